@@ -123,6 +123,10 @@ class Compilation {
   /// class Command and the exit status of the corresponding child process.
   std::function<void(const Command &, int)> PostCallback;
 
+  /// The maximum number of compilation jobs run in parallel, set with
+  /// -fsycl-max-parallel-compile-jobs.
+  unsigned MaxParallelCompileJobs = 1;
+
   /// Whether we're compiling for diagnostic purposes.
   bool ForDiagnostics = false;
 
@@ -236,6 +240,11 @@ public:
     PostCallback = CB;
   }
 
+  unsigned getMaxParallelCompileJobs() const { return MaxParallelCompileJobs; }
+  void setMaxParallelCompileJobs(unsigned Jobs) {
+    MaxParallelCompileJobs = Jobs;
+  }
+
   /// Returns the sysroot path.
   StringRef getSysRoot() const;
 
@@ -316,6 +325,26 @@ public:
   int ExecuteCommand(const Command &C, const Command *&FailingCommand,
                      bool LogOnly = false) const;
 
+  /// PrintCommand - Print the command when -v or CC_PRINT_OPTIONS is set.
+  ///
+  /// \return Non-zero if the log file could not be opened.
+  int PrintCommand(const Command &C, const Command *&FailingCommand) const;
+
+  /// HandleCommandResult - Report the result of an executed command and run
+  /// the post-callback.
+  ///
+  /// \return The result code of the command, as for ExecuteCommand.
+  int HandleCommandResult(const Command &C, int Res, StringRef Error,
+                          bool ExecutionFailed,
+                          const Command *&FailingCommand) const;
+
+  /// ExecuteJobsInParallel - Execute the jobs, running up to
+  /// MaxParallelCompileJobs independent compilation jobs at a time. The other
+  /// jobs run alone, in the order of the job list.
+  void ExecuteJobsInParallel(
+      const JobList &Jobs,
+      SmallVectorImpl<std::pair<int, const Command *>> &FailingCommands) const;
+
   /// ExecuteJob - Execute a single job.
   ///
   /// \param FailingCommands - For non-zero results, this will be a vector of
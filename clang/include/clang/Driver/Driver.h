@@ -869,6 +869,10 @@ private:
   mutable llvm::StringMap<const std::pair<StringRef, StringRef>>
       IntegrationFileList;
 
+  /// The device compilations writing the integration files of the inputs,
+  /// when the compilation jobs run in parallel.
+  mutable llvm::StringMap<std::string> IntegrationFilesOwners;
+
   /// Unique ID used for SYCL compilations.  Each file will use a different
   /// unique ID, but the same ID will be used for different compilation
   /// targets.
@@ -946,6 +950,13 @@ public:
   StringRef getIntegrationFooter(StringRef FileName) const {
     return IntegrationFileList[FileName].second;
   }
+  /// claimIntegrationFiles - Claim the integration files of the input for
+  /// the device compilation \p Device, a target triple and architecture.
+  /// Returns false if they are written by the compilation for another device.
+  bool claimIntegrationFiles(StringRef FileName, StringRef Device) const {
+    return IntegrationFilesOwners.try_emplace(FileName, Device.str())
+               .first->second == Device;
+  }
   /// createAppendedFooterInput - Create new source file.
   void createAppendedFooterInput(Action *&Input, Compilation &C,
                                  const llvm::opt::ArgList &Args) const;
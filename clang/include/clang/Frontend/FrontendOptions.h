@@ -585,6 +585,11 @@ public:
   LLVM_PREFERRED_TYPE(bool)
   unsigned TimeTraceVerbose : 1;
 
+  /// Make time trace only record the count and the total duration of each
+  /// kind of event.
+  LLVM_PREFERRED_TYPE(bool)
+  unsigned TimeTraceSummary : 1;
+
   /// Path which stores the output files for -ftime-trace
   std::string TimeTracePath;
 
@@ -607,7 +612,7 @@ public:
         EmitSymbolGraphSymbolLabelsForTesting(false),
         EmitPrettySymbolGraphs(false), GenReducedBMI(false),
         UseClangIRPipeline(false), TimeTraceGranularity(500),
-        TimeTraceVerbose(false) {}
+        TimeTraceVerbose(false), TimeTraceSummary(false) {}
 
   /// getInputKindForExtension - Return the appropriate input kind for a file
   /// extension. For example, "c" would return Language::C.
@@ -16,17 +16,24 @@
 #include "clang/Driver/ToolChain.h"
 #include "clang/Driver/Util.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/OptSpecifier.h"
 #include "llvm/Option/Option.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Jobserver.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SimpleTable.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/TargetParser/Triple.h"
 #include <cassert>
+#include <condition_variable>
 #include <fstream>
+#include <mutex>
 #include <string>
 #include <system_error>
 #include <utility>
@@ -273,9 +280,8 @@ bool Compilation::CleanupFileMap(const ArgStringMap &Files,
   return Success;
 }
 
-int Compilation::ExecuteCommand(const Command &C,
-                                const Command *&FailingCommand,
-                                bool LogOnly) const {
+int Compilation::PrintCommand(const Command &C,
+                              const Command *&FailingCommand) const {
   if ((getDriver().CCPrintOptions ||
        getArgs().hasArg(options::OPT_v)) && !getDriver().CCGenDiagnostics) {
     raw_ostream *OS = &llvm::errs();
@@ -303,13 +309,12 @@ int Compilation::ExecuteCommand(const Command &C,
 
     C.Print(*OS, "\n", /*Quote=*/getDriver().CCPrintOptions);
   }
+  return 0;
+}
 
-  if (LogOnly)
-    return 0;
-
-  std::string Error;
-  bool ExecutionFailed;
-  int Res = C.Execute(Redirects, &Error, &ExecutionFailed);
+int Compilation::HandleCommandResult(const Command &C, int Res,
+                                     StringRef Error, bool ExecutionFailed,
+                                     const Command *&FailingCommand) const {
   if (PostCallback)
     PostCallback(C, Res);
   if (!Error.empty()) {
@@ -331,6 +336,21 @@ int Compilation::ExecuteCommand(const Command &C,
   return ExecutionFailed ? 1 : Res;
 }
 
+int Compilation::ExecuteCommand(const Command &C,
+                                const Command *&FailingCommand,
+                                bool LogOnly) const {
+  if (int Res = PrintCommand(C, FailingCommand))
+    return Res;
+
+  if (LogOnly)
+    return 0;
+
+  std::string Error;
+  bool ExecutionFailed;
+  int Res = C.Execute(Redirects, &Error, &ExecutionFailed);
+  return HandleCommandResult(C, Res, Error, ExecutionFailed, FailingCommand);
+}
+
 using FailingCommandList = SmallVectorImpl<std::pair<int, const Command *>>;
 
 static bool ActionFailed(const Action *A,
@@ -365,9 +385,194 @@ static bool InputsOk(const Command &C,
   return !ActionFailed(&C.getSource(), FailingCommands);
 }
 
+/// Returns whether \p C compiles a single input, and can run in parallel with
+/// the other compilation jobs it doesn't depend on.
+static bool isParallelCompileJob(const Command &C) {
+  // Jobs run in the driver process and jobs printing their input files
+  // aren't thread-safe.
+  if (C.InProcess || C.PrintInputFilenames)
+    return false;
+  return isa<PreprocessJobAction, CompileJobAction, BackendJobAction,
+             AssembleJobAction>(C.getSource());
+}
+
+namespace {
+/// The files a job reads and writes.
+struct JobFiles {
+  llvm::StringSet<> Read;
+  llvm::StringSet<> Written;
+};
+} // namespace
+
+/// Collects the files read and written by \p C. Besides the outputs, the
+/// temporary files referred to by the arguments which aren't inputs, such as
+/// the integration header of a SYCL device compilation, are taken as written.
+/// The other arguments, such as a precompiled header, are taken as read.
+static JobFiles collectJobFiles(const Command &C,
+                                const llvm::StringSet<> &TempFiles) {
+  JobFiles Files;
+  for (const InputInfo &II : C.getInputInfos())
+    if (II.isFilename())
+      Files.Read.insert(II.getFilename());
+  for (const std::string &Output : C.getOutputFilenames())
+    Files.Written.insert(Output);
+  for (StringRef Arg : C.getArguments()) {
+    StringRef File = Arg.contains('=') ? Arg.split('=').second : Arg;
+    if (Files.Read.contains(File) || Files.Written.contains(File))
+      continue;
+    if (TempFiles.contains(File))
+      Files.Written.insert(File);
+    else
+      Files.Read.insert(File);
+  }
+  return Files;
+}
+
+static bool writesAnyOf(const JobFiles &Writer,
+                        const llvm::StringSet<> &Files) {
+  return llvm::any_of(Writer.Written, [&](const auto &File) {
+    return Files.contains(File.getKey());
+  });
+}
+
+static bool actionDependsOn(const Action *A, const Action *Dep,
+                            SmallPtrSetImpl<const Action *> &Visited) {
+  if (A == Dep)
+    return true;
+  if (!Visited.insert(A).second)
+    return false;
+  return llvm::any_of(A->inputs(), [&](const Action *Input) {
+    return actionDependsOn(Input, Dep, Visited);
+  });
+}
+
+/// Returns whether the job \p C, with files \p CFiles, must wait for the job
+/// \p Dep, with files \p DepFiles, an earlier job of the list.
+static bool jobDependsOn(const Command &C, const JobFiles &CFiles,
+                         const Command &Dep, const JobFiles &DepFiles) {
+  if (writesAnyOf(DepFiles, CFiles.Read) ||
+      writesAnyOf(DepFiles, CFiles.Written) ||
+      writesAnyOf(CFiles, DepFiles.Read))
+    return true;
+  SmallPtrSet<const Action *, 16> Visited;
+  return actionDependsOn(&C.getSource(), &Dep.getSource(), Visited);
+}
+
+void Compilation::ExecuteJobsInParallel(
+    const JobList &Jobs, FailingCommandList &FailingCommands) const {
+  const JobList::list_type &JobPtrs = Jobs.getJobs();
+  size_t NumJobs = JobPtrs.size();
+
+  llvm::StringSet<> TempFileNames;
+  for (const auto &File : TempFiles)
+    TempFileNames.insert(File.first);
+  std::vector<JobFiles> Files;
+  Files.reserve(NumJobs);
+  for (const auto &Job : JobPtrs)
+    Files.push_back(collectJobFiles(*Job, TempFileNames));
+
+  struct JobResult {
+    int Res = 0;
+    std::string Error;
+    bool ExecutionFailed = false;
+  };
+  std::vector<JobResult> Results(NumJobs);
+  // The jobs share the job slots of the build running the driver, when it has
+  // a jobserver.
+  llvm::JobserverClient *Jobserver = llvm::JobserverClient::getInstance();
+  std::vector<llvm::JobSlot> Slots(NumJobs);
+
+  std::mutex Mutex;
+  std::condition_variable Cond;
+  SmallVector<size_t, 8> Finished;
+  SmallVector<size_t, 8> Running;
+
+  // Jobs start in the order of the list. A compilation job starts while
+  // others are running when it doesn't depend on them, any other job runs
+  // alone.
+  auto CanStart = [&](size_t I) {
+    if (Running.empty())
+      return true;
+    if (Running.size() >= MaxParallelCompileJobs ||
+        !isParallelCompileJob(*JobPtrs[I]))
+      return false;
+    return llvm::none_of(Running, [&](size_t R) {
+      return !isParallelCompileJob(*JobPtrs[R]) ||
+             jobDependsOn(*JobPtrs[I], Files[I], *JobPtrs[R], Files[R]);
+    });
+  };
+
+  llvm::DefaultThreadPool Pool(
+      llvm::hardware_concurrency(MaxParallelCompileJobs));
+  size_t Next = 0;
+  bool Bail = false;
+  while (true) {
+    while (!Bail && Next < NumJobs && CanStart(Next)) {
+      size_t I = Next;
+      const Command &Job = *JobPtrs[I];
+      if (!InputsOk(Job, FailingCommands)) {
+        ++Next;
+        continue;
+      }
+      if (Jobserver) {
+        Slots[I] = Jobserver->tryAcquire();
+        if (!Slots[I].isValid() && !Running.empty())
+          break;
+      }
+      ++Next;
+      const Command *FailingCommand = nullptr;
+      if (int Res = PrintCommand(Job, FailingCommand)) {
+        Slots[I].release();
+        FailingCommands.push_back(std::make_pair(Res, FailingCommand));
+        Bail = TheDriver.IsCLMode() &&
+               FailingCommand->getWillExitForErrorCode(Res);
+        continue;
+      }
+      Running.push_back(I);
+      Pool.async([&, I] {
+        JobResult &Result = Results[I];
+        Result.Res = JobPtrs[I]->Execute(Redirects, &Result.Error,
+                                         &Result.ExecutionFailed);
+        std::lock_guard<std::mutex> Lock(Mutex);
+        Finished.push_back(I);
+        Cond.notify_one();
+      });
+    }
+    if (Running.empty())
+      break;
+
+    SmallVector<size_t, 8> Done;
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      Cond.wait(Lock, [&] { return !Finished.empty(); });
+      Done.swap(Finished);
+    }
+    for (size_t I : Done) {
+      llvm::erase(Running, I);
+      Slots[I].release();
+      const JobResult &Result = Results[I];
+      const Command *FailingCommand = nullptr;
+      if (int Res =
+              HandleCommandResult(*JobPtrs[I], Result.Res, Result.Error,
+                                  Result.ExecutionFailed, FailingCommand)) {
+        FailingCommands.push_back(std::make_pair(Res, FailingCommand));
+        // As in ExecuteJobs, let the running jobs finish but start no other
+        // one after a failure in cl driver mode.
+        if (TheDriver.IsCLMode() &&
+            FailingCommand->getWillExitForErrorCode(Res))
+          Bail = true;
+      }
+    }
+  }
+}
+
 void Compilation::ExecuteJobs(const JobList &Jobs,
                               FailingCommandList &FailingCommands,
                               bool LogOnly) const {
+  if (!LogOnly && MaxParallelCompileJobs > 1 && Jobs.size() > 1 &&
+      llvm::llvm_is_multithreaded())
+    return ExecuteJobsInParallel(Jobs, FailingCommands);
+
   // According to UNIX standard, driver need to continue compiling all the
   // inputs on the command line even one of them failed.
   // In all but CLMode, execute all the jobs unless the necessary inputs for the
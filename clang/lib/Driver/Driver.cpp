@@ -1159,7 +1159,8 @@ void Driver::CreateOffloadingDeviceToolChains(Compilation &C,
   Arg *DeviceCodeSplit =
       C.getInputArgs().getLastArg(options::OPT_fsycl_device_code_split_EQ);
   checkSingleArgValidity(DeviceCodeSplit,
-                         {"per_kernel", "per_source", "auto", "off"});
+                         {"per_kernel", "per_source", "auto", "by_size",
+                          "off"});
 
   Arg *RangeRoundingPreference =
       C.getInputArgs().getLastArg(options::OPT_fsycl_range_rounding_EQ);
@@ -1963,6 +1964,19 @@ Compilation *Driver::BuildCompilation(ArrayRef<const char *> ArgList) {
     return C;
   }
 
+  // Determine how many compilation jobs of a SYCL offload compilation may run
+  // in parallel.
+  if (C->hasOffloadToolChain<Action::OFK_SYCL>())
+    if (Arg *A = C->getArgs().getLastArg(
+            options::OPT_fsycl_max_parallel_compile_jobs_EQ)) {
+      unsigned Jobs = 0;
+      if (StringRef(A->getValue()).getAsInteger(10, Jobs) || Jobs == 0)
+        Diag(diag::err_drv_invalid_int_value)
+            << A->getAsString(C->getArgs()) << A->getValue();
+      else
+        C->setMaxParallelCompileJobs(Jobs);
+    }
+
   BuildJobs(*C);
 
   return C;
@@ -5471,7 +5485,7 @@ class OffloadingActionBuilder final {
         //   r - relocatable device code is requested
         //   f - link object output type is TY_Tempfilelist (fat archive)
         //   e - Embedded IR for fusion (-fsycl-embed-ir) was requested
-        //       and target is NVPTX.
+        //       and target is NVPTX/AMDGCN or SPIR-V without AOT.
         //   * - "all other cases"
         //     - no condition means output/input is "always" present
         // First symbol indicates output/input type
@@ -5676,13 +5690,15 @@ class OffloadingActionBuilder final {
             addDeps(DeviceWrappingAction, TC, BoundArch);
             continue;
           }
-          if ((IsNVPTX || IsAMDGCN) &&
+          if ((IsNVPTX || IsAMDGCN || (IsSPIR && !IsSpirvAOT)) &&
               Args.hasArg(options::OPT_fsycl_embed_ir)) {
-            // When compiling for Nvidia/AMD devices and the user requested the
-            // IR to be embedded in the application (via option), run the output
-            // of sycl-post-link (filetable referencing LLVM Bitcode + symbols)
-            // through the offload wrapper and link the resulting object to the
-            // application.
+            // When compiling for Nvidia/AMD devices or for SPIR-V JIT targets
+            // and the user requested the IR to be embedded in the application
+            // (via option), run the output of sycl-post-link (filetable
+            // referencing LLVM Bitcode + symbols) through the offload wrapper
+            // and link the resulting object to the application. For SPIR-V
+            // targets this spares the runtime the translation of the SPIR-V
+            // back to LLVM IR when JIT compiling kernels.
             auto *WrapBitcodeAction = C.MakeAction<OffloadWrapperJobAction>(
                 PostLinkAction, types::TY_Object, true);
             addDeps(WrapBitcodeAction, TC, BoundArch);
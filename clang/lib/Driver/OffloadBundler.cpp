@@ -40,14 +40,18 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/FileOutputBuffer.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
+#include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
@@ -200,6 +204,12 @@ public:
   /// Read the current bundle and write the result into the stream \a OS.
   virtual Error ReadBundle(raw_ostream &OS, MemoryBuffer &Input) = 0;
 
+  /// Return the contents of the current bundle when they are a part of \a
+  /// Input as is, so that they can be written without reading the bundle.
+  virtual std::optional<StringRef> getBundleContents(MemoryBuffer &Input) {
+    return std::nullopt;
+  }
+
   /// Write the header of the bundled file to \a OS based on the information
   /// gathered from \a Inputs.
   virtual Error WriteHeader(raw_ostream &OS,
@@ -436,6 +446,12 @@ public:
     return Error::success();
   }
 
+  std::optional<StringRef> getBundleContents(MemoryBuffer &Input) final {
+    assert(CurBundleInfo != BundlesInfo.end() && "Invalid reader info!");
+    return Input.getBuffer().substr(CurBundleInfo->second.Offset,
+                                    CurBundleInfo->second.Size);
+  }
+
   Error WriteHeader(raw_ostream &OS,
                     ArrayRef<std::unique_ptr<MemoryBuffer>> Inputs) final {
 
@@ -752,6 +768,19 @@ public:
     return Error::success();
   }
 
+  std::optional<StringRef> getBundleContents(MemoryBuffer &Input) final {
+    Expected<StringRef> ContentOrErr = CurrentSection->getContents();
+    // The error is reported by ReadBundle.
+    if (!ContentOrErr) {
+      consumeError(ContentOrErr.takeError());
+      return std::nullopt;
+    }
+    // The host bundle is the fat object without the offload sections.
+    if (ContentOrErr->size() == 1u && ContentOrErr->front() == 0)
+      return std::nullopt;
+    return *ContentOrErr;
+  }
+
   Error WriteHeader(raw_ostream &OS,
                     ArrayRef<std::unique_ptr<MemoryBuffer>> Inputs) final {
     assert(BundlerConfig.HostInputIndex != ~0u &&
@@ -1606,13 +1635,15 @@ CompressedOffloadBundle::decompress(const llvm::MemoryBuffer &Input,
   StringRef Blob = Input.getBuffer();
 
   if (Blob.size() < V1HeaderSize)
-    return llvm::MemoryBuffer::getMemBufferCopy(Blob);
+    return llvm::MemoryBuffer::getMemBuffer(Input.getMemBufferRef(),
+                                            /*RequiresNullTerminator=*/false);
 
   if (llvm::identify_magic(Blob) !=
       llvm::file_magic::offload_bundle_compressed) {
     if (Verbose)
       llvm::errs() << "Uncompressed bundle.\n";
-    return llvm::MemoryBuffer::getMemBufferCopy(Blob);
+    return llvm::MemoryBuffer::getMemBuffer(Input.getMemBufferRef(),
+                                            /*RequiresNullTerminator=*/false);
   }
 
   size_t CurrentOffset = MagicSize;
@@ -1911,7 +1942,9 @@ Error OffloadBundler::BundleFiles() {
             llvm::StringRef(Buffer.data(), Buffer.size()));
     auto CompressionResult = CompressedOffloadBundle::compress(
         {BundlerConfig.CompressionFormat, BundlerConfig.CompressionLevel,
-         /*zstdEnableLdm=*/true},
+         /*zstdEnableLdm=*/true,
+         /*zstdNumWorkers=*/
+         heavyweight_hardware_concurrency().compute_thread_count()},
         *BufferMemory, BundlerConfig.Verbose);
     if (auto Error = CompressionResult.takeError())
       return Error;
@@ -1928,10 +1961,27 @@ Error OffloadBundler::BundleFiles() {
 }
 
 // Unbundle the files. Return true if an error was found.
+// Writes \p Contents to the file \p FileName, through a file mapped in memory
+// when possible.
+static Error writeOutputFile(StringRef FileName, StringRef Contents) {
+  Expected<std::unique_ptr<FileOutputBuffer>> OutputOrErr =
+      FileOutputBuffer::create(FileName, Contents.size());
+  if (!OutputOrErr)
+    return createFileError(FileName, OutputOrErr.takeError());
+  std::copy(Contents.begin(), Contents.end(),
+            (*OutputOrErr)->getBufferStart());
+  if (Error Err = (*OutputOrErr)->commit())
+    return createFileError(FileName, std::move(Err));
+  return Error::success();
+}
+
 Error OffloadBundler::UnbundleFiles() {
-  // Open Input file.
+  // Open Input file. It is mapped in memory, the bundles are written from it
+  // without being copied.
   ErrorOr<std::unique_ptr<MemoryBuffer>> CodeOrErr =
-      MemoryBuffer::getFileOrSTDIN(BundlerConfig.InputFileNames.front());
+      MemoryBuffer::getFileOrSTDIN(BundlerConfig.InputFileNames.front(),
+                                   /*IsText=*/false,
+                                   /*RequiresNullTerminator=*/false);
   if (std::error_code EC = CodeOrErr.getError())
     return createFileError(BundlerConfig.InputFileNames.front(), EC);
 
@@ -1970,6 +2020,10 @@ Error OffloadBundler::UnbundleFiles() {
     ++Output;
   }
 
+  // The bundles which are parts of the input as is, written in parallel once
+  // all of them are found.
+  SmallVector<std::pair<StringRef, StringRef>> BundleWrites;
+
   // Read all the bundles that are in the work list. If we find no bundles we
   // assume the file is meant for the host target.
   bool FoundHostBundle = false;
@@ -1997,13 +2051,17 @@ Error OffloadBundler::UnbundleFiles() {
 
     if (Output == Worklist.end())
       continue;
-    // Check if the output file can be opened and copy the bundle to it.
-    std::error_code EC;
-    raw_fd_ostream OutputFile((*Output).second, EC, sys::fs::OF_None);
-    if (EC)
-      return createFileError((*Output).second, EC);
-    if (Error Err = FH->ReadBundle(OutputFile, Input))
-      return Err;
+    if (std::optional<StringRef> Contents = FH->getBundleContents(Input)) {
+      BundleWrites.emplace_back((*Output).second, *Contents);
+    } else {
+      // Check if the output file can be opened and copy the bundle to it.
+      std::error_code EC;
+      raw_fd_ostream OutputFile((*Output).second, EC, sys::fs::OF_None);
+      if (EC)
+        return createFileError((*Output).second, EC);
+      if (Error Err = FH->ReadBundle(OutputFile, Input))
+        return Err;
+    }
     if (Error Err = FH->ReadBundleEnd(Input))
       return Err;
     Worklist.erase(Output);
@@ -2014,6 +2072,12 @@ Error OffloadBundler::UnbundleFiles() {
       FoundHostBundle = true;
   }
 
+  if (Error Err = parallelForEachError(
+          BundleWrites, [](const std::pair<StringRef, StringRef> &Write) {
+            return writeOutputFile(Write.first, Write.second);
+          }))
+    return Err;
+
   if (!BundlerConfig.AllowMissingBundles && !Worklist.empty()) {
     std::string ErrMsg = "Can't find bundles for";
     std::set<StringRef> Sorted;
@@ -2218,6 +2282,119 @@ CheckHeterogeneousArchive(StringRef ArchiveName,
   return ArchiveErr;
 }
 
+namespace {
+/// A member of a heterogeneous archive and the code objects unbundled from it.
+struct UnbundledArchiveMember {
+  struct CodeObject {
+    StringRef Target;
+    std::string Name;
+    StringRef Contents;
+  };
+
+  StringRef FileName;
+  MemoryBufferRef Buffer;
+  /// The decompressed member, referencing the buffer of the archive when the
+  /// member isn't compressed.
+  std::unique_ptr<MemoryBuffer> Decompressed;
+  /// The code objects which aren't a part of the member as is.
+  SmallVector<std::unique_ptr<MemoryBuffer>, 0> ReadBundles;
+  SmallVector<CodeObject, 2> CodeObjects;
+};
+} // namespace
+
+/// Unbundles the code objects of \p Member compatible with the offload
+/// targets. Runs in parallel for the members of the archive.
+static Error unbundleArchiveMember(UnbundledArchiveMember &Member,
+                                   const OffloadBundlerConfig &BundlerConfig) {
+  auto TempCodeObjectBuffer = MemoryBuffer::getMemBuffer(Member.Buffer, false);
+
+  // Decompress the buffer if necessary.
+  Expected<std::unique_ptr<MemoryBuffer>> DecompressedBufferOrErr =
+      CompressedOffloadBundle::decompress(*TempCodeObjectBuffer,
+                                          BundlerConfig.Verbose);
+  if (!DecompressedBufferOrErr)
+    return createStringError(
+        inconvertibleErrorCode(),
+        "Failed to decompress code object: " +
+            llvm::toString(DecompressedBufferOrErr.takeError()));
+
+  Member.Decompressed = std::move(*DecompressedBufferOrErr);
+  MemoryBuffer &CodeObjectBuffer = *Member.Decompressed;
+
+  Expected<std::unique_ptr<FileHandler>> FileHandlerOrErr =
+      CreateFileHandler(CodeObjectBuffer, BundlerConfig);
+  if (!FileHandlerOrErr)
+    return FileHandlerOrErr.takeError();
+
+  std::unique_ptr<FileHandler> &FileHandler = *FileHandlerOrErr;
+  assert(FileHandler && "FileHandle creation failed for file in the archive!");
+
+  if (Error ReadErr = FileHandler->ReadHeader(CodeObjectBuffer))
+    return ReadErr;
+
+  Expected<std::optional<StringRef>> CurBundleIDOrErr =
+      FileHandler->ReadBundleStart(CodeObjectBuffer);
+  if (!CurBundleIDOrErr)
+    return CurBundleIDOrErr.takeError();
+
+  std::optional<StringRef> OptionalCurBundleID = *CurBundleIDOrErr;
+  // No device code in this child, skip.
+  if (!OptionalCurBundleID)
+    return Error::success();
+  StringRef CodeObject = *OptionalCurBundleID;
+
+  // Process all bundle entries (CodeObjects) found in this child of input
+  // archive.
+  while (!CodeObject.empty()) {
+    SmallVector<StringRef> CompatibleTargets;
+    auto CodeObjectInfo = OffloadTargetInfo(CodeObject, BundlerConfig);
+    if (getCompatibleOffloadTargets(CodeObjectInfo, CompatibleTargets,
+                                    BundlerConfig)) {
+      std::optional<StringRef> Contents =
+          FileHandler->getBundleContents(CodeObjectBuffer);
+      if (!Contents) {
+        SmallVector<char, 0> BundleData;
+        raw_svector_ostream DataStream(BundleData);
+        if (Error Err = FileHandler->ReadBundle(DataStream, CodeObjectBuffer))
+          return Err;
+        Member.ReadBundles.push_back(
+            std::make_unique<SmallVectorMemoryBuffer>(
+                std::move(BundleData), /*RequiresNullTerminator=*/false));
+        Contents = Member.ReadBundles.back()->getBuffer();
+      }
+
+      for (auto &CompatibleTarget : CompatibleTargets) {
+        SmallString<128> BundledObjectFileName;
+        BundledObjectFileName.assign(Member.FileName);
+        auto OutputBundleName =
+            Twine(llvm::sys::path::stem(BundledObjectFileName) + "-" +
+                  CodeObject +
+                  getDeviceLibraryFileName(BundledObjectFileName,
+                                           CodeObjectInfo.TargetID))
+                .str();
+        // Replace ':' in optional target feature list with '_' to ensure
+        // cross-platform validity.
+        std::replace(OutputBundleName.begin(), OutputBundleName.end(), ':',
+                     '_');
+
+        Member.CodeObjects.push_back(
+            {CompatibleTarget, std::move(OutputBundleName), *Contents});
+      }
+    }
+
+    if (Error Err = FileHandler->ReadBundleEnd(CodeObjectBuffer))
+      return Err;
+
+    Expected<std::optional<StringRef>> NextTripleOrErr =
+        FileHandler->ReadBundleStart(CodeObjectBuffer);
+    if (!NextTripleOrErr)
+      return NextTripleOrErr.takeError();
+
+    CodeObject = ((*NextTripleOrErr).has_value()) ? **NextTripleOrErr : "";
+  } // End of processing of all bundle entries of this child of input archive.
+  return Error::success();
+}
+
 /// UnbundleArchive takes an archive file (".a") as input containing bundled
 /// code object files, and a list of offload targets (not host), and extracts
 /// the code objects into a new archive file for each offload target. Each
@@ -2253,8 +2430,11 @@ Error OffloadBundler::UnbundleArchive() {
     }
   }
 
+  // The archive is mapped in memory, the code objects which are parts of its
+  // members as is are written from it without being copied.
   ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
-      MemoryBuffer::getFileOrSTDIN(IFName, true, false);
+      MemoryBuffer::getFileOrSTDIN(IFName, /*IsText=*/false,
+                                   /*RequiresNullTerminator=*/false);
   if (std::error_code EC = BufOrErr.getError())
     return createFileError(BundlerConfig.InputFileNames.front(), EC);
 
@@ -2266,6 +2446,9 @@ Error OffloadBundler::UnbundleArchive() {
 
   auto Archive = std::move(*LibOrErr);
 
+  // The members are unbundled in parallel, then their code objects are added
+  // to the output archives in the order of the members.
+  std::vector<UnbundledArchiveMember> Members;
   Error ArchiveErr = Error::success();
   auto ChildEnd = Archive->child_end();
 
@@ -2278,132 +2461,53 @@ Error OffloadBundler::UnbundleArchive() {
     if (!ArchiveChildNameOrErr)
       return ArchiveChildNameOrErr.takeError();
 
-    StringRef BundledObjectFile = sys::path::filename(*ArchiveChildNameOrErr);
-
     auto CodeObjectBufferRefOrErr = (*ArchiveIter).getMemoryBufferRef();
     if (!CodeObjectBufferRefOrErr)
       return CodeObjectBufferRefOrErr.takeError();
 
-    auto TempCodeObjectBuffer =
-        MemoryBuffer::getMemBuffer(*CodeObjectBufferRefOrErr, false);
-
-    // Decompress the buffer if necessary.
-    Expected<std::unique_ptr<MemoryBuffer>> DecompressedBufferOrErr =
-        CompressedOffloadBundle::decompress(*TempCodeObjectBuffer,
-                                            BundlerConfig.Verbose);
-    if (!DecompressedBufferOrErr)
-      return createStringError(
-          inconvertibleErrorCode(),
-          "Failed to decompress code object: " +
-              llvm::toString(DecompressedBufferOrErr.takeError()));
-
-    MemoryBuffer &CodeObjectBuffer = **DecompressedBufferOrErr;
-
-    Expected<std::unique_ptr<FileHandler>> FileHandlerOrErr =
-        CreateFileHandler(CodeObjectBuffer, BundlerConfig);
-    if (!FileHandlerOrErr)
-      return FileHandlerOrErr.takeError();
-
-    std::unique_ptr<FileHandler> &FileHandler = *FileHandlerOrErr;
-    assert(FileHandler &&
-           "FileHandle creation failed for file in the archive!");
-
-    if (Error ReadErr = FileHandler->ReadHeader(CodeObjectBuffer))
-      return ReadErr;
-
-    Expected<std::optional<StringRef>> CurBundleIDOrErr =
-        FileHandler->ReadBundleStart(CodeObjectBuffer);
-    if (!CurBundleIDOrErr)
-      return CurBundleIDOrErr.takeError();
-
-    std::optional<StringRef> OptionalCurBundleID = *CurBundleIDOrErr;
-    // No device code in this child, skip.
-    if (!OptionalCurBundleID)
-      continue;
-    StringRef CodeObject = *OptionalCurBundleID;
-
-    // Process all bundle entries (CodeObjects) found in this child of input
-    // archive.
-    while (!CodeObject.empty()) {
-      SmallVector<StringRef> CompatibleTargets;
-      auto CodeObjectInfo = OffloadTargetInfo(CodeObject, BundlerConfig);
-      if (getCompatibleOffloadTargets(CodeObjectInfo, CompatibleTargets,
-                                      BundlerConfig)) {
-        std::string BundleData;
-        raw_string_ostream DataStream(BundleData);
-        if (Error Err = FileHandler->ReadBundle(DataStream, CodeObjectBuffer))
-          return Err;
+    UnbundledArchiveMember &Member = Members.emplace_back();
+    Member.FileName = sys::path::filename(*ArchiveChildNameOrErr);
+    Member.Buffer = *CodeObjectBufferRefOrErr;
+  } // End of while over children of input archive.
+  if (ArchiveErr)
+    return ArchiveErr;
+
+  if (Error Err = parallelForEachError(
+          Members, [&](UnbundledArchiveMember &Member) {
+            return unbundleArchiveMember(Member, BundlerConfig);
+          }))
+    return Err;
 
-        for (auto &CompatibleTarget : CompatibleTargets) {
-          SmallString<128> BundledObjectFileName;
-          BundledObjectFileName.assign(BundledObjectFile);
-          auto OutputBundleName =
-              Twine(llvm::sys::path::stem(BundledObjectFileName) + "-" +
-                    CodeObject +
-                    getDeviceLibraryFileName(BundledObjectFileName,
-                                             CodeObjectInfo.TargetID))
+  for (UnbundledArchiveMember &Member : Members)
+    for (UnbundledArchiveMember::CodeObject &Object : Member.CodeObjects)
+      OutputArchivesMap[Object.Target].push_back(
+          NewArchiveMember(MemoryBufferRef(Object.Contents, Object.Name)));
+
+  /// Write out an archive for each target, in parallel.
+  return parallelForEachError(
+      BundlerConfig.TargetNames, [&](const std::string &Target) -> Error {
+        StringRef FileName = TargetOutputFileNameMap.lookup(Target);
+        auto CurArchiveMembers = OutputArchivesMap.find(Target);
+        if (CurArchiveMembers != OutputArchivesMap.end())
+          return writeArchive(FileName, CurArchiveMembers->getValue(),
+                              SymtabWritingMode::NormalSymtab,
+                              getDefaultArchiveKindForHost(), true, false,
+                              nullptr);
+        if (!BundlerConfig.AllowMissingBundles) {
+          std::string ErrMsg =
+              Twine("no compatible code object found for the target '" +
+                    Target + "' in heterogeneous archive library: " + IFName)
                   .str();
-          // Replace ':' in optional target feature list with '_' to ensure
-          // cross-platform validity.
-          std::replace(OutputBundleName.begin(), OutputBundleName.end(), ':',
-                       '_');
-
-          std::unique_ptr<MemoryBuffer> MemBuf = MemoryBuffer::getMemBufferCopy(
-              DataStream.str(), OutputBundleName);
-          ArchiveBuffers.push_back(std::move(MemBuf));
-          llvm::MemoryBufferRef MemBufRef =
-              MemoryBufferRef(*(ArchiveBuffers.back()));
-
-          // For inserting <CompatibleTarget, list<CodeObject>> entry in
-          // OutputArchivesMap.
-          OutputArchivesMap[CompatibleTarget].push_back(
-              NewArchiveMember(MemBufRef));
+          return createStringError(inconvertibleErrorCode(), ErrMsg);
         }
-      }
-
-      if (Error Err = FileHandler->ReadBundleEnd(CodeObjectBuffer))
-        return Err;
-
-      Expected<std::optional<StringRef>> NextTripleOrErr =
-          FileHandler->ReadBundleStart(CodeObjectBuffer);
-      if (!NextTripleOrErr)
-        return NextTripleOrErr.takeError();
-
-      CodeObject = ((*NextTripleOrErr).has_value()) ? **NextTripleOrErr : "";
-    } // End of processing of all bundle entries of this child of input archive.
-  }   // End of while over children of input archive.
-
-  assert(!ArchiveErr && "Error occurred while reading archive!");
-
-  /// Write out an archive for each target
-  for (auto &Target : BundlerConfig.TargetNames) {
-    StringRef FileName = TargetOutputFileNameMap[Target];
-    StringMapIterator<std::vector<llvm::NewArchiveMember>> CurArchiveMembers =
-        OutputArchivesMap.find(Target);
-    if (CurArchiveMembers != OutputArchivesMap.end()) {
-      if (Error WriteErr = writeArchive(FileName, CurArchiveMembers->getValue(),
-                                        SymtabWritingMode::NormalSymtab,
-                                        getDefaultArchiveKindForHost(), true,
-                                        false, nullptr))
-        return WriteErr;
-    } else if (!BundlerConfig.AllowMissingBundles) {
-      std::string ErrMsg =
-          Twine("no compatible code object found for the target '" + Target +
-                "' in heterogeneous archive library: " + IFName)
-              .str();
-      return createStringError(inconvertibleErrorCode(), ErrMsg);
-    } else { // Create an empty archive file if no compatible code object is
-             // found and "allow-missing-bundles" is enabled. It ensures that
-             // the linker using output of this step doesn't complain about
-             // the missing input file.
-      std::vector<llvm::NewArchiveMember> EmptyArchive;
-      EmptyArchive.clear();
-      if (Error WriteErr = writeArchive(
-              FileName, EmptyArchive, SymtabWritingMode::NormalSymtab,
-              getDefaultArchiveKindForHost(), true, false, nullptr))
-        return WriteErr;
-    }
-  }
-
-  return Error::success();
+        // Create an empty archive file if no compatible code object is found
+        // and "allow-missing-bundles" is enabled. It ensures that the linker
+        // using output of this step doesn't complain about the missing input
+        // file.
+        std::vector<llvm::NewArchiveMember> EmptyArchive;
+        return writeArchive(FileName, EmptyArchive,
+                            SymtabWritingMode::NormalSymtab,
+                            getDefaultArchiveKindForHost(), true, false,
+                            nullptr);
+      });
 }
@@ -60,6 +60,7 @@
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/YAMLParser.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/TargetParser/AArch64TargetParser.h"
 #include "llvm/TargetParser/ARMTargetParserCommon.h"
 #include "llvm/TargetParser/Host.h"
@@ -554,6 +555,94 @@ static bool isSYCLOptimizationO2orHigher(const ArgList &Args) {
   return true;
 }
 
+/// With -fsycl-pch-cache=<dir>, compile sycl/sycl.hpp into a precompiled
+/// header cached in <dir> and include it in the SYCL compilation of a source
+/// file. There is a precompiled header for each set of -cc1 arguments which
+/// don't depend on the source file, so the host compilation and the device
+/// compilation for each target have their own, shared by all the sources
+/// compiled with the same options. When it isn't in the cache yet, a job
+/// building it is added before the compilation.
+static void addSYCLPCHCacheArgs(Compilation &C, const JobAction &JA,
+                                const Tool &T, const char *Exec,
+                                const InputInfo &Input, const ArgList &Args,
+                                ArgStringList &CmdArgs) {
+  const Arg *CacheArg = Args.getLastArg(options::OPT_fsycl_pch_cache_EQ);
+  if (!CacheArg || !JA.isOffloading(Action::OFK_SYCL) ||
+      isa<PreprocessJobAction, PrecompileJobAction>(JA) ||
+      !Input.isFilename() || !types::isCXX(Input.getType()) ||
+      types::getPreprocessedType(Input.getType()) == types::TY_INVALID ||
+      Args.hasArg(options::OPT_include, options::OPT_include_pch))
+    return;
+
+  const Driver &D = C.getDriver();
+  SmallString<128> Header(D.Dir);
+  llvm::sys::path::append(Header, "..", "include", "sycl", "sycl.hpp");
+  llvm::sys::fs::file_status Status;
+  if (llvm::sys::fs::status(Header, Status))
+    return;
+
+  // The arguments naming the source file and the files generated for it
+  // aren't used by the precompiled header.
+  StringRef IntHeader = D.getIntegrationHeader(Input.getBaseInput());
+  StringRef IntFooter = D.getIntegrationFooter(Input.getBaseInput());
+  ArgStringList PCHArgs;
+  for (size_t I = 0, E = CmdArgs.size(); I != E; ++I) {
+    StringRef Arg = CmdArgs[I];
+    if (Arg == "-main-file-name" || Arg == "-dependency-file" ||
+        Arg == "-dependency-filter" || Arg == "-MT" ||
+        (Arg == "-include" && I + 1 != E && CmdArgs[I + 1] == IntHeader) ||
+        (Arg == "-include-footer" && I + 1 != E &&
+         CmdArgs[I + 1] == IntFooter)) {
+      ++I;
+      continue;
+    }
+    if (Arg.starts_with("-fsycl-int-header=") ||
+        Arg.starts_with("-fsycl-int-footer=") ||
+        Arg.starts_with("-fsycl-unique-prefix=") || Arg == "-sys-header-deps")
+      continue;
+    PCHArgs.push_back(CmdArgs[I]);
+  }
+
+  // Key the precompiled header on its arguments and on the version of the
+  // SYCL header.
+  std::string Key(Exec);
+  for (const char *Arg : PCHArgs)
+    (Key += '\0') += Arg;
+  Key += '\0';
+  Key += std::to_string(Status.getSize());
+  Key += '\0';
+  Key += std::to_string(
+      Status.getLastModificationTime().time_since_epoch().count());
+  SmallString<128> PCHFile(CacheArg->getValue());
+  llvm::sys::path::append(
+      PCHFile, Twine("sycl-") + T.getToolChain().getTripleString() + "-" +
+                   llvm::utohexstr(llvm::xxh3_64bits(Key)) + ".pch");
+  const char *PCH = Args.MakeArgString(PCHFile);
+
+  // Build the precompiled header once, even when several sources use it.
+  bool Building = llvm::any_of(C.getJobs(), [&](const Command &Job) {
+    return llvm::is_contained(Job.getOutputFilenames(), StringRef(PCHFile));
+  });
+  if (!Building && !llvm::sys::fs::exists(PCHFile)) {
+    // Compile without a precompiled header when the cache can't be created.
+    if (llvm::sys::fs::create_directories(CacheArg->getValue()))
+      return;
+    // -emit-pch overrides the action of the compilation, being the last one.
+    PCHArgs.push_back("-emit-pch");
+    PCHArgs.push_back("-o");
+    PCHArgs.push_back(PCH);
+    PCHArgs.push_back("-x");
+    PCHArgs.push_back("c++-header");
+    PCHArgs.push_back(Args.MakeArgString(Header));
+    C.addCommand(std::make_unique<Command>(
+        JA, T, ResponseFileSupport::AtFileUTF8(), Exec, PCHArgs, std::nullopt,
+        InputInfo(types::TY_PCH, PCH, Input.getBaseInput()),
+        D.getPrependArg()));
+  }
+  CmdArgs.push_back("-include-pch");
+  CmdArgs.push_back(PCH);
+}
+
 /// Vectorize at all optimization levels greater than 1 except for -Oz.
 /// For -Oz the loop vectorizer is disabled, while the slp vectorizer is
 /// enabled.
@@ -5606,6 +5695,23 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
 
     // Add the integration header option to generate the header.
     StringRef Header(D.getIntegrationHeader(Input.getBaseInput()));
+    StringRef Footer(D.getIntegrationFooter(Input.getBaseInput()));
+    // When the compilation jobs run in parallel, the device compilations for
+    // the other targets write their own copies of the integration files, so
+    // that they don't race with the one whose files the host compilation
+    // includes.
+    std::string Device = TripleStr;
+    if (const char *Arch = JA.getOffloadingArch())
+      Device += Arch;
+    if (!Header.empty() && C.getMaxParallelCompileJobs() > 1 &&
+        !D.claimIntegrationFiles(Input.getBaseInput(), Device)) {
+      StringRef Stem = llvm::sys::path::stem(Input.getBaseInput());
+      Header = C.addTempFile(C.getArgs().MakeArgString(
+          D.GetTemporaryPath(Stem.str() + "-header", "h")));
+      if (!Footer.empty())
+        Footer = C.addTempFile(C.getArgs().MakeArgString(
+            D.GetTemporaryPath(Stem.str() + "-footer", "h")));
+    }
     if (!Header.empty()) {
       SmallString<128> HeaderOpt("-fsycl-int-header=");
       HeaderOpt.append(Header);
@@ -5614,7 +5720,6 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
 
     if (!Args.hasArg(options::OPT_fno_sycl_use_footer)) {
       // Add the integration footer option to generated the footer.
-      StringRef Footer(D.getIntegrationFooter(Input.getBaseInput()));
       if (!Footer.empty()) {
         SmallString<128> FooterOpt("-fsycl-int-footer=");
         FooterOpt.append(Footer);
@@ -5644,6 +5749,11 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
                                  options::OPT_fno_sycl_id_queries_fit_in_int))
       A->render(Args, CmdArgs);
 
+    // The launches with an offset are rejected by the SYCL headers.
+    if (!Args.hasFlag(options::OPT_fsycl_global_offset,
+                      options::OPT_fno_sycl_global_offset, true))
+      CmdArgs.push_back("-D__SYCL_DISABLE_GLOBAL_OFFSET__");
+
     if (Args.hasArg(options::OPT_fpreview_breaking_changes))
       CmdArgs.push_back("-D__INTEL_PREVIEW_BREAKING_CHANGES");
 
@@ -7679,6 +7789,7 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back(Args.MakeArgString("-ftime-trace=" + Twine(Name)));
     Args.AddLastArg(CmdArgs, options::OPT_ftime_trace_granularity_EQ);
     Args.AddLastArg(CmdArgs, options::OPT_ftime_trace_verbose);
+    Args.AddLastArg(CmdArgs, options::OPT_ftime_trace_summary);
   }
 
   if (Arg *A = Args.getLastArg(options::OPT_ftrapv_handler_EQ)) {
@@ -8824,6 +8935,8 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
     CmdArgs.push_back(Args.MakeArgString(Str));
   }
 
+  addSYCLPCHCacheArgs(C, JA, *this, Exec, Input, Args, CmdArgs);
+
   // Add the "-o out -x type src.c" flags last. This is done primarily to make
   // the -cc1 command easier to edit when reproducing compiler crashes.
   if (Output.getType() == types::TY_Dependencies) {
@@ -10185,6 +10298,17 @@ void OffloadWrapper::ConstructJob(Compilation &C, const JobAction &JA,
     addRunTimeWrapperOpts(C, OffloadingKind, TCArgs, WrapperArgs,
                           getToolChain(), JA);
 
+    // Device images are compressed by the wrapper and decompressed lazily by
+    // the SYCL runtime.
+    if (C.getInputArgs().hasFlag(options::OPT_offload_compress,
+                                 options::OPT_no_offload_compress, false)) {
+      WrapperArgs.push_back(C.getArgs().MakeArgString("-offload-compress"));
+      if (Arg *A = C.getInputArgs().getLastArg(
+              options::OPT_offload_compression_level_EQ))
+        WrapperArgs.push_back(C.getArgs().MakeArgString(
+            Twine("-offload-compression-level=") + A->getValue()));
+    }
+
     // When wrapping an FPGA device binary, we need to be sure to apply the
     // appropriate triple that corresponds (fpga_aocr-intel-<os>)
     // to the target triple setting.
@@ -10867,6 +10991,8 @@ static void getNonTripleBasedSYCLPostLinkOpts(const ToolChain &TC,
       addArgs(PostLinkArgs, TCArgs, {"-split=source"});
     else if (CodeSplitValue == "auto")
       addArgs(PostLinkArgs, TCArgs, {"-split=auto"});
+    else if (CodeSplitValue == "by_size")
+      addArgs(PostLinkArgs, TCArgs, {"-split=size"});
     else { // Device code split is off
     }
   }
@@ -11379,6 +11505,11 @@ void LinkerWrapper::ConstructJob(Compilation &C, const JobAction &JA,
           Args.MakeArgString(Twine("-sycl-dump-device-code=") + DumpDir));
     }
 
+    if (Arg *A =
+            C.getArgs().getLastArg(options::OPT_fsycl_device_code_cache_dir_EQ))
+      CmdArgs.push_back(Args.MakeArgString(
+          Twine("-sycl-device-code-cache-dir=") + A->getValue()));
+
     auto appendOption = [](SmallString<128> &OptString, StringRef AddOpt) {
       if (!OptString.empty())
         OptString += " ";
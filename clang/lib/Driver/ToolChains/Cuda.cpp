@@ -953,6 +953,12 @@ void CudaToolChain::addClangTargetOptions(
     if (FastRelaxedMath || UnsafeMathOpt)
       CC1Args.append({"-mllvm", "--nvptx-prec-divf32=0", "-mllvm",
                       "--nvptx-prec-sqrtf32=0"});
+
+    // Without the global offset, the kernels are not cloned into variants
+    // taking it.
+    if (!DriverArgs.hasFlag(options::OPT_fsycl_global_offset,
+                            options::OPT_fno_sycl_global_offset, true))
+      CC1Args.append({"-mllvm", "-enable-global-offset=false"});
   } else {
     CC1Args.append(
         {"-fcuda-is-device", "-mllvm", "-enable-memcpyopt-without-libcalls"});
@@ -610,6 +610,13 @@ static void InitializeStandardPredefinedMacros(const TargetInfo &TI,
     // flag is used.
     if (LangOpts.SYCLExperimentalRangeRounding)
       Builder.defineMacro("__SYCL_EXP_PARALLEL_FOR_RANGE_ROUNDING__");
+
+    // Set __SYCL_CX_LIMITED_RANGE__ macro for both host and device
+    // compilations if -fcx-limited-range, -fcomplex-arithmetic=basic or
+    // -ffast-math is used, so that the complex types of the SYCL headers
+    // use the same formulas as _Complex types.
+    if (LangOpts.getComplexRange() == LangOptions::ComplexRangeKind::CX_Basic)
+      Builder.defineMacro("__SYCL_CX_LIMITED_RANGE__");
   }
 
   if (LangOpts.DeclareSPIRVBuiltins) {
@@ -53,6 +53,7 @@
 // CK-HELP: {{.*}}-hip-openmp-compatible {{.*}}- Treat hip and hipv4 offload kinds as compatible with openmp kind, and vice versa.
 // CK-HELP: {{.*}}-input=<string>  - Input file.  Can be specified multiple times for multiple input files.
 // CK-HELP: {{.*}}-inputs=<string>  - [<input file>,...] (deprecated)
+// CK-HELP: {{.*}}-jobs=<n> {{.*}}- Number of threads unbundling the members of archives and writing the bundles, or 'all'.
 // CK-HELP: {{.*}}-list {{.*}}- List bundle IDs in the bundled file.
 // CK-HELP: {{.*}}-output=<string>  - Output file.  Can be specified multiple times for multiple output files.
 // CK-HELP: {{.*}}-outputs=<string> - [<output file>,...] (deprecated)
@@ -598,6 +599,18 @@
 // GFX906: simple-openmp-amdgcn-amd-amdhsa-gfx906
 // RUN: llvm-ar t %t-archive-gfx908-simple.a | FileCheck %s -check-prefix=GFX908
 // GFX908-NOT: {{gfx906}}
+
+// The members are unbundled in parallel, the archives must not depend on the
+// number of jobs.
+// RUN: clang-offload-bundler -unbundle -type=a -targets=openmp-amdgcn-amd-amdhsa-gfx906,hip-amdgcn-amd-amdhsa-gfx906 -input=%t.input-archive.a -output=%t-archive-gfx906-jobs1.a -output=%t-hip-archive-gfx906-jobs1.a -hip-openmp-compatible -jobs=1
+// RUN: clang-offload-bundler -unbundle -type=a -targets=openmp-amdgcn-amd-amdhsa-gfx906,hip-amdgcn-amd-amdhsa-gfx906 -input=%t.input-archive.a -output=%t-archive-gfx906-jobs4.a -output=%t-hip-archive-gfx906-jobs4.a -hip-openmp-compatible -jobs=4
+// RUN: cmp %t-archive-gfx906-jobs1.a %t-archive-gfx906-jobs4.a
+// RUN: cmp %t-hip-archive-gfx906-jobs1.a %t-hip-archive-gfx906-jobs4.a
+// RUN: llvm-ar t %t-hip-archive-gfx906-jobs4.a | FileCheck %s -check-prefix=JOBS
+// JOBS: simple-openmp-amdgcn-amd-amdhsa-gfx906
+// JOBS-NEXT: simple2-hip-amdgcn-amd-amdhsa--gfx906
+// RUN: not clang-offload-bundler -unbundle -type=a -targets=openmp-amdgcn-amd-amdhsa-gfx906 -input=%t.input-archive.a -output=%t-archive-gfx906-jobs.a -jobs=many 2>&1 | FileCheck %s -check-prefix=BADJOBS
+// BADJOBS: error: invalid number of jobs 'many'
 // RUN: not clang-offload-bundler -type=o -targets=host-%itanium_abi_triple,openmp-amdgcn-amd-amdhsa-gfx906,openmp-amdgcn-amd-amdhsa-gfx906:sramecc+ -input=%t.o -input=%t.tgt1 -input=%t.tgt2 -output=%t.bad.bundle 2>&1 | FileCheck %s -check-prefix=BADTARGETS
 // BADTARGETS: error: Cannot bundle inputs with conflicting targets: 'openmp-amdgcn-amd-amdhsa-gfx906' and 'openmp-amdgcn-amd-amdhsa-gfx906:sramecc+'
 
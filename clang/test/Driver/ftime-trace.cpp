@@ -55,6 +55,9 @@
 // LINK3: -cc1{{.*}} "-ftime-trace=e{{/|\\\\}}a-{{[^.]*}}.json" "-ftime-trace-granularity=0" "-ftime-trace-verbose"
 // LINK3: -cc1{{.*}} "-ftime-trace=e{{/|\\\\}}b-{{[^.]*}}.json" "-ftime-trace-granularity=0" "-ftime-trace-verbose"
 
+// RUN: %clang -### -c -ftime-trace -ftime-trace-summary d/a.cpp -o e/a.o 2>&1 | FileCheck %s --check-prefix=SUMMARY
+// SUMMARY: -cc1{{.*}} "-ftime-trace=e/a.json" "-ftime-trace-summary"
+
 // RUN: %clang -### -ftime-trace -ftime-trace=e -ftime-trace-granularity=1 -ftime-trace-verbose -xassembler d/a.cpp 2>&1 | \
 // RUN:   FileCheck %s --check-prefix=UNUSED
 // UNUSED:      warning: argument unused during compilation: '-ftime-trace'
@@ -41,6 +41,17 @@ __attribute__((visibility("protected"), used)) int x;
 
 // AMDGPU-LINK: clang{{.*}} -o {{.*}}.img --target=amdgcn-amd-amdhsa -mcpu=gfx908 -O2 -flto -Wl,--no-undefined {{.*}}.o {{.*}}.o
 
+// RUN: clang-linker-wrapper --host-triple=x86_64-unknown-linux-gnu --dry-run \
+// RUN:   --device-debug --link-device-debug-info \
+// RUN:   --linker-path=/usr/bin/ld %t.o -o a.out 2>&1 | FileCheck %s --check-prefix=AMDGPU-DWARF-LINK
+// RUN: clang-linker-wrapper --host-triple=x86_64-unknown-linux-gnu --dry-run \
+// RUN:   --link-device-debug-info \
+// RUN:   --linker-path=/usr/bin/ld %t.o -o a.out 2>&1 | FileCheck %s --check-prefix=AMDGPU-NO-DWARF-LINK
+
+// AMDGPU-DWARF-LINK: clang{{.*}} -o [[IMG:.+\.img]] --target=amdgcn-amd-amdhsa -mcpu=gfx908
+// AMDGPU-DWARF-LINK: llvm-dwarfutil{{.*}} --linker=parallel --num-threads={{[0-9]+}} [[IMG]] {{.*}}.dwarf{{.*}}.img
+// AMDGPU-NO-DWARF-LINK-NOT: llvm-dwarfutil
+
 // RUN: clang-offload-packager -o %t.out \
 // RUN:   --image=file=%t.amdgpu.bc,kind=openmp,triple=amdgcn-amd-amdhsa,arch=gfx1030 \
 // RUN:   --image=file=%t.amdgpu.bc,kind=openmp,triple=amdgcn-amd-amdhsa,arch=gfx1030
@@ -0,0 +1,20 @@
+// REQUIRES: nvptx-registered-target
+
+// RUN: %clang -### -nocudalib \
+// RUN:   -fsycl -fsycl-targets=nvptx64-nvidia-cuda %s 2>&1 \
+// RUN: | FileCheck --check-prefix=CHECK-DEFAULT %s
+
+// RUN: %clang -### -nocudalib \
+// RUN:   -fsycl -fsycl-targets=nvptx64-nvidia-cuda -fno-sycl-global-offset %s 2>&1 \
+// RUN: | FileCheck --check-prefix=CHECK-DISABLED %s
+
+// RUN: %clang -### -nocudalib \
+// RUN:   -fsycl -fsycl-targets=nvptx64-nvidia-cuda -fno-sycl-global-offset \
+// RUN:   -fsycl-global-offset %s 2>&1 \
+// RUN: | FileCheck --check-prefix=CHECK-DEFAULT %s
+
+// CHECK-DISABLED-DAG: "-mllvm" "-enable-global-offset=false"
+// CHECK-DISABLED-DAG: "-D__SYCL_DISABLE_GLOBAL_OFFSET__"
+
+// CHECK-DEFAULT-NOT: "-enable-global-offset=false"
+// CHECK-DEFAULT-NOT: "-D__SYCL_DISABLE_GLOBAL_OFFSET__"
@@ -91,3 +91,32 @@
 // RUN:  %clangxx -fsycl --offload-new-driver -MD -c %s -o dummy -### 2>&1 \
 // RUN:   | FileCheck -check-prefix DEP_GEN_OUT_ERROR %s
 // DEP_GEN_OUT_ERROR-NOT: cannot specify -o when generating multiple output files
+
+/// With parallel compilation jobs, only one device compilation writes the
+/// integration files included by the host compilation.
+// RUN:  %clangxx -fsycl --offload-new-driver -fsycl-max-parallel-compile-jobs=2 \
+// RUN:    -fsycl-targets=spir64,spir64_x86_64 %s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix PARALLEL-JOBS %s
+// PARALLEL-JOBS: clang{{.*}} "-fsycl-is-device"{{.*}} "-fsycl-int-header=[[INTHEADER:.+\.h]]" "-fsycl-int-footer=[[INTFOOTER:.+\.h]]"
+// PARALLEL-JOBS-NOT: "-fsycl-int-header=[[INTHEADER]]"
+// PARALLEL-JOBS: clang{{.*}} "-fsycl-is-device"{{.*}} "-fsycl-int-header={{.+\.h}}" "-fsycl-int-footer={{.+\.h}}"
+// PARALLEL-JOBS: clang{{.*}} "-include" "[[INTHEADER]]"
+// PARALLEL-JOBS-SAME: "-include-footer" "[[INTFOOTER]]"
+// PARALLEL-JOBS-SAME: "-fsycl-is-host"
+
+/// The SYCL header is precompiled for the host and the device compilations,
+/// without the integration files of the source.
+// RUN: rm -rf %t.dir && mkdir -p %t.dir/bin %t.dir/include/sycl
+// RUN: touch %t.dir/include/sycl/sycl.hpp
+// RUN:  %clangxx -fsycl --offload-new-driver -target x86_64-unknown-linux-gnu \
+// RUN:    -ccc-install-dir %t.dir/bin -fsycl-pch-cache=%t.dir/cache %s -### 2>&1 \
+// RUN:   | FileCheck -check-prefix PCH-CACHE %s
+// PCH-CACHE: clang{{.*}} "-fsycl-is-device"
+// PCH-CACHE-NOT: "-fsycl-int-header=
+// PCH-CACHE-SAME: "-emit-pch" "-o" "[[DEVICE_PCH:.+sycl-spir64-unknown-unknown-.+\.pch]]" "-x" "c++-header" "{{.*}}sycl.hpp"
+// PCH-CACHE: clang{{.*}} "-fsycl-is-device"{{.*}} "-fsycl-int-header={{.+\.h}}"
+// PCH-CACHE-SAME: "-include-pch" "[[DEVICE_PCH]]"
+// PCH-CACHE: clang{{.*}} "-fsycl-is-host"
+// PCH-CACHE-SAME: "-emit-pch" "-o" "[[HOST_PCH:.+sycl-x86_64-unknown-linux-gnu-.+\.pch]]"
+// PCH-CACHE: clang{{.*}} "-include" "{{.+\.h}}"{{.*}} "-fsycl-is-host"
+// PCH-CACHE-SAME: "-include-pch" "[[HOST_PCH]]"
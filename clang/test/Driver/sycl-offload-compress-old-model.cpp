@@ -0,0 +1,20 @@
+/// Check that device image compression options are passed to
+/// clang-offload-wrapper.
+
+// RUN: %clangxx -### -fsycl --no-offload-new-driver --offload-compress %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-COMPRESS
+// CHECK-COMPRESS: clang-offload-wrapper{{.*}} "-offload-compress"
+// CHECK-COMPRESS-NOT: "-offload-compression-level
+
+// RUN: %clangxx -### -fsycl --no-offload-new-driver --offload-compress \
+// RUN:   --offload-compression-level=3 %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-LEVEL
+// CHECK-LEVEL: clang-offload-wrapper{{.*}} "-offload-compress" "-offload-compression-level=3"
+
+// RUN: %clangxx -### -fsycl --no-offload-new-driver --offload-compress \
+// RUN:   --no-offload-compress %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-NO-COMPRESS
+// RUN: %clangxx -### -fsycl --no-offload-new-driver %s 2>&1 \
+// RUN:   | FileCheck %s -check-prefix=CHECK-NO-COMPRESS
+// CHECK-NO-COMPRESS: clang-offload-wrapper
+// CHECK-NO-COMPRESS-NOT: "-offload-compress"
@@ -111,6 +111,15 @@
 // RUN:   %clang_cl -### -fsycl-max-parallel-link-jobs=4  %s 2>&1 \
 // RUN:   | FileCheck -check-prefix=WARNING-UNUSED-ARG -DOPT=-fsycl-max-parallel-link-jobs=4 %s
 
+// Warning should be emitted when using -fsycl-max-parallel-compile-jobs without -fsycl
+// RUN:   %clang -### -fsycl-max-parallel-compile-jobs=4  %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=WARNING-UNUSED-ARG -DOPT=-fsycl-max-parallel-compile-jobs=4 %s
+
+// Error should be emitted when -fsycl-max-parallel-compile-jobs isn't a positive number
+// RUN:   not %clang -### -fsycl -fsycl-max-parallel-compile-jobs=0  %s 2>&1 \
+// RUN:   | FileCheck -check-prefix=INVALID-PARALLEL-JOBS %s
+// INVALID-PARALLEL-JOBS: error: invalid integral value '0' in '-fsycl-max-parallel-compile-jobs=0'
+
 // Warning should be emitted when using -fsycl-optimize-non-user-code without -fsycl
 // RUN:   %clang -### -fsycl-optimize-non-user-code  %s 2>&1 \
 // RUN:   | FileCheck -check-prefix=WARNING-UNUSED-ARG -DOPT=-fsycl-optimize-non-user-code %s
@@ -19,6 +19,7 @@
 #include "clang/Basic/Version.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/BinaryFormat/Magic.h"
+#include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/CodeGen/CommandFlags.h"
 #include "llvm/Frontend/Offloading/OffloadWrapper.h"
@@ -26,7 +27,9 @@
 #include "llvm/Frontend/Offloading/Utility.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DiagnosticPrinter.h"
+#include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/ModuleSummaryIndex.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/LTO/LTO.h"
 #include "llvm/MC/TargetRegistry.h"
@@ -40,15 +43,18 @@
 #include "llvm/Option/ArgList.h"
 #include "llvm/Option/OptTable.h"
 #include "llvm/Option/Option.h"
+#include "llvm/Passes/PassBuilder.h"
 #include "llvm/Passes/PassPlugin.h"
 #include "llvm/Remarks/HotnessThresholdParser.h"
 #include "llvm/SYCLLowerIR/ModuleSplitter.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FileOutputBuffer.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FileUtilities.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/Jobserver.h"
 #include "llvm/Support/LineIterator.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Parallel.h"
@@ -59,12 +65,16 @@
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetMachine.h"
 #include "llvm/TargetParser/Host.h"
+#include "llvm/Transforms/IPO/FunctionImport.h"
+#include "llvm/Transforms/Utils/FunctionImportUtils.h"
 #include <atomic>
+#include <condition_variable>
 #include <optional>
 
 #define COMPILE_OPTS "compile-opts"
@@ -158,6 +168,9 @@ static bool UseSYCLPostLinkTool;
 
 SmallString<128> SPIRVDumpDir;
 
+/// Directory of the SYCL device code cache, empty if it is disabled.
+SmallString<128> SYCLDeviceCodeCacheDir;
+
 using OffloadingImage = OffloadBinary::OffloadingImage;
 
 namespace llvm {
@@ -310,14 +323,59 @@ Expected<StringRef> writeOffloadFile(const OffloadFile &File) {
 }
 
 /// Execute the command \p ExecutablePath with the arguments \p Args.
+namespace jobs {
+/// Limits the number of tools run at the same time to the number of parallel
+/// jobs. Under a build with a jobserver, each tool also holds a job slot of
+/// the jobserver, so that the tools count against the job limit of the build.
+static unsigned Limit = 1;
+static unsigned Running = 0;
+static std::mutex Mutex;
+static std::condition_variable Released;
+
+static bool hasJobServer() { return JobserverClient::getInstance() != nullptr; }
+
+/// A job slot, held while a tool runs.
+class Slot {
+public:
+  Slot() {
+    {
+      std::unique_lock<std::mutex> Lock(Mutex);
+      Released.wait(Lock, [] { return Running < Limit; });
+      ++Running;
+    }
+    if (JobserverClient *Jobserver = JobserverClient::getInstance())
+      JobserverSlot = Jobserver->acquire();
+  }
+
+  ~Slot() {
+    JobserverSlot.release();
+    std::lock_guard<std::mutex> Lock(Mutex);
+    --Running;
+    Released.notify_one();
+  }
+
+private:
+  JobSlot JobserverSlot;
+};
+
+/// Runs the jobs building the device images of the SYCL split modules. Never
+/// destroyed, as the wrapper may exit while they run.
+static DefaultThreadPool &getSYCLJobPool() {
+  static DefaultThreadPool *Pool = new DefaultThreadPool(parallel::strategy);
+  return *Pool;
+}
+} // namespace jobs
+
 Error executeCommands(StringRef ExecutablePath, ArrayRef<StringRef> Args) {
   if (Verbose || DryRun)
     printCommands(Args);
 
-  if (!DryRun)
-    if (sys::ExecuteAndWait(ExecutablePath, Args))
-      return createStringError(
-          "'%s' failed", sys::path::filename(ExecutablePath).str().c_str());
+  if (DryRun)
+    return Error::success();
+  jobs::Slot Slot;
+  if (sys::ExecuteAndWait(ExecutablePath, Args))
+    return createStringError(
+        "'%s' failed", sys::path::filename(ExecutablePath).str().c_str());
   return Error::success();
 }
 
@@ -635,6 +693,31 @@ static Expected<StringRef> convertSPIRVToIR(StringRef Filename,
   return *TempFileOrErr;
 }
 
+/// Converts the SPIR-V files among \p Filenames into LLVM IR files; the
+/// reverse translations run in parallel, each of them being a job.
+/// Returns the files to use instead of \p Filenames, in the same order.
+static Expected<SmallVector<StringRef, 16>>
+convertSPIRVToIR(ArrayRef<StringRef> Filenames, const ArgList &Args) {
+  SmallVector<StringRef, 16> IRFiles(Filenames.size());
+  std::mutex ErrMtx;
+  Error ConvertErr = Error::success();
+  ThreadPoolTaskGroup Jobs(jobs::getSYCLJobPool());
+  for (size_t I = 0, E = Filenames.size(); I != E; ++I)
+    Jobs.async([&, I] {
+      auto IRFile = convertSPIRVToIR(Filenames[I], Args);
+      if (IRFile) {
+        IRFiles[I] = *IRFile;
+        return;
+      }
+      std::scoped_lock Guard(ErrMtx);
+      ConvertErr = joinErrors(std::move(ConvertErr), IRFile.takeError());
+    });
+  Jobs.wait();
+  if (ConvertErr)
+    return std::move(ConvertErr);
+  return IRFiles;
+}
+
 /// Add any sycl-post-link options that rely on a specific Triple in addition
 /// to user supplied options.
 /// NOTE: Any changes made here should be reflected in the similarly named
@@ -1226,14 +1309,14 @@ Expected<StringRef> linkDeviceInputFiles(SmallVectorImpl<StringRef> &InputFiles,
   if (!OutFileOrErr)
     return OutFileOrErr.takeError();
 
+  auto IRFilesOrErr = sycl::convertSPIRVToIR(InputFiles, Args);
+  if (!IRFilesOrErr)
+    return IRFilesOrErr.takeError();
+
   SmallVector<StringRef, 8> CmdArgs;
   CmdArgs.push_back(*LLVMLinkPath);
-  for (auto &File : InputFiles) {
-    auto IRFile = sycl::convertSPIRVToIR(File, Args);
-    if (!IRFile)
-      return IRFile.takeError();
-    CmdArgs.push_back(*IRFile);
-  }
+  for (StringRef IRFile : *IRFilesOrErr)
+    CmdArgs.push_back(IRFile);
   CmdArgs.push_back("-o");
   CmdArgs.push_back(*OutFileOrErr);
   CmdArgs.push_back("--suppress-warnings");
@@ -1277,6 +1360,163 @@ linkDeviceLibFiles(SmallVectorImpl<StringRef> &InputFiles,
   return *OutFileOrErr;
 }
 
+/// Optimizes each SYCL device input file in the context of the others before
+/// they are linked together, ThinLTO style: a combined index of the module
+/// summaries drives the import of the functions called across translation
+/// units, then each module is optimized with the ThinLTO post-link pipeline
+/// on its own, in parallel. Imported definitions are dropped by the pipeline
+/// once inlined, and nothing is internalized, so the modules can still be
+/// linked by llvm-link. Inputs without a module summary are returned as is.
+/// 'InputFiles' is the list of all device input files.
+/// 'Args' encompasses all arguments required for linking and wrapping device
+/// code.
+static Expected<SmallVector<StringRef, 16>>
+runThinLTO(ArrayRef<StringRef> InputFiles, const ArgList &Args) {
+  llvm::TimeTraceScope TimeScope("SYCL ThinLTO");
+
+  struct ThinLTOModule {
+    StringRef File;
+    std::unique_ptr<MemoryBuffer> Buffer;
+    std::unique_ptr<lto::InputFile> Input;
+    StringRef OutputFile;
+  };
+  SmallVector<ThinLTOModule, 16> Modules;
+  StringMap<ThinLTOModule *> ModuleMap;
+  SmallVector<StringRef, 16> OutputFiles;
+  ModuleSummaryIndex Index(/*HaveGVs=*/false);
+  auto IRFilesOrErr = sycl::convertSPIRVToIR(InputFiles, Args);
+  if (!IRFilesOrErr)
+    return IRFilesOrErr.takeError();
+  for (StringRef IRFile : *IRFilesOrErr) {
+    auto BufferOrErr = MemoryBuffer::getFile(IRFile);
+    if (!BufferOrErr)
+      return createFileError(IRFile, BufferOrErr.getError());
+    auto InputOrErr = lto::InputFile::create((*BufferOrErr)->getMemBufferRef());
+    if (!InputOrErr)
+      return InputOrErr.takeError();
+    BitcodeModule &BM = (*InputOrErr)->getSingleBitcodeModule();
+    Expected<BitcodeLTOInfo> LTOInfo = BM.getLTOInfo();
+    if (!LTOInfo)
+      return LTOInfo.takeError();
+    if (!LTOInfo->HasSummary) {
+      OutputFiles.push_back(IRFile);
+      continue;
+    }
+    if (Error Err = BM.readSummary(Index, IRFile))
+      return std::move(Err);
+    Modules.push_back(
+        {IRFile, std::move(*BufferOrErr), std::move(*InputOrErr), ""});
+  }
+  if (Modules.size() < 2) {
+    for (ThinLTOModule &Mod : Modules)
+      OutputFiles.push_back(Mod.File);
+    return OutputFiles;
+  }
+  for (ThinLTOModule &Mod : Modules)
+    ModuleMap[Mod.File] = &Mod;
+
+  // The first strong definition of a symbol prevails, as with llvm-link.
+  DenseMap<GlobalValue::GUID, const GlobalValueSummary *> Prevailing;
+  for (const auto &[GUID, Info] : Index) {
+    const auto &Summaries = Info.SummaryList;
+    if (Summaries.size() < 2)
+      continue;
+    auto It = llvm::find_if(Summaries, [](const auto &Summary) {
+      return !GlobalValue::isAvailableExternallyLinkage(Summary->linkage()) &&
+             !GlobalValue::isWeakForLinker(Summary->linkage());
+    });
+    Prevailing[GUID] = It != Summaries.end() ? It->get() : Summaries[0].get();
+  }
+  auto IsPrevailing = [&](GlobalValue::GUID GUID,
+                          const GlobalValueSummary *Summary) {
+    auto It = Prevailing.find(GUID);
+    return It == Prevailing.end() || It->second == Summary;
+  };
+
+  DenseMap<StringRef, GVSummaryMapTy> ModuleToDefinedGVSummaries(
+      Modules.size());
+  Index.collectDefinedGVSummariesPerModule(ModuleToDefinedGVSummaries);
+  FunctionImporter::ImportListsTy ImportLists(Modules.size());
+  DenseMap<StringRef, FunctionImporter::ExportSetTy> ExportLists(
+      Modules.size());
+  ComputeCrossModuleImport(Index, ModuleToDefinedGVSummaries, IsPrevailing,
+                           ImportLists, ExportLists);
+
+  // The local values referenced by the functions imported into other modules
+  // have to be promoted to globals, renameModuleForThinLTO picks the new
+  // linkage up from the index.
+  for (auto &[ModulePath, ExportList] : ExportLists)
+    for (ValueInfo VI : ExportList)
+      for (const auto &Summary : VI.getSummaryList())
+        if (Summary->modulePath() == ModulePath &&
+            GlobalValue::isLocalLinkage(Summary->linkage()))
+          Summary->setLinkage(GlobalValue::ExternalLinkage);
+
+  StringRef OptLevel = Args.getLastArgValue(OPT_opt_level, "O2");
+  OptimizationLevel Level = OptLevel == "O0"   ? OptimizationLevel::O0
+                            : OptLevel == "O1" ? OptimizationLevel::O1
+                            : OptLevel == "O3" ? OptimizationLevel::O3
+                                               : OptimizationLevel::O2;
+
+  auto Err = parallelForEachError(Modules, [&](ThinLTOModule &Mod) -> Error {
+    LLVMContext Context;
+    Expected<std::unique_ptr<Module>> MOrErr =
+        Mod.Input->getSingleBitcodeModule().parseModule(Context);
+    if (!MOrErr)
+      return MOrErr.takeError();
+    Module &M = **MOrErr;
+
+    if (renameModuleForThinLTO(M, Index,
+                               /*ClearDSOLocalOnDeclarations=*/false))
+      return createStringError("failed to promote the exported values of " +
+                               Mod.File);
+    auto Loader = [&](StringRef Identifier) {
+      return ModuleMap.lookup(Identifier)
+          ->Input->getSingleBitcodeModule()
+          .getLazyModule(Context, /*ShouldLazyLoadMetadata=*/true,
+                         /*IsImporting=*/true);
+    };
+    FunctionImporter Importer(Index, Loader,
+                              /*ClearDSOLocalOnDeclarations=*/false);
+    Expected<bool> Imported =
+        Importer.importFunctions(M, ImportLists.lookup(Mod.File));
+    if (!Imported)
+      return Imported.takeError();
+
+    LoopAnalysisManager LAM;
+    FunctionAnalysisManager FAM;
+    CGSCCAnalysisManager CGAM;
+    ModuleAnalysisManager MAM;
+    PassBuilder PB;
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    ModulePassManager MPM =
+        PB.buildThinLTODefaultPipeline(Level, /*ImportSummary=*/nullptr);
+    MPM.run(M, MAM);
+
+    auto OutFileOrErr = createOutputFile(
+        sys::path::filename(ExecutableName) + ".thinlto", "bc");
+    if (!OutFileOrErr)
+      return OutFileOrErr.takeError();
+    std::error_code EC;
+    raw_fd_ostream OS(*OutFileOrErr, EC, sys::fs::OF_None);
+    if (EC)
+      return createFileError(*OutFileOrErr, EC);
+    WriteBitcodeToFile(M, OS);
+    Mod.OutputFile = *OutFileOrErr;
+    return Error::success();
+  });
+  if (Err)
+    return std::move(Err);
+
+  for (ThinLTOModule &Mod : Modules)
+    OutputFiles.push_back(Mod.OutputFile);
+  return OutputFiles;
+}
+
 /// This function is used to link all SYCL device input files into a single
 /// LLVM IR file. This file is in turn linked with all SYCL device library
 /// files.
@@ -1289,6 +1529,13 @@ static Expected<StringRef> linkDevice(ArrayRef<StringRef> InputFiles,
   SmallVector<StringRef, 16> InputFilesVec;
   for (StringRef InputFile : InputFiles)
     InputFilesVec.emplace_back(InputFile);
+  // Cross translation unit optimization ahead of the first llvm-link step.
+  if (Args.hasArg(OPT_sycl_thin_lto) && InputFilesVec.size() > 1) {
+    auto OptimizedFilesOrErr = sycl::runThinLTO(InputFilesVec, Args);
+    if (!OptimizedFilesOrErr)
+      return OptimizedFilesOrErr.takeError();
+    InputFilesVec = std::move(*OptimizedFilesOrErr);
+  }
   // First llvm-link step.
   auto LinkedFile = sycl::linkDeviceInputFiles(InputFilesVec, Args);
   if (!LinkedFile)
@@ -1501,6 +1748,158 @@ Error extractBundledObjects(StringRef Filename, const ArgList &Args,
   return Error::success();
 }
 
+/// Cache of the SYCL device code built by previous links, enabled with
+/// --sycl-device-code-cache-dir. The outputs of the split step are keyed by
+/// the hash of the linked device code, and the image built for each split
+/// module by the hash of its bitcode. The split modules an incremental build
+/// leaves unchanged thereby skip translation and AOT compilation. The keys
+/// also cover the options of the device link and the version of the tool.
+namespace cache {
+static Expected<std::string> getKey(StringRef Kind, StringRef File,
+                                    const ArgList &Args) {
+  auto BufferOrErr = MemoryBuffer::getFile(File);
+  if (!BufferOrErr)
+    return createFileError(File, BufferOrErr.getError());
+
+  llvm::MD5 Hasher;
+  Hasher.update(clang::getClangToolFullVersion("clang-linker-wrapper"));
+  for (const Arg *A : Args) {
+    if (A->getOption().matches(OPT_INPUT) || A->getOption().matches(OPT_o) ||
+        A->getOption().matches(OPT_sycl_device_code_cache_dir_EQ))
+      continue;
+    Hasher.update(A->getAsString(Args));
+    Hasher.update(StringRef("\0", 1));
+  }
+  Hasher.update((*BufferOrErr)->getBuffer());
+  llvm::MD5::MD5Result Hash;
+  Hasher.final(Hash);
+  return (Kind + "-" + Hash.digest()).str();
+}
+
+static std::string getPath(const Twine &Name) {
+  SmallString<128> Path(SYCLDeviceCodeCacheDir);
+  sys::path::append(Path, Name);
+  return std::string(Path);
+}
+
+/// Writes an entry of the cache through a temporary file, so that concurrent
+/// links never see it partially written.
+static Error writeEntry(StringRef Path,
+                        function_ref<void(raw_ostream &)> Write) {
+  SmallString<128> TempPath;
+  int FD;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(Path + ".%%%%%%.tmp", FD, TempPath))
+    return createFileError(Path, EC);
+  raw_fd_ostream OS(FD, /*shouldClose=*/true);
+  Write(OS);
+  OS.close();
+  if (std::error_code EC = OS.error()) {
+    OS.clear_error();
+    sys::fs::remove(TempPath);
+    return createFileError(Path, EC);
+  }
+  if (std::error_code EC = sys::fs::rename(TempPath, Path)) {
+    sys::fs::remove(TempPath);
+    return createFileError(Path, EC);
+  }
+  return Error::success();
+}
+
+static Error copyToEntry(StringRef File, StringRef Path) {
+  auto BufferOrErr = MemoryBuffer::getFile(File);
+  if (!BufferOrErr)
+    return createFileError(File, BufferOrErr.getError());
+  StringRef Contents = (*BufferOrErr)->getBuffer();
+  return writeEntry(Path, [&](raw_ostream &OS) { OS << Contents; });
+}
+
+/// Failing to fill the cache does not fail the link.
+static void warnNotCached(Error Err) {
+  WithColor::warning(errs(), LinkerExecutable)
+      << "SYCL device code not cached: " << toString(std::move(Err)) << "\n";
+}
+
+static Error storeSplitModules(StringRef Key,
+                               ArrayRef<module_split::SplitModule> Modules) {
+  std::string Table = "[Code|Properties|Symbols]\n";
+  for (size_t I = 0, E = Modules.size(); I != E; ++I) {
+    const module_split::SplitModule &Module = Modules[I];
+    std::string Base = getPath(Key + "." + Twine(I));
+    if (Error Err = copyToEntry(Module.ModuleFilePath, Base + ".bc"))
+      return Err;
+    if (Error Err = writeEntry(Base + ".prop", [&](raw_ostream &OS) {
+          Module.Properties.write(OS);
+        }))
+      return Err;
+    if (Error Err = writeEntry(Base + ".sym",
+                               [&](raw_ostream &OS) { OS << Module.Symbols; }))
+      return Err;
+    Table += Base + ".bc|" + Base + ".prop|" + Base + ".sym\n";
+  }
+  // The table is written last, its presence marks the entry as complete.
+  return writeEntry(getPath(Key + ".table"),
+                    [&](raw_ostream &OS) { OS << Table; });
+}
+
+/// Returns the split modules of the linked device code \p File, from the
+/// cache or by running \p Split.
+static Expected<std::vector<module_split::SplitModule>> getSplitModules(
+    StringRef File, const ArgList &Args,
+    function_ref<Expected<std::vector<module_split::SplitModule>>()> Split) {
+  if (SYCLDeviceCodeCacheDir.empty() || DryRun)
+    return Split();
+
+  auto KeyOrErr = getKey("split", File, Args);
+  if (!KeyOrErr)
+    return KeyOrErr.takeError();
+  std::string Table = getPath(*KeyOrErr + ".table");
+  if (sys::fs::exists(Table)) {
+    auto ModulesOrErr = module_split::parseSplitModulesFromFile(Table);
+    if (ModulesOrErr) {
+      if (Verbose)
+        errs() << formatv("sycl-device-code-cache: reusing {0}\n", Table);
+      return ModulesOrErr;
+    }
+    // Entries removed from the cache directory are rebuilt.
+    consumeError(ModulesOrErr.takeError());
+  }
+
+  auto ModulesOrErr = Split();
+  if (ModulesOrErr)
+    if (Error Err = storeSplitModules(*KeyOrErr, *ModulesOrErr))
+      warnNotCached(std::move(Err));
+  return ModulesOrErr;
+}
+
+/// Returns the device image of the split module \p File, from the cache or by
+/// running \p Build.
+static Expected<StringRef>
+getImage(StringRef File, const ArgList &Args,
+         function_ref<Expected<StringRef>()> Build) {
+  if (SYCLDeviceCodeCacheDir.empty() || DryRun)
+    return Build();
+
+  auto KeyOrErr = getKey("image", File, Args);
+  if (!KeyOrErr)
+    return KeyOrErr.takeError();
+  std::string Path = getPath(*KeyOrErr + ".image");
+  if (sys::fs::exists(Path)) {
+    if (Verbose)
+      errs() << formatv("sycl-device-code-cache: reusing {0}\n", Path);
+    return StringRef(Args.MakeArgString(Path));
+  }
+
+  auto ImageOrErr = Build();
+  // Targets not producing an image, e.g. JIT compilation for the host, return
+  // an empty path.
+  if (ImageOrErr && !ImageOrErr->empty())
+    if (Error Err = copyToEntry(*ImageOrErr, Path))
+      warnNotCached(std::move(Err));
+  return ImageOrErr;
+}
+} // namespace cache
+
 } // namespace sycl
 
 namespace generic {
@@ -1638,6 +2037,88 @@ Expected<StringRef> clang(ArrayRef<StringRef> InputFiles, const ArgList &Args,
 }
 } // namespace generic
 
+namespace dwarf {
+/// Returns true if \p File is an ELF file with DWARF sections.
+static bool hasDebugInfo(StringRef File) {
+  ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
+      MemoryBuffer::getFile(File, /*IsText=*/false,
+                            /*RequiresNullTerminator=*/false);
+  if (!BufferOrErr)
+    return false;
+  Expected<std::unique_ptr<ObjectFile>> ObjOrErr =
+      ObjectFile::createObjectFile(**BufferOrErr);
+  if (!ObjOrErr) {
+    consumeError(ObjOrErr.takeError());
+    return false;
+  }
+  if (!isa<ELFObjectFileBase>(ObjOrErr->get()))
+    return false;
+  for (const SectionRef &Section : (*ObjOrErr)->sections()) {
+    Expected<StringRef> NameOrErr = Section.getName();
+    if (!NameOrErr) {
+      consumeError(NameOrErr.takeError());
+      continue;
+    }
+    if (NameOrErr->starts_with(".debug_"))
+      return true;
+  }
+  return false;
+}
+
+/// Links the DWARF of the device image \p File with the parallel DWARF linker
+/// of llvm-dwarfutil, which deduplicates the types and drops the debug info of
+/// the code removed by the device link, then compresses the debug sections.
+/// The images which aren't ELF files with debug info are left as they are.
+Expected<StringRef> linkDebugInfo(StringRef File, const ArgList &Args) {
+  if (!Args.hasArg(OPT_debug) || !Args.hasArg(OPT_link_device_debug_info))
+    return File;
+  if (!DryRun && !hasDebugInfo(File))
+    return File;
+  llvm::TimeTraceScope TimeScope("Link device debug info");
+
+  Expected<std::string> DwarfutilPath =
+      findProgram("llvm-dwarfutil", {getMainExecutable("llvm-dwarfutil")});
+  if (!DwarfutilPath)
+    return DwarfutilPath.takeError();
+
+  auto TempFileOrErr = createOutputFile(
+      sys::path::filename(ExecutableName) + ".dwarf",
+      sys::path::extension(File).drop_front());
+  if (!TempFileOrErr)
+    return TempFileOrErr.takeError();
+
+  SmallVector<StringRef, 8> CmdArgs;
+  CmdArgs.push_back(*DwarfutilPath);
+  CmdArgs.push_back("--linker=parallel");
+  CmdArgs.push_back(Args.MakeArgString("--num-threads=" + Twine(jobs::Limit)));
+  CmdArgs.push_back(File);
+  CmdArgs.push_back(*TempFileOrErr);
+  if (Error Err = executeCommands(*DwarfutilPath, CmdArgs))
+    return std::move(Err);
+
+  StringRef Format = compression::zstd::isAvailable()   ? "zstd"
+                     : compression::zlib::isAvailable() ? "zlib"
+                                                        : "";
+  if (Format.empty())
+    return *TempFileOrErr;
+
+  Expected<std::string> ObjcopyPath =
+      findProgram("llvm-objcopy", {getMainExecutable("llvm-objcopy")});
+  if (!ObjcopyPath)
+    return ObjcopyPath.takeError();
+
+  SmallVector<StringRef, 4> ObjcopyArgs = {
+      *ObjcopyPath,
+      Args.MakeArgString("--compress-debug-sections=" + Format),
+      *TempFileOrErr,
+  };
+  if (Error Err = executeCommands(*ObjcopyPath, ObjcopyArgs))
+    return std::move(Err);
+
+  return *TempFileOrErr;
+}
+} // namespace dwarf
+
 Expected<StringRef> linkDevice(ArrayRef<StringRef> InputFiles,
                                const ArgList &Args, bool IsSYCLKind = false) {
   const llvm::Triple Triple(Args.getLastArgValue(OPT_triple_EQ));
@@ -2397,11 +2878,14 @@ Expected<SmallVector<StringRef>> linkAndWrapDeviceFiles(
         return TmpOutputOrErr.takeError();
       SmallVector<StringRef> InputFilesSYCL;
       InputFilesSYCL.emplace_back(*TmpOutputOrErr);
-      auto SplitModulesOrErr =
-          UseSYCLPostLinkTool
-              ? sycl::runSYCLPostLinkTool(InputFilesSYCL, LinkerArgs)
-              : sycl::runSYCLSplitLibrary(InputFilesSYCL, LinkerArgs,
-                                          *SYCLModuleSplitMode);
+      auto SplitModulesOrErr = sycl::cache::getSplitModules(
+          *TmpOutputOrErr, LinkerArgs,
+          [&]() -> Expected<std::vector<module_split::SplitModule>> {
+            return UseSYCLPostLinkTool
+                       ? sycl::runSYCLPostLinkTool(InputFilesSYCL, LinkerArgs)
+                       : sycl::runSYCLSplitLibrary(InputFilesSYCL, LinkerArgs,
+                                                   *SYCLModuleSplitMode);
+          });
       if (!SplitModulesOrErr)
         return SplitModulesOrErr.takeError();
 
@@ -2420,41 +2904,71 @@ Expected<SmallVector<StringRef>> linkAndWrapDeviceFiles(
           return OutputFile.takeError();
         WrappedOutput.push_back(*OutputFile);
       }
-      for (size_t I = 0, E = SplitModules.size(); I != E; ++I) {
-        SmallVector<StringRef> Files = {SplitModules[I].ModuleFilePath};
-        StringRef Arch = LinkerArgs.getLastArgValue(OPT_arch_EQ);
+      // The device images of the split modules are built in parallel, the
+      // job slots bounding the number of tools running at the same time.
+      auto BuildImage = [&](module_split::SplitModule &SplitModule) -> Error {
+        // Each job needs its own copy of the arguments, see above.
+        BumpPtrAllocator Alloc;
+        StringSaver Saver(Alloc);
+        auto BaseArgs =
+            Tbl.parseArgs(Argc, Argv, OPT_INVALID, Saver, [](StringRef Err) {
+              reportError(createStringError(Err));
+            });
+        auto SplitArgs = getLinkerArgs(Input, BaseArgs);
+        SmallVector<StringRef> Files = {SplitModule.ModuleFilePath};
+        StringRef Arch = SplitArgs.getLastArgValue(OPT_arch_EQ);
         if (Arch.empty())
           Arch = "native";
         SmallVector<std::pair<StringRef, StringRef>, 4> BundlerInputFiles;
-        auto ClangOutputOrErr =
-            linkDevice(Files, LinkerArgs, true /* IsSYCLKind */);
+        auto ClangOutputOrErr = sycl::cache::getImage(
+            Files.front(), SplitArgs, [&]() -> Expected<StringRef> {
+              auto OutputOrErr =
+                  linkDevice(Files, SplitArgs, true /* IsSYCLKind */);
+              if (!OutputOrErr)
+                return OutputOrErr.takeError();
+              return dwarf::linkDebugInfo(*OutputOrErr, SplitArgs);
+            });
         if (!ClangOutputOrErr)
           return ClangOutputOrErr.takeError();
         if (Triple.isNVPTX()) {
           auto VirtualArch = StringRef(clang::OffloadArchToVirtualArchString(
               clang::StringToOffloadArch(Arch)));
           auto PtxasOutputOrErr =
-              nvptx::ptxas(*ClangOutputOrErr, LinkerArgs, Arch);
+              nvptx::ptxas(*ClangOutputOrErr, SplitArgs, Arch);
           if (!PtxasOutputOrErr)
             return PtxasOutputOrErr.takeError();
           BundlerInputFiles.emplace_back(*ClangOutputOrErr, VirtualArch);
           BundlerInputFiles.emplace_back(*PtxasOutputOrErr, Arch);
           auto BundledFileOrErr =
-              nvptx::fatbinary(BundlerInputFiles, LinkerArgs);
+              nvptx::fatbinary(BundlerInputFiles, SplitArgs);
           if (!BundledFileOrErr)
             return BundledFileOrErr.takeError();
-          SplitModules[I].ModuleFilePath = *BundledFileOrErr;
+          SplitModule.ModuleFilePath = *BundledFileOrErr;
         } else if (Triple.isAMDGCN()) {
           BundlerInputFiles.emplace_back(*ClangOutputOrErr, Arch);
           auto BundledFileOrErr =
-              amdgcn::fatbinary(BundlerInputFiles, LinkerArgs);
+              amdgcn::fatbinary(BundlerInputFiles, SplitArgs);
           if (!BundledFileOrErr)
             return BundledFileOrErr.takeError();
-          SplitModules[I].ModuleFilePath = *BundledFileOrErr;
+          SplitModule.ModuleFilePath = *BundledFileOrErr;
         } else {
-          SplitModules[I].ModuleFilePath = *ClangOutputOrErr;
+          SplitModule.ModuleFilePath = *ClangOutputOrErr;
         }
-      }
+        return Error::success();
+      };
+      std::mutex ErrMtx;
+      Error BuildErr = Error::success();
+      ThreadPoolTaskGroup Jobs(jobs::getSYCLJobPool());
+      for (size_t I = 0, E = SplitModules.size(); I != E; ++I)
+        Jobs.async([&, I] {
+          if (Error Err = BuildImage(SplitModules[I])) {
+            std::scoped_lock Guard(ErrMtx);
+            BuildErr = joinErrors(std::move(BuildErr), std::move(Err));
+          }
+        });
+      Jobs.wait();
+      if (BuildErr)
+        return BuildErr;
 
       // TODO(NOM7): Remove this call and use community flow for bundle/wrap
       auto OutputFile = sycl::runWrapperAndCompile(SplitModules, LinkerArgs);
@@ -2489,6 +3003,10 @@ Expected<SmallVector<StringRef>> linkAndWrapDeviceFiles(
                              : InputFiles.front();
       if (!OutputOrErr)
         return OutputOrErr.takeError();
+      if (!Args.hasArg(OPT_embed_bitcode))
+        OutputOrErr = dwarf::linkDebugInfo(*OutputOrErr, LinkerArgs);
+      if (!OutputOrErr)
+        return OutputOrErr.takeError();
       // Store the offloading image for each linked output file.
       for (OffloadKind Kind : ActiveOffloadKinds) {
         llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> FileOrErr =
@@ -2958,7 +3476,11 @@ int main(int Argc, char **Argv) {
                                     Arg->getSpelling().data(),
                                     Arg->getValue()));
     parallel::strategy = hardware_concurrency(Threads);
+  } else if (jobs::hasJobServer()) {
+    // The jobserver of the build limits the parallel jobs.
+    parallel::strategy = hardware_concurrency();
   }
+  jobs::Limit = parallel::strategy.compute_thread_count();
 
   if (Args.hasArg(OPT_wrapper_time_trace_eq)) {
     unsigned Granularity;
@@ -3000,6 +3522,13 @@ int main(int Argc, char **Argv) {
     SPIRVDumpDir = Dir;
   }
 
+  if (Arg *A = Args.getLastArg(OPT_sycl_device_code_cache_dir_EQ)) {
+    SYCLDeviceCodeCacheDir = A->getValue();
+    if (std::error_code EC =
+            sys::fs::create_directories(SYCLDeviceCodeCacheDir))
+      reportError(createFileError(SYCLDeviceCodeCacheDir, EC));
+  }
+
   {
     llvm::TimeTraceScope TimeScope("Execute linker wrapper");
 
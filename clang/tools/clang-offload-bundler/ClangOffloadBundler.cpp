@@ -37,11 +37,13 @@
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/StringSaver.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Support/SourceMgr.h"
@@ -185,6 +187,13 @@ int main(int argc, const char **argv) {
   cl::opt<int> CompressionLevel(
       "compression-level", cl::desc("Specify the compression level (integer)"),
       cl::value_desc("n"), cl::Optional, cl::cat(ClangOffloadBundlerCategory));
+  cl::opt<std::string> Jobs(
+      "jobs",
+      cl::desc("Number of threads unbundling the members of archives and "
+               "writing the bundles, or 'all'. By default all the hardware "
+               "threads are used, within the jobs of the jobserver of the "
+               "build if there is one.\n"),
+      cl::value_desc("n"), cl::cat(ClangOffloadBundlerCategory));
 
   // Process commandline options and report errors
   sys::PrintStackTraceOnErrorSignal(argv[0]);
@@ -203,6 +212,19 @@ int main(int argc, const char **argv) {
     return 0;
   }
 
+  if (Jobs.getNumOccurrences() > 0) {
+    std::optional<ThreadPoolStrategy> Strategy =
+        get_threadpool_strategy(Jobs);
+    if (!Strategy) {
+      WithColor::error(errs(), argv[0])
+          << "invalid number of jobs '" << Jobs << "'\n";
+      return 1;
+    }
+    parallel::strategy = *Strategy;
+  } else {
+    parallel::strategy = jobserver_concurrency();
+  }
+
   // These calls are needed so that we can read bitcode correctly.
   InitializeAllTargetInfos();
   InitializeAllTargetMCs();
@@ -18,8 +18,10 @@
 #include "clang/Basic/Version.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/BinaryFormat/ELF.h"
+#include "llvm/BinaryFormat/Magic.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/IR/Constant.h"
 #include "llvm/IR/Constants.h"
@@ -37,9 +39,11 @@
 #endif // NDEBUG
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Object/ObjectFile.h"
+#include "llvm/Object/OffloadBinary.h"
 #include "llvm/SYCLLowerIR/SYCLUtils.h"
 #include "llvm/SYCLLowerIR/UtilsSYCLNativeCPU.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Compression.h"
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/Error.h"
@@ -70,7 +74,12 @@
 #define OPENMP_OFFLOAD_IMAGE_VERSION "1.0"
 
 using namespace llvm;
-using namespace llvm::object;
+// Not the whole of llvm::object, whose OffloadKind would clash with ours.
+using llvm::object::ELF32BEObjectFile;
+using llvm::object::ELF32LEObjectFile;
+using llvm::object::ELF64BEObjectFile;
+using llvm::object::ELF64LEObjectFile;
+using llvm::object::ObjectFile;
 
 // Fields in the binary descriptor which are made available to SYCL runtime
 // by the offload wrapper. Must match across tools -
@@ -146,8 +155,11 @@ enum BinaryImageFormat {
   none,   // image kind is not determined
   native, // image kind is native
   // portable image kinds go next
-  spirv, // SPIR-V
-  llvmbc // LLVM bitcode
+  spirv,  // SPIR-V
+  llvmbc, // LLVM bitcode
+  // Compressed image, the format of the decompressed image is not
+  // determined. Never given at the command line, set by the tool itself.
+  compressed_none
 };
 
 /// Sets offload kind.
@@ -230,6 +242,9 @@ static cl::opt<bool> BatchMode(
              "  [Code|Symbols|Properties|Manifest]\n"
              "  a_0.bc|a_0.sym|a_0.props|a_0.mnf\n"
              "  a_1.bin|||\n"
+             "An input file may also be a series of offload binaries written\n"
+             "by sycl-post-link -bundle, which provide the Code, Symbols and\n"
+             "Properties of the images themselves.\n"
              "Example usage:\n"
              "  clang-offload-wrapper -batch -host=x86_64-unknown-linux-gnu\n"
              "    -kind=openmp -target=spir64_gen table1.txt\n"
@@ -265,6 +280,8 @@ static StringRef formatToString(BinaryImageFormat Fmt) {
     return "llvmbc";
   case BinaryImageFormat::native:
     return "native";
+  case BinaryImageFormat::compressed_none:
+    return "compressed_none";
   }
   llvm_unreachable("bad format");
 
@@ -277,6 +294,21 @@ static cl::opt<bool> SaveTemps(
              "This option forces print-out of the temporary files' names."),
     cl::Hidden);
 
+static cl::opt<bool>
+    OffloadCompressDevImgs("offload-compress", cl::init(false), cl::Optional,
+                           cl::desc("Compress SYCL device images with zstd"),
+                           cl::cat(ClangOffloadWrapperCategory));
+
+static cl::opt<int> OffloadCompressLevel(
+    "offload-compression-level", cl::init(10), cl::Optional, cl::Hidden,
+    cl::desc("zstd compression level used for SYCL device images"),
+    cl::cat(ClangOffloadWrapperCategory));
+
+static cl::opt<int> OffloadCompressThreshold(
+    "offload-compression-threshold", cl::init(512), cl::Optional, cl::Hidden,
+    cl::desc("Minimal size in bytes of a SYCL device image to be compressed"),
+    cl::cat(ClangOffloadWrapperCategory));
+
 static cl::opt<bool> AddOpenMPOffloadNotes(
     "add-omp-offload-notes",
     cl::desc("Add LLVMOMPOFFLOAD ELF notes to ELF device images."), cl::Hidden);
@@ -340,6 +372,13 @@ private:
   llvm::DenseMap<OffloadKind, std::unique_ptr<SameKindPack>> Packs;
   /// Records all created memory buffers for safe auto-gc
   llvm::SmallVector<std::unique_ptr<MemoryBuffer>, 4> AutoGcBufs;
+  /// The offload binaries of the bundles added in batch mode, and the parts
+  /// of them by the names the images refer to them with.
+  llvm::SmallVector<object::OffloadFile, 0> Bundled;
+  llvm::StringMap<std::unique_ptr<MemoryBuffer>> BundledFiles;
+
+  /// Alignment of the SYCL device images, the page size.
+  static constexpr uint64_t DeviceImageAlignment = 4096;
 
 public:
   void addImage(const OffloadKind Kind, llvm::StringRef File,
@@ -354,6 +393,45 @@ public:
         File, Manif, Tgt, Fmt, CompileOpts, LinkOpts, EntriesFile, PropsFile));
   }
 
+  /// Adds the images of \p BundleFile, a series of offload binaries written by
+  /// sycl-post-link -bundle. The code, symbols and properties of the images
+  /// are read from the bundle rather than from files of their own.
+  Error addBundleImages(const OffloadKind Kind, llvm::StringRef BundleFile,
+                        llvm::StringRef Tgt, const BinaryImageFormat Fmt,
+                        llvm::StringRef CompileOpts,
+                        llvm::StringRef LinkOpts) {
+    Expected<MemoryBuffer *> MBOrErr = loadFile(BundleFile);
+    if (!MBOrErr)
+      return MBOrErr.takeError();
+    size_t First = Bundled.size();
+    if (Error E = object::extractOffloadBinaries(**MBOrErr, Bundled))
+      return createFileError(BundleFile, std::move(E));
+
+    for (size_t I = First; I < Bundled.size(); ++I) {
+      const object::OffloadBinary &Bin = *Bundled[I].getBinary();
+      std::string Prefix = (BundleFile + "(" + Twine(I - First) + "):").str();
+      // Returns the name the image refers to the part \p Col of the binary
+      // with, empty if the binary doesn't have it.
+      auto AddPart = [&](StringRef Col) -> std::string {
+        StringRef Contents;
+        if (Col == COL_CODE)
+          Contents = Bin.getImage();
+        else if (llvm::any_of(Bin.strings(),
+                              [&](const auto &KV) { return KV.first == Col; }))
+          Contents = Bin.getString(Col);
+        else
+          return "";
+        std::string Name = Prefix + Col.str();
+        BundledFiles[Name] = MemoryBuffer::getMemBuffer(
+            Contents, Name, /*RequiresNullTerminator=*/false);
+        return Name;
+      };
+      addImage(Kind, AddPart(COL_CODE), /*Manif=*/"", Tgt, Fmt, CompileOpts,
+               LinkOpts, AddPart(COL_SYM), AddPart(COL_PROPS));
+    }
+    return Error::success();
+  }
+
   std::string ToolName;
   std::string ObjcopyPath;
   // Temporary file names that may be created during adding notes
@@ -614,6 +692,10 @@ private:
   }
 
   Expected<MemoryBuffer *> loadFile(llvm::StringRef Name) {
+    auto It = BundledFiles.find(Name);
+    if (It != BundledFiles.end())
+      return It->second.get();
+
     auto InputOrErr = MemoryBuffer::getFileOrSTDIN(Name);
 
     if (auto EC = InputOrErr.getError())
@@ -733,13 +815,39 @@ private:
   std::pair<Constant *, Constant *>
   addDeviceImageToModule(ArrayRef<char> Buf, const Twine &Name,
                          OffloadKind Kind, StringRef TargetTriple) {
-    // Create global variable for the image data.
-    return addArrayToModule(Buf, Name,
-                            TargetTriple.empty()
-                                ? ""
-                                : "__CLANG_OFFLOAD_BUNDLE__" +
-                                      offloadKindToString(Kind) + "-" +
-                                      TargetTriple);
+    std::string Section =
+        TargetTriple.empty() ? ""
+                             : ("__CLANG_OFFLOAD_BUNDLE__" +
+                                offloadKindToString(Kind) + "-" + TargetTriple)
+                                   .str();
+    if (Kind != OffloadKind::SYCL)
+      // Create global variable for the image data.
+      return addArrayToModule(Buf, Name, Section);
+
+    // SYCL images are page aligned and padded to a whole number of pages, so
+    // that each image has pages of its own in the executable. The runtime can
+    // then page them in, release them or map them from the file independently
+    // of the data around them. The images have no relocations.
+    Constant *Data = ConstantDataArray::get(C, Buf);
+    uint64_t Padding = alignTo(Buf.size(), DeviceImageAlignment) - Buf.size();
+    if (Padding)
+      Data = ConstantStruct::getAnon(
+          {Data, ConstantAggregateZero::get(
+                     ArrayType::get(Type::getInt8Ty(C), Padding))},
+          /*Packed=*/true);
+    auto *Var = new GlobalVariable(M, Data->getType(), /*isConstant*/ true,
+                                   GlobalVariable::InternalLinkage, Data, Name);
+    if (Verbose)
+      errs() << "  global added: " << Var->getName() << "\n";
+    Var->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
+    Var->setAlignment(Align(DeviceImageAlignment));
+    if (!Section.empty())
+      Var->setSection(Section);
+    auto *ImageB = ConstantExpr::getGetElementPtr(
+        Type::getInt8Ty(C), Var, ConstantInt::get(getSizeTTy(), 0u));
+    auto *ImageE = ConstantExpr::getGetElementPtr(
+        Type::getInt8Ty(C), Var, ConstantInt::get(getSizeTTy(), Buf.size()));
+    return std::make_pair(ImageB, ImageE);
   }
 
   // Creates a global variable of const char* type and creates an
@@ -1032,7 +1140,7 @@ private:
       auto *Fver =
           ConstantInt::get(Type::getInt16Ty(C), DeviceImageStructVersion);
       auto *Fknd = ConstantInt::get(Type::getInt8Ty(C), Kind);
-      auto *Ffmt = ConstantInt::get(Type::getInt8Ty(C), Img.Fmt);
+      Constant *Ffmt = ConstantInt::get(Type::getInt8Ty(C), Img.Fmt);
       auto *Ftgt = addStringToModule(
           Img.Tgt, Twine(OffloadKindTag) + Twine("target.") + Twine(ImgId));
       auto *Foptcompile = addStringToModule(
@@ -1077,16 +1185,41 @@ private:
         Bin = addELFNotes(Bin, Img.File);
       }
       std::pair<Constant *, Constant *> Fbin;
+      size_t ImgSize = Bin->getBufferSize();
       if (Img.Tgt == "native_cpu") {
         auto FBinOrErr = addDeclarationsForNativeCPU(Img.EntriesFile);
         if (!FBinOrErr)
           return FBinOrErr.takeError();
         Fbin = *FBinOrErr;
       } else {
+        ArrayRef<char> ImgData(Bin->getBufferStart(), Bin->getBufferSize());
+        // The SYCL runtime decompresses images on first use, so images that
+        // are never selected for a device stay compressed in memory.
+        SmallVector<uint8_t, 0> CompressedData;
+        if (Kind == OffloadKind::SYCL && OffloadCompressDevImgs &&
+            ImgSize > static_cast<size_t>(OffloadCompressThreshold)) {
+          if (!compression::zstd::isAvailable()) {
+            WithColor::warning(errs(), ToolName)
+                << "'-offload-compress' is specified but zstd is not "
+                   "available, the device image will not be compressed\n";
+          } else {
+            compression::zstd::compress(
+                arrayRefFromStringRef(Bin->getBuffer()), CompressedData,
+                OffloadCompressLevel);
+            ImgData = ArrayRef<char>(
+                reinterpret_cast<const char *>(CompressedData.data()),
+                CompressedData.size());
+            ImgSize = CompressedData.size();
+            Ffmt = ConstantInt::get(Type::getInt8Ty(C),
+                                    BinaryImageFormat::compressed_none);
+            if (Verbose)
+              errs() << "  compressed image: " << Bin->getBufferSize()
+                     << " -> " << ImgSize << " bytes\n";
+          }
+        }
         Fbin = addDeviceImageToModule(
-            ArrayRef<char>(Bin->getBufferStart(), Bin->getBufferSize()),
-            Twine(OffloadKindTag) + Twine(ImgId) + Twine(".data"), Kind,
-            Img.Tgt);
+            ImgData, Twine(OffloadKindTag) + Twine(ImgId) + Twine(".data"),
+            Kind, Img.Tgt);
       }
 
       if (Kind == OffloadKind::SYCL) {
@@ -1115,7 +1248,7 @@ private:
         auto *ImgInfoArr = ConstantArray::get(
             ArrayType::get(IntPtrTy, 2),
             {ConstantExpr::getPointerCast(Fbin.first, IntPtrTy),
-             ConstantInt::get(IntPtrTy, Bin->getBufferSize())});
+             ConstantInt::get(IntPtrTy, ImgSize)});
         auto *ImgInfoVar = new GlobalVariable(
             M, ImgInfoArr->getType(), /*isConstant*/ true,
             GlobalVariable::InternalLinkage, ImgInfoArr,
@@ -1803,20 +1936,30 @@ int main(int argc, const char **argv) {
           // 'Wr.addImage' operations for each record in the table
           assert(CurInputGroup.size() == 1 && "1 input in batch mode expected");
           StringRef BatchFile = CurInputGroup[0];
-          Expected<std::unique_ptr<util::SimpleTable>> TPtr =
-              util::SimpleTable::read(BatchFile);
-          if (!TPtr) {
-            reportError(TPtr.takeError());
-            return 1;
-          }
-          const util::SimpleTable &T = *TPtr->get();
-
-          // iterate via records
-          for (const auto &Row : T.rows()) {
-            Wr.addImage(Knd, Row.getCell(COL_CODE),
-                        Row.getCell(COL_MANIFEST, ""), Tgt, Fmt, CompileOpts,
-                        LinkOpts, Row.getCell(COL_SYM, ""),
-                        Row.getCell(COL_PROPS, ""));
+          file_magic Magic;
+          if (!identify_magic(BatchFile, Magic) &&
+              Magic == file_magic::offload_binary) {
+            if (Error E = Wr.addBundleImages(Knd, BatchFile, Tgt, Fmt,
+                                             CompileOpts, LinkOpts)) {
+              reportError(std::move(E));
+              return 1;
+            }
+          } else {
+            Expected<std::unique_ptr<util::SimpleTable>> TPtr =
+                util::SimpleTable::read(BatchFile);
+            if (!TPtr) {
+              reportError(TPtr.takeError());
+              return 1;
+            }
+            const util::SimpleTable &T = *TPtr->get();
+
+            // iterate via records
+            for (const auto &Row : T.rows()) {
+              Wr.addImage(Knd, Row.getCell(COL_CODE),
+                          Row.getCell(COL_MANIFEST, ""), Tgt, Fmt, CompileOpts,
+                          LinkOpts, Row.getCell(COL_SYM, ""),
+                          Row.getCell(COL_PROPS, ""));
+            }
           }
         } else {
           if (Knd == OffloadKind::Unknown) {
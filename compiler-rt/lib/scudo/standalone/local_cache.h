@@ -41,6 +41,9 @@ template <class SizeClassAllocator> struct SizeClassAllocatorLocalCache {
     DCHECK_LT(ClassId, NumClasses);
     PerClass *C = &PerClassArray[ClassId];
     if (C->Count == 0) {
+      if (SizeClassAllocator::EnableAdaptiveLocalCache &&
+          ClassId != BatchClassId)
+        adaptMaxCount(C);
       // Refill half of the number of max cached.
       DCHECK_GT(C->MaxCount / 2, 0U);
       if (UNLIKELY(!refill(C, ClassId, C->MaxCount / 2)))
@@ -93,6 +96,12 @@ template <class SizeClassAllocator> struct SizeClassAllocatorLocalCache {
     while (PerClassArray[BatchClassId].Count > 0)
       drain(&PerClassArray[BatchClassId], BatchClassId);
     DCHECK(isEmpty());
+    // The caches that grew go back to their default size, their classes may
+    // not be used as much anymore.
+    for (uptr I = 0; I < NumClasses; ++I) {
+      PerClassArray[I].MaxCount = PerClassArray[I].DefaultMaxCount;
+      PerClassArray[I].LastRefill = 0;
+    }
   }
 
   void *getBatchClassBlock() {
@@ -104,6 +113,11 @@ template <class SizeClassAllocator> struct SizeClassAllocatorLocalCache {
 
   LocalStats &getStats() { return Stats; }
 
+  u16 getMaxCount(uptr ClassId) const {
+    DCHECK_LT(ClassId, NumClasses);
+    return PerClassArray[ClassId].MaxCount;
+  }
+
   void getStats(ScopedString *Str) {
     bool EmptyCache = true;
     for (uptr I = 0; I < NumClasses; ++I) {
@@ -118,9 +132,12 @@ template <class SizeClassAllocator> struct SizeClassAllocatorLocalCache {
                                  : PerClassArray[I].ClassSize;
       // Note that the string utils don't support printing u16 thus we cast it
       // to a common use type uptr.
-      Str->append("    %02zu (%6zu): cached: %4zu max: %4zu\n", I, ClassSize,
-                  static_cast<uptr>(PerClassArray[I].Count),
-                  static_cast<uptr>(PerClassArray[I].MaxCount));
+      Str->append("    %02zu (%6zu): cached: %4zu max: %4zu refills: %zu "
+                  "drains: %zu\n",
+                  I, ClassSize, static_cast<uptr>(PerClassArray[I].Count),
+                  static_cast<uptr>(PerClassArray[I].MaxCount),
+                  static_cast<uptr>(PerClassArray[I].NumRefills),
+                  static_cast<uptr>(PerClassArray[I].NumDrains));
     }
 
     if (EmptyCache)
@@ -135,14 +152,29 @@ template <class SizeClassAllocator> struct SizeClassAllocatorLocalCache {
 private:
   static const uptr NumClasses = SizeClassMap::NumClasses;
   static const uptr BatchClassId = SizeClassMap::BatchClassId;
+  // The largest MaxCount of a class, the capacity of its Chunks.
+  static const u16 MaxCountLimit = 2 * SizeClassMap::MaxNumCachedHint;
+  // A class refilled again within this number of refills of the cache grows
+  // its MaxCount, i.e. when it accounts for most of the recent refills.
+  static const u32 HotRefillDistance = 4;
+  // A class refilled again after this number of refills of the cache goes
+  // back to its default MaxCount.
+  static const u32 ColdRefillDistance = 256;
   struct alignas(SCUDO_CACHE_LINE_SIZE) PerClass {
     u16 Count;
     u16 MaxCount;
+    u16 DefaultMaxCount;
+    // The value of NumCacheRefills at the last refill of the class with
+    // EnableAdaptiveLocalCache, 0 if none happened since the last drain().
+    u32 LastRefill;
+    u32 NumRefills;
+    u32 NumDrains;
     // Note: ClassSize is zero for the transfer batch.
     uptr ClassSize;
-    CompactPtrT Chunks[2 * SizeClassMap::MaxNumCachedHint];
+    CompactPtrT Chunks[MaxCountLimit];
   };
   PerClass PerClassArray[NumClasses] = {};
+  u32 NumCacheRefills = 0;
   LocalStats Stats;
   SizeClassAllocator *Allocator = nullptr;
 
@@ -151,6 +183,7 @@ private:
       PerClass *P = &PerClassArray[I];
       const uptr Size = SizeClassAllocator::getSizeByClassId(I);
       P->MaxCount = static_cast<u16>(2 * getMaxCached(Size));
+      P->DefaultMaxCount = P->MaxCount;
       if (I != BatchClassId) {
         P->ClassSize = Size;
       } else {
@@ -166,15 +199,33 @@ private:
       deallocate(BatchClassId, B);
   }
 
+  // Called when the cache of the class is empty, so that shrinking it never
+  // leaves more blocks than MaxCount.
+  NOINLINE void adaptMaxCount(PerClass *C) {
+    DCHECK_EQ(C->Count, 0);
+    const u32 Now = ++NumCacheRefills;
+    const u32 Distance = Now - C->LastRefill;
+    const bool FirstRefill = C->LastRefill == 0;
+    C->LastRefill = Now;
+    if (FirstRefill)
+      return;
+    if (Distance <= HotRefillDistance)
+      C->MaxCount = static_cast<u16>(Min<u32>(2U * C->MaxCount, MaxCountLimit));
+    else if (Distance >= ColdRefillDistance)
+      C->MaxCount = C->DefaultMaxCount;
+  }
+
   NOINLINE bool refill(PerClass *C, uptr ClassId, u16 MaxRefill) {
     const u16 NumBlocksRefilled =
         Allocator->popBlocks(this, ClassId, C->Chunks, MaxRefill);
     DCHECK_LE(NumBlocksRefilled, MaxRefill);
     C->Count = static_cast<u16>(C->Count + NumBlocksRefilled);
+    C->NumRefills++;
     return NumBlocksRefilled != 0;
   }
 
   NOINLINE void drain(PerClass *C, uptr ClassId) {
+    C->NumDrains++;
     const u16 Count = Min(static_cast<u16>(C->MaxCount / 2), C->Count);
     Allocator->pushBlocks(this, ClassId, &C->Chunks[0], Count);
     // u16 will be promoted to int by arithmetic type conversion.
@@ -458,3 +458,59 @@ SCUDO_TYPED_TEST(ScudoPrimaryTest, MemoryGroup) {
   }
   Cache.drain();
 }
+
+struct AdaptiveLocalCacheConfig {
+  static const bool MaySupportMemoryTagging = false;
+  template <typename> using TSDRegistryT = void;
+  template <typename> using PrimaryT = void;
+  template <typename> using SecondaryT = void;
+
+  struct Primary {
+    using SizeClassMap = scudo::DefaultSizeClassMap;
+    static const scudo::uptr RegionSizeLog = 24U;
+    static const scudo::s32 MinReleaseToOsIntervalMs = INT32_MIN;
+    static const scudo::s32 MaxReleaseToOsIntervalMs = INT32_MAX;
+    typedef scudo::uptr CompactPtrT;
+    static const scudo::uptr CompactPtrScale = 0;
+    static const bool EnableRandomOffset = true;
+    static const scudo::uptr MapSizeIncrement = 1UL << 18;
+    static const scudo::uptr GroupSizeLog = 20U;
+    static const bool EnableAdaptiveLocalCache = true;
+  };
+};
+
+// The cache of a class refilled over and over grows up to its capacity, and
+// goes back to its default size when drained.
+TEST(ScudoPrimaryTest, AdaptiveLocalCache) {
+  using Primary = scudo::SizeClassAllocator64<
+      scudo::PrimaryConfig<AdaptiveLocalCacheConfig>>;
+  std::unique_ptr<Primary> Allocator(new Primary);
+  Allocator->init(/*ReleaseToOsInterval=*/-1);
+  typename Primary::CacheT Cache;
+  Cache.init(nullptr, Allocator.get());
+  const scudo::uptr ClassId = Primary::SizeClassMap::LargestClassId;
+  const scudo::uptr Size = Primary::getSizeByClassId(ClassId);
+  const scudo::u16 DefaultMaxCount = static_cast<scudo::u16>(
+      2 * Primary::CacheT::getMaxCached(Size));
+  const scudo::u16 MaxCountLimit = static_cast<scudo::u16>(
+      2 * Primary::SizeClassMap::MaxNumCachedHint);
+  ASSERT_LT(DefaultMaxCount, MaxCountLimit);
+  EXPECT_EQ(Cache.getMaxCount(ClassId), DefaultMaxCount);
+
+  std::vector<void *> Blocks;
+  for (scudo::uptr I = 0; I < 4U * MaxCountLimit; I++) {
+    void *P = Cache.allocate(ClassId);
+    ASSERT_NE(P, nullptr);
+    Blocks.push_back(P);
+  }
+  EXPECT_EQ(Cache.getMaxCount(ClassId), MaxCountLimit);
+
+  for (void *P : Blocks)
+    Cache.deallocate(ClassId, P);
+  Cache.drain();
+  EXPECT_EQ(Cache.getMaxCount(ClassId), DefaultMaxCount);
+
+  Cache.destroy(nullptr);
+  Allocator->releaseToOS(scudo::ReleaseToOS::Force);
+  Allocator->unmapTestOnly();
+}
@@ -79,6 +79,14 @@ extern DEVICE_EXTERNAL void
 __spirv_AtomicStore(int *, __spv::Scope::Flag, __spv::MemorySemanticsMask::Flag,
                     int);
 
+extern DEVICE_EXTERNAL uint64_t __spirv_AtomicIAdd(
+    uint64_t SPIR_GLOBAL *, __spv::Scope::Flag,
+    __spv::MemorySemanticsMask::Flag, uint64_t);
+
+extern DEVICE_EXTERNAL uint64_t __spirv_AtomicUMax(
+    uint64_t SPIR_GLOBAL *, __spv::Scope::Flag,
+    __spv::MemorySemanticsMask::Flag, uint64_t);
+
 /// Atomically set the value in *Ptr with Desired if and only if it is Expected
 /// Return the value which already was in *Ptr
 static inline int atomicCompareAndSet(SPIR_GLOBAL int *Ptr, int Desired,
@@ -111,4 +119,16 @@ static inline void atomicStore(int *Ptr, int V) {
                       __spv::MemorySemanticsMask::SequentiallyConsistent, V);
 }
 
+/// Relaxed atomic operations, for counters which are only read once the
+/// kernel has completed.
+static inline void atomicAddRelaxed(SPIR_GLOBAL uint64_t *Ptr, uint64_t V) {
+  __spirv_AtomicIAdd(Ptr, __spv::Scope::Device,
+                     __spv::MemorySemanticsMask::None, V);
+}
+
+static inline void atomicMaxRelaxed(SPIR_GLOBAL uint64_t *Ptr, uint64_t V) {
+  __spirv_AtomicUMax(Ptr, __spv::Scope::Device,
+                     __spv::MemorySemanticsMask::None, V);
+}
+
 #endif // __SPIR__ || __SPIRV__
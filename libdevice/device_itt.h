@@ -37,10 +37,45 @@ SYCL_EXTERNAL EXTERN_C char __spirv_SpecConstant(int, char);
 
 #define ITT_SPEC_CONSTANT 0xFF747469
 
+// Bits of the specialization constant, which must be the same as in
+// sycl/source/detail/program_manager/program_manager.hpp.
+#define ITT_ANNOTATIONS_ENABLED 0x1
+#define ITT_WG_COUNTERS_ENABLED 0x2
+
 static ITT_WRAPPER_ATTRIBUTES bool isITTEnabled() {
-  return __spirv_SpecConstant(ITT_SPEC_CONSTANT, 0) != 0;
+  return (__spirv_SpecConstant(ITT_SPEC_CONSTANT, 0) &
+          ITT_ANNOTATIONS_ENABLED) != 0;
+}
+
+static ITT_WRAPPER_ATTRIBUTES bool isITTWorkGroupCountersEnabled() {
+  return (__spirv_SpecConstant(ITT_SPEC_CONSTANT, 0) &
+          ITT_WG_COUNTERS_ENABLED) != 0;
 }
 
+// Counters of a work-group recorded by the compiler wrappers, in device clock
+// ticks. The layout must be the same as in
+// sycl/source/detail/work_group_counters.hpp.
+struct __itt_wg_record_t {
+  // Bitwise negation of the earliest start of a work-item, so that the zero
+  // initialized record is updated with an atomic max like the end.
+  uint64_t not_start;
+  // Latest finish of a work-item.
+  uint64_t end;
+  // Sum over the work-items of the time spent waiting at barriers.
+  uint64_t barrier_wait;
+};
+
+// Buffer the counters of the work-groups of a kernel launch are written to,
+// indexed by the linear work-group id. It is set up by the runtime through
+// the __itt_wg_counters device global, which stays null when the counters of
+// the launch are not collected.
+struct __itt_wg_counters_t {
+  uint64_t num_records;
+  // Number of work-groups whose linear id didn't fit into the records.
+  uint64_t dropped;
+  __itt_wg_record_t records[1];
+};
+
 // Wrapper APIs that may be called by compiler-generated code.
 // These are just parameterless helper APIs that call the corresponding
 // stub APIs after preparing the arguments for them.
@@ -12,6 +12,50 @@
 #if defined(__SPIR__) || defined(__SPIRV__) || defined(__NVPTX__) ||           \
     defined(__AMDGCN__)
 
+// The small sizes are dispatched to size classes like the memory functions of
+// LLVM libc (libc/src/string/memory_utils): a size class from S to 2 * S bytes
+// is copied or set with two blocks of S bytes, the first at the start of the
+// buffer and the second ending at its end, overlapping when the size is less
+// than 2 * S. The blocks are expanded inline by the compiler into the widest
+// accesses the target allows, without branching on the alignment of the
+// pointers nor looping over the bytes.
+template <size_t Size>
+static inline void __devicelib_memcpy_block(uint8_t *dest,
+                                            const uint8_t *src) {
+  __builtin_memcpy_inline(dest, src, Size);
+}
+
+template <size_t Size>
+static inline void __devicelib_memcpy_head_tail(uint8_t *dest,
+                                                const uint8_t *src, size_t n) {
+  __devicelib_memcpy_block<Size>(dest, src);
+  __devicelib_memcpy_block<Size>(dest + n - Size, src + n - Size);
+}
+
+// Copies n bytes, n being at most __devicelib_small_size_max.
+static inline void __devicelib_memcpy_small(uint8_t *dest, const uint8_t *src,
+                                            size_t n) {
+  if (n == 1)
+    return __devicelib_memcpy_block<1>(dest, src);
+  if (n == 2)
+    return __devicelib_memcpy_block<2>(dest, src);
+  if (n == 3)
+    return __devicelib_memcpy_block<3>(dest, src);
+  if (n <= 4)
+    return __devicelib_memcpy_head_tail<2>(dest, src, n);
+  if (n <= 8)
+    return __devicelib_memcpy_head_tail<4>(dest, src, n);
+  if (n <= 16)
+    return __devicelib_memcpy_head_tail<8>(dest, src, n);
+  if (n <= 32)
+    return __devicelib_memcpy_head_tail<16>(dest, src, n);
+  return __devicelib_memcpy_head_tail<32>(dest, src, n);
+}
+
+// Above this size, the copies and sets align the pointers and loop over
+// words.
+static constexpr size_t __devicelib_small_size_max = 64;
+
 static void *__devicelib_memcpy_uint8_aligned(void *dest, const void *src,
                                               size_t n) {
   if (dest == NULL || src == NULL || n == 0)
@@ -25,6 +69,9 @@ static void *__devicelib_memcpy_uint8_aligned(void *dest, const void *src,
   return dest;
 }
 
+// The word copies and sets below are unrolled by four. The loads of an
+// iteration are all issued before its stores, which the compiler can't do by
+// itself as it doesn't know that dest and src don't overlap.
 static void *__devicelib_memcpy_uint32_aligned(void *dest, const void *src,
                                                size_t n) {
   if (dest == NULL || src == NULL || n == 0)
@@ -35,7 +82,45 @@ static void *__devicelib_memcpy_uint32_aligned(void *dest, const void *src,
   size_t tailing_bytes = n % sizeof(uint32_t);
   size_t copy_num = n >> 2;
   size_t idx;
-  for (idx = 0; idx < copy_num; ++idx)
+  for (idx = 0; idx + 4 <= copy_num; idx += 4) {
+    uint32_t w0 = src_addr[idx];
+    uint32_t w1 = src_addr[idx + 1];
+    uint32_t w2 = src_addr[idx + 2];
+    uint32_t w3 = src_addr[idx + 3];
+    dest_addr[idx] = w0;
+    dest_addr[idx + 1] = w1;
+    dest_addr[idx + 2] = w2;
+    dest_addr[idx + 3] = w3;
+  }
+  for (; idx < copy_num; ++idx)
+    dest_addr[idx] = src_addr[idx];
+
+  __devicelib_memcpy_uint8_aligned(&dest_addr[idx], &src_addr[idx],
+                                   tailing_bytes);
+  return dest;
+}
+
+static void *__devicelib_memcpy_uint64_aligned(void *dest, const void *src,
+                                               size_t n) {
+  if (dest == NULL || src == NULL || n == 0)
+    return dest;
+
+  uint64_t *dest_addr = reinterpret_cast<uint64_t *>(dest);
+  const uint64_t *src_addr = reinterpret_cast<const uint64_t *>(src);
+  size_t tailing_bytes = n % sizeof(uint64_t);
+  size_t copy_num = n >> 3;
+  size_t idx;
+  for (idx = 0; idx + 4 <= copy_num; idx += 4) {
+    uint64_t w0 = src_addr[idx];
+    uint64_t w1 = src_addr[idx + 1];
+    uint64_t w2 = src_addr[idx + 2];
+    uint64_t w3 = src_addr[idx + 3];
+    dest_addr[idx] = w0;
+    dest_addr[idx + 1] = w1;
+    dest_addr[idx + 2] = w2;
+    dest_addr[idx + 3] = w3;
+  }
+  for (; idx < copy_num; ++idx)
     dest_addr[idx] = src_addr[idx];
 
   __devicelib_memcpy_uint8_aligned(&dest_addr[idx], &src_addr[idx],
@@ -48,8 +133,32 @@ void *__devicelib_memcpy(void *dest, const void *src, size_t n) {
   if (dest == NULL || src == NULL || n == 0)
     return dest;
 
+  if (n <= __devicelib_small_size_max) {
+    __devicelib_memcpy_small(reinterpret_cast<uint8_t *>(dest),
+                             reinterpret_cast<const uint8_t *>(src), n);
+    return dest;
+  }
+
   uintptr_t dest_addr = reinterpret_cast<uintptr_t>(dest);
   uintptr_t src_addr = reinterpret_cast<uintptr_t>(src);
+
+  // Both pointers can be aligned to 8 bytes by copying the same number of
+  // head bytes.
+  size_t dest_uint64_mod = dest_addr % alignof(uint64_t);
+  if (dest_uint64_mod == src_addr % alignof(uint64_t)) {
+    size_t head_ua_len =
+        (sizeof(uint64_t) - dest_uint64_mod) % sizeof(uint64_t);
+    if (head_ua_len >= n)
+      return __devicelib_memcpy_uint8_aligned(dest, src, n);
+
+    __devicelib_memcpy_uint8_aligned(dest, src, head_ua_len);
+    __devicelib_memcpy_uint64_aligned(
+        reinterpret_cast<void *>(dest_addr + head_ua_len),
+        reinterpret_cast<const void *>(src_addr + head_ua_len),
+        n - head_ua_len);
+    return dest;
+  }
+
   size_t dest_uint32_mod = dest_addr % alignof(uint32_t);
   size_t src_uint32_mod = src_addr % alignof(uint32_t);
 
@@ -73,6 +182,38 @@ void *__devicelib_memcpy(void *dest, const void *src, size_t n) {
   return dest;
 }
 
+template <size_t Size>
+static inline void __devicelib_memset_block(uint8_t *dest, uint8_t c) {
+  __builtin_memset_inline(dest, c, Size);
+}
+
+template <size_t Size>
+static inline void __devicelib_memset_head_tail(uint8_t *dest, uint8_t c,
+                                                size_t n) {
+  __devicelib_memset_block<Size>(dest, c);
+  __devicelib_memset_block<Size>(dest + n - Size, c);
+}
+
+// Sets n bytes, n being at most __devicelib_small_size_max.
+static inline void __devicelib_memset_small(uint8_t *dest, uint8_t c,
+                                            size_t n) {
+  if (n == 1)
+    return __devicelib_memset_block<1>(dest, c);
+  if (n == 2)
+    return __devicelib_memset_block<2>(dest, c);
+  if (n == 3)
+    return __devicelib_memset_block<3>(dest, c);
+  if (n <= 4)
+    return __devicelib_memset_head_tail<2>(dest, c, n);
+  if (n <= 8)
+    return __devicelib_memset_head_tail<4>(dest, c, n);
+  if (n <= 16)
+    return __devicelib_memset_head_tail<8>(dest, c, n);
+  if (n <= 32)
+    return __devicelib_memset_head_tail<16>(dest, c, n);
+  return __devicelib_memset_head_tail<32>(dest, c, n);
+}
+
 static void *__devicelib_memset_uint8_aligned(void *dest, int c, size_t n) {
   if (dest == NULL || n == 0)
     return dest;
@@ -84,22 +225,25 @@ static void *__devicelib_memset_uint8_aligned(void *dest, int c, size_t n) {
   return dest;
 }
 
-static void *__devicelib_memset_uint32_aligned(void *dest, int c, size_t n) {
+static void *__devicelib_memset_uint64_aligned(void *dest, int c, size_t n) {
   if (dest == NULL || n == 0)
     return dest;
 
-  uint32_t *dest_addr = reinterpret_cast<uint32_t *>(dest);
-  uint8_t temp = static_cast<uint8_t>(c);
-  uint32_t memset_udw = 0;
-  uint8_t *memset_udw_ptr = reinterpret_cast<uint8_t *>(&memset_udw);
-  size_t idx;
-  for (idx = 0; idx < 4; ++idx)
-    memset_udw_ptr[idx] = temp;
+  uint64_t *dest_addr = reinterpret_cast<uint64_t *>(dest);
+  uint64_t memset_uqw =
+      static_cast<uint64_t>(static_cast<uint8_t>(c)) * 0x0101010101010101ULL;
 
-  size_t tailing_bytes = n % sizeof(uint32_t);
-  size_t set_num = n >> 2;
-  for (idx = 0; idx < set_num; ++idx)
-    dest_addr[idx] = memset_udw;
+  size_t tailing_bytes = n % sizeof(uint64_t);
+  size_t set_num = n >> 3;
+  size_t idx;
+  for (idx = 0; idx + 4 <= set_num; idx += 4) {
+    dest_addr[idx] = memset_uqw;
+    dest_addr[idx + 1] = memset_uqw;
+    dest_addr[idx + 2] = memset_uqw;
+    dest_addr[idx + 3] = memset_uqw;
+  }
+  for (; idx < set_num; ++idx)
+    dest_addr[idx] = memset_uqw;
 
   __devicelib_memset_uint8_aligned(&dest_addr[idx], c, tailing_bytes);
   return dest;
@@ -110,20 +254,23 @@ void *__devicelib_memset(void *dest, int c, size_t n) {
   if (dest == NULL || n == 0)
     return dest;
 
-  uintptr_t memset_dest_addr = reinterpret_cast<uintptr_t>(dest);
-  size_t dest_uint32_mod = memset_dest_addr % alignof(uint32_t);
-  if (dest_uint32_mod == 0)
-    return __devicelib_memset_uint32_aligned(
-        reinterpret_cast<void *>(memset_dest_addr), c, n);
+  if (n <= __devicelib_small_size_max) {
+    __devicelib_memset_small(reinterpret_cast<uint8_t *>(dest),
+                             static_cast<uint8_t>(c), n);
+    return dest;
+  }
 
-  size_t head_ua_len = sizeof(uint32_t) - dest_uint32_mod;
+  uintptr_t memset_dest_addr = reinterpret_cast<uintptr_t>(dest);
+  size_t head_ua_len =
+      (sizeof(uint64_t) - memset_dest_addr % alignof(uint64_t)) %
+      sizeof(uint64_t);
   if (head_ua_len >= n)
     return __devicelib_memset_uint8_aligned(dest, c, n);
 
   __devicelib_memset_uint8_aligned(dest, c, head_ua_len);
   n -= head_ua_len;
   memset_dest_addr += head_ua_len;
-  __devicelib_memset_uint32_aligned(reinterpret_cast<void *>(memset_dest_addr),
+  __devicelib_memset_uint64_aligned(reinterpret_cast<void *>(memset_dest_addr),
                                     c, n);
   return dest;
 }
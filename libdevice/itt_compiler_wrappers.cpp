@@ -6,11 +6,50 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "atomic.hpp"
 #include "device_itt.h"
+#include "include/spir_global_var.hpp"
 
 #if defined(__SPIR__) || defined(__SPIRV__)
 
+DeviceGlobal<__SYCL_GLOBAL__ __itt_wg_counters_t *> __itt_wg_counters;
+
+extern DEVICE_EXTERNAL uint64_t __spirv_ReadClockKHR(int);
+
+static ITT_WRAPPER_ATTRIBUTES uint64_t readDeviceClock() {
+  return __spirv_ReadClockKHR(__spv::Scope::Device);
+}
+
+// Returns the record of the work-group of the work-item, or null if the
+// counters of the launch are not collected or the record doesn't exist. The
+// work-groups without record are counted if CountDropped is set.
+static ITT_WRAPPER_ATTRIBUTES __SYCL_GLOBAL__ __itt_wg_record_t *
+getWorkGroupRecord(bool CountDropped = false) {
+  __SYCL_GLOBAL__ __itt_wg_counters_t *Counters = __itt_wg_counters.get();
+  if (!Counters)
+    return nullptr;
+
+  size_t GroupID =
+      __spirv_BuiltInWorkgroupId.x +
+      __spirv_BuiltInNumWorkgroups.x *
+          (__spirv_BuiltInWorkgroupId.y +
+           __spirv_BuiltInNumWorkgroups.y * __spirv_BuiltInWorkgroupId.z);
+  if (GroupID < Counters->num_records)
+    return &Counters->records[GroupID];
+
+  // Counted once per work-group.
+  if (CountDropped && __spirv_BuiltInLocalInvocationId.x == 0 &&
+      __spirv_BuiltInLocalInvocationId.y == 0 &&
+      __spirv_BuiltInLocalInvocationId.z == 0)
+    atomicAddRelaxed(&Counters->dropped, 1);
+  return nullptr;
+}
+
 SYCL_EXTERNAL EXTERN_C void __itt_offload_wi_start_wrapper() {
+  if (isITTWorkGroupCountersEnabled())
+    if (auto *Record = getWorkGroupRecord(/*CountDropped=*/true))
+      atomicMaxRelaxed(&Record->not_start, ~readDeviceClock());
+
   if (!isITTEnabled())
     return;
 
@@ -25,6 +64,10 @@ SYCL_EXTERNAL EXTERN_C void __itt_offload_wi_start_wrapper() {
 }
 
 SYCL_EXTERNAL EXTERN_C void __itt_offload_wi_finish_wrapper() {
+  if (isITTWorkGroupCountersEnabled())
+    if (auto *Record = getWorkGroupRecord())
+      atomicMaxRelaxed(&Record->end, readDeviceClock());
+
   if (!isITTEnabled())
     return;
 
@@ -35,7 +78,15 @@ SYCL_EXTERNAL EXTERN_C void __itt_offload_wi_finish_wrapper() {
   __itt_offload_wi_finish_stub(GroupID, WIID);
 }
 
+// The wait of a work-item at a barrier is accounted for by subtracting the
+// clock before the barrier and adding it back once it is resumed, which needs
+// no per work-item state. The modular arithmetic makes the sum exact once all
+// the work-items resumed.
 SYCL_EXTERNAL EXTERN_C void __itt_offload_wg_barrier_wrapper() {
+  if (isITTWorkGroupCountersEnabled())
+    if (auto *Record = getWorkGroupRecord())
+      atomicAddRelaxed(&Record->barrier_wait, 0 - readDeviceClock());
+
   if (!isITTEnabled())
     return;
 
@@ -43,6 +94,10 @@ SYCL_EXTERNAL EXTERN_C void __itt_offload_wg_barrier_wrapper() {
 }
 
 SYCL_EXTERNAL EXTERN_C void __itt_offload_wi_resume_wrapper() {
+  if (isITTWorkGroupCountersEnabled())
+    if (auto *Record = getWorkGroupRecord())
+      atomicAddRelaxed(&Record->barrier_wait, readDeviceClock());
+
   if (!isITTEnabled())
     return;
 
@@ -25,6 +25,9 @@ DeviceGlobal<DeviceType> __DeviceType;
 DeviceGlobal<uint64_t> __AsanDebug;
 // Save the pointer to LaunchInfo
 __SYCL_GLOBAL__ uptr *__SYCL_LOCAL__ __AsanLaunchInfo;
+// Defined by the instrumentation of the device code, from
+// -asan-spir-sampling-shift
+extern __SYCL_CONSTANT__ const uint32_t __AsanSamplingShift;
 
 #if defined(__SPIR__) || defined(__SPIRV__)
 
@@ -697,6 +700,18 @@ inline uptr __asan_region_is_poisoned(uptr beg, uint32_t as, size_t size) {
 
 constexpr size_t AlignMask(size_t n) { return n - 1; }
 
+// With a sampling shift of N, only the accesses to 1 in 2^N pages of 4KiB are
+// checked. The pages are hashed with the address of the launch info, so that
+// another sample of the memory is checked by each launch.
+inline bool IsSampled(uptr addr) {
+  const uint32_t shift = __AsanSamplingShift;
+  if (shift == 0)
+    return true;
+  uint64_t hash = ((uint64_t)(addr >> 12) ^ (uint64_t)__AsanLaunchInfo) *
+                  0x9E3779B97F4A7C15ULL;
+  return (hash >> (64 - shift)) == 0;
+}
+
 } // namespace
 
 ///
@@ -707,6 +722,8 @@ constexpr size_t AlignMask(size_t n) { return n - 1; }
   DEVICE_EXTERN_C_NOINLINE void __asan_##type##size(                           \
       uptr addr, uint32_t as, const char __SYCL_CONSTANT__ *file,              \
       uint32_t line, const char __SYCL_CONSTANT__ *func) {                     \
+    if (!IsSampled(addr))                                                      \
+      return;                                                                  \
     if (addr & AlignMask(size)) {                                              \
       __asan_report_misalign_error(addr, as, size, is_write, addr, file, line, \
                                    func);                                      \
@@ -719,6 +736,8 @@ constexpr size_t AlignMask(size_t n) { return n - 1; }
   DEVICE_EXTERN_C_NOINLINE void __asan_##type##size##_noabort(                 \
       uptr addr, uint32_t as, const char __SYCL_CONSTANT__ *file,              \
       uint32_t line, const char __SYCL_CONSTANT__ *func) {                     \
+    if (!IsSampled(addr))                                                      \
+      return;                                                                  \
     if (addr & AlignMask(size)) {                                              \
       __asan_report_misalign_error(addr, as, size, is_write, addr, file, line, \
                                    func, true);                                \
@@ -744,6 +763,8 @@ ASAN_REPORT_ERROR(store, true, 16)
   DEVICE_EXTERN_C_NOINLINE void __asan_##type##N(                              \
       uptr addr, size_t size, uint32_t as, const char __SYCL_CONSTANT__ *file, \
       uint32_t line, const char __SYCL_CONSTANT__ *func) {                     \
+    if (!IsSampled(addr))                                                      \
+      return;                                                                  \
     if (auto poisoned_addr = __asan_region_is_poisoned(addr, as, size)) {      \
       __asan_report_access_error(addr, as, size, is_write, poisoned_addr,      \
                                  file, line, func);                            \
@@ -752,6 +773,8 @@ ASAN_REPORT_ERROR(store, true, 16)
   DEVICE_EXTERN_C_NOINLINE void __asan_##type##N_noabort(                      \
       uptr addr, size_t size, uint32_t as, const char __SYCL_CONSTANT__ *file, \
       uint32_t line, const char __SYCL_CONSTANT__ *func) {                     \
+    if (!IsSampled(addr))                                                      \
+      return;                                                                  \
     if (auto poisoned_addr = __asan_region_is_poisoned(addr, as, size)) {      \
       __asan_report_access_error(addr, as, size, is_write, poisoned_addr,      \
                                  file, line, func, true);                      \
@@ -113,7 +113,8 @@ static void decompressAux(const InputSectionBase &sec, uint8_t *out,
                         .slice(sizeof(typename ELFT::Chdr));
   if (Error e = hdr->ch_type == ELFCOMPRESS_ZLIB
                     ? compression::zlib::decompress(compressed, out, size)
-                    : compression::zstd::decompress(compressed, out, size))
+                    : compression::zstd::decompressInParallel(compressed, out,
+                                                              size))
     fatal(toString(&sec) +
           ": decompress failed: " + llvm::toString(std::move(e)));
 }
@@ -1248,7 +1249,8 @@ template <class ELFT> void InputSection::writeTo(uint8_t *buf) {
     size_t size = this->size;
     if (Error e = hdr->ch_type == ELFCOMPRESS_ZLIB
                       ? compression::zlib::decompress(compressed, buf, size)
-                      : compression::zstd::decompress(compressed, buf, size))
+                      : compression::zstd::decompressInParallel(compressed,
+                                                                buf, size))
       fatal(toString(this) +
             ": decompress failed: " + llvm::toString(std::move(e)));
     uint8_t *bufEnd = buf + size;
@@ -1646,18 +1646,40 @@ template <class ELFT> void elf::scanRelocations() {
   // for parallelism.
   bool serial = !config->zCombreloc || config->emachine == EM_MIPS ||
                 config->emachine == EM_PPC64;
+
+  // The sections of a file are scanned in one task, except for the files with
+  // many relocations, such as the fat objects of offload bundles, which are
+  // split into tasks of about relocsPerTask relocations.
+  constexpr size_t relocsPerTask = 1 << 15;
   parallel::TaskGroup tg;
+  auto spawnScan = [&](SmallVector<InputSectionBase *, 0> sections) {
+    tg.spawn(
+        [sections = std::move(sections)]() {
+          RelocationScanner scanner;
+          for (InputSectionBase *s : sections)
+            scanner.template scanSection<ELFT>(*s);
+        },
+        serial);
+  };
   for (ELFFileBase *f : ctx.objectFiles) {
-    auto fn = [f]() {
-      RelocationScanner scanner;
-      for (InputSectionBase *s : f->getSections()) {
-        if (s && s->kind() == SectionBase::Regular && s->isLive() &&
-            (s->flags & SHF_ALLOC) &&
-            !(s->type == SHT_ARM_EXIDX && config->emachine == EM_ARM))
-          scanner.template scanSection<ELFT>(*s);
+    SmallVector<InputSectionBase *, 0> sections;
+    size_t numRelocs = 0;
+    for (InputSectionBase *s : f->getSections()) {
+      if (!s || s->kind() != SectionBase::Regular || !s->isLive() ||
+          !(s->flags & SHF_ALLOC) ||
+          (s->type == SHT_ARM_EXIDX && config->emachine == EM_ARM))
+        continue;
+      sections.push_back(s);
+      const RelsOrRelas<ELFT> rels = s->template relsOrRelas<ELFT>();
+      numRelocs += rels.rels.size() + rels.relas.size() + rels.crels.size();
+      if (numRelocs >= relocsPerTask) {
+        spawnScan(std::move(sections));
+        sections.clear();
+        numRelocs = 0;
       }
-    };
-    tg.spawn(fn, serial);
+    }
+    if (!sections.empty())
+      spawnScan(std::move(sections));
   }
 
   tg.spawn([] {
@@ -31,6 +31,7 @@
 #include "SyntheticSections.h"
 #include "lld/Common/ErrorHandler.h"
 #include "llvm/Object/ELF.h"
+#include "llvm/Support/Parallel.h"
 
 using namespace llvm;
 using namespace llvm::object;
@@ -162,15 +163,38 @@ void TargetInfo::relocateAlloc(InputSectionBase &sec, uint8_t *buf) const {
     secAddr += s->outSecOff;
   else if (auto *ehIn = dyn_cast<EhInputSection>(&sec))
     secAddr += ehIn->getParent()->outSecOff;
-  for (const Relocation &rel : sec.relocs()) {
-    uint8_t *loc = buf + rel.offset;
-    const uint64_t val = SignExtend64(
-        sec.getRelocTargetVA(sec.file, rel.type, rel.addend,
-                             secAddr + rel.offset, *rel.sym, rel.expr),
-        bits);
-    if (rel.expr != R_RELAX_HINT)
-      relocate(loc, rel, val);
+  ArrayRef<Relocation> rels = sec.relocs();
+  auto relocateRange = [&](size_t begin, size_t end) {
+    for (const Relocation &rel : rels.slice(begin, end - begin)) {
+      uint8_t *loc = buf + rel.offset;
+      const uint64_t val = SignExtend64(
+          sec.getRelocTargetVA(sec.file, rel.type, rel.addend,
+                               secAddr + rel.offset, *rel.sym, rel.expr),
+          bits);
+      if (rel.expr != R_RELAX_HINT)
+        relocate(loc, rel, val);
+    }
+  };
+
+  // The relocations are applied independently of each other. Split the
+  // sections with many of them, such as the tables of device images of
+  // offload binaries, over several tasks. The relocations at the same offset,
+  // which combine their values, stay in the same task.
+  constexpr size_t relocsPerTask = 1 << 14;
+  if (rels.size() <= relocsPerTask) {
+    relocateRange(0, rels.size());
+    return;
+  }
+  SmallVector<size_t, 0> bounds = {0};
+  for (size_t i = relocsPerTask; i < rels.size(); i += relocsPerTask) {
+    while (i < rels.size() && rels[i].offset == rels[i - 1].offset)
+      ++i;
+    if (i < rels.size())
+      bounds.push_back(i);
   }
+  bounds.push_back(rels.size());
+  parallelFor(0, bounds.size() - 1,
+              [&](size_t i) { relocateRange(bounds[i], bounds[i + 1]); });
 }
 
 uint64_t TargetInfo::getImageBase() const {
@@ -252,6 +252,12 @@ public:
   void setUseLLVMTarget(bool Flag) noexcept { UseLLVMTarget = Flag; }
   bool getUseLLVMTarget() const noexcept { return UseLLVMTarget; }
 
+  bool shouldPruneToEntryPoints() const noexcept { return PruneToEntryPoints; }
+
+  void setPruneToEntryPoints(bool Value) noexcept {
+    PruneToEntryPoints = Value;
+  }
+
 private:
   // Common translation options
   VersionNumber MaxVersion = VersionNumber::MaximumVersion;
@@ -301,6 +307,10 @@ private:
 
   bool PreserveAuxData = false;
 
+  // Only keep the functions and globals reachable from the kernels, the other
+  // functions are not exported
+  bool PruneToEntryPoints = false;
+
   BuiltinFormat SPIRVBuiltinFormat = BuiltinFormat::Function;
 
   // Convert LLVM to SPIR-V using the LLVM SPIR-V Backend target
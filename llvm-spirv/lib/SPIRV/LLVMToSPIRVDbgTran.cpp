@@ -227,7 +227,10 @@ void LLVMToSPIRVDbgTran::transLocationInfo() {
           transDebugLoc(DL, SBB, static_cast<SPIRVInstruction *>(V));
         }
         // If any component of OpLine has changed emit another OpLine
-        SPIRVString *DirAndFile = BM->getString(getFullPath(DL.get()));
+        // The path is built once per file rather than for each location.
+        SPIRVString *&DirAndFile = FilePathMap[DL->getFile()];
+        if (!DirAndFile)
+          DirAndFile = BM->getString(getFullPath(DL.get()));
         if (File != DirAndFile || LineNo != DL.getLine() ||
             Col != DL.getCol()) {
           File = DirAndFile;
@@ -174,6 +174,7 @@ private:
   LLVMToSPIRVBase *SPIRVWriter;
   std::unordered_map<const MDNode *, SPIRVEntry *> MDMap;
   std::unordered_map<std::string, SPIRVExtInst *> FileMap;
+  std::unordered_map<const DIFile *, SPIRVString *> FilePathMap;
   DebugInfoFinder DIF;
   SPIRVType *VoidT = nullptr;
   SPIRVType *Int32T = nullptr;
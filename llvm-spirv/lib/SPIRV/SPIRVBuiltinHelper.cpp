@@ -58,15 +58,15 @@ static std::unique_ptr<BuiltinFuncMangleInfo> makeMangler(CallBase *CB,
   llvm_unreachable("Unknown mangling rules to make a name mangler");
 }
 
-BuiltinCallMutator::BuiltinCallMutator(
-    CallInst *CI, std::string FuncName, ManglingRules Rules,
-    std::function<std::string(StringRef)> NameMapFn)
+BuiltinCallMutator::BuiltinCallMutator(CallInst *CI, std::string FuncName,
+                                       ManglingRules Rules,
+                                       ArrayRef<Type *> DemangledTypes,
+                                       bool DidDemangle)
     : CI(CI), FuncName(FuncName),
       Attrs(CI->getCalledFunction()->getAttributes()),
       CallAttrs(CI->getAttributes()), ReturnTy(CI->getType()), Args(CI->args()),
-      Rules(Rules), Builder(CI) {
-  bool DidDemangle = getParameterTypes(CI->getCalledFunction(), PointerTypes,
-                                       std::move(NameMapFn));
+      PointerTypes(DemangledTypes.begin(), DemangledTypes.end()), Rules(Rules),
+      Builder(CI) {
   if (!DidDemangle) {
     // TODO: PipeBlocking.ll causes demangling failures.
     // assert(isNonMangledOCLBuiltin(CI->getCalledFunction()->getName()) &&
@@ -225,7 +225,25 @@ BuiltinCallMutator BuiltinCallHelper::mutateCallInst(CallInst *CI,
 BuiltinCallMutator BuiltinCallHelper::mutateCallInst(CallInst *CI,
                                                      std::string FuncName) {
   assert(CI->getCalledFunction() && "Can only mutate direct function calls.");
-  return BuiltinCallMutator(CI, std::move(FuncName), Rules, NameMapFn);
+  const DemangledParameterTypes &ParamTypes =
+      getDemangledParameterTypes(CI->getCalledFunction());
+  return BuiltinCallMutator(CI, std::move(FuncName), Rules, ParamTypes.Types,
+                            ParamTypes.DidDemangle);
+}
+
+const BuiltinCallHelper::DemangledParameterTypes &
+BuiltinCallHelper::getDemangledParameterTypes(Function *F) {
+  Type *SRetTy = F->arg_empty() ? nullptr : F->getParamStructRetType(0);
+  auto [It, Inserted] = ParameterTypesCache.try_emplace(F->getName());
+  DemangledParameterTypes &Entry = It->second;
+  if (Inserted || Entry.FuncTy != F->getFunctionType() ||
+      Entry.SRetTy != SRetTy) {
+    Entry.FuncTy = F->getFunctionType();
+    Entry.SRetTy = SRetTy;
+    Entry.Types.clear();
+    Entry.DidDemangle = getParameterTypes(F, Entry.Types, NameMapFn);
+  }
+  return Entry;
 }
 
 Value *BuiltinCallHelper::addSPIRVCall(IRBuilder<> &Builder, spv::Op Opcode,
@@ -354,6 +372,7 @@ Type *BuiltinCallHelper::getSPIRVType(spv::Op TypeOpcode,
 
 void BuiltinCallHelper::initialize(llvm::Module &M) {
   this->M = &M;
+  ParameterTypesCache.clear();
   // We want to use pointers-to-opaque-structs for the special types if:
   // * We are translating from SPIR-V to LLVM IR (which means we are using
   //   OpenCL mangling rules)
@@ -373,14 +392,12 @@ BuiltinCallMutator::ValueTypePair
 BuiltinCallHelper::getCallValue(CallInst *CI, unsigned ArgNo) {
   Function *CalledFunc = CI->getCalledFunction();
   assert(CalledFunc && "Unexpected indirect call");
-  if (CalledFunc != CachedFunc) {
-    CachedFunc = CalledFunc;
-    [[maybe_unused]] bool DidDemangle =
-        getParameterTypes(CalledFunc, CachedParameterTypes, NameMapFn);
-    assert(DidDemangle && "Expected SPIR-V builtins to be properly mangled");
-  }
+  const DemangledParameterTypes &ParamTypes =
+      getDemangledParameterTypes(CalledFunc);
+  assert(ParamTypes.DidDemangle &&
+         "Expected SPIR-V builtins to be properly mangled");
 
   Value *ParamValue = CI->getArgOperand(ArgNo);
-  Type *ParamType = CachedParameterTypes[ArgNo];
+  Type *ParamType = ParamTypes.Types[ArgNo];
   return {ParamValue, ParamType};
 }
@@ -44,6 +44,7 @@
 #include "libSPIRV/SPIRVOpCode.h"
 #include "libSPIRV/SPIRVType.h"
 #include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/IR/Attributes.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/TypedPointerType.h"
@@ -88,9 +89,10 @@ class BuiltinCallMutator {
   ManglingRules Rules;
 
   friend class BuiltinCallHelper;
-  BuiltinCallMutator(
-      llvm::CallInst *CI, std::string FuncName, ManglingRules Rules,
-      std::function<std::string(llvm::StringRef)> NameMapFn = nullptr);
+  BuiltinCallMutator(llvm::CallInst *CI, std::string FuncName,
+                     ManglingRules Rules,
+                     llvm::ArrayRef<llvm::Type *> DemangledTypes,
+                     bool DidDemangle);
 
   // This does the actual work of creating of the new call, and will return the
   // new instruction.
@@ -349,8 +351,22 @@ public:
                            bool UseRealType = false);
 
 private:
-  llvm::SmallVector<llvm::Type *, 4> CachedParameterTypes;
-  llvm::Function *CachedFunc = nullptr;
+  struct DemangledParameterTypes {
+    // The demangled types also depend on the LLVM parameter types and on the
+    // sret argument, a later function with the same name must match them.
+    llvm::FunctionType *FuncTy;
+    llvm::Type *SRetTy;
+    bool DidDemangle;
+    llvm::SmallVector<llvm::Type *, 4> Types;
+  };
+
+  /// Return the parameter types of F, as computed by getParameterTypes. The
+  /// result is memoized per builtin name, as each call of a builtin being
+  /// mutated or queried would otherwise demangle its name again.
+  const DemangledParameterTypes &
+  getDemangledParameterTypes(llvm::Function *F);
+
+  llvm::StringMap<DemangledParameterTypes> ParameterTypesCache;
 
 public:
   BuiltinCallMutator::ValueTypePair getCallValue(llvm::CallInst *CI,
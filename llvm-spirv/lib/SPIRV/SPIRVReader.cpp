@@ -5315,6 +5315,14 @@ bool llvm::readSpirv(LLVMContext &C, const SPIRV::TranslatorOpts &Opts,
   return true;
 }
 
+bool llvm::readSpirv(LLVMContext &C, const SPIRV::TranslatorOpts &Opts,
+                     const char *Data, size_t Size, Module *&M,
+                     std::string &ErrMsg) {
+  SPIRVMemoryStreamBuf Buf(Data, Size);
+  std::istream IS(&Buf);
+  return readSpirv(C, Opts, IS, M, ErrMsg);
+}
+
 bool llvm::getSpecConstInfo(std::istream &IS,
                             std::vector<SpecConstInfoTy> &SpecConstInfo) {
   std::unique_ptr<SPIRVModule> BM(SPIRVModule::createSPIRVModule());
@@ -1621,33 +1621,43 @@ SPIRVToLLVMDbgTran::transDebugIntrinsic(const SPIRVExtInst *DebugInst,
 }
 
 DebugLoc SPIRVToLLVMDbgTran::transDebugScope(const SPIRVInstruction *Inst) {
+  SPIRVEntry *S = Inst->getDebugScope();
+  if (!S)
+    return DebugLoc();
+
+  // The instructions of a range share the same scope and line entries, so
+  // their location is only translated once.
+  const SPIRVExtInst *DL = Inst->getDebugLine().get();
+  const SPIRVLine *L = DL ? nullptr : Inst->getLine().get();
+  if (S == LastLoc.DebugScope && DL == LastLoc.DebugLine && L == LastLoc.Line)
+    return LastLoc.Loc;
+
   unsigned Line = 0;
   unsigned Col = 0;
   MDNode *Scope = nullptr;
   MDNode *InlinedAt = nullptr;
 
   // If DebugLine and OpLine are both active give DebugLine priority
-  if (auto DL = Inst->getDebugLine()) {
+  if (DL) {
     using namespace SPIRVDebug::Operand::DebugLine;
-    SPIRVWordVec DebugLineArgs = DL->getArguments();
+    const SPIRVWordVec &DebugLineArgs = DL->getArguments();
     Line =
         getConstantValueOrLiteral(DebugLineArgs, StartIdx, DL->getExtSetKind());
     Col = getConstantValueOrLiteral(DebugLineArgs, ColumnStartIdx,
                                     DL->getExtSetKind());
-  } else if (auto L = Inst->getLine()) {
+  } else if (L) {
     Line = L->getLine();
     Col = L->getColumn();
   }
-  if (SPIRVEntry *S = Inst->getDebugScope()) {
-    using namespace SPIRVDebug::Operand::Scope;
-    SPIRVExtInst *DbgScope = static_cast<SPIRVExtInst *>(S);
-    SPIRVWordVec Ops = DbgScope->getArguments();
-    Scope = getScope(BM->getEntry(Ops[ScopeIdx]));
-    if (Ops.size() > InlinedAtIdx)
-      InlinedAt = transDebugInst(BM->get<SPIRVExtInst>(Ops[InlinedAtIdx]));
-    return DILocation::get(M->getContext(), Line, Col, Scope, InlinedAt);
-  }
-  return DebugLoc();
+  using namespace SPIRVDebug::Operand::Scope;
+  SPIRVExtInst *DbgScope = static_cast<SPIRVExtInst *>(S);
+  const SPIRVWordVec &Ops = DbgScope->getArguments();
+  Scope = getScope(BM->getEntry(Ops[ScopeIdx]));
+  if (Ops.size() > InlinedAtIdx)
+    InlinedAt = transDebugInst(BM->get<SPIRVExtInst>(Ops[InlinedAtIdx]));
+  LastLoc = {S, DL, L,
+             DILocation::get(M->getContext(), Line, Col, Scope, InlinedAt)};
+  return LastLoc.Loc;
 }
 
 MDNode *SPIRVToLLVMDbgTran::transDebugInlined(const SPIRVExtInst *DebugInst) {
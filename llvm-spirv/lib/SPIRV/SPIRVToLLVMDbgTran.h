@@ -188,6 +188,14 @@ private:
   std::unordered_map<std::string, DIFile *> FileMap;
   std::unordered_map<SPIRVId, DISubprogram *> FuncMap;
   std::unordered_map<const SPIRVExtInst *, MDNode *> DebugInstCache;
+  // Location returned by the last transDebugScope() call and the entries it
+  // was translated from.
+  struct {
+    const SPIRVEntry *DebugScope = nullptr;
+    const SPIRVExtInst *DebugLine = nullptr;
+    const SPIRVLine *Line = nullptr;
+    DebugLoc Loc;
+  } LastLoc;
 
   struct SplitFileName {
     SplitFileName(const std::string &FileName);
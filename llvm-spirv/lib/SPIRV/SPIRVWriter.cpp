@@ -88,6 +88,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/TargetParser/Triple.h"
+#include "llvm/Transforms/IPO/GlobalDCE.h"
 #include "llvm/Transforms/Utils/LoopSimplify.h"
 #include "llvm/Transforms/Utils/Mem2Reg.h"
 
@@ -637,9 +638,9 @@ SPIRVType *LLVMToSPIRVBase::transPointerType(Type *ET, unsigned AddrSpc) {
                           SPIRVEC_FunctionPointers, toString(T)))
     return nullptr;
 
-  std::string TypeKey = (Twine((uintptr_t)ET) + Twine(AddrSpc)).str();
-  auto Loc = PointeeTypeMap.find(TypeKey);
-  if (Loc != PointeeTypeMap.end())
+  std::pair<const void *, unsigned> TypeKey = {ET, AddrSpc};
+  auto Loc = PointerTypeMap.find(TypeKey);
+  if (Loc != PointerTypeMap.end())
     return Loc->second;
 
   // A pointer to image or pipe type in LLVM is translated to a SPIRV
@@ -674,7 +675,7 @@ SPIRVType *LLVMToSPIRVBase::transPointerType(Type *ET, unsigned AddrSpc) {
 
     auto SaveType = [&](SPIRVType *MappedTy) {
       OpaqueStructMap[Key] = MappedTy;
-      PointeeTypeMap[TypeKey] = MappedTy;
+      PointerTypeMap[TypeKey] = MappedTy;
       return MappedTy;
     };
 
@@ -723,9 +724,9 @@ SPIRVType *LLVMToSPIRVBase::transPointerType(Type *ET, unsigned AddrSpc) {
     // ET, as a recursive type, may contain exactly the same pointer T, so it
     // may happen that after translation of ET we already have translated T,
     // added the translated pointer to the SPIR-V module and mapped T to this
-    // pointer. Now we have to check PointeeTypeMap again.
-    auto Loc = PointeeTypeMap.find(TypeKey);
-    if (Loc != PointeeTypeMap.end()) {
+    // pointer. Now we have to check PointerTypeMap again.
+    auto Loc = PointerTypeMap.find(TypeKey);
+    if (Loc != PointerTypeMap.end()) {
       return Loc->second;
     }
 
@@ -739,7 +740,7 @@ SPIRVType *LLVMToSPIRVBase::transPointerType(Type *ET, unsigned AddrSpc) {
       ElementType = transType(ET);
       TranslatedTy = transPointerType(ElementType, AddrSpc);
     }
-    PointeeTypeMap[TypeKey] = TranslatedTy;
+    PointerTypeMap[TypeKey] = TranslatedTy;
     return TranslatedTy;
   }
 
@@ -748,9 +749,9 @@ SPIRVType *LLVMToSPIRVBase::transPointerType(Type *ET, unsigned AddrSpc) {
 }
 
 SPIRVType *LLVMToSPIRVBase::transPointerType(SPIRVType *ET, unsigned AddrSpc) {
-  std::string TypeKey = (Twine((uintptr_t)ET) + Twine(AddrSpc)).str();
-  auto Loc = PointeeTypeMap.find(TypeKey);
-  if (Loc != PointeeTypeMap.end())
+  std::pair<const void *, unsigned> TypeKey = {ET, AddrSpc};
+  auto Loc = PointerTypeMap.find(TypeKey);
+  if (Loc != PointerTypeMap.end())
     return Loc->second;
 
   SPIRVType *TranslatedTy = nullptr;
@@ -766,7 +767,7 @@ SPIRVType *LLVMToSPIRVBase::transPointerType(SPIRVType *ET, unsigned AddrSpc) {
     TranslatedTy = BM->addPointerType(
         SPIRSPIRVAddrSpaceMap::map(static_cast<SPIRAddressSpace>(AddrSpc)), ET);
   }
-  PointeeTypeMap[TypeKey] = TranslatedTy;
+  PointerTypeMap[TypeKey] = TranslatedTy;
   return TranslatedTy;
 }
 
@@ -870,21 +871,18 @@ SPIRVType *LLVMToSPIRVBase::transScavengedType(Value *V) {
 SPIRVType *
 LLVMToSPIRVBase::getSPIRVFunctionType(SPIRVType *RT,
                                       const std::vector<SPIRVType *> &Args) {
-  // Come up with a unique string identifier for the arguments. This is a hacky
-  // way of doing so, but it works.
-  std::string TypeKey;
-  llvm::raw_string_ostream TKS(TypeKey);
-  TKS << (uintptr_t)RT << ",";
-  for (SPIRVType *ArgTy : Args) {
-    TKS << (uintptr_t)ArgTy << ",";
-  }
+  std::vector<SPIRVType *> TypeKey;
+  TypeKey.reserve(Args.size() + 1);
+  TypeKey.push_back(RT);
+  TypeKey.insert(TypeKey.end(), Args.begin(), Args.end());
 
   // Create a SPIRVType for the function type. Since SPIRVModule doesn't do
   // any type uniquing for SPIRVType, we have to do it ourself.
-  TKS.flush();
-  auto It = PointeeTypeMap.find(TypeKey);
-  if (It == PointeeTypeMap.end())
-    It = PointeeTypeMap.insert({TypeKey, BM->addFunctionType(RT, Args)}).first;
+  auto It = FunctionTypeMap.find(TypeKey);
+  if (It == FunctionTypeMap.end())
+    It = FunctionTypeMap.emplace(std::move(TypeKey),
+                                 BM->addFunctionType(RT, Args))
+             .first;
   return It->second;
 }
 
@@ -6844,6 +6842,27 @@ void addPassesForSPIRV(ModulePassManager &PassMgr,
       SPIRVLowerBitCastToNonStandardTypePass(Opts)));
 }
 
+// Gives internal linkage to the function definitions which can't be entry
+// points, so that GlobalDCE drops those the kernels don't reach together with
+// the types, constants and decorations only they use. Functions that may be
+// called through a pointer obtained by name are kept. Modules without kernels
+// are libraries and are left alone.
+static bool internalizeNonEntryPoints(Module &M) {
+  auto IsKernel = [](const Function &F) {
+    return F.getCallingConv() == CallingConv::SPIR_KERNEL;
+  };
+  if (llvm::none_of(M, IsKernel))
+    return false;
+  for (Function &F : M) {
+    if (F.isDeclaration() || F.hasLocalLinkage() || IsKernel(F) ||
+        F.hasFnAttribute("referenced-indirectly"))
+      continue;
+    F.setLinkage(GlobalValue::InternalLinkage);
+    F.setComdat(nullptr);
+  }
+  return true;
+}
+
 bool isValidLLVMModule(Module *M, SPIRVErrorLog &ErrorLog) {
   if (!M)
     return false;
@@ -7024,6 +7043,9 @@ bool runSpirvWriterPasses(Module *M, std::ostream *OS, std::string &ErrMsg,
   }
 
   ModulePassManager PassMgr;
+  if (WriteSpirv && Opts.shouldPruneToEntryPoints() &&
+      internalizeNonEntryPoints(*M))
+    PassMgr.addPass(GlobalDCEPass());
   addPassesForSPIRV(PassMgr, Opts);
   if (WriteSpirv) {
     // Run loop simplify pass in order to avoid duplicate OpLoopMerge
@@ -7051,8 +7073,10 @@ bool runSpirvWriterPasses(Module *M, std::ostream *OS, std::string &ErrMsg,
   if (BM->getError(ErrMsg) != SPIRVEC_Success)
     return false;
 
+  // BM is destroyed right after, so the function bodies can go as soon as
+  // they are written.
   if (WriteSpirv)
-    *OS << *BM;
+    BM->encodeAndReleaseFunctionBodies(*OS);
 
   return true;
 }
@@ -61,6 +61,7 @@
 #include "llvm/Analysis/CallGraph.h"
 #include "llvm/IR/IntrinsicInst.h"
 
+#include <map>
 #include <memory>
 
 using namespace llvm;
@@ -181,8 +182,12 @@ private:
   // This maps {struct name, addrspace} to SPIRVType, for those structs that
   // represent special SPIRV types.
   DenseMap<std::pair<StringRef, unsigned>, SPIRVType *> OpaqueStructMap;
-  // This maps <type-unique keys> to SPIRVType, for use in function types.
-  StringMap<SPIRVType *> PointeeTypeMap;
+  // This maps {pointee type, addrspace} to the SPIR-V pointer type, the
+  // pointee being either an LLVM type or an already translated SPIRVType.
+  DenseMap<std::pair<const void *, unsigned>, SPIRVType *> PointerTypeMap;
+  // This maps {return type, argument types...} to SPIRVType, for use in
+  // function types.
+  std::map<std::vector<SPIRVType *>, SPIRVType *> FunctionTypeMap;
 
   /// Get the SPIRVFunctionType with appropriate return and argument types,
   /// returning an existing instance if one has already been created. This is
@@ -190,8 +190,8 @@ void SPIRVEntry::encodeLine(spv_ostream &O) const {
 
 namespace {
 bool isDebugLineEqual(const SPIRVExtInst &DL1, const SPIRVExtInst &DL2) {
-  std::vector<SPIRVWord> DL1Args = DL1.getArguments();
-  std::vector<SPIRVWord> DL2Args = DL2.getArguments();
+  const std::vector<SPIRVWord> &DL1Args = DL1.getArguments();
+  const std::vector<SPIRVWord> &DL2Args = DL2.getArguments();
 
   using namespace SPIRVDebug::Operand::DebugLine;
   assert(DL1Args.size() == OperandCount && DL2Args.size() == OperandCount &&
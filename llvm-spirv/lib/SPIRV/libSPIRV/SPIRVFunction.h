@@ -136,6 +136,14 @@ public:
     return BB;
   }
 
+  // Hands the basic blocks over to the caller, which deletes them.
+  std::vector<SPIRVBasicBlock *> takeBasicBlocks() {
+    Variables.clear();
+    std::vector<SPIRVBasicBlock *> BBs;
+    BBs.swap(BBVec);
+    return BBs;
+  }
+
   void encodeChildren(spv_ostream &) const override;
   void encodeExecutionModes(spv_ostream &) const;
   _SPIRV_DCL_ENCDEC
@@ -55,6 +55,7 @@
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace SPIRV {
 
@@ -68,6 +69,60 @@ std::string to_string(uint32_t Version) {
 std::string to_string(VersionNumber Version) {
   return to_string(static_cast<uint32_t>(Version));
 }
+
+/// Map from the ids to the entries. The ids of a module are below its bound
+/// and mostly dense, so the entries are kept in a vector indexed by the id,
+/// the lookup being a bounds check and a load. The ids too large to be
+/// indexed, which only a corrupted module uses, go to a hash map.
+class SPIRVIdEntryTable {
+public:
+  SPIRVEntry *lookup(SPIRVId Id) const {
+    if (Id < Dense.size())
+      return Dense[Id];
+    if (Id < MaxDenseId)
+      return nullptr;
+    auto Loc = Sparse.find(Id);
+    return Loc == Sparse.end() ? nullptr : Loc->second;
+  }
+
+  void set(SPIRVId Id, SPIRVEntry *Entry) {
+    assert(Entry && "Invalid entry");
+    if (Id >= MaxDenseId) {
+      Sparse[Id] = Entry;
+      return;
+    }
+    if (Id >= Dense.size())
+      Dense.resize(std::min<size_t>(std::max<size_t>(Id + 1, Dense.size() * 2),
+                                    MaxDenseId));
+    Dense[Id] = Entry;
+  }
+
+  void erase(SPIRVId Id) {
+    assert(lookup(Id) && "Id is not in map");
+    if (Id < MaxDenseId)
+      Dense[Id] = nullptr;
+    else
+      Sparse.erase(Id);
+  }
+
+  void reserve(SPIRVWord Bound) {
+    Dense.reserve(std::min<SPIRVWord>(Bound, MaxDenseId));
+  }
+
+  template <typename FuncTy> void forEach(FuncTy Func) const {
+    for (SPIRVEntry *Entry : Dense)
+      if (Entry)
+        Func(Entry);
+    for (const auto &I : Sparse)
+      Func(I.second);
+  }
+
+private:
+  static constexpr SPIRVWord MaxDenseId = 1u << 22;
+
+  std::vector<SPIRVEntry *> Dense;
+  std::unordered_map<SPIRVId, SPIRVEntry *> Sparse;
+};
 } // Anonymous namespace
 
 SPIRVModule::SPIRVModule()
@@ -499,8 +554,13 @@ public:
   // I/O functions
   friend spv_ostream &operator<<(spv_ostream &O, SPIRVModule &M);
   friend std::istream &operator>>(std::istream &I, SPIRVModule &M);
+  void encodeAndReleaseFunctionBodies(spv_ostream &O) override;
 
 private:
+  void encode(spv_ostream &O, bool ReleaseFunctionBodies);
+  void releaseFunctionBody(SPIRVFunction *F);
+  void releaseEntry(SPIRVEntry *E);
+
   SPIRVErrorLog ErrLog;
   SPIRVId NextId;
   VersionNumber SPIRVVersion;
@@ -546,7 +606,7 @@ private:
 
   SPIRVForwardPointerVec ForwardPointerVec;
   SPIRVTypeVec TypeVec;
-  SPIRVIdToEntryMap IdEntryMap;
+  SPIRVIdEntryTable IdEntryMap;
   SPIRVIdToEntryMap IdTypeForwardMap; // Forward declared IDs
   SPIRVFunctionVector FuncVec;
   SPIRVConstantVector ConstVec;
@@ -593,8 +653,7 @@ SPIRVModuleImpl::~SPIRVModuleImpl() {
   for (auto *I : EntryNoId)
     delete I;
 
-  for (auto I : IdEntryMap)
-    delete I.second;
+  IdEntryMap.forEach([](SPIRVEntry *E) { delete E; });
 
   for (auto C : CapMap)
     delete C.second;
@@ -636,7 +695,7 @@ bool isDebugLineEqual(const SPIRVExtInst &CurrentDebugLine, SPIRVId FileNameId,
                       SPIRVId LineStartId, SPIRVId LineEndId,
                       SPIRVId ColumnStartId, SPIRVId ColumnEndId) {
   assert(CurrentDebugLine.getExtOp() == SPIRVDebug::DebugLine);
-  const std::vector<SPIRVWord> CurrentDebugLineArgs =
+  const std::vector<SPIRVWord> &CurrentDebugLineArgs =
       CurrentDebugLine.getArguments();
 
   using namespace SPIRVDebug::Operand::DebugLine;
@@ -652,20 +711,21 @@ void SPIRVModuleImpl::addDebugLine(SPIRVEntry *E, SPIRVType *TheType,
                                    SPIRVId FileNameId, SPIRVWord LineStart,
                                    SPIRVWord LineEnd, SPIRVWord ColumnStart,
                                    SPIRVWord ColumnEnd) {
+  SPIRVId LineStartId = getLiteralAsConstant(LineStart)->getId();
+  SPIRVId LineEndId = getLiteralAsConstant(LineEnd)->getId();
+  SPIRVId ColumnStartId = getLiteralAsConstant(ColumnStart)->getId();
+  SPIRVId ColumnEndId = getLiteralAsConstant(ColumnEnd)->getId();
   if (!(CurrentDebugLine &&
-        isDebugLineEqual(*CurrentDebugLine, FileNameId,
-                         getLiteralAsConstant(LineStart)->getId(),
-                         getLiteralAsConstant(LineEnd)->getId(),
-                         getLiteralAsConstant(ColumnStart)->getId(),
-                         getLiteralAsConstant(ColumnEnd)->getId()))) {
+        isDebugLineEqual(*CurrentDebugLine, FileNameId, LineStartId, LineEndId,
+                         ColumnStartId, ColumnEndId))) {
     using namespace SPIRVDebug::Operand::DebugLine;
 
     std::vector<SPIRVWord> DebugLineOps(OperandCount);
     DebugLineOps[SourceIdx] = FileNameId;
-    DebugLineOps[StartIdx] = getLiteralAsConstant(LineStart)->getId();
-    DebugLineOps[EndIdx] = getLiteralAsConstant(LineEnd)->getId();
-    DebugLineOps[ColumnStartIdx] = getLiteralAsConstant(ColumnStart)->getId();
-    DebugLineOps[ColumnEndIdx] = getLiteralAsConstant(ColumnEnd)->getId();
+    DebugLineOps[StartIdx] = LineStartId;
+    DebugLineOps[EndIdx] = LineEndId;
+    DebugLineOps[ColumnStartIdx] = ColumnStartId;
+    DebugLineOps[ColumnEndIdx] = ColumnEndId;
 
     CurrentDebugLine.reset(static_cast<SPIRVExtInst *>(
         createDebugInfo(SPIRVDebug::DebugLine, TheType, DebugLineOps)));
@@ -825,7 +885,7 @@ SPIRVEntry *SPIRVModuleImpl::addEntry(SPIRVEntry *Entry) {
         assert(Mapped == Entry && "Id used twice");
       }
     } else
-      IdEntryMap[Id] = Entry;
+      IdEntryMap.set(Id, Entry);
   } else {
     // Collect entries with no ID to de-allocate them at the end.
     // Entry of OpLine will be deleted by std::shared_ptr automatically.
@@ -867,11 +927,11 @@ bool SPIRVModuleImpl::exist(SPIRVId Id) const { return exist(Id, nullptr); }
 
 bool SPIRVModuleImpl::exist(SPIRVId Id, SPIRVEntry **Entry) const {
   assert(Id != SPIRVID_INVALID && "Invalid Id");
-  SPIRVIdToEntryMap::const_iterator Loc = IdEntryMap.find(Id);
-  if (Loc == IdEntryMap.end())
+  SPIRVEntry *Mapped = IdEntryMap.lookup(Id);
+  if (!Mapped)
     return false;
   if (Entry)
-    *Entry = Loc->second;
+    *Entry = Mapped;
   return true;
 }
 
@@ -888,10 +948,8 @@ SPIRVId SPIRVModuleImpl::getId(SPIRVId Id, unsigned Increment) {
 
 SPIRVEntry *SPIRVModuleImpl::getEntry(SPIRVId Id) const {
   assert(Id != SPIRVID_INVALID && "Invalid Id");
-  SPIRVIdToEntryMap::const_iterator Loc = IdEntryMap.find(Id);
-  if (Loc != IdEntryMap.end()) {
-    return Loc->second;
-  }
+  if (SPIRVEntry *Entry = IdEntryMap.lookup(Id))
+    return Entry;
   SPIRVIdToEntryMap::const_iterator LocFwd = IdTypeForwardMap.find(Id);
   if (LocFwd != IdTypeForwardMap.end()) {
     return LocFwd->second;
@@ -1206,15 +1264,13 @@ SPIRVEntry *SPIRVModuleImpl::replaceForward(SPIRVForward *Forward,
   SPIRVId Id = Entry->getId();
   SPIRVId ForwardId = Forward->getId();
   if (ForwardId == Id) {
-    IdEntryMap[Id] = Entry;
+    IdEntryMap.set(Id, Entry);
     // Annotations include name, decorations, execution modes
     Entry->takeAnnotations(Forward);
   } else {
-    auto Loc = IdEntryMap.find(Id);
-    assert(Loc != IdEntryMap.end());
-    IdEntryMap.erase(Loc);
+    IdEntryMap.erase(Id);
     Entry->setId(ForwardId);
-    IdEntryMap[ForwardId] = Entry;
+    IdEntryMap.set(ForwardId, Entry);
     // Replace current Id with ForwardId in decorates.
     Entry->replaceTargetIdInDecorates(ForwardId);
   }
@@ -1226,9 +1282,7 @@ void SPIRVModuleImpl::eraseInstruction(SPIRVInstruction *I,
                                        SPIRVBasicBlock *BB) {
   SPIRVId Id = I->getId();
   BB->eraseInstruction(I);
-  auto Loc = IdEntryMap.find(Id);
-  assert(Loc != IdEntryMap.end());
-  IdEntryMap.erase(Loc);
+  IdEntryMap.erase(Id);
   delete I;
 }
 
@@ -2035,7 +2089,36 @@ spv_ostream &operator<<(spv_ostream &O, const TopologicalSort &S) {
 }
 
 spv_ostream &operator<<(spv_ostream &O, SPIRVModule &M) {
-  SPIRVModuleImpl &MI = *static_cast<SPIRVModuleImpl *>(&M);
+  static_cast<SPIRVModuleImpl *>(&M)->encode(O, false);
+  return O;
+}
+
+void SPIRVModuleImpl::encodeAndReleaseFunctionBodies(spv_ostream &O) {
+  encode(O, true);
+}
+
+void SPIRVModuleImpl::releaseEntry(SPIRVEntry *E) {
+  if (E->hasId()) {
+    NamedId.erase(E->getId());
+    IdEntryMap.erase(E->getId());
+  } else if (!EntryNoId.erase(E)) {
+    // OpLine is owned by the std::shared_ptr of the entries on the line.
+    return;
+  }
+  delete E;
+}
+
+void SPIRVModuleImpl::releaseFunctionBody(SPIRVFunction *F) {
+  for (SPIRVBasicBlock *BB : F->takeBasicBlocks()) {
+    for (size_t I = 0, E = BB->getNumInst(); I != E; ++I)
+      releaseEntry(BB->getInst(I));
+    releaseEntry(BB);
+  }
+}
+
+void SPIRVModuleImpl::encode(spv_ostream &O, bool ReleaseFunctionBodies) {
+  SPIRVModuleImpl &MI = *this;
+  SPIRVModule &M = *this;
   // Start tracking of the current line with no line
   MI.CurrentLine.reset();
   MI.CurrentDebugLine.reset();
@@ -2112,9 +2195,13 @@ spv_ostream &operator<<(spv_ostream &O, SPIRVModule &M) {
                      }),
       MI.DebugInstVec.end());
 
-  O << SPIRVNL() << MI.DebugInstVec << MI.AuxDataInstVec << SPIRVNL()
-    << MI.FuncVec;
-  return O;
+  O << SPIRVNL() << MI.DebugInstVec << MI.AuxDataInstVec << SPIRVNL();
+  // Nothing written after a function refers to its body.
+  for (SPIRVFunction *F : MI.FuncVec) {
+    O << *F;
+    if (ReleaseFunctionBodies)
+      releaseFunctionBody(F);
+  }
 }
 
 template <class T>
@@ -2408,6 +2495,8 @@ std::istream &SPIRVModuleImpl::parseSPIRV(std::istream &I) {
   MI.GeneratorVer = Header[2] & 0xFFFF;
   MI.NextId = Header[3];
   MI.InstSchema = static_cast<SPIRVInstructionSchemaKind>(Header[4]);
+  // The header bounds the ids, most of which get an entry.
+  MI.IdEntryMap.reserve(Header[3]);
 
   SPIRVEntry *Scope = nullptr;
   while (true) {
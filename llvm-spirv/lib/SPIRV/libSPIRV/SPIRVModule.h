@@ -593,6 +593,11 @@ public:
   // I/O functions
   friend spv_ostream &operator<<(spv_ostream &O, SPIRVModule &M);
   friend std::istream &operator>>(std::istream &I, SPIRVModule &M);
+  // Writes the module like operator<<, deleting the basic blocks of each
+  // function as soon as the function is written, so that the bodies and the
+  // output are not both kept in memory. The module can only be destroyed
+  // afterwards.
+  virtual void encodeAndReleaseFunctionBodies(spv_ostream &O) = 0;
 
 protected:
   bool AutoAddCapability;
@@ -85,6 +85,25 @@ static void readQuotedString(std::istream &IS, std::string &Str) {
 bool SPIRVUseTextFormat = false;
 #endif
 
+SPIRVMemoryStreamBuf::pos_type
+SPIRVMemoryStreamBuf::seekoff(off_type Off, std::ios_base::seekdir Dir,
+                              std::ios_base::openmode Which) {
+  if (!(Which & std::ios_base::in))
+    return pos_type(off_type(-1));
+  char *Base = Dir == std::ios_base::beg   ? eback()
+               : Dir == std::ios_base::cur ? gptr()
+                                           : egptr();
+  if (Off < eback() - Base || Off > egptr() - Base)
+    return pos_type(off_type(-1));
+  setg(eback(), Base + Off, egptr());
+  return pos_type(gptr() - eback());
+}
+
+SPIRVMemoryStreamBuf::pos_type
+SPIRVMemoryStreamBuf::seekpos(pos_type Pos, std::ios_base::openmode Which) {
+  return seekoff(off_type(Pos), std::ios_base::beg, Which);
+}
+
 SPIRVDecoder::SPIRVDecoder(std::istream &InputStream, SPIRVFunction &F)
     : IS(InputStream), M(*F.getModule()), WordCount(0), OpCode(OpNop),
       Scope(&F) {}
@@ -161,17 +180,25 @@ const SPIRVDecoder &operator>>(const SPIRVDecoder &I, std::string &Str) {
   }
 #endif
 
+  // Like the words, the characters are read from the stream buffer directly.
+  std::streambuf *Buf = I.IS.rdbuf();
+  auto GetChar = [&]() {
+    int Ch = I.IS.good() ? Buf->sbumpc() : std::char_traits<char>::eof();
+    if (Ch == std::char_traits<char>::eof())
+      I.IS.setstate(std::ios_base::eofbit | std::ios_base::failbit);
+    return Ch;
+  };
   uint64_t Count = 0;
-  char Ch;
-  while (I.IS.get(Ch) && Ch != '\0') {
-    Str += Ch;
+  for (int Ch = GetChar(); Ch != std::char_traits<char>::eof() && Ch != '\0';
+       Ch = GetChar()) {
+    Str += static_cast<char>(Ch);
     ++Count;
   }
   Count = (Count + 1) % 4;
   Count = Count ? 4 - Count : 0;
   for (; Count; --Count) {
-    I.IS >> Ch;
-    assert(Ch == '\0' && "Invalid string in SPIRV");
+    [[maybe_unused]] int Ch = GetChar();
+    assert((Ch == '\0' || !I.IS.good()) && "Invalid string in SPIRV");
   }
   SPIRVDBG(spvdbgs() << "Read string: \"" << Str << "\"\n");
   return I;
@@ -46,6 +46,7 @@
 #include <cctype>
 #include <cstdint>
 #include <iostream>
+#include <streambuf>
 #include <string>
 #include <vector>
 
@@ -63,6 +64,21 @@ extern bool SPIRVUseTextFormat;
 class SPIRVFunction;
 class SPIRVBasicBlock;
 
+/// Read-only stream buffer over SPIR-V held in memory, so that the binary is
+/// decoded in place instead of being copied into a string stream first.
+class SPIRVMemoryStreamBuf : public std::streambuf {
+public:
+  SPIRVMemoryStreamBuf(const char *Data, size_t Size) {
+    char *Begin = const_cast<char *>(Data);
+    setg(Begin, Begin, Begin + Size);
+  }
+
+protected:
+  pos_type seekoff(off_type Off, std::ios_base::seekdir Dir,
+                   std::ios_base::openmode Which) override;
+  pos_type seekpos(pos_type Pos, std::ios_base::openmode Which) override;
+};
+
 class SPIRVDecoder {
 public:
   SPIRVDecoder(std::istream &InputStream, SPIRVModule &Module)
@@ -100,8 +116,13 @@ class SPIRVNL {
 
 template <typename T>
 const SPIRVDecoder &decodeBinary(const SPIRVDecoder &I, T &V) {
-  uint32_t W;
-  I.IS.read(reinterpret_cast<char *>(&W), sizeof(W));
+  uint32_t W = 0;
+  // Reads from the stream buffer directly, constructing the sentry of
+  // std::istream::read for every word is expensive for large modules.
+  if (!I.IS.good() ||
+      I.IS.rdbuf()->sgetn(reinterpret_cast<char *>(&W), sizeof(W)) !=
+          sizeof(W))
+    I.IS.setstate(std::ios_base::eofbit | std::ios_base::failbit);
   V = static_cast<T>(W);
   SPIRVDBG(spvdbgs() << "Read word: W = " << W << " V = " << V << '\n');
   return I;
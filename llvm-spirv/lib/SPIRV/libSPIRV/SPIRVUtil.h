@@ -133,7 +133,7 @@ public:
     }
   }
 
-  static bool find(Ty1 Key, Ty2 *Val = nullptr) {
+  static bool find(const Ty1 &Key, Ty2 *Val = nullptr) {
     const SPIRVMap &Map = getMap();
     typename MapTy::const_iterator Loc = Map.Map.find(Key);
     if (Loc == Map.Map.end())
@@ -143,7 +143,7 @@ public:
     return true;
   }
 
-  static bool rfind(Ty2 Key, Ty1 *Val = nullptr) {
+  static bool rfind(const Ty2 &Key, Ty1 *Val = nullptr) {
     const SPIRVMap &Map = getRMap();
     typename RevMapTy::const_iterator Loc = Map.RevMap.find(Key);
     if (Loc == Map.RevMap.end())
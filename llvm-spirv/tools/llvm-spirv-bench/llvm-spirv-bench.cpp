@@ -0,0 +1,250 @@
+//===- llvm-spirv-bench.cpp - Benchmark of the LLVM/SPIR-V Translator -----===//
+//
+//                     The LLVM/SPIR-V Translator
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+//
+// Runs the forward (LLVM IR to SPIR-V) and reverse (SPIR-V to LLVM IR)
+// translations on a corpus of LLVM IR or bitcode modules, typically SYCL
+// device modules saved with -fsycl-dump-device-code or -save-temps, and
+// reports for each module and direction the time, the peak resident set size
+// and the size of the output (SPIR-V for the forward translation, bitcode for
+// the reverse one):
+//
+//   llvm-spirv-bench [--repetitions=<N>] [--json=<file>] <module or dir>...
+//
+// The translations run in process, through the same library entry points as
+// the llvm-spirv tool, with the options the SYCL toolchain passes to it. The
+// time reported is the median over the repetitions.
+//
+//===----------------------------------------------------------------------===//
+
+#include "LLVMSPIRVLib.h"
+
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IRReader/IRReader.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::list<std::string> Inputs(cl::Positional, cl::OneOrMore,
+                                    cl::desc("<module or directory>..."));
+
+static cl::opt<unsigned> Repetitions("repetitions", cl::init(5),
+                                     cl::desc("Runs of each translation"));
+
+static cl::opt<std::string>
+    JSONFile("json", cl::desc("Write the results as JSON to <file>"),
+             cl::value_desc("file"));
+
+namespace {
+struct Measurement {
+  double MedianMs = 0;
+  uint64_t PeakRSSBytes = 0;
+  uint64_t OutputBytes = 0;
+};
+
+struct Result {
+  std::string Name;
+  uint64_t InputBytes;
+  Measurement Forward;
+  Measurement Reverse;
+};
+
+// The peak resident set size of the process is a high-water mark, it is reset
+// before each translation where the OS allows it, so that each measurement
+// only accounts for its own translation.
+void resetPeakRSS() {
+#if defined(__linux__)
+  std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+
+uint64_t getPeakRSS() {
+#if defined(__linux__)
+  std::ifstream Status("/proc/self/status");
+  std::string Line;
+  while (std::getline(Status, Line))
+    if (Line.rfind("VmHWM:", 0) == 0)
+      return std::stoull(Line.substr(6)) * 1024;
+#endif
+  return 0;
+}
+
+SPIRV::TranslatorOpts getTranslatorOpts() {
+  SPIRV::TranslatorOpts Opts;
+  Opts.enableAllExtensions();
+  Opts.setDebugInfoEIS(SPIRV::DebugInfoEIS::OpenCL_DebugInfo_100);
+  Opts.setAllowExtraDIExpressionsEnabled(true);
+  Opts.setPreserveAuxData(true);
+  Opts.setDesiredBIsRepresentation(SPIRV::BIsRepresentation::SPIRVFriendlyIR);
+  return Opts;
+}
+
+template <typename FuncTy>
+Expected<Measurement> measure(unsigned Runs, FuncTy Translate) {
+  Measurement M;
+  std::vector<double> Samples;
+  for (unsigned I = 0; I < Runs; ++I) {
+    resetPeakRSS();
+    auto Start = std::chrono::steady_clock::now();
+    Expected<uint64_t> OutputBytes = Translate();
+    auto End = std::chrono::steady_clock::now();
+    if (!OutputBytes)
+      return OutputBytes.takeError();
+    M.OutputBytes = *OutputBytes;
+    M.PeakRSSBytes = std::max(M.PeakRSSBytes, getPeakRSS());
+    Samples.push_back(
+        std::chrono::duration<double, std::milli>(End - Start).count());
+  }
+  std::sort(Samples.begin(), Samples.end());
+  size_t Mid = Samples.size() / 2;
+  M.MedianMs = Samples.size() % 2 ? Samples[Mid]
+                                   : (Samples[Mid - 1] + Samples[Mid]) / 2;
+  return M;
+}
+
+Expected<Result> run(StringRef File) {
+  LLVMContext Ctx;
+  SMDiagnostic Err;
+  std::unique_ptr<Module> M = parseIRFile(File, Err, Ctx);
+  if (!M)
+    return createStringError(inconvertibleErrorCode(), Err.getMessage());
+
+  Result R;
+  R.Name = sys::path::filename(File).str();
+  uint64_t InputBytes = 0;
+  sys::fs::file_size(File, InputBytes);
+  R.InputBytes = InputBytes;
+
+  SPIRV::TranslatorOpts Opts = getTranslatorOpts();
+  std::string SPIRV;
+  // The writer regularizes the module in place, so each run translates a
+  // fresh copy of it.
+  auto Forward = measure(Repetitions, [&]() -> Expected<uint64_t> {
+    std::unique_ptr<Module> Copy = CloneModule(*M);
+    std::ostringstream OS;
+    std::string ErrMsg;
+    if (!writeSpirv(Copy.get(), Opts, OS, ErrMsg))
+      return createStringError(inconvertibleErrorCode(), ErrMsg);
+    SPIRV = OS.str();
+    return SPIRV.size();
+  });
+  if (!Forward)
+    return Forward.takeError();
+  R.Forward = *Forward;
+  M.reset();
+
+  auto Reverse = measure(Repetitions, [&]() -> Expected<uint64_t> {
+    LLVMContext RevCtx;
+    Module *RevM = nullptr;
+    std::string ErrMsg;
+    if (!readSpirv(RevCtx, Opts, SPIRV.data(), SPIRV.size(), RevM, ErrMsg))
+      return createStringError(inconvertibleErrorCode(), ErrMsg);
+    std::unique_ptr<Module> Owner(RevM);
+    std::string Bitcode;
+    raw_string_ostream OS(Bitcode);
+    WriteBitcodeToFile(*Owner, OS);
+    return OS.str().size();
+  });
+  if (!Reverse)
+    return Reverse.takeError();
+  R.Reverse = *Reverse;
+  return R;
+}
+
+void collectInputs(StringRef Path, std::vector<std::string> &Files) {
+  if (!sys::fs::is_directory(Path)) {
+    Files.push_back(Path.str());
+    return;
+  }
+  std::error_code EC;
+  for (sys::fs::directory_iterator It(Path, EC), End; It != End && !EC;
+       It.increment(EC)) {
+    StringRef Ext = sys::path::extension(It->path());
+    if (Ext == ".bc" || Ext == ".ll")
+      Files.push_back(It->path());
+  }
+}
+
+json::Object toJSON(const Measurement &M) {
+  return json::Object{{"median_ms", M.MedianMs},
+                      {"peak_rss_bytes", int64_t(M.PeakRSSBytes)},
+                      {"output_bytes", int64_t(M.OutputBytes)}};
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  InitLLVM X(argc, argv);
+  cl::ParseCommandLineOptions(argc, argv, "LLVM/SPIR-V translator benchmark\n");
+  if (!Repetitions) {
+    errs() << "The repetitions must be positive\n";
+    return 1;
+  }
+
+  std::vector<std::string> Files;
+  for (const std::string &Input : Inputs)
+    collectInputs(Input, Files);
+  std::sort(Files.begin(), Files.end());
+
+  outs() << format("%-40s %10s %12s %12s %12s %12s %12s\n", "Module",
+                   "input KB", "forward ms", "forward MB", "SPIR-V KB",
+                   "reverse ms", "reverse MB");
+  std::vector<Result> Results;
+  bool Failed = false;
+  for (const std::string &File : Files) {
+    Expected<Result> R = run(File);
+    if (!R) {
+      errs() << File << ": " << toString(R.takeError()) << "\n";
+      Failed = true;
+      continue;
+    }
+    outs() << format("%-40s %10.0f %12.1f %12.1f %12.0f %12.1f %12.1f\n",
+                     R->Name.c_str(), R->InputBytes / 1024.0,
+                     R->Forward.MedianMs, R->Forward.PeakRSSBytes / 1048576.0,
+                     R->Forward.OutputBytes / 1024.0, R->Reverse.MedianMs,
+                     R->Reverse.PeakRSSBytes / 1048576.0);
+    Results.push_back(std::move(*R));
+  }
+
+  if (!JSONFile.empty()) {
+    json::Array Modules;
+    for (const Result &R : Results)
+      Modules.push_back(json::Object{{"name", R.Name},
+                                     {"input_bytes", int64_t(R.InputBytes)},
+                                     {"forward", toJSON(R.Forward)},
+                                     {"reverse", toJSON(R.Reverse)}});
+    std::error_code EC;
+    raw_fd_ostream OS(JSONFile, EC);
+    if (EC) {
+      errs() << JSONFile << ": " << EC.message() << "\n";
+      return 1;
+    }
+    OS << formatv("{0:2}\n", json::Value(json::Object{
+                                 {"repetitions", int64_t(Repetitions)},
+                                 {"modules", std::move(Modules)}}));
+  }
+  return Failed ? 1 : 0;
+}
@@ -38,7 +38,7 @@ private:
   /// symbol in shared memory.
   /// It alters the signature of the kernel (pointer vs offset value) as well
   /// as the access (dereferencing the argument pointer vs GEP to the global
-  /// symbol).
+  /// symbol). The first of the offsets is always zero and is folded.
   ///
   /// \param F The kernel to be processed.
   ///
@@ -45,7 +45,8 @@ enum IRSplitMode {
   SPLIT_PER_TU,     // one module per translation unit
   SPLIT_PER_KERNEL, // one module per kernel
   SPLIT_AUTO,       // automatically select split mode
-  SPLIT_NONE        // no splitting
+  SPLIT_NONE,       // no splitting
+  SPLIT_BY_SIZE     // modules of kernels sharing code, up to a target size
 };
 
 // \returns IRSplitMode value if \p S is recognized. Otherwise, std::nullopt is
@@ -214,6 +215,10 @@ public:
   void setSpecConstantDefault(bool Value);
 
   ModuleDesc clone() const;
+  // Clones the module, only the globals accepted by ShouldCloneDefinition keep
+  // their definitions and the other ones become declarations.
+  ModuleDesc
+  clone(function_ref<bool(const GlobalValue *)> ShouldCloneDefinition) const;
 
   std::string makeSymbolTable() const;
 
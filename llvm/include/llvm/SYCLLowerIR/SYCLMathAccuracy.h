@@ -0,0 +1,43 @@
+//===------- SYCLMathAccuracy.h - Per-kernel math accuracy selection ------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Pass selecting the math functions called by the kernels with the
+// 'sycl-fp-accuracy' attribute, which comes from the fp_accuracy kernel
+// property, and by the functions they call:
+//  - the calls to the __devicelib_* math functions, which only forward to the
+//    SPIR-V builtins, are replaced with calls to these builtins, so that the
+//    kernels don't require the fallback math libraries;
+//  - with the high and medium accuracies, the calls to the SPIR-V math builtins
+//    get !fpmath metadata with the maximum error, which the SPIR-V translator
+//    emits as the FPMaxErrorDecorationINTEL decoration;
+//  - with the native accuracy, the calls to the single precision SPIR-V math
+//    builtins having a native variant are replaced with calls to it.
+// The functions called by kernels with different accuracies are left as they
+// are.
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SYCL_MATH_ACCURACY_H
+#define LLVM_SYCL_MATH_ACCURACY_H
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class Module;
+
+/// Selects the math functions of the module, returns true if it has changed.
+bool selectSYCLMathAccuracy(Module &M);
+
+class SYCLMathAccuracyPass : public PassInfoMixin<SYCLMathAccuracyPass> {
+public:
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &);
+};
+
+} // namespace llvm
+
+#endif // LLVM_SYCL_MATH_ACCURACY_H
@@ -0,0 +1,33 @@
+//===- SYCLStdParAllocInterposition.h - SYCL stdpar allocation interposition =//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Pass replacing the calls to the allocation and deallocation functions of
+// the host code with the equivalents of the SYCL runtime, which allocate USM
+// shared memory, so that the parallel algorithms offloaded to SYCL devices can
+// use the heap memory of the program.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SYCL_STDPAR_ALLOC_INTERPOSITION_H
+#define LLVM_SYCL_STDPAR_ALLOC_INTERPOSITION_H
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+class SYCLStdParAllocInterpositionPass
+    : public PassInfoMixin<SYCLStdParAllocInterpositionPass> {
+public:
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &);
+
+  static bool isRequired() { return true; }
+};
+
+} // namespace llvm
+
+#endif // LLVM_SYCL_STDPAR_ALLOC_INTERPOSITION_H
@@ -16,9 +16,11 @@
 #pragma once
 
 #include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassManager.h"
 
+#include <optional>
 #include <vector>
 
 namespace llvm {
@@ -83,4 +85,10 @@ private:
 
 bool checkModuleContainsSpecConsts(const Module &M);
 
+// Collects the kernels of M which use specialization constants, directly or
+// through the functions they call. Returns std::nullopt if they can't be told
+// apart, i.e. if a function using them is called indirectly.
+std::optional<SmallPtrSet<const Function *, 8>>
+collectKernelsUsingSpecConsts(const Module &M);
+
 } // namespace llvm
@@ -61,9 +61,14 @@ constexpr int BestSizeCompression = 12;
 
 bool isAvailable();
 
+// Compress Input. With NumWorkers, the input is compressed by as many threads
+// of zstd when libzstd supports multithreading, otherwise by the calling
+// thread. The output doesn't depend on the number of workers, as long as
+// there is at least one.
 void compress(ArrayRef<uint8_t> Input,
               SmallVectorImpl<uint8_t> &CompressedBuffer,
-              int Level = DefaultCompression, bool EnableLdm = false);
+              int Level = DefaultCompression, bool EnableLdm = false,
+              unsigned NumWorkers = 0);
 
 Error decompress(ArrayRef<uint8_t> Input, uint8_t *Output,
                  size_t &UncompressedSize);
@@ -71,6 +76,16 @@ Error decompress(ArrayRef<uint8_t> Input, uint8_t *Output,
 Error decompress(ArrayRef<uint8_t> Input, SmallVectorImpl<uint8_t> &Output,
                  size_t UncompressedSize);
 
+// Decompress Input, a sequence of zstd frames such as the shards compressed in
+// parallel by lld. The frames recording their content size are decompressed
+// in parallel with llvm::parallelFor; otherwise this is decompress().
+Error decompressInParallel(ArrayRef<uint8_t> Input, uint8_t *Output,
+                           size_t &UncompressedSize);
+
+Error decompressInParallel(ArrayRef<uint8_t> Input,
+                           SmallVectorImpl<uint8_t> &Output,
+                           size_t UncompressedSize);
+
 } // End of namespace zstd
 
 enum class Format {
@@ -94,16 +109,17 @@ struct Params {
   constexpr Params(Format F)
       : format(F), level(F == Format::Zlib ? zlib::DefaultCompression
                                            : zstd::DefaultCompression) {}
-  constexpr Params(Format F, int L, bool Ldm = false)
-      : format(F), level(L), zstdEnableLdm(Ldm) {}
+  constexpr Params(Format F, int L, bool Ldm = false, unsigned Workers = 0)
+      : format(F), level(L), zstdEnableLdm(Ldm), zstdNumWorkers(Workers) {}
   Params(DebugCompressionType Type) : Params(formatFor(Type)) {}
 
   Format format;
   int level;
   bool zstdEnableLdm = false; // Enable zstd long distance matching
-  // This may support multi-threading for zstd in the future. Note that
-  // different threads may produce different output, so be careful if certain
-  // output determinism is desired.
+  // Number of zstd worker threads, 0 to compress on the calling thread. The
+  // output with workers differs from the single-threaded output, but not
+  // between different numbers of workers.
+  unsigned zstdNumWorkers = 0;
 };
 
 // Return nullptr if LLVM was built with support (LLVM_ENABLE_ZLIB,
@@ -116,7 +132,8 @@ const char *getReasonIfUnsupported(Format F);
 void compress(Params P, ArrayRef<uint8_t> Input,
               SmallVectorImpl<uint8_t> &Output);
 
-// Decompress Input. The uncompressed size must be available.
+// Decompress Input. The uncompressed size must be available. The frames of
+// zstd inputs are decompressed in parallel.
 Error decompress(DebugCompressionType T, ArrayRef<uint8_t> Input,
                  uint8_t *Output, size_t UncompressedSize);
 Error decompress(Format F, ArrayRef<uint8_t> Input,
@@ -0,0 +1,115 @@
+//===- llvm/Support/Jobserver.h - Client of a build jobserver ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file declares a client of the jobserver of GNU make and ninja, which
+// shares the parallel jobs of a build between the processes it runs.
+//
+// A process run by the build holds one implicit job slot. Each additional job
+// it runs in parallel takes a token from the jobserver, and writes it back
+// when done, so that the jobs of all the processes stay within the limit set
+// with -j.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_JOBSERVER_H
+#define LLVM_SUPPORT_JOBSERVER_H
+
+#include "llvm/ADT/StringRef.h"
+
+#include <atomic>
+#include <optional>
+
+namespace llvm {
+
+class JobserverClient;
+
+/// A job slot, either the implicit slot of the process or a token of the
+/// jobserver. The slot is released when it is destroyed.
+class JobSlot {
+public:
+  JobSlot() = default;
+  JobSlot(JobSlot &&Other) : Client(Other.Client), Token(Other.Token) {
+    Other.Client = nullptr;
+  }
+  JobSlot &operator=(JobSlot &&Other) {
+    if (this != &Other) {
+      release();
+      Client = Other.Client;
+      Token = Other.Token;
+      Other.Client = nullptr;
+    }
+    return *this;
+  }
+  JobSlot(const JobSlot &) = delete;
+  JobSlot &operator=(const JobSlot &) = delete;
+  ~JobSlot() { release(); }
+
+  bool isValid() const { return Client != nullptr; }
+  bool isImplicit() const { return isValid() && Token == ImplicitToken; }
+
+  /// Returns the slot to the client.
+  void release();
+
+private:
+  friend class JobserverClient;
+
+  /// The token of the implicit slot, which isn't read from the jobserver.
+  static constexpr int ImplicitToken = -1;
+  /// The token of a slot taken after the jobserver went away.
+  static constexpr int NoToken = -2;
+
+  JobSlot(JobserverClient *Client, int Token) : Client(Client), Token(Token) {}
+
+  JobserverClient *Client = nullptr;
+  int Token = NoToken;
+};
+
+/// Client of the jobserver given to the process in MAKEFLAGS, by
+/// --jobserver-auth=fifo:<path> (GNU make 4.4 and ninja),
+/// --jobserver-auth=<read>,<write> or --jobserver-fds=<read>,<write> for the
+/// descriptors of a pipe, or --jobserver-auth=<name> for a semaphore on
+/// Windows.
+class JobserverClient {
+public:
+  /// Returns the client of the jobserver of the build running the process,
+  /// or nullptr when the process isn't run with a jobserver.
+  static JobserverClient *getInstance();
+
+  /// Takes the implicit slot of the process when it is free, otherwise waits
+  /// for a token of the jobserver. When the jobserver goes away, returns a
+  /// slot without a token rather than waiting forever.
+  JobSlot acquire();
+
+  /// Like acquire(), but returns an invalid slot instead of waiting.
+  JobSlot tryAcquire();
+
+private:
+  friend class JobSlot;
+
+  JobserverClient() = default;
+
+  /// Connects to the jobserver described by \p Auth, the value of the
+  /// --jobserver-auth option.
+  bool connect(StringRef Auth);
+  /// Reads a token, waiting for it if \p Wait is set.
+  std::optional<int> readToken(bool Wait);
+  void writeToken(int Token);
+  void release(int Token);
+
+  std::atomic<bool> ImplicitSlotUsed{false};
+#ifdef _WIN32
+  void *Semaphore = nullptr;
+#else
+  int ReadFD = -1;
+  int WriteFD = -1;
+#endif
+};
+
+} // namespace llvm
+
+#endif // LLVM_SUPPORT_JOBSERVER_H
@@ -83,6 +83,11 @@ public:
     std::unique_lock<std::mutex> lock(Mutex);
     Cond.wait(lock, [&] { return Count == 0; });
   }
+
+  bool isReleased() const {
+    std::lock_guard<std::mutex> lock(Mutex);
+    return Count == 0;
+  }
 };
 } // namespace detail
 
@@ -101,7 +106,9 @@ public:
   // threads, but strictly in sequential order.
   void spawn(std::function<void()> f, bool Sequential = false);
 
-  void sync() const { L.sync(); }
+  // Waits for the spawned tasks to finish. On a worker thread of the default
+  // executor, the other queued tasks are run while waiting.
+  void sync() const;
 
   bool isParallel() const { return Parallel; }
 };
@@ -129,6 +129,11 @@ constexpr bool llvm_is_multithreaded() { return LLVM_ENABLE_THREADS; }
     // threads, or hardware cores.
     bool Limit = false;
 
+    // If set, and the process is run by a build with a jobserver, each thread
+    // of the pool holds a job slot of the jobserver while it runs tasks, so
+    // that the pool stays within the parallel jobs of the build.
+    bool UseJobserver = false;
+
     /// Retrieves the max available threads for the current strategy. This
     /// accounts for affinity masks and takes advantage of all CPU sockets.
     unsigned compute_thread_count() const;
@@ -149,6 +154,8 @@ constexpr bool llvm_is_multithreaded() { return LLVM_ENABLE_THREADS; }
   /// strategy, we attempt to equally allocate the threads on all CPU sockets.
   /// "0" or an empty string will return the \p Default strategy.
   /// "all" for using all hardware threads.
+  /// "jobserver" for using all hardware threads, limited by the jobserver of
+  /// the build.
   std::optional<ThreadPoolStrategy>
   get_threadpool_strategy(StringRef Num, ThreadPoolStrategy Default = {});
 
@@ -188,6 +195,15 @@ constexpr bool llvm_is_multithreaded() { return LLVM_ENABLE_THREADS; }
     return S;
   }
 
+  /// Returns a thread strategy using all hardware threads, where the threads
+  /// only run tasks while they hold a job slot of the jobserver of the build,
+  /// if the process is run with one.
+  inline ThreadPoolStrategy jobserver_concurrency() {
+    ThreadPoolStrategy S;
+    S.UseJobserver = true;
+    return S;
+  }
+
   /// Returns an optimal thread strategy to execute specified amount of tasks.
   /// This strategy should prevent us from creating too many threads if we
   /// occasionaly have an unexpectedly small amount of tasks.
@@ -97,14 +97,24 @@ TimeTraceProfiler *getTimeTraceProfilerInstance();
 
 bool isTimeTraceVerbose();
 
+/// Is the time trace profiler of the thread in summary mode?
+bool isTimeTraceSummary();
+
 struct TimeTraceProfilerEntry;
 
 /// Initialize the time trace profiler.
 /// This sets up the global \p TimeTraceProfilerInstance
 /// variable to be the profiler instance.
+///
+/// With \p TimeTraceSummary, the profiler only records the count and the
+/// total duration of the sections of each name, in a fixed-size table, which
+/// is cheap enough to leave on for every compilation. The details of the
+/// sections are never computed, the granularity and the async sections are
+/// ignored, and the output only has the "Total" events.
 void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
                                  StringRef ProcName,
-                                 bool TimeTraceVerbose = false);
+                                 bool TimeTraceVerbose = false,
+                                 bool TimeTraceSummary = false);
 
 /// Cleanup the time trace profiler, if it was initialized.
 void timeTraceProfilerCleanup();
@@ -33,6 +33,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/PropertySetIO.h"
 #include "llvm/Transforms/Utils/ModuleUtils.h"
 #include <memory>
@@ -78,6 +79,9 @@ struct Wrapper {
   StructType *SyclDeviceImageTy = nullptr;
   StructType *SyclBinDescTy = nullptr;
 
+  /// Alignment of the device images, the page size.
+  static constexpr uint64_t DeviceImageAlignment = 4096;
+
   Wrapper(Module &M, const SYCLWrappingOptions &Options)
       : M(M), C(M.getContext()), Options(Options) {
 
@@ -330,9 +334,29 @@ struct Wrapper {
   std::pair<Constant *, Constant *>
   addDeviceImageToModule(ArrayRef<char> Buf, const Twine &Name,
                          StringRef TargetTriple) {
-    // Create global variable for the image data.
-    return addArrayToModule(Buf, Name,
-                            TargetTriple.empty() ? "" : TargetTriple);
+    // Create global variable for the image data. The images are page aligned
+    // and padded to a whole number of pages, so that each image has pages of
+    // its own in the executable. The runtime can then page them in, release
+    // them or map them from the file independently of the data around them.
+    // The images have no relocations.
+    Constant *Data = ConstantDataArray::get(C, Buf);
+    uint64_t Padding = alignTo(Buf.size(), DeviceImageAlignment) - Buf.size();
+    if (Padding)
+      Data = ConstantStruct::getAnon(
+          {Data, ConstantAggregateZero::get(
+                     ArrayType::get(Type::getInt8Ty(C), Padding))},
+          /*Packed=*/true);
+    auto *Var = new GlobalVariable(M, Data->getType(), /*isConstant*/ true,
+                                   GlobalVariable::InternalLinkage, Data, Name);
+    Var->setUnnamedAddr(GlobalValue::UnnamedAddr::Global);
+    Var->setAlignment(Align(DeviceImageAlignment));
+    if (!TargetTriple.empty())
+      Var->setSection(TargetTriple);
+    auto *ImageB = ConstantExpr::getGetElementPtr(
+        Type::getInt8Ty(C), Var, ConstantInt::get(getSizeTTy(), 0));
+    auto *ImageE = ConstantExpr::getGetElementPtr(
+        Type::getInt8Ty(C), Var, ConstantInt::get(getSizeTTy(), Buf.size()));
+    return std::make_pair(ImageB, ImageE);
   }
 
   /// Creates a global variable of const char* type and creates an
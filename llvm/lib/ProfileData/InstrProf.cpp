@@ -439,7 +439,9 @@ std::string getPGOFuncNameVarName(StringRef FuncName,
 
 bool isGPUProfTarget(const Module &M) {
   const auto &T = Triple(M.getTargetTriple());
-  return T.isAMDGPU() || T.isNVPTX();
+  // The counters of SPIR-V device code are read by the SYCL runtime by name,
+  // like those of AMDGPU and NVPTX code by the offload plugins.
+  return T.isAMDGPU() || T.isNVPTX() || T.isSPIROrSPIRV();
 }
 
 void setPGOFuncVisibility(Module &M, GlobalVariable *FuncNameVar) {
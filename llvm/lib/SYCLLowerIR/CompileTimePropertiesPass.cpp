@@ -15,6 +15,7 @@
 #include "llvm/SYCLLowerIR/TargetHelpers.h"
 
 #include "llvm/ADT/APInt.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/InstIterator.h"
@@ -31,6 +32,7 @@ constexpr StringRef SYCL_HOST_ACCESS_ATTR = "sycl-host-access";
 constexpr StringRef SYCL_PIPELINED_ATTR = "sycl-pipelined";
 constexpr StringRef SYCL_REGISTER_ALLOC_MODE_ATTR = "sycl-register-alloc-mode";
 constexpr StringRef SYCL_GRF_SIZE_ATTR = "sycl-grf-size";
+constexpr StringRef SYCL_WAVES_PER_EU_ATTR = "sycl-waves-per-eu";
 
 constexpr StringRef SPIRV_DECOR_MD_KIND = "spirv.Decorations";
 constexpr StringRef SPIRV_PARAM_DECOR_MD_KIND = "spirv.ParameterDecorations";
@@ -565,6 +567,61 @@ void getUserListIgnoringCast(
   }
 }
 
+// Returns the number of work-items of the work-group sizes in the metadata
+// \p MDName of \p F, if any.
+std::optional<uint64_t> getWorkGroupMetadataSize(const Function &F,
+                                                 StringRef MDName) {
+  const MDNode *Node = F.getMetadata(MDName);
+  if (!Node)
+    return std::nullopt;
+  uint64_t Size = 1;
+  for (const MDOperand &Op : Node->operands()) {
+    auto *C = mdconst::dyn_extract<ConstantInt>(Op);
+    if (!C)
+      return std::nullopt;
+    Size *= C->getZExtValue();
+  }
+  return Size;
+}
+
+/// AMDGPU has no metadata for the work-group sizes and the occupancy of
+/// kernels, the backend reads them from function attributes. Without them,
+/// it assumes work-groups of up to 1024 work-items and gives the work-items
+/// as many registers as they need, which lowers the occupancy.
+///
+/// @param F     [in] the kernel, with its work-group metadata.
+void addAMDGPUOccupancyAttributes(Function &F) {
+  constexpr StringRef AMDGPUWavesPerEUAttr = "amdgpu-waves-per-eu";
+  constexpr StringRef AMDGPUFlatWGSizeAttr = "amdgpu-flat-work-group-size";
+  // The largest work-group size of AMDGPU.
+  constexpr uint64_t AMDGPUMaxWGSize = 1024;
+
+  if (F.hasFnAttribute(SYCL_WAVES_PER_EU_ATTR) &&
+      !F.hasFnAttribute(AMDGPUWavesPerEUAttr)) {
+    // The property value is "Min,Max", a maximum of 0 being unbounded.
+    auto [Min, Max] =
+        F.getFnAttribute(SYCL_WAVES_PER_EU_ATTR).getValueAsString().split(',');
+    bool Unbounded = Max.empty() || Max == "0";
+    F.addFnAttr(AMDGPUWavesPerEUAttr,
+                Unbounded ? Min.str() : (Min + "," + Max).str());
+  }
+
+  if (F.hasFnAttribute(AMDGPUFlatWGSizeAttr))
+    return;
+  if (auto Reqd = getWorkGroupMetadataSize(F, "reqd_work_group_size")) {
+    if (*Reqd <= AMDGPUMaxWGSize)
+      F.addFnAttr(AMDGPUFlatWGSizeAttr, utostr(*Reqd) + "," + utostr(*Reqd));
+    return;
+  }
+  std::optional<uint64_t> Max =
+      getWorkGroupMetadataSize(F, "max_work_group_size");
+  if (auto MaxLinear =
+          getWorkGroupMetadataSize(F, "max_linear_work_group_size"))
+    Max = Max ? std::min(*Max, *MaxLinear) : *MaxLinear;
+  if (Max && *Max <= AMDGPUMaxWGSize)
+    F.addFnAttr(AMDGPUFlatWGSizeAttr, "1," + utostr(*Max));
+}
+
 } // anonymous namespace
 
 PreservedAnalyses CompileTimePropertiesPass::run(Module &M,
@@ -619,6 +676,7 @@ PreservedAnalyses CompileTimePropertiesPass::run(Module &M,
   // Process all properties on kernels.
   TargetHelpers::KernelCache HIPCUDAKCache;
   HIPCUDAKCache.populateKernels(M);
+  const bool IsAMDGCN = Triple(M.getTargetTriple()).isAMDGCN();
 
   for (Function &F : M) {
     // Only consider kernels.
@@ -710,6 +768,9 @@ PreservedAnalyses CompileTimePropertiesPass::run(Module &M,
         continue;
       F.addMetadata(NamedMD.first, *NamedMD.second);
     }
+
+    if (IsAMDGCN)
+      addAMDGPUOccupancyAttributes(F);
   }
 
   // Check pointer annotations.
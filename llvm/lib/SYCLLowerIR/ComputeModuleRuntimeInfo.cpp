@@ -13,6 +13,7 @@
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/IR/PassInstrumentation.h"
+#include "llvm/ProfileData/InstrProf.h"
 #include "llvm/SYCLLowerIR/CompileTimePropertiesPass.h"
 #include "llvm/SYCLLowerIR/DeviceGlobals.h"
 #include "llvm/SYCLLowerIR/HostPipes.h"
@@ -21,6 +22,7 @@
 #include "llvm/SYCLLowerIR/SYCLKernelParamOptInfo.h"
 #include "llvm/SYCLLowerIR/SYCLUtils.h"
 #include "llvm/SYCLLowerIR/SpecConstants.h"
+#include <cstring>
 #include <queue>
 #include <unordered_set>
 #ifndef NDEBUG
@@ -43,6 +45,63 @@ getSYCLESIMDSplitStatusFromMetadata(const Module &M) {
   auto AsEnum = static_cast<module_split::SyclEsimdSplitStatus>(Val);
   return AsEnum;
 }
+
+// Describes the counters of the functions instrumented with
+// -fprofile-instr-generate, which the SYCL runtime reads back by name:
+// "counters variable name" -> the hash of the function (8 bytes), the number
+// of counters (4 bytes), the size of the PGO name of the function (4 bytes)
+// and the name.
+MapVector<StringRef, std::vector<char>>
+collectProfileCounters(const Module &M) {
+  MapVector<StringRef, std::vector<char>> Counters;
+  const GlobalVariable *NamesVar =
+      M.getGlobalVariable(getInstrProfNamesVarName());
+  if (!NamesVar || !NamesVar->hasInitializer())
+    return Counters;
+  const auto *Names = dyn_cast<ConstantDataArray>(NamesVar->getInitializer());
+  if (!Names)
+    return Counters;
+  InstrProfSymtab Symtab;
+  if (Error E = Symtab.create(Names->getRawDataValues())) {
+    consumeError(std::move(E));
+    return Counters;
+  }
+
+  for (const GlobalVariable &GV : M.globals()) {
+    StringRef Suffix = GV.getName();
+    if (!Suffix.consume_front(getInstrProfDataVarPrefix()) ||
+        !GV.hasInitializer())
+      continue;
+    const GlobalVariable *CountersVar = M.getGlobalVariable(
+        (getInstrProfCountersVarPrefix() + Suffix).str());
+    const auto *Data = dyn_cast<ConstantStruct>(GV.getInitializer());
+    if (!CountersVar || !Data)
+      continue;
+    const auto *CountersTy = dyn_cast<ArrayType>(CountersVar->getValueType());
+    const auto *NameRef = dyn_cast<ConstantInt>(Data->getOperand(0));
+    const auto *FuncHash = dyn_cast<ConstantInt>(Data->getOperand(1));
+    // The single byte counters of coverage aren't profile counts.
+    if (!CountersTy || !CountersTy->getElementType()->isIntegerTy(64) ||
+        !NameRef || !FuncHash)
+      continue;
+    StringRef FuncName = Symtab.getFuncOrVarName(NameRef->getZExtValue());
+    if (FuncName.empty())
+      continue;
+
+    uint64_t Hash = FuncHash->getZExtValue();
+    uint32_t NumCounters = CountersTy->getNumElements();
+    uint32_t NameSize = FuncName.size();
+    std::vector<char> &Value = Counters[CountersVar->getName()];
+    Value.resize(sizeof(Hash) + sizeof(NumCounters) + sizeof(NameSize));
+    std::memcpy(Value.data(), &Hash, sizeof(Hash));
+    std::memcpy(Value.data() + sizeof(Hash), &NumCounters,
+                sizeof(NumCounters));
+    std::memcpy(Value.data() + sizeof(Hash) + sizeof(NumCounters), &NameSize,
+                sizeof(NameSize));
+    Value.insert(Value.end(), FuncName.begin(), FuncName.end());
+  }
+  return Counters;
+}
 } // namespace
 
 bool isModuleUsingAsan(const Module &M) {
@@ -327,6 +386,10 @@ PropSetRegTy computeModuleProperties(const Module &M,
 
   if (SplitType == module_split::SyclEsimdSplitStatus::ESIMD_ONLY)
     PropSet.add(PropSetRegTy::SYCL_MISC_PROP, "isEsimdImage", true);
+  if (llvm::any_of(EntryPoints, [](const Function *F) {
+        return F->hasFnAttribute(llvm::sycl::utils::ATTR_SYCL_HOT_KERNEL);
+      }))
+    PropSet.add(PropSetRegTy::SYCL_MISC_PROP, "hotKernels", true);
   {
     StringRef RegAllocModeAttr = "sycl-register-alloc-mode";
     uint32_t RegAllocModeVal;
@@ -414,6 +477,10 @@ PropSetRegTy computeModuleProperties(const Module &M,
   if (!HostPipePropertyMap.empty()) {
     PropSet.add(PropSetRegTy::SYCL_HOST_PIPES, HostPipePropertyMap);
   }
+
+  auto ProfileCounters = collectProfileCounters(M);
+  if (!ProfileCounters.empty())
+    PropSet.add(PropSetRegTy::SYCL_PROFILE_COUNTERS, ProfileCounters);
   bool IsSpecConstantDefault =
       M.getNamedMetadata(
           SpecConstantsPass::SPEC_CONST_DEFAULT_VAL_MODULE_MD_STRING) !=
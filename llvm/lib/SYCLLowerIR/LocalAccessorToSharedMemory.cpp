@@ -161,11 +161,19 @@ Function *LocalAccessorToSharedMemoryPass::processKernel(Module &M,
   NF->splice(NF->begin(), F);
 
   unsigned i = 0;
+  bool FirstReplaced = true;
   for (Function::arg_iterator FA = F->arg_begin(), FE = F->arg_end(),
                               NFA = NF->arg_begin();
        FA != FE; ++FA, ++NFA, ++i) {
     Value *NewValueForUse = NFA;
     if (ArgumentReplaced[i]) {
+      // The local arguments are laid out in the order of their indices,
+      // starting at the base of the symbol, so the offset of the first one
+      // is known to be zero. The argument is kept, the runtime still sets it.
+      Value *Offset = NFA;
+      if (FirstReplaced)
+        Offset = ConstantInt::get(Type::getInt32Ty(M.getContext()), 0, false);
+      FirstReplaced = false;
       // If this argument was replaced, then create a `getelementptr`
       // instruction that uses it to recreate the pointer that was replaced.
       auto *InsertBefore = &NF->getEntryBlock().front();
@@ -175,7 +183,7 @@ Function *LocalAccessorToSharedMemoryPass::processKernel(Module &M,
           /* IdxList= */
           ArrayRef<Value *>{
               ConstantInt::get(Type::getInt32Ty(M.getContext()), 0, false),
-              NFA,
+              Offset,
           },
           /* NameStr= */ Twine{NFA->getName()}, InsertBefore);
       // Then create a bitcast to make sure the new pointer is the same type
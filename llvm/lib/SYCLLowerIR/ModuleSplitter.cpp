@@ -25,6 +25,7 @@
 #include "llvm/IRPrinter/IRPrintingPasses.h"
 #include "llvm/SYCLLowerIR/DeviceGlobals.h"
 #include "llvm/SYCLLowerIR/LowerInvokeSimd.h"
+#include "llvm/SYCLLowerIR/SYCLMathAccuracy.h"
 #include "llvm/SYCLLowerIR/SYCLUtils.h"
 #include "llvm/SYCLLowerIR/SpecConstants.h"
 #include "llvm/Support/CommandLine.h"
@@ -51,6 +52,7 @@ namespace {
 constexpr char GLOBAL_SCOPE_NAME[] = "<GLOBAL>";
 constexpr char SYCL_SCOPE_NAME[] = "<SYCL>";
 constexpr char ESIMD_SCOPE_NAME[] = "<ESIMD>";
+constexpr char HOT_SCOPE_NAME[] = "<HOT>";
 constexpr char ESIMD_MARKER_MD[] = "sycl_explicit_simd";
 
 cl::opt<bool> AllowDeviceImageDependencies{
@@ -58,11 +60,19 @@ cl::opt<bool> AllowDeviceImageDependencies{
     cl::desc("Allow dependencies between device images"),
     cl::cat(getModuleSplitCategory()), cl::init(false)};
 
+cl::opt<unsigned> SplitTargetSize{
+    "split-target-size",
+    cl::desc("Target number of instructions of the modules produced by "
+             "-split=size. Smaller modules take less time to JIT, larger ones "
+             "duplicate less shared code and need fewer programs to be built"),
+    cl::cat(getModuleSplitCategory()), cl::init(20000)};
+
 EntryPointsGroupScope selectDeviceCodeGroupScope(const Module &M,
                                                  IRSplitMode Mode,
                                                  bool AutoSplitIsGlobalScope) {
   switch (Mode) {
   case SPLIT_PER_TU:
+  case SPLIT_BY_SIZE:
     return Scope_PerModule;
 
   case SPLIT_PER_KERNEL:
@@ -450,7 +460,8 @@ std::optional<IRSplitMode> convertStringToSplitMode(StringRef S) {
   static const StringMap<IRSplitMode> Values = {{"kernel", SPLIT_PER_KERNEL},
                                                 {"source", SPLIT_PER_TU},
                                                 {"auto", SPLIT_AUTO},
-                                                {"none", SPLIT_NONE}};
+                                                {"none", SPLIT_NONE},
+                                                {"size", SPLIT_BY_SIZE}};
 
   auto It = Values.find(S);
   if (It == Values.end())
@@ -751,7 +762,14 @@ void ModuleDesc::setSpecConstantDefault(bool Value) {
 }
 
 ModuleDesc ModuleDesc::clone() const {
-  std::unique_ptr<Module> NewModule = CloneModule(getModule());
+  return clone([](const GlobalValue *) { return true; });
+}
+
+ModuleDesc ModuleDesc::clone(
+    function_ref<bool(const GlobalValue *)> ShouldCloneDefinition) const {
+  ValueToValueMapTy VMap;
+  std::unique_ptr<Module> NewModule =
+      CloneModule(getModule(), VMap, ShouldCloneDefinition);
   ModuleDesc NewMD(std::move(NewModule));
   NewMD.EntryPoints.Props = EntryPoints.Props;
   return NewMD;
@@ -1097,6 +1115,69 @@ std::string FunctionsCategorizer::computeCategoryFor(Function *F) const {
 
   return (std::string)Result;
 }
+
+// Partitions the entry points of a category for the size-based split. Each
+// entry point, in order, joins the partition with which it shares the most
+// instructions, among the partitions that stay within the target size once
+// the functions it reaches are added, preferring the smallest one on a tie.
+// It starts a new partition when none of them fits. The functions reached by
+// several partitions are duplicated into each of their modules.
+std::vector<EntryPointSet> partitionBySize(const EntryPointSet &EntryPoints,
+                                           const Module &M,
+                                           const DependencyGraph &CG) {
+  struct Partition {
+    EntryPointSet EntryPoints;
+    SmallPtrSet<const Function *, 32> Functions;
+    size_t Size = 0;
+  };
+  std::vector<Partition> Partitions;
+  DenseMap<const Function *, size_t> FunctionSizes;
+  auto getSize = [&](const Function *F) {
+    auto [It, Inserted] = FunctionSizes.try_emplace(F, 0);
+    if (Inserted)
+      It->second = F->getInstructionCount();
+    return It->second;
+  };
+
+  for (Function *EP : EntryPoints) {
+    EntryPointGroup Group{EP->getName(), EntryPointSet{}};
+    Group.Functions.insert(EP);
+    SetVector<const GlobalValue *> GVs;
+    collectFunctionsAndGlobalVariablesToExtract(GVs, M, Group, CG);
+    SmallVector<const Function *, 32> Reached;
+    for (const GlobalValue *GV : GVs)
+      if (const auto *F = dyn_cast<Function>(GV); F && !F->isDeclaration())
+        Reached.push_back(F);
+
+    Partition *Best = nullptr;
+    size_t BestShared = 0;
+    for (Partition &P : Partitions) {
+      size_t Shared = 0, Merged = P.Size;
+      for (const Function *F : Reached)
+        (P.Functions.contains(F) ? Shared : Merged) += getSize(F);
+      if (Merged > SplitTargetSize)
+        continue;
+      if (!Best || Shared > BestShared ||
+          (Shared == BestShared && P.Size < Best->Size)) {
+        Best = &P;
+        BestShared = Shared;
+      }
+    }
+    if (!Best)
+      Best = &Partitions.emplace_back();
+
+    Best->EntryPoints.insert(EP);
+    for (const Function *F : Reached)
+      if (Best->Functions.insert(F).second)
+        Best->Size += getSize(F);
+  }
+
+  std::vector<EntryPointSet> Result;
+  Result.reserve(Partitions.size());
+  for (Partition &P : Partitions)
+    Result.push_back(std::move(P.EntryPoints));
+  return Result;
+}
 } // namespace
 
 std::unique_ptr<ModuleSplitterBase>
@@ -1123,9 +1204,22 @@ getDeviceCodeSplitter(ModuleDesc &&MD, IRSplitMode Mode, bool IROutputOnly,
     // The most complex case, because we should account for many other features
     // like aspects used in a kernel, large-grf mode, reqd-work-group-size, etc.
 
-    // This is core of per-source device code split
-    Categorizer.registerSimpleStringAttributeRule(
-        sycl::utils::ATTR_SYCL_MODULE_ID);
+    // This is core of per-source device code split. Size-based split groups
+    // kernels regardless of their translation unit, but still has to keep
+    // apart the ones using different optional features. The kernels marked as
+    // hot by a kernel profile are grouped together regardless of their
+    // translation unit, so that the kernels which are used end up in a few
+    // primary device images.
+    Categorizer.registerRule([Mode](Function *F) -> std::string {
+      if (F->hasFnAttribute(sycl::utils::ATTR_SYCL_HOT_KERNEL))
+        return HOT_SCOPE_NAME;
+      if (Mode == SPLIT_BY_SIZE ||
+          !F->hasFnAttribute(sycl::utils::ATTR_SYCL_MODULE_ID))
+        return "";
+      return F->getFnAttribute(sycl::utils::ATTR_SYCL_MODULE_ID)
+          .getValueAsString()
+          .str();
+    });
 
     // This attribute marks virtual functions and effectively dictates how they
     // should be groupped together. By design we won't split those groups of
@@ -1152,6 +1246,7 @@ getDeviceCodeSplitter(ModuleDesc &&MD, IRSplitMode Mode, bool IROutputOnly,
         sycl::utils::ATTR_SYCL_OPTLEVEL);
     Categorizer.registerSimpleStringMetadataRule("sycl_joint_matrix");
     Categorizer.registerSimpleStringMetadataRule("sycl_joint_matrix_mad");
+    Categorizer.registerSimpleStringAttributeRule("sycl-fp-accuracy");
     break;
   }
 
@@ -1175,6 +1270,8 @@ getDeviceCodeSplitter(ModuleDesc &&MD, IRSplitMode Mode, bool IROutputOnly,
     Groups.emplace_back(GLOBAL_SCOPE_NAME, EntryPointSet{});
   } else {
     Groups.reserve(EntryPointsMap.size());
+    // Only needed by the size-based split.
+    std::unique_ptr<DependencyGraph> CG;
     // Start with properties of a source module
     EntryPointGroup::Properties MDProps = MD.getEntryPointGroup().Props;
     for (auto &[Key, EntryPoints] : EntryPointsMap) {
@@ -1188,7 +1285,19 @@ getDeviceCodeSplitter(ModuleDesc &&MD, IRSplitMode Mode, bool IROutputOnly,
 
       auto PropsCopy = MDProps;
       PropsCopy.HasVirtualFunctionDefinitions = HasVirtualFunctions;
-      Groups.emplace_back(Key, std::move(EntryPoints), PropsCopy);
+      // Groups of virtual functions must stay together.
+      if (Mode != SPLIT_BY_SIZE || HasVirtualFunctions) {
+        Groups.emplace_back(Key, std::move(EntryPoints), PropsCopy);
+        continue;
+      }
+
+      if (!CG)
+        CG = std::make_unique<DependencyGraph>(MD.getModule());
+      std::vector<EntryPointSet> Partitions =
+          partitionBySize(EntryPoints, MD.getModule(), *CG);
+      for (size_t I = 0; I < Partitions.size(); ++I)
+        Groups.emplace_back(Key + std::to_string(I), std::move(Partitions[I]),
+                            PropsCopy);
     }
   }
 
@@ -1387,6 +1496,8 @@ splitSYCLModule(std::unique_ptr<Module> M, ModuleSplitterSettings Settings) {
   while (Splitter->hasMoreSplits()) {
     ModuleDesc MD2 = Splitter->nextSplit();
     MD2.fixupLinkageOfDirectInvokeSimdTargets();
+    // The kernels of a split module have the same fp_accuracy property.
+    selectSYCLMathAccuracy(MD2.getModule());
 
     std::string OutIRFileName = (Settings.OutputPrefix + "_" + Twine(ID)).str();
     auto SplittedImageOrErr =
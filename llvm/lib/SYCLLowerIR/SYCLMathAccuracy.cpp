@@ -0,0 +1,218 @@
+//===------ SYCLMathAccuracy.cpp - Per-kernel math accuracy selection -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// See comments in the header.
+//===----------------------------------------------------------------------===//
+
+#include "llvm/SYCLLowerIR/SYCLMathAccuracy.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/TargetParser/Triple.h"
+
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+constexpr StringRef ATTR_SYCL_FP_ACCURACY = "sycl-fp-accuracy";
+constexpr StringRef DEVICELIB_FUNC_PREFIX = "__devicelib_";
+constexpr StringRef SPIRV_OCL_PREFIX = "__spirv_ocl_";
+
+// Values of the 'sycl-fp-accuracy' attribute, must be in sync with
+// fp_accuracy_mode in sycl/ext/intel/experimental/fp_accuracy_properties.hpp.
+enum FPAccuracy : unsigned {
+  FPA_Default = 0,
+  FPA_High = 1,
+  FPA_Medium = 2,
+  FPA_Native = 3,
+  // Called by kernels with different accuracies.
+  FPA_Conflict = ~0u,
+};
+
+// The SPIR-V math builtins with an accuracy defined by the implementation.
+// The __devicelib_ functions of the same name, with an 'f' suffix for single
+// precision, only forward to them.
+const StringSet<> MathBuiltins = {
+    "acos", "acosh", "asin", "asinh", "atan", "atan2", "atanh",
+    "cbrt", "cos", "cosh", "cospi", "erf", "erfc", "exp",
+    "exp10", "exp2", "expm1", "hypot", "lgamma", "log", "log10",
+    "log1p", "log2", "pow", "powr", "rsqrt", "sin", "sinh",
+    "sinpi", "sqrt", "tan", "tanh", "tgamma"};
+
+// The math builtins having a native variant.
+const StringSet<> NativeBuiltins = {
+    "cos", "exp", "exp10", "exp2", "log", "log10",
+    "log2", "powr", "rsqrt", "sin", "sqrt", "tan"};
+
+unsigned getKernelAccuracy(const Function &F) {
+  if (!F.hasFnAttribute(ATTR_SYCL_FP_ACCURACY))
+    return FPA_Default;
+  unsigned Accuracy = FPA_Default;
+  if (F.getFnAttribute(ATTR_SYCL_FP_ACCURACY)
+          .getValueAsString()
+          .getAsInteger(10, Accuracy) ||
+      Accuracy > FPA_Native)
+    return FPA_Default;
+  return Accuracy;
+}
+
+// Computes the accuracy of the kernels and of the functions they call.
+DenseMap<Function *, unsigned> computeAccuracies(Module &M) {
+  DenseMap<Function *, unsigned> Accuracies;
+  for (Function &K : M) {
+    if (K.getCallingConv() != CallingConv::SPIR_KERNEL || K.isDeclaration())
+      continue;
+    unsigned Accuracy = getKernelAccuracy(K);
+    SmallPtrSet<Function *, 32> Visited;
+    SmallVector<Function *, 32> Worklist{&K};
+    while (!Worklist.empty()) {
+      Function *F = Worklist.pop_back_val();
+      if (!Visited.insert(F).second)
+        continue;
+      auto [It, Inserted] = Accuracies.try_emplace(F, Accuracy);
+      if (!Inserted && It->second != Accuracy)
+        It->second = FPA_Conflict;
+      for (Instruction &I : instructions(F))
+        if (auto *CI = dyn_cast<CallInst>(&I))
+          if (Function *Callee = CI->getCalledFunction();
+              Callee && !Callee->isDeclaration())
+            Worklist.push_back(Callee);
+    }
+  }
+  return Accuracies;
+}
+
+// Gets the name, without prefix, and the mangled parameter types of the SPIR-V
+// math builtin F is or forwards to. Returns false if there is none.
+bool getMathBuiltin(const Function &F, StringRef &Builtin,
+                    std::string &Params) {
+  StringRef Name = F.getName();
+  if (Name.consume_front(DEVICELIB_FUNC_PREFIX)) {
+    if (!F.getReturnType()->isFloatingPointTy())
+      return false;
+    bool IsSingle = F.getReturnType()->isFloatTy();
+    for (Type *ParamTy : F.getFunctionType()->params()) {
+      if (ParamTy != F.getReturnType())
+        return false;
+      Params += IsSingle ? 'f' : 'd';
+    }
+    if (IsSingle && !Name.consume_back("f"))
+      return false;
+    Builtin = Name;
+    return MathBuiltins.contains(Builtin);
+  }
+
+  // Itanium mangled name of a function in the global namespace.
+  unsigned Len = 0;
+  if (!F.isDeclaration() || !Name.consume_front("_Z") ||
+      Name.consumeInteger(10, Len) || Len > Name.size())
+    return false;
+  Builtin = Name.take_front(Len);
+  Params = Name.drop_front(Len).str();
+  return Builtin.consume_front(SPIRV_OCL_PREFIX) &&
+         MathBuiltins.contains(Builtin);
+}
+
+Function *getOrCreateBuiltin(Module &M, const Twine &Builtin,
+                             StringRef Params, FunctionType *FTy) {
+  std::string Name = (SPIRV_OCL_PREFIX + Builtin).str();
+  Name = ("_Z" + Twine(Name.size()) + Name + Params).str();
+  if (Function *F = M.getFunction(Name))
+    return F->getFunctionType() == FTy ? F : nullptr;
+  Function *F = Function::Create(FTy, GlobalValue::ExternalLinkage, Name, M);
+  F->setCallingConv(CallingConv::SPIR_FUNC);
+  F->setDoesNotAccessMemory();
+  F->setDoesNotThrow();
+  F->setWillReturn();
+  return F;
+}
+
+bool selectMathBuiltins(Function &F, unsigned Accuracy,
+                        SmallPtrSetImpl<Function *> &Replaced) {
+  Module &M = *F.getParent();
+  MDNode *FPMath = nullptr;
+  if (Accuracy != FPA_Native)
+    FPMath = MDBuilder(F.getContext())
+                 .createFPMath(Accuracy == FPA_High ? 1.0f : 4.0f);
+
+  bool Changed = false;
+  for (Instruction &I : instructions(F)) {
+    auto *CI = dyn_cast<CallInst>(&I);
+    Function *Callee = CI ? CI->getCalledFunction() : nullptr;
+    StringRef Builtin;
+    std::string Params;
+    if (!Callee || !getMathBuiltin(*Callee, Builtin, Params))
+      continue;
+
+    bool UseNative = Accuracy == FPA_Native &&
+                     CI->getType()->getScalarType()->isFloatTy() &&
+                     NativeBuiltins.contains(Builtin);
+    Function *NewCallee = Callee;
+    if (UseNative)
+      NewCallee = getOrCreateBuiltin(M, "native_" + Builtin, Params,
+                                     Callee->getFunctionType());
+    else if (Callee->getName().starts_with(DEVICELIB_FUNC_PREFIX))
+      NewCallee =
+          getOrCreateBuiltin(M, Builtin, Params, Callee->getFunctionType());
+    if (!NewCallee)
+      continue;
+
+    if (NewCallee != Callee) {
+      CI->setCalledFunction(NewCallee);
+      CI->setCallingConv(CallingConv::SPIR_FUNC);
+      Replaced.insert(Callee);
+      Changed = true;
+    }
+    if (FPMath) {
+      CI->setMetadata(LLVMContext::MD_fpmath, FPMath);
+      Changed = true;
+    }
+  }
+  return Changed;
+}
+
+} // namespace
+
+bool llvm::selectSYCLMathAccuracy(Module &M) {
+  if (!Triple(M.getTargetTriple()).isSPIROrSPIRV() ||
+      none_of(M, [](const Function &F) {
+        return F.hasFnAttribute(ATTR_SYCL_FP_ACCURACY);
+      }))
+    return false;
+
+  bool Changed = false;
+  SmallPtrSet<Function *, 16> Replaced;
+  DenseMap<Function *, unsigned> Accuracies = computeAccuracies(M);
+  for (Function &F : M) {
+    unsigned Accuracy = Accuracies.lookup(&F);
+    if (Accuracy != FPA_Default && Accuracy != FPA_Conflict)
+      Changed |= selectMathBuiltins(F, Accuracy, Replaced);
+  }
+
+  // The declarations of the __devicelib_ functions which are no longer called
+  // would make the kernels require the fallback libraries.
+  for (Function *F : Replaced)
+    if (F->isDeclaration() && F->use_empty())
+      F->eraseFromParent();
+  return Changed;
+}
+
+PreservedAnalyses SYCLMathAccuracyPass::run(Module &M,
+                                            ModuleAnalysisManager &) {
+  return selectSYCLMathAccuracy(M) ? PreservedAnalyses::none()
+                                   : PreservedAnalyses::all();
+}
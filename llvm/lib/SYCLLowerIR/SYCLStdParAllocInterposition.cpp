@@ -0,0 +1,90 @@
+//===- SYCLStdParAllocInterposition.cpp - SYCL stdpar alloc interposition -===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The devices without on-demand paging of the system memory only access the
+// memory allocated with USM. As the allocation interposition of HIP stdpar,
+// the pass replaces the known allocation and deallocation functions called by
+// the host code with the __syclstdpar_* functions of the SYCL runtime, which
+// allocate USM shared memory, so that the standard parallel algorithms run on
+// SYCL devices can use the heap memory of the program. The memory allocated by
+// the code compiled without the interposition, e.g. in other libraries, can
+// still be freed or reallocated by the runtime functions.
+//
+// The device code, which allocates nothing from the heap, is left unchanged.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/SYCLLowerIR/SYCLStdParAllocInterposition.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/Module.h"
+
+using namespace llvm;
+
+static constexpr std::pair<StringLiteral, StringLiteral> ReplaceMap[]{
+    {"aligned_alloc", "__syclstdpar_aligned_alloc"},
+    {"calloc", "__syclstdpar_calloc"},
+    {"free", "__syclstdpar_free"},
+    {"malloc", "__syclstdpar_malloc"},
+    {"memalign", "__syclstdpar_aligned_alloc"},
+    {"posix_memalign", "__syclstdpar_posix_aligned_alloc"},
+    {"realloc", "__syclstdpar_realloc"},
+    {"reallocarray", "__syclstdpar_realloc_array"},
+    {"_ZdaPv", "__syclstdpar_operator_delete"},
+    {"_ZdaPvm", "__syclstdpar_operator_delete_sized"},
+    {"_ZdaPvSt11align_val_t", "__syclstdpar_operator_delete_aligned"},
+    {"_ZdaPvmSt11align_val_t", "__syclstdpar_operator_delete_aligned_sized"},
+    {"_ZdlPv", "__syclstdpar_operator_delete"},
+    {"_ZdlPvm", "__syclstdpar_operator_delete_sized"},
+    {"_ZdlPvSt11align_val_t", "__syclstdpar_operator_delete_aligned"},
+    {"_ZdlPvmSt11align_val_t", "__syclstdpar_operator_delete_aligned_sized"},
+    {"_Znam", "__syclstdpar_operator_new"},
+    {"_ZnamRKSt9nothrow_t", "__syclstdpar_operator_new_nothrow"},
+    {"_ZnamSt11align_val_t", "__syclstdpar_operator_new_aligned"},
+    {"_ZnamSt11align_val_tRKSt9nothrow_t",
+     "__syclstdpar_operator_new_aligned_nothrow"},
+    {"_Znwm", "__syclstdpar_operator_new"},
+    {"_ZnwmRKSt9nothrow_t", "__syclstdpar_operator_new_nothrow"},
+    {"_ZnwmSt11align_val_t", "__syclstdpar_operator_new_aligned"},
+    {"_ZnwmSt11align_val_tRKSt9nothrow_t",
+     "__syclstdpar_operator_new_aligned_nothrow"},
+    {"__libc_calloc", "__syclstdpar_calloc"},
+    {"__libc_free", "__syclstdpar_free"},
+    {"__libc_malloc", "__syclstdpar_malloc"},
+    {"__libc_memalign", "__syclstdpar_aligned_alloc"},
+    {"__libc_realloc", "__syclstdpar_realloc"}};
+
+PreservedAnalyses
+SYCLStdParAllocInterpositionPass::run(Module &M, ModuleAnalysisManager &) {
+  if (M.getModuleFlag("sycl-device"))
+    return PreservedAnalyses::all();
+
+  SmallDenseMap<StringRef, StringRef> AllocReplacements(std::cbegin(ReplaceMap),
+                                                        std::cend(ReplaceMap));
+  // The replacements are declared while iterating, collect the functions to
+  // replace first.
+  SmallVector<Function *> ToReplace;
+  for (Function &F : M)
+    if (F.hasName() && AllocReplacements.contains(F.getName()))
+      ToReplace.push_back(&F);
+
+  // The runtime functions have the prototypes of the functions they replace:
+  // declare them with the type and the attributes of the original ones.
+  for (Function *F : ToReplace) {
+    FunctionCallee R = M.getOrInsertFunction(AllocReplacements[F->getName()],
+                                             F->getFunctionType(),
+                                             F->getAttributes());
+    F->replaceAllUsesWith(R.getCallee());
+  }
+
+  return ToReplace.empty() ? PreservedAnalyses::all()
+                           : PreservedAnalyses::none();
+}
@@ -1101,13 +1101,39 @@ bool SpecConstantsPass::collectSpecConstantDefaultValuesMetadata(
   return true;
 }
 
+static bool isSpecConstantGetter(const Function &F) {
+  return F.getName().starts_with(SYCL_GET_SCALAR_2020_SPEC_CONST_VAL) ||
+         F.getName().starts_with(SYCL_GET_COMPOSITE_2020_SPEC_CONST_VAL) ||
+         F.getIntrinsicID() == llvm::Intrinsic::sycl_alloca;
+}
+
 bool llvm::checkModuleContainsSpecConsts(const Module &M) {
-  for (const Function &F : M.functions()) {
-    if (F.getName().starts_with(SYCL_GET_SCALAR_2020_SPEC_CONST_VAL) ||
-        F.getName().starts_with(SYCL_GET_COMPOSITE_2020_SPEC_CONST_VAL) ||
-        F.getIntrinsicID() == llvm::Intrinsic::sycl_alloca)
-      return true;
+  return any_of(M.functions(), isSpecConstantGetter);
+}
+
+std::optional<SmallPtrSet<const Function *, 8>>
+llvm::collectKernelsUsingSpecConsts(const Module &M) {
+  SmallPtrSet<const Function *, 16> Users;
+  SmallVector<const Function *, 16> Worklist;
+  for (const Function &F : M.functions())
+    if (isSpecConstantGetter(F))
+      Worklist.push_back(&F);
+
+  while (!Worklist.empty()) {
+    const Function *F = Worklist.pop_back_val();
+    for (const User *U : F->users()) {
+      const auto *CB = dyn_cast<CallBase>(U);
+      if (!CB || CB->getCalledOperand() != F)
+        return std::nullopt;
+      const Function *Caller = CB->getFunction();
+      if (Users.insert(Caller).second)
+        Worklist.push_back(Caller);
+    }
   }
 
-  return false;
+  SmallPtrSet<const Function *, 8> Kernels;
+  for (const Function *F : Users)
+    if (F->getCallingConv() == CallingConv::SPIR_KERNEL)
+      Kernels.insert(F);
+  return Kernels;
 }
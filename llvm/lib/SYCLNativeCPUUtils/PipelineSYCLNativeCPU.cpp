@@ -30,6 +30,8 @@
 #include "compiler/utils/work_item_loops_pass.h"
 #include "vecz/pass.h"
 #include "vecz/vecz_target_info.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Metadata.h"
 #include "llvm/IR/PassManager.h"
 #include "llvm/Transforms/AggressiveInstCombine/AggressiveInstCombine.h"
 #include "llvm/Transforms/IPO/AlwaysInliner.h"
@@ -65,6 +67,21 @@ static cl::opt<bool>
     SYCLDumpIR("sycl-native-dump-device-ir", cl::init(false),
                cl::desc("Dump device IR after Native passes."));
 
+#ifdef NATIVECPU_USE_OCK
+// On Native CPU the sub-group of a work-item is made of the work-items packed
+// into the lanes of the vectorized kernel, so kernels requiring a sub-group
+// size are vectorized by that size.
+static std::optional<unsigned> getReqdSubGroupSize(const Function &F) {
+  auto *MD = F.getMetadata("intel_reqd_sub_group_size");
+  if (!MD || MD->getNumOperands() != 1)
+    return std::nullopt;
+  auto *Size = mdconst::dyn_extract<ConstantInt>(MD->getOperand(0));
+  if (!Size)
+    return std::nullopt;
+  return Size->getZExtValue();
+}
+#endif
+
 void llvm::sycl::utils::addSYCLNativeCPUBackendPasses(
     llvm::ModulePassManager &MPM, ModuleAnalysisManager &MAM,
     OptimizationLevel OptLevel) {
@@ -84,7 +101,11 @@ void llvm::sycl::utils::addSYCLNativeCPUBackendPasses(
       if (F.getCallingConv() != llvm::CallingConv::SPIR_KERNEL) {
         return false;
       }
-      compiler::utils::VectorizationFactor VF(NativeCPUVeczWidth, false);
+      unsigned Width = getReqdSubGroupSize(F).value_or(NativeCPUVeczWidth);
+      if (Width <= 1) {
+        return false;
+      }
+      compiler::utils::VectorizationFactor VF(Width, false);
       vecz::VeczPassOptions VPO;
       VPO.factor = std::move(VF);
       Opts.emplace_back(std::move(VPO));
@@ -17,6 +17,7 @@
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/Parallel.h"
 #if LLVM_ENABLE_ZLIB
 #include <zlib.h>
 #endif
@@ -50,7 +51,7 @@ void compression::compress(Params P, ArrayRef<uint8_t> Input,
     zlib::compress(Input, Output, P.level);
     break;
   case compression::Format::Zstd:
-    zstd::compress(Input, Output, P.level, P.zstdEnableLdm);
+    zstd::compress(Input, Output, P.level, P.zstdEnableLdm, P.zstdNumWorkers);
     break;
   }
 }
@@ -61,7 +62,7 @@ Error compression::decompress(DebugCompressionType T, ArrayRef<uint8_t> Input,
   case compression::Format::Zlib:
     return zlib::decompress(Input, Output, UncompressedSize);
   case compression::Format::Zstd:
-    return zstd::decompress(Input, Output, UncompressedSize);
+    return zstd::decompressInParallel(Input, Output, UncompressedSize);
   }
   llvm_unreachable("");
 }
@@ -73,7 +74,7 @@ Error compression::decompress(compression::Format F, ArrayRef<uint8_t> Input,
   case compression::Format::Zlib:
     return zlib::decompress(Input, Output, UncompressedSize);
   case compression::Format::Zstd:
-    return zstd::decompress(Input, Output, UncompressedSize);
+    return zstd::decompressInParallel(Input, Output, UncompressedSize);
   }
   llvm_unreachable("");
 }
@@ -167,7 +168,7 @@ bool zstd::isAvailable() { return true; }
 
 void zstd::compress(ArrayRef<uint8_t> Input,
                     SmallVectorImpl<uint8_t> &CompressedBuffer, int Level,
-                    bool EnableLdm) {
+                    bool EnableLdm, unsigned NumWorkers) {
   ZSTD_CCtx *Cctx = ZSTD_createCCtx();
   if (!Cctx)
     report_bad_alloc_error("Failed to create ZSTD_CCtx");
@@ -184,6 +185,11 @@ void zstd::compress(ArrayRef<uint8_t> Input,
     report_bad_alloc_error("Failed to set ZSTD_c_compressionLevel");
   }
 
+  // This fails when libzstd is built without multithreading, in which case
+  // the input is compressed on this thread.
+  if (NumWorkers)
+    ZSTD_CCtx_setParameter(Cctx, ZSTD_c_nbWorkers, NumWorkers);
+
   unsigned long CompressedBufferSize = ZSTD_compressBound(Input.size());
   CompressedBuffer.resize_for_overwrite(CompressedBufferSize);
 
@@ -224,11 +230,64 @@ Error zstd::decompress(ArrayRef<uint8_t> Input,
   return E;
 }
 
+Error zstd::decompressInParallel(ArrayRef<uint8_t> Input, uint8_t *Output,
+                                 size_t &UncompressedSize) {
+  struct Frame {
+    ArrayRef<uint8_t> Compressed;
+    size_t Offset;
+    size_t Size;
+  };
+  SmallVector<Frame, 0> Frames;
+  size_t Offset = 0;
+  for (ArrayRef<uint8_t> Rest = Input; !Rest.empty();) {
+    size_t CompressedSize =
+        ZSTD_findFrameCompressedSize(Rest.data(), Rest.size());
+    unsigned long long Size =
+        ZSTD_getFrameContentSize(Rest.data(), Rest.size());
+    // Let decompress() report the errors and handle the frames without a
+    // content size.
+    if (ZSTD_isError(CompressedSize) || Size == ZSTD_CONTENTSIZE_UNKNOWN ||
+        Size == ZSTD_CONTENTSIZE_ERROR || Size > UncompressedSize - Offset)
+      return zstd::decompress(Input, Output, UncompressedSize);
+    Frames.push_back(
+        {Rest.take_front(CompressedSize), Offset, static_cast<size_t>(Size)});
+    Offset += Size;
+    Rest = Rest.drop_front(CompressedSize);
+  }
+  if (Frames.size() < 2)
+    return zstd::decompress(Input, Output, UncompressedSize);
+
+  SmallVector<size_t, 0> Results(Frames.size());
+  parallelFor(0, Frames.size(), [&](size_t I) {
+    const Frame &F = Frames[I];
+    Results[I] = ::ZSTD_decompress(Output + F.Offset, F.Size,
+                                   F.Compressed.data(), F.Compressed.size());
+  });
+  for (size_t Res : Results)
+    if (ZSTD_isError(Res))
+      return make_error<StringError>(ZSTD_getErrorName(Res),
+                                     inconvertibleErrorCode());
+  UncompressedSize = Offset;
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  __msan_unpoison(Output, UncompressedSize);
+  return Error::success();
+}
+
+Error zstd::decompressInParallel(ArrayRef<uint8_t> Input,
+                                 SmallVectorImpl<uint8_t> &Output,
+                                 size_t UncompressedSize) {
+  Output.resize_for_overwrite(UncompressedSize);
+  Error E = zstd::decompressInParallel(Input, Output.data(), UncompressedSize);
+  if (UncompressedSize < Output.size())
+    Output.truncate(UncompressedSize);
+  return E;
+}
+
 #else
 bool zstd::isAvailable() { return false; }
 void zstd::compress(ArrayRef<uint8_t> Input,
                     SmallVectorImpl<uint8_t> &CompressedBuffer, int Level,
-                    bool EnableLdm) {
+                    bool EnableLdm, unsigned NumWorkers) {
   llvm_unreachable("zstd::compress is unavailable");
 }
 Error zstd::decompress(ArrayRef<uint8_t> Input, uint8_t *Output,
@@ -240,4 +299,13 @@ Error zstd::decompress(ArrayRef<uint8_t> Input,
                        size_t UncompressedSize) {
   llvm_unreachable("zstd::decompress is unavailable");
 }
+Error zstd::decompressInParallel(ArrayRef<uint8_t> Input, uint8_t *Output,
+                                 size_t &UncompressedSize) {
+  llvm_unreachable("zstd::decompressInParallel is unavailable");
+}
+Error zstd::decompressInParallel(ArrayRef<uint8_t> Input,
+                                 SmallVectorImpl<uint8_t> &Output,
+                                 size_t UncompressedSize) {
+  llvm_unreachable("zstd::decompressInParallel is unavailable");
+}
 #endif
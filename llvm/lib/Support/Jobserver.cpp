@@ -0,0 +1,84 @@
+//===- llvm/Support/Jobserver.cpp - Client of a build jobserver -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/Jobserver.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Process.h"
+
+#include <string>
+
+using namespace llvm;
+
+//===----------------------------------------------------------------------===//
+//=== WARNING: Implementation here must contain only TRULY operating system
+//===          independent code.
+//===----------------------------------------------------------------------===//
+
+void JobSlot::release() {
+  if (!Client)
+    return;
+  Client->release(Token);
+  Client = nullptr;
+}
+
+JobserverClient *JobserverClient::getInstance() {
+  static JobserverClient *Instance = []() -> JobserverClient * {
+    std::optional<std::string> MakeFlags = sys::Process::GetEnv("MAKEFLAGS");
+    if (!MakeFlags)
+      return nullptr;
+    // The last option wins, as for make itself.
+    StringRef Auth;
+    for (StringRef Flag : llvm::split(*MakeFlags, ' '))
+      if (Flag.consume_front("--jobserver-auth=") ||
+          Flag.consume_front("--jobserver-fds="))
+        Auth = Flag;
+    if (Auth.empty())
+      return nullptr;
+    // Never destroyed, the slots may be released while the process exits.
+    auto *Client = new JobserverClient();
+    if (Client->connect(Auth))
+      return Client;
+    delete Client;
+    return nullptr;
+  }();
+  return Instance;
+}
+
+JobSlot JobserverClient::acquire() {
+  if (JobSlot Slot = tryAcquire(); Slot.isValid())
+    return Slot;
+  if (std::optional<int> Token = readToken(/*Wait=*/true))
+    return JobSlot(this, *Token);
+  // The jobserver is gone, only the limits of the process apply.
+  return JobSlot(this, JobSlot::NoToken);
+}
+
+JobSlot JobserverClient::tryAcquire() {
+  if (!ImplicitSlotUsed.exchange(true))
+    return JobSlot(this, JobSlot::ImplicitToken);
+  if (std::optional<int> Token = readToken(/*Wait=*/false))
+    return JobSlot(this, *Token);
+  return JobSlot();
+}
+
+void JobserverClient::release(int Token) {
+  if (Token == JobSlot::ImplicitToken)
+    ImplicitSlotUsed = false;
+  else if (Token != JobSlot::NoToken)
+    writeToken(Token);
+}
+
+// Include the platform-specific parts of this class.
+#ifdef LLVM_ON_UNIX
+#include "Unix/Jobserver.inc"
+#endif
+#ifdef _WIN32
+#include "Windows/Jobserver.inc"
+#endif
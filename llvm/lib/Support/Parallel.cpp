@@ -8,6 +8,7 @@
 
 #include "llvm/Support/Parallel.h"
 #include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Jobserver.h"
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/Threading.h"
 
@@ -42,15 +43,32 @@ public:
   virtual void add(std::function<void()> func, bool Sequential = false) = 0;
   virtual size_t getThreadCount() const = 0;
 
+  /// Runs the queued closures on the calling worker thread until \p L is
+  /// released, so that a worker waiting for a nested TaskGroup helps
+  /// instead of blocking.
+  virtual void helpUntilReleased(const Latch &L) = 0;
+
+  /// Wakes up the workers helping in helpUntilReleased when a latch may
+  /// have been released.
+  virtual void notifyHelpers() = 0;
+
   static Executor *getDefaultExecutor();
 };
 
-/// An implementation of an Executor that runs closures on a thread pool
-///   in filo order.
+/// An implementation of an Executor that runs closures on a thread pool.
+///
+/// Each worker has its own queue: the closures added by a worker are pushed
+/// to its queue and the worker runs them in filo order, while idle workers
+/// steal the oldest closures of the other queues. The closures added by the
+/// other threads go to a shared queue, which is also stolen from.
 class ThreadPoolExecutor : public Executor {
 public:
   explicit ThreadPoolExecutor(ThreadPoolStrategy S) {
     ThreadCount = S.compute_thread_count();
+    // The last queue is shared by the threads which are not workers.
+    Queues.reserve(ThreadCount + 1);
+    for (unsigned I = 0; I <= ThreadCount; ++I)
+      Queues.push_back(std::make_unique<TaskQueue>());
     // Spawn all but one of the threads in another thread as spawning threads
     // can take a while.
     Threads.reserve(ThreadCount);
@@ -99,54 +117,150 @@ public:
   };
 
   void add(std::function<void()> F, bool Sequential = false) override {
-    {
+    if (Sequential) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      WorkQueueSequential.emplace_front(std::move(F));
+      ++SequentialTasks;
+    } else {
+      // Count the task before it is visible, so that the count never
+      // underflows when it is stolen right away.
+      PendingTasks.fetch_add(1);
+      TaskQueue &Queue = *Queues[getQueueIndex()];
+      {
+        std::lock_guard<std::mutex> Lock(Queue.Mutex);
+        Queue.Tasks.emplace_back(std::move(F));
+      }
+      // Synchronize with the workers checking for tasks before they wait.
       std::lock_guard<std::mutex> Lock(Mutex);
-      if (Sequential)
-        WorkQueueSequential.emplace_front(std::move(F));
-      else
-        WorkQueue.emplace_back(std::move(F));
     }
     Cond.notify_one();
   }
 
   size_t getThreadCount() const override { return ThreadCount; }
 
+  void helpUntilReleased(const Latch &L) override {
+    HelpingThreads.fetch_add(1);
+    while (!L.isReleased()) {
+      std::function<void()> Task;
+      bool Sequential = false;
+      if (!popTask(Task, Sequential)) {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        Cond.wait(Lock, [&] {
+          return Stop || L.isReleased() || hasTasks();
+        });
+        if (Stop)
+          break;
+        continue;
+      }
+      runTask(Task, Sequential);
+    }
+    HelpingThreads.fetch_sub(1);
+    // Without workers, the remaining tasks of the group are never run.
+    L.sync();
+  }
+
+  void notifyHelpers() override {
+    if (HelpingThreads.load() == 0)
+      return;
+    {
+      std::lock_guard<std::mutex> Lock(Mutex);
+    }
+    Cond.notify_all();
+  }
+
 private:
+  struct TaskQueue {
+    std::mutex Mutex;
+    std::deque<std::function<void()>> Tasks;
+  };
+
+  unsigned getQueueIndex() const {
+    return threadIndex < ThreadCount ? threadIndex : ThreadCount;
+  }
+
   bool hasSequentialTasks() const {
     return !WorkQueueSequential.empty() && !SequentialQueueIsLocked;
   }
 
-  bool hasGeneralTasks() const { return !WorkQueue.empty(); }
+  bool hasTasks() const { return PendingTasks > 0 || hasSequentialTasks(); }
+
+  /// Pops the next task to run: a sequential task, the newest task of the
+  /// queue of the worker, or the oldest task of the other queues.
+  bool popTask(std::function<void()> &Task, bool &Sequential) {
+    // Only take the lock of the sequential queue when it may have tasks.
+    if (SequentialTasks > 0 && !SequentialQueueIsLocked) {
+      std::lock_guard<std::mutex> Lock(Mutex);
+      if (hasSequentialTasks()) {
+        SequentialQueueIsLocked = true;
+        Task = std::move(WorkQueueSequential.back());
+        WorkQueueSequential.pop_back();
+        --SequentialTasks;
+        Sequential = true;
+        return true;
+      }
+    }
+    if (PendingTasks == 0)
+      return false;
+
+    unsigned Own = getQueueIndex();
+    unsigned NumQueues = Queues.size();
+    for (unsigned I = 0; I < NumQueues; ++I) {
+      unsigned Index = (Own + I) % NumQueues;
+      TaskQueue &Queue = *Queues[Index];
+      std::lock_guard<std::mutex> Lock(Queue.Mutex);
+      if (Queue.Tasks.empty())
+        continue;
+      if (Index == Own && Own != ThreadCount) {
+        Task = std::move(Queue.Tasks.back());
+        Queue.Tasks.pop_back();
+      } else {
+        Task = std::move(Queue.Tasks.front());
+        Queue.Tasks.pop_front();
+      }
+      PendingTasks.fetch_sub(1);
+      Sequential = false;
+      return true;
+    }
+    return false;
+  }
+
+  void runTask(std::function<void()> &Task, bool Sequential) {
+    Task();
+    if (Sequential)
+      SequentialQueueIsLocked = false;
+  }
 
   void work(ThreadPoolStrategy S, unsigned ThreadID) {
     threadIndex = ThreadID;
     S.apply_thread_strategy(ThreadID);
+    JobserverClient *Jobserver =
+        S.UseJobserver ? JobserverClient::getInstance() : nullptr;
+    // The job slot is kept while there are tasks to run, and released before
+    // waiting for more.
+    JobSlot Slot;
     while (true) {
-      std::unique_lock<std::mutex> Lock(Mutex);
-      Cond.wait(Lock, [&] {
-        return Stop || hasGeneralTasks() || hasSequentialTasks();
-      });
-      if (Stop)
-        break;
-      bool Sequential = hasSequentialTasks();
-      if (Sequential)
-        SequentialQueueIsLocked = true;
-      else
-        assert(hasGeneralTasks());
-
-      auto &Queue = Sequential ? WorkQueueSequential : WorkQueue;
-      auto Task = std::move(Queue.back());
-      Queue.pop_back();
-      Lock.unlock();
-      Task();
-      if (Sequential)
-        SequentialQueueIsLocked = false;
+      std::function<void()> Task;
+      bool Sequential = false;
+      if (!popTask(Task, Sequential)) {
+        Slot.release();
+        std::unique_lock<std::mutex> Lock(Mutex);
+        Cond.wait(Lock, [&] { return Stop || hasTasks(); });
+        if (Stop)
+          break;
+        continue;
+      }
+      if (Jobserver && !Slot.isValid())
+        Slot = Jobserver->acquire();
+      runTask(Task, Sequential);
     }
   }
 
   std::atomic<bool> Stop{false};
   std::atomic<bool> SequentialQueueIsLocked{false};
-  std::deque<std::function<void()>> WorkQueue;
+  std::atomic<size_t> PendingTasks{0};
+  std::atomic<size_t> SequentialTasks{0};
+  std::atomic<unsigned> HelpingThreads{0};
+  std::vector<std::unique_ptr<TaskQueue>> Queues;
   std::deque<std::function<void()>> WorkQueueSequential;
   std::mutex Mutex;
   std::condition_variable Cond;
@@ -197,31 +311,35 @@ size_t getThreadCount() {
 }
 #endif
 
-// Latch::sync() called by the dtor may cause one thread to block. If is a dead
-// lock if all threads in the default executor are blocked. To prevent the dead
-// lock, only allow the root TaskGroup to run tasks parallelly. In the scenario
-// of nested parallel_for_each(), only the outermost one runs parallelly.
+// Nested TaskGroups run their tasks in parallel too: a worker thread waiting
+// for a TaskGroup runs the queued tasks until the group is done, instead of
+// blocking, so that nested parallel_for_each() calls neither deadlock nor
+// oversubscribe the default executor.
 TaskGroup::TaskGroup()
 #if LLVM_ENABLE_THREADS
-    : Parallel((parallel::strategy.ThreadsRequested != 1) &&
-               (threadIndex == UINT_MAX)) {}
+    : Parallel(parallel::strategy.ThreadsRequested != 1) {}
 #else
     : Parallel(false) {}
 #endif
 TaskGroup::~TaskGroup() {
   // We must ensure that all the workloads have finished before decrementing the
   // instances count.
-  L.sync();
+  sync();
 }
 
 void TaskGroup::spawn(std::function<void()> F, bool Sequential) {
 #if LLVM_ENABLE_THREADS
-  if (Parallel) {
+  // A sequential task of a nested group runs right away: the worker may be
+  // running a sequential task itself, which blocks the sequential queue.
+  if (Parallel && !(Sequential && threadIndex != UINT_MAX)) {
+    detail::Executor *Exec = detail::Executor::getDefaultExecutor();
     L.inc();
-    detail::Executor::getDefaultExecutor()->add(
-        [&, F = std::move(F)] {
+    Exec->add(
+        [&L = L, Exec, F = std::move(F)] {
           F();
           L.dec();
+          // The group may be destroyed once the latch is released.
+          Exec->notifyHelpers();
         },
         Sequential);
     return;
@@ -230,6 +348,16 @@ void TaskGroup::spawn(std::function<void()> F, bool Sequential) {
   F();
 }
 
+void TaskGroup::sync() const {
+#if LLVM_ENABLE_THREADS
+  if (Parallel && threadIndex != UINT_MAX) {
+    detail::Executor::getDefaultExecutor()->helpUntilReleased(L);
+    return;
+  }
+#endif
+  L.sync();
+}
+
 } // namespace parallel
 } // namespace llvm
 
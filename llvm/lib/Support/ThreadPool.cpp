@@ -15,6 +15,7 @@
 #include "llvm/Config/llvm-config.h"
 
 #include "llvm/Support/FormatVariadic.h"
+#include "llvm/Support/Jobserver.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -96,8 +97,15 @@ void StdThreadPool::processTasks(ThreadPoolTaskGroup *WaitingForGroup) {
     CurrentThreadTaskGroups->push_back(GroupOfTask);
 #endif
 
-    // Run the task we just grabbed
-    Task();
+    // Run the task we just grabbed. The threads waiting for a group already
+    // hold a job slot for the task they are running.
+    {
+      JobSlot Slot;
+      if (Strategy.UseJobserver && WaitingForGroup == nullptr)
+        if (JobserverClient *Jobserver = JobserverClient::getInstance())
+          Slot = Jobserver->acquire();
+      Task();
+    }
 
 #ifndef NDEBUG
     CurrentThreadTaskGroups->pop_back();
@@ -14,11 +14,13 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/STLFunctionalExtras.h"
 #include "llvm/ADT/StringMap.h"
+#include "llvm/Support/xxhash.h"
 #include "llvm/Support/JSON.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Threading.h"
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <chrono>
 #include <memory>
@@ -104,14 +106,97 @@ struct llvm::TimeTraceProfilerEntry {
   }
 };
 
+/// The durations of the sections of each name, in summary mode. The table
+/// has a fixed size so that recording a section never allocates, except to
+/// copy the name the first time it is seen, and the sections of the names
+/// which don't fit are counted under an overflow name.
+class TimeTraceSummaryTable {
+public:
+  static constexpr unsigned Size = 512;
+  static constexpr unsigned OverflowIndex = Size - 1;
+
+  struct Kind {
+    std::string Name;
+    size_t Count = 0;
+    DurationType Total{};
+    // The number of open sections of the kind, only the outermost ones are
+    // counted in the totals.
+    unsigned Open = 0;
+  };
+
+  TimeTraceSummaryTable() { Kinds[OverflowIndex].Name = "<other>"; }
+
+  unsigned getIndex(StringRef Name) {
+    // Linear probing over all but the overflow entry.
+    unsigned Index = xxh3_64bits(Name) % OverflowIndex;
+    for (unsigned Probe = 0; Probe < OverflowIndex; ++Probe) {
+      Kind &K = Kinds[Index];
+      if (K.Name == Name)
+        return Index;
+      if (K.Name.empty()) {
+        K.Name = Name.str();
+        return Index;
+      }
+      Index = (Index + 1) % OverflowIndex;
+    }
+    return OverflowIndex;
+  }
+
+  Kind &operator[](unsigned Index) { return Kinds[Index]; }
+
+  /// Adds the totals of the table to \p CountAndTotalPerName.
+  void flush(StringMap<CountAndDurationType> &CountAndTotalPerName) {
+    for (Kind &K : Kinds) {
+      if (!K.Count)
+        continue;
+      auto &CountAndTotal = CountAndTotalPerName[K.Name];
+      CountAndTotal.first += K.Count;
+      CountAndTotal.second += K.Total;
+      K.Count = 0;
+      K.Total = DurationType();
+    }
+  }
+
+private:
+  std::array<Kind, Size> Kinds;
+};
+
 struct llvm::TimeTraceProfiler {
   TimeTraceProfiler(unsigned TimeTraceGranularity = 0, StringRef ProcName = "",
-                    bool TimeTraceVerbose = false)
+                    bool TimeTraceVerbose = false,
+                    bool TimeTraceSummary = false)
       : BeginningOfTime(system_clock::now()), StartTime(ClockType::now()),
         ProcName(ProcName), Pid(sys::Process::getProcessId()),
         Tid(llvm::get_threadid()), TimeTraceGranularity(TimeTraceGranularity),
         TimeTraceVerbose(TimeTraceVerbose) {
     llvm::get_thread_name(ThreadName);
+    if (TimeTraceSummary)
+      Summary = std::make_unique<TimeTraceSummaryTable>();
+  }
+
+  /// Starts a section in summary mode. Neither the details nor the section
+  /// are recorded, only the start time and the kind of the section.
+  void beginSummary(StringRef Name) {
+    unsigned Index = Summary->getIndex(Name);
+    ++(*Summary)[Index].Open;
+    SummaryStack.emplace_back(Index, ClockType::now());
+  }
+
+  void endSummary() {
+    assert(!SummaryStack.empty() && "Must call begin() first");
+    auto [Index, Start] = SummaryStack.pop_back_val();
+    TimeTraceSummaryTable::Kind &K = (*Summary)[Index];
+    if (--K.Open == 0) {
+      ++K.Count;
+      K.Total += ClockType::now() - Start;
+    }
+  }
+
+  /// Moves the totals of the summary to CountAndTotalPerName, which write()
+  /// reports.
+  void flushSummary() {
+    if (Summary)
+      Summary->flush(CountAndTotalPerName);
   }
 
   TimeTraceProfilerEntry *begin(std::string Name,
@@ -179,6 +264,9 @@ struct llvm::TimeTraceProfiler {
     assert(llvm::all_of(Instances.List,
                         [](const auto &TTP) { return TTP->Stack.empty(); }) &&
            "All profiler sections should be ended when calling write");
+    flushSummary();
+    for (TimeTraceProfiler *TTP : Instances.List)
+      TTP->flushSummary();
 
     json::OStream J(OS);
     J.objectBegin();
@@ -322,6 +410,10 @@ struct llvm::TimeTraceProfiler {
   SmallVector<std::unique_ptr<TimeTraceProfilerEntry>, 16> Stack;
   SmallVector<TimeTraceProfilerEntry, 128> Entries;
   StringMap<CountAndDurationType> CountAndTotalPerName;
+  // In summary mode, the durations per section name, and the kinds and start
+  // times of the open sections.
+  std::unique_ptr<TimeTraceSummaryTable> Summary;
+  SmallVector<std::pair<unsigned, TimePointType>, 32> SummaryStack;
   // System clock time when the session was begun.
   const time_point<system_clock> BeginningOfTime;
   // Profiling clock time when the session was begun.
@@ -344,14 +436,20 @@ bool llvm::isTimeTraceVerbose() {
          getTimeTraceProfilerInstance()->TimeTraceVerbose;
 }
 
+bool llvm::isTimeTraceSummary() {
+  return getTimeTraceProfilerInstance() &&
+         getTimeTraceProfilerInstance()->Summary;
+}
+
 void llvm::timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
                                        StringRef ProcName,
-                                       bool TimeTraceVerbose) {
+                                       bool TimeTraceVerbose,
+                                       bool TimeTraceSummary) {
   assert(TimeTraceProfilerInstance == nullptr &&
          "Profiler should not be initialized");
   TimeTraceProfilerInstance = new TimeTraceProfiler(
       TimeTraceGranularity, llvm::sys::path::filename(ProcName),
-      TimeTraceVerbose);
+      TimeTraceVerbose, TimeTraceSummary);
 }
 
 // Removes all TimeTraceProfilerInstances.
@@ -402,44 +500,74 @@ Error llvm::timeTraceProfilerWrite(StringRef PreferredFileName,
   return Error::success();
 }
 
+// In summary mode, the begin functions return a shared placeholder entry:
+// the sections are ended in the order they were begun. The async sections,
+// which may not be, are ignored and get no entry.
+static TimeTraceProfilerEntry *getSummaryEntry() {
+  static TimeTraceProfilerEntry Entry(TimePointType(), TimePointType(), "", "",
+                                      false);
+  return &Entry;
+}
+
 TimeTraceProfilerEntry *llvm::timeTraceProfilerBegin(StringRef Name,
                                                      StringRef Detail) {
-  if (TimeTraceProfilerInstance != nullptr)
-    return TimeTraceProfilerInstance->begin(
-        std::string(Name), [&]() { return std::string(Detail); }, false);
-  return nullptr;
+  if (TimeTraceProfilerInstance == nullptr)
+    return nullptr;
+  if (TimeTraceProfilerInstance->Summary) {
+    TimeTraceProfilerInstance->beginSummary(Name);
+    return getSummaryEntry();
+  }
+  return TimeTraceProfilerInstance->begin(
+      std::string(Name), [&]() { return std::string(Detail); }, false);
 }
 
 TimeTraceProfilerEntry *
 llvm::timeTraceProfilerBegin(StringRef Name,
                              llvm::function_ref<std::string()> Detail) {
-  if (TimeTraceProfilerInstance != nullptr)
-    return TimeTraceProfilerInstance->begin(std::string(Name), Detail, false);
-  return nullptr;
+  if (TimeTraceProfilerInstance == nullptr)
+    return nullptr;
+  if (TimeTraceProfilerInstance->Summary) {
+    TimeTraceProfilerInstance->beginSummary(Name);
+    return getSummaryEntry();
+  }
+  return TimeTraceProfilerInstance->begin(std::string(Name), Detail, false);
 }
 
 TimeTraceProfilerEntry *
 llvm::timeTraceProfilerBegin(StringRef Name,
                              llvm::function_ref<TimeTraceMetadata()> Metadata) {
-  if (TimeTraceProfilerInstance != nullptr)
-    return TimeTraceProfilerInstance->begin(std::string(Name), Metadata, false);
-  return nullptr;
+  if (TimeTraceProfilerInstance == nullptr)
+    return nullptr;
+  if (TimeTraceProfilerInstance->Summary) {
+    TimeTraceProfilerInstance->beginSummary(Name);
+    return getSummaryEntry();
+  }
+  return TimeTraceProfilerInstance->begin(std::string(Name), Metadata, false);
 }
 
 TimeTraceProfilerEntry *llvm::timeTraceAsyncProfilerBegin(StringRef Name,
                                                           StringRef Detail) {
-  if (TimeTraceProfilerInstance != nullptr)
+  if (TimeTraceProfilerInstance != nullptr &&
+      !TimeTraceProfilerInstance->Summary)
     return TimeTraceProfilerInstance->begin(
         std::string(Name), [&]() { return std::string(Detail); }, true);
   return nullptr;
 }
 
 void llvm::timeTraceProfilerEnd() {
-  if (TimeTraceProfilerInstance != nullptr)
+  if (TimeTraceProfilerInstance == nullptr)
+    return;
+  if (TimeTraceProfilerInstance->Summary)
+    TimeTraceProfilerInstance->endSummary();
+  else
     TimeTraceProfilerInstance->end();
 }
 
 void llvm::timeTraceProfilerEnd(TimeTraceProfilerEntry *E) {
-  if (TimeTraceProfilerInstance != nullptr)
+  if (TimeTraceProfilerInstance == nullptr)
+    return;
+  if (!TimeTraceProfilerInstance->Summary)
     TimeTraceProfilerInstance->end(*E);
+  else if (E == getSummaryEntry())
+    TimeTraceProfilerInstance->endSummary();
 }
@@ -310,6 +310,18 @@ static void convertToParamAS(Use *OldUse, Value *Param, bool HasCvtaParam,
           SI->setFalseValue(ParamInGenericAS);
       }
 
+      // Calls which only read through the pointer and don't capture it can
+      // use generic param pointers, see ArgUseChecker::visitCallBase.
+      if (auto *CI = dyn_cast<CallInst>(I.OldInstruction)) {
+        if (!IsGridConstant && CI->isArgOperand(I.OldUse)) {
+          unsigned ArgNo = CI->getArgOperandNo(I.OldUse);
+          if (CI->doesNotCapture(ArgNo) && CI->onlyReadsMemory(ArgNo)) {
+            I.OldUse->set(ParamInGenericAS);
+            return CI;
+          }
+        }
+      }
+
       // Escapes or writes can only use generic param pointers if
       // __grid_constant__ is in effect.
       if (IsGridConstant) {
@@ -461,11 +473,15 @@ struct ArgUseChecker : PtrUseVisitor<ArgUseChecker> {
   using Base = PtrUseVisitor<ArgUseChecker>;
 
   bool IsGridConstant;
+  // Whether the calls only reading through the pointer are read-only uses.
+  bool AllowReadOnlyCalls;
   // Set of phi/select instructions using the Arg
   SmallPtrSet<Instruction *, 4> Conditionals;
 
-  ArgUseChecker(const DataLayout &DL, bool IsGridConstant)
-      : PtrUseVisitor(DL), IsGridConstant(IsGridConstant) {}
+  ArgUseChecker(const DataLayout &DL, bool IsGridConstant,
+                bool AllowReadOnlyCalls)
+      : PtrUseVisitor(DL), IsGridConstant(IsGridConstant),
+        AllowReadOnlyCalls(AllowReadOnlyCalls) {}
 
   PtrInfo visitArgPtr(Argument &A) {
     assert(A.getType()->isPointerTy());
@@ -542,6 +558,19 @@ struct ArgUseChecker : PtrUseVisitor<ArgUseChecker> {
     if (!IsGridConstant)
       PI.setAborted(&II);
   }
+
+  // Passing the pointer to a function which neither captures it nor writes
+  // through it, e.g. to the device functions a kernel passes the members of
+  // its aggregate argument to, doesn't need a copy: the callee can read the
+  // parameter through a generic pointer to it.
+  void visitCallBase(CallBase &CB) {
+    if (AllowReadOnlyCalls && CB.isArgOperand(U)) {
+      unsigned ArgNo = CB.getArgOperandNo(U);
+      if (CB.doesNotCapture(ArgNo) && CB.onlyReadsMemory(ArgNo))
+        return;
+    }
+    Base::visitCallBase(CB);
+  }
 }; // struct ArgUseChecker
 } // namespace
 
@@ -555,7 +584,11 @@ void NVPTXLowerArgs::handleByValParam(const NVPTXTargetMachine &TM,
   Type *StructType = Arg->getParamByValType();
   assert(StructType && "Missing byval type");
 
-  ArgUseChecker AUC(DL, IsGridConstant);
+  // Taking a generic pointer to the parameter needs cvta.param, which is
+  // only available for the parameters of kernels.
+  ArgUseChecker AUC(DL, IsGridConstant,
+                    /*AllowReadOnlyCalls=*/HasCvtaParam &&
+                        isKernelFunction(*Func));
   ArgUseChecker::PtrInfo PI = AUC.visitArgPtr(*Arg);
   bool ArgUseIsReadOnly  = !(PI.isEscaped() || PI.isAborted());
   // Easy case, accessing parameter directly is fine.
@@ -145,27 +145,31 @@ private:
 
 public:
   void add(KeyTy V, const MachineFunction *MF, Register R) {
-    if (find(V, MF).isValid())
+    SPIRV::DTSortableEntry &Entry = Storage[V];
+    Register &Reg = Entry[MF];
+    if (Reg.isValid())
       return;
 
-    Storage[V][MF] = R;
+    Reg = R;
     if (std::is_same<Function,
                      typename std::remove_const<
                          typename std::remove_pointer<KeyTy>::type>::type>() ||
         std::is_same<Argument,
                      typename std::remove_const<
                          typename std::remove_pointer<KeyTy>::type>::type>())
-      Storage[V].setIsFunc(true);
+      Entry.setIsFunc(true);
     if (std::is_same<GlobalVariable,
                      typename std::remove_const<
                          typename std::remove_pointer<KeyTy>::type>::type>())
-      Storage[V].setIsGV(true);
+      Entry.setIsGV(true);
   }
 
   Register find(KeyTy V, const MachineFunction *MF) const {
     auto iter = Storage.find(V);
     if (iter != Storage.end()) {
-      auto Map = iter->second;
+      // The entry holds the registers of all the functions using the value,
+      // so it must not be copied.
+      const SPIRV::DTSortableEntry &Map = iter->second;
       auto iter2 = Map.find(MF);
       if (iter2 != Map.end())
         return iter2->second;
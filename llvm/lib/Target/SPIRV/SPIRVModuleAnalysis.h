@@ -126,9 +126,9 @@ public:
 
 using InstrList = SmallVector<MachineInstr *>;
 // Maps a local register to the corresponding global alias.
-using LocalToGlobalRegTable = std::map<Register, Register>;
+using LocalToGlobalRegTable = DenseMap<Register, Register>;
 using RegisterAliasMapTy =
-    std::map<const MachineFunction *, LocalToGlobalRegTable>;
+    DenseMap<const MachineFunction *, LocalToGlobalRegTable>;
 
 // The struct contains results of the module analysis and methods
 // to access them.
@@ -176,15 +176,15 @@ struct ModuleAnalysisInfo {
     RegisterAliasTable[MF][Reg] = AliasReg;
   }
   Register getRegisterAlias(const MachineFunction *MF, Register Reg) {
-    auto RI = RegisterAliasTable[MF].find(Reg);
-    if (RI == RegisterAliasTable[MF].end()) {
+    auto FI = RegisterAliasTable.find(MF);
+    if (FI == RegisterAliasTable.end())
       return Register(0);
-    }
-    return RegisterAliasTable[MF][Reg];
+    auto RI = FI->second.find(Reg);
+    return RI == FI->second.end() ? Register(0) : RI->second;
   }
   bool hasRegisterAlias(const MachineFunction *MF, Register Reg) {
-    return RegisterAliasTable.find(MF) != RegisterAliasTable.end() &&
-           RegisterAliasTable[MF].find(Reg) != RegisterAliasTable[MF].end();
+    auto FI = RegisterAliasTable.find(MF);
+    return FI != RegisterAliasTable.end() && FI->second.contains(Reg);
   }
   unsigned getNextID() { return MaxID++; }
   bool hasMBBRegister(const MachineBasicBlock &MBB) {
@@ -464,6 +464,12 @@ static cl::opt<bool>
                           cl::desc("instrument generic pointer"), cl::Hidden,
                           cl::init(true));
 
+static cl::opt<unsigned> ClSpirOffloadSamplingShift(
+    "asan-spir-sampling-shift",
+    cl::desc("check only the accesses to 1 in 2^N pages of memory, picked "
+             "anew at each kernel launch (0 to check all the accesses)"),
+    cl::Hidden, cl::init(0));
+
 // Debug flags.
 
 static cl::opt<int> ClDebug("asan-debug", cl::desc("debug"), cl::Hidden,
@@ -1294,6 +1300,20 @@ struct FunctionStackPoisoner : public InstVisitor<FunctionStackPoisoner> {
 
 } // end anonymous namespace
 
+// Define the sampling shift read by the checks of the device library, see
+// IsSampled in libdevice/sanitizer_utils.cpp. Weak, the modules linked
+// together all define it.
+static void DefineSpirSamplingShift(Module &M) {
+  if (ClSpirOffloadSamplingShift >= 32)
+    report_fatal_error("asan-spir-sampling-shift must be less than 32");
+  auto *Int32Ty = Type::getInt32Ty(M.getContext());
+  new GlobalVariable(M, Int32Ty, /*isConstant=*/true,
+                     GlobalValue::WeakAnyLinkage,
+                     ConstantInt::get(Int32Ty, ClSpirOffloadSamplingShift),
+                     "__AsanSamplingShift", nullptr,
+                     GlobalVariable::NotThreadLocal, kSpirOffloadConstantAS);
+}
+
 // Append a new argument "launch_data" to user's spir_kernels
 static void ExtendSpirKernelArgs(Module &M, FunctionAnalysisManager &FAM) {
   SmallVector<Function *> SpirFixupFuncs;
@@ -1462,6 +1482,10 @@ PreservedAnalyses AddressSanitizerPass::run(Module &M,
     Modified |= FunctionSanitizer.instrumentFunction(F, &TLI);
   }
   Modified |= ModuleSanitizer.instrumentModule();
+  if (Triple(M.getTargetTriple()).isSPIROrSPIRV()) {
+    DefineSpirSamplingShift(M);
+    Modified = true;
+  }
   if (!Modified)
     return PreservedAnalyses::all();
 
@@ -1043,6 +1043,11 @@ void InstrLowerer::lowerValueProfileInst(InstrProfValueProfileInst *Ind) {
   assert(
       !DebugInfoCorrelate && ProfileCorrelate == InstrProfCorrelator::NONE &&
       "Value profiling is not yet supported with lightweight instrumentation");
+  // SPIR-V device code has no value profiling runtime to call.
+  if (TT.isSPIROrSPIRV()) {
+    Ind->eraseFromParent();
+    return;
+  }
   GlobalVariable *Name = Ind->getName();
   auto It = ProfileDataMap.find(Name);
   assert(It != ProfileDataMap.end() && It->second.DataVar &&
@@ -1454,6 +1459,10 @@ static bool needsRuntimeRegistrationOfSectionRange(const Triple &TT) {
   if (TT.isOSBinFormatELF() || TT.isOSBinFormatCOFF() ||
       TT.isOSBinFormatMachO() || TT.isOSBinFormatXCOFF())
     return false;
+  // There is no profile runtime in SPIR-V device code, the host runtime reads
+  // the counters.
+  if (TT.isSPIROrSPIRV())
+    return false;
 
   return true;
 }
@@ -2085,6 +2094,10 @@ bool InstrLowerer::emitRuntimeHook() {
   if (TT.isOSLinux() || TT.isOSAIX())
     return false;
 
+  // SPIR-V device code doesn't link with the profile runtime.
+  if (TT.isSPIROrSPIRV())
+    return false;
+
   // If the module's provided its own runtime, we don't need to do anything.
   if (M.getGlobalVariable(getInstrProfRuntimeHookVarName()))
     return false;
@@ -13,14 +13,17 @@
 
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Jobserver.h"
 #include "llvm/Support/LineIterator.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/SystemUtils.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Threading.h"
 
-#include <list>
+#include <atomic>
+#include <mutex>
 #include <vector>
 
 using namespace llvm;
@@ -76,7 +79,9 @@ static cl::opt<unsigned int> JobsInParallel{
     cl::Optional,
     cl::init(1),
     cl::desc("Specify the number of threads for launching input commands in "
-             "parallel mode"),
+             "parallel mode. Without it, the commands are run in parallel "
+             "within the jobs of the jobserver of the build if there is one, "
+             "one at a time otherwise"),
 };
 
 static cl::alias JobsInParallelShort{"j", cl::desc("Alias for --jobs"),
@@ -92,33 +97,6 @@ static void error(std::error_code EC, const Twine &Prefix) {
     error(Prefix + ": " + EC.message());
 }
 
-// With BlockingWait=false this function just goes through the all
-// submitted jobs to check if some of them have finished.
-int checkIfJobsAreFinished(std::list<sys::ProcessInfo> &JobsSubmitted,
-                           bool BlockingWait = true) {
-  std::string ErrMsg;
-  auto It = JobsSubmitted.begin();
-  while (It != JobsSubmitted.end()) {
-    sys::ProcessInfo WaitResult = sys::Wait(
-        *It, /*SecondsToWait*/ BlockingWait ? std::nullopt : std::optional(0),
-        &ErrMsg);
-
-    // Check if the job has finished (PID will be 0 if it's not).
-    if (!BlockingWait && !WaitResult.Pid) {
-      It++;
-      continue;
-    }
-    assert(BlockingWait || WaitResult.Pid);
-    It = JobsSubmitted.erase(It);
-
-    if (WaitResult.ReturnCode != 0) {
-      errs() << "llvm-foreach: " << ErrMsg << '\n';
-      return WaitResult.ReturnCode;
-    }
-  }
-  return 0;
-}
-
 int main(int argc, char **argv) {
   cl::ParseCommandLineOptions(
       argc, argv,
@@ -210,17 +188,26 @@ int main(int argc, char **argv) {
            << MaxSafeNumThreads << " (max safe available).\n";
   }
 
+  // Each running command holds a job slot of the jobserver of the build, if
+  // there is one, so that the commands count against the jobs of the build.
+  ThreadPoolStrategy Strategy = hardware_concurrency(JobsInParallel);
+  if (JobsInParallel.getNumOccurrences() == 0 &&
+      JobserverClient::getInstance())
+    Strategy = optimal_concurrency(FileLists[0].size());
+  Strategy.UseJobserver = true;
+
   std::error_code EC;
   raw_fd_ostream OS{OutputFileList, EC, sys::fs::OpenFlags::OF_None};
   if (!OutputFileList.empty())
     error(EC, "error opening the file '" + OutputFileList + "'");
 
-  int Res = 0;
+  // The command lines of all the input items. The output files are created,
+  // and added to the output file list, in the order of the items.
   std::string ResOutArg;
   std::string IncOutArg;
   std::vector<std::string> ResInArgs(InReplaceArgs.size());
-  std::string ResFileList = "";
-  std::list<sys::ProcessInfo> JobsSubmitted;
+  std::vector<std::vector<std::string>> Commands;
+  Commands.reserve(FileLists[0].size());
   for (size_t j = 0; j != FileLists[0].size(); ++j) {
     for (size_t i = 0; i < InReplaceArgs.size(); ++i) {
       ArgumentReplace CurReplace = InReplaceArgs[i];
@@ -272,27 +259,36 @@ int main(int argc, char **argv) {
       Args[OutIncrementArg.ArgNum] = IncOutArg;
     }
 
-    // Do not start execution of a new job until previous one(s) are finished,
-    // if the maximum number of parallel workers is reached.
-    while (JobsSubmitted.size() == JobsInParallel)
-      if (int Result =
-              checkIfJobsAreFinished(JobsSubmitted, /*BlockingWait*/ false))
-        Res = Result;
-
-    JobsSubmitted.emplace_back(
-        sys::ExecuteNoWait(Prog, Args, /*Env=*/std::nullopt,
-                           /*Redirects=*/std::nullopt, /*MemoryLimit=*/0));
+    Commands.emplace_back(Args.begin(), Args.end());
   }
 
-  // Wait for all commands to be executed.
-  while (!JobsSubmitted.empty())
-    if (int Result =
-            checkIfJobsAreFinished(JobsSubmitted, /*BlockingWait*/ true))
-      Res = Result;
-
   if (!OutputFileList.empty()) {
     OS.close();
   }
 
+  // Once a command failed, the commands which haven't started yet are
+  // skipped. The exit code is the one of the first command which failed.
+  int Res = 0;
+  std::atomic<bool> Failed = false;
+  std::mutex ResMutex;
+  DefaultThreadPool Pool(Strategy);
+  for (const std::vector<std::string> &Command : Commands)
+    Pool.async([&] {
+      if (Failed.load(std::memory_order_relaxed))
+        return;
+      SmallVector<StringRef, 8> CommandArgs(Command.begin(), Command.end());
+      std::string ErrMsg;
+      int Result = sys::ExecuteAndWait(Prog, CommandArgs, /*Env=*/std::nullopt,
+                                       /*Redirects=*/{}, /*SecondsToWait=*/0,
+                                       /*MemoryLimit=*/0, &ErrMsg);
+      if (Result == 0)
+        return;
+      std::lock_guard<std::mutex> Lock(ResMutex);
+      if (!Failed.exchange(true))
+        Res = Result;
+      errs() << "llvm-foreach: " << ErrMsg << '\n';
+    });
+  Pool.wait();
+
   return Res;
 }
@@ -49,7 +49,10 @@ cl::opt<IRSplitMode> SplitMode(
                clEnumValN(module_split::SPLIT_PER_KERNEL, "kernel",
                           "1 output module per kernel"),
                clEnumValN(module_split::SPLIT_AUTO, "auto",
-                          "Choose split mode automatically")),
+                          "Choose split mode automatically"),
+               clEnumValN(module_split::SPLIT_BY_SIZE, "size",
+                          "Output modules of kernels sharing code, up to "
+                          "-split-target-size instructions")),
     cl::cat(SplitCategory));
 
 void writeStringToFile(const std::string &Content, StringRef Path) {
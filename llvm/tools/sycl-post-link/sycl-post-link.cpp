@@ -15,10 +15,13 @@
 
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/StringSet.h"
 #include "llvm/Analysis/AssumptionCache.h"
 #include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/Bitcode/BitcodeWriterPass.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/GenXIntrinsics/GenXSPIRVWriterAdaptor.h"
@@ -28,6 +31,7 @@
 #include "llvm/IRPrinter/IRPrintingPasses.h"
 #include "llvm/IRReader/IRReader.h"
 #include "llvm/Linker/Linker.h"
+#include "llvm/Object/OffloadBinary.h"
 #include "llvm/Passes/PassBuilder.h"
 #include "llvm/SYCLLowerIR/CompileTimePropertiesPass.h"
 #include "llvm/SYCLLowerIR/ComputeModuleRuntimeInfo.h"
@@ -39,6 +43,7 @@
 #include "llvm/SYCLLowerIR/LowerInvokeSimd.h"
 #include "llvm/SYCLLowerIR/ModuleSplitter.h"
 #include "llvm/SYCLLowerIR/SYCLJointMatrixTransform.h"
+#include "llvm/SYCLLowerIR/SYCLMathAccuracy.h"
 #include "llvm/SYCLLowerIR/SYCLUtils.h"
 #include "llvm/SYCLLowerIR/SanitizeDeviceGlobal.h"
 #include "llvm/SYCLLowerIR/SpecConstants.h"
@@ -46,11 +51,15 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/LineIterator.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/PropertySetIO.h"
 #include "llvm/Support/SimpleTable.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/SystemUtils.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Transforms/IPO/AlwaysInliner.h"
 #include "llvm/Transforms/IPO/StripDeadPrototypes.h"
@@ -62,7 +71,10 @@
 #include "llvm/Transforms/Utils/GlobalStatus.h"
 
 #include <algorithm>
+#include <deque>
+#include <future>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -191,7 +203,10 @@ cl::opt<module_split::IRSplitMode> SplitMode(
                clEnumValN(module_split::SPLIT_PER_KERNEL, "kernel",
                           "1 output module per kernel"),
                clEnumValN(module_split::SPLIT_AUTO, "auto",
-                          "Choose split mode automatically")),
+                          "Choose split mode automatically"),
+               clEnumValN(module_split::SPLIT_BY_SIZE, "size",
+                          "Output modules of kernels sharing code, up to "
+                          "-split-target-size instructions")),
     cl::cat(PostLinkCat));
 
 cl::opt<bool> DoSymGen{"symbols", cl::desc("generate exported symbol files"),
@@ -251,6 +266,27 @@ cl::opt<bool> GenerateDeviceImageWithDefaultSpecConsts{
              "replaced with default values from specialization id(s)."),
     cl::cat(PostLinkCat)};
 
+cl::opt<unsigned> NumThreads{
+    "j", cl::Prefix,
+    cl::desc("Number of threads processing the modules resulting from the "
+             "split, 0 to use all the hardware threads (default 1)"),
+    cl::init(1), cl::cat(PostLinkCat)};
+
+cl::opt<std::string> KernelProfile{
+    "kernel-profile",
+    cl::desc("File naming the kernels used by a profiled run, one per line, "
+             "as written by the SYCL runtime under SYCL_KERNEL_PROFILE. With "
+             "the per-source and size-based splits, these kernels are grouped "
+             "into primary device images apart from the other kernels"),
+    cl::value_desc("filename"), cl::cat(PostLinkCat)};
+
+cl::opt<bool> OutputBundle{
+    "bundle",
+    cl::desc("Write each output file as a series of offload binaries, one for "
+             "each module, holding its IR, properties and symbols, instead of "
+             "a file table listing separate files"),
+    cl::cat(PostLinkCat)};
+
 struct IrPropSymFilenameTriple {
   std::string Ir;
   std::string Prop;
@@ -280,11 +316,7 @@ std::string makeResultFileName(Twine Ext, int I, StringRef Suffix) {
       .str();
 }
 
-void saveModuleIR(Module &M, StringRef OutFilename) {
-  std::error_code EC;
-  raw_fd_ostream Out{OutFilename, EC, sys::fs::OF_None};
-  checkError(EC, "error opening the file '" + OutFilename + "'");
-
+void writeModuleIR(Module &M, raw_ostream &Out) {
   ModulePassManager MPM;
   ModuleAnalysisManager MAM;
   PassBuilder PB;
@@ -296,44 +328,48 @@ void saveModuleIR(Module &M, StringRef OutFilename) {
   MPM.run(M, MAM);
 }
 
-std::string saveModuleIR(Module &M, int I, StringRef Suff) {
-  DUMP_ENTRY_POINTS(M, EmitOnlyKernelsAsEntryPoints, "saving IR");
-  StringRef FileExt = (OutputAssembly) ? ".ll" : ".bc";
-  std::string OutFilename = makeResultFileName(FileExt, I, Suff);
-  saveModuleIR(M, OutFilename);
-  return OutFilename;
+void saveModuleIR(Module &M, StringRef OutFilename) {
+  std::error_code EC;
+  raw_fd_ostream Out{OutFilename, EC, sys::fs::OF_None};
+  checkError(EC, "error opening the file '" + OutFilename + "'");
+  writeModuleIR(M, Out);
 }
 
-std::string saveModuleProperties(module_split::ModuleDesc &MD,
-                                 const GlobalBinImageProps &GlobProps, int I,
-                                 StringRef Suff, StringRef Target = "") {
+// Contents of the files generated for a module. They are computed before the
+// sequential ID of the module, which their names are made of, is known, so
+// that the split modules can be processed in parallel.
+struct ModuleOutputs {
+  std::string Suffix;
+  // Filename of already available IR component. If not empty, IR is unused
+  // and this file name is recorded as such in the result.
+  std::string IRFilename;
+  std::string IR;
+  std::string Sym;
+  // Indexed like OutputFiles, std::nullopt for the targets which are not
+  // compatible with the module.
+  SmallVector<std::optional<std::string>, 1> Props;
+};
+
+// The result for an output file: the file table, or with -bundle the offload
+// binaries of the modules.
+struct OutputResult {
+  std::unique_ptr<util::SimpleTable> Table;
+  SmallString<0> Bundle;
+};
+
+std::string makeModuleProperties(module_split::ModuleDesc &MD,
+                                 const GlobalBinImageProps &GlobProps,
+                                 StringRef Target) {
   auto PropSet =
       computeModuleProperties(MD.getModule(), MD.entries(), GlobProps);
-
-  std::string NewSuff = Suff.str();
-  if (!Target.empty()) {
+  if (!Target.empty())
     PropSet.add(PropSetRegTy::SYCL_DEVICE_REQUIREMENTS, "compile_target",
                 Target);
-    NewSuff += "_";
-    NewSuff += Target;
-  }
-
-  std::error_code EC;
-  std::string SCFile = makeResultFileName(".prop", I, NewSuff);
-  raw_fd_ostream SCOut(SCFile, EC);
-  checkError(EC, "error opening file '" + SCFile + "'");
-  PropSet.write(SCOut);
-
-  return SCFile;
-}
 
-// Saves specified collection of symbols to a file.
-std::string saveModuleSymbolTable(const module_split::ModuleDesc &MD, int I,
-                                  StringRef Suffix) {
-  auto SymT = computeModuleSymbolTable(MD.getModule(), MD.entries());
-  std::string OutFileName = makeResultFileName(".sym", I, Suffix);
-  writeToFile(OutFileName, SymT);
-  return OutFileName;
+  std::string Props;
+  raw_string_ostream Out(Props);
+  PropSet.write(Out);
+  return Props;
 }
 
 template <class PassClass> bool runModulePass(Module &M) {
@@ -410,40 +446,105 @@ bool isTargetCompatibleWithModule(const std::string &Target,
 void addTableRow(util::SimpleTable &Table,
                  const IrPropSymFilenameTriple &RowData);
 
-// @param OutTables List of tables (one for each target) to output results
 // @param MD Module descriptor to save
 // @param IRFilename filename of already available IR component. If not empty,
 //   IR component saving is skipped, and this file name is recorded as such in
 //   the result.
-void saveModule(std::vector<std::unique_ptr<util::SimpleTable>> &OutTables,
-                module_split::ModuleDesc &MD, int I, StringRef IRFilename) {
-  IrPropSymFilenameTriple BaseTriple;
-  StringRef Suffix = getModuleSuffix(MD);
+ModuleOutputs computeModuleOutputs(module_split::ModuleDesc &MD,
+                                   StringRef IRFilename) {
+  ModuleOutputs Outputs;
+  Outputs.Suffix = getModuleSuffix(MD).str();
   MD.saveSplitInformationAsMetadata();
   if (!IRFilename.empty()) {
     // don't save IR, just record the filename
-    BaseTriple.Ir = IRFilename.str();
+    Outputs.IRFilename = IRFilename.str();
   } else {
     MD.cleanup();
-    BaseTriple.Ir = saveModuleIR(MD.getModule(), I, Suffix);
+    DUMP_ENTRY_POINTS(MD.getModule(), EmitOnlyKernelsAsEntryPoints,
+                      "saving IR");
+    raw_string_ostream Out(Outputs.IR);
+    writeModuleIR(MD.getModule(), Out);
+  }
+  if (DoSymGen) {
+    // the names of the entry points - the symbol table
+    Outputs.Sym = computeModuleSymbolTable(MD.getModule(), MD.entries());
+  }
+
+  for (const auto &OutputFile : OutputFiles) {
+    if (!isTargetCompatibleWithModule(OutputFile.Target, MD)) {
+      Outputs.Props.push_back(std::nullopt);
+      continue;
+    }
+    std::string Props;
+    if (DoPropGen) {
+      GlobalBinImageProps GlobProps = {EmitKernelParamInfo, EmitProgramMetadata,
+                                       EmitExportedSymbols, EmitImportedSymbols,
+                                       DeviceGlobals};
+      Props = makeModuleProperties(MD, GlobProps, OutputFile.Target);
+    }
+    Outputs.Props.push_back(std::move(Props));
+  }
+  return Outputs;
+}
+
+// The properties and the symbols are stored under the names of the columns
+// of the file table, the IR being the image.
+SmallString<0> makeOffloadBinary(const ModuleOutputs &Outputs,
+                                 StringRef Props) {
+  object::OffloadBinary::OffloadingImage Image;
+  Image.TheImageKind = OutputAssembly ? object::IMG_None : object::IMG_Bitcode;
+  Image.TheOffloadKind = object::OFK_SYCL;
+  Image.Flags = 0;
+  if (DoPropGen)
+    Image.StringData[COL_PROPS] = Props;
+  if (DoSymGen)
+    Image.StringData[COL_SYM] = Outputs.Sym;
+  Image.Image = MemoryBuffer::getMemBuffer(Outputs.IR, "",
+                                           /*RequiresNullTerminator=*/false);
+  return object::OffloadBinary::write(Image);
+}
+
+// @param OutResults List of results (one for each target) to output results
+// @param Outputs Contents of the files to save
+// @param I Sequential ID of the module used in the file names
+void saveModule(std::vector<OutputResult> &OutResults,
+                const ModuleOutputs &Outputs, int I) {
+  if (OutputBundle) {
+    for (const auto &[Result, Props] : zip_equal(OutResults, Outputs.Props))
+      if (Props)
+        Result.Bundle += makeOffloadBinary(Outputs, *Props);
+    return;
+  }
+
+  IrPropSymFilenameTriple BaseTriple;
+  StringRef Suffix = Outputs.Suffix;
+  if (!Outputs.IRFilename.empty()) {
+    BaseTriple.Ir = Outputs.IRFilename;
+  } else {
+    StringRef FileExt = (OutputAssembly) ? ".ll" : ".bc";
+    BaseTriple.Ir = makeResultFileName(FileExt, I, Suffix);
+    writeToFile(BaseTriple.Ir, Outputs.IR);
   }
   if (DoSymGen) {
-    // save the names of the entry points - the symbol table
-    BaseTriple.Sym = saveModuleSymbolTable(MD, I, Suffix);
+    BaseTriple.Sym = makeResultFileName(".sym", I, Suffix);
+    writeToFile(BaseTriple.Sym, Outputs.Sym);
   }
 
-  for (const auto &[Table, OutputFile] : zip_equal(OutTables, OutputFiles)) {
-    if (!isTargetCompatibleWithModule(OutputFile.Target, MD))
+  for (const auto &[Result, OutputFile, Props] :
+       zip_equal(OutResults, OutputFiles, Outputs.Props)) {
+    if (!Props)
       continue;
     auto CopyTriple = BaseTriple;
     if (DoPropGen) {
-      GlobalBinImageProps Props = {EmitKernelParamInfo, EmitProgramMetadata,
-                                   EmitExportedSymbols, EmitImportedSymbols,
-                                   DeviceGlobals};
-      CopyTriple.Prop =
-          saveModuleProperties(MD, Props, I, Suffix, OutputFile.Target);
+      std::string NewSuff = Suffix.str();
+      if (!OutputFile.Target.empty()) {
+        NewSuff += "_";
+        NewSuff += OutputFile.Target;
+      }
+      CopyTriple.Prop = makeResultFileName(".prop", I, NewSuff);
+      writeToFile(CopyTriple.Prop, *Props);
     }
-    addTableRow(*Table, CopyTriple);
+    addTableRow(*Result.Table, CopyTriple);
   }
 }
 
@@ -487,6 +588,8 @@ bool processSpecConstants(module_split::ModuleDesc &MD) {
 
 /// Function generates the copy of the given ModuleDesc where all uses of
 /// Specialization Constants are replaced by corresponding default values.
+/// Only the kernels using Specialization Constants are copied, the other ones
+/// are the same in both images and are only kept in the original one.
 /// If the Module in MD doesn't contain specialization constants then
 /// std::nullopt is returned.
 std::optional<module_split::ModuleDesc>
@@ -495,8 +598,22 @@ processSpecConstantsWithDefaultValues(const module_split::ModuleDesc &MD) {
   if (!checkModuleContainsSpecConsts(MD.getModule()))
     return NewModuleDesc;
 
-  NewModuleDesc = MD.clone();
+  std::optional<SmallPtrSet<const Function *, 8>> Kernels =
+      collectKernelsUsingSpecConsts(MD.getModule());
+  if (Kernels && Kernels->empty())
+    return NewModuleDesc;
+
+  NewModuleDesc = MD.clone([&](const GlobalValue *GV) {
+    const auto *F = dyn_cast<Function>(GV);
+    return !Kernels || !F || F->getCallingConv() != CallingConv::SPIR_KERNEL ||
+           Kernels->contains(F);
+  });
   NewModuleDesc->setSpecConstantDefault(true);
+  // The kernels which have not been copied are left as declarations.
+  for (Function &F : make_early_inc_range(NewModuleDesc->getModule()))
+    if (F.getCallingConv() == CallingConv::SPIR_KERNEL && F.isDeclaration() &&
+        F.use_empty())
+      F.eraseFromParent();
 
   ModulePassManager MPM;
   ModuleAnalysisManager MAM;
@@ -741,8 +858,149 @@ bool isTargetCompatibleWithModule(const std::string &Target,
   return true;
 }
 
-std::vector<std::unique_ptr<util::SimpleTable>>
-processInputModule(std::unique_ptr<Module> M) {
+// Outputs of the modules a split resulted in, once they have been processed.
+struct SplitOutputs {
+  SmallVector<ModuleOutputs, 2> Modules;
+  // Copies of the modules with the specialization constants replaced by their
+  // default values.
+  SmallVector<ModuleOutputs, 2> ModulesWithDefaultSpecConsts;
+  // Whether the IR has been modified or split once the split was processed.
+  bool Modified = false;
+  bool SplitOccurred = false;
+};
+
+// Runs the transformations on a module resulting from the split and computes
+// the contents of the files generated for it.
+// @param Modified Whether the IR has been modified so far, is updated.
+// @param SplitOccurred Whether the IR has been split so far, is updated.
+SplitOutputs processSplit(module_split::ModuleDesc &&MDesc, bool &Modified,
+                          bool &SplitOccurred) {
+  SplitOutputs Outputs;
+
+  SmallVector<module_split::ModuleDesc, 2> MMs =
+      handleESIMD(std::move(MDesc), Modified, SplitOccurred);
+  assert(MMs.size() && "at least one module is expected after ESIMD split");
+
+  SmallVector<module_split::ModuleDesc, 2> MMsWithDefaultSpecConsts;
+  for (size_t I = 0; I != MMs.size(); ++I) {
+    // The kernels of a split module have the same fp_accuracy property.
+    Modified |= selectSYCLMathAccuracy(MMs[I].getModule());
+
+    if (GenerateDeviceImageWithDefaultSpecConsts) {
+      std::optional<module_split::ModuleDesc> NewMD =
+          processSpecConstantsWithDefaultValues(MMs[I]);
+      if (NewMD)
+        MMsWithDefaultSpecConsts.push_back(std::move(*NewMD));
+    }
+
+    Modified |= processSpecConstants(MMs[I]);
+  }
+
+  if (IROutputOnly) {
+    if (SplitOccurred) {
+      error("some modules had to be split, '-" + IROutputOnly.ArgStr +
+            "' can't be used");
+    }
+    MMs.front().cleanup();
+    saveModuleIR(MMs.front().getModule(), OutputFiles[0].Filename);
+    return Outputs;
+  }
+  // Empty IR file name directs saveModule to generate one and save IR to
+  // it:
+  std::string OutIRFileName = "";
+
+  if (!Modified && (OutputFiles.getNumOccurrences() == 0) && !OutputBundle) {
+    assert(!SplitOccurred);
+    OutIRFileName = InputFilename; // ... non-empty means "skip IR writing"
+    errs() << "sycl-post-link NOTE: no modifications to the input LLVM IR "
+              "have been made\n";
+  }
+  for (module_split::ModuleDesc &IrMD : MMs)
+    Outputs.Modules.push_back(computeModuleOutputs(IrMD, OutIRFileName));
+  for (module_split::ModuleDesc &IrMD : MMsWithDefaultSpecConsts)
+    Outputs.ModulesWithDefaultSpecConsts.push_back(
+        computeModuleOutputs(IrMD, OutIRFileName));
+
+  Outputs.Modified = Modified;
+  Outputs.SplitOccurred = SplitOccurred;
+  return Outputs;
+}
+
+// Saves the outputs of a split, incrementing ID for each image of the split.
+void saveSplit(std::vector<OutputResult> &Results, const SplitOutputs &Outputs,
+               int &ID) {
+  for (const ModuleOutputs &MO : Outputs.Modules)
+    saveModule(Results, MO, ID);
+
+  ++ID;
+
+  if (!Outputs.ModulesWithDefaultSpecConsts.empty()) {
+    for (const ModuleOutputs &MO : Outputs.ModulesWithDefaultSpecConsts)
+      saveModule(Results, MO, ID);
+
+    ++ID;
+  }
+}
+
+// A module resulting from the split serialized to bitcode, so that it can be
+// processed in another LLVMContext.
+class SerializedSplit {
+public:
+  SerializedSplit(module_split::ModuleDesc &&MD)
+      : Name(MD.Name), GroupId(MD.getEntryPointGroup().GroupId),
+        GroupProps(MD.getEntryPointGroup().Props), Props(MD.Props) {
+    MD.saveEntryPointNames(EntryPointNames);
+    raw_svector_ostream Out(Bitcode);
+    WriteBitcodeToFile(MD.getModule(), Out);
+  }
+
+  module_split::ModuleDesc deserialize(LLVMContext &Context) const {
+    Expected<std::unique_ptr<Module>> M = parseBitcodeFile(
+        MemoryBufferRef(StringRef(Bitcode.data(), Bitcode.size()), Name),
+        Context);
+    CHECK_AND_EXIT(M.takeError());
+    module_split::EntryPointGroup Group(GroupId, module_split::EntryPointSet{},
+                                        GroupProps);
+    module_split::ModuleDesc MD(std::move(*M), std::move(Group), Props);
+    MD.Name = Name;
+    MD.rebuildEntryPoints(EntryPointNames);
+    return MD;
+  }
+
+private:
+  SmallVector<char, 0> Bitcode;
+  std::string Name;
+  std::string GroupId;
+  module_split::EntryPointGroup::Properties GroupProps;
+  module_split::ModuleDesc::Properties Props;
+  std::vector<std::string> EntryPointNames;
+};
+
+// Marks the kernels named by the kernel profile as hot, for the split to
+// group them together.
+bool markHotKernels(Module &M) {
+  if (KernelProfile.empty())
+    return false;
+
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MBOrErr =
+      MemoryBuffer::getFile(KernelProfile);
+  checkError(MBOrErr.getError(),
+             "error reading the kernel profile '" + KernelProfile + "'");
+  StringSet<> HotKernels;
+  for (line_iterator LI(**MBOrErr); !LI.is_at_eof(); ++LI)
+    HotKernels.insert(LI->trim());
+
+  bool Modified = false;
+  for (Function &F : M)
+    if (F.getCallingConv() == CallingConv::SPIR_KERNEL &&
+        HotKernels.contains(F.getName())) {
+      F.addFnAttr(sycl::utils::ATTR_SYCL_HOT_KERNEL);
+      Modified = true;
+    }
+  return Modified;
+}
+
+std::vector<OutputResult> processInputModule(std::unique_ptr<Module> M) {
   // Construct the resulting table which will accumulate all the outputs.
   SmallVector<StringRef, MAX_COLUMNS_IN_FILE_TABLE> ColumnTitles{
       StringRef(COL_CODE)};
@@ -756,12 +1014,12 @@ processInputModule(std::unique_ptr<Module> M) {
   Expected<std::unique_ptr<util::SimpleTable>> TableE =
       util::SimpleTable::create(ColumnTitles);
   CHECK_AND_EXIT(TableE.takeError());
-  std::vector<std::unique_ptr<util::SimpleTable>> Tables;
-  for (size_t i = 0; i < OutputFiles.size(); ++i) {
+  std::vector<OutputResult> Results(OutputFiles.size());
+  for (OutputResult &Result : Results) {
     Expected<std::unique_ptr<util::SimpleTable>> TableE =
         util::SimpleTable::create(ColumnTitles);
     CHECK_AND_EXIT(TableE.takeError());
-    Tables.push_back(std::move(TableE.get()));
+    Result.Table = std::move(TableE.get());
   }
 
   // Used in output filenames generation.
@@ -811,6 +1069,8 @@ processInputModule(std::unique_ptr<Module> M) {
   }
   Modified |= InvokeSimdMet;
 
+  Modified |= markHotKernels(*M);
+
   DUMP_ENTRY_POINTS(*M, EmitOnlyKernelsAsEntryPoints, "Input");
 
   // -ir-output-only assumes single module output thus no code splitting.
@@ -838,63 +1098,52 @@ processInputModule(std::unique_ptr<Module> M) {
   // It is important that we *DO NOT* preserve all the splits in memory at the
   // same time, because it leads to a huge RAM consumption by the tool on bigger
   // inputs.
+  if (NumThreads == 1 || IROutputOnly) {
+    while (Splitter->hasMoreSplits()) {
+      module_split::ModuleDesc MDesc = Splitter->nextSplit();
+      DUMP_ENTRY_POINTS(MDesc.entries(), MDesc.Name.c_str(), 1);
+
+      MDesc.fixupLinkageOfDirectInvokeSimdTargets();
+      SplitOutputs Outputs =
+          processSplit(std::move(MDesc), Modified, SplitOccurred);
+      if (IROutputOnly)
+        return Results;
+      saveSplit(Results, Outputs, ID);
+    }
+    return Results;
+  }
+
+  // LLVMContext is not thread safe, so each split is moved to a context of
+  // its own to be processed on a worker thread. The outputs are saved in the
+  // order of the splits, which makes them independent of the scheduling, and
+  // the number of splits in flight is bounded to bound the memory usage.
+  DefaultThreadPool Pool(hardware_concurrency(NumThreads));
+  const size_t MaxSplitsInFlight = 2 * Pool.getMaxConcurrency();
+  std::deque<std::shared_future<SplitOutputs>> InFlight;
+  auto SaveFirstSplit = [&]() {
+    const SplitOutputs &Outputs = InFlight.front().get();
+    Modified |= Outputs.Modified;
+    SplitOccurred |= Outputs.SplitOccurred;
+    saveSplit(Results, Outputs, ID);
+    InFlight.pop_front();
+  };
   while (Splitter->hasMoreSplits()) {
     module_split::ModuleDesc MDesc = Splitter->nextSplit();
     DUMP_ENTRY_POINTS(MDesc.entries(), MDesc.Name.c_str(), 1);
 
     MDesc.fixupLinkageOfDirectInvokeSimdTargets();
-
-    SmallVector<module_split::ModuleDesc, 2> MMs =
-        handleESIMD(std::move(MDesc), Modified, SplitOccurred);
-    assert(MMs.size() && "at least one module is expected after ESIMD split");
-
-    SmallVector<module_split::ModuleDesc, 2> MMsWithDefaultSpecConsts;
-    for (size_t I = 0; I != MMs.size(); ++I) {
-      if (GenerateDeviceImageWithDefaultSpecConsts) {
-        std::optional<module_split::ModuleDesc> NewMD =
-            processSpecConstantsWithDefaultValues(MMs[I]);
-        if (NewMD)
-          MMsWithDefaultSpecConsts.push_back(std::move(*NewMD));
-      }
-
-      Modified |= processSpecConstants(MMs[I]);
-    }
-
-    if (IROutputOnly) {
-      if (SplitOccurred) {
-        error("some modules had to be split, '-" + IROutputOnly.ArgStr +
-              "' can't be used");
-      }
-      MMs.front().cleanup();
-      saveModuleIR(MMs.front().getModule(), OutputFiles[0].Filename);
-      return Tables;
-    }
-    // Empty IR file name directs saveModule to generate one and save IR to
-    // it:
-    std::string OutIRFileName = "";
-
-    if (!Modified && (OutputFiles.getNumOccurrences() == 0)) {
-      assert(!SplitOccurred);
-      OutIRFileName = InputFilename; // ... non-empty means "skip IR writing"
-      errs() << "sycl-post-link NOTE: no modifications to the input LLVM IR "
-                "have been made\n";
-    }
-    for (module_split::ModuleDesc &IrMD : MMs) {
-      saveModule(Tables, IrMD, ID, OutIRFileName);
-    }
-
-    ++ID;
-
-    if (!MMsWithDefaultSpecConsts.empty()) {
-      for (size_t i = 0; i != MMsWithDefaultSpecConsts.size(); ++i) {
-        module_split::ModuleDesc &IrMD = MMsWithDefaultSpecConsts[i];
-        saveModule(Tables, IrMD, ID, OutIRFileName);
-      }
-
-      ++ID;
-    }
+    auto Split = std::make_shared<SerializedSplit>(std::move(MDesc));
+    InFlight.push_back(Pool.async([Split, Modified, SplitOccurred]() mutable {
+      LLVMContext Context;
+      return processSplit(Split->deserialize(Context), Modified,
+                          SplitOccurred);
+    }));
+    while (InFlight.size() > MaxSplitsInFlight)
+      SaveFirstSplit();
   }
-  return Tables;
+  while (!InFlight.empty())
+    SaveFirstSplit();
+  return Results;
 }
 
 } // namespace
@@ -953,7 +1202,13 @@ int main(int argc, char **argv) {
       "will produce single output file example_p.bc suitable for SPIRV\n"
       "translation.\n"
       "--ir-output-only option is not not compatible with split modes other\n"
-      "than 'auto'.\n");
+      "than 'auto'.\n"
+      "The modules resulting from the split are processed in parallel when\n"
+      "-j<N> is specified, the output being the same as with one thread.\n"
+      "With -bundle, the output file is a series of offload binaries\n"
+      "instead of a file table, the image of each holding the IR of a\n"
+      "module, its 'Properties' and 'Symbols' strings the contents of the\n"
+      "files the table would list. No other file is written.\n");
 
   bool DoSplit = SplitMode.getNumOccurrences() > 0;
   bool DoSplitEsimd = SplitEsimd.getNumOccurrences() > 0;
@@ -1013,6 +1268,11 @@ int main(int argc, char **argv) {
            << " -" << IROutputOnly.ArgStr << "\n";
     return 1;
   }
+  if (IROutputOnly && OutputBundle) {
+    errs() << "error: -" << OutputBundle.ArgStr << " can't be used with -"
+           << IROutputOnly.ArgStr << "\n";
+    return 1;
+  }
   if (IROutputOnly && DoGenerateDeviceImageWithDefaulValues) {
     errs() << "error: -" << GenerateDeviceImageWithDefaultSpecConsts.ArgStr
            << " can't be used with -" << IROutputOnly.ArgStr << "\n";
@@ -1036,19 +1296,21 @@ int main(int argc, char **argv) {
     OutputFiles.push_back({{}, (sys::path::stem(InputFilename) + S).str()});
   }
 
-  std::vector<std::unique_ptr<util::SimpleTable>> Tables =
-      processInputModule(std::move(M));
+  std::vector<OutputResult> Results = processInputModule(std::move(M));
 
   // Input module was processed and a single output file was requested.
   if (IROutputOnly)
     return 0;
 
-  // Emit the resulting tables
-  for (const auto &[Table, OutputFile] : zip_equal(Tables, OutputFiles)) {
+  // Emit the resulting tables or bundles
+  for (const auto &[Result, OutputFile] : zip_equal(Results, OutputFiles)) {
     std::error_code EC;
     raw_fd_ostream Out{OutputFile.Filename, EC, sys::fs::OF_None};
     checkError(EC, "error opening file '" + OutputFile.Filename + "'");
-    Table->write(Out);
+    if (OutputBundle)
+      Out << Result.Bundle;
+    else
+      Result.Table->write(Out);
   }
 
   return 0;
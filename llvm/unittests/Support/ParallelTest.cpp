@@ -108,7 +108,7 @@ TEST(Parallel, TaskGroupSequentialFor) {
 TEST(Parallel, NestedTaskGroup) {
   // This test checks:
   // 1. Root TaskGroup is in Parallel mode.
-  // 2. Nested TaskGroup is not in Parallel mode.
+  // 2. Nested TaskGroup is in Parallel mode too.
   parallel::TaskGroup tg;
 
   tg.spawn([&]() {
@@ -117,15 +117,17 @@ TEST(Parallel, NestedTaskGroup) {
 
   tg.spawn([&]() {
     parallel::TaskGroup nestedTG;
-    EXPECT_FALSE(nestedTG.isParallel());
+    EXPECT_TRUE(nestedTG.isParallel() ||
+                (parallel::strategy.ThreadsRequested == 1));
 
     nestedTG.spawn([&]() {
       // Check that root TaskGroup is in Parallel mode.
       EXPECT_TRUE(tg.isParallel() ||
                   (parallel::strategy.ThreadsRequested == 1));
 
-      // Check that nested TaskGroup is not in Parallel mode.
-      EXPECT_FALSE(nestedTG.isParallel());
+      // Check that nested TaskGroup is in Parallel mode.
+      EXPECT_TRUE(nestedTG.isParallel() ||
+                  (parallel::strategy.ThreadsRequested == 1));
     });
   });
 }
@@ -144,9 +146,10 @@ TEST(Parallel, ParallelNestedTaskGroup) {
         EXPECT_TRUE(tg.isParallel() ||
                     (parallel::strategy.ThreadsRequested == 1));
 
-        // Check that nested TaskGroup is not in Parallel mode.
+        // Check that nested TaskGroup is in Parallel mode.
         parallel::TaskGroup nestedTG;
-        EXPECT_FALSE(nestedTG.isParallel());
+        EXPECT_TRUE(nestedTG.isParallel() ||
+                    (parallel::strategy.ThreadsRequested == 1));
         ++Count;
 
         nestedTG.spawn([&]() {
@@ -154,8 +157,9 @@ TEST(Parallel, ParallelNestedTaskGroup) {
           EXPECT_TRUE(tg.isParallel() ||
                       (parallel::strategy.ThreadsRequested == 1));
 
-          // Check that nested TaskGroup is not in Parallel mode.
-          EXPECT_FALSE(nestedTG.isParallel());
+          // Check that nested TaskGroup is in Parallel mode.
+          EXPECT_TRUE(nestedTG.isParallel() ||
+                      (parallel::strategy.ThreadsRequested == 1));
           ++Count;
         });
       });
@@ -174,6 +178,21 @@ TEST(Parallel, ParallelNestedTaskGroup) {
   }
   EXPECT_EQ(Count, 12ul);
 }
+
+TEST(Parallel, DeeplyNestedParallelFor) {
+  // This test checks that nested parallelFor calls, more deeply nested than
+  // there are threads, complete while the workers wait for each other.
+  std::atomic<size_t> Count{0};
+  std::function<void(unsigned)> Fn = [&](unsigned Depth) {
+    if (Depth == 0) {
+      ++Count;
+      return;
+    }
+    parallelFor(0, 4, [&](size_t) { Fn(Depth - 1); });
+  };
+  Fn(6);
+  EXPECT_EQ(Count, 4096ul);
+}
 #endif
 
 #endif
@@ -65,6 +65,27 @@ TEST(TimeProfiler, Async_Begin_End_Smoke) {
   ASSERT_TRUE(json.find(R"("detail":"detail")") != std::string::npos);
 }
 
+TEST(TimeProfiler, Summary_Smoke) {
+  timeTraceProfilerInitialize(/*TimeTraceGranularity=*/0, "test",
+                              /*TimeTraceVerbose=*/false,
+                              /*TimeTraceSummary=*/true);
+
+  {
+    TimeTraceScope scope("event", "detail");
+    TimeTraceScope nested("event", "detail");
+  }
+  { TimeTraceScope scope("event", "detail"); }
+  timeTraceProfilerEnd(timeTraceAsyncProfilerBegin("async", "detail"));
+
+  std::string json = teardownProfiler();
+  // Only the totals are written, and the nested section isn't counted.
+  ASSERT_TRUE(json.find(R"("name":"Total event")") != std::string::npos);
+  ASSERT_TRUE(json.find(R"("count":2)") != std::string::npos);
+  ASSERT_TRUE(json.find(R"("name":"event")") == std::string::npos);
+  ASSERT_TRUE(json.find(R"("detail")") == std::string::npos);
+  ASSERT_TRUE(json.find(R"(async)") == std::string::npos);
+}
+
 TEST(TimeProfiler, Begin_End_Disabled) {
   // Nothing should be observable here. The test is really just making sure
   // we've not got a stray nullptr deref.
@@ -34,6 +34,7 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
 #include "mlir/Dialect/GPU/Transforms/Passes.h"
+#include "mlir/Dialect/GPU/Transforms/Utils.h"
 #include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Dialect/LLVMIR/ROCDLDialect.h"
 #include "mlir/Dialect/Math/IR/Math.h"
@@ -191,6 +192,86 @@ struct GPUShuffleOpLowering : public ConvertOpToLLVMPattern<gpu::ShuffleOp> {
   }
 };
 
+/// Lowers 32-bit scalar subgroup reductions to a reduction tree of DPP row
+/// operations, which exchange values between the lanes of each row of 16 lanes
+/// without going through LDS like ds_bpermute shuffles:
+///
+///   quad_perm [1, 0, 3, 2]  reduces clusters of 2 lanes,
+///   quad_perm [2, 3, 0, 1]  reduces clusters of 4 lanes,
+///   row_half_mirror         reduces clusters of 8 lanes,
+///   row_mirror              reduces clusters of 16 lanes.
+///
+/// The larger clusters are then reduced with shuffles across the rows. Whole
+/// subgroup reductions need the wave size, which is only known to be 64 on
+/// gfx9. Like the shuffle lowering, this assumes all the lanes of the clusters
+/// are active.
+struct GPUSubgroupReduceOpToDPP
+    : public ConvertOpToLLVMPattern<gpu::SubgroupReduceOp> {
+  GPUSubgroupReduceOpToDPP(const LLVMTypeConverter &converter,
+                           amdgpu::Chipset chipset)
+      : ConvertOpToLLVMPattern<gpu::SubgroupReduceOp>(converter),
+        chipset(chipset) {}
+
+  LogicalResult
+  matchAndRewrite(gpu::SubgroupReduceOp op, OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    if (chipset.majorVersion < 9)
+      return rewriter.notifyMatchFailure(op, "DPP rows need gfx9 or later");
+    if (op.getClusterStride() != 1)
+      return rewriter.notifyMatchFailure(
+          op, "DPP rows only reduce contiguous clusters");
+
+    std::optional<uint32_t> clusterSize = op.getClusterSize();
+    if (!clusterSize) {
+      if (chipset.majorVersion != 9)
+        return rewriter.notifyMatchFailure(op, "wave size is not known");
+      clusterSize = 64;
+    }
+
+    Value value = adaptor.getValue();
+    Type type = value.getType();
+    if (!type.isInteger(32) && !type.isF32())
+      return rewriter.notifyMatchFailure(op, "value is not a 32-bit scalar");
+
+    // DPP control values of the row operations.
+    constexpr unsigned quadPermXor1 = 0xb1;
+    constexpr unsigned quadPermXor2 = 0x4e;
+    constexpr unsigned rowHalfMirror = 0x141;
+    constexpr unsigned rowMirror = 0x140;
+    constexpr unsigned allRowsAndBanks = 0xf;
+
+    Location loc = op.getLoc();
+    vector::CombiningKind kind = gpu::convertReductionKind(op.getOp());
+    Value result = value;
+    unsigned size = 2;
+    for (unsigned dppCtrl :
+         {quadPermXor1, quadPermXor2, rowHalfMirror, rowMirror}) {
+      if (size > *clusterSize)
+        break;
+      Value moved = rewriter.create<ROCDL::DPPUpdateOp>(
+          loc, type, result, result, dppCtrl, allRowsAndBanks,
+          allRowsAndBanks, /*boundCtrl=*/false);
+      result = vector::makeArithReduction(rewriter, loc, kind, result, moved);
+      size <<= 1;
+    }
+    for (unsigned offset = 16; offset < *clusterSize; offset <<= 1) {
+      Value shuffled = rewriter
+                           .create<gpu::ShuffleOp>(loc, result, offset,
+                                                   /*width=*/*clusterSize,
+                                                   gpu::ShuffleMode::XOR)
+                           .getShuffleResult();
+      result =
+          vector::makeArithReduction(rewriter, loc, kind, result, shuffled);
+    }
+
+    rewriter.replaceOp(op, result);
+    return success();
+  }
+
+private:
+  amdgpu::Chipset chipset;
+};
+
 /// Import the GPU Ops to ROCDL Patterns.
 #include "GPUToROCDL.cpp.inc"
 
@@ -296,6 +377,7 @@ struct LowerGpuOpsToROCDLOpsPass
     populateFuncToLLVMConversionPatterns(converter, llvmPatterns);
     populateFinalizeMemRefToLLVMConversionPatterns(converter, llvmPatterns);
     populateGpuToROCDLConversionPatterns(converter, llvmPatterns, runtime);
+    llvmPatterns.add<GPUSubgroupReduceOpToDPP>(converter, *maybeChipset);
     LLVMConversionTarget target(getContext());
     configureGpuToROCDLConversionLegality(target);
     if (failed(applyPartialConversion(m, target, std::move(llvmPatterns))))
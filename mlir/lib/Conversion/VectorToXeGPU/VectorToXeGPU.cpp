@@ -14,6 +14,7 @@
 
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
+#include "mlir/Dialect/Utils/StructuredOpsUtils.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/Dialect/XeGPU/IR/XeGPU.h"
 #include "mlir/Pass/Pass.h"
@@ -233,6 +234,57 @@ struct TransferWriteLowering
   }
 };
 
+// Lowers the contractions of a tile of a row-major matmul to DPAS, which
+// runs them on the XMX matrix engines. The operands keep their plain 2D
+// layout; the VNNI packing of the B operand is left to a later lowering.
+struct ContractionLowering : public OpRewritePattern<vector::ContractionOp> {
+  using OpRewritePattern<vector::ContractionOp>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(vector::ContractionOp contractOp,
+                                PatternRewriter &rewriter) const override {
+    Location loc = contractOp.getLoc();
+
+    if (contractOp.getKind() != vector::CombiningKind::ADD)
+      return rewriter.notifyMatchFailure(contractOp,
+                                         "Expects add combining kind");
+
+    Value acc = contractOp.getAcc();
+    auto accType = dyn_cast<VectorType>(acc.getType());
+    if (!accType || accType.getRank() != 2)
+      return rewriter.notifyMatchFailure(contractOp, "Expects 2D accumulator");
+
+    VectorType lhsTy = contractOp.getLhsType();
+    VectorType rhsTy = contractOp.getRhsType();
+    if (lhsTy.getRank() != 2 || rhsTy.getRank() != 2)
+      return rewriter.notifyMatchFailure(contractOp,
+                                         "Expects 2D lhs and rhs vectors");
+
+    if (!isRowMajorMatmul(contractOp.getIndexingMapsAttr()))
+      return rewriter.notifyMatchFailure(contractOp,
+                                         "Expects row-major matmul maps");
+
+    // DPAS multiplies 16 or 8 bit operands, accumulating in 32 bits.
+    Type elemTy = lhsTy.getElementType();
+    Type accElemTy = accType.getElementType();
+    if (elemTy != rhsTy.getElementType())
+      return rewriter.notifyMatchFailure(contractOp,
+                                         "Expects matching operand types");
+    bool isFloat = elemTy.isF16() || elemTy.isBF16();
+    bool isInt = elemTy.isInteger(8);
+    if (!(isFloat && accElemTy.isF32()) &&
+        !(isInt && accElemTy.isInteger(32)))
+      return rewriter.notifyMatchFailure(contractOp,
+                                         "Unsupported DPAS data types");
+
+    auto dpasOp = rewriter.create<xegpu::DpasOp>(
+        loc, TypeRange{contractOp.getResultType()},
+        ValueRange{contractOp.getLhs(), contractOp.getRhs(), acc});
+    rewriter.replaceOp(contractOp, dpasOp);
+
+    return success();
+  }
+};
+
 struct ConvertVectorToXeGPUPass
     : public impl::ConvertVectorToXeGPUBase<ConvertVectorToXeGPUPass> {
   void runOnOperation() override {
@@ -248,8 +300,8 @@ struct ConvertVectorToXeGPUPass
 
 void mlir::populateVectorToXeGPUConversionPatterns(
     RewritePatternSet &patterns) {
-  patterns.add<TransferReadLowering, TransferWriteLowering>(
-      patterns.getContext());
+  patterns.add<TransferReadLowering, TransferWriteLowering,
+               ContractionLowering>(patterns.getContext());
 }
 
 std::unique_ptr<Pass> mlir::createConvertVectorToXeGPUPass() {
@@ -47,8 +47,10 @@ using namespace mlir::gpu;
 /// Implement the MemoryEffectsOpInterface in the suitable way.
 static bool isKnownNoEffectsOpWithoutInterface(Operation *op) {
   // memref::AssumeAlignment is conceptually pure, but marking it as such would
-  // make DCE immediately remove it.
-  return isa<memref::AssumeAlignmentOp>(op);
+  // make DCE immediately remove it. gpu::SubgroupReduceOp only exchanges values
+  // between the work items of a subgroup, but it must not be speculated or
+  // removed since all the work items of the subgroup take part in it.
+  return isa<memref::AssumeAlignmentOp, SubgroupReduceOp>(op);
 }
 
 /// Returns `true` if the op is defines the parallel region that is subject to
@@ -323,10 +325,56 @@ static Value getBase(Value v) {
   return v;
 }
 
-/// Returns `true` if the value is defined as a function argument.
+/// Returns `true` if the value is defined as a function argument. The
+/// attributions of GPU functions are not arguments.
 static bool isFunctionArgument(Value v) {
   auto arg = dyn_cast<BlockArgument>(v);
-  return arg && isa<FunctionOpInterface>(arg.getOwner()->getParentOp());
+  if (!arg || !isa<FunctionOpInterface>(arg.getOwner()->getParentOp()))
+    return false;
+  if (auto gpuFunc = dyn_cast<GPUFuncOp>(arg.getOwner()->getParentOp()))
+    return arg.getArgNumber() < gpuFunc.getFirstWorkgroupAttributionIndex();
+  return true;
+}
+
+/// Returns `true` if the value is a workgroup attribution of a GPU function.
+/// Like allocations, the attributions are distinct from each other and from
+/// the arguments of the function.
+static bool isWorkgroupAttribution(Value v) {
+  auto arg = dyn_cast<BlockArgument>(v);
+  if (!arg)
+    return false;
+  auto gpuFunc = dyn_cast<GPUFuncOp>(arg.getOwner()->getParentOp());
+  return gpuFunc && llvm::is_contained(gpuFunc.getWorkgroupAttributions(), arg);
+}
+
+/// Returns `true` if the op is nested in a parallel region, so that each work
+/// item executes its own instance of the op.
+static bool isInParallelRegion(Operation *op) {
+  for (Operation *parent = op->getParentOp(); parent;
+       parent = parent->getParentOp())
+    if (isParallelRegionBoundary(parent))
+      return true;
+  return false;
+}
+
+/// Returns `true` if the value refers to memory private to each work item:
+/// a memref in the private address space, a private attribution, or a memref
+/// allocated on the stack of each work item. Other work items cannot access
+/// the memory, so the accesses to it never need a barrier.
+static bool isThreadPrivate(Value v) {
+  v = getBase(v);
+  auto type = dyn_cast<BaseMemRefType>(v.getType());
+  if (!type)
+    return false;
+  if (auto space = dyn_cast_or_null<AddressSpaceAttr>(type.getMemorySpace()))
+    return space.getValue() == GPUDialect::getPrivateAddressSpace();
+
+  if (auto arg = dyn_cast<BlockArgument>(v)) {
+    auto gpuFunc = dyn_cast<GPUFuncOp>(arg.getOwner()->getParentOp());
+    return gpuFunc && llvm::is_contained(gpuFunc.getPrivateAttributions(), arg);
+  }
+  auto alloca = v.getDefiningOp<memref::AllocaOp>();
+  return alloca && !type.getMemorySpace() && isInParallelRegion(alloca);
 }
 
 /// Returns the operand that the operation "propagates" through it for capture
@@ -453,8 +501,20 @@ static bool mayAlias(Value first, Value second) {
   if (isNoaliasFuncArgument(first) && isNoaliasFuncArgument(second))
     return false;
 
-  bool isDistinct[] = {producesDistinctBase(first.getDefiningOp()),
-                       producesDistinctBase(second.getDefiningOp())};
+  // Memrefs in different GPU address spaces do not alias.
+  auto getAddressSpace = [](Value value) -> AddressSpaceAttr {
+    auto type = dyn_cast<BaseMemRefType>(value.getType());
+    return type ? dyn_cast_or_null<AddressSpaceAttr>(type.getMemorySpace())
+                : nullptr;
+  };
+  AddressSpaceAttr spaces[] = {getAddressSpace(first), getAddressSpace(second)};
+  if (spaces[0] && spaces[1] && spaces[0] != spaces[1])
+    return false;
+
+  bool isDistinct[] = {producesDistinctBase(first.getDefiningOp()) ||
+                           isWorkgroupAttribution(first),
+                       producesDistinctBase(second.getDefiningOp()) ||
+                           isWorkgroupAttribution(second)};
   bool isGlobal[] = {first.getDefiningOp<memref::GetGlobalOp>() != nullptr,
                      second.getDefiningOp<memref::GetGlobalOp>() != nullptr};
 
@@ -524,6 +584,12 @@ haveConflictingEffects(ArrayRef<MemoryEffects::EffectInstance> beforeEffects,
       if (!mayAlias(before, after))
         continue;
 
+      // The memory private to each work item is not shared by the work items
+      // the barrier synchronizes.
+      if ((before.getValue() && isThreadPrivate(before.getValue())) ||
+          (after.getValue() && isThreadPrivate(after.getValue())))
+        continue;
+
       // Read/read is not a conflict.
       if (isa<MemoryEffects::Read>(before.getEffect()) &&
           isa<MemoryEffects::Read>(after.getEffect())) {
@@ -604,10 +670,10 @@ public:
 class GpuEliminateBarriersPass
     : public impl::GpuEliminateBarriersBase<GpuEliminateBarriersPass> {
   void runOnOperation() override {
-    auto funcOp = getOperation();
+    Operation *op = getOperation();
     RewritePatternSet patterns(&getContext());
     mlir::populateGpuEliminateBarriersPatterns(patterns);
-    if (failed(applyPatternsAndFoldGreedily(funcOp, std::move(patterns)))) {
+    if (failed(applyPatternsAndFoldGreedily(op, std::move(patterns)))) {
       return signalPassFailure();
     }
   }
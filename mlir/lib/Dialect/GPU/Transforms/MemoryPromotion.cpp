@@ -114,11 +114,12 @@ static void insertCopyLoops(ImplicitLocOpBuilder &b, Value from, Value to) {
 ///
 /// Inserts the barriers unconditionally since different threads may be copying
 /// values and reading them. An analysis would be required to eliminate barriers
-/// in case where value is only used by the thread that copies it. Both copies
-/// are inserted unconditionally, an analysis would be required to only copy
-/// live-in and live-out values when necessary. This copies the entire memref
-/// pointed to by "from". In case a smaller block would be sufficient, the
-/// caller can create a subview of the memref and promote it instead.
+/// in case where value is only used by the thread that copies it, the
+/// gpu-eliminate-barriers pass removes the ones no conflicting access needs.
+/// Both copies are inserted unconditionally, an analysis would be required to
+/// only copy live-in and live-out values when necessary. This copies the entire
+/// memref pointed to by "from". In case a smaller block would be sufficient,
+/// the caller can create a subview of the memref and promote it instead.
 static void insertCopies(Region &region, Location loc, Value from, Value to) {
   auto fromType = cast<MemRefType>(from.getType());
   auto toType = cast<MemRefType>(to.getType());
@@ -20,11 +20,15 @@
 #include "mlir/Dialect/LLVMIR/ROCDLDialect.h"
 #include "mlir/Dialect/SPIRV/IR/SPIRVDialect.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringSwitch.h"
 
+#include <deque>
+
 using namespace mlir;
 using namespace mlir::gpu;
 
@@ -78,29 +82,37 @@ void GpuModuleToBinaryPass::runOnOperation() {
 }
 
 namespace {
+/// The serialization of the GPU modules with a given body and attributes to
+/// one of their targets.
+struct SerializationJob {
+  GPUModuleOp module;
+  TargetAttrInterface target;
+  std::optional<SmallVector<char, 0>> object;
+};
+
+/// Returns the printed attributes, but the name, and body of `module`. The
+/// modules with the same fingerprint serialize to the same objects.
+std::string getModuleFingerprint(GPUModuleOp module) {
+  std::string fingerprint;
+  llvm::raw_string_ostream os(fingerprint);
+  for (NamedAttribute attr : module->getAttrs())
+    if (attr.getName() != SymbolTable::getSymbolAttrName())
+      os << attr.getName() << '=' << attr.getValue() << ';';
+  for (Operation &op : *module.getBody())
+    os << op << '\n';
+  return fingerprint;
+}
+
 LogicalResult moduleSerializer(GPUModuleOp op,
                                OffloadingLLVMTranslationAttrInterface handler,
-                               const TargetOptions &targetOptions) {
+                               const TargetOptions &targetOptions,
+                               ArrayRef<SerializationJob *> jobs) {
   OpBuilder builder(op->getContext());
   SmallVector<Attribute> objects;
-  // Fail if there are no target attributes
-  if (!op.getTargetsAttr())
-    return op.emitError("the module has no target attributes");
-  // Serialize all targets.
-  for (auto targetAttr : op.getTargetsAttr()) {
-    assert(targetAttr && "Target attribute cannot be null.");
-    auto target = dyn_cast<gpu::TargetAttrInterface>(targetAttr);
-    assert(target &&
-           "Target attribute doesn't implements `TargetAttrInterface`.");
-    std::optional<SmallVector<char, 0>> serializedModule =
-        target.serializeToObject(op, targetOptions);
-    if (!serializedModule) {
-      op.emitError("An error happened while serializing the module.");
-      return failure();
-    }
-
+  // Create the objects of all the targets.
+  for (SerializationJob *job : jobs) {
     Attribute object =
-        target.createObject(op, *serializedModule, targetOptions);
+        job->target.createObject(op, *job->object, targetOptions);
     if (!object) {
       op.emitError("An error happened while creating the object.");
       return failure();
@@ -123,11 +135,51 @@ LogicalResult moduleSerializer(GPUModuleOp op,
 LogicalResult mlir::gpu::transformGpuModulesToBinaries(
     Operation *op, OffloadingLLVMTranslationAttrInterface handler,
     const gpu::TargetOptions &targetOptions) {
+  SmallVector<GPUModuleOp> modules;
   for (Region &region : op->getRegions())
     for (Block &block : region.getBlocks())
-      for (auto module :
-           llvm::make_early_inc_range(block.getOps<GPUModuleOp>()))
-        if (failed(moduleSerializer(module, handler, targetOptions)))
-          return failure();
+      llvm::append_range(modules, block.getOps<GPUModuleOp>());
+  if (modules.empty())
+    return success();
+
+  // Collect the serializations to run, the modules with the same fingerprint
+  // being serialized once per target.
+  std::deque<SerializationJob> jobs;
+  llvm::StringMap<DenseMap<Attribute, SerializationJob *>> jobsByFingerprint;
+  SmallVector<SmallVector<SerializationJob *>> moduleJobs(modules.size());
+  for (auto [module, jobsOfModule] : llvm::zip_equal(modules, moduleJobs)) {
+    // Fail if there are no target attributes
+    if (!module.getTargetsAttr())
+      return module.emitError("the module has no target attributes");
+    DenseMap<Attribute, SerializationJob *> &targetJobs =
+        jobsByFingerprint[getModuleFingerprint(module)];
+    for (Attribute targetAttr : module.getTargetsAttr()) {
+      assert(targetAttr && "Target attribute cannot be null.");
+      auto target = dyn_cast<gpu::TargetAttrInterface>(targetAttr);
+      assert(target &&
+             "Target attribute doesn't implements `TargetAttrInterface`.");
+      SerializationJob *&job = targetJobs[targetAttr];
+      if (!job)
+        job = &jobs.emplace_back(SerializationJob{module, target, {}});
+      jobsOfModule.push_back(job);
+    }
+  }
+
+  // Serialize all the targets concurrently. The serializations only read the
+  // IR, the lazily built symbol table is built before they start.
+  (void)targetOptions.getSymbolTable();
+  auto serialize = [&](SerializationJob &job) -> LogicalResult {
+    job.object = job.target.serializeToObject(job.module, targetOptions);
+    if (!job.object)
+      return job.module.emitError(
+          "An error happened while serializing the module.");
+    return success();
+  };
+  if (failed(failableParallelForEach(op->getContext(), jobs, serialize)))
+    return failure();
+
+  for (auto [module, jobsOfModule] : llvm::zip_equal(modules, moduleJobs))
+    if (failed(moduleSerializer(module, handler, targetOptions, jobsOfModule)))
+      return failure();
   return success();
 }
@@ -148,11 +148,15 @@ static void launchKernel(sycl::queue *queue, sycl::kernel *kernel, size_t gridX,
 
 // Wrappers
 
+// The streams are in order, as the operations of a GPU stream, so that the
+// operations on the USM allocations submitted to a stream see the results of
+// the previous ones.
 extern "C" SYCL_RUNTIME_EXPORT sycl::queue *mgpuStreamCreate() {
 
   return catchAll([&]() {
     sycl::queue *queue =
-        new sycl::queue(getDefaultContext(), getDefaultDevice());
+        new sycl::queue(getDefaultContext(), getDefaultDevice(),
+                        sycl::property::queue::in_order());
     return queue;
   });
 }
@@ -163,7 +167,9 @@ extern "C" SYCL_RUNTIME_EXPORT void mgpuStreamDestroy(sycl::queue *queue) {
 
 extern "C" SYCL_RUNTIME_EXPORT void *
 mgpuMemAlloc(uint64_t size, sycl::queue *queue, bool isShared) {
-  return catchAll([&]() {
+  return catchAll([&]() -> void * {
+    if (size == 0)
+      return nullptr;
     return allocDeviceMemory(queue, static_cast<size_t>(size), true);
   });
 }
@@ -202,8 +208,267 @@ extern "C" SYCL_RUNTIME_EXPORT void mgpuStreamSynchronize(sycl::queue *queue) {
   catchAll([&]() { queue->wait(); });
 }
 
+extern "C" SYCL_RUNTIME_EXPORT void mgpuStreamWaitEvent(sycl::queue *queue,
+                                                       sycl::event *event) {
+  catchAll([&]() { queue->ext_oneapi_submit_barrier({*event}); });
+}
+
+// An event is the barrier of the stream it was last recorded on, the commands
+// submitted to the stream before the record are complete when it is.
+extern "C" SYCL_RUNTIME_EXPORT sycl::event *mgpuEventCreate() {
+  return catchAll([&]() { return new sycl::event(); });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuEventDestroy(sycl::event *event) {
+  catchAll([&]() { delete event; });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuEventSynchronize(sycl::event *event) {
+  catchAll([&]() { event->wait(); });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuEventRecord(sycl::event *event,
+                                                   sycl::queue *queue) {
+  catchAll([&]() { *event = queue->ext_oneapi_submit_barrier(); });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void
+mgpuMemcpy(void *dst, void *src, size_t sizeBytes, sycl::queue *queue) {
+  catchAll([&]() { queue->memcpy(dst, src, sizeBytes); });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void
+mgpuMemset32(void *dst, unsigned int value, size_t count, sycl::queue *queue) {
+  catchAll([&]() {
+    queue->fill(static_cast<uint32_t *>(dst), static_cast<uint32_t>(value),
+                count);
+  });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void
+mgpuMemset16(void *dst, unsigned short value, size_t count,
+             sycl::queue *queue) {
+  catchAll([&]() {
+    queue->fill(static_cast<uint16_t *>(dst), static_cast<uint16_t>(value),
+                count);
+  });
+}
+
 extern "C" SYCL_RUNTIME_EXPORT void
 mgpuModuleUnload(ze_module_handle_t module) {
 
   catchAll([&]() { L0_SAFE_CALL(zeModuleDestroy(module)); });
 }
+
+///
+/// Wrapper methods for the sparse operations of the GPU dialect.
+///
+/// There is no sparse library on the SYCL runtime, so the operations are
+/// implemented with SYCL kernels over the USM allocations of the default
+/// context. The type codes passed by the lowering are the cuSPARSE ones, and
+/// the results are computed with alpha = 1 and beta = 0, as the CUDA wrappers
+/// do. The values are f32 or f64 and the indices i32 or i64.
+///
+
+namespace {
+
+enum class SparseFormat { Coo, Csr };
+
+struct DnTensor {
+  intptr_t rows;
+  intptr_t cols;
+  void *values;
+  int32_t dtp;
+};
+
+struct SpMat {
+  SparseFormat format;
+  intptr_t rows;
+  intptr_t cols;
+  intptr_t nnz;
+  // The row indices of a COO matrix, the row positions of a CSR matrix.
+  void *rowData;
+  void *colIdxs;
+  void *values;
+  int32_t ptp;
+  int32_t itp;
+  int32_t dtp;
+};
+
+template <typename F>
+void dispatchIndexType(int32_t tp, F &&func) {
+  switch (tp) {
+  case 2: // CUSPARSE_INDEX_32I
+    return func(int32_t{});
+  case 3: // CUSPARSE_INDEX_64I
+    return func(int64_t{});
+  default:
+    throw std::runtime_error("unsupported sparse index type");
+  }
+}
+
+template <typename F>
+void dispatchValueType(int32_t tp, F &&func) {
+  switch (tp) {
+  case 0: // CUDA_R_32F
+    return func(float{});
+  case 1: // CUDA_R_64F
+    return func(double{});
+  default:
+    throw std::runtime_error("unsupported sparse value type");
+  }
+}
+
+template <typename V>
+void atomicAdd(V &dst, V val) {
+  sycl::atomic_ref<V, sycl::memory_order::relaxed, sycl::memory_scope::device,
+                   sycl::access::address_space::global_space>(dst)
+      .fetch_add(val);
+}
+
+} // namespace
+
+/// Computes c = op(a) * b, where b, in row-major order, has n columns. Each
+/// work-item computes one element of c when a is a non-transposed CSR matrix,
+/// otherwise c is zeroed and the products of each stored element of a are
+/// accumulated atomically.
+template <typename V, typename P, typename I>
+static void spmm(sycl::queue *queue, const SpMat &a, bool transA,
+                 const V *b, V *c, size_t n) {
+  size_t rows = a.rows, nnz = a.nnz;
+  const P *rowData = static_cast<const P *>(a.rowData);
+  const I *colIdxs = static_cast<const I *>(a.colIdxs);
+  const V *values = static_cast<const V *>(a.values);
+  if (a.format == SparseFormat::Csr && !transA) {
+    queue->parallel_for(sycl::range<2>(rows, n), [=](sycl::id<2> idx) {
+      size_t i = idx[0], j = idx[1];
+      V sum = 0;
+      for (P k = rowData[i]; k < rowData[i + 1]; ++k)
+        sum += values[k] * b[colIdxs[k] * n + j];
+      c[i * n + j] = sum;
+    });
+    return;
+  }
+  size_t outRows = transA ? a.cols : a.rows;
+  sycl::event zeroed = queue->fill(c, V{0}, outRows * n);
+  if (a.format == SparseFormat::Csr) {
+    queue->parallel_for(sycl::range<2>(rows, n), zeroed,
+                        [=](sycl::id<2> idx) {
+                          size_t i = idx[0], j = idx[1];
+                          for (P k = rowData[i]; k < rowData[i + 1]; ++k)
+                            atomicAdd(c[colIdxs[k] * n + j],
+                                      values[k] * b[i * n + j]);
+                        });
+    return;
+  }
+  queue->parallel_for(sycl::range<2>(nnz, n), zeroed, [=](sycl::id<2> idx) {
+    size_t k = idx[0], j = idx[1];
+    size_t row = rowData[k], col = colIdxs[k];
+    if (transA)
+      std::swap(row, col);
+    atomicAdd(c[row * n + j], values[k] * b[col * n + j]);
+  });
+}
+
+static void spmm(sycl::queue *queue, int32_t ma, const SpMat &a,
+                 const DnTensor &b, const DnTensor &c) {
+  if (a.dtp != b.dtp || a.dtp != c.dtp)
+    throw std::runtime_error("mixed sparse value types are not supported");
+  dispatchValueType(a.dtp, [&](auto v) {
+    using V = decltype(v);
+    int32_t ptp = a.format == SparseFormat::Csr ? a.ptp : a.itp;
+    dispatchIndexType(ptp, [&](auto p) {
+      using P = decltype(p);
+      dispatchIndexType(a.itp, [&](auto i) {
+        using I = decltype(i);
+        spmm<V, P, I>(queue, a, ma != 0, static_cast<const V *>(b.values),
+                      static_cast<V *>(c.values), b.cols);
+      });
+    });
+  });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuCreateSparseEnv() {}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuDestroySparseEnv() {}
+
+extern "C" SYCL_RUNTIME_EXPORT void *
+mgpuCreateDnVec(intptr_t size, void *values, int32_t dtp,
+                sycl::queue * /*queue*/) {
+  return catchAll([&]() { return new DnTensor{size, 1, values, dtp}; });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuDestroyDnVec(void *h,
+                                                     sycl::queue * /*queue*/) {
+  catchAll([&]() { delete static_cast<DnTensor *>(h); });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void *
+mgpuCreateDnMat(intptr_t rows, intptr_t cols, void *values, int32_t dtp,
+                sycl::queue * /*queue*/) {
+  return catchAll([&]() { return new DnTensor{rows, cols, values, dtp}; });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuDestroyDnMat(void *h,
+                                                     sycl::queue * /*queue*/) {
+  catchAll([&]() { delete static_cast<DnTensor *>(h); });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void *
+mgpuCreateCoo(intptr_t rows, intptr_t cols, intptr_t nnz, void *rowIdxs,
+              void *colIdxs, void *values, int32_t itp, int32_t dtp,
+              sycl::queue * /*queue*/) {
+  return catchAll([&]() {
+    return new SpMat{SparseFormat::Coo, rows, cols, nnz, rowIdxs, colIdxs,
+                     values, itp, itp, dtp};
+  });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void *
+mgpuCreateCsr(intptr_t rows, intptr_t cols, intptr_t nnz, void *rowPos,
+              void *colIdxs, void *values, int32_t ptp, int32_t itp,
+              int32_t dtp, sycl::queue * /*queue*/) {
+  return catchAll([&]() {
+    return new SpMat{SparseFormat::Csr, rows, cols, nnz, rowPos, colIdxs,
+                     values, ptp, itp, dtp};
+  });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuDestroySpMat(void *h,
+                                                     sycl::queue * /*queue*/) {
+  catchAll([&]() { delete static_cast<SpMat *>(h); });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT intptr_t
+mgpuSpMVBufferSize(int32_t ma, void *a, void *x, void *y, int32_t ctp,
+                   sycl::queue * /*queue*/) {
+  // The kernels don't need a work buffer.
+  return 0;
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuSpMV(int32_t ma, void *a, void *x,
+                                             void *y, int32_t ctp, void *buf,
+                                             sycl::queue *queue) {
+  catchAll([&]() {
+    // A vector is a matrix with one column.
+    spmm(queue, ma, *static_cast<SpMat *>(a), *static_cast<DnTensor *>(x),
+         *static_cast<DnTensor *>(y));
+  });
+}
+
+extern "C" SYCL_RUNTIME_EXPORT intptr_t
+mgpuSpMMBufferSize(int32_t ma, int32_t mb, void *a, void *b, void *c,
+                   int32_t ctp, sycl::queue * /*queue*/) {
+  return 0;
+}
+
+extern "C" SYCL_RUNTIME_EXPORT void mgpuSpMM(int32_t ma, int32_t mb, void *a,
+                                             void *b, void *c, int32_t ctp,
+                                             void *buf, sycl::queue *queue) {
+  catchAll([&]() {
+    if (mb != 0)
+      throw std::runtime_error("transposed dense operands are not supported");
+    spmm(queue, ma, *static_cast<SpMat *>(a), *static_cast<DnTensor *>(b),
+         *static_cast<DnTensor *>(c));
+  });
+}
@@ -118,12 +118,17 @@ void *getProperty<void *>(omp_interop_val_t &InteropVal,
   case omp_ipr_device:
     if (InteropVal.device_info.Device)
       return InteropVal.device_info.Device;
-    *Err = omp_irc_no_value;
+    if (Err)
+      *Err = omp_irc_no_value;
     return const_cast<char *>(InteropVal.err_str);
   case omp_ipr_device_context:
     return InteropVal.device_info.Context;
   case omp_ipr_targetsync:
-    return InteropVal.async_info->Queue;
+    if (InteropVal.async_info)
+      return InteropVal.async_info->Queue;
+    if (Err)
+      *Err = omp_irc_no_value;
+    return nullptr;
   default:;
   }
   getTypeMismatch(Property, Err);
@@ -166,7 +171,6 @@ bool getPropertyCheck(omp_interop_val_t **InteropPtr,
                                        omp_interop_property_t property_id,     \
                                        int *err) {                             \
     omp_interop_val_t *interop_val = (omp_interop_val_t *)interop;             \
-    assert((interop_val)->interop_type == kmp_interop_type_tasksync);          \
     if (!getPropertyCheck(&interop_val, property_id, err)) {                   \
       return (RETURN_TYPE)(0);                                                 \
     }                                                                          \
@@ -3395,6 +3395,7 @@ extern kmp_uint32 __kmp_barrier_gather_branch_bits[bs_last_barrier];
 extern kmp_uint32 __kmp_barrier_release_branch_bits[bs_last_barrier];
 extern kmp_bar_pat_e __kmp_barrier_gather_pattern[bs_last_barrier];
 extern kmp_bar_pat_e __kmp_barrier_release_pattern[bs_last_barrier];
+extern int __kmp_barrier_auto_tune;
 extern char const *__kmp_barrier_branch_bit_env_name[bs_last_barrier];
 extern char const *__kmp_barrier_pattern_env_name[bs_last_barrier];
 extern char const *__kmp_barrier_type_name[bs_last_barrier];
@@ -4062,6 +4063,7 @@ extern int __kmp_barrier(enum barrier_type bt, int gtid, int is_split,
                          void (*reduce)(void *, void *));
 extern void __kmp_end_split_barrier(enum barrier_type bt, int gtid);
 extern int __kmp_barrier_gomp_cancel(int gtid);
+extern void __kmp_barrier_tune_for_topology();
 
 /*!
  * Tell the fork call which compiler generated the fork call, and therefore how
@@ -2128,6 +2128,55 @@ int __kmp_barrier_gomp_cancel(int gtid) {
 }
 #endif
 
+// Adapts the default barrier patterns to the machine, unless the environment
+// sets any of them. This only applies when the threads are bound, otherwise
+// the position of a thread in the machine hierarchy means nothing.
+//  - With several sockets, the plain and fork/join barriers follow the machine
+//    hierarchy, so that each socket gathers and releases its own threads and
+//    the cache lines of a barrier cross the sockets once per socket instead of
+//    once per thread.
+//  - With many threads per socket, the gather of the plain barrier has a
+//    fan-in of 8 rather than 4, which was the best setting for the 240
+//    threads of KNC, to keep the tree shallow.
+// The reduction barrier keeps its hyper pattern, its gather combines the
+// partial results along the tree.
+void __kmp_barrier_tune_for_topology() {
+#if KMP_AFFINITY_SUPPORTED
+  if (!__kmp_barrier_auto_tune || !__kmp_topology || !KMP_AFFINITY_CAPABLE() ||
+      __kmp_affinity.type == affinity_none ||
+      __kmp_affinity.type == affinity_disabled)
+    return;
+
+  int socket_level = __kmp_topology->get_level(KMP_HW_SOCKET);
+  int num_sockets =
+      socket_level >= 0 ? __kmp_topology->get_count(socket_level) : 1;
+  int threads_per_socket =
+      __kmp_avail_proc / (num_sockets > 0 ? num_sockets : 1);
+
+  if (num_sockets > 1) {
+    __kmp_barrier_gather_pattern[bs_plain_barrier] = bp_hierarchical_bar;
+    __kmp_barrier_release_pattern[bs_plain_barrier] = bp_hierarchical_bar;
+    __kmp_barrier_gather_pattern[bs_forkjoin_barrier] = bp_hierarchical_bar;
+    __kmp_barrier_release_pattern[bs_forkjoin_barrier] = bp_hierarchical_bar;
+  } else if (threads_per_socket > 64 &&
+             __kmp_barrier_gather_pattern[bs_plain_barrier] == bp_hyper_bar) {
+    __kmp_barrier_gather_branch_bits[bs_plain_barrier] = 3;
+  }
+
+  KA_TRACE(10, ("__kmp_barrier_tune_for_topology: %d sockets, %d threads per "
+                "socket, plain barrier %s,%s, fork/join barrier %s,%s\n",
+                num_sockets, threads_per_socket,
+                __kmp_barrier_pattern_name
+                    [__kmp_barrier_gather_pattern[bs_plain_barrier]],
+                __kmp_barrier_pattern_name
+                    [__kmp_barrier_release_pattern[bs_plain_barrier]],
+                __kmp_barrier_pattern_name
+                    [__kmp_barrier_gather_pattern[bs_forkjoin_barrier]],
+                __kmp_barrier_pattern_name
+                    [__kmp_barrier_release_pattern[bs_forkjoin_barrier]]));
+#endif // KMP_AFFINITY_SUPPORTED
+}
+
 void __kmp_end_split_barrier(enum barrier_type bt, int gtid) {
   KMP_TIME_DEVELOPER_PARTITIONED_BLOCK(KMP_end_split_barrier);
   KMP_SET_THREAD_STATE_BLOCK(PLAIN_BARRIER);
@@ -91,6 +91,9 @@ kmp_uint32 __kmp_barrier_gather_branch_bits[bs_last_barrier] = {0};
 kmp_uint32 __kmp_barrier_release_branch_bits[bs_last_barrier] = {0};
 kmp_bar_pat_e __kmp_barrier_gather_pattern[bs_last_barrier] = {bp_linear_bar};
 kmp_bar_pat_e __kmp_barrier_release_pattern[bs_last_barrier] = {bp_linear_bar};
+// Whether the patterns and branch bits may be adapted to the machine topology,
+// cleared when any of them is set in the environment.
+int __kmp_barrier_auto_tune = TRUE;
 char const *__kmp_barrier_branch_bit_env_name[bs_last_barrier] = {
     "KMP_PLAIN_BARRIER", "KMP_FORKJOIN_BARRIER"
 #if KMP_FAST_REDUCTION_BARRIER
@@ -7431,6 +7431,9 @@ static void __kmp_do_middle_initialize(void) {
   // number of cores on the machine.
   __kmp_affinity_initialize(__kmp_affinity);
 
+  // The barriers are tuned once the topology is known, before any team is
+  // allocated with them.
+  __kmp_barrier_tune_for_topology();
 #endif /* KMP_AFFINITY_SUPPORTED */
 
   KMP_ASSERT(__kmp_xproc > 0);
@@ -1701,6 +1701,8 @@ static void __kmp_stg_parse_barrier_branch_bit(char const *name,
     if ((strcmp(var, name) == 0) && (value != 0)) {
       char *comma;
 
+      __kmp_barrier_auto_tune = FALSE;
+
       comma = CCAST(char *, strchr(value, ','));
       __kmp_barrier_gather_branch_bits[i] =
           (kmp_uint32)__kmp_str_to_int(value, ',');
@@ -1770,6 +1772,8 @@ static void __kmp_stg_parse_barrier_pattern(char const *name, char const *value,
       int j;
       char *comma = CCAST(char *, strchr(value, ','));
 
+      __kmp_barrier_auto_tune = FALSE;
+
       /* handle first parameter: gather pattern */
       for (j = bp_linear_bar; j < bp_last_bar; j++) {
         if (__kmp_match_with_sentinel(__kmp_barrier_pattern_name[j], value, 1,
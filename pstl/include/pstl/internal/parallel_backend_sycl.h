@@ -0,0 +1,68 @@
+// -*- C++ -*-
+// -*-===----------------------------------------------------------------------===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_SYCL_H
+#define _PSTL_PARALLEL_BACKEND_SYCL_H
+
+//------------------------------------------------------------------------
+// Backend running the par_unseq algorithms on the device of the default SYCL
+// queue, see sycl/util.h for when they are offloaded. The translation units
+// using it are compiled with -fsycl.
+//------------------------------------------------------------------------
+
+#include "sycl/util.h"
+
+//------------------------------------------------------------------------
+// parallel_for
+//------------------------------------------------------------------------
+
+#include "sycl/parallel_for.h"
+
+//------------------------------------------------------------------------
+// parallel_for_each
+//------------------------------------------------------------------------
+
+#include "sycl/parallel_for_each.h"
+
+//------------------------------------------------------------------------
+// parallel_invoke
+//------------------------------------------------------------------------
+
+#include "sycl/parallel_invoke.h"
+
+//------------------------------------------------------------------------
+// parallel_reduce
+//------------------------------------------------------------------------
+
+#include "sycl/parallel_reduce.h"
+#include "sycl/parallel_transform_reduce.h"
+
+//------------------------------------------------------------------------
+// parallel_scan
+//------------------------------------------------------------------------
+
+#include "sycl/parallel_scan.h"
+#include "sycl/parallel_transform_scan.h"
+
+//------------------------------------------------------------------------
+// parallel_stable_sort
+//------------------------------------------------------------------------
+
+#include "sycl/parallel_stable_sort.h"
+
+//------------------------------------------------------------------------
+// parallel_merge
+//------------------------------------------------------------------------
+
+#include "sycl/parallel_merge.h"
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif //_PSTL_PARALLEL_BACKEND_SYCL_H
@@ -0,0 +1,52 @@
+// -*- C++ -*-
+// -*-===----------------------------------------------------------------------===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_INTERNAL_SYCL_PARALLEL_FOR_H
+#define _PSTL_INTERNAL_SYCL_PARALLEL_FOR_H
+
+#include <cstddef>
+
+#include "util.h"
+
+namespace __pstl
+{
+namespace __sycl_backend
+{
+
+//------------------------------------------------------------------------
+// Notation:
+// Evaluation of brick f[i,j) for each subrange [i,j) of [first, last)
+//------------------------------------------------------------------------
+
+template <class _ExecutionPolicy, class _Index, class _Fp>
+void
+__parallel_for(__pstl::__internal::__sycl_backend_tag, _ExecutionPolicy&&, _Index __first, _Index __last, _Fp __f)
+{
+    if constexpr (__can_offload_v<_ExecutionPolicy, _Index, _Fp>)
+    {
+        if (__pstl::__sycl_backend::__should_offload(__first, __last))
+        {
+            __pstl::__sycl_backend::__prefetch(__first, __last);
+            // One work-item per element, each running the brick on its own
+            // element.
+            const std::size_t __n = __last - __first;
+            __pstl::__sycl_backend::__get_queue()
+                .parallel_for(sycl::range<1>(__n),
+                              [=](sycl::id<1> __i) { __f(__first + __i[0], __first + __i[0] + 1); })
+                .wait_and_throw();
+            return;
+        }
+    }
+    __f(__first, __last);
+}
+
+} // namespace __sycl_backend
+} // namespace __pstl
+#endif // _PSTL_INTERNAL_SYCL_PARALLEL_FOR_H
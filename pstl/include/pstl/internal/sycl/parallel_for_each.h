@@ -0,0 +1,46 @@
+// -*- C++ -*-
+// -*-===----------------------------------------------------------------------===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_INTERNAL_SYCL_PARALLEL_FOR_EACH_H
+#define _PSTL_INTERNAL_SYCL_PARALLEL_FOR_EACH_H
+
+#include <cstddef>
+
+#include "util.h"
+
+namespace __pstl
+{
+namespace __sycl_backend
+{
+
+template <class _ExecutionPolicy, class _ForwardIterator, class _Fp>
+void
+__parallel_for_each(__pstl::__internal::__sycl_backend_tag, _ExecutionPolicy&&, _ForwardIterator __first,
+                    _ForwardIterator __last, _Fp __f)
+{
+    if constexpr (__can_offload_v<_ExecutionPolicy, _ForwardIterator, _Fp>)
+    {
+        if (__pstl::__sycl_backend::__should_offload(__first, __last))
+        {
+            __pstl::__sycl_backend::__prefetch(__first, __last);
+            const std::size_t __n = __last - __first;
+            __pstl::__sycl_backend::__get_queue()
+                .parallel_for(sycl::range<1>(__n), [=](sycl::id<1> __i) { __f(__first[__i[0]]); })
+                .wait_and_throw();
+            return;
+        }
+    }
+    for (auto __iter = __first; __iter != __last; ++__iter)
+        __f(*__iter);
+}
+
+} // namespace __sycl_backend
+} // namespace __pstl
+#endif // _PSTL_INTERNAL_SYCL_PARALLEL_FOR_EACH_H
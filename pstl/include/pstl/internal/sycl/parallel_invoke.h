@@ -0,0 +1,35 @@
+// -*- C++ -*-
+// -*-===----------------------------------------------------------------------===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_INTERNAL_SYCL_PARALLEL_INVOKE_H
+#define _PSTL_INTERNAL_SYCL_PARALLEL_INVOKE_H
+
+#include <utility>
+
+#include "util.h"
+
+namespace __pstl
+{
+namespace __sycl_backend
+{
+
+// The functions are run on the host, one after the other: they recurse into
+// the algorithms, which offload themselves.
+template <class _ExecutionPolicy, typename _F1, typename _F2>
+void
+__parallel_invoke(__pstl::__internal::__sycl_backend_tag, _ExecutionPolicy&&, _F1&& __f1, _F2&& __f2)
+{
+    std::forward<_F1>(__f1)();
+    std::forward<_F2>(__f2)();
+}
+
+} // namespace __sycl_backend
+} // namespace __pstl
+#endif // _PSTL_INTERNAL_SYCL_PARALLEL_INVOKE_H
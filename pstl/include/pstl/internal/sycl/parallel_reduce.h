@@ -0,0 +1,64 @@
+// -*- C++ -*-
+// -*-===----------------------------------------------------------------------===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_INTERNAL_SYCL_PARALLEL_REDUCE_H
+#define _PSTL_INTERNAL_SYCL_PARALLEL_REDUCE_H
+
+#include <cstddef>
+
+#include "util.h"
+
+namespace __pstl
+{
+namespace __sycl_backend
+{
+
+//------------------------------------------------------------------------
+// Notation:
+//      r(i,j,init) returns reduction of init with reduction over [i,j)
+//      c(x,y) combines values x and y that were the result of r
+//------------------------------------------------------------------------
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _Value, typename _RealBody, typename _Reduction>
+_Value
+__parallel_reduce(__pstl::__internal::__sycl_backend_tag, _ExecutionPolicy&&, _RandomAccessIterator __first,
+                  _RandomAccessIterator __last, _Value __identity, _RealBody __real_body, _Reduction __reduction)
+{
+    if constexpr (__can_offload_v<_ExecutionPolicy, _RandomAccessIterator, _Value, _RealBody, _Reduction>)
+    {
+        if (__pstl::__sycl_backend::__should_offload(__first, __last))
+        {
+            __pstl::__sycl_backend::__prefetch(__first, __last);
+            // The runtime's reduction combines the brick of each element, with
+            // the known identity of the reduction.
+            sycl::queue& __queue = __pstl::__sycl_backend::__get_queue();
+            __usm_buffer<_Value> __result(__queue, 1);
+            const std::size_t __n = __last - __first;
+            __queue
+                .parallel_for(sycl::range<1>(__n),
+                              sycl::reduction(__result.get(), __identity, __reduction,
+                                              sycl::property::reduction::initialize_to_identity()),
+                              [=](sycl::id<1> __i, auto& __sum)
+                              {
+                                  auto __elem = __first + __i[0];
+                                  __sum.combine(__real_body(__elem, __elem + 1, __identity));
+                              })
+                .wait_and_throw();
+            return *__result.get();
+        }
+    }
+    if (__first == __last)
+        return __identity;
+    return __real_body(__first, __last, __identity);
+}
+
+} // namespace __sycl_backend
+} // namespace __pstl
+#endif // _PSTL_INTERNAL_SYCL_PARALLEL_REDUCE_H
@@ -0,0 +1,137 @@
+// -*- C++ -*-
+// -*-===----------------------------------------------------------------------===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_INTERNAL_SYCL_PARALLEL_STABLE_SORT_H
+#define _PSTL_INTERNAL_SYCL_PARALLEL_STABLE_SORT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+#include "util.h"
+
+namespace __pstl
+{
+namespace __sycl_backend
+{
+
+namespace __sort_details
+{
+
+// Number of elements insertion sorted by each work-item before the merges.
+inline constexpr std::size_t __leaf_size = 16;
+
+// Bottom-up merge sort: the work-items first sort leaves of __leaf_size
+// elements, then each pass merges the pairs of sorted runs, one work-item per
+// element. The position of an element in the merged run is its position in
+// its own run plus the number of elements of the other run it goes after,
+// found by binary search: the elements of the right run go after the equal
+// elements of the left run, which keeps the sort stable.
+template <typename _Tp, typename _Compare>
+void
+__device_stable_sort(sycl::queue& __queue, _Tp* __data, std::size_t __n, _Compare __comp)
+{
+    __usm_buffer<_Tp> __scratch(__queue, __n, sycl::usm::alloc::device);
+
+    __queue.parallel_for(sycl::range<1>((__n + __leaf_size - 1) / __leaf_size),
+                         [=](sycl::id<1> __i)
+                         {
+                             const std::size_t __begin = __i[0] * __leaf_size;
+                             const std::size_t __end = std::min(__begin + __leaf_size, __n);
+                             for (std::size_t __k = __begin + 1; __k < __end; ++__k)
+                             {
+                                 _Tp __v = __data[__k];
+                                 std::size_t __j = __k;
+                                 for (; __j > __begin && __comp(__v, __data[__j - 1]); --__j)
+                                     __data[__j] = __data[__j - 1];
+                                 __data[__j] = __v;
+                             }
+                         });
+
+    _Tp* __src = __data;
+    _Tp* __dst = __scratch.get();
+    for (std::size_t __width = __leaf_size; __width < __n; __width *= 2)
+    {
+        __queue.parallel_for(sycl::range<1>(__n),
+                             [=](sycl::id<1> __i)
+                             {
+                                 const std::size_t __k = __i[0];
+                                 const std::size_t __begin = __k / (2 * __width) * (2 * __width);
+                                 const std::size_t __middle = std::min(__begin + __width, __n);
+                                 const std::size_t __end = std::min(__begin + 2 * __width, __n);
+                                 const _Tp __v = __src[__k];
+                                 std::size_t __lo, __hi;
+                                 if (__k < __middle)
+                                 {
+                                     // Count the elements of the right run less than __v.
+                                     __lo = __middle;
+                                     __hi = __end;
+                                     while (__lo < __hi)
+                                     {
+                                         const std::size_t __m = __lo + (__hi - __lo) / 2;
+                                         if (__comp(__src[__m], __v))
+                                             __lo = __m + 1;
+                                         else
+                                             __hi = __m;
+                                     }
+                                     __dst[__k + (__lo - __middle)] = __v;
+                                 }
+                                 else
+                                 {
+                                     // Count the elements of the left run not greater than __v.
+                                     __lo = __begin;
+                                     __hi = __middle;
+                                     while (__lo < __hi)
+                                     {
+                                         const std::size_t __m = __lo + (__hi - __lo) / 2;
+                                         if (!__comp(__v, __src[__m]))
+                                             __lo = __m + 1;
+                                         else
+                                             __hi = __m;
+                                     }
+                                     __dst[(__k - __middle) + __lo] = __v;
+                                 }
+                             });
+        std::swap(__src, __dst);
+    }
+    if (__src != __data)
+        __queue.copy(__src, __data, __n);
+    __queue.wait_and_throw();
+}
+
+} // namespace __sort_details
+
+template <class _ExecutionPolicy, typename _RandomAccessIterator, typename _Compare, typename _LeafSort>
+void
+__parallel_stable_sort(__pstl::__internal::__sycl_backend_tag, _ExecutionPolicy&&, _RandomAccessIterator __xs,
+                       _RandomAccessIterator __xe, _Compare __comp, _LeafSort __leaf_sort, std::size_t __nsort = 0)
+{
+    using _ValueType = typename std::iterator_traits<_RandomAccessIterator>::value_type;
+
+    auto __count = static_cast<std::size_t>(__xe - __xs);
+    if constexpr (__can_offload_v<_ExecutionPolicy, _RandomAccessIterator, _ValueType, _Compare>)
+    {
+        // Partial sorts are left to the leaf sort.
+        if (__count <= __nsort && __pstl::__sycl_backend::__should_offload(__xs, __xe))
+        {
+            __pstl::__sycl_backend::__prefetch(__xs, __xe);
+            __pstl::__sycl_backend::__sort_details::__device_stable_sort(__pstl::__sycl_backend::__get_queue(),
+                                                                         std::addressof(*__xs), __count, __comp);
+            return;
+        }
+    }
+    __leaf_sort(__xs, __xe, __comp);
+}
+
+} // namespace __sycl_backend
+} // namespace __pstl
+#endif // _PSTL_INTERNAL_SYCL_PARALLEL_STABLE_SORT_H
@@ -0,0 +1,64 @@
+// -*- C++ -*-
+// -*-===----------------------------------------------------------------------===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_INTERNAL_SYCL_PARALLEL_TRANSFORM_REDUCE_H
+#define _PSTL_INTERNAL_SYCL_PARALLEL_TRANSFORM_REDUCE_H
+
+#include <cstddef>
+#include <new>
+
+#include "util.h"
+
+namespace __pstl
+{
+namespace __sycl_backend
+{
+
+//------------------------------------------------------------------------
+// parallel_transform_reduce
+//
+// Notation:
+//      r(i,j,init) returns reduction of init with reduction over [i,j)
+//      u(i) returns f(i,i+1,identity) for a hypothetical left identity element
+//      of r c(x,y) combines values x and y that were the result of r or u
+//------------------------------------------------------------------------
+
+template <class _ExecutionPolicy, class _RandomAccessIterator, class _UnaryOp, class _Value, class _Combiner,
+          class _Reduction>
+_Value
+__parallel_transform_reduce(__pstl::__internal::__sycl_backend_tag, _ExecutionPolicy&&, _RandomAccessIterator __first,
+                            _RandomAccessIterator __last, _UnaryOp __unary_op, _Value __init, _Combiner __combiner,
+                            _Reduction __reduction)
+{
+    if constexpr (__can_offload_v<_ExecutionPolicy, _RandomAccessIterator, _Value, _UnaryOp, _Combiner>)
+    {
+        if (__pstl::__sycl_backend::__should_offload(__first, __last))
+        {
+            __pstl::__sycl_backend::__prefetch(__first, __last);
+            // The identity of the combiner isn't known: the runtime's
+            // reduction starts from the initial value and combines u(i) of
+            // each element into it.
+            sycl::queue& __queue = __pstl::__sycl_backend::__get_queue();
+            __usm_buffer<_Value> __result(__queue, 1);
+            ::new (__result.get()) _Value(__init);
+            const std::size_t __n = __last - __first;
+            __queue
+                .parallel_for(sycl::range<1>(__n), sycl::reduction(__result.get(), __combiner),
+                              [=](sycl::id<1> __i, auto& __sum) { __sum.combine(__unary_op(__first + __i[0])); })
+                .wait_and_throw();
+            return *__result.get();
+        }
+    }
+    return __reduction(__first, __last, __init);
+}
+
+} // namespace __sycl_backend
+} // namespace __pstl
+#endif // _PSTL_INTERNAL_SYCL_PARALLEL_TRANSFORM_REDUCE_H
@@ -0,0 +1,184 @@
+// -*- C++ -*-
+// -*-===----------------------------------------------------------------------===//
+//
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_INTERNAL_SYCL_UTIL_H
+#define _PSTL_INTERNAL_SYCL_UTIL_H
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <sycl/sycl.hpp>
+
+#include "../execution_defs.h"
+#include "../utils.h"
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __internal
+{
+struct __sycl_backend_tag
+{
+};
+} // namespace __internal
+
+namespace __sycl_backend
+{
+
+//------------------------------------------------------------------------
+// The algorithms run on the device of the default SYCL queue when:
+//  - the policy is par_unseq, the kernels neither keeping the order of the
+//    iterations nor guaranteeing forward progress to a work-item waiting for
+//    another;
+//  - the range has random access iterators to contiguous memory allocated
+//    with the USM of the context of the queue, or shared with the device by
+//    the system;
+//  - the functions given to the algorithm are device copyable;
+//  - the range holds more than __default_offload_size elements.
+// Otherwise they run serially on the host. As for the offloaded algorithms
+// of HIP, when the first range is in memory the device can access, all the
+// other memory used by the algorithm must be as well.
+//------------------------------------------------------------------------
+
+// Below this size the launch of a kernel costs more than it saves.
+inline constexpr std::size_t __default_offload_size = 1 << 14;
+
+inline sycl::queue&
+__get_queue()
+{
+    static sycl::queue __queue{sycl::property::queue::in_order()};
+    return __queue;
+}
+
+//------------------------------------------------------------------------
+// use to cancel execution
+//------------------------------------------------------------------------
+inline void
+__cancel_execution()
+{
+    // The kernels can't be canceled, they run to the end.
+}
+
+//------------------------------------------------------------------------
+// raw buffer
+//------------------------------------------------------------------------
+
+template <typename _Tp>
+class __buffer
+{
+    std::allocator<_Tp> __allocator_;
+    _Tp* __ptr_;
+    const std::size_t __buf_size_;
+    __buffer(const __buffer&) = delete;
+    void
+    operator=(const __buffer&) = delete;
+
+  public:
+    __buffer(std::size_t __n) : __allocator_(), __ptr_(__allocator_.allocate(__n)), __buf_size_(__n) {}
+
+    operator bool() const { return __ptr_ != nullptr; }
+
+    _Tp*
+    get() const
+    {
+        return __ptr_;
+    }
+    ~__buffer() { __allocator_.deallocate(__ptr_, __buf_size_); }
+};
+
+// Memory allocated with the USM of the queue, shared with the host by default,
+// for the results and the scratch data of the kernels.
+template <typename _Tp>
+class __usm_buffer
+{
+    sycl::queue& __queue_;
+    _Tp* __ptr_;
+    __usm_buffer(const __usm_buffer&) = delete;
+    void
+    operator=(const __usm_buffer&) = delete;
+
+  public:
+    __usm_buffer(sycl::queue& __queue, std::size_t __n, sycl::usm::alloc __kind = sycl::usm::alloc::shared)
+        : __queue_(__queue), __ptr_(sycl::malloc<_Tp>(__n, __queue, __kind))
+    {
+        if (!__ptr_)
+            throw std::bad_alloc();
+    }
+
+    _Tp*
+    get() const
+    {
+        return __ptr_;
+    }
+    ~__usm_buffer() { sycl::free(__ptr_, __queue_); }
+};
+
+template <typename _ExecutionPolicy>
+inline constexpr bool __is_unsequenced_policy_v =
+    std::is_same_v<std::decay_t<_ExecutionPolicy>, __pstl::execution::parallel_unsequenced_policy>;
+
+// Before C++20, only the pointers are known to be contiguous.
+template <typename _Iterator>
+inline constexpr bool __is_contiguous_iterator_v =
+#if __cplusplus >= 202002L
+    std::contiguous_iterator<_Iterator>;
+#else
+    std::is_pointer_v<_Iterator>;
+#endif
+
+// Whether the memory at __ptr is accessible from the device of the queue.
+inline bool
+__is_device_accessible(const void* __ptr)
+{
+    sycl::queue& __queue = __get_queue();
+    if (sycl::get_pointer_type(__ptr, __queue.get_context()) != sycl::usm::alloc::unknown)
+        return true;
+    return __queue.get_device().has(sycl::aspect::usm_system_allocations);
+}
+
+// Whether an algorithm run with a policy of type _ExecutionPolicy over a range
+// of _Iterator, with functions and values of the types _Args, can offload.
+template <typename _ExecutionPolicy, typename _Iterator, typename... _Args>
+inline constexpr bool __can_offload_v = __is_unsequenced_policy_v<_ExecutionPolicy> && !std::is_integral_v<_Iterator> &&
+                                        __is_contiguous_iterator_v<_Iterator> &&
+                                        (sycl::is_device_copyable_v<_Args> && ...);
+
+// Whether an algorithm that can offload runs over [__first, __last) on the
+// device.
+template <typename _Iterator>
+bool
+__should_offload(_Iterator __first, _Iterator __last)
+{
+    if (__last - __first <= static_cast<std::ptrdiff_t>(__default_offload_size))
+        return false;
+    return __pstl::__sycl_backend::__is_device_accessible(std::addressof(*__first));
+}
+
+// Migrates the USM shared memory of the range to the device ahead of the
+// kernel, rather than on the page faults of the work-items. This is the case
+// of the memory allocated with the allocation interposition of the SYCL
+// stdpar.
+template <typename _Iterator>
+void
+__prefetch(_Iterator __first, _Iterator __last)
+{
+    sycl::queue& __queue = __get_queue();
+    const void* __ptr = std::addressof(*__first);
+    if (sycl::get_pointer_type(__ptr, __queue.get_context()) == sycl::usm::alloc::shared)
+        __queue.prefetch(__ptr, (__last - __first) * sizeof(*__first));
+}
+
+} // namespace __sycl_backend
+} // namespace __pstl
+
+#endif // _PSTL_INTERNAL_SYCL_UTIL_H
@@ -28,15 +28,24 @@ enum class BarrierFlags : uint32_t {
   None = 0,   // Do not insert barrier
   Local = 1,  // Ensure correct ordering of memory operations to local memory
   Global = 2, // Ensure correct ordering of memory operations to global memory
-  LocalAndGlobal = Local | Global
+  LocalAndGlobal = Local | Global,
+  // The barriers may be removed if the kernels provably access disjoint
+  // memory, as distinct parameters are guaranteed to not overlap.
+  Elidable = 4
 };
 
 constexpr BarrierFlags getNoBarrierFlag() { return BarrierFlags::None; }
 constexpr BarrierFlags getLocalAndGlobalBarrierFlag() {
   return BarrierFlags::LocalAndGlobal;
 }
+constexpr BarrierFlags getElidableLocalAndGlobalBarrierFlag() {
+  return static_cast<BarrierFlags>(
+      static_cast<uint32_t>(BarrierFlags::LocalAndGlobal) |
+      static_cast<uint32_t>(BarrierFlags::Elidable));
+}
 constexpr bool isNoBarrierFlag(BarrierFlags Flag) {
-  return Flag == BarrierFlags::None;
+  return (static_cast<uint32_t>(Flag) &
+          static_cast<uint32_t>(BarrierFlags::LocalAndGlobal)) == 0;
 }
 constexpr bool hasLocalBarrierFlag(BarrierFlags Flag) {
   return static_cast<uint32_t>(Flag) &
@@ -46,6 +55,10 @@ constexpr bool hasGlobalBarrierFlag(BarrierFlags Flag) {
   return static_cast<uint32_t>(Flag) &
          static_cast<uint32_t>(BarrierFlags::Global);
 }
+constexpr bool hasElidableBarrierFlag(BarrierFlags Flag) {
+  return static_cast<uint32_t>(Flag) &
+         static_cast<uint32_t>(BarrierFlags::Elidable);
+}
 
 ///
 /// Enumerate possible kinds of parameters.
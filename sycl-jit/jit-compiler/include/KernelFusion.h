@@ -62,9 +62,12 @@ JITResult fuseKernels(View<SYCLKernelInfo> KernelInformation,
                       View<ParameterInternalization> Internalization,
                       View<jit_compiler::JITConstant> JITConstants);
 
+/// Materialize the specialization constants of the kernel \p KernelName and,
+/// if \p NDR is not null, the ND-range it is launched with.
 JITResult materializeSpecConstants(const char *KernelName,
                                    jit_compiler::SYCLKernelBinaryInfo &BinInfo,
-                                   View<unsigned char> SpecConstBlob);
+                                   View<unsigned char> SpecConstBlob,
+                                   const jit_compiler::NDRange *NDR);
 
 /// Clear all previously set options.
 void resetJITConfiguration();
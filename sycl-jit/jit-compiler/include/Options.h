@@ -18,7 +18,8 @@ enum OptionID {
   EnableCaching,
   TargetDeviceInfo,
   TargetCPU,
-  TargetFeatures
+  TargetFeatures,
+  EnableFusionCostModel
 };
 
 class OptionPtrBase {
@@ -107,6 +108,12 @@ struct JITTargetFeatures
   using OptionBase::OptionBase;
 };
 
+struct JITEnableFusionCostModel
+    : public OptionBase<JITEnableFusionCostModel,
+                        OptionID::EnableFusionCostModel, bool> {
+  using OptionBase::OptionBase;
+};
+
 } // namespace option
 } // namespace jit_compiler
 
@@ -73,7 +73,8 @@ static bool isTargetFormatSupported(BinaryFormat TargetFormat) {
 extern "C" JITResult
 materializeSpecConstants(const char *KernelName,
                          jit_compiler::SYCLKernelBinaryInfo &BinInfo,
-                         View<unsigned char> SpecConstBlob) {
+                         View<unsigned char> SpecConstBlob,
+                         const jit_compiler::NDRange *NDR) {
   auto &JITCtx = JITContext::getInstance();
 
   TargetInfo TargetInfo = ConfigHelper::get<option::JITTargetInfo>();
@@ -99,7 +100,7 @@ materializeSpecConstants(const char *KernelName,
   }
   std::unique_ptr<llvm::Module> NewMod = std::move(*ModOrError);
   if (!fusion::FusionPipeline::runMaterializerPasses(
-          *NewMod, SpecConstBlob.to<llvm::ArrayRef>()) ||
+          *NewMod, SpecConstBlob.to<llvm::ArrayRef>(), KernelName, NDR) ||
       !NewMod->getFunction(KernelName)) {
     return JITResult{"Materializer passes should not fail"};
   }
@@ -204,9 +205,13 @@ extern "C" JITResult fuseKernels(View<SYCLKernelInfo> KernelInformation,
   std::unique_ptr<llvm::Module> NewMod = std::move(*NewModOrError);
 
   // Invoke the actual fusion via LLVM pass manager.
-  std::unique_ptr<SYCLModuleInfo> NewModInfo =
-      fusion::FusionPipeline::runFusionPasses(*NewMod, ModuleInfo,
-                                              BarriersFlags);
+  llvm::Expected<std::unique_ptr<SYCLModuleInfo>> NewModInfoOrError =
+      fusion::FusionPipeline::runFusionPasses(
+          *NewMod, ModuleInfo, BarriersFlags, FusedNDR->getNDR());
+  if (auto Error = NewModInfoOrError.takeError()) {
+    return errorToFusionResult(std::move(Error), "Kernel fusion declined");
+  }
+  std::unique_ptr<SYCLModuleInfo> NewModInfo = std::move(*NewModInfoOrError);
 
   if (!NewMod->getFunction(FusedKernelName)) {
     return JITResult{"Kernel fusion failed"};
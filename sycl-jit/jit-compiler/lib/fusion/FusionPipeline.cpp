@@ -11,10 +11,13 @@
 #include "debug/PassDebug.h"
 #include "helper/ConfigHelper.h"
 #include "internalization/Internalization.h"
+#include "kernel-fusion/SYCLBarrierElimination.h"
 #include "kernel-fusion/SYCLKernelFusion.h"
+#include "kernel-fusion/SYCLNDRangeMaterializer.h"
 #include "kernel-fusion/SYCLSpecConstMaterializer.h"
 #include "kernel-info/SYCLKernelInfo.h"
 #include "syclcp/SYCLCP.h"
+#include "target/TargetFusionInfo.h"
 
 #include "llvm/IR/PassManager.h"
 #include "llvm/Transforms/IPO/AlwaysInliner.h"
@@ -52,9 +55,81 @@ static unsigned getFlatAddressSpace(Module &Mod) {
   return std::numeric_limits<unsigned>::max();
 }
 
-std::unique_ptr<SYCLModuleInfo>
+namespace {
+///
+/// Lowest occupancy of the input kernels and whether any of them exceeds the
+/// register file, to compare the fused kernel against.
+struct InputKernelsCost {
+  double MinOccupancy = 1.0;
+  bool ExceedsRegisterFile = false;
+};
+} // namespace
+
+static InputKernelsCost estimateInputKernelsCost(Module &Mod,
+                                                 SYCLModuleInfo &InputInfo) {
+  TargetFusionInfo TFI{&Mod};
+  InputKernelsCost Cost;
+  for (const SYCLKernelInfo &KI : InputInfo.kernels()) {
+    Function *F = Mod.getFunction(KI.Name.c_str());
+    if (!F) {
+      continue;
+    }
+    KernelFootprint FP = TFI.estimateFootprint(F);
+    double Occupancy = TFI.estimateOccupancy(FP, KI.NDR);
+    FUSION_DEBUG(llvm::dbgs() << "Input kernel " << F->getName() << ": "
+                              << FP.Registers << " registers, "
+                              << FP.LocalMemBytes << " bytes of local memory, "
+                              << "estimated occupancy " << Occupancy << "\n");
+    Cost.MinOccupancy = std::min(Cost.MinOccupancy, Occupancy);
+    Cost.ExceedsRegisterFile |= TFI.exceedsRegisterFile(FP);
+  }
+  return Cost;
+}
+
+///
+/// Check the fused kernels against the cost of the input kernels. Fusion is
+/// declined if it lowers the occupancy, as the fewer resident work-items
+/// hide less of the memory latency, or if it introduces register spills.
+static Error checkFusedKernelsCost(Module &Mod, SYCLModuleInfo &FusedInfo,
+                                   SYCLModuleInfo &InputInfo,
+                                   const InputKernelsCost &InputCost,
+                                   const NDRange &FusedNDR) {
+  TargetFusionInfo TFI{&Mod};
+  for (const SYCLKernelInfo &KI : FusedInfo.kernels()) {
+    if (InputInfo.hasKernelFor(KI.Name.c_str())) {
+      continue;
+    }
+    Function *F = Mod.getFunction(KI.Name.c_str());
+    if (!F) {
+      continue;
+    }
+    KernelFootprint FP = TFI.estimateFootprint(F);
+    double Occupancy = TFI.estimateOccupancy(FP, FusedNDR);
+    FUSION_DEBUG(llvm::dbgs() << "Fused kernel " << F->getName() << ": "
+                              << FP.Registers << " registers, "
+                              << FP.LocalMemBytes << " bytes of local memory, "
+                              << "estimated occupancy " << Occupancy << "\n");
+    std::string Reason;
+    raw_string_ostream ReasonOS{Reason};
+    if (Occupancy < InputCost.MinOccupancy) {
+      ReasonOS << "estimated occupancy drops from " << InputCost.MinOccupancy
+               << " to " << Occupancy;
+    } else if (TFI.exceedsRegisterFile(FP) && !InputCost.ExceedsRegisterFile) {
+      ReasonOS << FP.Registers << " registers exceed the register file";
+    } else {
+      continue;
+    }
+    FUSION_DEBUG(llvm::dbgs() << "Fusion declined: " << Reason << "\n");
+    return createStringError(inconvertibleErrorCode(),
+                             "Fusion declined by the cost model: " + Reason);
+  }
+  return Error::success();
+}
+
+Expected<std::unique_ptr<SYCLModuleInfo>>
 FusionPipeline::runFusionPasses(Module &Mod, SYCLModuleInfo &InputInfo,
-                                BarrierFlags BarriersFlags) {
+                                BarrierFlags BarriersFlags,
+                                const NDRange &FusedNDR) {
   // Perform the actual kernel fusion, i.e., generate a kernel function for the
   // fused kernel from the kernel functions of the input kernels. This is done
   // by the SYCLKernelFusion LLVM pass, which is run here through a custom LLVM
@@ -67,6 +142,14 @@ FusionPipeline::runFusionPasses(Module &Mod, SYCLModuleInfo &InputInfo,
     jit_compiler::PassDebug = true;
   }
 
+  // The input kernels are replaced by the fused kernel, so their cost is
+  // estimated before running the pipeline.
+  bool CostModelEnabled = ConfigHelper::get<option::JITEnableFusionCostModel>();
+  InputKernelsCost InputCost;
+  if (CostModelEnabled) {
+    InputCost = estimateInputKernelsCost(Mod, InputInfo);
+  }
+
   // Initialize the analysis managers with all the registered analyses.
   PassBuilder PB;
   LoopAnalysisManager LAM;
@@ -111,6 +194,10 @@ FusionPipeline::runFusionPasses(Module &Mod, SYCLModuleInfo &InputInfo,
     FPM.addPass(SimplifyCFGPass{});
     MPM.addPass(createModuleToFunctionPassAdaptor(std::move(FPM)));
   }
+  // Remove the barriers between the kernels if the work-items don't share
+  // memory, which lets the optimizations below forward values across the
+  // kernels.
+  MPM.addPass(SYCLBarrierElimination{});
   // Run dataflow internalization and runtime constant propagation.
   MPM.addPass(SYCLInternalizer{});
   MPM.addPass(SYCLCP{});
@@ -130,21 +217,31 @@ FusionPipeline::runFusionPasses(Module &Mod, SYCLModuleInfo &InputInfo,
   }
   MPM.run(Mod, MAM);
 
+  assert(!verifyModule(Mod, &errs()) && "Invalid LLVM IR generated");
+
+  auto NewModInfo = MAM.getResult<SYCLModuleInfoAnalysis>(Mod);
+  assert(NewModInfo.ModuleInfo && "Failed to retrieve SYCL module info");
+
+  Error CostErr = CostModelEnabled
+                      ? checkFusedKernelsCost(Mod, *NewModInfo.ModuleInfo,
+                                              InputInfo, InputCost, FusedNDR)
+                      : Error::success();
+
   if (DebugEnabled) {
     // Restore debug option
     jit_compiler::PassDebug = false;
   }
 
-  assert(!verifyModule(Mod, &errs()) && "Invalid LLVM IR generated");
-
-  auto NewModInfo = MAM.getResult<SYCLModuleInfoAnalysis>(Mod);
-  assert(NewModInfo.ModuleInfo && "Failed to retrieve SYCL module info");
+  if (CostErr) {
+    return std::move(CostErr);
+  }
 
   return std::make_unique<SYCLModuleInfo>(std::move(*NewModInfo.ModuleInfo));
 }
 
 bool FusionPipeline::runMaterializerPasses(
-    llvm::Module &Mod, llvm::ArrayRef<unsigned char> SpecConstData) {
+    llvm::Module &Mod, llvm::ArrayRef<unsigned char> SpecConstData,
+    llvm::StringRef KernelName, const NDRange *NDR) {
   PassBuilder PB;
   LoopAnalysisManager LAM;
   FunctionAnalysisManager FAM;
@@ -157,6 +254,11 @@ bool FusionPipeline::runMaterializerPasses(
   PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
 
   ModulePassManager MPM;
+  // Replace the index space getters by the launch configuration, the
+  // following passes make the most of the constants.
+  if (NDR) {
+    MPM.addPass(SYCLNDRangeMaterializer{KernelName, *NDR});
+  }
   // Register inserter and materializer passes.
   {
     FunctionPassManager FPM;
@@ -23,17 +23,21 @@ public:
   /// fusion on the given module. The module should contain the stub functions
   /// and fusion metadata. The given SYCLModuleInfo must contain information
   /// about all input kernels. The returned SYCLModuleInfo will additionally
-  /// contain an entry for the fused kernel.
-  static std::unique_ptr<SYCLModuleInfo>
+  /// contain an entry for the fused kernel. An error is returned if the cost
+  /// model predicts the fused kernel, launched with \p FusedNDR, to perform
+  /// worse than the input kernels.
+  static llvm::Expected<std::unique_ptr<SYCLModuleInfo>>
   runFusionPasses(llvm::Module &Mod, SYCLModuleInfo &InputInfo,
-                  BarrierFlags BarriersFlags);
+                  BarrierFlags BarriersFlags, const NDRange &FusedNDR);
 
   ///
   /// Run the necessary passes in a custom pass pipeline to perform
-  /// materialization of kernel specialization constants.
+  /// materialization of kernel specialization constants and, if \p NDR is
+  /// not null, of the ND-range the kernel \p KernelName is launched with.
   static bool
   runMaterializerPasses(llvm::Module &Mod,
-                        llvm::ArrayRef<unsigned char> SpecConstData);
+                        llvm::ArrayRef<unsigned char> SpecConstData,
+                        llvm::StringRef KernelName, const NDRange *NDR);
 };
 } // namespace fusion
 } // namespace jit_compiler
@@ -23,9 +23,14 @@ size_t KernelBinary::size() const { return Blob.size(); }
 
 BinaryFormat KernelBinary::format() const { return Format; }
 
-JITContext::JITContext() : LLVMCtx{new llvm::LLVMContext}, Binaries{} {}
+JITContext::JITContext() : Binaries{} {}
 
-llvm::LLVMContext *JITContext::getLLVMContext() { return LLVMCtx.get(); }
+llvm::LLVMContext *JITContext::getLLVMContext() {
+  // The modules created in a context don't outlive a single invocation of the
+  // JIT compiler, so the context can stay with the thread.
+  static thread_local llvm::LLVMContext LLVMCtx;
+  return &LLVMCtx;
+}
 
 std::optional<SYCLKernelInfo>
 JITContext::getCacheEntry(CacheKeyT &Identifier) const {
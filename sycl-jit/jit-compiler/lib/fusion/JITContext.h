@@ -66,6 +66,9 @@ public:
     return Instance;
   }
 
+  ///
+  /// Get the LLVM context of the calling thread. Each thread compiles in its
+  /// own context, so that independent JIT compilations run in parallel.
   llvm::LLVMContext *getLLVMContext();
 
   template <typename... Ts> KernelBinary &emplaceKernelBinary(Ts &&...Args) {
@@ -92,8 +95,6 @@ private:
 
   using WriteLockT = std::unique_lock<MutexT>;
 
-  std::unique_ptr<llvm::LLVMContext> LLVMCtx;
-
   MutexT BinariesMutex;
 
   std::vector<KernelBinary> Binaries;
@@ -237,10 +237,15 @@ KernelTranslator::translateToPTX(SYCLKernelInfo &KernelInfo, llvm::Module &Mod,
   return createStringError(inconvertibleErrorCode(),
                            "PTX translation not supported in this build");
 #else  // JIT_SUPPORT_PTX
-  LLVMInitializeNVPTXTargetInfo();
-  LLVMInitializeNVPTXTarget();
-  LLVMInitializeNVPTXAsmPrinter();
-  LLVMInitializeNVPTXTargetMC();
+  // The target registration is not thread-safe, only do it once.
+  static const bool TargetInitialized = []() {
+    LLVMInitializeNVPTXTargetInfo();
+    LLVMInitializeNVPTXTarget();
+    LLVMInitializeNVPTXAsmPrinter();
+    LLVMInitializeNVPTXTargetMC();
+    return true;
+  }();
+  (void)TargetInitialized;
 
   static const char *TARGET_CPU_ATTRIBUTE = "target-cpu";
   static const char *TARGET_FEATURE_ATTRIBUTE = "target-features";
@@ -321,10 +326,15 @@ KernelTranslator::translateToAMDGCN(SYCLKernelInfo &KernelInfo,
                            "AMDGPU translation not supported in this build");
 #else  // JIT_SUPPORT_AMDGCN
 
-  LLVMInitializeAMDGPUTargetInfo();
-  LLVMInitializeAMDGPUTarget();
-  LLVMInitializeAMDGPUAsmPrinter();
-  LLVMInitializeAMDGPUTargetMC();
+  // The target registration is not thread-safe, only do it once.
+  static const bool TargetInitialized = []() {
+    LLVMInitializeAMDGPUTargetInfo();
+    LLVMInitializeAMDGPUTarget();
+    LLVMInitializeAMDGPUAsmPrinter();
+    LLVMInitializeAMDGPUTargetMC();
+    return true;
+  }();
+  (void)TargetInitialized;
 
   static const char *TARGET_CPU_ATTRIBUTE = "target-cpu";
   static const char *TARGET_FEATURE_ATTRIBUTE = "target-features";
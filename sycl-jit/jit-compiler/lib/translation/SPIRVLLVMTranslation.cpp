@@ -15,13 +15,62 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
+#include "llvm/Transforms/Utils/Cloning.h"
 #include <iostream>
+#include <list>
 #include <sstream>
 
 using namespace jit_compiler;
 using namespace jit_compiler::translation;
 using namespace llvm;
 
+namespace {
+///
+/// Modules translated from the SPIR-V images most recently loaded by the
+/// calling thread, keyed by the hash of the image. Fusion and materialization
+/// mostly run against the same few device images, whose module is then cloned
+/// instead of parsing and translating the whole binary again.
+class TranslatedSPIRVCache {
+public:
+  ///
+  /// Get the cache of the calling thread. The modules live in the LLVM context
+  /// of the thread, which is created before and thus outlives the cache.
+  static TranslatedSPIRVCache &getInstance() {
+    static thread_local TranslatedSPIRVCache Cache;
+    return Cache;
+  }
+
+  std::unique_ptr<Module> lookup(StringRef Image) {
+    uint64_t Hash = xxh3_64bits(Image);
+    for (auto It = Entries.begin(); It != Entries.end(); ++It) {
+      if (It->Hash == Hash && It->Size == Image.size()) {
+        Entries.splice(Entries.begin(), Entries, It);
+        return CloneModule(*It->Mod);
+      }
+    }
+    return nullptr;
+  }
+
+  void insert(StringRef Image, const Module &Mod) {
+    if (Entries.size() == Capacity)
+      Entries.pop_back();
+    Entries.push_front({xxh3_64bits(Image), Image.size(), CloneModule(Mod)});
+  }
+
+private:
+  static constexpr size_t Capacity = 8;
+
+  struct Entry {
+    uint64_t Hash;
+    size_t Size;
+    std::unique_ptr<Module> Mod;
+  };
+
+  std::list<Entry> Entries;
+};
+} // namespace
+
 SPIRV::TranslatorOpts &SPIRVLLVMTranslator::translatorOpts() {
   static auto Opts = []() -> SPIRV::TranslatorOpts {
     // Options for translation between SPIR-V and LLVM IR.
@@ -61,17 +110,26 @@ SPIRVLLVMTranslator::loadSPIRVKernel(llvm::LLVMContext &LLVMCtx,
   assert(BinInfo.Format == BinaryFormat::SPIRV &&
          "Only SPIR-V supported as input");
 
-  // Create an input stream for the SPIR-V binary.
-  std::stringstream SPIRStream(
-      std::string(reinterpret_cast<const char *>(BinInfo.BinaryStart),
-                  BinInfo.BinarySize),
-      std::ios_base::in | std::ios_base::binary);
+  StringRef Image{reinterpret_cast<const char *>(BinInfo.BinaryStart),
+                  BinInfo.BinarySize};
+  // Only modules of the thread's own context are cached, as the cache must
+  // not outlive the context.
+  TranslatedSPIRVCache *Cache =
+      &LLVMCtx == JITContext::getInstance().getLLVMContext()
+          ? &TranslatedSPIRVCache::getInstance()
+          : nullptr;
+  if (Cache) {
+    if (auto CachedMod = Cache->lookup(Image))
+      return std::move(CachedMod);
+  }
+
   std::string ErrMsg;
   // Create a raw pointer. readSpirv accepts a reference to a pointer,
   // so it will reset the pointer to point to an actual LLVM module.
+  // The SPIR-V binary is decoded in place, without copying it into a stream.
   Module *LLVMMod;
-  auto Success =
-      llvm::readSpirv(LLVMCtx, translatorOpts(), SPIRStream, LLVMMod, ErrMsg);
+  auto Success = llvm::readSpirv(LLVMCtx, translatorOpts(), Image.data(),
+                                 Image.size(), LLVMMod, ErrMsg);
   if (!Success) {
     return createStringError(
         inconvertibleErrorCode(),
@@ -79,6 +137,8 @@ SPIRVLLVMTranslator::loadSPIRVKernel(llvm::LLVMContext &LLVMCtx,
         ErrMsg.c_str());
   }
   std::unique_ptr<Module> NewMod{LLVMMod};
+  if (Cache)
+    Cache->insert(Image, *NewMod);
 
   return std::move(NewMod);
 }
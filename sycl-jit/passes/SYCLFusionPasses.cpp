@@ -12,6 +12,7 @@
 #include "Kernel.h"
 
 #include "internalization/Internalization.h"
+#include "kernel-fusion/SYCLBarrierElimination.h"
 #include "kernel-fusion/SYCLKernelFusion.h"
 #include "kernel-fusion/SYCLSpecConstMaterializer.h"
 #include "kernel-info/SYCLKernelInfo.h"
@@ -42,6 +43,10 @@ llvm::PassPluginLibraryInfo getSYCLKernelFusionPluginInfo() {
                 MPM.addPass(SYCLInternalizer());
                 return true;
               }
+              if (Name == "sycl-barrier-elimination") {
+                MPM.addPass(SYCLBarrierElimination());
+                return true;
+              }
               if (Name == "sycl-cp") {
                 MPM.addPass(SYCLCP());
                 return true;
@@ -0,0 +1,230 @@
+//==--------------------- SYCLBarrierElimination.cpp -----------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SYCLBarrierElimination.h"
+
+#include "SYCLKernelFusion.h"
+#include "debug/PassDebug.h"
+#include "target/TargetFusionInfo.h"
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/ScalarEvolutionExpressions.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/Module.h"
+
+using namespace llvm;
+using namespace jit_compiler;
+
+namespace {
+///
+/// Bytes accessed by a work-item through a kernel argument:
+/// [Begin, End) + Uniform + Stride * GlobalID, Uniform being the same for all
+/// the work-items.
+struct Footprint {
+  const SCEV *Uniform;
+  int64_t Stride;
+  int64_t Begin;
+  int64_t End;
+};
+
+class BarrierEliminator {
+public:
+  BarrierEliminator(Function &F, ScalarEvolution &SE,
+                    const TargetFusionInfo &TargetInfo)
+      : F{F}, SE{SE}, TargetInfo{TargetInfo} {}
+
+  ///
+  /// Removes the elidable barriers of the function if the work-items access
+  /// disjoint memory.
+  /// \return Whether barriers were removed.
+  bool run();
+
+private:
+  std::optional<BuiltinKind> getBuiltinKind(const Value *V) const;
+  bool isUniform(const Value *V, unsigned Depth = 0) const;
+  bool isUniform(const SCEV *S) const;
+  bool isGlobalID(const SCEV *S) const;
+  std::optional<Footprint> getFootprint(const SCEV *Offset,
+                                        uint64_t Size) const;
+  bool addAccess(Value *Ptr, Type *AccessTy, bool IsStore);
+
+  Function &F;
+  ScalarEvolution &SE;
+  const TargetFusionInfo &TargetInfo;
+  // Footprints of the accesses through each argument, merged.
+  DenseMap<const Argument *, Footprint> Footprints;
+  SmallPtrSet<const Argument *, 8> StoredArgs;
+};
+} // namespace
+
+std::optional<BuiltinKind>
+BarrierEliminator::getBuiltinKind(const Value *V) const {
+  const auto *Call = dyn_cast<CallInst>(V);
+  if (!Call || !Call->getCalledFunction()) {
+    return {};
+  }
+  return TargetInfo.getBuiltinKind(Call->getCalledFunction());
+}
+
+bool BarrierEliminator::isUniform(const Value *V, unsigned Depth) const {
+  static constexpr unsigned MaxDepth{6};
+  if (isa<Argument, Constant>(V)) {
+    return true;
+  }
+  if (Depth == MaxDepth) {
+    return false;
+  }
+  if (auto Kind = getBuiltinKind(V)) {
+    // The sizes and the offset of the index space are the same for all the
+    // work-items.
+    switch (*Kind) {
+    case BuiltinKind::GlobalSizeRemapper:
+    case BuiltinKind::GlobalOffsetRemapper:
+    case BuiltinKind::NumWorkGroupsRemapper:
+    case BuiltinKind::LocalSizeRemapper:
+      return isa<Constant>(cast<CallInst>(V)->getArgOperand(0));
+    default:
+      return false;
+    }
+  }
+  if (!isa<CastInst, BinaryOperator, CmpInst, SelectInst>(V)) {
+    return false;
+  }
+  return all_of(cast<Instruction>(V)->operands(),
+                [&](const Use &Op) { return isUniform(Op.get(), Depth + 1); });
+}
+
+bool BarrierEliminator::isUniform(const SCEV *S) const {
+  return !SCEVExprContains(S, [&](const SCEV *E) {
+    if (isa<SCEVAddRecExpr>(E)) {
+      return true;
+    }
+    const auto *U = dyn_cast<SCEVUnknown>(E);
+    return U && !isUniform(U->getValue());
+  });
+}
+
+bool BarrierEliminator::isGlobalID(const SCEV *S) const {
+  const auto *U = dyn_cast<SCEVUnknown>(S);
+  if (!U) {
+    return false;
+  }
+  auto Kind = getBuiltinKind(U->getValue());
+  if (!Kind || *Kind != BuiltinKind::GlobalIDRemapper) {
+    return false;
+  }
+  // As the fused ND-range is one-dimensional, the first dimension identifies
+  // the work-item.
+  const auto *Dim =
+      dyn_cast<ConstantInt>(cast<CallInst>(U->getValue())->getArgOperand(0));
+  return Dim && Dim->isZero();
+}
+
+std::optional<Footprint> BarrierEliminator::getFootprint(const SCEV *Offset,
+                                                         uint64_t Size) const {
+  // Split the offset into a constant, a multiple of the global ID and terms
+  // uniform across the work-items.
+  SmallVector<const SCEV *> Terms;
+  if (const auto *Add = dyn_cast<SCEVAddExpr>(Offset)) {
+    Terms.append(Add->op_begin(), Add->op_end());
+  } else {
+    Terms.push_back(Offset);
+  }
+  Footprint FP{nullptr, 0, 0, 0};
+  SmallVector<const SCEV *> UniformTerms;
+  for (const SCEV *Term : Terms) {
+    if (const auto *C = dyn_cast<SCEVConstant>(Term)) {
+      FP.Begin += C->getAPInt().getSExtValue();
+      continue;
+    }
+    const SCEV *ID = Term;
+    int64_t Stride = 1;
+    if (const auto *Mul = dyn_cast<SCEVMulExpr>(Term);
+        Mul && Mul->getNumOperands() == 2 &&
+        isa<SCEVConstant>(Mul->getOperand(0))) {
+      ID = Mul->getOperand(1);
+      Stride = cast<SCEVConstant>(Mul->getOperand(0))
+                   ->getAPInt()
+                   .getSExtValue();
+    }
+    if (isGlobalID(ID)) {
+      if (FP.Stride != 0) {
+        return {};
+      }
+      FP.Stride = Stride;
+      continue;
+    }
+    if (!isUniform(Term)) {
+      return {};
+    }
+    UniformTerms.push_back(Term);
+  }
+  if (FP.Stride <= 0) {
+    // The accessed bytes don't move forward with the global ID.
+    return {};
+  }
+  FP.End = FP.Begin + static_cast<int64_t>(Size);
+  FP.Uniform = UniformTerms.empty() ? SE.getZero(Offset->getType())
+                                    : SE.getAddExpr(UniformTerms);
+  return FP;
+}
+
+bool BarrierEliminator::addAccess(Value *Ptr, Type *AccessTy, bool IsStore) {
+  const unsigned AS = Ptr->getType()->getPointerAddressSpace();
+  if (AS == TargetInfo.getPrivateAddressSpace() ||
+      AS == TargetInfo.getLocalAddressSpace()) {
+    // Private memory is not shared and the kernels don't share local memory.
+    return true;
+  }
+  if (!IsStore) {
+    if (const auto *GV = dyn_cast<GlobalVariable>(getUnderlyingObject(Ptr));
+        GV && GV->isConstant()) {
+      return true;
+    }
+  }
+
+  const auto Size = F.getDataLayout().getTypeStoreSize(AccessTy);
+  if (Size.isScalable()) {
+    return false;
+  }
+  const SCEV *PtrSCEV = SE.getSCEV(Ptr);
+  const auto *Base = dyn_cast<SCEVUnknown>(SE.getPointerBase(PtrSCEV));
+  if (!Base || !isa<Argument>(Base->getValue())) {
+    return false;
+  }
+  const auto *Arg = cast<Argument>(Base->getValue());
+  const SCEV *Offset = SE.getMinusSCEV(PtrSCEV, Base);
+  if (isa<SCEVCouldNotCompute>(Offset)) {
+    return false;
+  }
+
+  if (IsStore) {
+    StoredArgs.insert(Arg);
+  }
+  // Accesses whose footprint is unknown are fine as long as the argument is
+  // only loaded from.
+  auto FP = getFootprint(Offset, Size.getFixedValue());
+  auto [It, Inserted] =
+      Footprints.try_emplace(Arg, FP.value_or(Footprint{nullptr, 0, 0, 0}));
+  if (Inserted) {
+    return true;
+  }
+  Footprint &Merged = It->second;
+  // Footprints of different accesses can only be compared if they move with
+  // the global ID in the same way.
+  if (!FP || Merged.Uniform != FP->Uniform || Merged.Stride != FP->Stride) {
+    Merged.Stride = 0;
+    return true;
+  }
+  Merged.Begin = std::min(Merged.Begin, FP->Begin);
+  Merged.End = std::max(Merged.End, FP->End);
+  return true;
+}
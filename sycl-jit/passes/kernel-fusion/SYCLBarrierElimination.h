@@ -0,0 +1,33 @@
+//==---------------------- SYCLBarrierElimination.h ------------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_BARRIER_ELIMINATION_H
+#define SYCL_BARRIER_ELIMINATION_H
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+///
+/// Pass removing the barriers SYCLKernelFusion inserts between the kernels of
+/// a fused kernel if no work-item can observe the memory accesses of another
+/// one. This is the case if each work-item only accesses its own slice,
+/// selected by its global ID, of the kernel arguments stored to. Once the
+/// barriers are gone, the following optimizations forward the values stored
+/// by a kernel to the loads of the next ones, internalizing them in
+/// registers.
+///
+/// Only the barriers marked as elidable by SYCLKernelFusion are removed, the
+/// marker guarantees that distinct kernel arguments don't overlap.
+class SYCLBarrierElimination : public PassInfoMixin<SYCLBarrierElimination> {
+public:
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+};
+} // namespace llvm
+
+#endif // SYCL_BARRIER_ELIMINATION_H
@@ -240,6 +240,12 @@ static Expected<CallInst *> createFusionCall(
     const jit_compiler::NDRange &FusedNDRange, bool IsLast,
     jit_compiler::BarrierFlags BarriersFlags, jit_compiler::Remapper &Remapper,
     bool ShouldRemap, TargetFusionInfo &TargetInfo) {
+  // The barriers may only be removed if all the work-items run all the
+  // kernels, i.e., they are not guarded, and the global ID identifies the
+  // work-item in a single dimension.
+  const bool BarrierIsElidable =
+      jit_compiler::hasElidableBarrierFlag(BarriersFlags) && !ShouldRemap &&
+      FusedNDRange.getDimensions() == 1;
   const auto IPs = addGuard(Builder, TargetInfo, SrcNDRange, FusedNDRange);
 
   if (ShouldRemap) {
@@ -267,7 +273,16 @@ static Expected<CallInst *> createFusionCall(
 
   // Insert barrier if needed
   if (!IsLast && !jit_compiler::isNoBarrierFlag(BarriersFlags)) {
+    Instruction *Last = IPs.Exit->empty() ? nullptr : &IPs.Exit->back();
     TargetInfo.createBarrierCall(Builder, BarriersFlags);
+    if (BarrierIsElidable) {
+      auto *MD = MDNode::get(Builder.getContext(), {});
+      for (Instruction &I : make_range(
+               Last ? std::next(Last->getIterator()) : IPs.Exit->begin(),
+               IPs.Exit->end())) {
+        I.setMetadata(SYCLKernelFusion::ElidableBarrierMDKey, MD);
+      }
+    }
   }
 
   // Set insert point for future insertions
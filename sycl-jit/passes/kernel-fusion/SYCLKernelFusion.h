@@ -34,6 +34,10 @@ class SYCLKernelFusion : public llvm::PassInfoMixin<SYCLKernelFusion> {
 public:
   constexpr static llvm::StringLiteral NDRangeMDKey{"sycl.kernel.nd-range"};
   constexpr static llvm::StringLiteral NDRangesMDKey{"sycl.kernel.nd-ranges"};
+  /// Marks the barriers between the fused kernels which may be removed by
+  /// SYCLBarrierElimination.
+  constexpr static llvm::StringLiteral ElidableBarrierMDKey{
+      "sycl.kernel.fusion.elidable-barrier"};
 
   constexpr SYCLKernelFusion() = default;
   constexpr explicit SYCLKernelFusion(jit_compiler::BarrierFlags BarriersFlags)
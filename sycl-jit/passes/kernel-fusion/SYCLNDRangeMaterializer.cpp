@@ -0,0 +1,41 @@
+//==--------------------- SYCLNDRangeMaterializer.cpp ----------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "SYCLNDRangeMaterializer.h"
+
+#include "Builtins.h"
+#include "debug/PassDebug.h"
+#include "target/TargetFusionInfo.h"
+
+#include "llvm/IR/Module.h"
+
+using namespace llvm;
+using namespace jit_compiler;
+
+PreservedAnalyses SYCLNDRangeMaterializer::run(Module &M,
+                                               ModuleAnalysisManager &) {
+  Function *Kernel = M.getFunction(KernelName);
+  // Without a local size, the local and group IDs depend on the work-group
+  // size the backend picks, so they cannot be materialized.
+  if (!Kernel || Kernel->isDeclaration() || !NDR.hasSpecificLocalSize())
+    return PreservedAnalyses::all();
+
+  // Remapping the builtins from the ND-range to itself replaces the sizes and
+  // the offset by constants and keeps the IDs, see Remapper.
+  TargetFusionInfo TargetInfo{&M};
+  Remapper BuiltinsRemapper{TargetInfo};
+  if (auto Err = TargetInfo.scanForBuiltinsToRemap(Kernel, BuiltinsRemapper,
+                                                   NDR, NDR)) {
+    // The calls remapped so far are valid, the others are left as they are.
+    handleAllErrors(std::move(Err), [](const StringError &EL) {
+      FUSION_DEBUG(dbgs() << "WARNING: ND-range not fully materialized: "
+                          << EL.message() << "\n");
+    });
+  }
+  return PreservedAnalyses::none();
+}
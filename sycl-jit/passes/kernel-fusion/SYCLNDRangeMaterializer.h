@@ -0,0 +1,38 @@
+//==---------------------- SYCLNDRangeMaterializer.h -----------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SYCL_ND_RANGE_MATERIALIZER_H
+#define SYCL_ND_RANGE_MATERIALIZER_H
+
+#include "Kernel.h"
+
+#include "llvm/IR/PassManager.h"
+
+namespace llvm {
+
+///
+/// Pass to materialize the ND-range a kernel is launched with. The index space
+/// getters for the global size, the local size, the number of work-groups and
+/// the global offset called by the kernel, directly or through other
+/// functions, are replaced by the values they return when the kernel is
+/// launched with the given ND-range. This enables the unrolling of loops over
+/// the work-group and the simplification of the index computations.
+class SYCLNDRangeMaterializer : public PassInfoMixin<SYCLNDRangeMaterializer> {
+public:
+  SYCLNDRangeMaterializer(StringRef KernelName, jit_compiler::NDRange NDR)
+      : KernelName(KernelName), NDR(NDR) {}
+
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &);
+
+private:
+  StringRef KernelName;
+  jit_compiler::NDRange NDR;
+};
+} // namespace llvm
+
+#endif // SYCL_ND_RANGE_MATERIALIZER_H
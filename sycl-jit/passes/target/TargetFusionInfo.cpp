@@ -12,6 +12,8 @@
 #include "Kernel.h"
 #include "NDRangesHelper.h"
 
+#include "llvm/ADT/PostOrderIterator.h"
+#include "llvm/IR/CFG.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/InstIterator.h"
 #include "llvm/IR/InstrTypes.h"
@@ -52,6 +54,20 @@ using jit_compiler::Remapper;
 
 using jit_compiler::requireIDRemapping;
 
+///
+/// Resources of a compute unit, i.e., an SM on NVPTX, a CU on AMDGCN and a
+/// subslice on SPIR-V devices, which limit the number of resident work-items.
+struct ComputeUnitResources {
+  /// 32-bit registers shared by the work-items of the compute unit.
+  unsigned Registers;
+  /// 32-bit registers a single work-item can use without spilling.
+  unsigned MaxRegistersPerWorkItem;
+  /// Granularity the registers of a work-item are allocated with.
+  unsigned RegisterGranularity;
+  unsigned MaxWorkItems;
+  uint64_t LocalMemBytes;
+};
+
 class TargetFusionInfoImpl {
 
 public:
@@ -77,6 +93,8 @@ public:
 
   virtual unsigned getLocalAddressSpace() const = 0;
 
+  virtual ComputeUnitResources getComputeUnitResources() const = 0;
+
   virtual void
   updateAddressSpaceMetadata([[maybe_unused]] Function *KernelFunc,
                              [[maybe_unused]] ArrayRef<bool> ArgIsPromoted,
@@ -209,7 +227,8 @@ public:
       return;
     }
 
-    static const auto FnAttrs = AttributeSet::get(
+    // Attributes belong to a context, don't keep them across modules.
+    const auto FnAttrs = AttributeSet::get(
         LLVMMod->getContext(),
         {Attribute::get(LLVMMod->getContext(), Attribute::AttrKind::Convergent),
          Attribute::get(LLVMMod->getContext(), Attribute::AttrKind::NoUnwind)});
@@ -253,6 +272,14 @@ public:
   unsigned getPrivateAddressSpace() const override { return 0; }
   unsigned getLocalAddressSpace() const override { return 3; }
 
+  ComputeUnitResources getComputeUnitResources() const override {
+    // Intel GPU subslice with the large register file mode disabled: 8 EUs
+    // with 8 threads of 128 GRFs each, shared by 16 work-items per thread.
+    return {/*Registers*/ 131072, /*MaxRegistersPerWorkItem*/ 64,
+            /*RegisterGranularity*/ 1, /*MaxWorkItems*/ 2048,
+            /*LocalMemBytes*/ 64 * 1024};
+  }
+
   void updateAddressSpaceMetadata(Function *KernelFunc,
                                   ArrayRef<bool> ArgIsPromoted,
                                   unsigned AddressSpace) const override {
@@ -740,6 +767,13 @@ public:
   unsigned getPrivateAddressSpace() const override { return 0; }
   unsigned getLocalAddressSpace() const override { return 3; }
 
+  ComputeUnitResources getComputeUnitResources() const override {
+    // SM of compute capability 7.0 and newer.
+    return {/*Registers*/ 65536, /*MaxRegistersPerWorkItem*/ 255,
+            /*RegisterGranularity*/ 8, /*MaxWorkItems*/ 2048,
+            /*LocalMemBytes*/ 64 * 1024};
+  }
+
   std::optional<BuiltinKind> getBuiltinKind(Function *F) const override {
     // PTX doesn't have intrinsics for global sizes and global IDs:
     // https://www.llvm.org/docs/NVPTXUsage.html#reading-ptx-special-registers
@@ -850,6 +884,14 @@ public:
   unsigned getLocalAddressSpace() const override { return 3; }
   unsigned getConstantAddressSpace() const { return 4; }
 
+  ComputeUnitResources getComputeUnitResources() const override {
+    // CU of the GCN and CDNA architectures: 4 SIMDs with 512 VGPRs per lane
+    // and up to 10 wavefronts of 64 work-items each.
+    return {/*Registers*/ 65536, /*MaxRegistersPerWorkItem*/ 256,
+            /*RegisterGranularity*/ 4, /*MaxWorkItems*/ 2560,
+            /*LocalMemBytes*/ 64 * 1024};
+  }
+
   std::optional<BuiltinKind> getBuiltinKind(Function *F) const override {
     if (!F->isIntrinsic())
       return {};
@@ -1201,6 +1243,130 @@ Function *TargetFusionInfo::createRemapperFunction(
                                       FusedNDRange);
 }
 
+static unsigned getRegisterCount(const Value *V, const DataLayout &DL) {
+  Type *Ty = V->getType();
+  if (!Ty->isSized()) {
+    return 0;
+  }
+  return divideCeil(DL.getTypeSizeInBits(Ty).getKnownMinValue(), 32);
+}
+
+///
+/// Maximum number of 32-bit registers needed by the values live at the same
+/// time in \p F. The arguments are not counted, as they are mostly held in
+/// constant memory.
+static unsigned estimateRegisterPressure(Function *F) {
+  const DataLayout &DL = F->getDataLayout();
+  DenseMap<const BasicBlock *, SmallPtrSet<const Value *, 16>> LiveIn;
+  const auto Analyze = [&](const BasicBlock &BB, bool &Changed) {
+    SmallPtrSet<const Value *, 16> Live;
+    unsigned Pressure = 0;
+    const auto Use = [&](const Value *V) {
+      if (isa<Instruction>(V) && Live.insert(V).second) {
+        Pressure += getRegisterCount(V, DL);
+      }
+    };
+    const auto Def = [&](const Value *V) {
+      if (Live.erase(V)) {
+        Pressure -= getRegisterCount(V, DL);
+      }
+    };
+    for (const BasicBlock *Succ : successors(&BB)) {
+      for (const Value *V : LiveIn[Succ]) {
+        Use(V);
+      }
+      for (const PHINode &Phi : Succ->phis()) {
+        Use(Phi.getIncomingValueForBlock(&BB));
+      }
+    }
+    unsigned MaxPressure = Pressure;
+    for (const Instruction &I : reverse(BB)) {
+      if (isa<PHINode>(I)) {
+        break;
+      }
+      Def(&I);
+      for (const Value *Op : I.operands()) {
+        Use(Op);
+      }
+      MaxPressure = std::max(MaxPressure, Pressure);
+    }
+    for (const PHINode &Phi : BB.phis()) {
+      Use(&Phi);
+    }
+    MaxPressure = std::max(MaxPressure, Pressure);
+    for (const PHINode &Phi : BB.phis()) {
+      Def(&Phi);
+    }
+    auto &BBLiveIn = LiveIn[&BB];
+    if (BBLiveIn.size() != Live.size()) {
+      BBLiveIn = std::move(Live);
+      Changed = true;
+    }
+    return MaxPressure;
+  };
+
+  // The live sets only grow, so they are recomputed until their sizes don't
+  // change anymore.
+  unsigned MaxPressure = 0;
+  for (bool Changed = true; Changed;) {
+    Changed = false;
+    MaxPressure = 0;
+    for (const BasicBlock *BB : post_order(&F->getEntryBlock())) {
+      MaxPressure = std::max(MaxPressure, Analyze(*BB, Changed));
+    }
+  }
+  return MaxPressure;
+}
+
+static bool isUsedIn(const Value *V, const Function *F) {
+  return any_of(V->users(), [F](const User *U) {
+    if (const auto *I = dyn_cast<Instruction>(U)) {
+      return I->getFunction() == F;
+    }
+    return isa<ConstantExpr>(U) && isUsedIn(U, F);
+  });
+}
+
+KernelFootprint TargetFusionInfo::estimateFootprint(Function *F) const {
+  KernelFootprint FP;
+  FP.Registers = estimateRegisterPressure(F);
+  // Only the local memory allocated statically is known, the size of local
+  // accessors is decided at launch.
+  const unsigned LocalAS = getLocalAddressSpace();
+  const DataLayout &DL = F->getDataLayout();
+  for (const GlobalVariable &GV : F->getParent()->globals()) {
+    if (GV.getAddressSpace() == LocalAS && isUsedIn(&GV, F)) {
+      FP.LocalMemBytes += DL.getTypeAllocSize(GV.getValueType());
+    }
+  }
+  return FP;
+}
+
+double TargetFusionInfo::estimateOccupancy(const KernelFootprint &FP,
+                                           const NDRange &ND) const {
+  const ComputeUnitResources CU = Impl->getComputeUnitResources();
+  // Kernels needing more registers than a work-item can use spill the rest.
+  const unsigned Registers =
+      alignTo(std::clamp(FP.Registers, 1u, CU.MaxRegistersPerWorkItem),
+              CU.RegisterGranularity);
+  uint64_t Resident = std::min<uint64_t>(CU.MaxWorkItems,
+                                         CU.Registers / Registers);
+  uint64_t WGSize = 1;
+  if (ND.hasSpecificLocalSize()) {
+    WGSize = NDRange::linearize(ND.getLocalSize());
+  }
+  if (FP.LocalMemBytes) {
+    Resident = std::min(Resident, CU.LocalMemBytes / FP.LocalMemBytes * WGSize);
+  }
+  // Work-groups are resident as a whole.
+  Resident -= Resident % WGSize;
+  return static_cast<double>(Resident) / CU.MaxWorkItems;
+}
+
+bool TargetFusionInfo::exceedsRegisterFile(const KernelFootprint &FP) const {
+  return FP.Registers > Impl->getComputeUnitResources().MaxRegistersPerWorkItem;
+}
+
 //
 // MetadataCollection
 //
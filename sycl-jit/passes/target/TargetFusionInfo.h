@@ -20,6 +20,16 @@ namespace llvm {
 
 class TargetFusionInfoImpl;
 
+///
+/// Estimated resources needed to execute a kernel, see
+/// TargetFusionInfo::estimateFootprint.
+struct KernelFootprint {
+  /// Number of 32-bit registers live at the same time in a work-item.
+  unsigned Registers = 0;
+  /// Bytes of local memory statically allocated by a work-group.
+  uint64_t LocalMemBytes = 0;
+};
+
 ///
 /// Common interface to target-specific logic around handling of kernel
 /// functions.
@@ -117,6 +127,24 @@ public:
                          const jit_compiler::NDRange &SrcNDRange,
                          const jit_compiler::NDRange &FusedNDRange) const;
 
+  ///
+  /// Estimate the registers a work-item of \p F and the local memory a
+  /// work-group of \p F need. The registers are estimated from the values live
+  /// at the same time in the LLVM IR, before register allocation.
+  KernelFootprint estimateFootprint(Function *F) const;
+
+  ///
+  /// Estimate the fraction of the work-items a compute unit can hold that are
+  /// resident when executing a kernel with footprint \p FP and the local size
+  /// of \p ND.
+  double estimateOccupancy(const KernelFootprint &FP,
+                           const jit_compiler::NDRange &ND) const;
+
+  ///
+  /// Check whether the registers of a work-item with footprint \p FP exceed
+  /// the registers the target provides to a work-item, causing spills.
+  bool exceedsRegisterFile(const KernelFootprint &FP) const;
+
 private:
   using ImplPtr = std::shared_ptr<TargetFusionInfoImpl>;
 
@@ -0,0 +1,77 @@
+# Collects the BOLT profile of the SYCL runtime library by running the
+# training workloads listed in bolt-workloads.txt, then writes it to PROFILE.
+#
+# Expects MODE, Instrument, Perf or LBR, BENCHMARKS, the benchmarks binary,
+# WORKLOADS, MERGE_FDATA, PROFILE_DIR and PROFILE. With Instrument, expects
+# INSTRUMENTED_DIR, the directory of the library instrumented by BOLT, which
+# writes its profiles to PROFILE_DIR. Otherwise expects SYCL_LIBRARY,
+# PERF2BOLT, optionally PERF_TOOL, the perf binary, and REORDER_DATA.
+
+string(TOUPPER "${MODE}" MODE)
+if(NOT DEFINED PERF_TOOL)
+  set(PERF_TOOL perf)
+endif()
+
+file(REMOVE_RECURSE ${PROFILE_DIR})
+file(MAKE_DIRECTORY ${PROFILE_DIR})
+
+if(MODE STREQUAL "INSTRUMENT")
+  # The instrumented library writes a profile for each process when it is
+  # unloaded, see --instrumentation-file-append-pid.
+  set(ENV{LD_LIBRARY_PATH} "${INSTRUMENTED_DIR}:$ENV{LD_LIBRARY_PATH}")
+elseif(MODE STREQUAL "LBR")
+  set(perf_events -e cycles:u -j any,u)
+  # The data reordering needs the addresses of the loads.
+  if(REORDER_DATA)
+    list(APPEND perf_events -e cpu/mem-loads,ldlat=30/Pu)
+  endif()
+else()
+  set(perf_events -e cycles:u)
+endif()
+
+file(STRINGS ${WORKLOADS} workloads REGEX "^[^#]")
+set(run 0)
+foreach(workload IN LISTS workloads)
+  separate_arguments(args NATIVE_COMMAND "${workload}")
+  if(MODE STREQUAL "INSTRUMENT")
+    set(command ${BENCHMARKS} ${args})
+  else()
+    set(command ${PERF_TOOL} record ${perf_events}
+                -o ${PROFILE_DIR}/perf.${run}.data -- ${BENCHMARKS} ${args})
+  endif()
+  message(STATUS "Running ${workload}")
+  execute_process(COMMAND ${command} OUTPUT_QUIET RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "The training workload ${workload} failed: ${result}")
+  endif()
+  math(EXPR run "${run} + 1")
+endforeach()
+
+if(NOT MODE STREQUAL "INSTRUMENT")
+  # Without LBR, the profile is made of the sampled instructions only.
+  if(MODE STREQUAL "PERF")
+    set(no_lbr -nl)
+  endif()
+  math(EXPR last_run "${run} - 1")
+  foreach(index RANGE ${last_run})
+    execute_process(
+      COMMAND ${PERF2BOLT} ${SYCL_LIBRARY} -p ${PROFILE_DIR}/perf.${index}.data
+              -o ${PROFILE_DIR}/prof.${index}.fdata ${no_lbr}
+      OUTPUT_QUIET RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+      message(FATAL_ERROR "perf2bolt failed: ${result}")
+    endif()
+  endforeach()
+endif()
+
+file(GLOB profiles ${PROFILE_DIR}/prof.*.fdata)
+if(NOT profiles)
+  message(FATAL_ERROR "The training workloads wrote no profile to "
+    "${PROFILE_DIR}")
+endif()
+execute_process(COMMAND ${MERGE_FDATA} ${profiles} -o ${PROFILE}
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "merge-fdata failed: ${result}")
+endif()
+message(STATUS "BOLT profile of the SYCL runtime written to ${PROFILE}")
@@ -0,0 +1,81 @@
+//==------ dependencies.cpp - Buffer and USM dependency benchmarks ---------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "harness.hpp"
+
+namespace sycl_bench {
+namespace {
+class BufferChain;
+class BufferIndependent;
+class USMChain;
+class USMIndependent;
+
+// Kernels accessing the same buffer, each depending on the previous one
+// through the scheduler.
+void bufferChain(sycl::queue &Queue, State &S) {
+  sycl::buffer<int, 1> Buf{sycl::range<1>{1}};
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Queue.submit([&](sycl::handler &CGH) {
+      sycl::accessor Acc{Buf, CGH, sycl::read_write};
+      CGH.single_task<BufferChain>([=] { Acc[0] += 1; });
+    });
+  S.stop();
+  Queue.wait();
+}
+
+// Kernels accessing a buffer each, which don't depend on each other.
+void bufferIndependent(sycl::queue &Queue, State &S) {
+  std::vector<sycl::buffer<int, 1>> Bufs;
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Bufs.emplace_back(sycl::range<1>{1});
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Queue.submit([&](sycl::handler &CGH) {
+      sycl::accessor Acc{Bufs[I], CGH, sycl::write_only, sycl::no_init};
+      CGH.single_task<BufferIndependent>([=] { Acc[0] = 1; });
+    });
+  S.stop();
+  Queue.wait();
+}
+
+// The same chain as bufferChain() with USM and explicit dependencies.
+void usmChain(sycl::queue &Queue, State &S) {
+  int *Ptr = sycl::malloc_device<int>(1, Queue);
+  sycl::event Last = Queue.memset(Ptr, 0, sizeof(int));
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Last = Queue.submit([&](sycl::handler &CGH) {
+      CGH.depends_on(Last);
+      CGH.single_task<USMChain>([=] { Ptr[0] += 1; });
+    });
+  S.stop();
+  Queue.wait();
+  sycl::free(Ptr, Queue);
+}
+
+void usmIndependent(sycl::queue &Queue, State &S) {
+  int *Ptr = sycl::malloc_device<int>(S.Iterations, Queue);
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Queue.single_task<USMIndependent>([=] { Ptr[I] = 1; });
+  S.stop();
+  Queue.wait();
+  sycl::free(Ptr, Queue);
+}
+} // namespace
+
+void registerDependencyBenchmarks(Registry &Benchmarks) {
+  Benchmarks.push_back({"dependency/buffer/chain", {}, bufferChain});
+  Benchmarks.push_back(
+      {"dependency/buffer/independent", {}, bufferIndependent});
+  Benchmarks.push_back({"dependency/usm/chain", {}, usmChain});
+  Benchmarks.push_back({"dependency/usm/independent", {}, usmIndependent});
+}
+
+} // namespace sycl_bench
@@ -0,0 +1,67 @@
+//==---------- events.cpp - Event wait latency benchmarks ------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "harness.hpp"
+
+namespace sycl_bench {
+namespace {
+class WaitRoundTrip;
+class WaitCompleted;
+class QueryCompleted;
+class QueueWait;
+
+// Submission of an empty kernel and wait on its event: the latency of a
+// blocking round-trip to the device.
+void waitRoundTrip(sycl::queue &Queue, State &S) {
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Queue.single_task<WaitRoundTrip>([] {}).wait();
+  S.stop();
+}
+
+// Wait on an event which is already complete.
+void waitCompleted(sycl::queue &Queue, State &S) {
+  sycl::event E = Queue.single_task<WaitCompleted>([] {});
+  E.wait();
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    E.wait();
+  S.stop();
+}
+
+// Query of the status of an event which is already complete.
+void queryCompleted(sycl::queue &Queue, State &S) {
+  sycl::event E = Queue.single_task<QueryCompleted>([] {});
+  E.wait();
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    (void)E.get_info<sycl::info::event::command_execution_status>();
+  S.stop();
+}
+
+// Submission of an empty kernel and wait on the queue.
+void queueWait(sycl::queue &Queue, State &S) {
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I) {
+    Queue.single_task<QueueWait>([] {});
+    Queue.wait();
+  }
+  S.stop();
+}
+} // namespace
+
+void registerEventBenchmarks(Registry &Benchmarks) {
+  Benchmarks.push_back({"event/round_trip/in_order", inOrder(), waitRoundTrip});
+  Benchmarks.push_back({"event/round_trip/out_of_order", {}, waitRoundTrip});
+  Benchmarks.push_back({"event/wait_completed", {}, waitCompleted});
+  Benchmarks.push_back({"event/query_completed", {}, queryCompleted});
+  Benchmarks.push_back({"event/queue_wait/in_order", inOrder(), queueWait});
+  Benchmarks.push_back({"event/queue_wait/out_of_order", {}, queueWait});
+}
+
+} // namespace sycl_bench
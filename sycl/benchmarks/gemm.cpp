@@ -0,0 +1,143 @@
+//==----------- gemm.cpp - joint_matrix GEMM library benchmarks ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "harness.hpp"
+
+#ifdef SYCL_BENCH_ONEMKL
+#include <oneapi/mkl/blas.hpp>
+#endif
+
+#include <string>
+
+namespace syclex = sycl::ext::oneapi::experimental;
+
+namespace sycl_bench {
+namespace {
+// Unlike the other benchmarks, these ones are dominated by the device: they
+// compare the GEMM of the matrix extension with the vendor BLAS, when the
+// benchmarks are built with oneMKL.
+constexpr size_t Size = 1024;
+constexpr size_t BatchSize = 16;
+constexpr size_t BatchedSize = 256;
+
+template <typename T> struct Matrices {
+  Matrices(sycl::queue &Queue, size_t Batch, size_t N) : Queue(Queue) {
+    A = sycl::malloc_device<T>(Batch * N * N, Queue);
+    B = sycl::malloc_device<T>(Batch * N * N, Queue);
+    C = sycl::malloc_device<float>(Batch * N * N, Queue);
+    Queue.fill(A, T(1), Batch * N * N);
+    Queue.fill(B, T(1), Batch * N * N);
+    Queue.fill(C, 0.0f, Batch * N * N);
+    Queue.wait();
+  }
+  ~Matrices() {
+    sycl::free(A, Queue);
+    sycl::free(B, Queue);
+    sycl::free(C, Queue);
+  }
+
+  sycl::queue &Queue;
+  T *A;
+  T *B;
+  float *C;
+};
+
+// A Size x Size x Size GEMM.
+template <typename T> void jointMatrixGemm(sycl::queue &Queue, State &S) {
+  Matrices<T> Mats(Queue, 1, Size);
+  syclex::matrix::gemm(Queue, Size, Size, Size, 1.0f, Mats.A, Size, Mats.B,
+                       Size, 0.0f, Mats.C, Size)
+      .wait();
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    syclex::matrix::gemm(Queue, Size, Size, Size, 1.0f, Mats.A, Size, Mats.B,
+                         Size, 0.0f, Mats.C, Size);
+  Queue.wait();
+  S.stop();
+}
+
+// BatchSize GEMMs of BatchedSize x BatchedSize x BatchedSize.
+template <typename T>
+void jointMatrixBatchedGemm(sycl::queue &Queue, State &S) {
+  Matrices<T> Mats(Queue, BatchSize, BatchedSize);
+  constexpr size_t Stride = BatchedSize * BatchedSize;
+  auto Run = [&]() {
+    return syclex::matrix::batched_gemm(
+        Queue, BatchSize, BatchedSize, BatchedSize, BatchedSize, 1.0f, Mats.A,
+        BatchedSize, Stride, Mats.B, BatchedSize, Stride, 0.0f, Mats.C,
+        BatchedSize, Stride);
+  };
+  Run().wait();
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Run();
+  Queue.wait();
+  S.stop();
+}
+
+#ifdef SYCL_BENCH_ONEMKL
+namespace blas = oneapi::mkl::blas::row_major;
+constexpr auto NoTrans = oneapi::mkl::transpose::nontrans;
+
+template <typename T> void oneMKLGemm(sycl::queue &Queue, State &S) {
+  Matrices<T> Mats(Queue, 1, Size);
+  auto Run = [&]() {
+    return blas::gemm(Queue, NoTrans, NoTrans, Size, Size, Size, 1.0f, Mats.A,
+                      Size, Mats.B, Size, 0.0f, Mats.C, Size);
+  };
+  Run().wait();
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Run();
+  Queue.wait();
+  S.stop();
+}
+
+template <typename T> void oneMKLBatchedGemm(sycl::queue &Queue, State &S) {
+  Matrices<T> Mats(Queue, BatchSize, BatchedSize);
+  constexpr size_t Stride = BatchedSize * BatchedSize;
+  auto Run = [&]() {
+    return blas::gemm_batch(Queue, NoTrans, NoTrans, BatchedSize, BatchedSize,
+                            BatchedSize, 1.0f, Mats.A, BatchedSize, Stride,
+                            Mats.B, BatchedSize, Stride, 0.0f, Mats.C,
+                            BatchedSize, Stride, BatchSize);
+  };
+  Run().wait();
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Run();
+  Queue.wait();
+  S.stop();
+}
+#endif
+
+template <typename T>
+void registerGemmBenchmarks(Registry &Benchmarks, const std::string &Type) {
+  std::string Sizes = std::to_string(Size);
+  std::string BatchedSizes =
+      std::to_string(BatchSize) + "x" + std::to_string(BatchedSize);
+  Benchmarks.push_back({"gemm/joint_matrix_" + Type + "_" + Sizes, inOrder(),
+                        jointMatrixGemm<T>});
+  Benchmarks.push_back({"gemm/joint_matrix_batched_" + Type + "_" +
+                            BatchedSizes,
+                        inOrder(), jointMatrixBatchedGemm<T>});
+#ifdef SYCL_BENCH_ONEMKL
+  Benchmarks.push_back(
+      {"gemm/onemkl_" + Type + "_" + Sizes, inOrder(), oneMKLGemm<T>});
+  Benchmarks.push_back({"gemm/onemkl_batched_" + Type + "_" + BatchedSizes,
+                        inOrder(), oneMKLBatchedGemm<T>});
+#endif
+}
+} // namespace
+
+void registerGemmBenchmarks(Registry &Benchmarks) {
+  registerGemmBenchmarks<sycl::ext::oneapi::bfloat16>(Benchmarks, "bf16");
+  registerGemmBenchmarks<sycl::half>(Benchmarks, "fp16");
+}
+
+} // namespace sycl_bench
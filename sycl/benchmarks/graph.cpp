@@ -0,0 +1,87 @@
+//==-------------- graph.cpp - SYCL graph overhead benchmarks --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "harness.hpp"
+
+namespace syclex = sycl::ext::oneapi::experimental;
+
+namespace sycl_bench {
+namespace {
+class GraphKernel;
+
+// Kernels in the graphs of the benchmarks measuring whole graphs.
+constexpr size_t GraphSize = 16;
+
+using ModifiableGraph = syclex::command_graph<syclex::graph_state::modifiable>;
+
+void recordKernels(sycl::queue &Queue, ModifiableGraph &Graph, int *Ptr,
+                   size_t Count) {
+  Graph.begin_recording(Queue);
+  for (size_t I = 0; I < Count; ++I)
+    Queue.single_task<GraphKernel>([=] { Ptr[0] += 1; });
+  Graph.end_recording(Queue);
+}
+
+// Recording of a kernel into a graph.
+void graphRecord(sycl::queue &Queue, State &S) {
+  int *Ptr = sycl::malloc_device<int>(1, Queue);
+  ModifiableGraph Graph{Queue.get_context(), Queue.get_device()};
+  S.start();
+  recordKernels(Queue, Graph, Ptr, S.Iterations);
+  S.stop();
+  sycl::free(Ptr, Queue);
+}
+
+// Finalization of a graph of GraphSize kernels.
+void graphFinalize(sycl::queue &Queue, State &S) {
+  int *Ptr = sycl::malloc_device<int>(1, Queue);
+  ModifiableGraph Graph{Queue.get_context(), Queue.get_device()};
+  recordKernels(Queue, Graph, Ptr, GraphSize);
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    (void)Graph.finalize();
+  S.stop();
+  sycl::free(Ptr, Queue);
+}
+
+// Submission of a finalized graph of GraphSize kernels.
+void graphSubmit(sycl::queue &Queue, State &S) {
+  int *Ptr = sycl::malloc_device<int>(1, Queue);
+  ModifiableGraph Graph{Queue.get_context(), Queue.get_device()};
+  recordKernels(Queue, Graph, Ptr, GraphSize);
+  auto ExecGraph = Graph.finalize();
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Queue.ext_oneapi_graph(ExecGraph);
+  S.stop();
+  Queue.wait();
+  sycl::free(Ptr, Queue);
+}
+
+// Whole graph update of an executable graph of GraphSize kernels.
+void graphUpdate(sycl::queue &Queue, State &S) {
+  int *Ptr = sycl::malloc_device<int>(1, Queue);
+  ModifiableGraph Graph{Queue.get_context(), Queue.get_device()};
+  recordKernels(Queue, Graph, Ptr, GraphSize);
+  auto ExecGraph = Graph.finalize(syclex::property::graph::updatable{});
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    ExecGraph.update(Graph);
+  S.stop();
+  sycl::free(Ptr, Queue);
+}
+} // namespace
+
+void registerGraphBenchmarks(Registry &Benchmarks) {
+  Benchmarks.push_back({"graph/record", inOrder(), graphRecord});
+  Benchmarks.push_back({"graph/finalize", inOrder(), graphFinalize});
+  Benchmarks.push_back({"graph/submit", inOrder(), graphSubmit});
+  Benchmarks.push_back({"graph/update", inOrder(), graphUpdate});
+}
+
+} // namespace sycl_bench
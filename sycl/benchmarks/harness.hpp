@@ -0,0 +1,64 @@
+//==---------- harness.hpp - SYCL runtime overhead benchmarks --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/sycl.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sycl_bench {
+
+/// Passed to a benchmark, which runs Iterations operations and brackets the
+/// part of the work to measure with start() and stop(). The time between the
+/// brackets is accumulated, so setup done outside of them is not measured.
+class State {
+public:
+  State(size_t Iterations) : Iterations(Iterations) {}
+
+  void start() { MStart = std::chrono::steady_clock::now(); }
+  void stop() { MElapsed += std::chrono::steady_clock::now() - MStart; }
+
+  double elapsedNs() const {
+    return std::chrono::duration<double, std::nano>(MElapsed).count();
+  }
+
+  const size_t Iterations;
+
+private:
+  std::chrono::steady_clock::time_point MStart;
+  std::chrono::steady_clock::duration MElapsed{};
+};
+
+using BenchmarkFn = std::function<void(sycl::queue &, State &)>;
+
+struct Benchmark {
+  std::string Name;
+  /// Properties of the queue the benchmark runs on.
+  sycl::property_list QueueProps;
+  BenchmarkFn Fn;
+};
+
+using Registry = std::vector<Benchmark>;
+
+void registerSubmitBenchmarks(Registry &Benchmarks);
+void registerEventBenchmarks(Registry &Benchmarks);
+void registerDependencyBenchmarks(Registry &Benchmarks);
+void registerGraphBenchmarks(Registry &Benchmarks);
+void registerKernelCacheBenchmarks(Registry &Benchmarks);
+void registerGemmBenchmarks(Registry &Benchmarks);
+
+inline sycl::property_list inOrder() {
+  return sycl::property_list{sycl::property::queue::in_order{}};
+}
+
+} // namespace sycl_bench
@@ -0,0 +1,72 @@
+//==------- kernel_cache.cpp - Kernel cache lookup benchmarks --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "harness.hpp"
+
+#include <array>
+#include <utility>
+
+namespace sycl_bench {
+namespace {
+template <size_t I> class CachedKernel;
+
+// Kernels with different names, submitted in turn so that each submission
+// looks up a different kernel in the caches of the runtime.
+constexpr size_t NumKernels = 64;
+
+template <size_t I> void submitKernel(sycl::queue &Queue) {
+  Queue.single_task<CachedKernel<I>>([] {});
+}
+
+template <size_t... Is>
+constexpr std::array<void (*)(sycl::queue &), NumKernels>
+getSubmitters(std::index_sequence<Is...>) {
+  return {submitKernel<Is>...};
+}
+
+void submitManyKernels(sycl::queue &Queue, State &S) {
+  constexpr auto Submitters =
+      getSubmitters(std::make_index_sequence<NumKernels>{});
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Submitters[I % NumKernels](Queue);
+  S.stop();
+  Queue.wait();
+}
+
+// Lookup of a kernel object from the kernel bundle of the application.
+void getKernelFromBundle(sycl::queue &Queue, State &S) {
+  auto Bundle = sycl::get_kernel_bundle<sycl::bundle_state::executable>(
+      Queue.get_context(), {Queue.get_device()});
+  sycl::kernel_id ID = sycl::get_kernel_id<CachedKernel<0>>();
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    (void)Bundle.get_kernel(ID);
+  S.stop();
+}
+
+// Lookup of the executable kernel bundle itself.
+void getKernelBundle(sycl::queue &Queue, State &S) {
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    (void)sycl::get_kernel_bundle<CachedKernel<0>,
+                                  sycl::bundle_state::executable>(
+        Queue.get_context());
+  S.stop();
+}
+} // namespace
+
+void registerKernelCacheBenchmarks(Registry &Benchmarks) {
+  Benchmarks.push_back(
+      {"kernel_cache/submit_many_kernels", inOrder(), submitManyKernels});
+  Benchmarks.push_back(
+      {"kernel_cache/get_kernel_from_bundle", {}, getKernelFromBundle});
+  Benchmarks.push_back({"kernel_cache/get_kernel_bundle", {}, getKernelBundle});
+}
+
+} // namespace sycl_bench
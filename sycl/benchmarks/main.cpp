@@ -0,0 +1,180 @@
+//==----------- main.cpp - SYCL runtime overhead benchmarks ----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Runs the benchmarks measuring the host overheads of the SYCL runtime on the
+// default device and reports the time per operation of each of them:
+//
+//   sycl-runtime-benchmarks [--list] [--filter=<substring>]
+//                           [--iterations=<N>] [--repetitions=<N>]
+//                           [--json=<file>]
+//
+// Each benchmark runs once to warm up, then <repetitions> times with
+// <iterations> operations each. The JSON output is meant for tracking
+// regressions across runtime versions.
+//
+//===----------------------------------------------------------------------===//
+
+#include "harness.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+using namespace sycl_bench;
+
+namespace {
+struct Options {
+  bool List = false;
+  std::string Filter;
+  size_t Iterations = 1000;
+  size_t Repetitions = 10;
+  std::string JSONFile;
+};
+
+struct Result {
+  std::string Name;
+  double MinNs;
+  double MedianNs;
+  double MeanNs;
+  double MaxNs;
+};
+
+bool parseOptions(int argc, char **argv, Options &Opts) {
+  auto getValue = [](const char *Arg, const char *Name) -> const char * {
+    size_t Len = std::strlen(Name);
+    return std::strncmp(Arg, Name, Len) == 0 ? Arg + Len : nullptr;
+  };
+  for (int I = 1; I < argc; ++I) {
+    const char *Arg = argv[I];
+    if (std::strcmp(Arg, "--list") == 0)
+      Opts.List = true;
+    else if (const char *V = getValue(Arg, "--filter="))
+      Opts.Filter = V;
+    else if (const char *V = getValue(Arg, "--iterations="))
+      Opts.Iterations = std::strtoull(V, nullptr, 10);
+    else if (const char *V = getValue(Arg, "--repetitions="))
+      Opts.Repetitions = std::strtoull(V, nullptr, 10);
+    else if (const char *V = getValue(Arg, "--json="))
+      Opts.JSONFile = V;
+    else {
+      std::cerr << "Unknown option: " << Arg << "\n";
+      return false;
+    }
+  }
+  if (!Opts.Iterations || !Opts.Repetitions) {
+    std::cerr << "The iterations and the repetitions must be positive\n";
+    return false;
+  }
+  return true;
+}
+
+Result run(const Benchmark &B, const Options &Opts) {
+  sycl::queue Queue{B.QueueProps};
+  {
+    State Warmup{Opts.Iterations};
+    B.Fn(Queue, Warmup);
+  }
+
+  std::vector<double> Samples;
+  for (size_t R = 0; R < Opts.Repetitions; ++R) {
+    State S{Opts.Iterations};
+    B.Fn(Queue, S);
+    Samples.push_back(S.elapsedNs() / Opts.Iterations);
+  }
+  Queue.wait_and_throw();
+
+  std::sort(Samples.begin(), Samples.end());
+  double Sum = 0;
+  for (double Sample : Samples)
+    Sum += Sample;
+  size_t Mid = Samples.size() / 2;
+  double Median = Samples.size() % 2 ? Samples[Mid]
+                                     : (Samples[Mid - 1] + Samples[Mid]) / 2;
+  return {B.Name, Samples.front(), Median, Sum / Samples.size(),
+          Samples.back()};
+}
+
+std::string escapeJSON(const std::string &Str) {
+  std::string Escaped;
+  for (char C : Str) {
+    if (C == '"' || C == '\\')
+      Escaped += '\\';
+    if (static_cast<unsigned char>(C) < 0x20)
+      continue;
+    Escaped += C;
+  }
+  return Escaped;
+}
+
+void writeJSON(const std::string &File, const Options &Opts,
+               const sycl::device &Dev, const std::vector<Result> &Results) {
+  std::ofstream Out{File};
+  Out << "{\n";
+  Out << "  \"device\": \""
+      << escapeJSON(Dev.get_info<sycl::info::device::name>()) << "\",\n";
+  Out << "  \"driver_version\": \""
+      << escapeJSON(Dev.get_info<sycl::info::device::driver_version>())
+      << "\",\n";
+  Out << "  \"iterations\": " << Opts.Iterations << ",\n";
+  Out << "  \"repetitions\": " << Opts.Repetitions << ",\n";
+  Out << "  \"benchmarks\": [\n";
+  for (size_t I = 0; I < Results.size(); ++I) {
+    const Result &R = Results[I];
+    Out << "    {\"name\": \"" << escapeJSON(R.Name) << "\", \"min_ns\": "
+        << R.MinNs << ", \"median_ns\": " << R.MedianNs
+        << ", \"mean_ns\": " << R.MeanNs << ", \"max_ns\": " << R.MaxNs
+        << "}" << (I + 1 < Results.size() ? "," : "") << "\n";
+  }
+  Out << "  ]\n";
+  Out << "}\n";
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  Options Opts;
+  if (!parseOptions(argc, argv, Opts))
+    return 1;
+
+  Registry Benchmarks;
+  registerSubmitBenchmarks(Benchmarks);
+  registerEventBenchmarks(Benchmarks);
+  registerDependencyBenchmarks(Benchmarks);
+  registerGraphBenchmarks(Benchmarks);
+  registerKernelCacheBenchmarks(Benchmarks);
+  registerGemmBenchmarks(Benchmarks);
+
+  sycl::device Dev;
+  std::vector<Result> Results;
+  if (!Opts.List)
+    std::printf("Device: %s\n%-40s %12s %12s %12s %12s\n",
+                Dev.get_info<sycl::info::device::name>().c_str(),
+                "Benchmark (ns/op)", "min", "median", "mean", "max");
+  for (const Benchmark &B : Benchmarks) {
+    if (B.Name.find(Opts.Filter) == std::string::npos)
+      continue;
+    if (Opts.List) {
+      std::printf("%s\n", B.Name.c_str());
+      continue;
+    }
+    try {
+      Result R = run(B, Opts);
+      std::printf("%-40s %12.1f %12.1f %12.1f %12.1f\n", R.Name.c_str(),
+                  R.MinNs, R.MedianNs, R.MeanNs, R.MaxNs);
+      Results.push_back(R);
+    } catch (const sycl::exception &E) {
+      std::printf("%-40s skipped: %s\n", B.Name.c_str(), E.what());
+    }
+  }
+
+  if (!Opts.JSONFile.empty())
+    writeJSON(Opts.JSONFile, Opts, Dev, Results);
+  return 0;
+}
@@ -0,0 +1,60 @@
+//==---------- submit.cpp - Kernel submission latency benchmarks -----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "harness.hpp"
+
+namespace syclex = sycl::ext::oneapi::experimental;
+
+namespace sycl_bench {
+namespace {
+class EmptySingleTask;
+class EmptyParallelFor;
+class EmptyEventless;
+
+// Time to submit an empty kernel, the execution being waited for outside of
+// the measurement.
+void submitSingleTask(sycl::queue &Queue, State &S) {
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Queue.single_task<EmptySingleTask>([] {});
+  S.stop();
+  Queue.wait();
+}
+
+void submitParallelFor(sycl::queue &Queue, State &S) {
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    Queue.parallel_for<EmptyParallelFor>(sycl::range<1>{1}, [](sycl::id<1>) {});
+  S.stop();
+  Queue.wait();
+}
+
+// Submission without creating an event for the kernel.
+void submitEventless(sycl::queue &Queue, State &S) {
+  S.start();
+  for (size_t I = 0; I < S.Iterations; ++I)
+    syclex::single_task<EmptyEventless>(Queue, [] {});
+  S.stop();
+  Queue.wait();
+}
+} // namespace
+
+void registerSubmitBenchmarks(Registry &Benchmarks) {
+  Benchmarks.push_back(
+      {"submit/single_task/in_order", inOrder(), submitSingleTask});
+  Benchmarks.push_back(
+      {"submit/single_task/out_of_order", {}, submitSingleTask});
+  Benchmarks.push_back(
+      {"submit/parallel_for/in_order", inOrder(), submitParallelFor});
+  Benchmarks.push_back(
+      {"submit/parallel_for/out_of_order", {}, submitParallelFor});
+  Benchmarks.push_back(
+      {"submit/eventless/in_order", inOrder(), submitEventless});
+}
+
+} // namespace sycl_bench
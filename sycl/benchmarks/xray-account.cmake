@@ -0,0 +1,42 @@
+# Runs the SYCL runtime benchmarks with the SYCL runtime library built with
+# SYCL_ENABLE_XRAY, then writes the XRay function call accounting of the
+# library, the functions taking the most time first.
+#
+# Expects BENCHMARKS, the benchmarks binary, SYCL_LIBRARY, the instrumented
+# library, LLVM_XRAY, LOG_DIR, REPORT and optionally BENCHMARK_ARGS and TOP.
+
+if(NOT DEFINED TOP)
+  set(TOP 50)
+endif()
+separate_arguments(benchmark_args NATIVE_COMMAND "${BENCHMARK_ARGS}")
+
+file(REMOVE_RECURSE ${LOG_DIR})
+file(MAKE_DIRECTORY ${LOG_DIR})
+set(ENV{XRAY_OPTIONS}
+  "patch_premain=true xray_mode=xray-basic xray_logfile_base=${LOG_DIR}/xray-log.")
+# Basic mode drops the calls shorter than 5us by default, which would leave
+# out most of the submission path.
+set(ENV{XRAY_BASIC_OPTIONS} "func_duration_threshold_us=0")
+
+execute_process(COMMAND ${BENCHMARKS} ${benchmark_args}
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "The SYCL runtime benchmarks failed: ${result}")
+endif()
+
+file(GLOB logs ${LOG_DIR}/xray-log.*)
+list(LENGTH logs num_logs)
+if(NOT num_logs EQUAL 1)
+  message(FATAL_ERROR "Expected one XRay log in ${LOG_DIR}, found "
+    "${num_logs}, is the SYCL runtime built with SYCL_ENABLE_XRAY?")
+endif()
+
+execute_process(
+  COMMAND ${LLVM_XRAY} account ${logs} -instr_map=${SYCL_LIBRARY}
+          -sort=sum -sortorder=dsc -top=${TOP} -deduce-sibling-calls
+          -keep-going -format=text -o ${REPORT}
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "llvm-xray account failed: ${result}")
+endif()
+message(STATUS "XRay account of the SYCL runtime written to ${REPORT}")
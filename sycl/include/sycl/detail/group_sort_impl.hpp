@@ -16,10 +16,13 @@
 
 #include <sycl/builtins.hpp>
 #include <sycl/detail/key_value_iterator.hpp>
+#include <sycl/ext/oneapi/free_function_queries.hpp>
+#include <sycl/ext/oneapi/sub_group_mask.hpp>
 #include <sycl/group_algorithm.hpp>
 #include <sycl/group_barrier.hpp>
 #include <sycl/sycl_span.hpp>
 
+#include <algorithm>
 #include <iterator>
 #include <memory>
 
@@ -748,6 +751,166 @@ void performRadixIterStaticSize(GroupT group, const uint32_t radix_iter,
   }
 }
 
+// Ranks the keys of a work-group for one iteration of radix sort. The
+// work-items of a sub-group holding keys with the same bucket value are found
+// with ballots, so the first of them updates a single counter per bucket value
+// and sub-group while the others get their rank from the ballot. The keys must
+// be in the sub-group striped arrangement, see
+// performRadixIterStaticSizeSubGroupRank.
+template <size_t items_per_work_item, uint32_t radix_bits, bool is_comp_asc,
+          typename KeysT, typename GroupT>
+void rankKeysInSubGroups(GroupT group, const uint32_t radix_iter, KeysT *keys,
+                         uint32_t *ranks, const ScratchMemory &memory) {
+  constexpr uint32_t radix_states = getStatesInBits(radix_bits);
+  const size_t wgsize = group.get_local_linear_range();
+  const size_t idx = group.get_local_linear_id();
+  sycl::sub_group sg = sycl::ext::oneapi::this_work_item::get_sub_group();
+  const uint32_t sg_id = sg.get_group_linear_id();
+  const uint32_t num_sgs = sg.get_group_linear_range();
+  const uint64_t lower_lanes = (uint64_t{1} << sg.get_local_linear_id()) - 1;
+  const uint32_t num_counters = radix_states * num_sgs;
+
+  // 1.1. Zeroinitialize the counters of every bucket value and sub-group
+  for (uint32_t c = idx; c < num_counters; c += wgsize)
+    memory.get<uint32_t>(c) = uint32_t{0};
+
+  sycl::group_barrier(group);
+
+  // 1.2. Rank the keys within the sub-group and count them
+  uint32_t buckets[items_per_work_item];
+  for (uint32_t i = 0; i < items_per_work_item; ++i) {
+    buckets[i] = getBucketValue<radix_bits, is_comp_asc>(
+        convertToOrdered(keys[i]), radix_iter);
+
+    // work-items of the sub-group with the same bucket value
+    auto peers = sycl::ext::oneapi::group_ballot(sg);
+    for (uint32_t bit = 0; bit < radix_bits; ++bit) {
+      const bool is_set = (buckets[i] >> bit) & 1u;
+      auto ballot = sycl::ext::oneapi::group_ballot(sg, is_set);
+      peers &= is_set ? ballot : ~ballot;
+    }
+    uint64_t peer_bits = 0;
+    peers.extract_bits(peer_bits);
+
+    auto counter = memory.get<uint32_t>(buckets[i] * num_sgs + sg_id);
+    const uint32_t count = counter;
+    const uint64_t lower_peers = peer_bits & lower_lanes;
+    ranks[i] = count + static_cast<uint32_t>(sycl::popcount(lower_peers));
+    // all the peers read the counter before the first of them updates it
+    sycl::group_barrier(sg);
+    if (lower_peers == 0)
+      counter = count + static_cast<uint32_t>(sycl::popcount(peer_bits));
+    sycl::group_barrier(sg);
+  }
+
+  sycl::group_barrier(group);
+
+  // 2.1 Scan. Upsweep: reduce over the counters of the work item, which are
+  // ordered by bucket value and then by sub-group
+  const uint32_t counters_per_item = (num_counters - 1) / wgsize + 1;
+  const uint32_t begin = (std::min)(
+      static_cast<uint32_t>(idx * counters_per_item), num_counters);
+  const uint32_t end = (std::min)(begin + counters_per_item, num_counters);
+  uint32_t reduced = 0;
+  for (uint32_t c = begin; c < end; ++c)
+    reduced += memory.get<uint32_t>(c);
+
+  // 2.2. Exclusive scan: over work items
+  uint32_t scanned =
+      sycl::exclusive_scan_over_group(group, reduced, std::plus<uint32_t>());
+
+  // 2.3. Exclusive downsweep: exclusive scan over the counters
+  for (uint32_t c = begin; c < end; ++c) {
+    auto value_ref = memory.get<uint32_t>(c);
+    uint32_t value_before = value_ref;
+    value_ref = scanned;
+    scanned += value_before;
+  }
+
+  sycl::group_barrier(group);
+
+  // 2.4. Fill ranks with offsets
+  for (uint32_t i = 0; i < items_per_work_item; ++i)
+    ranks[i] += memory.get<uint32_t>(buckets[i] * num_sgs + sg_id);
+}
+
+// The iteration of radix sort over a work-group for known number of elements
+// per work item, ranking the keys with sub-group ballots. Between the
+// iterations the keys are kept in the sub-group striped arrangement: item i of
+// the work item with local id lane in sub-group sg holds the key at
+// sg * max_sg_size * items_per_work_item + i * sg_size + lane, so that the
+// keys ranked together by a sub-group are consecutive.
+template <size_t items_per_work_item, uint32_t radix_bits, bool is_comp_asc,
+          bool is_key_value_sort, bool is_input_blocked, bool is_output_blocked,
+          typename KeysT, typename ValsT, typename GroupT>
+void performRadixIterStaticSizeSubGroupRank(
+    GroupT group, const uint32_t radix_iter, const uint32_t first_iter,
+    const uint32_t last_iter, KeysT *keys, ValsT *vals,
+    const ScratchMemory &memory) {
+  const size_t wgsize = group.get_local_linear_range();
+  const size_t idx = group.get_local_linear_id();
+  sycl::sub_group sg = sycl::ext::oneapi::this_work_item::get_sub_group();
+  const size_t sg_begin = sg.get_group_linear_id() *
+                          sg.get_max_local_range()[0] * items_per_work_item;
+  const size_t sg_size = sg.get_local_linear_range();
+  const size_t lane = sg.get_local_linear_id();
+
+  const ScratchMemory &keys_temp = memory;
+  const ScratchMemory vals_temp =
+      memory + wgsize * items_per_work_item * sizeof(KeysT);
+
+  auto getUserShift = [&](uint32_t i, bool is_blocked) {
+    return is_blocked ? idx * items_per_work_item + i : i * wgsize + idx;
+  };
+
+  // Move the items to the sub-group striped arrangement before sorting, this
+  // only needs to be done at the first iteration.
+  if constexpr (items_per_work_item > 1) {
+    if (radix_iter == first_iter) {
+      for (uint32_t i = 0; i < items_per_work_item; ++i) {
+        size_t shift = getUserShift(i, is_input_blocked);
+        keys_temp.get<KeysT>(shift) = keys[i];
+        if constexpr (is_key_value_sort)
+          vals_temp.get<ValsT>(shift) = vals[i];
+      }
+      sycl::group_barrier(group);
+      for (uint32_t i = 0; i < items_per_work_item; ++i) {
+        size_t shift = sg_begin + i * sg_size + lane;
+        keys[i] = keys_temp.get<KeysT>(shift);
+        if constexpr (is_key_value_sort)
+          vals[i] = vals_temp.get<ValsT>(shift);
+      }
+      sycl::group_barrier(group);
+    }
+  }
+
+  // 1-2. Rank the keys
+  uint32_t ranks[items_per_work_item];
+  rankKeysInSubGroups<items_per_work_item, radix_bits, is_comp_asc>(
+      group, radix_iter, keys, ranks, memory);
+
+  sycl::group_barrier(group);
+
+  // 3. Reorder
+  for (uint32_t i = 0; i < items_per_work_item; ++i) {
+    keys_temp.get<KeysT>(ranks[i]) = keys[i];
+    if constexpr (is_key_value_sort)
+      vals_temp.get<ValsT>(ranks[i]) = vals[i];
+  }
+
+  sycl::group_barrier(group);
+
+  // 4. Copy back to input
+  for (uint32_t i = 0; i < items_per_work_item; ++i) {
+    size_t shift = radix_iter == last_iter - 1
+                       ? getUserShift(i, is_output_blocked)
+                       : sg_begin + i * sg_size + lane;
+    keys[i] = keys_temp.get<KeysT>(shift);
+    if constexpr (is_key_value_sort)
+      vals[i] = vals_temp.get<ValsT>(shift);
+  }
+}
+
 template <bool is_key_value_sort, bool is_comp_asc,
           uint32_t items_per_work_item = 1, uint32_t radix_bits = 4,
           typename GroupT, typename KeysT, typename ValsT>
@@ -797,10 +960,18 @@ void privateStaticSort(GroupT group, T *keys, U *values, std::byte *scratch,
   const uint32_t last_iter = last_bit / radix_bits;
 
   for (uint32_t radix_iter = first_iter; radix_iter < last_iter; ++radix_iter) {
-    performRadixIterStaticSize<items_per_work_item, radix_bits, is_comp_asc,
-                               is_key_value_sort, is_intput_blocked,
-                               is_output_blocked>(
-        group, radix_iter, first_iter, last_iter, keys, values, scratch);
+    // Work-groups rank the keys per sub-group, which needs fewer counters
+    // and fewer updates of the local memory.
+    if constexpr (is_group<GroupT>::value)
+      performRadixIterStaticSizeSubGroupRank<
+          items_per_work_item, radix_bits, is_comp_asc, is_key_value_sort,
+          is_intput_blocked, is_output_blocked>(
+          group, radix_iter, first_iter, last_iter, keys, values, scratch);
+    else
+      performRadixIterStaticSize<items_per_work_item, radix_bits, is_comp_asc,
+                                 is_key_value_sort, is_intput_blocked,
+                                 is_output_blocked>(
+          group, radix_iter, first_iter, last_iter, keys, values, scratch);
     sycl::group_barrier(group);
   }
 }
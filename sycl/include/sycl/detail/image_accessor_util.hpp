@@ -107,6 +107,24 @@ getImageOffset(const vec<T, 4> &Coords, const id<3> ImgPitch,
          Coords.z() * ImgPitch[1];
 }
 
+// Returns the integer Coords as Pixel Coordinates, the unused ones are 0.
+template <typename T>
+std::enable_if_t<std::is_integral_v<T>, int4> getPixelCoord(const T &Coords) {
+  return {Coords, 0, 0, 0};
+}
+
+template <typename T>
+std::enable_if_t<std::is_integral_v<T>, int4>
+getPixelCoord(const vec<T, 2> &Coords) {
+  return {Coords.x(), Coords.y(), 0, 0};
+}
+
+template <typename T>
+std::enable_if_t<std::is_integral_v<T>, int4>
+getPixelCoord(const vec<T, 4> &Coords) {
+  return {Coords.x(), Coords.y(), Coords.z(), 0};
+}
+
 // Process float4 Coordinates and return the appropriate Pixel
 // Coordinates to read from based on Addressing Mode for Nearest filter mode.
 __SYCL_EXPORT int4 getPixelCoordNearestFiltMode(float4, const addressing_mode,
@@ -696,6 +714,32 @@ void imageWriteHostImpl(const CoordT &Coords, const WriteDataT &Color,
   auto Ptr = static_cast<unsigned char *>(BasePtr) +
              getImageOffset(Coords, ImgPitch, ElementSize);
 
+  // The RGBA8 and RGBA32F pixels are written without the dispatch on the
+  // channel order.
+  if constexpr (std::is_same_v<WriteDataT, float4>) {
+    if (ImgChannelOrder == image_channel_order::rgba) {
+      if (ImgChannelType == image_channel_type::fp32) {
+        auto *Pixel = reinterpret_cast<float *>(Ptr);
+        Pixel[0] = Color.x();
+        Pixel[1] = Color.y();
+        Pixel[2] = Color.z();
+        Pixel[3] = Color.w();
+        return;
+      }
+      if (ImgChannelType == image_channel_type::unorm_int8) {
+        // convert_uchar_sat_rte(f * 255.0f)
+        vec<std::uint8_t, 4> Data =
+            processFloatDataToPixel<std::uint8_t>(Color, 255.0f);
+        auto *Pixel = reinterpret_cast<std::uint8_t *>(Ptr);
+        Pixel[0] = Data.x();
+        Pixel[1] = Data.y();
+        Pixel[2] = Data.z();
+        Pixel[3] = Data.w();
+        return;
+      }
+    }
+  }
+
   switch (ImgChannelType) {
   case image_channel_type::snorm_int8:
     writePixel(convertWriteData<std::int8_t>(Color, ImgChannelType),
@@ -796,6 +840,23 @@ DataT ReadPixelData(const int4 PixelCoord, const id<3> ImgPitch,
                             ElementSize); // Utility to compute offset in
                                           // image_accessor_util.hpp
 
+  // The RGBA8 and RGBA32F pixels are read without the dispatch on the channel
+  // order.
+  if constexpr (std::is_same_v<DataT, float4>) {
+    if (ImageChannelOrder == image_channel_order::rgba) {
+      if (ImageChannelType == image_channel_type::fp32) {
+        auto *Pixel = reinterpret_cast<const float *>(Ptr);
+        return {Pixel[0], Pixel[1], Pixel[2], Pixel[3]};
+      }
+      if (ImageChannelType == image_channel_type::unorm_int8) {
+        // (float)c / 255.0f
+        auto *Pixel = reinterpret_cast<const std::uint8_t *>(Ptr);
+        vec<std::uint8_t, 4> Data(Pixel[0], Pixel[1], Pixel[2], Pixel[3]);
+        return Data.template convert<float>() / 255.0f;
+      }
+    }
+  }
+
   switch (ImageChannelType) {
     // TODO: Pass either ImageChannelType or the exact channel type to the
     // readPixel Function.
@@ -1021,6 +1082,17 @@ DataT imageReadSamplerHostImpl(
     image_channel_type ImgChannelType, image_channel_order ImgChannelOrder,
     void *BasePtr, uint8_t ElementSize) {
 
+  // The reads of the unsampled accessors use integer coordinates, which are
+  // the pixel coordinates as they are.
+  if constexpr (std::is_integral_v<get_elem_type_t<CoordT>>) {
+    if (SmplNormMode == coordinate_normalization_mode::unnormalized &&
+        SmplFiltMode == filtering_mode::nearest &&
+        SmplAddrMode == addressing_mode::none)
+      return getColor<DataT>(getPixelCoord(Coords), SmplAddrMode, ImgRange,
+                             ImgPitch, ImgChannelType, ImgChannelOrder,
+                             BasePtr, ElementSize);
+  }
+
   CoordT Coorduvw;
   float4 FloatCoorduvw;
   DataT RetData;
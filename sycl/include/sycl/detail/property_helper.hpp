@@ -51,8 +51,11 @@ enum DataLessPropKind {
   GraphDependOnAllLeaves = 24,
   GraphUpdatable = 25,
   GraphEnableProfiling = 26,
+  GraphEnableOptimizations = 27,
+  GraphUseMultipleQueues = 28,
+  BufferZeroCopy = 29,
   // Indicates the last known dataless property.
-  LastKnownDataLessPropKind = 26,
+  LastKnownDataLessPropKind = 29,
   // Exceeding 32 may cause ABI breaking change on some of OSes.
   DataLessPropKindSize = 32
 };
@@ -67,7 +70,9 @@ enum PropWithDataKind {
   AccPropBufferLocation = 5,
   QueueComputeIndex = 6,
   GraphNodeDependencies = 7,
-  PropWithDataKindSize = 8
+  QueueWaitSpinDuration = 8,
+  UsmNumaLocal = 9,
+  PropWithDataKindSize = 10
 };
 
 // Base class for dataless properties, needed to check that the type of an
@@ -9,6 +9,7 @@
 #pragma once
 
 #include <sycl/detail/defines.hpp>
+#include <sycl/detail/tsan_annotations.hpp>
 
 #include <atomic>
 #include <thread>
@@ -24,13 +25,20 @@ namespace detail {
 /// be zero-initialized. This allows SpinLock to have trivial constructor and
 /// destructor, which makes it possible to use it in global context (unlike
 /// std::mutex, that doesn't provide such guarantees).
+///
+/// The lock and unlock are annotated for ThreadSanitizer, which doesn't see
+/// the atomic operations of the SYCL runtime library.
 class SpinLock {
 public:
   void lock() {
     while (MLock.test_and_set(std::memory_order_acquire))
       std::this_thread::yield();
+    tsanAcquire(&MLock);
+  }
+  void unlock() {
+    tsanRelease(&MLock);
+    MLock.clear(std::memory_order_release);
   }
-  void unlock() { MLock.clear(std::memory_order_release); }
 
 private:
   std::atomic_flag MLock = ATOMIC_FLAG_INIT;
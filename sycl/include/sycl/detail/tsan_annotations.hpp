@@ -0,0 +1,50 @@
+//==------ tsan_annotations.hpp - ThreadSanitizer happens-before hints -----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+// The SYCL runtime library isn't built with ThreadSanitizer, so the atomics it
+// synchronizes with are invisible to an application built with
+// -fsanitize=thread, which reports races on the data they protect. The
+// annotations tell ThreadSanitizer about the happens-before edges of these
+// primitives. They call the ThreadSanitizer runtime when the application has
+// it, the declarations being weak, and do nothing otherwise.
+#if !defined(__SYCL_DEVICE_ONLY__) && defined(__linux__) &&                    \
+    (defined(__clang__) || defined(__GNUC__))
+#define __SYCL_TSAN_ANNOTATIONS 1
+extern "C" {
+__attribute__((weak)) void __tsan_acquire(void *addr);
+__attribute__((weak)) void __tsan_release(void *addr);
+}
+#endif
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+/// Everything done by the threads before they called tsanRelease on \p Addr
+/// happens before what the calling thread does next.
+inline void tsanAcquire([[maybe_unused]] const void *Addr) {
+#ifdef __SYCL_TSAN_ANNOTATIONS
+  if (__tsan_acquire)
+    __tsan_acquire(const_cast<void *>(Addr));
+#endif
+}
+
+/// Everything done by the calling thread so far happens before what the
+/// threads do after calling tsanAcquire on \p Addr.
+inline void tsanRelease([[maybe_unused]] const void *Addr) {
+#ifdef __SYCL_TSAN_ANNOTATIONS
+  if (__tsan_release)
+    __tsan_release(const_cast<void *>(Addr));
+#endif
+}
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
+
+#undef __SYCL_TSAN_ANNOTATIONS
@@ -0,0 +1,16 @@
+//==--------------- codeplay.hpp - SYCL Codeplay extensions ----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+// The headers of the Codeplay extensions that <sycl/sycl.hpp> includes, for
+// the programs using them without the other vendors' extensions.
+
+#include <sycl/detail/core.hpp>
+
+#include <sycl/ext/codeplay/experimental/fusion_wrapper.hpp>
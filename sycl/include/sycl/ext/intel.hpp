@@ -0,0 +1,26 @@
+//==------------------ intel.hpp - SYCL Intel extensions -------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+// The headers of the Intel extensions that <sycl/sycl.hpp> includes, for the
+// programs using them without the other vendors' extensions.
+
+#include <sycl/detail/core.hpp>
+
+#include <sycl/ext/intel/experimental/fp_accuracy_properties.hpp>
+#include <sycl/ext/intel/experimental/fp_control_kernel_properties.hpp>
+#include <sycl/ext/intel/experimental/fpga_mem/fpga_datapath.hpp>
+#include <sycl/ext/intel/experimental/fpga_mem/fpga_mem.hpp>
+#include <sycl/ext/intel/experimental/fpga_mem/properties.hpp>
+#include <sycl/ext/intel/experimental/pipe_properties.hpp>
+#include <sycl/ext/intel/experimental/pipes.hpp>
+#include <sycl/ext/intel/experimental/task_sequence.hpp>
+#include <sycl/ext/intel/experimental/task_sequence_properties.hpp>
+#include <sycl/ext/intel/experimental/usm_properties.hpp>
+#include <sycl/ext/intel/usm_pointers.hpp>
@@ -0,0 +1,208 @@
+//==------- stream_pipeline.hpp - DPC++ Explicit SIMD API ------------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// Software-pipelined streaming over the blocks of one or more arrays.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/ext/intel/esimd/common.hpp>
+#include <sycl/ext/intel/esimd/memory.hpp>
+#include <sycl/ext/intel/esimd/memory_properties.hpp>
+#include <sycl/ext/intel/esimd/simd.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::intel {
+namespace experimental::esimd {
+
+/// @addtogroup sycl_esimd_memory
+/// @{
+
+/// Block of the arrays processed by an iteration of stream_pipeline.
+/// @tparam BlockSize the number of elements of the block.
+template <int BlockSize> class stream_block {
+public:
+  stream_block(size_t Offset, int Count) : MOffset(Offset), MCount(Count) {}
+
+  /// Index of the first element of the block in the arrays.
+  size_t offset() const { return MOffset; }
+  /// Number of elements of the block in the arrays, BlockSize but for the
+  /// tail of the range.
+  int count() const { return MCount; }
+  bool is_full() const { return MCount == BlockSize; }
+  /// Mask of the elements of the block in the arrays.
+  __ESIMD_NS::simd_mask<BlockSize> mask() const {
+    __ESIMD_NS::simd<uint16_t, BlockSize> Lanes(0, 1);
+    return Lanes < MCount;
+  }
+
+  /// Stores the elements of the block in the array Dst, with a block store
+  /// for the full blocks and masked scatters for the tail.
+  template <typename T, typename PropertyListT =
+                            oneapi::experimental::empty_properties_t>
+  void store(T *Dst, __ESIMD_NS::simd<T, BlockSize> Vals,
+             PropertyListT Props = {}) const;
+
+private:
+  size_t MOffset;
+  int MCount;
+};
+
+namespace detail {
+// Tails are accessed with gathers and scatters of TailChunk elements.
+template <int BlockSize>
+constexpr int TailChunk = BlockSize < 16 ? BlockSize : 16;
+
+template <int BlockSize, typename PropertyListT, typename T>
+__ESIMD_API void prefetchStreamBlock(const T *P) {
+  constexpr int Bytes = BlockSize * sizeof(T);
+  // The prefetches of up to 256 bytes are supported by DG2 and PVC.
+  constexpr int ChunkBytes = Bytes < 256 ? Bytes : 256;
+  static_assert(Bytes % ChunkBytes == 0 && ChunkBytes % 4 == 0 &&
+                    ((ChunkBytes / 4) & (ChunkBytes / 4 - 1)) == 0,
+                "The block must be a power of 2 or a multiple of 256 bytes");
+  for (int C = 0; C < Bytes; C += ChunkBytes)
+    __ESIMD_NS::prefetch<uint32_t, ChunkBytes / 4>(
+        reinterpret_cast<const uint32_t *>(P), C, PropertyListT{});
+}
+
+template <int BlockSize, typename PropertyListT, typename T>
+__ESIMD_API __ESIMD_NS::simd<T, BlockSize> loadStreamTail(const T *P,
+                                                          int Count) {
+  constexpr int Chunk = TailChunk<BlockSize>;
+  __ESIMD_NS::simd<T, BlockSize> Vals = 0;
+  __ESIMD_NS::simd<uint32_t, Chunk> ByteOffsets(0, sizeof(T));
+  for (int C = 0; C < Count; C += Chunk) {
+    __ESIMD_NS::simd<uint16_t, Chunk> Lanes(C, 1);
+    Vals.template select<Chunk, 1>(C) = __ESIMD_NS::gather<T, Chunk>(
+        P + C, ByteOffsets, Lanes < Count, __ESIMD_NS::simd<T, Chunk>(0),
+        PropertyListT{});
+  }
+  return Vals;
+}
+} // namespace detail
+
+template <int BlockSize>
+template <typename T, typename PropertyListT>
+void stream_block<BlockSize>::store(T *Dst,
+                                    __ESIMD_NS::simd<T, BlockSize> Vals,
+                                    PropertyListT Props) const {
+  if (is_full()) {
+    __ESIMD_NS::block_store(Dst + MOffset, Vals, Props);
+    return;
+  }
+  constexpr int Chunk = detail::TailChunk<BlockSize>;
+  __ESIMD_NS::simd<uint32_t, Chunk> ByteOffsets(0, sizeof(T));
+  for (int C = 0; C < MCount; C += Chunk) {
+    __ESIMD_NS::simd<uint16_t, Chunk> Lanes(C, 1);
+    __ESIMD_NS::scatter<T, Chunk>(Dst + MOffset + C, ByteOffsets,
+                                  Vals.template select<Chunk, 1>(C).read(),
+                                  Lanes < MCount, Props);
+  }
+}
+
+/// Properties of the prefetches of stream_pipeline by default.
+using stream_prefetch_properties_t = decltype(__ESIMD_NS::properties{
+    __ESIMD_NS::cache_hint_L1<__ESIMD_NS::cache_hint::cached>,
+    __ESIMD_NS::cache_hint_L2<__ESIMD_NS::cache_hint::cached>});
+
+/// Calls \p Func for the blocks of \p BlockSize elements of the arrays
+/// \p Srcs starting at \p Begin, \p Begin + \p Step, ... below \p End, with
+/// the block descriptor and the elements of the block of each array:
+///
+///   Func(const stream_block<BlockSize> &Block, simd<Ts, BlockSize>... Vals)
+///
+/// The loop is software-pipelined: the blocks \p PrefetchDistance iterations
+/// ahead are prefetched into the caches, and the loads of the next block are
+/// issued before \p Func is called for the current one, so that their latency
+/// overlaps the computation. The last block, when it is partial, is loaded
+/// with masked gathers and its missing elements are zero. Typically, each
+/// thread processes a contiguous range with \p Step equal to \p BlockSize, or
+/// the threads interleave their blocks with \p Step equal to the number of
+/// threads times \p BlockSize.
+///
+/// Supported platforms: DG2, PVC.
+/// @tparam BlockSize the number of elements of the blocks. It must satisfy
+/// the restrictions of block_load for each of the element types.
+/// @tparam PrefetchDistance the number of iterations the prefetches are
+/// issued ahead of the loads, 0 disables them.
+/// @tparam PrefetchPropertyListT the cache hints of the prefetches.
+/// @tparam LoadPropertyListT the cache hints and alignment of the loads.
+/// @param Begin the index of the first element of the first block.
+/// @param End the index past the last element of the arrays to process.
+/// @param Step the difference of the indices of consecutive blocks, at
+/// least \p BlockSize.
+/// @param Func the function called for each block.
+/// @param Srcs the arrays, aligned as required by block_load.
+template <int BlockSize, int PrefetchDistance = 4,
+          typename PrefetchPropertyListT = stream_prefetch_properties_t,
+          typename LoadPropertyListT = oneapi::experimental::empty_properties_t,
+          typename FuncT, typename... Ts>
+__ESIMD_API void stream_pipeline(size_t Begin, size_t End, size_t Step,
+                                 FuncT Func, const Ts *...Srcs) {
+  static_assert(sizeof...(Ts) > 0, "No array to stream");
+  static_assert(PrefetchDistance >= 0, "Negative prefetch distance");
+  auto Load = [&](size_t Offset) {
+    return std::make_tuple(__ESIMD_NS::block_load<Ts, BlockSize>(
+        Srcs + Offset, LoadPropertyListT{})...);
+  };
+  auto Prefetch = [&](size_t Offset) {
+    if constexpr (PrefetchDistance > 0)
+      if (Offset < End)
+        (detail::prefetchStreamBlock<BlockSize, PrefetchPropertyListT>(
+             Srcs + Offset),
+         ...);
+  };
+  auto Call = [&](size_t Offset, int Count, auto &Vals) {
+    std::apply(
+        [&](auto &...BlockVals) {
+          Func(stream_block<BlockSize>(Offset, Count), BlockVals...);
+        },
+        Vals);
+  };
+
+  for (int I = 1; I <= PrefetchDistance; ++I)
+    Prefetch(Begin + I * Step);
+
+  size_t Offset = Begin;
+  if (Offset < End && End - Offset >= BlockSize) {
+    auto Vals = Load(Offset);
+    while (true) {
+      Prefetch(Offset + (PrefetchDistance + 1) * Step);
+      size_t Next = Offset + Step;
+      bool HasNext = Next < End && End - Next >= BlockSize;
+      decltype(Vals) NextVals;
+      if (HasNext)
+        NextVals = Load(Next);
+      Call(Offset, BlockSize, Vals);
+      Offset = Next;
+      if (!HasNext)
+        break;
+      Vals = NextVals;
+    }
+  }
+
+  if (Offset < End) {
+    int Count = static_cast<int>(End - Offset);
+    auto Vals = std::make_tuple(
+        detail::loadStreamTail<BlockSize, LoadPropertyListT>(Srcs + Offset,
+                                                             Count)...);
+    Call(Offset, Count, Vals);
+  }
+}
+
+/// @} sycl_esimd_memory
+
+} // namespace experimental::esimd
+} // namespace ext::intel
+} // namespace _V1
+} // namespace sycl
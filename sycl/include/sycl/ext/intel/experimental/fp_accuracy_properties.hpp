@@ -0,0 +1,58 @@
+//==- fp_accuracy_properties.hpp - Math accuracy kernel property ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===--------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/ext/oneapi/properties/property.hpp>
+#include <sycl/ext/oneapi/properties/property_value.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::intel::experimental {
+
+// Values defined here must be in sync with the LLVM pass selecting the math
+// functions of the kernels (SYCLMathAccuracyPass).
+enum class fp_accuracy_mode : std::uint32_t {
+  high = 1,   // Maximum error of 1 ulp
+  medium = 2, // Maximum error of 4 ulp
+  native = 3  // Native implementations, accuracy defined by the device
+};
+
+/// Accuracy of the math functions called by a kernel and the functions it
+/// calls, on the devices selecting implementations by their maximum error.
+struct fp_accuracy_key
+    : oneapi::experimental::detail::compile_time_property_key<
+          oneapi::experimental::detail::PropKind::FPAccuracy> {
+  template <fp_accuracy_mode Accuracy>
+  using value_t = oneapi::experimental::property_value<
+      fp_accuracy_key, std::integral_constant<fp_accuracy_mode, Accuracy>>;
+};
+
+template <fp_accuracy_mode Accuracy>
+inline constexpr fp_accuracy_key::value_t<Accuracy> fp_accuracy;
+
+} // namespace ext::intel::experimental
+
+namespace ext::oneapi::experimental::detail {
+template <intel::experimental::fp_accuracy_mode Accuracy>
+struct HasCompileTimeEffect<
+    intel::experimental::fp_accuracy_key::value_t<Accuracy>> : std::true_type {
+};
+
+template <intel::experimental::fp_accuracy_mode Accuracy>
+struct PropertyMetaInfo<
+    intel::experimental::fp_accuracy_key::value_t<Accuracy>> {
+  static constexpr const char *name = "sycl-fp-accuracy";
+  static constexpr std::uint32_t value = static_cast<std::uint32_t>(Accuracy);
+};
+} // namespace ext::oneapi::experimental::detail
+} // namespace _V1
+} // namespace sycl
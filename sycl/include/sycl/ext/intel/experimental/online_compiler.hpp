@@ -12,6 +12,7 @@
 #include <sycl/detail/export.hpp>             // for __SYCL_EXPORT
 #include <sycl/device.hpp>
 
+#include <future>
 #include <string>
 #include <vector>
 
@@ -119,6 +120,20 @@ public:
   template <typename... Tys>
   std::vector<byte> compile(const std::string &src, const Tys &...args);
 
+  /// Compiles given in-memory \c Lang source asynchronously, on another thread
+  /// with a copy of this compiler, so that several sources can be compiled in
+  /// parallel. The arguments are the ones of \c compile.
+  /// The returned future throws online_compile_error if compilation is not
+  /// successful.
+  template <typename... Tys>
+  std::future<std::vector<byte>> compile_async(const std::string &src,
+                                               const Tys &...args) const {
+    return std::async(std::launch::async,
+                      [Compiler = *this, src, args...]() mutable {
+                        return Compiler.compile(src, args...);
+                      });
+  }
+
   /// Sets the compiled code format of the compilation target and returns *this.
   online_compiler<Lang> &setOutputFormat(compiled_code_format fmt) {
     OutputFormat = fmt;
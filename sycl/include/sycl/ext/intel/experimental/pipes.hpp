@@ -277,6 +277,51 @@ public:
     E.wait();
   }
 
+  // Batched host API, moving Count elements with a single transfer instead of
+  // one command per element. The transfer is blocking on the device side but
+  // asynchronous for the host: the returned event completes once the kernel
+  // consumed or produced all the elements, reporting the back-pressure of the
+  // pipe. Data must stay valid until then.
+  static event read(queue &Q, _dataT *Data, size_t Count,
+                    memory_order Order = memory_order::seq_cst) {
+    // Order is currently unused.
+    std::ignore = Order;
+
+    const device Dev = Q.get_device();
+    bool IsPipeSupported =
+        Dev.has_extension("cl_intel_program_scope_host_pipe");
+    if (!IsPipeSupported || Count == 0) {
+      return event{};
+    }
+    const void *HostPipePtr = &m_Storage;
+    const std::string PipeName = pipe_base::get_pipe_name(HostPipePtr);
+    void *DataPtr = Data;
+    return Q.submit([=](handler &CGH) {
+      CGH.ext_intel_read_host_pipe(PipeName, DataPtr, Count * sizeof(_dataT),
+                                   true /*blocking*/);
+    });
+  }
+
+  static event write(queue &Q, const _dataT *Data, size_t Count,
+                     memory_order Order = memory_order::seq_cst) {
+    // Order is currently unused.
+    std::ignore = Order;
+
+    const device Dev = Q.get_device();
+    bool IsPipeSupported =
+        Dev.has_extension("cl_intel_program_scope_host_pipe");
+    if (!IsPipeSupported || Count == 0) {
+      return event{};
+    }
+    const void *HostPipePtr = &m_Storage;
+    const std::string PipeName = pipe_base::get_pipe_name(HostPipePtr);
+    void *DataPtr = const_cast<_dataT *>(Data);
+    return Q.submit([=](handler &CGH) {
+      CGH.ext_intel_write_host_pipe(PipeName, DataPtr, Count * sizeof(_dataT),
+                                    true /*blocking*/);
+    });
+  }
+
   // Reading from pipe is lowered to SPIR-V instruction OpReadPipe via SPIR-V
   // friendly LLVM IR.
   template <typename _functionPropertiesT>
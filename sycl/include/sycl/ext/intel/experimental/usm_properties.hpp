@@ -9,6 +9,7 @@
 #pragma once
 
 #include <sycl/detail/property_helper.hpp>     // for PropWithDataKind, Dat...
+#include <sycl/device.hpp>                     // for device
 #include <sycl/properties/property_traits.hpp> // for is_property
 
 #include <stdint.h>    // for uint64_t
@@ -24,6 +25,19 @@ class device_read_only
 public:
   device_read_only() = default;
 };
+
+// Places the host allocation on the NUMA node closest to the device, so that
+// the transfers between the device and the allocation don't cross sockets.
+class numa_local
+    : public sycl::detail::PropertyWithData<
+          sycl::detail::PropWithDataKind::UsmNumaLocal> {
+public:
+  numa_local(const sycl::device &Device) : MDevice(Device) {}
+  sycl::device get_device() const { return MDevice; }
+
+private:
+  sycl::device MDevice;
+};
 } // namespace oneapi::property::usm
 
 namespace intel::experimental::property::usm {
@@ -46,6 +60,9 @@ template <>
 struct is_property<ext::oneapi::property::usm::device_read_only>
     : std::true_type {};
 
+template <>
+struct is_property<ext::oneapi::property::usm::numa_local> : std::true_type {};
+
 template <>
 struct is_property<ext::intel::experimental::property::usm::buffer_location>
     : std::true_type {};
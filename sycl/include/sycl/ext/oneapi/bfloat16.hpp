@@ -43,6 +43,21 @@ __devicelib_ConvertFToBF16INTELVec16(const float *, uint16_t *) noexcept;
 extern "C" __DPCPP_SYCL_EXTERNAL void
 __devicelib_ConvertBF16ToFINTELVec16(const uint16_t *, float *) noexcept;
 
+// When compiling ahead of time for Intel GPUs which have bfloat16 conversion
+// instructions, the conversions use them inline rather than calling into the
+// bfloat16 device library. The devices are the ones the driver links the
+// native bfloat16 library for.
+#if defined(__SYCL_DEVICE_ONLY__) &&                                           \
+    (defined(__SPIR__) || defined(__SPIRV__)) &&                               \
+    ((__SYCL_TARGET_INTEL_GPU_ACM_G10__ == 1) ||                               \
+     (__SYCL_TARGET_INTEL_GPU_ACM_G11__ == 1) ||                               \
+     (__SYCL_TARGET_INTEL_GPU_ACM_G12__ == 1) ||                               \
+     (__SYCL_TARGET_INTEL_GPU_PVC__ == 1) ||                                   \
+     (__SYCL_TARGET_INTEL_GPU_PVC_VG__ == 1))
+#define __SYCL_INLINE_BF16_CONVERSIONS__ 1
+#include <sycl/__spirv/spirv_ops.hpp> // for __spirv_ConvertFToBF16INTEL
+#endif
+
 namespace sycl {
 inline namespace _V1 {
 namespace ext::oneapi {
@@ -58,7 +73,11 @@ bfloat16 bitsToBfloat16(const Bfloat16StorageT Value);
 class ConvertToBfloat16;
 
 template <int N> void BF16VecToFloatVec(const bfloat16 src[N], float dst[N]) {
-#if defined(__SYCL_DEVICE_ONLY__) && (defined(__SPIR__) || defined(__SPIRV__))
+#if defined(__SYCL_INLINE_BF16_CONVERSIONS__)
+  const uint16_t *src_i16 = sycl::bit_cast<const uint16_t *>(src);
+  for (int i = 0; i < N; ++i)
+    dst[i] = __spirv_ConvertBF16ToFINTEL(src_i16[i]);
+#elif defined(__SYCL_DEVICE_ONLY__) && (defined(__SPIR__) || defined(__SPIRV__))
   const uint16_t *src_i16 = sycl::bit_cast<const uint16_t *>(src);
   if constexpr (N == 1)
     __devicelib_ConvertBF16ToFINTELVec1(src_i16, dst);
@@ -127,6 +146,8 @@ private:
 #endif
 #elif defined(__AMDGCN__)
     return from_float_fallback(a);
+#elif defined(__SYCL_INLINE_BF16_CONVERSIONS__)
+    return __spirv_ConvertFToBF16INTEL(a);
 #else
     return __devicelib_ConvertFToBF16INTEL(a);
 #endif
@@ -135,7 +156,9 @@ private:
   }
 
   static float to_float(const detail::Bfloat16StorageT &a) {
-#if defined(__SYCL_DEVICE_ONLY__) && (defined(__SPIR__) || defined(__SPIRV__))
+#if defined(__SYCL_INLINE_BF16_CONVERSIONS__)
+    return __spirv_ConvertBF16ToFINTEL(a);
+#elif defined(__SYCL_DEVICE_ONLY__) && (defined(__SPIR__) || defined(__SPIRV__))
     return __devicelib_ConvertBF16ToFINTEL(a);
 #else
     union {
@@ -188,8 +211,6 @@ public:
     detail::Bfloat16StorageT res;
     asm("neg.bf16 %0, %1;" : "=h"(res) : "h"(lhs.value));
     return detail::bitsToBfloat16(res);
-#elif defined(__SYCL_DEVICE_ONLY__) && (defined(__SPIR__) || defined(__SPIRV__))
-    return bfloat16{-__devicelib_ConvertBF16ToFINTEL(lhs.value)};
 #else
     return bfloat16{-to_float(lhs.value)};
 #endif
@@ -271,7 +292,11 @@ public:
 namespace detail {
 
 template <int N> void FloatVecToBF16Vec(float src[N], bfloat16 dst[N]) {
-#if defined(__SYCL_DEVICE_ONLY__) && (defined(__SPIR__) || defined(__SPIRV__))
+#if defined(__SYCL_INLINE_BF16_CONVERSIONS__)
+  uint16_t *dst_i16 = sycl::bit_cast<uint16_t *>(dst);
+  for (int i = 0; i < N; ++i)
+    dst_i16[i] = __spirv_ConvertFToBF16INTEL(src[i]);
+#elif defined(__SYCL_DEVICE_ONLY__) && (defined(__SPIR__) || defined(__SPIRV__))
   uint16_t *dst_i16 = sycl::bit_cast<uint16_t *>(dst);
   if constexpr (N == 1)
     __devicelib_ConvertFToBF16INTELVec1(src, dst_i16);
@@ -0,0 +1,323 @@
+//==------- bindless_images_tiled_copy.hpp --- SYCL bindless images --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// Copies of large images split into tiles, pipelined over several queues.
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>                               // for context
+#include <sycl/event.hpp>                                 // for event
+#include <sycl/exception.hpp>                             // for exception
+#include <sycl/ext/oneapi/bindless_images.hpp>            // for ext_oneapi...
+#include <sycl/ext/oneapi/bindless_images_descriptor.hpp> // for image_desc...
+#include <sycl/ext/oneapi/bindless_images_memory.hpp>     // for image_mem_...
+#include <sycl/handler.hpp>                               // for handler
+#include <sycl/image.hpp>                                 // for image_chan...
+#include <sycl/queue.hpp>                                 // for queue
+#include <sycl/range.hpp>                                 // for range
+#include <sycl/usm.hpp>                                   // for malloc_host
+
+#include <algorithm> // for min
+#include <cstddef>   // for size_t
+#include <cstring>   // for memcpy
+#include <utility>   // for move
+#include <vector>    // for vector
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+namespace detail {
+inline size_t getImagePixelSize(const image_descriptor &Desc) {
+  switch (Desc.channel_type) {
+  case image_channel_type::snorm_int8:
+  case image_channel_type::unorm_int8:
+  case image_channel_type::signed_int8:
+  case image_channel_type::unsigned_int8:
+    return Desc.num_channels;
+  case image_channel_type::snorm_int16:
+  case image_channel_type::unorm_int16:
+  case image_channel_type::signed_int16:
+  case image_channel_type::unsigned_int16:
+  case image_channel_type::fp16:
+    return 2 * Desc.num_channels;
+  case image_channel_type::signed_int32:
+  case image_channel_type::unsigned_int32:
+  case image_channel_type::fp32:
+    return 4 * Desc.num_channels;
+  case image_channel_type::unorm_short_565:
+  case image_channel_type::unorm_short_555:
+    return 2;
+  case image_channel_type::unorm_int_101010:
+    return 4;
+  }
+  return 0;
+}
+
+// Splits the copies of an image into tiles along its outermost dimension:
+// ranges of pixels for 1D images, of rows for 2D ones and of slices for 3D
+// ones. The tiles of the packed host data are then contiguous.
+class ImageTiling {
+public:
+  ImageTiling(const std::vector<queue> &Queues, const image_descriptor &Desc,
+              size_t TileSize)
+      : MExtent(Desc.width, Desc.height ? Desc.height : 1,
+                Desc.depth ? Desc.depth : 1),
+        MOuterDim(Desc.depth ? 2 : Desc.height ? 1 : 0),
+        MTileSize(TileSize), MPixelSize(getImagePixelSize(Desc)) {
+    if (Queues.empty())
+      throw exception(make_error_code(errc::invalid),
+                      "No queue to copy the image tiles on");
+    if (TileSize == 0)
+      throw exception(make_error_code(errc::invalid),
+                      "The tiles of the image copy are empty");
+    if (Desc.type != image_type::standard)
+      throw exception(make_error_code(errc::invalid),
+                      "Tiled copies are only supported for standard images");
+  }
+
+  size_t getNumTiles() const {
+    return (MExtent[MOuterDim] + MTileSize - 1) / MTileSize;
+  }
+  const range<3> &getExtent() const { return MExtent; }
+  // Offset of the tile in the image, in pixels.
+  range<3> getOffset(size_t Tile) const {
+    range<3> Offset{0, 0, 0};
+    Offset[MOuterDim] = Tile * MTileSize;
+    return Offset;
+  }
+  // Offset of the tile in the host data, in bytes, rows and slices.
+  range<3> getHostOffset(size_t Tile) const {
+    range<3> Offset = getOffset(Tile);
+    Offset[0] *= MPixelSize;
+    return Offset;
+  }
+  range<3> getTileExtent(size_t Tile) const {
+    range<3> Extent = MExtent;
+    Extent[MOuterDim] =
+        std::min(MTileSize, MExtent[MOuterDim] - Tile * MTileSize);
+    return Extent;
+  }
+  size_t getTileBytes(size_t Tile) const {
+    return getTileExtent(Tile).size() * MPixelSize;
+  }
+  size_t getTileByteOffset(size_t Tile) const {
+    return getOffset(Tile)[MOuterDim] * (MExtent.size() / MExtent[MOuterDim]) *
+           MPixelSize;
+  }
+
+private:
+  range<3> MExtent;
+  int MOuterDim;
+  size_t MTileSize;
+  size_t MPixelSize;
+};
+
+// Ring of pinned host buffers staging the tiles of the copies from and to
+// pageable memory, so that the host copy of a tile overlaps the device copies
+// of the previous ones.
+class ImageStagingRing {
+public:
+  ImageStagingRing(const context &Ctx, size_t NumBuffers, size_t BufferSize)
+      : MContext(Ctx), MBufferSize(BufferSize), MBuffers(NumBuffers, nullptr),
+        MEvents(NumBuffers) {}
+  ImageStagingRing(const ImageStagingRing &) = delete;
+  ImageStagingRing &operator=(const ImageStagingRing &) = delete;
+  ~ImageStagingRing() {
+    // Only reached with buffers on errors, finish hands them over otherwise.
+    for (size_t I = 0; I < MBuffers.size(); ++I) {
+      if (!MBuffers[I])
+        continue;
+      try {
+        MEvents[I].wait();
+      } catch (...) {
+      }
+      free(MBuffers[I], MContext);
+    }
+  }
+
+  bool empty() const { return MBuffers.empty(); }
+
+  // Returns the buffer of the tile, once the previous tile using it is done.
+  void *acquire(size_t Tile) {
+    size_t Slot = Tile % MBuffers.size();
+    if (!MBuffers[Slot]) {
+      MBuffers[Slot] = malloc_host(MBufferSize, MContext);
+      if (!MBuffers[Slot])
+        throw exception(make_error_code(errc::memory_allocation),
+                        "Failed to allocate the staging buffers of the tiles");
+    } else {
+      MEvents[Slot].wait();
+    }
+    return MBuffers[Slot];
+  }
+
+  void release(size_t Tile, const event &Done) {
+    MEvents[Tile % MBuffers.size()] = Done;
+  }
+
+  // Returns an event completing with the tiles, after which the staging
+  // buffers are freed.
+  event finish(queue &Q, const std::vector<event> &TileEvents) {
+    if (empty())
+      return Q.ext_oneapi_submit_barrier(TileEvents);
+    std::vector<void *> Buffers;
+    std::swap(Buffers, MBuffers);
+    context Ctx = MContext;
+    return Q.submit([&](handler &CGH) {
+      CGH.depends_on(TileEvents);
+      CGH.host_task([Buffers, Ctx]() {
+        for (void *Buffer : Buffers)
+          if (Buffer)
+            free(Buffer, Ctx);
+      });
+    });
+  }
+
+private:
+  context MContext;
+  size_t MBufferSize;
+  std::vector<void *> MBuffers;
+  std::vector<event> MEvents;
+};
+
+inline size_t getNumStagingBuffers(const std::vector<queue> &Queues,
+                                   const void *HostPtr) {
+  // The USM allocations are copied directly.
+  if (get_pointer_type(HostPtr, Queues[0].get_context()) !=
+      usm::alloc::unknown)
+    return 0;
+  return Queues.size() + 1;
+}
+} // namespace detail
+
+/// Copies the packed image data at \p Src to the image \p Dest in tiles of
+/// \p TileSize pixels, rows or slices for 1D, 2D or 3D images respectively.
+/// The tiles are submitted round-robin to \p Queues, e.g. queues of different
+/// copy engines, so that they are transferred concurrently. When \p Src isn't
+/// a USM allocation, the tiles are staged through pinned host buffers, the
+/// host copy of a tile overlapping the transfers of the previous ones.
+///
+/// \p OnTile is called as each tile is submitted with the event of its copy
+/// and its offset and extent in pixels:
+///
+///   OnTile(event TileEvent, range<3> Offset, range<3> Extent)
+///
+/// so that the work on a tile only depends on it, overlapping the upload of
+/// the next tiles.
+/// \return an event completing when all the tiles are copied.
+template <typename OnTileT>
+event copy_image_tiled(const std::vector<queue> &Queues, const void *Src,
+                       image_mem_handle Dest,
+                       const image_descriptor &DestImgDesc, size_t TileSize,
+                       OnTileT OnTile,
+                       const std::vector<event> &DepEvents = {}) {
+  detail::ImageTiling Tiling(Queues, DestImgDesc, TileSize);
+  detail::ImageStagingRing Staging(Queues[0].get_context(),
+                                   detail::getNumStagingBuffers(Queues, Src),
+                                   Tiling.getTileBytes(0));
+  std::vector<event> TileEvents;
+  TileEvents.reserve(Tiling.getNumTiles());
+  for (size_t Tile = 0; Tile < Tiling.getNumTiles(); ++Tile) {
+    queue Q = Queues[Tile % Queues.size()];
+    range<3> Offset = Tiling.getOffset(Tile);
+    range<3> Extent = Tiling.getTileExtent(Tile);
+    event TileEvent;
+    if (Staging.empty()) {
+      TileEvent = Q.ext_oneapi_copy(Src, Tiling.getHostOffset(Tile),
+                                    Tiling.getExtent(), Dest, Offset,
+                                    DestImgDesc, Extent, DepEvents);
+    } else {
+      void *Buffer = Staging.acquire(Tile);
+      std::memcpy(Buffer,
+                  static_cast<const char *>(Src) +
+                      Tiling.getTileByteOffset(Tile),
+                  Tiling.getTileBytes(Tile));
+      TileEvent =
+          Q.ext_oneapi_copy(Buffer, range<3>{0, 0, 0}, Extent, Dest, Offset,
+                            DestImgDesc, Extent, DepEvents);
+      Staging.release(Tile, TileEvent);
+    }
+    OnTile(TileEvent, Offset, Extent);
+    TileEvents.push_back(std::move(TileEvent));
+  }
+  queue Q = Queues[0];
+  return Staging.finish(Q, TileEvents);
+}
+
+/// Copies the image \p Src to the packed image data at \p Dest in tiles,
+/// the counterpart of the copy_image_tiled upload above. When \p Dest isn't
+/// a USM allocation, the tiles are copied from the pinned staging buffers by
+/// host tasks, and the events given to \p OnTile are the ones of these host
+/// tasks.
+/// \return an event completing when all the tiles are copied.
+template <typename OnTileT>
+event copy_image_tiled(const std::vector<queue> &Queues, image_mem_handle Src,
+                       const image_descriptor &SrcImgDesc, void *Dest,
+                       size_t TileSize, OnTileT OnTile,
+                       const std::vector<event> &DepEvents = {}) {
+  detail::ImageTiling Tiling(Queues, SrcImgDesc, TileSize);
+  detail::ImageStagingRing Staging(Queues[0].get_context(),
+                                   detail::getNumStagingBuffers(Queues, Dest),
+                                   Tiling.getTileBytes(0));
+  std::vector<event> TileEvents;
+  TileEvents.reserve(Tiling.getNumTiles());
+  for (size_t Tile = 0; Tile < Tiling.getNumTiles(); ++Tile) {
+    queue Q = Queues[Tile % Queues.size()];
+    range<3> Offset = Tiling.getOffset(Tile);
+    range<3> Extent = Tiling.getTileExtent(Tile);
+    event TileEvent;
+    if (Staging.empty()) {
+      TileEvent = Q.ext_oneapi_copy(Src, Offset, SrcImgDesc, Dest,
+                                    Tiling.getHostOffset(Tile),
+                                    Tiling.getExtent(), Extent, DepEvents);
+    } else {
+      void *Buffer = Staging.acquire(Tile);
+      event CopyEvent =
+          Q.ext_oneapi_copy(Src, Offset, SrcImgDesc, Buffer, range<3>{0, 0, 0},
+                            Extent, Extent, DepEvents);
+      char *TileDest = static_cast<char *>(Dest) +
+                       Tiling.getTileByteOffset(Tile);
+      size_t TileBytes = Tiling.getTileBytes(Tile);
+      TileEvent = Q.submit([&](handler &CGH) {
+        CGH.depends_on(CopyEvent);
+        CGH.host_task([=]() { std::memcpy(TileDest, Buffer, TileBytes); });
+      });
+      Staging.release(Tile, TileEvent);
+    }
+    OnTile(TileEvent, Offset, Extent);
+    TileEvents.push_back(std::move(TileEvent));
+  }
+  queue Q = Queues[0];
+  return Staging.finish(Q, TileEvents);
+}
+
+/// Tiled image upload without a per-tile callback.
+inline event copy_image_tiled(const std::vector<queue> &Queues, const void *Src,
+                              image_mem_handle Dest,
+                              const image_descriptor &DestImgDesc,
+                              size_t TileSize,
+                              const std::vector<event> &DepEvents = {}) {
+  return copy_image_tiled(
+      Queues, Src, Dest, DestImgDesc, TileSize,
+      [](const event &, range<3>, range<3>) {}, DepEvents);
+}
+
+/// Tiled image download without a per-tile callback.
+inline event copy_image_tiled(const std::vector<queue> &Queues,
+                              image_mem_handle Src,
+                              const image_descriptor &SrcImgDesc, void *Dest,
+                              size_t TileSize,
+                              const std::vector<event> &DepEvents = {}) {
+  return copy_image_tiled(
+      Queues, Src, SrcImgDesc, Dest, TileSize,
+      [](const event &, range<3>, range<3>) {}, DepEvents);
+}
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
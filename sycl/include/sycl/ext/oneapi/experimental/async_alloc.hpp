@@ -0,0 +1,106 @@
+//==------ async_alloc.hpp --- SYCL asynchronous USM allocations -----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>
+#include <sycl/detail/common.hpp>
+#include <sycl/detail/owner_less_base.hpp>
+#include <sycl/device.hpp>
+#include <sycl/property_list.hpp>
+#include <sycl/queue.hpp>
+#include <sycl/usm/usm_enums.hpp>
+
+namespace sycl {
+inline namespace _V1 {
+
+namespace detail {
+class memory_pool_impl;
+} // namespace detail
+
+namespace ext::oneapi::experimental {
+
+/// Pool of device USM allocations. Memory released with async_free() stays in
+/// the pool and is handed out again by later allocations, which are ordered
+/// after the work submitted before the release.
+class __SYCL_EXPORT memory_pool
+    : public sycl::detail::OwnerLessBase<memory_pool> {
+public:
+  memory_pool(const context &SyclContext, const device &SyclDevice,
+              const property_list &PropList = {});
+
+  memory_pool(const queue &SyclQueue, const property_list &PropList = {})
+      : memory_pool(SyclQueue.get_context(), SyclQueue.get_device(),
+                    PropList) {}
+
+  memory_pool(const memory_pool &rhs) = default;
+  memory_pool(memory_pool &&rhs) = default;
+
+  memory_pool &operator=(const memory_pool &rhs) = default;
+  memory_pool &operator=(memory_pool &&rhs) = default;
+
+  ~memory_pool() = default;
+
+  bool operator==(const memory_pool &rhs) const { return impl == rhs.impl; }
+  bool operator!=(const memory_pool &rhs) const { return !(*this == rhs); }
+
+  context get_context() const;
+  device get_device() const;
+
+  /// @return Number of bytes of device memory allocated by the pool.
+  size_t get_reserved_size_current() const;
+
+  /// @return Number of bytes of the pool's memory handed out to allocations
+  /// that haven't been freed.
+  size_t get_used_size_current() const;
+
+  /// Releases memory kept by the pool which isn't used by any allocation,
+  /// until at most MinBytesToKeep bytes are reserved.
+  void trim_to(size_t MinBytesToKeep);
+
+private:
+  std::shared_ptr<sycl::detail::memory_pool_impl> impl;
+
+  template <class Obj>
+  friend const decltype(Obj::impl) &
+  sycl::detail::getSyclObjImpl(const Obj &SyclObject);
+
+  template <class T>
+  friend T sycl::detail::createSyclObjFromImpl(decltype(T::impl) ImplObj);
+};
+
+/// Allocates memory which can be used by the work submitted to SyclQueue
+/// after the call. The memory is taken from the default pool of the context
+/// and device of the queue.
+/// Only sycl::usm::alloc::device allocations are supported.
+__SYCL_EXPORT void *async_malloc(const queue &SyclQueue, sycl::usm::alloc Kind,
+                                 size_t Size);
+
+/// Allocates memory from Pool which can be used by the work submitted to
+/// SyclQueue after the call.
+__SYCL_EXPORT void *async_malloc_from_pool(const queue &SyclQueue, size_t Size,
+                                           const memory_pool &Pool);
+
+/// Releases memory returned by async_malloc() or async_malloc_from_pool()
+/// once the work submitted to SyclQueue before the call is done. The memory
+/// is returned to its pool without waiting for that work.
+__SYCL_EXPORT void async_free(const queue &SyclQueue, void *Ptr);
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
+
+namespace std {
+template <> struct hash<sycl::ext::oneapi::experimental::memory_pool> {
+  size_t operator()(
+      const sycl::ext::oneapi::experimental::memory_pool &MemoryPool) const {
+    return hash<std::shared_ptr<sycl::detail::memory_pool_impl>>()(
+        sycl::detail::getSyclObjImpl(MemoryPool));
+  }
+};
+} // namespace std
@@ -0,0 +1,35 @@
+//==------- build_async.hpp - SYCL background kernel build extension -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>
+#include <sycl/detail/export.hpp>
+#include <sycl/device.hpp>
+
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+/// Starts building the device code of all kernels in the application for the
+/// given devices in the background and returns immediately. Kernel submissions
+/// made while a build is still in progress wait for it to finish instead of
+/// starting a second build. Build errors are reported by the first submission
+/// of the affected kernel.
+__SYCL_EXPORT void build_kernels_async(const context &Ctx,
+                                       const std::vector<device> &Devs);
+
+inline void build_kernels_async(const context &Ctx) {
+  build_kernels_async(Ctx, Ctx.get_devices());
+}
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
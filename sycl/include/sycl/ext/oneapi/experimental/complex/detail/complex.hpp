@@ -180,6 +180,7 @@ public:
     value_type __bc = __b * __c;
     value_type __x = __ac - __bd;
     value_type __y = __ad + __bc;
+#ifndef __SYCL_CX_LIMITED_RANGE__
     if (sycl::isnan(__x) && sycl::isnan(__y)) {
       bool __recalc = false;
       if (sycl::isinf(__a) || sycl::isinf(__b)) {
@@ -221,6 +222,7 @@ public:
         __y = value_type(INFINITY) * (__a * __d + __b * __c);
       }
     }
+#endif
     return complex<value_type>(__x, __y);
   }
   _SYCL_EXT_CPLX_INLINE_VISIBILITY friend complex<value_type>
@@ -238,11 +240,18 @@ public:
 
   _SYCL_EXT_CPLX_INLINE_VISIBILITY friend complex<value_type>
   operator/(const complex<value_type> &__z, const complex<value_type> &__w) {
-    int __ilogbw = 0;
     value_type __a = __z.__re_;
     value_type __b = __z.__im_;
     value_type __c = __w.__re_;
     value_type __d = __w.__im_;
+#ifdef __SYCL_CX_LIMITED_RANGE__
+    // The range is limited, so the denominator doesn't need scaling, and the
+    // infinities and NaNs are not recovered, as with _Complex types.
+    value_type __denom = __c * __c + __d * __d;
+    return complex<value_type>((__a * __c + __b * __d) / __denom,
+                               (__b * __c - __a * __d) / __denom);
+#else
+    int __ilogbw = 0;
     value_type __logbw =
         sycl::logb(sycl::fmax(sycl::fabs(__c), sycl::fabs(__d)));
     if (sycl::isfinite(__logbw)) {
@@ -277,6 +286,7 @@ public:
       }
     }
     return complex<value_type>(__x, __y);
+#endif
   }
   _SYCL_EXT_CPLX_INLINE_VISIBILITY friend complex<value_type>
   operator/(const complex<value_type> &__x, value_type __y) {
@@ -0,0 +1,155 @@
+//==---------- composite_queue.hpp - SYCL Composite Device Queue -----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp> // for context
+#include <sycl/device.hpp> // for device
+#include <sycl/event.hpp> // for event
+#include <sycl/handler.hpp> // for handler
+#include <sycl/id.hpp> // for id
+#include <sycl/item.hpp> // for item
+#include <sycl/kernel.hpp> // for auto_name
+#include <sycl/property_list.hpp> // for property_list
+#include <sycl/queue.hpp> // for queue
+#include <sycl/range.hpp> // for range
+
+#include <cstddef> // for size_t
+#include <utility> // for pair
+#include <vector> // for vector
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+/// How the work submitted to a composite_queue is distributed over the
+/// component devices of its device.
+enum class composite_scaling : char {
+  /// The ranges are split over one queue per component device.
+  explicit_split,
+  /// The work is submitted to the composite device, and distributed over its
+  /// components by the backend.
+  implicit
+};
+
+/// Queue of a composite device distributing the range of parallel_for over
+/// its component devices. The outermost dimension of the range is split in
+/// contiguous partitions, one per component device, and the partition of each
+/// component is submitted to a queue of the component, so that the kernel
+/// runs on all the tiles of the device.
+///
+/// The queues share a context with all the component devices, so that the
+/// USM allocations of the context are accessible from all of them, and
+/// prefetch places the partitions of shared allocations on the component
+/// devices that process them with the same split as parallel_for.
+///
+/// For a device which isn't composite, or with composite_scaling::implicit,
+/// there is a single partition submitted to the device itself.
+class composite_queue {
+public:
+  explicit composite_queue(
+      const device &SyclDevice,
+      composite_scaling Scaling = composite_scaling::explicit_split,
+      const property_list &PropList = {}) {
+    std::vector<device> Devices;
+    if (Scaling == composite_scaling::explicit_split &&
+        SyclDevice.has(aspect::ext_oneapi_is_composite))
+      Devices = SyclDevice.get_info<info::device::component_devices>();
+    if (Devices.empty())
+      Devices.push_back(SyclDevice);
+
+    MContext = context(Devices);
+    MQueues.reserve(Devices.size());
+    for (const device &Dev : Devices)
+      MQueues.emplace_back(MContext, Dev, PropList);
+  }
+
+  context get_context() const { return MContext; }
+
+  /// Queues of the component devices, in the order of the partitions.
+  const std::vector<queue> &get_queues() const { return MQueues; }
+
+  /// Number of partitions of the ranges.
+  size_t get_num_partitions() const { return MQueues.size(); }
+
+  /// Offset and count of the elements of the partition \p Partition of
+  /// \p Count elements.
+  std::pair<size_t, size_t> get_partition(size_t Partition,
+                                          size_t Count) const {
+    size_t N = MQueues.size();
+    size_t Begin = Partition * Count / N;
+    size_t End = (Partition + 1) * Count / N;
+    return {Begin, End - Begin};
+  }
+
+  /// Calls \p KernelFunc with the ids of \p Range, the partitions of the
+  /// outermost dimension running on the component devices.
+  ///
+  /// \return the events of the partitions.
+  template <typename KernelName = detail::auto_name, int Dims,
+            typename KernelType>
+  std::vector<event> parallel_for(range<Dims> Range, KernelType KernelFunc,
+                                  const std::vector<event> &DepEvents = {}) {
+    std::vector<event> Events;
+    Events.reserve(MQueues.size());
+    for (size_t P = 0; P < MQueues.size(); ++P) {
+      std::pair<size_t, size_t> Partition = get_partition(P, Range[0]);
+      if (Partition.second == 0)
+        continue;
+      size_t Offset = Partition.first;
+      range<Dims> SubRange = Range;
+      SubRange[0] = Partition.second;
+      Events.push_back(MQueues[P].submit([&](handler &CGH) {
+        CGH.depends_on(DepEvents);
+        CGH.parallel_for<KernelName>(SubRange, [=](item<Dims> It) {
+          id<Dims> Id = It.get_id();
+          Id[0] += Offset;
+          KernelFunc(Id);
+        });
+      }));
+    }
+    return Events;
+  }
+
+  /// Prefetches the \p Count elements at \p Ptr, a shared allocation of the
+  /// context, to the component devices processing them when parallel_for is
+  /// called with a range of \p Count in its outermost dimension.
+  template <typename T>
+  std::vector<event> prefetch(const T *Ptr, size_t Count,
+                              const std::vector<event> &DepEvents = {}) {
+    std::vector<event> Events;
+    Events.reserve(MQueues.size());
+    for (size_t P = 0; P < MQueues.size(); ++P) {
+      std::pair<size_t, size_t> Partition = get_partition(P, Count);
+      if (Partition.second == 0)
+        continue;
+      Events.push_back(MQueues[P].prefetch(Ptr + Partition.first,
+                                           Partition.second * sizeof(T),
+                                           DepEvents));
+    }
+    return Events;
+  }
+
+  void wait() {
+    for (queue &Q : MQueues)
+      Q.wait();
+  }
+
+  void wait_and_throw() {
+    for (queue &Q : MQueues)
+      Q.wait_and_throw();
+  }
+
+private:
+  context MContext;
+  std::vector<queue> MQueues;
+};
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
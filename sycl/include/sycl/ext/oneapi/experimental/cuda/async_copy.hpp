@@ -0,0 +1,151 @@
+//==--- async_copy.hpp - SYCL_ONEAPI_CUDA asynchronous copies --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/exception.hpp>
+
+#include <cstddef>     // for size_t
+#include <cstdint>     // for uintptr_t
+#include <cstring>     // for memcpy
+#include <type_traits> // for is_trivially_copyable_v
+
+#define SYCL_EXT_ONEAPI_CUDA_ASYNC_COPY 1
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext {
+namespace oneapi {
+namespace experimental {
+namespace cuda {
+
+// The copies use cp.async on sm_80 and later, which copies from global to
+// shared memory without going through the registers, so that the loads of
+// the next tile of a kernel overlap the computation on the current one. On
+// earlier architectures and other backends the copies are synchronous, and
+// committing and waiting for them do nothing.
+#if defined(__SYCL_DEVICE_ONLY__) && defined(__NVPTX__) &&                    \
+    (__SYCL_CUDA_ARCH__ >= 800)
+#define __SYCL_CUDA_CP_ASYNC 1
+#endif
+
+/// Starts copying \p NumBytes bytes, 4, 8 or 16, from \p src, pointing to
+/// global memory, to \p dst, pointing to local memory. Both pointers must be
+/// aligned to \p NumBytes. The copy is only complete after it is committed
+/// with commit_async_copies and waited for with wait_async_copies.
+template <size_t NumBytes>
+inline __SYCL_ALWAYS_INLINE void memcpy_async(void *dst, const void *src) {
+  static_assert(NumBytes == 4 || NumBytes == 8 || NumBytes == 16,
+                "memcpy_async copies 4, 8 or 16 bytes");
+#if defined(__SYCL_DEVICE_ONLY__)
+#if defined(__SYCL_CUDA_CP_ASYNC)
+  auto *Dst = (void __attribute__((address_space(3))) *)dst;
+  auto *Src = (const void __attribute__((address_space(1))) *)src;
+  if constexpr (NumBytes == 4)
+    __nvvm_cp_async_ca_shared_global_4(Dst, Src);
+  else if constexpr (NumBytes == 8)
+    __nvvm_cp_async_ca_shared_global_8(Dst, Src);
+  else
+    // The 16 bytes copies bypass L1, they are used for tiles read once.
+    __nvvm_cp_async_cg_shared_global_16(Dst, Src);
+#else
+  std::memcpy(dst, src, NumBytes);
+#endif
+#else
+  (void)dst;
+  (void)src;
+  throw exception(make_error_code(errc::runtime),
+                  "memcpy_async is not supported on host.");
+#endif
+}
+
+/// Commits the asynchronous copies started by the work-item since the last
+/// commit into a group of copies.
+inline __SYCL_ALWAYS_INLINE void commit_async_copies() {
+#if defined(__SYCL_DEVICE_ONLY__)
+#if defined(__SYCL_CUDA_CP_ASYNC)
+  __nvvm_cp_async_commit_group();
+#endif
+#else
+  throw exception(make_error_code(errc::runtime),
+                  "commit_async_copies is not supported on host.");
+#endif
+}
+
+/// Waits until at most \p NumPending of the groups of copies committed by the
+/// work-item are incomplete. With double buffering, waiting with one pending
+/// group completes the copies of the current tile while the copies of the
+/// next tile are in flight.
+///
+/// The copies are only visible to the other work-items of the work-group
+/// after a group_barrier.
+template <int NumPending = 0>
+inline __SYCL_ALWAYS_INLINE void wait_async_copies() {
+  static_assert(NumPending >= 0, "The number of pending groups is negative");
+#if defined(__SYCL_DEVICE_ONLY__)
+#if defined(__SYCL_CUDA_CP_ASYNC)
+  if constexpr (NumPending == 0)
+    __nvvm_cp_async_wait_all();
+  else
+    __nvvm_cp_async_wait_group(NumPending);
+#endif
+#else
+  throw exception(make_error_code(errc::runtime),
+                  "wait_async_copies is not supported on host.");
+#endif
+}
+
+/// Starts copying the \p count elements at \p src, in global memory, to
+/// \p dst, in local memory, the copies being distributed over the work-items
+/// of \p g. This stages the tiles of joint_matrix_load and group_load in
+/// local memory: the work-items commit the copies of the next tile, compute
+/// on the current one, then wait for the copies and synchronize the group.
+///
+/// The copies are of 16 bytes when both pointers are aligned to 16 bytes and
+/// the size of the elements divides 16, the remaining elements being copied
+/// one element at a time.
+template <typename Group, typename T>
+inline __SYCL_ALWAYS_INLINE void joint_memcpy_async(Group g, T *dst,
+                                                    const T *src,
+                                                    size_t count) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "The elements copied must be trivially copyable");
+#if defined(__SYCL_DEVICE_ONLY__)
+  size_t LocalId = g.get_local_linear_id();
+  size_t LocalRange = g.get_local_linear_range();
+  size_t Vectorized = 0;
+  if constexpr (16 % sizeof(T) == 0) {
+    constexpr size_t PerCopy = 16 / sizeof(T);
+    if (reinterpret_cast<uintptr_t>(dst) % 16 == 0 &&
+        reinterpret_cast<uintptr_t>(src) % 16 == 0) {
+      Vectorized = count / PerCopy * PerCopy;
+      for (size_t I = LocalId * PerCopy; I < Vectorized;
+           I += LocalRange * PerCopy)
+        memcpy_async<16>(dst + I, src + I);
+    }
+  }
+  for (size_t I = Vectorized + LocalId; I < count; I += LocalRange)
+    dst[I] = src[I];
+#else
+  (void)g;
+  (void)dst;
+  (void)src;
+  (void)count;
+  throw exception(make_error_code(errc::runtime),
+                  "joint_memcpy_async is not supported on host.");
+#endif
+}
+
+#undef __SYCL_CUDA_CP_ASYNC
+
+} // namespace cuda
+} // namespace experimental
+} // namespace oneapi
+} // namespace ext
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,260 @@
+//==------ device_algorithm.hpp --- SYCL device-wide scan and reduction ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/atomic_ref.hpp>      // for atomic_ref
+#include <sycl/event.hpp>           // for event
+#include <sycl/group_algorithm.hpp> // for exclusive_scan_over_group
+#include <sycl/group_barrier.hpp>   // for group_barrier
+#include <sycl/handler.hpp>         // for handler
+#include <sycl/info/info_desc.hpp>  // for info::device::max_work_group_size
+#include <sycl/kernel.hpp>          // for auto_name
+#include <sycl/nd_item.hpp>         // for nd_item
+#include <sycl/nd_range.hpp>        // for nd_range
+#include <sycl/queue.hpp>           // for queue
+#include <sycl/usm/usm_enums.hpp>   // for usm::alloc
+
+#include <sycl/ext/oneapi/experimental/async_alloc.hpp> // for async_malloc
+
+#include <algorithm>   // for std::min
+#include <stddef.h>    // for size_t
+#include <type_traits> // for enable_if_t, conditional_t
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+namespace detail {
+
+template <typename KernelName, typename T, typename BinaryOperation>
+class __sycl_device_scan_kernel;
+template <typename KernelName, typename T, typename BinaryOperation>
+class __sycl_device_segmented_reduce_kernel;
+
+// Kernel names are only wrapped if the user gave one, as is done for the
+// reductions.
+template <template <typename, typename, typename> class KernelT,
+          typename KernelName, typename T, typename BinaryOperation>
+using __sycl_device_algorithm_kernel = std::conditional_t<
+    std::is_same_v<KernelName, sycl::detail::auto_name>,
+    sycl::detail::auto_name, KernelT<KernelName, T, BinaryOperation>>;
+
+template <typename T, typename BinaryOperation>
+using enable_if_device_algorithm_t = std::enable_if_t<
+    (sycl::detail::is_arithmetic_or_complex<T>::value &&
+     sycl::detail::is_plus_or_multiplies_if_complex<T,
+                                                    BinaryOperation>::value &&
+     sycl::detail::is_native_op<T, BinaryOperation>::value),
+    event>;
+
+// Status of a tile of the single-pass scan.
+enum class scan_tile_status : int {
+  // Nothing is published yet.
+  invalid = 0,
+  // The aggregate of the tile alone is published.
+  aggregate = 1,
+  // The aggregate of the tile and all the tiles before it is published.
+  inclusive_prefix = 2
+};
+
+/// Work-items per work-group and elements per work-item of the single-pass
+/// scan. A tile is the part of the input scanned by one work-group.
+constexpr size_t ScanMaxWGSize = 256;
+constexpr size_t ScanItemsPerWorkItem = 4;
+
+inline size_t getDeviceAlgorithmWGSize(const queue &Queue) {
+  return std::min<size_t>(
+      ScanMaxWGSize,
+      Queue.get_device().get_info<sycl::info::device::max_work_group_size>());
+}
+
+/// Scratch memory of the single-pass scan: the counter handing out the tile
+/// indices, the statuses of the tiles and the values they publish.
+template <typename T> struct scan_scratch_layout {
+  scan_scratch_layout(size_t NumTiles) {
+    StatusBytes = (NumTiles + 1) * sizeof(int);
+    ValuesOffset = (StatusBytes + alignof(T) - 1) / alignof(T) * alignof(T);
+    TotalBytes = ValuesOffset + 2 * NumTiles * sizeof(T);
+  }
+
+  size_t StatusBytes;
+  size_t ValuesOffset;
+  size_t TotalBytes;
+};
+
+/// Computes the combination of all the tiles before Tile by looking back at
+/// the values their work-groups publish, while publishing the aggregate and
+/// then the inclusive prefix of Tile. Only called by one work-item of the
+/// work-group scanning Tile.
+template <typename T, typename BinaryOperation>
+T scanLookBack(size_t Tile, T Aggregate, int *Statuses, T *Aggregates,
+               T *InclusivePrefixes, BinaryOperation BOp) {
+  using status_ref_t =
+      sycl::atomic_ref<int, memory_order::acq_rel, memory_scope::device,
+                       access::address_space::global_space>;
+  auto Publish = [&](size_t Index, scan_tile_status Status) {
+    status_ref_t(Statuses[Index])
+        .store(static_cast<int>(Status), memory_order::release);
+  };
+
+  T Prefix = sycl::detail::identity_for_ga_op<T, BinaryOperation>();
+  if (Tile == 0) {
+    InclusivePrefixes[0] = Aggregate;
+    Publish(0, scan_tile_status::inclusive_prefix);
+    return Prefix;
+  }
+
+  Aggregates[Tile] = Aggregate;
+  Publish(Tile, scan_tile_status::aggregate);
+
+  // The tiles are handed out in order, so the work-groups waited for here
+  // are already running and guarantee forward progress.
+  for (size_t Pred = Tile; Pred-- > 0;) {
+    int Status;
+    do {
+      Status = status_ref_t(Statuses[Pred]).load(memory_order::acquire);
+    } while (Status == static_cast<int>(scan_tile_status::invalid));
+
+    if (Status == static_cast<int>(scan_tile_status::inclusive_prefix)) {
+      Prefix = BOp(InclusivePrefixes[Pred], Prefix);
+      break;
+    }
+    Prefix = BOp(Aggregates[Pred], Prefix);
+  }
+
+  InclusivePrefixes[Tile] = BOp(Prefix, Aggregate);
+  Publish(Tile, scan_tile_status::inclusive_prefix);
+  return Prefix;
+}
+
+} // namespace detail
+
+/// Computes the exclusive scan of the N elements starting at First with the
+/// initial value Init and writes it to the N elements starting at Result.
+/// The scan is done by a single kernel in which each work-group scans a tile
+/// of the input and gets the combination of the tiles before it from the
+/// values published by their work-groups (decoupled look-back).
+///
+/// First and Result are USM pointers accessible by the device of Queue and
+/// may be equal. BinaryOperation is one of the function objects supported by
+/// the group algorithms.
+/// \return an event representing the scan.
+template <typename KernelName = sycl::detail::auto_name, typename T,
+          typename BinaryOperation>
+detail::enable_if_device_algorithm_t<T, BinaryOperation>
+exclusive_scan(queue Queue, const T *First, size_t N, T *Result, T Init,
+               BinaryOperation BOp) {
+  if (N == 0)
+    return Queue.ext_oneapi_submit_barrier();
+
+  size_t WGSize = detail::getDeviceAlgorithmWGSize(Queue);
+  size_t TileSize = WGSize * detail::ScanItemsPerWorkItem;
+  size_t NumTiles = (N + TileSize - 1) / TileSize;
+
+  detail::scan_scratch_layout<T> Layout(NumTiles);
+  char *Scratch = static_cast<char *>(
+      async_malloc(Queue, sycl::usm::alloc::device, Layout.TotalBytes));
+  // The tile counter and the statuses start at zero.
+  event Cleared = Queue.memset(Scratch, 0, Layout.StatusBytes);
+
+  int *Counter = reinterpret_cast<int *>(Scratch);
+  int *Statuses = Counter + 1;
+  T *Aggregates = reinterpret_cast<T *>(Scratch + Layout.ValuesOffset);
+  T *InclusivePrefixes = Aggregates + NumTiles;
+
+  using Name = detail::__sycl_device_algorithm_kernel<
+      detail::__sycl_device_scan_kernel, KernelName, T, BinaryOperation>;
+
+  event ScanEvent = Queue.submit([&](handler &CGH) {
+    CGH.depends_on(Cleared);
+    local_accessor<size_t, 1> TileAcc{1, CGH};
+    local_accessor<T, 1> PrefixAcc{1, CGH};
+
+    CGH.parallel_for<Name>(
+        nd_range<1>{NumTiles * WGSize, WGSize}, [=](nd_item<1> NDIt) {
+          constexpr size_t ItemsPerWorkItem = detail::ScanItemsPerWorkItem;
+          auto Group = NDIt.get_group();
+          size_t LID = NDIt.get_local_linear_id();
+
+          // Take the tiles in the order the work-groups start, not in the
+          // order of their ids, which the look-back relies upon.
+          if (LID == 0)
+            TileAcc[0] = sycl::atomic_ref<int, memory_order::relaxed,
+                                          memory_scope::device,
+                                          access::address_space::global_space>(
+                             Counter[0])
+                             .fetch_add(1);
+          group_barrier(Group);
+
+          size_t Tile = TileAcc[0];
+          size_t Begin = Tile * TileSize + LID * ItemsPerWorkItem;
+          T Identity = sycl::detail::identity_for_ga_op<T, BinaryOperation>();
+          T Items[ItemsPerWorkItem];
+          T ItemsSum = Identity;
+          for (size_t I = 0; I < ItemsPerWorkItem; ++I) {
+            Items[I] = Begin + I < N ? First[Begin + I] : Identity;
+            ItemsSum = BOp(ItemsSum, Items[I]);
+          }
+
+          T ItemsPrefix = exclusive_scan_over_group(Group, ItemsSum, BOp);
+          T Aggregate = reduce_over_group(Group, ItemsSum, BOp);
+          if (LID == 0)
+            PrefixAcc[0] = detail::scanLookBack(Tile, Aggregate, Statuses,
+                                                Aggregates, InclusivePrefixes,
+                                                BOp);
+          group_barrier(Group);
+
+          T Running = BOp(BOp(Init, PrefixAcc[0]), ItemsPrefix);
+          for (size_t I = 0; I < ItemsPerWorkItem && Begin + I < N; ++I) {
+            Result[Begin + I] = Running;
+            Running = BOp(Running, Items[I]);
+          }
+        });
+  });
+
+  async_free(Queue, Scratch);
+  return ScanEvent;
+}
+
+/// Reduces each of the NumSegments segments of Input with the initial value
+/// Init and writes the result of segment S to Result[S]. Segment S is made of
+/// the elements of Input from Offsets[S] to Offsets[S + 1], so Offsets holds
+/// NumSegments + 1 values. Each segment is reduced by one work-group.
+///
+/// Input, Offsets and Result are USM pointers accessible by the device of
+/// Queue. BinaryOperation is one of the function objects supported by the
+/// group algorithms.
+/// \return an event representing the reduction.
+template <typename KernelName = sycl::detail::auto_name, typename T,
+          typename BinaryOperation>
+detail::enable_if_device_algorithm_t<T, BinaryOperation>
+segmented_reduce(queue Queue, const T *Input, const size_t *Offsets,
+                 size_t NumSegments, T *Result, T Init, BinaryOperation BOp) {
+  if (NumSegments == 0)
+    return Queue.ext_oneapi_submit_barrier();
+
+  size_t WGSize = detail::getDeviceAlgorithmWGSize(Queue);
+  using Name = detail::__sycl_device_algorithm_kernel<
+      detail::__sycl_device_segmented_reduce_kernel, KernelName, T,
+      BinaryOperation>;
+
+  return Queue.submit([&](handler &CGH) {
+    CGH.parallel_for<Name>(
+        nd_range<1>{NumSegments * WGSize, WGSize}, [=](nd_item<1> NDIt) {
+          size_t Segment = NDIt.get_group_linear_id();
+          T Sum = joint_reduce(NDIt.get_group(), Input + Offsets[Segment],
+                               Input + Offsets[Segment + 1], Init, BOp);
+          if (NDIt.get_local_linear_id() == 0)
+            Result[Segment] = Sum;
+        });
+  });
+}
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
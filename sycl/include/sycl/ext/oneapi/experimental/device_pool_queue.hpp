@@ -0,0 +1,164 @@
+//==------- device_pool_queue.hpp - SYCL Queue over a pool of devices ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp> // for context
+#include <sycl/device.hpp> // for device
+#include <sycl/event.hpp> // for event
+#include <sycl/exception.hpp> // for exception
+#include <sycl/info/info_desc.hpp> // for event_command_status
+#include <sycl/properties/queue_properties.hpp> // for discard_events
+#include <sycl/property_list.hpp> // for property_list
+#include <sycl/queue.hpp> // for queue
+#include <sycl/usm/usm_enums.hpp> // for alloc
+#include <sycl/usm/usm_pointer_info.hpp> // for get_pointer_device
+
+#include <algorithm> // for remove_if
+#include <cstddef> // for size_t
+#include <memory> // for shared_ptr
+#include <mutex> // for mutex
+#include <vector> // for vector
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+/// Queue dispatching each command group to the least loaded of a pool of
+/// devices, the one with the fewest commands submitted through the pool and
+/// not yet complete, for the independent kernels of an application scaling
+/// out over the devices of a node.
+///
+/// The queues of the devices share a context, so that the scheduler tracks
+/// the dependencies of the command groups through the buffers they access
+/// and moves the buffers between the devices as needed. The command groups
+/// using device USM are submitted with the allocation, and run on its
+/// device. Copies of a device_pool_queue are shallow, they dispatch over the
+/// same queues.
+class device_pool_queue {
+public:
+  explicit device_pool_queue(const std::vector<device> &Devices,
+                             const property_list &PropList = {})
+      : device_pool_queue(context(Devices), PropList) {}
+
+  explicit device_pool_queue(const context &Context,
+                             const property_list &PropList = {})
+      : MState(std::make_shared<State>(Context)) {
+    // The load is counted with the events of the commands.
+    if (PropList.has_property<ext::oneapi::property::queue::discard_events>())
+      throw sycl::exception(make_error_code(errc::invalid),
+                            "A device_pool_queue cannot discard events");
+    for (const device &Dev : Context.get_devices())
+      MState->Members.push_back({queue(Context, Dev, PropList), {}});
+    if (MState->Members.empty())
+      throw sycl::exception(make_error_code(errc::invalid),
+                            "A device_pool_queue needs at least one device");
+  }
+
+  context get_context() const { return MState->Context; }
+
+  /// Queues of the devices of the pool.
+  std::vector<queue> get_queues() const {
+    std::vector<queue> Queues;
+    for (const Member &M : MState->Members)
+      Queues.push_back(M.Queue);
+    return Queues;
+  }
+
+  /// Submits \p CGF to the queue of the least loaded device.
+  template <typename T> event submit(T CGF) {
+    std::lock_guard<std::mutex> Lock(MState->Mutex);
+    Member *Best = nullptr;
+    for (Member &M : MState->Members) {
+      prune(M);
+      if (!Best || M.Pending.size() < Best->Pending.size())
+        Best = &M;
+    }
+    return submitTo(*Best, CGF);
+  }
+
+  /// Submits \p CGF, which uses the USM allocation \p Ptr, to the queue of the
+  /// device of \p Ptr if it is a device allocation, otherwise to the queue of
+  /// the least loaded device.
+  template <typename T> event submit(const void *Ptr, T CGF) {
+    if (get_pointer_type(Ptr, MState->Context) != usm::alloc::device)
+      return submit(CGF);
+    device Dev = get_pointer_device(Ptr, MState->Context);
+    std::lock_guard<std::mutex> Lock(MState->Mutex);
+    for (Member &M : MState->Members) {
+      if (M.Queue.get_device() == Dev) {
+        prune(M);
+        return submitTo(M, CGF);
+      }
+    }
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "The allocation belongs to no device of the pool");
+  }
+
+  /// Number of the commands submitted to the queue of \p Dev through the pool
+  /// and not yet complete.
+  size_t get_num_pending(const device &Dev) const {
+    std::lock_guard<std::mutex> Lock(MState->Mutex);
+    for (Member &M : MState->Members) {
+      if (M.Queue.get_device() == Dev) {
+        prune(M);
+        return M.Pending.size();
+      }
+    }
+    return 0;
+  }
+
+  void wait() {
+    for (queue &Q : get_queues())
+      Q.wait();
+  }
+
+  void wait_and_throw() {
+    for (queue &Q : get_queues())
+      Q.wait_and_throw();
+  }
+
+private:
+  struct Member {
+    queue Queue;
+    /// The events of the commands of the queue not known to be complete.
+    std::vector<event> Pending;
+  };
+
+  struct State {
+    State(const context &Context) : Context(Context) {}
+
+    context Context;
+    std::vector<Member> Members;
+    std::mutex Mutex;
+  };
+
+  template <typename T> static event submitTo(Member &M, T CGF) {
+    event Event = M.Queue.submit(CGF);
+    M.Pending.push_back(Event);
+    return Event;
+  }
+
+  /// Removes the complete commands from the pending ones of \p M.
+  static void prune(Member &M) {
+    M.Pending.erase(
+        std::remove_if(M.Pending.begin(), M.Pending.end(),
+                       [](const event &E) {
+                         return E.get_info<
+                                    info::event::command_execution_status>() ==
+                                info::event_command_status::complete;
+                       }),
+        M.Pending.end());
+  }
+
+  std::shared_ptr<State> MState;
+};
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
@@ -8,12 +8,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 #include <sycl/detail/common.hpp>
 #include <sycl/event.hpp>
 #include <sycl/ext/oneapi/properties/properties.hpp>
 #include <sycl/handler.hpp>
+#include <sycl/kernel.hpp>
 #include <sycl/nd_range.hpp>
 #include <sycl/queue.hpp>
 #include <sycl/range.hpp>
@@ -93,6 +100,12 @@ void submit_impl(queue &Q, CommandGroupFunc &&CGF,
                  const sycl::detail::code_location &CodeLoc) {
   Q.submit_without_event(std::forward<CommandGroupFunc>(CGF), CodeLoc);
 }
+
+__SYCL_EXPORT event
+submit_batch_impl(queue &Q,
+                  const std::vector<std::function<void(handler &)>> &CGFs,
+                  bool CallerNeedsEvent,
+                  const sycl::detail::code_location &CodeLoc);
 } // namespace detail
 
 template <typename CommandGroupFunc>
@@ -110,6 +123,144 @@ event submit_with_event(queue Q, CommandGroupFunc &&CGF,
   return Q.submit(std::forward<CommandGroupFunc>(CGF), CodeLoc);
 }
 
+// Submits the command groups to the queue in the given order, as if submit()
+// was called for each of them. The queue lock is only taken once for the whole
+// batch.
+inline void
+submit_batch(queue Q, const std::vector<std::function<void(handler &)>> &CGFs,
+             const sycl::detail::code_location &CodeLoc =
+                 sycl::detail::code_location::current()) {
+  sycl::ext::oneapi::experimental::detail::submit_batch_impl(
+      Q, CGFs, /*CallerNeedsEvent=*/false, CodeLoc);
+}
+
+// Same as submit_batch, returns the event of the last command group.
+inline event submit_batch_with_event(
+    queue Q, const std::vector<std::function<void(handler &)>> &CGFs,
+    const sycl::detail::code_location &CodeLoc =
+        sycl::detail::code_location::current()) {
+  return sycl::ext::oneapi::experimental::detail::submit_batch_impl(
+      Q, CGFs, /*CallerNeedsEvent=*/true, CodeLoc);
+}
+
+namespace detail {
+// Argument Index of a launch_descriptor, stored at Offset in its data.
+struct launch_arg {
+  int Index;
+  size_t Offset;
+  size_t Size;
+};
+
+__SYCL_EXPORT event launch_descriptor_impl(
+    queue &Q, const kernel &Kernel, const char *KernelName, int Dims,
+    const size_t *GlobalSize, const size_t *LocalSize,
+    const unsigned char *ArgData, const launch_arg *Args, size_t NumArgs,
+    bool CallerNeedsEvent, const sycl::detail::code_location &CodeLoc);
+
+template <typename RangeT> struct LaunchDescriptorAccess;
+} // namespace detail
+
+// A precompiled kernel, typically obtained from an executable kernel_bundle,
+// with its arguments and range. When the queue allows it, launch() enqueues
+// the kernel directly, without creating a handler or a command group, so the
+// descriptor can be built once and launched repeatedly at a low cost.
+template <typename RangeT, typename = std::enable_if_t<
+                               detail::is_range_or_nd_range_v<RangeT>>>
+class launch_descriptor {
+public:
+  launch_descriptor(kernel Kernel, RangeT Range)
+      : MKernel{std::move(Kernel)}, MRange{Range},
+        MKernelName{MKernel.get_info<info::kernel::function_name>()} {}
+
+  // Sets the argument Index of the kernel to a copy of Arg.
+  template <typename T> launch_descriptor &set_arg(int Index, const T &Arg) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "The arguments of a launch_descriptor must be trivially "
+                  "copyable.");
+    auto It = std::find_if(
+        MArgs.begin(), MArgs.end(),
+        [Index](const detail::launch_arg &A) { return A.Index == Index; });
+    if (It != MArgs.end() && It->Size == sizeof(T)) {
+      std::memcpy(MArgData.data() + It->Offset, &Arg, sizeof(T));
+      return *this;
+    }
+    detail::launch_arg NewArg{Index, MArgData.size(), sizeof(T)};
+    MArgData.resize(MArgData.size() + sizeof(T));
+    std::memcpy(MArgData.data() + NewArg.Offset, &Arg, sizeof(T));
+    if (It != MArgs.end())
+      *It = NewArg;
+    else
+      MArgs.push_back(NewArg);
+    return *this;
+  }
+
+  // Sets the arguments of the kernel, in order, starting from the first one.
+  template <typename... ArgsT>
+  launch_descriptor &set_args(const ArgsT &...Args) {
+    int Index = 0;
+    (set_arg(Index++, Args), ...);
+    return *this;
+  }
+
+  const kernel &get_kernel() const noexcept { return MKernel; }
+
+  const RangeT &get_range() const noexcept { return MRange; }
+
+private:
+  kernel MKernel;
+  RangeT MRange;
+  std::string MKernelName;
+  std::vector<unsigned char> MArgData;
+  std::vector<detail::launch_arg> MArgs;
+
+  template <typename LDRangeT> friend struct detail::LaunchDescriptorAccess;
+};
+
+namespace detail {
+// Helper for launching a launch_descriptor.
+template <typename RangeT> struct LaunchDescriptorAccess {
+  static event launch(queue &Q, const launch_descriptor<RangeT> &Desc,
+                      bool CallerNeedsEvent,
+                      const sycl::detail::code_location &CodeLoc) {
+    constexpr int Dims = RangeT::dimensions;
+    size_t GlobalSize[Dims];
+    size_t LocalSize[Dims];
+    constexpr bool IsNDRange = std::is_same_v<RangeT, nd_range<Dims>>;
+    for (int I = 0; I < Dims; ++I) {
+      if constexpr (IsNDRange) {
+        GlobalSize[I] = Desc.MRange.get_global_range()[I];
+        LocalSize[I] = Desc.MRange.get_local_range()[I];
+      } else {
+        GlobalSize[I] = Desc.MRange[I];
+      }
+    }
+    return launch_descriptor_impl(
+        Q, Desc.MKernel, Desc.MKernelName.c_str(), Dims, GlobalSize,
+        IsNDRange ? LocalSize : nullptr, Desc.MArgData.data(),
+        Desc.MArgs.data(), Desc.MArgs.size(), CallerNeedsEvent, CodeLoc);
+  }
+};
+} // namespace detail
+
+// Enqueues the kernel of the launch descriptor with its arguments and range.
+// Unlike a submission with a handler, the arguments can't be accessors.
+template <typename RangeT>
+void launch(queue Q, const launch_descriptor<RangeT> &Desc,
+            const sycl::detail::code_location &CodeLoc =
+                sycl::detail::code_location::current()) {
+  detail::LaunchDescriptorAccess<RangeT>::launch(
+      Q, Desc, /*CallerNeedsEvent=*/false, CodeLoc);
+}
+
+// Same as launch, returns the event of the kernel.
+template <typename RangeT>
+event launch_with_event(queue Q, const launch_descriptor<RangeT> &Desc,
+                        const sycl::detail::code_location &CodeLoc =
+                            sycl::detail::code_location::current()) {
+  return detail::LaunchDescriptorAccess<RangeT>::launch(
+      Q, Desc, /*CallerNeedsEvent=*/true, CodeLoc);
+}
+
 template <typename KernelName = sycl::detail::auto_name, typename KernelType>
 void single_task(handler &CGH, const KernelType &KernelObj) {
   CGH.single_task<KernelName>(KernelObj);
@@ -108,7 +108,9 @@ enum class node_type {
   prefetch = 6,
   memadvise = 7,
   ext_oneapi_barrier = 8,
-  host_task = 9
+  host_task = 9,
+  ext_oneapi_mem_alloc = 10,
+  ext_oneapi_mem_free = 11
 };
 
 /// Class representing a node in the graph, returned by command_graph::add().
@@ -185,6 +187,27 @@ class enable_profiling : public ::sycl::detail::DataLessProperty<
 public:
   enable_profiling() = default;
 };
+
+/// Property passed to command_graph<graph_state::modifiable>::finalize() to
+/// optimize the resulting executable command_graph. Redundant edges are
+/// removed and chains of contiguous USM copies or fills are merged into single
+/// nodes.
+class enable_optimizations
+    : public ::sycl::detail::DataLessProperty<
+          ::sycl::detail::GraphEnableOptimizations> {
+public:
+  enable_optimizations() = default;
+};
+
+/// Property passed to command_graph<graph_state::modifiable>::finalize() to
+/// let the executable command_graph run independent parts of the graph on
+/// several internal in-order queues of the device it was submitted to. The
+/// event returned by a submission still covers the whole graph.
+class use_multiple_queues : public ::sycl::detail::DataLessProperty<
+                                ::sycl::detail::GraphUseMultipleQueues> {
+public:
+  use_multiple_queues() = default;
+};
 } // namespace graph
 
 namespace node {
@@ -272,6 +295,44 @@ public:
     return Node;
   }
 
+  /// Add a node allocating device memory owned by the graph. The memory may
+  /// only be used by nodes ordered after this node and, if there is one,
+  /// before the matching free node. Allocations whose lifetimes don't overlap
+  /// share device memory once the graph is finalized.
+  /// @param[out] Ptr Set to the device address of the allocation.
+  /// @param Size Number of bytes to allocate.
+  /// @param PropList Property list used to pass [0..n] predecessor nodes.
+  /// @return Constructed allocation node which has been added to the graph.
+  node add_malloc_device(void *&Ptr, size_t Size,
+                         const property_list &PropList = {}) {
+    std::vector<node> Deps;
+    if (PropList.has_property<property::node::depends_on>())
+      Deps = PropList.get_property<property::node::depends_on>()
+                 .get_dependencies();
+    node Node = addMallocDeviceImpl(Ptr, Size, Deps);
+    if (PropList.has_property<property::node::depends_on_all_leaves>()) {
+      addGraphLeafDependencies(Node);
+    }
+    return Node;
+  }
+
+  /// Add a node ending the lifetime of memory allocated by an allocation node
+  /// of this graph.
+  /// @param Ptr Device address returned by add_malloc_device().
+  /// @param PropList Property list used to pass [0..n] predecessor nodes.
+  /// @return Constructed free node which has been added to the graph.
+  node add_free(void *Ptr, const property_list &PropList = {}) {
+    std::vector<node> Deps;
+    if (PropList.has_property<property::node::depends_on>())
+      Deps = PropList.get_property<property::node::depends_on>()
+                 .get_dependencies();
+    node Node = addFreeImpl(Ptr, Deps);
+    if (PropList.has_property<property::node::depends_on_all_leaves>()) {
+      addGraphLeafDependencies(Node);
+    }
+    return Node;
+  }
+
   /// Add a dependency between two nodes.
   /// @param Src Node which will be a dependency of \p Dest.
   /// @param Dest Node which will be dependent on \p Src.
@@ -349,6 +410,20 @@ protected:
   /// @return Node added to the graph.
   node addImpl(const std::vector<node> &Dep);
 
+  /// Implementation of add_malloc_device().
+  /// @param[out] Ptr Set to the device address of the allocation.
+  /// @param Size Number of bytes to allocate.
+  /// @param Dep List of predecessor nodes.
+  /// @return Node added to the graph.
+  node addMallocDeviceImpl(void *&Ptr, size_t Size,
+                           const std::vector<node> &Dep);
+
+  /// Implementation of add_free().
+  /// @param Ptr Device address of the allocation to free.
+  /// @param Dep List of predecessor nodes.
+  /// @return Node added to the graph.
+  node addFreeImpl(void *Ptr, const std::vector<node> &Dep);
+
   /// Adds all graph leaves as dependencies
   /// @param Node Destination node to which the leaves of the graph will be
   /// added as dependencies.
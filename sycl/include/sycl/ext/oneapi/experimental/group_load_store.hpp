@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <sycl/ext/oneapi/free_function_queries.hpp>
 #include <sycl/ext/oneapi/properties/properties.hpp>
 #include <sycl/group_barrier.hpp>
 #include <sycl/sycl_span.hpp>
@@ -133,6 +134,13 @@ int get_mem_idx(GroupTy g, int vec_or_array_idx) {
 // Utility type traits below are used to map user type to one of the block
 // read/write types above.
 
+#if defined(__SPIR__)
+// TODO: What about non-Intel SPIR-V devices?
+inline constexpr bool has_block_ops = true;
+#else
+inline constexpr bool has_block_ops = false;
+#endif
+
 template <typename IteratorT, std::size_t ElementsPerWorkItem, bool Blocked>
 struct BlockInfo {
   using value_type =
@@ -182,14 +190,7 @@ auto get_block_op_ptr(IteratorT iter, [[maybe_unused]] Properties props) {
   constexpr bool blocked = detail::isBlocked(props);
   using BlkInfo = BlockInfo<IteratorT, ElementsPerWorkItem, blocked>;
 
-#if defined(__SPIR__)
-  // TODO: What about non-Intel SPIR-V devices?
-  constexpr bool is_spir = true;
-#else
-  constexpr bool is_spir = false;
-#endif
-
-  if constexpr (!is_spir || !BlkInfo::has_builtin) {
+  if constexpr (!has_block_ops || !BlkInfo::has_builtin) {
     return nullptr;
   } else if constexpr (!props.template has_property<full_group_key>()) {
     return nullptr;
@@ -226,6 +227,26 @@ auto get_block_op_ptr(IteratorT iter, [[maybe_unused]] Properties props) {
     }
   }
 }
+
+// Moves the values of the work-items of g from one data placement to the
+// other through the local memory in scratch.
+template <bool FromBlocked, typename Group, typename T,
+          std::size_t ElementsPerWorkItem>
+void group_transpose(Group g, span<T, ElementsPerWorkItem> values,
+                     span<std::byte> scratch) {
+  std::byte *mem = scratch.data();
+  for (int i = 0; i < values.size(); ++i)
+    std::memcpy(mem + get_mem_idx<FromBlocked, ElementsPerWorkItem>(g, i) *
+                          sizeof(T),
+                &values[i], sizeof(T));
+  group_barrier(g);
+  for (int i = 0; i < values.size(); ++i)
+    std::memcpy(&values[i],
+                mem + get_mem_idx<!FromBlocked, ElementsPerWorkItem>(g, i) *
+                          sizeof(T),
+                sizeof(T));
+  group_barrier(g);
+}
 } // namespace detail
 
 // Load API span overload.
@@ -248,7 +269,29 @@ group_load(Group g, InputIteratorT in_ptr,
     group_barrier(g);
     return;
   } else if constexpr (!std::is_same_v<Group, sycl::sub_group>) {
-    return group_load(g, in_ptr, out, use_naive{});
+    if constexpr (!detail::has_block_ops ||
+                  !props.template has_property<full_group_key>()) {
+      return group_load(g, in_ptr, out, use_naive{});
+    } else {
+      // Let every sub-group load its part of the data, which it can do with
+      // block reads. The sub-groups are full if the work-group is full and
+      // made of whole sub-groups.
+      sycl::sub_group sg = sycl::ext::oneapi::this_work_item::get_sub_group();
+      const size_t sg_max = sg.get_max_local_range()[0];
+      const size_t wg_size = g.get_local_linear_range();
+      if (wg_size % sg_max != 0)
+        return group_load(g, in_ptr, out, use_naive{});
+
+      const size_t sg_begin = sg.get_group_linear_id() * sg_max;
+      if constexpr (blocked) {
+        group_load(sg, in_ptr + sg_begin * ElementsPerWorkItem, out, props);
+      } else {
+        for (int i = 0; i < out.size(); ++i)
+          group_load(sg, in_ptr + (sg_begin + i * wg_size),
+                     span<OutputT, 1>(&out[i], 1), props);
+      }
+      return;
+    }
   } else {
     auto ptr =
         detail::get_block_op_ptr<4 /* load align */, ElementsPerWorkItem>(
@@ -320,7 +363,29 @@ group_store(Group g, const span<InputT, ElementsPerWorkItem> in,
     group_barrier(g);
     return;
   } else if constexpr (!std::is_same_v<Group, sycl::sub_group>) {
-    return group_store(g, in, out_ptr, use_naive{});
+    if constexpr (!detail::has_block_ops ||
+                  !props.template has_property<full_group_key>()) {
+      return group_store(g, in, out_ptr, use_naive{});
+    } else {
+      // Let every sub-group store its part of the data, which it can do with
+      // block writes. The sub-groups are full if the work-group is full and
+      // made of whole sub-groups.
+      sycl::sub_group sg = sycl::ext::oneapi::this_work_item::get_sub_group();
+      const size_t sg_max = sg.get_max_local_range()[0];
+      const size_t wg_size = g.get_local_linear_range();
+      if (wg_size % sg_max != 0)
+        return group_store(g, in, out_ptr, use_naive{});
+
+      const size_t sg_begin = sg.get_group_linear_id() * sg_max;
+      if constexpr (blocked) {
+        group_store(sg, in, out_ptr + sg_begin * ElementsPerWorkItem, props);
+      } else {
+        for (int i = 0; i < in.size(); ++i)
+          group_store(sg, span<InputT, 1>(&in[i], 1),
+                      out_ptr + (sg_begin + i * wg_size), props);
+      }
+      return;
+    }
   } else {
     auto ptr =
         detail::get_block_op_ptr<16 /* store align */, ElementsPerWorkItem>(
@@ -388,6 +453,30 @@ group_store(Group g, const sycl::vec<InputT, N> &in, OutputIteratorT out_ptr,
   group_store(g, span<const InputT, N>(&in[0], N), out_ptr, properties);
 }
 
+// Rearranges the values of the work-items of g from the blocked to the
+// striped data placement. scratch must be local memory of at least
+// g.get_local_linear_range() * ElementsPerWorkItem * sizeof(T) bytes.
+// Loading striped data and transposing it is usually faster than loading
+// blocked data, as the loads of a group are then contiguous.
+template <typename Group, typename T, std::size_t ElementsPerWorkItem>
+std::enable_if_t<std::is_trivially_copyable_v<T> &&
+                 detail::is_generic_group_v<Group>>
+group_blocked_to_striped(Group g, span<T, ElementsPerWorkItem> values,
+                         span<std::byte> scratch) {
+  detail::group_transpose</*FromBlocked=*/true>(g, values, scratch);
+}
+
+// Rearranges the values of the work-items of g from the striped to the
+// blocked data placement. scratch must be local memory of at least
+// g.get_local_linear_range() * ElementsPerWorkItem * sizeof(T) bytes.
+template <typename Group, typename T, std::size_t ElementsPerWorkItem>
+std::enable_if_t<std::is_trivially_copyable_v<T> &&
+                 detail::is_generic_group_v<Group>>
+group_striped_to_blocked(Group g, span<T, ElementsPerWorkItem> values,
+                         span<std::byte> scratch) {
+  detail::group_transpose</*FromBlocked=*/false>(g, values, scratch);
+}
+
 #else
 template <typename... Args> void group_load(Args...) {
   throw sycl::exception(
@@ -399,6 +488,16 @@ template <typename... Args> void group_store(Args...) {
       sycl::errc::feature_not_supported,
       "Group loads/stores are not supported on host.");
 }
+template <typename... Args> void group_blocked_to_striped(Args...) {
+  throw sycl::exception(
+      sycl::errc::feature_not_supported,
+      "Group loads/stores are not supported on host.");
+}
+template <typename... Args> void group_striped_to_blocked(Args...) {
+  throw sycl::exception(
+      sycl::errc::feature_not_supported,
+      "Group loads/stores are not supported on host.");
+}
 #endif
 } // namespace ext::oneapi::experimental
 } // namespace _V1
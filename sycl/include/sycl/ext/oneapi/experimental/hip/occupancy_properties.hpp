@@ -0,0 +1,52 @@
+//==- occupancy_properties.hpp - Occupancy kernel properties for AMD GPUs --==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/ext/oneapi/properties/properties.hpp>
+#include <sycl/ext/oneapi/properties/property.hpp>
+#include <sycl/ext/oneapi/properties/property_utils.hpp>
+#include <sycl/ext/oneapi/properties/property_value.hpp>
+
+#include <stdint.h> // for uint32_t
+
+#define SYCL_EXT_ONEAPI_HIP_WAVES_PER_EU 1
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental::hip {
+/// Minimum and, if not 0, maximum number of waves per execution unit the
+/// kernel is compiled for on AMD GPUs. The AMDGPU backend limits the
+/// registers of each work-item so that at least Min waves fit on an
+/// execution unit, instead of using as many registers as the kernel needs.
+struct waves_per_eu_key
+    : detail::compile_time_property_key<detail::PropKind::WavesPerEU> {
+  template <uint32_t Min, uint32_t Max>
+  using value_t = property_value<waves_per_eu_key,
+                                 std::integral_constant<uint32_t, Min>,
+                                 std::integral_constant<uint32_t, Max>>;
+};
+
+template <uint32_t Min, uint32_t Max = 0>
+inline constexpr waves_per_eu_key::value_t<Min, Max> waves_per_eu;
+
+} // namespace ext::oneapi::experimental::hip
+namespace ext::oneapi::experimental::detail {
+template <uint32_t Min, uint32_t Max>
+struct PropertyMetaInfo<
+    sycl::ext::oneapi::experimental::hip::waves_per_eu_key::value_t<Min,
+                                                                     Max>> {
+  static_assert(Min > 0, "The minimum number of waves per EU must be positive");
+  static_assert(Max == 0 || Min <= Max,
+                "The minimum number of waves per EU exceeds the maximum");
+  static constexpr const char *name = "sycl-waves-per-eu";
+  static constexpr const char *value = SizeListToStr<Min, Max>::value;
+};
+} // namespace ext::oneapi::experimental::detail
+} // namespace _V1
+} // namespace sycl
@@ -12,10 +12,16 @@
 #include <sycl/ext/oneapi/experimental/use_root_sync_prop.hpp>
 #include <sycl/ext/oneapi/free_function_queries.hpp>
 #include <sycl/group.hpp>
+#include <sycl/kernel.hpp>
 #include <sycl/memory_enums.hpp>
 #include <sycl/nd_item.hpp>
+#include <sycl/nd_range.hpp>
+#include <sycl/queue.hpp>
 #include <sycl/sub_group.hpp>
 
+#include <algorithm>
+#include <cstddef>
+
 #ifdef __SYCL_DEVICE_ONLY__
 #include <sycl/ext/oneapi/functional.hpp>
 #endif
@@ -89,6 +95,49 @@ root_group<Dimensions> get_root_group() {
 }
 } // namespace this_kernel
 
+/// Returns the launch range of Kernel on the device of Queue with the most
+/// work-items whose work-groups are all co-resident, so that a launch with
+/// the use_root_sync property can synchronize its root group, e.g. in a
+/// persistent kernel. Each work-group uses DynamicLocalMemorySize bytes of
+/// local memory besides the static local memory of the kernel.
+///
+/// The work-group sizes tried are the largest one the kernel supports on the
+/// device and its halves down to the sub-group size, the number of
+/// co-resident work-groups of each being given by the max_num_work_groups
+/// query, which accounts for the registers and the local memory used by the
+/// kernel. Throws errc::invalid if no work-group of the kernel fits on the
+/// device.
+inline nd_range<1>
+get_max_co_resident_nd_range(const kernel &Kernel, const queue &Queue,
+                             size_t DynamicLocalMemorySize = 0) {
+  const device Dev = Queue.get_device();
+  const size_t MaxWorkGroupSize =
+      Kernel.get_info<info::kernel_device_specific::work_group_size>(Dev);
+  const size_t MinWorkGroupSize = std::max<size_t>(
+      Kernel.get_info<info::kernel_device_specific::max_sub_group_size>(Dev),
+      1);
+
+  size_t BestWorkGroupSize = 0;
+  size_t BestNumWorkGroups = 0;
+  for (size_t WorkGroupSize = MaxWorkGroupSize;
+       WorkGroupSize >= MinWorkGroupSize; WorkGroupSize /= 2) {
+    const size_t NumWorkGroups = Kernel.ext_oneapi_get_info<
+        info::kernel_queue_specific::max_num_work_groups>(
+        Queue, range<3>{WorkGroupSize, 1, 1}, DynamicLocalMemorySize);
+    // The largest work-groups are preferred for the same number of
+    // work-items.
+    if (NumWorkGroups * WorkGroupSize > BestNumWorkGroups * BestWorkGroupSize) {
+      BestWorkGroupSize = WorkGroupSize;
+      BestNumWorkGroups = NumWorkGroups;
+    }
+  }
+  if (BestNumWorkGroups == 0)
+    throw sycl::exception(make_error_code(errc::invalid),
+                          "No work-group of the kernel fits on the device");
+  return nd_range<1>{range<1>{BestNumWorkGroups * BestWorkGroupSize},
+                     range<1>{BestWorkGroupSize}};
+}
+
 } // namespace ext::oneapi::experimental
 
 template <int dimensions>
@@ -0,0 +1,33 @@
+//==--- specialize_nd_range_prop.hpp --- SYCL ND-range specialization ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Declaration of the property to be included in <sycl/handler.hpp>.
+
+#pragma once
+
+#include <sycl/ext/oneapi/properties/properties.hpp>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+/// Requests the kernel to be JIT compiled for the ND-range it is launched
+/// with, the global and local sizes and the global offset becoming constants
+/// of the kernel. A kernel is compiled once per ND-range it is launched with.
+/// Only honored for nd_range launches when the kernels are JIT compiled, see
+/// SYCL_JIT_AMDGCN_PTX_KERNELS.
+struct specialize_nd_range_key
+    : detail::compile_time_property_key<detail::PropKind::SpecializeNDRange> {
+  using value_t = property_value<specialize_nd_range_key>;
+};
+
+inline constexpr specialize_nd_range_key::value_t specialize_nd_range;
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
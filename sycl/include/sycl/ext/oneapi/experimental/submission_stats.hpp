@@ -0,0 +1,61 @@
+//==------ submission_stats.hpp - SYCL submission latency breakdown --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/export.hpp>
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+/// Phases of the host side of a command group submission. The time of a
+/// phase includes the time of the phases nested in it: scheduler_add_cg is
+/// part of handler_finalize, graph_build and enqueue_command are part of
+/// scheduler_add_cg, kernel_lookup and set_arguments are part of
+/// enqueue_command unless the kernel is enqueued directly by the queue.
+enum class submission_phase : int {
+  handler_finalize = 0,
+  scheduler_add_cg = 1,
+  graph_build = 2,
+  enqueue_command = 3,
+  kernel_lookup = 4,
+  set_arguments = 5
+};
+
+/// Time spent in a submission phase since the start of the application or the
+/// last call to reset_submission_stats().
+struct submission_phase_stats {
+  static constexpr size_t histogram_size = 32;
+
+  uint64_t count = 0;
+  uint64_t total_ns = 0;
+  uint64_t max_ns = 0;
+  /// histogram[I] counts the runs of the phase which took from 2^I to
+  /// 2^(I+1) - 1 nanoseconds, the last bucket also counts the longer ones.
+  std::array<uint64_t, histogram_size> histogram{};
+};
+
+/// Returns the statistics of Phase. They are only collected after
+/// set_submission_stats_enabled(true) or when the SYCL_SUBMISSION_STATS
+/// environment variable is set to 1, in which case the runtime also prints
+/// them to stderr at exit.
+__SYCL_EXPORT submission_phase_stats
+get_submission_stats(submission_phase Phase);
+
+__SYCL_EXPORT void reset_submission_stats();
+
+__SYCL_EXPORT void set_submission_stats_enabled(bool Enabled);
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
@@ -85,6 +85,16 @@ struct max_linear_work_group_size_key
                                  std::integral_constant<size_t, Size>>;
 };
 
+/// The range a parallel_for kernel is always launched with, the global range
+/// for nd_range launches. The range is a compile-time constant of the kernel,
+/// which is never range rounded, and launching it with another range throws.
+struct launch_range_key
+    : detail::compile_time_property_key<detail::PropKind::LaunchRange> {
+  template <size_t... Dims>
+  using value_t = property_value<launch_range_key,
+                                 std::integral_constant<size_t, Dims>...>;
+};
+
 template <size_t Dim0, size_t... Dims>
 struct property_value<work_group_size_key, std::integral_constant<size_t, Dim0>,
                       std::integral_constant<size_t, Dims>...> {
@@ -174,6 +184,23 @@ template <> struct property_value<max_linear_work_group_size_key> {
   using key_t = max_linear_work_group_size_key;
 };
 
+template <size_t Dim0, size_t... Dims>
+struct property_value<launch_range_key, std::integral_constant<size_t, Dim0>,
+                      std::integral_constant<size_t, Dims>...> {
+  static_assert(
+      sizeof...(Dims) + 1 <= 3,
+      "launch_range property currently only supports up to three values.");
+  static_assert(detail::AllNonZero<Dim0, Dims...>::value,
+                "launch_range property must only contain non-zero values.");
+
+  using key_t = launch_range_key;
+  static constexpr int dimensions = sizeof...(Dims) + 1;
+
+  constexpr size_t operator[](int Dim) const {
+    return std::array<size_t, sizeof...(Dims) + 1>{Dim0, Dims...}[Dim];
+  }
+};
+
 template <size_t Dim0, size_t... Dims>
 inline constexpr work_group_size_key::value_t<Dim0, Dims...> work_group_size;
 
@@ -200,6 +227,9 @@ template <size_t Size>
 inline constexpr max_linear_work_group_size_key::value_t<Size>
     max_linear_work_group_size;
 
+template <size_t Dim0, size_t... Dims>
+inline constexpr launch_range_key::value_t<Dim0, Dims...> launch_range;
+
 struct work_group_progress_key
     : detail::compile_time_property_key<detail::PropKind::WorkGroupProgress> {
   template <forward_progress_guarantee Guarantee,
@@ -296,6 +326,9 @@ struct HasCompileTimeEffect<sub_group_size_key::value_t<Size>>
 template <sycl::aspect... Aspects>
 struct HasCompileTimeEffect<device_has_key::value_t<Aspects...>>
     : std::true_type {};
+template <size_t... Dims>
+struct HasCompileTimeEffect<launch_range_key::value_t<Dims...>>
+    : std::true_type {};
 
 template <size_t Dim0, size_t... Dims>
 struct PropertyMetaInfo<work_group_size_key::value_t<Dim0, Dims...>> {
@@ -337,6 +370,11 @@ struct PropertyMetaInfo<max_linear_work_group_size_key::value_t<Size>> {
   static constexpr const char *name = "sycl-max-linear-work-group-size";
   static constexpr size_t value = Size;
 };
+template <size_t Dim0, size_t... Dims>
+struct PropertyMetaInfo<launch_range_key::value_t<Dim0, Dims...>> {
+  static constexpr const char *name = "sycl-launch-range";
+  static constexpr const char *value = SizeListToStr<Dim0, Dims...>::value;
+};
 
 template <typename T, typename = void>
 struct HasKernelPropertiesGetMethod : std::false_type {};
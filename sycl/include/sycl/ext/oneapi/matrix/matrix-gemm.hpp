@@ -0,0 +1,353 @@
+//==------------- matrix-gemm.hpp - SYCL matrix ----------------*- C++ -*---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// ===--------------------------------------------------------------------=== //
+// Reference GEMM and batched GEMM built on joint_matrix:
+//
+//   C = Alpha * A * B + Beta * C
+//
+// with A (M x K) and B (K x N) row major matrices of bfloat16 or half, and C
+// a row major M x N matrix of float. The tile sizes, the sub-group size and
+// the blocking are selected by the architecture of the device. Each
+// work-group stages the blocks of A and B in double-buffered local memory,
+// so that the copy of the next block overlaps the multiplication of the
+// current one with a single barrier per block, and prefetches the block
+// after it on the Intel GPUs. The partial blocks at the edges of the matrices
+// are zero-filled in local memory, so M, N and K are arbitrary.
+// ===--------------------------------------------------------------------=== //
+
+#pragma once
+
+#include <sycl/device.hpp>                           // for device
+#include <sycl/event.hpp>                            // for event
+#include <sycl/exception.hpp>                        // for exception
+#include <sycl/ext/oneapi/bfloat16.hpp>              // for bfloat16
+#include <sycl/ext/oneapi/experimental/device_architecture.hpp>
+#include <sycl/ext/oneapi/experimental/prefetch.hpp> // for prefetch
+#include <sycl/ext/oneapi/matrix/matrix-unified.hpp> // for joint_matrix
+#include <sycl/group_barrier.hpp>                    // for group_barrier
+#include <sycl/half_type.hpp>                        // for half
+#include <sycl/nd_range.hpp>                         // for nd_range
+#include <sycl/queue.hpp>                            // for queue
+
+#include <cstddef>     // for size_t
+#include <type_traits> // for is_same_v
+#include <vector>      // for vector
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental::matrix {
+
+/// Matrix units the GEMM configurations target.
+enum class gemm_backend { intel_xmx, nvidia_tensor_cores, amd_matrix_cores };
+
+/// Tile configuration of the GEMM kernel:
+///  - TM x TN x TK are the sizes of the joint_matrix multiplication;
+///  - each sub-group of SGSize work-items computes SGTilesM x SGTilesN tiles
+///    of C;
+///  - each work-group has WGSubGroupsM x WGSubGroupsN sub-groups;
+///  - KBlock elements of K are staged in local memory at a time.
+template <gemm_backend Backend, size_t TM, size_t TN, size_t TK, size_t SGSize,
+          size_t SGTilesM, size_t SGTilesN, size_t WGSubGroupsM,
+          size_t WGSubGroupsN, size_t KBlock>
+struct gemm_tile_config {
+  static_assert(KBlock % TK == 0, "KBlock must be a multiple of TK");
+
+  static constexpr gemm_backend backend = Backend;
+  static constexpr size_t tm = TM;
+  static constexpr size_t tn = TN;
+  static constexpr size_t tk = TK;
+  static constexpr size_t sg_size = SGSize;
+  static constexpr size_t sg_tiles_m = SGTilesM;
+  static constexpr size_t sg_tiles_n = SGTilesN;
+  static constexpr size_t wg_sub_groups_m = WGSubGroupsM;
+  static constexpr size_t wg_sub_groups_n = WGSubGroupsN;
+  static constexpr size_t k_block = KBlock;
+
+  /// Rows and columns of C computed by a work-group.
+  static constexpr size_t wg_m = TM * SGTilesM * WGSubGroupsM;
+  static constexpr size_t wg_n = TN * SGTilesN * WGSubGroupsN;
+  static constexpr size_t wg_size = SGSize * WGSubGroupsM * WGSubGroupsN;
+};
+
+/// Ponte Vecchio, Battlemage and Lunar Lake.
+using gemm_config_intel_xe_hpc =
+    gemm_tile_config<gemm_backend::intel_xmx, 8, 16, 16, 16, 4, 2, 2, 2, 32>;
+/// Alchemist.
+using gemm_config_intel_xe_hpg =
+    gemm_tile_config<gemm_backend::intel_xmx, 8, 8, 16, 8, 4, 4, 2, 2, 32>;
+/// Volta and later for half, Ampere and later for bfloat16.
+using gemm_config_nvidia =
+    gemm_tile_config<gemm_backend::nvidia_tensor_cores, 16, 16, 16, 32, 2, 2,
+                     2, 2, 32>;
+/// CDNA2 and CDNA3.
+using gemm_config_amd =
+    gemm_tile_config<gemm_backend::amd_matrix_cores, 16, 16, 16, 64, 2, 2, 2,
+                     2, 32>;
+
+template <typename Config, typename T> class __gemm_kernel;
+
+} // namespace ext::oneapi::experimental::matrix
+
+namespace ext::oneapi::detail {
+using namespace sycl::ext::oneapi::experimental::matrix;
+
+// Whether the kernels of Config are compiled for the current device target,
+// the joint_matrix shapes of the other backends may not be supported by it.
+template <typename Config> constexpr bool isGemmConfigCompiled() {
+#if defined(__SYCL_DEVICE_ONLY__)
+#if defined(__NVPTX__)
+  return Config::backend == gemm_backend::nvidia_tensor_cores;
+#elif defined(__HIP_PLATFORM_AMD_MFMA__)
+  return Config::backend == gemm_backend::amd_matrix_cores;
+#elif defined(__SPIR__) || defined(__SPIRV__)
+  return Config::backend == gemm_backend::intel_xmx;
+#else
+  return false;
+#endif
+#else
+  return false;
+#endif
+}
+
+template <typename Config, typename T>
+void gemmWorkGroup(nd_item<3> It, const T *A, const T *B, float *C, size_t M,
+                   size_t N, size_t K, size_t Lda, size_t Ldb, size_t Ldc,
+                   float Alpha, float Beta, T *ALocal, T *BLocal,
+                   float *CLocal) {
+  constexpr size_t TM = Config::tm, TN = Config::tn, TK = Config::tk;
+  constexpr size_t WGM = Config::wg_m, WGN = Config::wg_n;
+  constexpr size_t KBlock = Config::k_block;
+  constexpr size_t ABlockSize = WGM * KBlock, BBlockSize = KBlock * WGN;
+
+  sycl::sub_group SG = It.get_sub_group();
+  size_t SGRow = It.get_local_id(1);
+  size_t SGCol = It.get_local_id(2) / Config::sg_size;
+  size_t SGId = SGRow * Config::wg_sub_groups_n + SGCol;
+  size_t LocalId = It.get_local_linear_id();
+  size_t M0 = It.get_group(1) * WGM;
+  size_t N0 = It.get_group(2) * WGN;
+  size_t NumKBlocks = (K + KBlock - 1) / KBlock;
+
+  // Copies the K block KB of A and B into the local memory of Stage.
+  auto CopyBlock = [&](size_t KB, size_t Stage) {
+    size_t K0 = KB * KBlock;
+    for (size_t I = LocalId; I < ABlockSize; I += Config::wg_size) {
+      size_t Row = M0 + I / KBlock, Col = K0 + I % KBlock;
+      ALocal[Stage * ABlockSize + I] =
+          Row < M && Col < K ? A[Row * Lda + Col] : T(0);
+    }
+    for (size_t I = LocalId; I < BBlockSize; I += Config::wg_size) {
+      size_t Row = K0 + I / WGN, Col = N0 + I % WGN;
+      BLocal[Stage * BBlockSize + I] =
+          Row < K && Col < N ? B[Row * Ldb + Col] : T(0);
+    }
+  };
+  // Prefetches the rows of the K block KB the work-item copies.
+  auto PrefetchBlock = [&](size_t KB) {
+    if constexpr (Config::backend == gemm_backend::intel_xmx) {
+      size_t K0 = KB * KBlock;
+      if (K0 >= K)
+        return;
+      if (LocalId < WGM && M0 + LocalId < M)
+        experimental::prefetch(
+            const_cast<T *>(A + (M0 + LocalId) * Lda + K0), KBlock);
+      if (LocalId < KBlock && K0 + LocalId < K)
+        experimental::prefetch(
+            const_cast<T *>(B + (K0 + LocalId) * Ldb + N0), WGN);
+    }
+  };
+
+  joint_matrix<sycl::sub_group, float, use::accumulator, TM, TN>
+      Acc[Config::sg_tiles_m][Config::sg_tiles_n];
+  for (size_t TI = 0; TI < Config::sg_tiles_m; ++TI)
+    for (size_t TJ = 0; TJ < Config::sg_tiles_n; ++TJ)
+      joint_matrix_fill(SG, Acc[TI][TJ], 0.0f);
+
+  CopyBlock(0, 0);
+  PrefetchBlock(1);
+  group_barrier(It.get_group());
+  for (size_t KB = 0; KB < NumKBlocks; ++KB) {
+    size_t Stage = KB % 2;
+    // The other stage was last read before the barrier ending the previous
+    // iteration, so it can be overwritten while this one is multiplied.
+    if (KB + 1 < NumKBlocks)
+      CopyBlock(KB + 1, 1 - Stage);
+    PrefetchBlock(KB + 2);
+
+    auto AStage = address_space_cast<access::address_space::local_space,
+                                     access::decorated::no>(
+        ALocal + Stage * ABlockSize);
+    auto BStage = address_space_cast<access::address_space::local_space,
+                                     access::decorated::no>(
+        BLocal + Stage * BBlockSize);
+    for (size_t KK = 0; KK < KBlock; KK += TK) {
+      joint_matrix<sycl::sub_group, T, use::a, TM, TK, layout::row_major>
+          TA[Config::sg_tiles_m];
+      joint_matrix<sycl::sub_group, T, use::b, TK, TN, layout::row_major>
+          TB[Config::sg_tiles_n];
+      for (size_t TI = 0; TI < Config::sg_tiles_m; ++TI)
+        joint_matrix_load(
+            SG, TA[TI],
+            AStage + ((SGRow * Config::sg_tiles_m + TI) * TM) * KBlock + KK,
+            KBlock);
+      for (size_t TJ = 0; TJ < Config::sg_tiles_n; ++TJ)
+        joint_matrix_load(
+            SG, TB[TJ],
+            BStage + KK * WGN + (SGCol * Config::sg_tiles_n + TJ) * TN, WGN);
+      for (size_t TI = 0; TI < Config::sg_tiles_m; ++TI)
+        for (size_t TJ = 0; TJ < Config::sg_tiles_n; ++TJ)
+          joint_matrix_mad(SG, Acc[TI][TJ], TA[TI], TB[TJ], Acc[TI][TJ]);
+    }
+    group_barrier(It.get_group());
+  }
+
+  // The tiles go through local memory, so that the edges of C are not
+  // written out of bounds and Beta * C is added with the scalar loads.
+  float *SGScratch = CLocal + SGId * TM * TN;
+  auto Scratch = address_space_cast<access::address_space::local_space,
+                                    access::decorated::no>(SGScratch);
+  size_t Lane = SG.get_local_linear_id();
+  for (size_t TI = 0; TI < Config::sg_tiles_m; ++TI)
+    for (size_t TJ = 0; TJ < Config::sg_tiles_n; ++TJ) {
+      joint_matrix_store(SG, Acc[TI][TJ], Scratch, TN, layout::row_major);
+      group_barrier(SG);
+      size_t TileRow = M0 + (SGRow * Config::sg_tiles_m + TI) * TM;
+      size_t TileCol = N0 + (SGCol * Config::sg_tiles_n + TJ) * TN;
+      for (size_t I = Lane; I < TM * TN; I += Config::sg_size) {
+        size_t Row = TileRow + I / TN, Col = TileCol + I % TN;
+        if (Row >= M || Col >= N)
+          continue;
+        float &Out = C[Row * Ldc + Col];
+        Out = Beta == 0.0f ? Alpha * SGScratch[I]
+                           : Alpha * SGScratch[I] + Beta * Out;
+      }
+      group_barrier(SG);
+    }
+}
+
+template <typename Config, typename T>
+event submitBatchedGemm(queue &Q, size_t Batch, size_t M, size_t N, size_t K,
+                        float Alpha, const T *A, size_t Lda, size_t StrideA,
+                        const T *B, size_t Ldb, size_t StrideB, float Beta,
+                        float *C, size_t Ldc, size_t StrideC,
+                        const std::vector<event> &DepEvents) {
+  constexpr size_t WGM = Config::wg_m, WGN = Config::wg_n;
+  size_t GroupsM = (M + WGM - 1) / WGM;
+  size_t GroupsN = (N + WGN - 1) / WGN;
+  range<3> Local{1, Config::wg_sub_groups_m,
+                 Config::wg_sub_groups_n * Config::sg_size};
+  range<3> Global{Batch, GroupsM * Local[1], GroupsN * Local[2]};
+  return Q.submit([&](handler &CGH) {
+    CGH.depends_on(DepEvents);
+    local_accessor<T, 1> ALocal(2 * WGM * Config::k_block, CGH);
+    local_accessor<T, 1> BLocal(2 * Config::k_block * WGN, CGH);
+    local_accessor<float, 1> CLocal(
+        Config::wg_sub_groups_m * Config::wg_sub_groups_n * Config::tm *
+            Config::tn,
+        CGH);
+    CGH.parallel_for<__gemm_kernel<Config, T>>(
+        nd_range<3>(Global, Local),
+        [=](nd_item<3> It) [[sycl::reqd_sub_group_size(Config::sg_size)]] {
+          if constexpr (isGemmConfigCompiled<Config>()) {
+            size_t Batch = It.get_group(0);
+            gemmWorkGroup<Config>(
+                It, A + Batch * StrideA, B + Batch * StrideB,
+                C + Batch * StrideC, M, N, K, Lda, Ldb, Ldc, Alpha, Beta,
+                &ALocal[0], &BLocal[0], &CLocal[0]);
+          }
+        });
+  });
+}
+
+template <typename T>
+event batchedGemm(queue &Q, size_t Batch, size_t M, size_t N, size_t K,
+                  float Alpha, const T *A, size_t Lda, size_t StrideA,
+                  const T *B, size_t Ldb, size_t StrideB, float Beta, float *C,
+                  size_t Ldc, size_t StrideC,
+                  const std::vector<event> &DepEvents) {
+  static_assert(std::is_same_v<T, sycl::ext::oneapi::bfloat16> ||
+                    std::is_same_v<T, sycl::half>,
+                "The GEMM supports bfloat16 and half matrices");
+  if (Batch == 0 || M == 0 || N == 0)
+    return Q.ext_oneapi_submit_barrier(DepEvents);
+
+  using experimental::architecture;
+  architecture Arch =
+      Q.get_device().get_info<experimental::info::device::architecture>();
+  auto Submit = [&](auto Config) {
+    return submitBatchedGemm<decltype(Config)>(
+        Q, Batch, M, N, K, Alpha, A, Lda, StrideA, B, Ldb, StrideB, Beta, C,
+        Ldc, StrideC, DepEvents);
+  };
+  switch (Arch) {
+  case architecture::intel_gpu_pvc:
+  case architecture::intel_gpu_pvc_vg:
+  case architecture::intel_gpu_bmg_g21:
+  case architecture::intel_gpu_lnl_m:
+    return Submit(gemm_config_intel_xe_hpc{});
+  case architecture::intel_gpu_acm_g10:
+  case architecture::intel_gpu_acm_g11:
+  case architecture::intel_gpu_acm_g12:
+    return Submit(gemm_config_intel_xe_hpg{});
+  case architecture::nvidia_gpu_sm_70:
+  case architecture::nvidia_gpu_sm_72:
+  case architecture::nvidia_gpu_sm_75:
+    if (std::is_same_v<T, sycl::ext::oneapi::bfloat16>)
+      break;
+    return Submit(gemm_config_nvidia{});
+  case architecture::nvidia_gpu_sm_80:
+  case architecture::nvidia_gpu_sm_86:
+  case architecture::nvidia_gpu_sm_87:
+  case architecture::nvidia_gpu_sm_89:
+  case architecture::nvidia_gpu_sm_90:
+  case architecture::nvidia_gpu_sm_90a:
+    return Submit(gemm_config_nvidia{});
+  case architecture::amd_gpu_gfx90a:
+  case architecture::amd_gpu_gfx940:
+  case architecture::amd_gpu_gfx941:
+  case architecture::amd_gpu_gfx942:
+    return Submit(gemm_config_amd{});
+  default:
+    break;
+  }
+  throw exception(make_error_code(errc::feature_not_supported),
+                  "There is no joint_matrix GEMM configuration for the "
+                  "architecture of the device");
+}
+} // namespace ext::oneapi::detail
+
+namespace ext::oneapi::experimental::matrix {
+
+/// Computes C = Alpha * A * B + Beta * C, with A a M x K matrix of leading
+/// dimension Lda, B a K x N matrix of leading dimension Ldb and C a M x N
+/// matrix of leading dimension Ldc, all of them row major USM allocations.
+/// Throws an exception with the errc::feature_not_supported code if there is
+/// no configuration for the architecture of the device of Q.
+template <typename T>
+event gemm(queue &Q, size_t M, size_t N, size_t K, float Alpha, const T *A,
+           size_t Lda, const T *B, size_t Ldb, float Beta, float *C,
+           size_t Ldc, const std::vector<event> &DepEvents = {}) {
+  return oneapi::detail::batchedGemm(Q, 1, M, N, K, Alpha, A, Lda, 0, B, Ldb,
+                                     0, Beta, C, Ldc, 0, DepEvents);
+}
+
+/// Computes Batch GEMMs with the same dimensions, the matrices of the batch
+/// I start at A + I * StrideA, B + I * StrideB and C + I * StrideC.
+template <typename T>
+event batched_gemm(queue &Q, size_t Batch, size_t M, size_t N, size_t K,
+                   float Alpha, const T *A, size_t Lda, size_t StrideA,
+                   const T *B, size_t Ldb, size_t StrideB, float Beta,
+                   float *C, size_t Ldc, size_t StrideC,
+                   const std::vector<event> &DepEvents = {}) {
+  return oneapi::detail::batchedGemm(Q, Batch, M, N, K, Alpha, A, Lda,
+                                     StrideA, B, Ldb, StrideB, Beta, C, Ldc,
+                                     StrideC, DepEvents);
+}
+
+} // namespace ext::oneapi::experimental::matrix
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,222 @@
+//==------------ matrix-packing.hpp - SYCL matrix --------------*- C++ -*---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// ===--------------------------------------------------------------------=== //
+// Host-side helpers packing the B matrices of a GEMM into the VNNI layout
+// loaded with layout::ext_intel_packed by the Intel XMX and AMX units, padded
+// to the tile sizes the device supports, and caching the packed matrices so
+// that constant weights are only packed once.
+// ===--------------------------------------------------------------------=== //
+
+#pragma once
+
+#include <sycl/device.hpp>                                 // for device
+#include <sycl/event.hpp>                                  // for event
+#include <sycl/exception.hpp>                              // for exception
+#include <sycl/ext/oneapi/bfloat16.hpp>                    // for bfloat16
+#include <sycl/ext/oneapi/matrix/matrix-unified-utils.hpp> // for layout
+#include <sycl/ext/oneapi/matrix/query-types.hpp>          // for combination
+#include <sycl/half_type.hpp>                              // for half
+#include <sycl/queue.hpp>                                  // for queue
+#include <sycl/usm.hpp>                                    // for malloc_device
+
+#include <algorithm>     // for max
+#include <cstddef>       // for size_t
+#include <cstdint>       // for int8_t, uint8_t
+#include <mutex>         // for mutex, lock_guard
+#include <type_traits>   // for is_same_v
+#include <unordered_map> // for unordered_map
+#include <vector>        // for vector
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::detail {
+template <typename T>
+constexpr bool isPackedMatrixType(experimental::matrix::matrix_type Type) {
+  using experimental::matrix::matrix_type;
+  if constexpr (std::is_same_v<T, sycl::ext::oneapi::bfloat16>)
+    return Type == matrix_type::bf16;
+  else if constexpr (std::is_same_v<T, sycl::half>)
+    return Type == matrix_type::fp16;
+  else if constexpr (std::is_same_v<T, int8_t>)
+    return Type == matrix_type::sint8;
+  else if constexpr (std::is_same_v<T, uint8_t>)
+    return Type == matrix_type::uint8;
+  else if constexpr (std::is_same_v<T, float>)
+    return Type == matrix_type::fp32 || Type == matrix_type::tf32;
+  else
+    return false;
+}
+
+inline size_t roundUpToMultiple(size_t Value, size_t Multiple) {
+  return (Value + Multiple - 1) / Multiple * Multiple;
+}
+} // namespace ext::oneapi::detail
+
+namespace ext::intel::experimental::matrix {
+template <typename T> class __pack_b_kernel;
+
+/// Shape of a K x N B matrix packed by pack_b. The rows and columns are
+/// padded with zeros to multiples of the K and N tile sizes of the device, so
+/// that the kernels don't need the checked loads for the partial tiles.
+template <typename T> struct packed_b_shape {
+  /// Number of elements of 32 bits the VNNI layout interleaves.
+  static constexpr size_t vnni_factor = 4 / sizeof(T);
+
+  size_t rows = 0; // padded K
+  size_t cols = 0; // padded N
+
+  /// Stride of joint_matrix_load with layout::ext_intel_packed.
+  size_t stride() const { return cols * vnni_factor; }
+  /// Number of elements of the packed matrix.
+  size_t size() const { return rows * cols; }
+};
+
+/// Returns the shape of a K x N B matrix of type T packed for Dev, using the
+/// largest tile sizes of the matrix combinations of the device for T.
+template <typename T>
+packed_b_shape<T> get_packed_b_shape(const device &Dev, size_t K, size_t N) {
+  static_assert(sizeof(T) <= 4, "Elements are larger than 32 bits");
+  namespace syclex = sycl::ext::oneapi::experimental;
+  size_t TileK = packed_b_shape<T>::vnni_factor;
+  size_t TileN = 1;
+  for (const syclex::matrix::combination &C :
+       Dev.get_info<syclex::info::device::matrix_combinations>()) {
+    if (!oneapi::detail::isPackedMatrixType<T>(C.btype))
+      continue;
+    TileK = std::max(TileK, C.ksize ? C.ksize : C.max_ksize);
+    TileN = std::max(TileN, C.nsize ? C.nsize : C.max_nsize);
+  }
+  packed_b_shape<T> Shape;
+  Shape.rows = oneapi::detail::roundUpToMultiple(K, TileK);
+  Shape.cols = oneapi::detail::roundUpToMultiple(N, TileN);
+  return Shape;
+}
+
+/// Packs the K x N matrix Src, of leading dimension Ld and of layout
+/// SrcLayout, row_major or col_major, into Dst, a USM allocation of
+/// Shape.size() elements, with the padding filled with zeros.
+template <typename T>
+event pack_b(queue &Q, const T *Src, size_t K, size_t N, size_t Ld,
+             oneapi::experimental::matrix::layout SrcLayout, T *Dst,
+             const packed_b_shape<T> &Shape,
+             const std::vector<event> &DepEvents = {}) {
+  using oneapi::experimental::matrix::layout;
+  if (SrcLayout != layout::row_major && SrcLayout != layout::col_major)
+    throw exception(make_error_code(errc::invalid),
+                    "Only row_major and col_major matrices can be packed");
+  if (Shape.rows < K || Shape.cols < N)
+    throw exception(make_error_code(errc::invalid),
+                    "The packed shape is smaller than the matrix");
+
+  constexpr size_t Vnni = packed_b_shape<T>::vnni_factor;
+  return Q.submit([&](handler &CGH) {
+    CGH.depends_on(DepEvents);
+    bool RowMajor = SrcLayout == layout::row_major;
+    size_t Stride = Shape.stride();
+    CGH.parallel_for<__pack_b_kernel<T>>(
+        range<2>(Shape.rows / Vnni, Shape.cols), [=](item<2> It) {
+          size_t KBlock = It[0];
+          size_t Col = It[1];
+          for (size_t V = 0; V < Vnni; ++V) {
+            size_t Row = KBlock * Vnni + V;
+            T Value = T(0);
+            if (Row < K && Col < N)
+              Value = RowMajor ? Src[Row * Ld + Col] : Src[Col * Ld + Row];
+            Dst[KBlock * Stride + Col * Vnni + V] = Value;
+          }
+        });
+  });
+}
+
+/// Cache of the B matrices packed for the device of a queue, keyed by the
+/// address of the source matrix. The packed matrices are owned by the cache
+/// and freed when it is destroyed, or when the source is invalidated.
+template <typename T> class packed_b_cache {
+public:
+  explicit packed_b_cache(const queue &Q) : MQueue(Q) {}
+  packed_b_cache(const packed_b_cache &) = delete;
+  packed_b_cache &operator=(const packed_b_cache &) = delete;
+  ~packed_b_cache() { clear(); }
+
+  /// Returns the packed matrix of Src, packing it if it isn't in the cache
+  /// or was packed with different dimensions. Src must be invalidated when
+  /// its content changes.
+  const T *get(const T *Src, size_t K, size_t N, size_t Ld,
+               oneapi::experimental::matrix::layout SrcLayout) {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    auto It = MEntries.find(Src);
+    if (It != MEntries.end()) {
+      const Entry &E = It->second;
+      if (E.K == K && E.N == N && E.Ld == Ld && E.SrcLayout == SrcLayout)
+        return E.Packed;
+      free(E.Packed, MQueue);
+      MEntries.erase(It);
+    }
+
+    packed_b_shape<T> Shape = get_packed_b_shape<T>(MQueue.get_device(), K, N);
+    T *Packed = malloc_device<T>(Shape.size(), MQueue);
+    if (!Packed)
+      throw exception(make_error_code(errc::memory_allocation),
+                      "Failed to allocate the packed matrix");
+    try {
+      pack_b(MQueue, Src, K, N, Ld, SrcLayout, Packed, Shape).wait();
+    } catch (...) {
+      free(Packed, MQueue);
+      throw;
+    }
+    MEntries.emplace(Src, Entry{Packed, K, N, Ld, SrcLayout, Shape});
+    return Packed;
+  }
+
+  /// Returns the shape of the packed matrix of Src, which must be in the
+  /// cache.
+  packed_b_shape<T> get_shape(const T *Src) const {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    auto It = MEntries.find(Src);
+    if (It == MEntries.end())
+      throw exception(make_error_code(errc::invalid),
+                      "The matrix is not in the cache");
+    return It->second.Shape;
+  }
+
+  /// Frees the packed matrix of Src, if any.
+  void invalidate(const T *Src) {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    auto It = MEntries.find(Src);
+    if (It == MEntries.end())
+      return;
+    free(It->second.Packed, MQueue);
+    MEntries.erase(It);
+  }
+
+  /// Frees all the packed matrices.
+  void clear() {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    for (auto &[Src, E] : MEntries)
+      free(E.Packed, MQueue);
+    MEntries.clear();
+  }
+
+private:
+  struct Entry {
+    T *Packed = nullptr;
+    size_t K = 0;
+    size_t N = 0;
+    size_t Ld = 0;
+    oneapi::experimental::matrix::layout SrcLayout =
+        oneapi::experimental::matrix::layout::row_major;
+    packed_b_shape<T> Shape;
+  };
+
+  queue MQueue;
+  mutable std::mutex MMutex;
+  std::unordered_map<const T *, Entry> MEntries;
+};
+
+} // namespace ext::intel::experimental::matrix
+} // namespace _V1
+} // namespace sycl
@@ -214,8 +214,12 @@ enum PropKind : uint32_t {
   ResponseCapacity = 73,
   MaxWorkGroupSize = 74,
   MaxLinearWorkGroupSize = 75,
+  SpecializeNDRange = 76,
+  LaunchRange = 77,
+  FPAccuracy = 78,
+  WavesPerEU = 79,
   // PropKindSize must always be the last value.
-  PropKindSize = 76,
+  PropKindSize = 80,
 };
 
 struct property_key_base_tag {};
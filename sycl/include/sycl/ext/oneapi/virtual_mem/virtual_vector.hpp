@@ -0,0 +1,168 @@
+//==--- virtual_vector.hpp - sycl_ext_oneapi_virtual_mem growable array ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>
+#include <sycl/device.hpp>
+#include <sycl/exception.hpp>
+#include <sycl/ext/oneapi/virtual_mem/physical_mem.hpp>
+#include <sycl/ext/oneapi/virtual_mem/virtual_mem.hpp>
+#include <sycl/queue.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+/// Device array growing in place: it reserves a virtual address range for
+/// up to a maximum number of elements and maps physical memory to it as it
+/// grows, so that growing neither reallocates nor copies the elements, and
+/// the memory used while growing is only the memory of the new size.
+///
+/// The elements are accessed from the device through data(). The elements
+/// added by resize are uninitialized.
+template <typename T> class virtual_vector {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "The elements of virtual_vector must be trivially copyable");
+
+public:
+  /// Reserves the virtual address range of \p MaxSize elements.
+  virtual_vector(const device &SyclDevice, const context &SyclContext,
+                 size_t MaxSize)
+      : MDevice(SyclDevice), MContext(SyclContext),
+        MGranularity(get_mem_granularity(SyclDevice, SyclContext)) {
+    MReservedBytes = roundUp(MaxSize * sizeof(T));
+    MPtr = reserve_virtual_mem(MReservedBytes, MContext);
+  }
+
+  virtual_vector(const queue &SyclQueue, size_t MaxSize)
+      : virtual_vector(SyclQueue.get_device(), SyclQueue.get_context(),
+                       MaxSize) {}
+
+  virtual_vector(const virtual_vector &) = delete;
+  virtual_vector &operator=(const virtual_vector &) = delete;
+
+  virtual_vector(virtual_vector &&Other) noexcept
+      : MDevice(Other.MDevice), MContext(Other.MContext),
+        MGranularity(Other.MGranularity),
+        MReservedBytes(std::exchange(Other.MReservedBytes, 0)),
+        MPtr(std::exchange(Other.MPtr, 0)),
+        MMappedBytes(std::exchange(Other.MMappedBytes, 0)),
+        MSize(std::exchange(Other.MSize, 0)),
+        MChunks(std::move(Other.MChunks)) {}
+
+  virtual_vector &operator=(virtual_vector &&Other) noexcept {
+    if (this != &Other) {
+      release();
+      MDevice = Other.MDevice;
+      MContext = Other.MContext;
+      MGranularity = Other.MGranularity;
+      MReservedBytes = std::exchange(Other.MReservedBytes, 0);
+      MPtr = std::exchange(Other.MPtr, 0);
+      MMappedBytes = std::exchange(Other.MMappedBytes, 0);
+      MSize = std::exchange(Other.MSize, 0);
+      MChunks = std::move(Other.MChunks);
+    }
+    return *this;
+  }
+
+  ~virtual_vector() { release(); }
+
+  T *data() const { return reinterpret_cast<T *>(MPtr); }
+
+  size_t size() const noexcept { return MSize; }
+  bool empty() const noexcept { return MSize == 0; }
+  /// Number of elements backed by physical memory.
+  size_t capacity() const noexcept { return MMappedBytes / sizeof(T); }
+  /// Number of elements of the reserved virtual address range.
+  size_t max_size() const noexcept { return MReservedBytes / sizeof(T); }
+
+  /// Maps physical memory for at least \p NewCapacity elements. The new
+  /// memory is mapped right after the mapped one, so data() doesn't change.
+  void reserve(size_t NewCapacity) {
+    if (NewCapacity > max_size())
+      throw exception(make_error_code(errc::invalid),
+                      "The capacity exceeds the reserved virtual range");
+    size_t Bytes = roundUp(NewCapacity * sizeof(T));
+    if (Bytes <= MMappedBytes)
+      return;
+
+    physical_mem Mem(MDevice, MContext, Bytes - MMappedBytes);
+    Mem.map(MPtr + MMappedBytes, Bytes - MMappedBytes,
+            address_access_mode::read_write);
+    MChunks.push_back({std::move(Mem), MMappedBytes});
+    MMappedBytes = Bytes;
+  }
+
+  /// Resizes the array to \p NewSize elements, mapping the physical memory
+  /// they need. The elements are neither moved nor copied.
+  void resize(size_t NewSize) {
+    reserve(NewSize);
+    MSize = NewSize;
+  }
+
+  void clear() noexcept { MSize = 0; }
+
+  /// Unmaps and releases the physical memory the elements don't use.
+  void shrink_to_fit() {
+    size_t Needed = roundUp(MSize * sizeof(T));
+    while (!MChunks.empty() && MChunks.back().Offset >= Needed) {
+      const Chunk &Last = MChunks.back();
+      unmap(reinterpret_cast<const void *>(MPtr + Last.Offset),
+            MMappedBytes - Last.Offset, MContext);
+      MMappedBytes = Last.Offset;
+      MChunks.pop_back();
+    }
+  }
+
+private:
+  // Physical memory mapped at Offset bytes from the start of the range.
+  struct Chunk {
+    physical_mem Mem;
+    size_t Offset;
+  };
+
+  size_t roundUp(size_t Bytes) const {
+    return (Bytes + MGranularity - 1) / MGranularity * MGranularity;
+  }
+
+  void release() noexcept {
+    if (!MPtr)
+      return;
+    // The errors on release can't be reported from the destructor.
+    try {
+      if (MMappedBytes)
+        unmap(reinterpret_cast<const void *>(MPtr), MMappedBytes, MContext);
+      MChunks.clear();
+      free_virtual_mem(MPtr, MReservedBytes, MContext);
+    } catch (...) {
+    }
+    MPtr = 0;
+    MMappedBytes = 0;
+    MSize = 0;
+  }
+
+  device MDevice;
+  context MContext;
+  size_t MGranularity;
+  size_t MReservedBytes = 0;
+  uintptr_t MPtr = 0;
+  size_t MMappedBytes = 0;
+  size_t MSize = 0;
+  std::vector<Chunk> MChunks;
+};
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
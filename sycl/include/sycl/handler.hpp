@@ -35,6 +35,7 @@
 #include <sycl/ext/oneapi/experimental/cluster_group_prop.hpp>
 #include <sycl/ext/oneapi/experimental/graph.hpp>
 #include <sycl/ext/oneapi/experimental/raw_kernel_arg.hpp>
+#include <sycl/ext/oneapi/experimental/specialize_nd_range_prop.hpp>
 #include <sycl/ext/oneapi/experimental/use_root_sync_prop.hpp>
 #include <sycl/ext/oneapi/experimental/virtual_functions.hpp>
 #include <sycl/ext/oneapi/kernel_properties/properties.hpp>
@@ -692,8 +693,11 @@ private:
         detail::KernelLambdaHasKernelHandlerArgT<KernelType,
                                                  LambdaArgType>::value;
 
-    MHostKernel = std::make_unique<
-        detail::HostKernel<KernelType, LambdaArgType, Dims>>(KernelFunc);
+    // The arguments are marshalled from the captures of the stored copy, so
+    // the lambda is moved rather than copied into it.
+    MHostKernel =
+        std::make_unique<detail::HostKernel<KernelType, LambdaArgType, Dims>>(
+            std::move(KernelFunc));
 
     constexpr bool KernelHasName =
         detail::getKernelName<KernelName>() != nullptr &&
@@ -762,6 +766,30 @@ private:
     }
   }
 
+  /// Checks that a kernel with the launch_range property is launched with
+  /// that range.
+  ///
+  /// \param Range is the range of the launch, the global range for nd_range
+  /// launches.
+  template <typename PropertiesT, int Dims>
+  static void checkLaunchRange(const range<Dims> &Range) {
+    using LaunchRangeKey = ext::oneapi::experimental::launch_range_key;
+    if constexpr (PropertiesT::template has_property<LaunchRangeKey>()) {
+      constexpr auto LaunchRange =
+          PropertiesT::template get_property<LaunchRangeKey>();
+      static_assert(LaunchRange.dimensions == Dims,
+                    "launch_range property must have the dimensionality of "
+                    "the range the kernel is launched with");
+      for (int I = 0; I < Dims; ++I)
+        if (Range[I] != LaunchRange[I])
+          throw sycl::exception(make_error_code(errc::nd_range),
+                                "The range of the launch doesn't match the "
+                                "launch_range property of the kernel");
+    } else {
+      std::ignore = Range;
+    }
+  }
+
   /// Process runtime kernel properties.
   ///
   /// Stores information about kernel properties into the handler.
@@ -783,6 +811,11 @@ private:
     constexpr bool UsesRootSync = PropertiesT::template has_property<
         sycl::ext::oneapi::experimental::use_root_sync_key>();
     setKernelIsCooperative(UsesRootSync);
+    if constexpr (PropertiesT::template has_property<
+                      sycl::ext::oneapi::experimental::
+                          specialize_nd_range_key>()) {
+      setKernelSpecializesNDRange(true);
+    }
     if constexpr (PropertiesT::template has_property<
                       sycl::ext::oneapi::experimental::
                           work_group_progress_key>()) {
@@ -1134,49 +1167,64 @@ private:
     using NameT =
         typename detail::get_kernel_name_t<KernelName, KernelType>::name;
 
+    // Kernels launched with a compile-time range are used as is.
+    using MergedPropertiesT =
+        typename detail::GetMergedKernelProperties<KernelType,
+                                                   PropertiesT>::type;
+    constexpr bool HasLaunchRange = MergedPropertiesT::template has_property<
+        ext::oneapi::experimental::launch_range_key>();
+
     // Range rounding can be disabled by the user.
     // Range rounding is not done on the host device.
     // Range rounding is supported only for newer SYCL standards.
 #if !defined(__SYCL_DISABLE_PARALLEL_FOR_RANGE_ROUNDING__) &&                  \
     !defined(DPCPP_HOST_DEVICE_OPENMP) &&                                      \
     !defined(DPCPP_HOST_DEVICE_PERF_NATIVE) && SYCL_LANGUAGE_VERSION >= 202001
-    auto [RoundedRange, HasRoundedRange] = getRoundedRange(UserRange);
-    if (HasRoundedRange) {
-      using NameWT = typename detail::get_kernel_wrapper_name_t<NameT>::name;
-      auto Wrapper =
-          getRangeRoundedKernelLambda<NameWT, TransformedArgType, Dims>(
-              KernelFunc, UserRange);
-
-      using KName = std::conditional_t<std::is_same<KernelType, NameT>::value,
-                                       decltype(Wrapper), NameWT>;
-
-      kernel_parallel_for_wrapper<KName, TransformedArgType, decltype(Wrapper),
-                                  PropertiesT>(Wrapper);
+    if constexpr (!HasLaunchRange) {
+      auto [RoundedRange, HasRoundedRange] = getRoundedRange(UserRange);
+      if (HasRoundedRange) {
+        using NameWT = typename detail::get_kernel_wrapper_name_t<NameT>::name;
+        auto Wrapper =
+            getRangeRoundedKernelLambda<NameWT, TransformedArgType, Dims>(
+                KernelFunc, UserRange);
+
+        using KName = std::conditional_t<std::is_same<KernelType, NameT>::value,
+                                         decltype(Wrapper), NameWT>;
+
+        kernel_parallel_for_wrapper<KName, TransformedArgType,
+                                    decltype(Wrapper), PropertiesT>(Wrapper);
 #ifndef __SYCL_DEVICE_ONLY__
-      verifyUsedKernelBundleInternal(
-          detail::string_view{detail::getKernelName<NameT>()});
-      // We are executing over the rounded range, but there are still
-      // items/ids that are are constructed in ther range rounded
-      // kernel use items/ids in the user range, which means that
-      // __SYCL_ASSUME_INT can still be violated. So check the bounds
-      // of the user range, instead of the rounded range.
-      detail::checkValueRange<Dims>(UserRange);
-      setNDRangeDescriptor(RoundedRange);
-      StoreLambda<KName, decltype(Wrapper), Dims, TransformedArgType>(
-          std::move(Wrapper));
-      setType(detail::CGType::Kernel);
-      setNDRangeUsed(false);
+        verifyUsedKernelBundleInternal(
+            detail::string_view{detail::getKernelName<NameT>()});
+        // We are executing over the rounded range, but there are still
+        // items/ids that are are constructed in ther range rounded
+        // kernel use items/ids in the user range, which means that
+        // __SYCL_ASSUME_INT can still be violated. So check the bounds
+        // of the user range, instead of the rounded range.
+        detail::checkValueRange<Dims>(UserRange);
+        setNDRangeDescriptor(RoundedRange);
+        StoreLambda<KName, decltype(Wrapper), Dims, TransformedArgType>(
+            std::move(Wrapper));
+        setType(detail::CGType::Kernel);
+        setNDRangeUsed(false);
 #endif
-    } else
+        return;
+      }
+    }
 #endif // !__SYCL_DISABLE_PARALLEL_FOR_RANGE_ROUNDING__ &&
        // !DPCPP_HOST_DEVICE_OPENMP && !DPCPP_HOST_DEVICE_PERF_NATIVE &&
        // SYCL_LANGUAGE_VERSION >= 202001
-    {
-      (void)UserRange;
-      (void)Props;
-#ifndef __SYCL_FORCE_PARALLEL_FOR_RANGE_ROUNDING__
-      // If parallel_for range rounding is forced then only range rounded
-      // kernel is generated
+
+    (void)UserRange;
+    (void)Props;
+#ifdef __SYCL_FORCE_PARALLEL_FOR_RANGE_ROUNDING__
+    // If parallel_for range rounding is forced then only range rounded
+    // kernel is generated, unless the range is known at compile time.
+    constexpr bool HasUnroundedKernel = HasLaunchRange;
+#else
+    constexpr bool HasUnroundedKernel = true;
+#endif
+    if constexpr (HasUnroundedKernel) {
       kernel_parallel_for_wrapper<NameT, TransformedArgType, KernelType,
                                   PropertiesT>(KernelFunc);
 #ifndef __SYCL_DEVICE_ONLY__
@@ -1184,15 +1232,15 @@ private:
           detail::string_view{detail::getKernelName<NameT>()});
       processProperties<detail::isKernelESIMD<NameT>(), PropertiesT>(Props);
       detail::checkValueRange<Dims>(UserRange);
+      checkLaunchRange<MergedPropertiesT>(UserRange);
       setNDRangeDescriptor(std::move(UserRange));
       StoreLambda<NameT, KernelType, Dims, TransformedArgType>(
           std::move(KernelFunc));
       setType(detail::CGType::Kernel);
       setNDRangeUsed(false);
 #endif
-#else
+    } else {
       (void)KernelFunc;
-#endif // __SYCL_FORCE_PARALLEL_FOR_RANGE_ROUNDING__
     }
   }
 
@@ -1234,6 +1282,8 @@ private:
     verifyUsedKernelBundleInternal(
         detail::string_view{detail::getKernelName<NameT>()});
     detail::checkValueRange<Dims>(ExecutionRange);
+    checkLaunchRange<typename detail::GetMergedKernelProperties<
+        KernelType, PropertiesT>::type>(ExecutionRange.get_global_range());
     setNDRangeDescriptor(std::move(ExecutionRange));
     processProperties<detail::isKernelESIMD<NameT>(), PropertiesT>(Props);
     StoreLambda<NameT, KernelType, Dims, TransformedArgType>(
@@ -1427,6 +1477,36 @@ private:
 #endif
   }
 
+#ifdef __SYCL_DEVICE_ONLY__
+  // Tells the device compiler that a kernel with the launch_range property
+  // always runs over that range, so the range queries fold into constants.
+  template <typename... Props, typename ElementType>
+  static void assumeLaunchRange(const ElementType &Item) {
+    using LaunchRangeKey = ext::oneapi::experimental::launch_range_key;
+    using PropertyTupleT = std::tuple<Props...>;
+    if constexpr (ext::oneapi::experimental::detail::ContainsProperty<
+                      LaunchRangeKey, PropertyTupleT>::value) {
+      constexpr auto LaunchRange = std::remove_const_t<
+          typename ext::oneapi::experimental::detail::
+              FindCompileTimePropertyValueType<LaunchRangeKey,
+                                               PropertyTupleT>::type>{};
+      constexpr int Dims = LaunchRange.dimensions;
+      for (int I = 0; I < Dims; ++I) {
+        if constexpr (std::is_same_v<ElementType, nd_item<Dims>>) {
+          size_t Range = Item.get_global_range(I);
+          __builtin_assume(Range == LaunchRange[I]);
+        } else if constexpr (std::is_same_v<ElementType, item<Dims, true>> ||
+                             std::is_same_v<ElementType, item<Dims, false>>) {
+          size_t Range = Item.get_range(I);
+          __builtin_assume(Range == LaunchRange[I]);
+        }
+      }
+    } else {
+      (void)Item;
+    }
+  }
+#endif
+
   // NOTE: the name of these functions - "kernel_parallel_for" - are used by the
   // Front End to determine kernel invocation kind.
   template <typename KernelName, typename ElementType, typename KernelType,
@@ -1439,7 +1519,9 @@ private:
   __SYCL_KERNEL_ATTR__ static void
   kernel_parallel_for(_KERNELFUNCPARAM(KernelFunc)) {
 #ifdef __SYCL_DEVICE_ONLY__
-    KernelFunc(detail::Builder::getElement(detail::declptr<ElementType>()));
+    auto Item = detail::Builder::getElement(detail::declptr<ElementType>());
+    assumeLaunchRange<Props...>(Item);
+    KernelFunc(Item);
 #else
     (void)KernelFunc;
 #endif
@@ -1457,7 +1539,9 @@ private:
   __SYCL_KERNEL_ATTR__ static void
   kernel_parallel_for(_KERNELFUNCPARAM(KernelFunc), kernel_handler KH) {
 #ifdef __SYCL_DEVICE_ONLY__
-    KernelFunc(detail::Builder::getElement(detail::declptr<ElementType>()), KH);
+    auto Item = detail::Builder::getElement(detail::declptr<ElementType>());
+    assumeLaunchRange<Props...>(Item);
+    KernelFunc(Item, KH);
 #else
     (void)KernelFunc;
     (void)KH;
@@ -1648,7 +1732,7 @@ private:
     // known constant.
     setNDRangeDescriptor(range<1>{1});
     processProperties<detail::isKernelESIMD<NameT>(), PropertiesT>(Props);
-    StoreLambda<NameT, KernelType, /*Dims*/ 1, void>(KernelFunc);
+    StoreLambda<NameT, KernelType, /*Dims*/ 1, void>(std::move(KernelFunc));
     setType(detail::CGType::Kernel);
 #endif
   }
@@ -3541,6 +3625,9 @@ private:
   // Set value of the kernel is cooperative flag
   void setKernelIsCooperative(bool);
 
+  // Set value of the kernel is specialized for its ND-range flag
+  void setKernelSpecializesNDRange(bool);
+
   // Set using cuda thread block cluster launch flag and set the launch bounds.
   void setKernelClusterLaunch(sycl::range<3> ClusterSize, int Dims);
 
@@ -3646,6 +3733,18 @@ private:
     }
   }
 
+  // The kernels of the code compiled with -fno-sycl-global-offset have no
+  // variant taking the offset.
+  template <int Dims>
+  void checkNoGlobalOffset([[maybe_unused]] sycl::id<Dims> Offset) {
+#ifdef __SYCL_DISABLE_GLOBAL_OFFSET__
+    if (Offset != sycl::id<Dims>{})
+      throw sycl::exception(make_error_code(errc::invalid),
+                            "Global offsets are disabled by "
+                            "-fno-sycl-global-offset");
+#endif
+  }
+
   template <int Dims>
   void setNDRangeDescriptor(sycl::range<Dims> N,
                             bool SetNumWorkGroups = false) {
@@ -3654,11 +3753,13 @@ private:
   template <int Dims>
   void setNDRangeDescriptor(sycl::range<Dims> NumWorkItems,
                             sycl::id<Dims> Offset) {
+    checkNoGlobalOffset(Offset);
     return setNDRangeDescriptorPadded(padRange(NumWorkItems), padId(Offset),
                                       Dims);
   }
   template <int Dims>
   void setNDRangeDescriptor(sycl::nd_range<Dims> ExecutionRange) {
+    checkNoGlobalOffset(ExecutionRange.get_offset());
     return setNDRangeDescriptorPadded(
         padRange(ExecutionRange.get_global_range()),
         padRange(ExecutionRange.get_local_range()),
@@ -12,6 +12,7 @@
 #include <sycl/detail/property_helper.hpp>     // for DataLessPropKind
 #include <sycl/properties/property_traits.hpp> // for is_property_of
 
+#include <chrono>      // for microseconds
 #include <type_traits> // for true_type
 
 namespace sycl {
@@ -46,6 +47,22 @@ private:
 };
 } // namespace ext::intel::property::queue
 
+namespace ext::oneapi::property::queue {
+// Duration for which the waits on the events of the queue poll them before
+// blocking, trading CPU time for the wake up latency of short commands.
+class wait_spin_duration
+    : public sycl::detail::PropertyWithData<
+          sycl::detail::PropWithDataKind::QueueWaitSpinDuration> {
+public:
+  wait_spin_duration(std::chrono::microseconds Duration)
+      : MDuration(Duration) {}
+  std::chrono::microseconds get_duration() const { return MDuration; }
+
+private:
+  std::chrono::microseconds MDuration;
+};
+} // namespace ext::oneapi::property::queue
+
 // Queue property trait specializations.
 class queue;
 
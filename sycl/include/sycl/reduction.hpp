@@ -2385,6 +2385,162 @@ void reduCGFuncMulti(handler &CGH, KernelType KernelFunc,
          createReduOutAccs<false>(NWorkGroups, CGH, ReduTuple, ReduIndices));
 }
 
+/// Combines the partial sums of all the work-groups for one reduction and
+/// writes the result to the user's variable.
+template <typename Reduction, int Dims, typename LocalAccT,
+          typename PartialAccT, typename OutAccT, typename T, typename BOPT>
+void reduFinalizeInLastWGHelper(nd_item<Dims> NDIt, size_t NWorkGroups,
+                                LocalAccT LocalReds, PartialAccT Partials,
+                                OutAccT Out, T IdentityContainer, BOPT BOp,
+                                bool IsInitializeToIdentity) {
+  using element_type = typename Reduction::reducer_element_type;
+  auto ElementCombiner = [&](element_type &LHS, const element_type &RHS) {
+    return LHS.combine(BOp, RHS);
+  };
+
+  size_t LID = NDIt.get_local_linear_id();
+  auto NElements = Reduction::num_elements;
+  for (size_t E = 0; E < NElements; ++E) {
+    doTreeReduction<WorkSizeGuarantees::None>(
+        NWorkGroups, NDIt, LocalReds, ElementCombiner,
+        [&](size_t I) { return Partials[I * NElements + E]; });
+
+    // Add the initial value of user's variable to the final result.
+    if (LID == 0)
+      Out[E] = *ElementCombiner(LocalReds[0],
+                                IsInitializeToIdentity
+                                    ? IdentityContainer.getIdentity()
+                                    : Out[E]);
+
+    // Ensure item 0 is finished with LocalReds before next iteration
+    if (E != NElements - 1) {
+      NDIt.barrier();
+    }
+  }
+}
+
+template <typename... Reductions, int Dims, typename... LocalAccT,
+          typename... PartialAccT, typename... OutAccT, typename... Ts,
+          typename... BOPsT, size_t... Is>
+void reduFinalizeInLastWG(
+    nd_item<Dims> NDIt, size_t NWorkGroups,
+    ReduTupleT<LocalAccT...> LocalAccsTuple,
+    ReduTupleT<PartialAccT...> PartialAccsTuple,
+    ReduTupleT<OutAccT...> OutAccsTuple, ReduTupleT<Ts...> IdentitiesTuple,
+    ReduTupleT<BOPsT...> BOPsTuple,
+    std::array<bool, sizeof...(Reductions)> InitToIdentityProps,
+    std::index_sequence<Is...>) {
+  using ReductionPack = std::tuple<Reductions...>;
+  (reduFinalizeInLastWGHelper<std::tuple_element_t<Is, ReductionPack>>(
+       NDIt, NWorkGroups, std::get<Is>(LocalAccsTuple),
+       std::get<Is>(PartialAccsTuple), std::get<Is>(OutAccsTuple),
+       std::get<Is>(IdentitiesTuple), std::get<Is>(BOPsTuple),
+       InitToIdentityProps[Is]),
+   ...);
+}
+
+// Tag struct for the multi-reduction kernel finalizing the reductions in the
+// work-group finishing last.
+struct KernelLastWGFinalizeTag {};
+
+/// Checks if the device supports the device-scope acq_rel atomics used to
+/// detect the work-group finishing last.
+inline bool reduCanDetectLastWG(const device &Dev) {
+  auto Orders = Dev.get_info<info::device::atomic_memory_order_capabilities>();
+  auto Scopes = Dev.get_info<info::device::atomic_memory_scope_capabilities>();
+  return std::find(Orders.begin(), Orders.end(), memory_order::acq_rel) !=
+             Orders.end() &&
+         std::find(Scopes.begin(), Scopes.end(), memory_scope::device) !=
+             Scopes.end();
+}
+
+/// Multi-reduction in a single kernel: the work-groups write their partial
+/// sums and the work-group finishing last, detected with a counter, combines
+/// them and writes the results. Requires all the reductions to have an
+/// identity and more than one work-group.
+template <typename KernelName, typename KernelType, int Dims,
+          typename PropertiesT, typename... Reductions, size_t... Is>
+void reduCGFuncMultiLastWG(handler &CGH, KernelType KernelFunc,
+                           const nd_range<Dims> &Range, PropertiesT Properties,
+                           std::tuple<Reductions...> &ReduTuple,
+                           std::index_sequence<Is...> ReduIndices) {
+  size_t WGSize = Range.get_local_range().size();
+  size_t NWorkGroups = Range.get_group_range().size();
+
+  IsScalarReduction ScalarPredicate;
+  auto ScalarIs = filterSequence<Reductions...>(ScalarPredicate, ReduIndices);
+
+  IsArrayReduction ArrayPredicate;
+  auto ArrayIs = filterSequence<Reductions...>(ArrayPredicate, ReduIndices);
+
+  auto LocalAccsTuple = makeReduTupleT(
+      local_accessor<typename Reductions::reducer_element_type, 1>{WGSize,
+                                                                   CGH}...);
+  auto PartialAccsTuple =
+      createReduOutAccs<false>(NWorkGroups, CGH, ReduTuple, ReduIndices);
+  auto OutAccsTuple =
+      makeReduTupleT(std::get<Is>(ReduTuple).getUserRedVarAccess(CGH)...);
+  auto IdentitiesTuple =
+      makeReduTupleT(std::get<Is>(ReduTuple).getIdentityContainer()...);
+  auto BOPsTuple =
+      makeReduTupleT(std::get<Is>(ReduTuple).getBinaryOperation()...);
+  std::array InitToIdentityProps{
+      std::get<Is>(ReduTuple).initializeToIdentity()...};
+
+  auto NWorkGroupsFinished =
+      std::get<0>(ReduTuple).getReadWriteAccessorToInitializedGroupsCounter(
+          CGH);
+  local_accessor<int, 1> DoFinalizeInThisWG{1, CGH};
+
+  using Name = __sycl_reduction_kernel<reduction::MainKrn, KernelName,
+                                       reduction::strategy::multi,
+                                       KernelLastWGFinalizeTag>;
+
+  CGH.parallel_for<Name>(Range, Properties, [=](nd_item<Dims> NDIt) {
+    // Pass all reductions to user's lambda in the same order as supplied
+    // Each reducer initializes its own storage
+    auto ReducerTokensTuple =
+        std::tuple{typename Reductions::reducer_token_type{
+            std::get<Is>(IdentitiesTuple), std::get<Is>(BOPsTuple)}...};
+    auto ReducersTuple = std::tuple<typename Reductions::reducer_type...>{
+        std::get<Is>(ReducerTokensTuple)...};
+    std::apply([&](auto &...Reducers) { KernelFunc(NDIt, Reducers...); },
+               ReducersTuple);
+
+    // Write the partial sums of the work-group.
+    reduCGFuncImplScalar<false, Reductions...>(
+        NDIt, LocalAccsTuple, PartialAccsTuple, ReducersTuple, IdentitiesTuple,
+        BOPsTuple, InitToIdentityProps, ScalarIs);
+    reduCGFuncImplArray<false, Reductions...>(
+        NDIt, LocalAccsTuple, PartialAccsTuple, ReducersTuple, BOPsTuple,
+        InitToIdentityProps, ArrayIs);
+
+    // Signal this work-group has finished. The partial sums were written by
+    // the (LID == 0) work-item, which also increments the counter.
+    size_t LID = NDIt.get_local_linear_id();
+    if (LID == 0) {
+      auto NFinished =
+          sycl::atomic_ref<int, memory_order::acq_rel, memory_scope::device,
+                           access::address_space::global_space>(
+              NWorkGroupsFinished[0]);
+      DoFinalizeInThisWG[0] = ++NFinished == static_cast<int>(NWorkGroups);
+    }
+
+    workGroupBarrier();
+    if (DoFinalizeInThisWG[0])
+      reduFinalizeInLastWG<Reductions...>(
+          NDIt, NWorkGroups, LocalAccsTuple, PartialAccsTuple, OutAccsTuple,
+          IdentitiesTuple, BOPsTuple, InitToIdentityProps,
+          std::index_sequence_for<Reductions...>());
+  });
+}
+
+template <typename... Reductions> struct AreAllReductionsWithIdentity;
+template <typename... Reductions>
+struct AreAllReductionsWithIdentity<std::tuple<Reductions...>> {
+  static constexpr bool value = (Reductions::has_identity && ...);
+};
+
 // TODO: Is this still needed?
 template <typename... Reductions, size_t... Is>
 void associateReduAccsWithHandler(handler &CGH,
@@ -2624,11 +2780,22 @@ template <> struct NDRangeReduction<reduction::strategy::multi> {
                             " than " +
                                 std::to_string(MaxWGSize));
 
+    // Finalize in the main kernel when possible, saving the launches of the
+    // auxiliary kernels.
+    size_t NWorkItems = NDRange.get_group_range().size();
+    if constexpr (AreAllReductionsWithIdentity<decltype(ReduTuple)>::value) {
+      if (NWorkItems > 1 && reduCanDetectLastWG(getDeviceFromHandler(CGH))) {
+        reduCGFuncMultiLastWG<KernelName>(CGH, KernelFunc, NDRange, Properties,
+                                          ReduTuple, ReduIndices);
+        reduction::finalizeHandler(CGH);
+        return;
+      }
+    }
+
     reduCGFuncMulti<KernelName>(CGH, KernelFunc, NDRange, Properties, ReduTuple,
                                 ReduIndices);
     reduction::finalizeHandler(CGH);
 
-    size_t NWorkItems = NDRange.get_group_range().size();
     while (NWorkItems > 1) {
       reduction::withAuxHandler(CGH, [&](handler &AuxHandler) {
         NWorkItems = reduAuxCGFunc<KernelName, decltype(KernelFunc)>(
@@ -2713,6 +2880,14 @@ void reduction_parallel_for(handler &CGH, nd_range<Dims> NDRange,
 __SYCL_EXPORT uint32_t
 reduGetMaxNumConcurrentWorkGroups(std::shared_ptr<queue_impl> Queue);
 
+/// Gets the work-group size and the maximal number of work-groups of range
+/// reductions using LocalMemBytesPerWorkItem bytes of local memory per
+/// work-item on the device of Queue.
+__SYCL_EXPORT void
+reduGetRangeLaunchParams(std::shared_ptr<queue_impl> &Queue,
+                         size_t LocalMemBytesPerWorkItem, size_t &WGSize,
+                         size_t &NumWorkGroups);
+
 template <typename KernelName, reduction::strategy Strategy, int Dims,
           typename PropertiesT, typename... RestT>
 void reduction_parallel_for(handler &CGH, range<Dims> Range,
@@ -2738,24 +2913,24 @@ void reduction_parallel_for(handler &CGH, range<Dims> Range,
     }
   }();
 
-  uint32_t NumConcurrentWorkGroups =
-#ifdef __SYCL_REDUCTION_NUM_CONCURRENT_WORKGROUPS
-      __SYCL_REDUCTION_NUM_CONCURRENT_WORKGROUPS;
-#else
-      reduGetMaxNumConcurrentWorkGroups(CGH.MQueue);
-#endif
-
+  // The work-group size and the number of partial results are derived from
+  // device queries once per device and local memory size.
   // TODO: currently the preferred work group size is determined for the given
   // queue/device, while it is safer to use queries to the kernel pre-compiled
   // for the device.
-  size_t PrefWGSize = reduGetPreferredWGSize(CGH.MQueue, OneElemSize);
+  size_t PrefWGSize = 0;
+  size_t MaxNWorkGroups = 0;
+  reduGetRangeLaunchParams(CGH.MQueue, OneElemSize, PrefWGSize,
+                           MaxNWorkGroups);
+#ifdef __SYCL_REDUCTION_NUM_CONCURRENT_WORKGROUPS
+  MaxNWorkGroups = __SYCL_REDUCTION_NUM_CONCURRENT_WORKGROUPS;
+#endif
 
   size_t NWorkItems = Range.size();
   size_t WGSize = std::min(NWorkItems, PrefWGSize);
   size_t NWorkGroups = NWorkItems / WGSize;
   if (NWorkItems % WGSize)
     NWorkGroups++;
-  size_t MaxNWorkGroups = NumConcurrentWorkGroups;
   NWorkGroups = std::min(NWorkGroups, MaxNWorkGroups);
   size_t NDRItems = NWorkGroups * WGSize;
   nd_range<1> NDRange{range<1>{NDRItems}, range<1>{WGSize}};
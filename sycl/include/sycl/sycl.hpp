@@ -27,6 +27,7 @@
 #include <sycl/device_selector.hpp>
 #include <sycl/event.hpp>
 #include <sycl/exception.hpp>
+#include <sycl/ext/oneapi/experimental/async_alloc.hpp>
 #include <sycl/ext/oneapi/experimental/group_sort.hpp>
 #include <sycl/functional.hpp>
 #include <sycl/group.hpp>
@@ -59,60 +60,6 @@
 #include <sycl/usm/usm_allocator.hpp>
 #include <sycl/usm/usm_pointer_info.hpp>
 #include <sycl/version.hpp>
-#if SYCL_EXT_ONEAPI_BACKEND_LEVEL_ZERO
-#include <sycl/ext/oneapi/backend/level_zero.hpp>
-#endif
-#include <sycl/ext/codeplay/experimental/fusion_wrapper.hpp>
-#include <sycl/ext/intel/experimental/fp_control_kernel_properties.hpp>
-#include <sycl/ext/intel/experimental/fpga_mem/fpga_datapath.hpp>
-#include <sycl/ext/intel/experimental/fpga_mem/fpga_mem.hpp>
-#include <sycl/ext/intel/experimental/fpga_mem/properties.hpp>
-#include <sycl/ext/intel/experimental/pipe_properties.hpp>
-#include <sycl/ext/intel/experimental/pipes.hpp>
-#include <sycl/ext/intel/experimental/task_sequence.hpp>
-#include <sycl/ext/intel/experimental/task_sequence_properties.hpp>
-#include <sycl/ext/intel/experimental/usm_properties.hpp>
-#include <sycl/ext/intel/usm_pointers.hpp>
-#include <sycl/ext/oneapi/bindless_images.hpp>
-#include <sycl/ext/oneapi/device_global/device_global.hpp>
-#include <sycl/ext/oneapi/device_global/properties.hpp>
-#include <sycl/ext/oneapi/experimental/address_cast.hpp>
-#include <sycl/ext/oneapi/experimental/annotated_arg/annotated_arg.hpp>
-#include <sycl/ext/oneapi/experimental/annotated_ptr/annotated_ptr.hpp>
-#include <sycl/ext/oneapi/experimental/annotated_usm/alloc_device.hpp>
-#include <sycl/ext/oneapi/experimental/annotated_usm/alloc_host.hpp>
-#include <sycl/ext/oneapi/experimental/annotated_usm/alloc_shared.hpp>
-#include <sycl/ext/oneapi/experimental/annotated_usm/dealloc.hpp>
-#include <sycl/ext/oneapi/experimental/auto_local_range.hpp>
-#include <sycl/ext/oneapi/experimental/ballot_group.hpp>
-#include <sycl/ext/oneapi/experimental/bfloat16_math.hpp>
-#include <sycl/ext/oneapi/experimental/builtins.hpp>
-#include <sycl/ext/oneapi/experimental/cluster_group_prop.hpp>
-#include <sycl/ext/oneapi/experimental/composite_device.hpp>
-#include <sycl/ext/oneapi/experimental/cuda/barrier.hpp>
-#include <sycl/ext/oneapi/experimental/enqueue_functions.hpp>
-#include <sycl/ext/oneapi/experimental/fixed_size_group.hpp>
-#include <sycl/ext/oneapi/experimental/forward_progress.hpp>
-#include <sycl/ext/oneapi/experimental/group_load_store.hpp>
-#include <sycl/ext/oneapi/experimental/opportunistic_group.hpp>
-#include <sycl/ext/oneapi/experimental/prefetch.hpp>
-#include <sycl/ext/oneapi/experimental/profiling_tag.hpp>
-#include <sycl/ext/oneapi/experimental/raw_kernel_arg.hpp>
-#include <sycl/ext/oneapi/experimental/root_group.hpp>
-#include <sycl/ext/oneapi/experimental/tangle_group.hpp>
-#include <sycl/ext/oneapi/filter_selector.hpp>
-#include <sycl/ext/oneapi/free_function_queries.hpp>
-#include <sycl/ext/oneapi/functional.hpp>
-#include <sycl/ext/oneapi/get_kernel_info.hpp>
-#include <sycl/ext/oneapi/group_local_memory.hpp>
-#include <sycl/ext/oneapi/kernel_properties/properties.hpp>
-#include <sycl/ext/oneapi/matrix/matrix.hpp>
-#include <sycl/ext/oneapi/memcpy2d.hpp>
-#include <sycl/ext/oneapi/owner_less.hpp>
-#include <sycl/ext/oneapi/properties/properties.hpp>
-#include <sycl/ext/oneapi/properties/property_value.hpp>
-#include <sycl/ext/oneapi/sub_group.hpp>
-#include <sycl/ext/oneapi/sub_group_mask.hpp>
-#include <sycl/ext/oneapi/virtual_mem/physical_mem.hpp>
-#include <sycl/ext/oneapi/virtual_mem/virtual_mem.hpp>
-#include <sycl/ext/oneapi/weak_object.hpp>
+#include <sycl/ext/codeplay.hpp>
+#include <sycl/ext/intel.hpp>
+#include <sycl/ext/oneapi.hpp>
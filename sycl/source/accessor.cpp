@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/accessor_impl_pool.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/sycl_mem_obj_t.hpp>
 #include <sycl/accessor.hpp>
@@ -56,10 +57,10 @@ AccessorBaseHost::AccessorBaseHost(id<3> Offset, range<3> AccessRange,
                                    bool IsSubBuffer,
                                    const property_list &PropertyList) {
   verifyAccessorProps(PropertyList);
-  impl = std::shared_ptr<AccessorImplHost>(
-      new AccessorImplHost(Offset, AccessRange, MemoryRange, AccessMode,
-                           (detail::SYCLMemObjI *)SYCLMemObject, Dims, ElemSize,
-                           false, OffsetInBytes, IsSubBuffer, PropertyList));
+  impl = std::allocate_shared<AccessorImplHost>(
+      AccessorImplPoolAllocator<AccessorImplHost>{}, Offset, AccessRange,
+      MemoryRange, AccessMode, (detail::SYCLMemObjI *)SYCLMemObject, Dims,
+      ElemSize, false, OffsetInBytes, IsSubBuffer, PropertyList);
 }
 
 AccessorBaseHost::AccessorBaseHost(id<3> Offset, range<3> AccessRange,
@@ -69,10 +70,10 @@ AccessorBaseHost::AccessorBaseHost(id<3> Offset, range<3> AccessRange,
                                    size_t OffsetInBytes, bool IsSubBuffer,
                                    const property_list &PropertyList) {
   verifyAccessorProps(PropertyList);
-  impl = std::shared_ptr<AccessorImplHost>(
-      new AccessorImplHost(Offset, AccessRange, MemoryRange, AccessMode,
-                           (detail::SYCLMemObjI *)SYCLMemObject, Dims, ElemSize,
-                           IsPlaceH, OffsetInBytes, IsSubBuffer, PropertyList));
+  impl = std::allocate_shared<AccessorImplHost>(
+      AccessorImplPoolAllocator<AccessorImplHost>{}, Offset, AccessRange,
+      MemoryRange, AccessMode, (detail::SYCLMemObjI *)SYCLMemObject, Dims,
+      ElemSize, IsPlaceH, OffsetInBytes, IsSubBuffer, PropertyList);
 }
 
 id<3> &AccessorBaseHost::getOffset() { return impl->MOffset; }
@@ -0,0 +1,114 @@
+//==------------ accessor_impl_pool.hpp - SYCL accessor pool ---------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// Per-thread free list of memory blocks used for the AccessorImplHost
+/// objects together with their shared_ptr control blocks. The accessors of a
+/// command group are typically created and released by the same submitting
+/// thread, so they don't go through malloc/free for each submission.
+class AccessorImplPool {
+public:
+  static void *allocate(size_t Size) {
+    if (!isDestroyed()) {
+      FreeList &List = getFreeList();
+      if (Size == List.BlockSize && !List.Blocks.empty()) {
+        void *Block = List.Blocks.back();
+        List.Blocks.pop_back();
+        return Block;
+      }
+    }
+    return ::operator new(Size);
+  }
+
+  static void deallocate(void *Block, size_t Size) noexcept {
+    // The blocks released after the free list of the thread is destroyed,
+    // e.g. by the destructors of other thread-local objects, are freed.
+    if (!isDestroyed()) {
+      FreeList &List = getFreeList();
+      // All the blocks are expected to be of the same size, so only the
+      // first size seen is pooled.
+      if (!List.BlockSize)
+        List.BlockSize = Size;
+      if (Size == List.BlockSize && List.Blocks.size() < MaxFreeBlocks) {
+        List.Blocks.push_back(Block);
+        return;
+      }
+    }
+    ::operator delete(Block);
+  }
+
+private:
+  // Limits the memory kept by each thread after a burst of submissions.
+  static constexpr size_t MaxFreeBlocks = 256;
+
+  struct FreeList {
+    // Reserved so that pooling a block never allocates.
+    FreeList() { Blocks.reserve(MaxFreeBlocks); }
+    ~FreeList() {
+      for (void *Block : Blocks)
+        ::operator delete(Block);
+      isDestroyed() = true;
+    }
+
+    std::vector<void *> Blocks;
+    size_t BlockSize = 0;
+  };
+
+  static FreeList &getFreeList() {
+    static thread_local FreeList List;
+    return List;
+  }
+
+  // Trivially destructible, so it may be read after the free list of the
+  // thread is destroyed.
+  static bool &isDestroyed() {
+    static thread_local bool Destroyed = false;
+    return Destroyed;
+  }
+};
+
+/// Allocator for std::allocate_shared taking the storage from
+/// AccessorImplPool.
+template <typename T> class AccessorImplPoolAllocator {
+public:
+  using value_type = T;
+
+  AccessorImplPoolAllocator() = default;
+  template <typename U>
+  AccessorImplPoolAllocator(const AccessorImplPoolAllocator<U> &) {}
+
+  T *allocate(size_t N) {
+    return static_cast<T *>(AccessorImplPool::allocate(N * sizeof(T)));
+  }
+
+  void deallocate(T *Ptr, size_t N) {
+    AccessorImplPool::deallocate(Ptr, N * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const AccessorImplPoolAllocator<U> &) const {
+    return true;
+  }
+  template <typename U>
+  bool operator!=(const AccessorImplPoolAllocator<U> &) const {
+    return false;
+  }
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
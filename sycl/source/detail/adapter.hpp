@@ -152,6 +152,9 @@ public:
   /// multiple backends as determined by the platforms reported by the adapter.
   bool hasBackend(backend Backend) const { return Backend == MBackend; }
 
+  /// Returns the backend this adapter serves.
+  backend getBackend() const { return MBackend; }
+
   void release() {
     call<UrApiKind::urAdapterRelease>(MAdapter);
     this->adapterReleased = true;
@@ -10,6 +10,7 @@
 #include <detail/context_impl.hpp>
 #include <detail/global_handler.hpp>
 #include <detail/memory_manager.hpp>
+#include <detail/memory_telemetry.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/xpti_registry.hpp>
 #include <sycl/detail/ur.hpp>
@@ -40,10 +41,14 @@ void buffer_impl::constructorNotification(const detail::code_location &CodeLoc,
                                           uint32_t ElemSize, size_t Range[3]) {
   XPTIRegistry::bufferConstructorNotification(UserObj, CodeLoc, HostObj, Type,
                                               Dim, ElemSize, Range);
+  if (MemoryTelemetry::isEnabled())
+    MemoryTelemetry::instance().registerBuffer(this, CodeLoc);
 }
 
 void buffer_impl::destructorNotification(void *UserObj) {
   XPTIRegistry::bufferDestructorNotification(UserObj);
+  if (MemoryTelemetry::isEnabled())
+    MemoryTelemetry::instance().unregisterBuffer(this);
 }
 
 void buffer_impl::addInteropObject(
@@ -51,6 +51,10 @@ public:
       throw sycl::exception(
           make_error_code(errc::invalid),
           "The use_host_ptr property requires host pointer to be provided");
+    if (Props.has_property<sycl::ext::oneapi::property::buffer::zero_copy>())
+      throw sycl::exception(
+          make_error_code(errc::invalid),
+          "The zero_copy property requires host pointer to be provided");
   }
 
   buffer_impl(void *HostData, size_t SizeInBytes, size_t RequiredAlign,
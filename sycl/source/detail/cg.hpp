@@ -260,6 +260,7 @@ public:
   ur_kernel_cache_config_t MKernelCacheConfig;
   bool MKernelIsCooperative = false;
   bool MKernelUsesClusterLaunch = false;
+  bool MKernelSpecializesNDRange = false;
 
   CGExecKernel(NDRDescT NDRDesc, std::shared_ptr<HostKernelBase> HKernel,
                std::shared_ptr<detail::kernel_impl> SyclKernel,
@@ -270,7 +271,7 @@ public:
                std::vector<std::shared_ptr<const void>> AuxiliaryResources,
                CGType Type, ur_kernel_cache_config_t KernelCacheConfig,
                bool KernelIsCooperative, bool MKernelUsesClusterLaunch,
-               detail::code_location loc = {})
+               bool KernelSpecializesNDRange, detail::code_location loc = {})
       : CG(Type, std::move(CGData), std::move(loc)),
         MNDRDesc(std::move(NDRDesc)), MHostKernel(std::move(HKernel)),
         MSyclKernel(std::move(SyclKernel)),
@@ -279,7 +280,8 @@ public:
         MAuxiliaryResources(std::move(AuxiliaryResources)),
         MKernelCacheConfig(std::move(KernelCacheConfig)),
         MKernelIsCooperative(KernelIsCooperative),
-        MKernelUsesClusterLaunch(MKernelUsesClusterLaunch) {
+        MKernelUsesClusterLaunch(MKernelUsesClusterLaunch),
+        MKernelSpecializesNDRange(KernelSpecializesNDRange) {
     assert(getType() == CGType::Kernel && "Wrong type of exec kernel CG.");
   }
 
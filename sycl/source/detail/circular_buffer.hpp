@@ -61,6 +61,12 @@ public:
 
   bool full() const { return MValues.size() == MCapacity; };
 
+  // Only growing is supported, so no data is lost.
+  void grow(std::size_t Capacity) {
+    if (Capacity > MCapacity)
+      MCapacity = Capacity;
+  }
+
   void push_back(T Val) {
     if (MValues.size() == MCapacity)
       MValues.pop_front();
@@ -91,7 +97,7 @@ private:
   // and deallocations are a concern, switching to an array/vector might be a
   // worthwhile optimization.
   std::deque<T> MValues;
-  const std::size_t MCapacity;
+  std::size_t MCapacity;
 };
 
 } // namespace detail
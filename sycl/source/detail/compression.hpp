@@ -0,0 +1,57 @@
+//==---------- compression.hpp --- Device image compression helpers -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+
+#include <sycl/exception.hpp>
+
+#include <memory>
+#include <string>
+
+#include <zstd.h>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+// Decompresses device images compressed with zstd by the offload wrapper.
+class ZSTDCompressor {
+public:
+  // Returns the size of the decompressed data stored in the zstd frame
+  // header of Src.
+  static size_t getDecompressedSize(const char *Src, size_t SrcSize) {
+    unsigned long long DstSize = ZSTD_getFrameContentSize(Src, SrcSize);
+    if (DstSize == ZSTD_CONTENTSIZE_ERROR ||
+        DstSize == ZSTD_CONTENTSIZE_UNKNOWN)
+      throw sycl::exception(make_error_code(errc::runtime),
+                            "Failed to determine the size of a compressed "
+                            "device image");
+    return static_cast<size_t>(DstSize);
+  }
+
+  static std::unique_ptr<char[]> decompressBlob(const char *Src,
+                                                size_t SrcSize,
+                                                size_t &DstSize) {
+    DstSize = getDecompressedSize(Src, SrcSize);
+    std::unique_ptr<char[]> Dst(new char[DstSize]);
+    size_t Res = ZSTD_decompress(Dst.get(), DstSize, Src, SrcSize);
+    if (ZSTD_isError(Res))
+      throw sycl::exception(make_error_code(errc::runtime),
+                            std::string{"Failed to decompress device image: "} +
+                                ZSTD_getErrorName(Res));
+    DstSize = Res;
+    return Dst;
+  }
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
+
+#endif // SYCL_RT_ZSTD_AVAILABLE
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <array>
 #include <cstdlib>
+#include <cstring>
 #include <mutex>
 #include <string>
 #include <utility>
@@ -586,6 +587,251 @@ private:
   }
 };
 
+// When enabled, kernels are launched as they are while the JIT compiler
+// materializes their specialization constants on a worker thread. The
+// materialized kernels are used by the submissions made once they are ready.
+template <> class SYCLConfig<SYCL_JIT_BACKGROUND_COMPILATION> {
+  using BaseT = SYCLConfigBase<SYCL_JIT_BACKGROUND_COMPILATION>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = false;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// When enabled, the JIT compiler declines to fuse kernels if it estimates
+// that the fused kernel would have a lower occupancy than the input kernels,
+// or would exceed the register file when none of them does.
+template <> class SYCLConfig<SYCL_JIT_FUSION_COST_MODEL> {
+  using BaseT = SYCLConfigBase<SYCL_JIT_FUSION_COST_MODEL>;
+
+public:
+  static bool get() {
+    constexpr bool DefaultValue = true;
+
+    const char *ValStr = getCachedValue();
+
+    if (!ValStr)
+      return DefaultValue;
+
+    return ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+template <> class SYCLConfig<SYCL_SUBMISSION_STATS> {
+  using BaseT = SYCLConfigBase<SYCL_SUBMISSION_STATS>;
+
+public:
+  static bool get() {
+    const char *ValStr = getCachedValue();
+    return ValStr && ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+template <> class SYCLConfig<SYCL_MEMORY_TELEMETRY> {
+  using BaseT = SYCLConfigBase<SYCL_MEMORY_TELEMETRY>;
+
+public:
+  static bool get() {
+    const char *ValStr = getCachedValue();
+    return ValStr && ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+template <> class SYCLConfig<SYCL_WORK_GROUP_COUNTERS> {
+  using BaseT = SYCLConfigBase<SYCL_WORK_GROUP_COUNTERS>;
+
+public:
+  static bool get() {
+    const char *ValStr = getCachedValue();
+    return ValStr && ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// Path of the file the names of the kernels launched by the application are
+// added to when it exits, for sycl-post-link -kernel-profile.
+template <> class SYCLConfig<SYCL_KERNEL_PROFILE> {
+  using BaseT = SYCLConfigBase<SYCL_KERNEL_PROFILE>;
+
+public:
+  static std::string get() {
+    const char *ValStr = getCachedValue();
+    return ValStr ? std::string{ValStr} : std::string{};
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// Batch size and delay in microseconds of the deferred flushes of the queues
+// other queues depend on, see DeferredFlush.
+template <> class SYCLConfig<SYCL_DEFERRED_FLUSH> {
+  using BaseT = SYCLConfigBase<SYCL_DEFERRED_FLUSH>;
+
+public:
+  static std::string get() {
+    const char *ValStr = getCachedValue();
+    return ValStr ? std::string{ValStr} : std::string{};
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+// Path of the file the counters of the device code built with
+// -fprofile-instr-generate are written to, in the text format of
+// llvm-profdata.
+template <> class SYCLConfig<SYCL_DEVICE_PROFILE_FILE> {
+  using BaseT = SYCLConfigBase<SYCL_DEVICE_PROFILE_FILE>;
+
+public:
+  static std::string get() {
+    const char *ValStr = getCachedValue();
+    return ValStr ? std::string{ValStr} : std::string{};
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+template <> class SYCLConfig<SYCL_EAGER_BUILD_HOT_KERNELS> {
+  using BaseT = SYCLConfigBase<SYCL_EAGER_BUILD_HOT_KERNELS>;
+
+public:
+  static bool get() {
+    const char *ValStr = getCachedValue();
+    return ValStr && ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+template <> class SYCLConfig<SYCL_REPORT_KERNEL_RESOURCES> {
+  using BaseT = SYCLConfigBase<SYCL_REPORT_KERNEL_RESOURCES>;
+
+public:
+  static bool get() {
+    const char *ValStr = getCachedValue();
+    return ValStr && ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
 template <> class SYCLConfig<SYCL_CACHE_IN_MEM> {
   using BaseT = SYCLConfigBase<SYCL_CACHE_IN_MEM>;
 
@@ -618,6 +864,174 @@ private:
   }
 };
 
+// Maximum total size in bytes of the programs kept in the in-memory program
+// cache of a context. Least recently used programs are evicted once the
+// threshold is exceeded. Zero (the default) disables eviction.
+template <> class SYCLConfig<SYCL_IN_MEM_CACHE_EVICTION_THRESHOLD> {
+  using BaseT = SYCLConfigBase<SYCL_IN_MEM_CACHE_EVICTION_THRESHOLD>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static size_t parseValue() {
+    const char *ValStr = BaseT::getRawValue();
+    if (!ValStr)
+      return 0;
+
+    long long Result = 0;
+    try {
+      Result = std::stoll(ValStr);
+    } catch (...) {
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should be a number");
+    }
+
+    if (Result < 0)
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should not be "
+                          "negative");
+
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+// Initial number of generic leaves kept per access kind of a memory object in
+// the scheduler graph. The limit grows up to 4 times when leaves can't be
+// compacted.
+template <> class SYCLConfig<SYCL_MAX_LEAVES> {
+  using BaseT = SYCLConfigBase<SYCL_MAX_LEAVES>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static constexpr size_t DefaultValue = 8;
+
+  static size_t parseValue() {
+    const char *ValStr = BaseT::getRawValue();
+    if (!ValStr)
+      return DefaultValue;
+
+    long long Result = 0;
+    try {
+      Result = std::stoll(ValStr);
+    } catch (...) {
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should be a number");
+    }
+
+    if (Result <= 0)
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should be positive");
+
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+// Size in bytes of the pinned host buffers used to stage large buffer writes
+// to discrete devices. Writes of at least two chunks are split into chunks
+// copied through the staging buffers, zero disables staging.
+template <> class SYCLConfig<SYCL_STAGING_CHUNK_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_STAGING_CHUNK_SIZE>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static constexpr size_t DefaultValue = 4 * 1024 * 1024;
+
+  static size_t parseValue() {
+    const char *ValStr = BaseT::getRawValue();
+    if (!ValStr)
+      return DefaultValue;
+
+    long long Result = 0;
+    try {
+      Result = std::stoll(ValStr);
+    } catch (...) {
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should be a number");
+    }
+
+    if (Result < 0)
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should not be "
+                          "negative");
+
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+enum class StreamFlushMode { Sync, Async, AsyncLossy };
+
+// How the output of sycl::stream is printed once a kernel is done:
+// 0 - synchronously by the host task flushing the stream (default);
+// 1 - by a background thread, the flush waits when too much output is pending;
+// 2 - by a background thread, output exceeding the pending limit is dropped.
+template <> class SYCLConfig<SYCL_ASYNC_STREAM_FLUSH> {
+  using BaseT = SYCLConfigBase<SYCL_ASYNC_STREAM_FLUSH>;
+
+public:
+  static StreamFlushMode get() { return getCachedValue(); }
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static StreamFlushMode parseValue() {
+    const char *ValStr = BaseT::getRawValue();
+    if (!ValStr || std::strcmp(ValStr, "0") == 0)
+      return StreamFlushMode::Sync;
+    if (std::strcmp(ValStr, "1") == 0)
+      return StreamFlushMode::Async;
+    if (std::strcmp(ValStr, "2") == 0)
+      return StreamFlushMode::AsyncLossy;
+    throw exception(make_error_code(errc::invalid),
+                    std::string{"Invalid value for "} + getName() +
+                        " environment variable: value should be 0, 1 or 2");
+  }
+
+  static StreamFlushMode getCachedValue(bool ResetCache = false) {
+    static StreamFlushMode Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
 template <> class SYCLConfig<SYCL_JIT_AMDGCN_PTX_KERNELS> {
   using BaseT = SYCLConfigBase<SYCL_JIT_AMDGCN_PTX_KERNELS>;
 
@@ -698,6 +1112,137 @@ private:
   }
 };
 
+// Number of commands whose post-enqueue cleanup is deferred before they are
+// cleaned up together under a single graph write lock, 1 cleans them up as
+// soon as they are enqueued.
+template <> class SYCLConfig<SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE> {
+  using BaseT = SYCLConfigBase<SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static constexpr size_t DefaultValue = 16;
+
+  static size_t parseValue() {
+    const char *ValStr = BaseT::getRawValue();
+    if (!ValStr)
+      return DefaultValue;
+
+    long long Result = 0;
+    try {
+      Result = std::stoll(ValStr);
+    } catch (...) {
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should be a number");
+    }
+
+    if (Result <= 0)
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should be positive");
+
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+template <> class SYCLConfig<SYCL_USM_CACHE_THRESHOLD> {
+  using BaseT = SYCLConfigBase<SYCL_USM_CACHE_THRESHOLD>;
+
+public:
+  static size_t get() { return getCachedValue(); }
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  // The cache is disabled by default.
+  static constexpr size_t DefaultValue = 0;
+
+  static size_t parseValue() {
+    const char *ValStr = BaseT::getRawValue();
+    if (!ValStr)
+      return DefaultValue;
+
+    long long Result = 0;
+    try {
+      Result = std::stoll(ValStr);
+    } catch (...) {
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should be a number");
+    }
+
+    if (Result < 0)
+      throw exception(make_error_code(errc::invalid),
+                      std::string{"Invalid value for "} + getName() +
+                          " environment variable: value should not be "
+                          "negative");
+
+    return static_cast<size_t>(Result);
+  }
+
+  static size_t getCachedValue(bool ResetCache = false) {
+    static size_t Val = parseValue();
+    if (ResetCache)
+      Val = parseValue();
+    return Val;
+  }
+};
+
+template <> class SYCLConfig<SYCL_USM_AUTO_PREFETCH> {
+  using BaseT = SYCLConfigBase<SYCL_USM_AUTO_PREFETCH>;
+
+public:
+  static bool get() {
+    const char *ValStr = getCachedValue();
+    return ValStr && ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
+template <> class SYCLConfig<SYCL_USM_HOST_NUMA_LOCAL> {
+  using BaseT = SYCLConfigBase<SYCL_USM_HOST_NUMA_LOCAL>;
+
+public:
+  static bool get() {
+    const char *ValStr = getCachedValue();
+    return ValStr && ValStr[0] == '1';
+  }
+
+  static void reset() { (void)getCachedValue(/*ResetCache=*/true); }
+
+  static const char *getName() { return BaseT::MConfigName; }
+
+private:
+  static const char *getCachedValue(bool ResetCache = false) {
+    static const char *ValStr = BaseT::getRawValue();
+    if (ResetCache)
+      ValStr = BaseT::getRawValue();
+    return ValStr;
+  }
+};
+
 #undef INVALID_CONFIG_EXCEPTION
 
 } // namespace detail
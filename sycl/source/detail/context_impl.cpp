@@ -8,7 +8,9 @@
 
 #include <detail/context_impl.hpp>
 #include <detail/context_info.hpp>
+#include <detail/device_profile.hpp>
 #include <detail/event_info.hpp>
+#include <detail/memory_pool_impl.hpp>
 #include <detail/platform_impl.hpp>
 #include <detail/queue_impl.hpp>
 #include <sycl/detail/common.hpp>
@@ -126,6 +128,13 @@ cl_context context_impl::get() const {
 
 context_impl::~context_impl() {
   try {
+    // The programs are released with the cache, after the destructor.
+    DeviceProfile::collect(*this);
+    // The pools release their memory through the context handle.
+    MDefaultMemoryPools.clear();
+    MStagingBufferPool.release();
+    MUSMCache.release();
+    MQueuePool.release();
     // Free all events associated with the initialization of device globals.
     for (auto &DeviceGlobalInitializer : MDeviceGlobalInitializers)
       DeviceGlobalInitializer.second.ClearEvents(getAdapter());
@@ -147,6 +156,35 @@ context_impl::~context_impl() {
   }
 }
 
+memory_pool_impl &
+context_impl::getDefaultMemoryPool(const std::shared_ptr<device_impl> &Device) {
+  std::lock_guard<std::mutex> Lock(MDefaultMemoryPoolsMutex);
+  std::unique_ptr<memory_pool_impl> &Pool = MDefaultMemoryPools[Device.get()];
+  if (!Pool)
+    Pool = std::make_unique<memory_pool_impl>(*this, Device);
+  return *Pool;
+}
+
+void context_impl::registerMemoryPool(memory_pool_impl *Pool) {
+  std::lock_guard<std::mutex> Lock(MMemoryPoolsMutex);
+  MMemoryPools.push_back(Pool);
+}
+
+void context_impl::unregisterMemoryPool(memory_pool_impl *Pool) {
+  std::lock_guard<std::mutex> Lock(MMemoryPoolsMutex);
+  MMemoryPools.erase(
+      std::remove(MMemoryPools.begin(), MMemoryPools.end(), Pool),
+      MMemoryPools.end());
+}
+
+memory_pool_impl *context_impl::findMemoryPool(void *Ptr) {
+  std::lock_guard<std::mutex> Lock(MMemoryPoolsMutex);
+  for (memory_pool_impl *Pool : MMemoryPools)
+    if (Pool->owns(Ptr))
+      return Pool;
+  return nullptr;
+}
+
 const async_handler &context_impl::get_async_handler() const {
   return MAsyncHandler;
 }
@@ -397,6 +435,11 @@ std::vector<ur_event_handle_t> context_impl::initializeDeviceGlobals(
     // list.
     InitEventsRef.reserve(DeviceGlobalEntries.size());
 
+    // The device globals without USM memory yet are allocated together, with
+    // a single copy of their initial values.
+    DeviceGlobalMapEntry::allocateDeviceGlobalsUSM(DeviceGlobalEntries,
+                                                   QueueImpl);
+
     // Device global map entry pointers will not die before the end of the
     // program and the pointers will stay the same, so we do not need
     // m_DeviceGlobalsMutex here.
@@ -409,9 +452,13 @@ std::vector<ur_event_handle_t> context_impl::initializeDeviceGlobals(
       // added to the initialization events list. Since initialization events
       // are cleaned up separately from cleaning up the device global USM memory
       // this must retain the event.
+      // The device globals allocated together share their event, which is
+      // only added once.
       {
         if (OwnedUrEvent ZIEvent = DeviceGlobalUSM.getInitEvent(Adapter))
-          InitEventsRef.push_back(ZIEvent.TransferOwnership());
+          if (std::find(InitEventsRef.begin(), InitEventsRef.end(),
+                        ZIEvent.GetEvent()) == InitEventsRef.end())
+            InitEventsRef.push_back(ZIEvent.TransferOwnership());
       }
       // Write the pointer to the device global and store the event in the
       // initialize events list.
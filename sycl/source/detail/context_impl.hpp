@@ -11,6 +11,10 @@
 #include <detail/kernel_program_cache.hpp>
 #include <detail/platform_impl.hpp>
 #include <detail/program_manager/program_manager.hpp>
+#include <detail/queue_pool.hpp>
+#include <detail/staging_buffer_pool.hpp>
+#include <detail/usm/usm_cache.hpp>
+#include <detail/usm/usm_prefetch.hpp>
 #include <sycl/detail/common.hpp>
 #include <sycl/detail/os_util.hpp>
 #include <sycl/detail/ur.hpp>
@@ -20,14 +24,18 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 namespace sycl {
 inline namespace _V1 {
 // Forward declaration
 class device;
 namespace detail {
+class memory_pool_impl;
 using PlatformImplPtr = std::shared_ptr<detail::platform_impl>;
 class context_impl {
 public:
@@ -149,6 +157,10 @@ public:
 
   KernelProgramCache &getKernelProgramCache() const;
 
+  /// Guards the single build of the hot kernel programs of the context
+  /// requested by SYCL_EAGER_BUILD_HOT_KERNELS.
+  std::once_flag &getHotProgramsBuildFlag() { return MHotProgramsBuildFlag; }
+
   /// Returns true if and only if context contains the given device.
   bool hasDevice(std::shared_ptr<detail::device_impl> Device) const;
 
@@ -244,6 +256,32 @@ public:
 
   const property_list &getPropList() const { return MPropList; }
 
+  /// Gets the memory pool used by async_malloc() for allocations on Device,
+  /// creating it on first use.
+  memory_pool_impl &
+  getDefaultMemoryPool(const std::shared_ptr<device_impl> &Device);
+
+  /// Registers a memory pool of this context, so that async_free() can find
+  /// the pool of an allocation.
+  void registerMemoryPool(memory_pool_impl *Pool);
+  void unregisterMemoryPool(memory_pool_impl *Pool);
+
+  /// @return The pool owning the allocation Ptr, nullptr if none does.
+  memory_pool_impl *findMemoryPool(void *Ptr);
+
+  /// Gets the pinned host buffers used to stage buffer transfers.
+  StagingBufferPool &getStagingBufferPool() { return MStagingBufferPool; }
+
+  /// Gets the native queues kept for reuse by the queues of the context.
+  QueuePool &getQueuePool() { return MQueuePool; }
+
+  /// Gets the cache of the small USM allocations of the context.
+  usm::USMCache &getUSMCache() const { return MUSMCache; }
+
+  /// Gets the tracker of the shared USM allocations prefetched for the
+  /// kernels of the context.
+  usm::USMPrefetcher &getUSMPrefetcher() const { return MUSMPrefetcher; }
+
 private:
   bool MOwnedByRuntime;
   async_handler MAsyncHandler;
@@ -254,6 +292,7 @@ private:
   CachedLibProgramsT MCachedLibPrograms;
   std::mutex MCachedLibProgramsMutex;
   mutable KernelProgramCache MKernelProgramCache;
+  std::once_flag MHotProgramsBuildFlag;
   mutable PropertySupport MSupportBufferLocationByDevices;
 
   std::set<const void *> MAssociatedDeviceGlobals;
@@ -307,6 +346,17 @@ private:
   std::mutex MDeviceGlobalUnregisteredDataMutex;
 
   void verifyProps(const property_list &Props) const;
+
+  std::unordered_map<const device_impl *, std::unique_ptr<memory_pool_impl>>
+      MDefaultMemoryPools;
+  std::mutex MDefaultMemoryPoolsMutex;
+  std::vector<memory_pool_impl *> MMemoryPools;
+  std::mutex MMemoryPoolsMutex;
+
+  StagingBufferPool MStagingBufferPool{*this};
+  QueuePool MQueuePool{*this};
+  mutable usm::USMCache MUSMCache{*this};
+  mutable usm::USMPrefetcher MUSMPrefetcher;
 };
 
 template <typename T, typename Capabilities>
@@ -0,0 +1,95 @@
+//==---- deferred_flush.cpp - Batching of the cross-queue queue flushes ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/deferred_flush.hpp>
+#include <detail/queue_impl.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+DeferredFlush &DeferredFlush::instance() {
+  // Never destroyed, the queues may be released by the destructors of other
+  // static objects.
+  static DeferredFlush *Instance = new DeferredFlush();
+  return *Instance;
+}
+
+DeferredFlush::DeferredFlush() {
+  const std::string Value = SYCLConfig<SYCL_DEFERRED_FLUSH>::get();
+  if (Value.empty())
+    return;
+  try {
+    size_t Comma = Value.find(',');
+    long long Batch = std::stoll(Value.substr(0, Comma));
+    long long Delay =
+        Comma == std::string::npos ? 0 : std::stoll(Value.substr(Comma + 1));
+    if (Batch <= 0 || Delay < 0)
+      throw std::invalid_argument(Value);
+    MBatchSize = static_cast<size_t>(Batch);
+    MMaxDelay = std::chrono::microseconds(Delay);
+  } catch (...) {
+    throw exception(make_error_code(errc::invalid),
+                    std::string{"Invalid value for "} +
+                        SYCLConfig<SYCL_DEFERRED_FLUSH>::getName() +
+                        " environment variable: value should be a positive "
+                        "batch size, optionally followed by a comma and a "
+                        "delay in microseconds");
+  }
+}
+
+void DeferredFlush::request(const std::shared_ptr<queue_impl> &Queue) {
+  const auto Now = std::chrono::steady_clock::now();
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    PendingFlush &Pending = MPending[Queue.get()];
+    // The entry may be left by a destroyed queue at the same address.
+    if (Pending.Requests == 0 || Pending.Queue.lock() != Queue) {
+      Pending = PendingFlush{Queue, 0, Now};
+      MNumPending.store(MPending.size(), std::memory_order_relaxed);
+    }
+    ++Pending.Requests;
+    const bool Expired = MMaxDelay.count() != 0 &&
+                         Now - Pending.First >= MMaxDelay;
+    if (Pending.Requests < MBatchSize && !Expired)
+      return;
+    MPending.erase(Queue.get());
+    MNumPending.store(MPending.size(), std::memory_order_relaxed);
+  }
+  flush(Queue);
+}
+
+void DeferredFlush::flushAll() {
+  if (MNumPending.load(std::memory_order_relaxed) == 0)
+    return;
+  std::vector<std::shared_ptr<queue_impl>> Queues;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    for (auto &[Key, Pending] : MPending)
+      if (std::shared_ptr<queue_impl> Queue = Pending.Queue.lock())
+        Queues.push_back(std::move(Queue));
+    MPending.clear();
+    MNumPending.store(0, std::memory_order_relaxed);
+  }
+  // A queue released since its request was flushed by urQueueRelease.
+  for (const std::shared_ptr<queue_impl> &Queue : Queues)
+    flush(Queue);
+}
+
+void DeferredFlush::flush(const std::shared_ptr<queue_impl> &Queue) {
+  Queue->getAdapter()->call<UrApiKind::urQueueFlush>(Queue->getHandleRef());
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
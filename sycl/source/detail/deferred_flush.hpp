@@ -0,0 +1,67 @@
+//==---- deferred_flush.hpp - Batching of the cross-queue queue flushes ----==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class queue_impl;
+
+/// Deferral of the flushes of the native queues whose commands are depended
+/// on by the commands of other queues. By default such a queue is flushed at
+/// once, which cuts short the batches of the backends recording the commands
+/// in command lists, e.g. Level Zero.
+///
+/// With SYCL_DEFERRED_FLUSH=<batch>[,<microseconds>], the flush requests of
+/// each queue are counted instead, and the queue is flushed once <batch>
+/// requests are pending or the oldest of them is <microseconds> old. All the
+/// pending requests are honored before the host waits for or polls an event,
+/// or waits for a queue, so that the commands depending on them can complete.
+class DeferredFlush {
+public:
+  static DeferredFlush &instance();
+
+  static bool isEnabled() { return instance().MBatchSize != 0; }
+
+  /// Records a flush request for Queue, flushing it if a threshold is reached.
+  void request(const std::shared_ptr<queue_impl> &Queue);
+
+  /// Flushes the queues with pending requests.
+  void flushAll();
+
+private:
+  DeferredFlush();
+
+  struct PendingFlush {
+    std::weak_ptr<queue_impl> Queue;
+    size_t Requests = 0;
+    std::chrono::steady_clock::time_point First;
+  };
+
+  static void flush(const std::shared_ptr<queue_impl> &Queue);
+
+  size_t MBatchSize = 0;
+  std::chrono::microseconds MMaxDelay{0};
+
+  std::mutex MMutex;
+  std::unordered_map<const queue_impl *, PendingFlush> MPending;
+  std::atomic<size_t> MNumPending{0};
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/compression.hpp>
 #include <detail/device_binary_image.hpp>
 #include <sycl/detail/ur.hpp>
 
@@ -189,6 +190,7 @@ void RTDeviceBinaryImage::init(sycl_device_binary Bin) {
   DeviceRequirements.init(Bin, __SYCL_PROPERTY_SET_SYCL_DEVICE_REQUIREMENTS);
   HostPipes.init(Bin, __SYCL_PROPERTY_SET_SYCL_HOST_PIPES);
   VirtualFunctions.init(Bin, __SYCL_PROPERTY_SET_SYCL_VIRTUAL_FUNCTIONS);
+  ProfileCounters.init(Bin, __SYCL_PROPERTY_SET_SYCL_PROFILE_COUNTERS);
 
   ImageId = ImageCounter++;
 }
@@ -226,6 +228,31 @@ DynRTDeviceBinaryImage::~DynRTDeviceBinaryImage() {
   Bin = nullptr;
 }
 
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+void CompressedRTDeviceBinaryImage::decompress() {
+  std::call_once(MDecompressFlag, [this]() {
+    size_t DecompressedSize = 0;
+    MDecompressedData = ZSTDCompressor::decompressBlob(
+        reinterpret_cast<const char *>(Bin->BinaryStart), getSize(),
+        DecompressedSize);
+
+    MDecompressedBin = std::make_unique<sycl_device_binary_struct>(*Bin);
+    MDecompressedBin->BinaryStart =
+        reinterpret_cast<const unsigned char *>(MDecompressedData.get());
+    MDecompressedBin->BinaryEnd =
+        MDecompressedBin->BinaryStart + DecompressedSize;
+    MDecompressedBin->Format = ur::getBinaryImageFormat(
+        MDecompressedBin->BinaryStart, DecompressedSize);
+
+    // Property ranges point into the property sets, which are shared with the
+    // original descriptor, so only the data and the format change here.
+    Bin = MDecompressedBin.get();
+    Format = static_cast<ur::DeviceBinaryType>(Bin->Format);
+    MIsDecompressed.store(true, std::memory_order_release);
+  });
+}
+#endif // SYCL_RT_ZSTD_AVAILABLE
+
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
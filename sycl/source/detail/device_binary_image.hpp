@@ -19,6 +19,7 @@
 #include <atomic>
 #include <cstring>
 #include <memory>
+#include <mutex>
 
 namespace sycl {
 inline namespace _V1 {
@@ -227,6 +228,7 @@ public:
   }
   const PropertyRange &getHostPipes() const { return HostPipes; }
   const PropertyRange &getVirtualFunctions() const { return VirtualFunctions; }
+  const PropertyRange &getProfileCounters() const { return ProfileCounters; }
 
   std::uintptr_t getImageID() const {
     assert(Bin && "Image ID is not available without a binary image.");
@@ -252,6 +254,7 @@ protected:
   RTDeviceBinaryImage::PropertyRange DeviceRequirements;
   RTDeviceBinaryImage::PropertyRange HostPipes;
   RTDeviceBinaryImage::PropertyRange VirtualFunctions;
+  RTDeviceBinaryImage::PropertyRange ProfileCounters;
 
   std::vector<ur_program_metadata_t> ProgramMetadataUR;
 
@@ -276,6 +279,40 @@ protected:
   std::unique_ptr<char[]> Data;
 };
 
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+// Device binary image whose binary data is compressed in the fat binary. The
+// data is only decompressed once the image is selected for a device, so images
+// for targets that are never used are never decompressed. Until then the image
+// format is SYCL_DEVICE_BINARY_TYPE_COMPRESSED_NONE.
+class CompressedRTDeviceBinaryImage : public RTDeviceBinaryImage {
+public:
+  CompressedRTDeviceBinaryImage(sycl_device_binary CompressedBin)
+      : RTDeviceBinaryImage(CompressedBin) {}
+
+  /// Decompresses the binary data if it has not been decompressed yet.
+  /// Safe to call concurrently.
+  void decompress();
+
+  bool isCompressed() const {
+    return !MIsDecompressed.load(std::memory_order_acquire);
+  }
+
+  void print() const override {
+    RTDeviceBinaryImage::print();
+    std::cerr << "    COMPRESSED" << (isCompressed() ? "" : ", DECOMPRESSED")
+              << "\n";
+  }
+
+private:
+  std::once_flag MDecompressFlag;
+  std::atomic<bool> MIsDecompressed{false};
+  std::unique_ptr<char[]> MDecompressedData;
+  // Copy of the original descriptor pointing to the decompressed data. The
+  // original one is a part of the loaded executable and can't be modified.
+  std::unique_ptr<sycl_device_binary_struct> MDecompressedBin;
+};
+#endif // SYCL_RT_ZSTD_AVAILABLE
+
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
@@ -11,8 +11,12 @@
 #include <detail/event_info.hpp>
 #include <detail/memory_manager.hpp>
 #include <detail/queue_impl.hpp>
+#include <detail/staging_buffer_pool.hpp>
 #include <detail/usm/usm_impl.hpp>
 
+#include <algorithm>
+#include <cstring>
+
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
@@ -90,6 +94,91 @@ DeviceGlobalUSMMem &DeviceGlobalMapEntry::getOrAllocateDeviceGlobalUSM(
   return NewAlloc;
 }
 
+void DeviceGlobalMapEntry::allocateDeviceGlobalsUSM(
+    const std::vector<DeviceGlobalMapEntry *> &Entries,
+    const std::shared_ptr<queue_impl> &QueueImpl) {
+  const std::shared_ptr<context_impl> &CtxImpl = QueueImpl->getContextImplPtr();
+  const std::shared_ptr<device_impl> &DevImpl = QueueImpl->getDeviceImplPtr();
+  const auto Key = std::make_pair(DevImpl.get(), CtxImpl.get());
+
+  // The maps of all the entries are locked for the allocation, in address
+  // order so that concurrent batches don't deadlock.
+  std::vector<DeviceGlobalMapEntry *> SortedEntries(Entries);
+  std::sort(SortedEntries.begin(), SortedEntries.end());
+  SortedEntries.erase(std::unique(SortedEntries.begin(), SortedEntries.end()),
+                      SortedEntries.end());
+  std::vector<std::unique_lock<std::mutex>> Locks;
+  Locks.reserve(SortedEntries.size());
+  std::vector<DeviceGlobalMapEntry *> NewEntries;
+  std::vector<size_t> Offsets;
+  size_t BlockSize = 0;
+  for (DeviceGlobalMapEntry *Entry : SortedEntries) {
+    Locks.emplace_back(Entry->MDeviceToUSMPtrMapMutex);
+    if (Entry->MDeviceToUSMPtrMap.count(Key))
+      continue;
+    // The alignment of a type divides its size, the largest power of 2 which
+    // divides the size is a sufficient alignment.
+    size_t Size = Entry->MDeviceGlobalTSize;
+    size_t Alignment = Size ? std::min<size_t>(Size & (~Size + 1), 128) : 1;
+    BlockSize = (BlockSize + Alignment - 1) / Alignment * Alignment;
+    NewEntries.push_back(Entry);
+    Offsets.push_back(BlockSize);
+    BlockSize += Size;
+  }
+  // A single device_global is allocated by getOrAllocateDeviceGlobalUSM.
+  if (NewEntries.size() < 2)
+    return;
+
+  // The initial values are packed into a pinned staging buffer. Without one,
+  // the device_globals are allocated one by one.
+  StagingBufferPool &Staging = CtxImpl->getStagingBufferPool();
+  void *StagingPtr = Staging.acquire(BlockSize);
+  if (!StagingPtr)
+    return;
+  void *BlockPtr = detail::usm::alignedAllocInternal(
+      128, BlockSize, CtxImpl.get(), DevImpl.get(), sycl::usm::alloc::device);
+  // The block is freed once the last device_global using it is removed from
+  // the context, which is still alive then.
+  const context_impl *Ctx = CtxImpl.get();
+  std::shared_ptr<void> Block(
+      BlockPtr, [Ctx](void *Ptr) { detail::usm::freeInternal(Ptr, Ctx); });
+
+  // See getOrAllocateDeviceGlobalUSM for the location of the initial value.
+  for (size_t I = 0; I < NewEntries.size(); ++I) {
+    const void *DeviceGlobalPtr = NewEntries[I]->MDeviceGlobalPtr;
+    std::memcpy(static_cast<char *>(StagingPtr) + Offsets[I],
+                reinterpret_cast<const void *>(
+                    reinterpret_cast<uintptr_t>(DeviceGlobalPtr) +
+                    sizeof(DeviceGlobalPtr)),
+                NewEntries[I]->MDeviceGlobalTSize);
+  }
+  ur_event_handle_t InitEvent = nullptr;
+  try {
+    MemoryManager::copy_usm(StagingPtr, QueueImpl, BlockSize, BlockPtr,
+                            std::vector<ur_event_handle_t>{}, &InitEvent,
+                            nullptr);
+  } catch (...) {
+    Staging.recycle(StagingPtr, BlockSize, nullptr);
+    throw;
+  }
+  Staging.recycle(StagingPtr, BlockSize, InitEvent);
+
+  // Each device_global owns a reference to the initialization event.
+  const AdapterPtr &Adapter = CtxImpl->getAdapter();
+  for (size_t I = 0; I < NewEntries.size(); ++I) {
+    DeviceGlobalMapEntry *Entry = NewEntries[I];
+    auto NewAllocIt = Entry->MDeviceToUSMPtrMap.emplace(
+        std::piecewise_construct, std::forward_as_tuple(Key),
+        std::forward_as_tuple(static_cast<char *>(BlockPtr) + Offsets[I]));
+    DeviceGlobalUSMMem &NewAlloc = NewAllocIt.first->second;
+    NewAlloc.MBlock = Block;
+    if (I > 0)
+      Adapter->call<UrApiKind::urEventRetain>(InitEvent);
+    NewAlloc.MInitEvent = InitEvent;
+    CtxImpl->addAssociatedDeviceGlobal(Entry->MDeviceGlobalPtr);
+  }
+}
+
 void DeviceGlobalMapEntry::removeAssociatedResources(
     const context_impl *CtxImpl) {
   std::lock_guard<std::mutex> Lock{MDeviceToUSMPtrMapMutex};
@@ -98,7 +187,10 @@ void DeviceGlobalMapEntry::removeAssociatedResources(
         MDeviceToUSMPtrMap.find({getSyclObjImpl(Device).get(), CtxImpl});
     if (USMPtrIt != MDeviceToUSMPtrMap.end()) {
       DeviceGlobalUSMMem &USMMem = USMPtrIt->second;
-      detail::usm::freeInternal(USMMem.MPtr, CtxImpl);
+      if (USMMem.MBlock)
+        USMMem.MBlock.reset();
+      else
+        detail::usm::freeInternal(USMMem.MPtr, CtxImpl);
       if (USMMem.MInitEvent.has_value())
         CtxImpl->getAdapter()->call<UrApiKind::urEventRelease>(
             *USMMem.MInitEvent);
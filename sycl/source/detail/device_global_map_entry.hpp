@@ -11,10 +11,12 @@
 #include <cassert>
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <set>
 #include <unordered_set>
+#include <vector>
 
 #include <detail/ur_utils.hpp>
 #include <sycl/detail/defines_elementary.hpp>
@@ -43,6 +45,9 @@ struct DeviceGlobalUSMMem {
 
 private:
   void *MPtr;
+  // The allocation shared by the device_globals allocated together, MPtr
+  // pointing inside it. Null if MPtr is an allocation of its own.
+  std::shared_ptr<void> MBlock;
   std::mutex MInitEventMutex;
   std::optional<ur_event_handle_t> MInitEvent;
 
@@ -112,6 +117,13 @@ struct DeviceGlobalMapEntry {
   DeviceGlobalUSMMem &
   getOrAllocateDeviceGlobalUSM(const std::shared_ptr<queue_impl> &QueueImpl);
 
+  // Allocates the USM memory of the device_globals of Entries which have none
+  // for the device and the context of QueueImpl. They share one allocation
+  // and their initial values are packed and copied by a single transfer.
+  static void
+  allocateDeviceGlobalsUSM(const std::vector<DeviceGlobalMapEntry *> &Entries,
+                           const std::shared_ptr<queue_impl> &QueueImpl);
+
   // Removes resources for device_globals associated with the context.
   void removeAssociatedResources(const context_impl *CtxImpl);
 
@@ -106,10 +106,37 @@ platform device_impl::get_platform() const {
   return createSyclObjFromImpl<platform>(MPlatform);
 }
 
+template <typename Param>
+const typename Param::return_type &
+device_impl::getCachedInfo(typename Param::return_type &Value,
+                           std::once_flag &Flag) const {
+  std::call_once(Flag, [&]() {
+    Value = get_device_info<Param>(
+        MPlatform->getOrMakeDeviceImpl(MDevice, MPlatform));
+  });
+  return Value;
+}
+
 template <typename Param>
 typename Param::return_type device_impl::get_info() const {
-  return get_device_info<Param>(
-      MPlatform->getOrMakeDeviceImpl(MDevice, MPlatform));
+  // The partitioning capabilities are queried for each device by
+  // ONEAPI_DEVICE_SELECTOR and create_sub_devices, and don't change.
+  if constexpr (std::is_same_v<Param, info::device::partition_properties>)
+    return getCachedInfo<Param>(MPartitionProperties,
+                                MPartitionPropertiesFlag);
+  else if constexpr (std::is_same_v<Param,
+                                    info::device::partition_affinity_domains>)
+    return getCachedInfo<Param>(MPartitionAffinityDomains,
+                                MPartitionAffinityDomainsFlag);
+  else if constexpr (std::is_same_v<Param,
+                                    info::device::partition_max_sub_devices>)
+    return getCachedInfo<Param>(MPartitionMaxSubDevices,
+                                MPartitionMaxSubDevicesFlag);
+  else if constexpr (std::is_same_v<Param, info::device::max_compute_units>)
+    return getCachedInfo<Param>(MMaxComputeUnits, MMaxComputeUnitsFlag);
+  else
+    return get_device_info<Param>(
+        MPlatform->getOrMakeDeviceImpl(MDevice, MPlatform));
 }
 // Explicitly instantiate all device info traits
 #define __SYCL_PARAM_TRAITS_SPEC(DescType, Desc, ReturnT, PiCode)              \
@@ -791,6 +818,17 @@ std::string device_impl::getDeviceName() const {
   return MDeviceName;
 }
 
+device_impl::ReductionLaunchParams device_impl::getReductionLaunchParams(
+    size_t LocalMemBytesPerWorkItem,
+    const std::function<ReductionLaunchParams()> &Compute) const {
+  std::lock_guard<std::mutex> Lock(MReductionLaunchParamsMutex);
+  auto It = MReductionLaunchParams.find(LocalMemBytesPerWorkItem);
+  if (It == MReductionLaunchParams.end())
+    It = MReductionLaunchParams.emplace(LocalMemBytesPerWorkItem, Compute())
+             .first;
+  return It->second;
+}
+
 ext::oneapi::experimental::architecture device_impl::getDeviceArch() const {
   std::call_once(MDeviceArchFlag, [this]() {
     MDeviceArch =
@@ -16,9 +16,12 @@
 #include <sycl/ext/oneapi/experimental/forward_progress.hpp>
 #include <sycl/kernel_bundle.hpp>
 
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace sycl {
 inline namespace _V1 {
@@ -293,7 +296,26 @@ public:
   /// Get device architecture
   ext::oneapi::experimental::architecture getDeviceArch() const;
 
+  /// Work-group size and number of work-groups of range reductions.
+  struct ReductionLaunchParams {
+    size_t WGSize;
+    size_t NumWorkGroups;
+  };
+
+  /// Get the launch parameters of range reductions using
+  /// LocalMemBytesPerWorkItem bytes of local memory per work-item. They are
+  /// computed by Compute on the first request and cached.
+  ReductionLaunchParams getReductionLaunchParams(
+      size_t LocalMemBytesPerWorkItem,
+      const std::function<ReductionLaunchParams()> &Compute) const;
+
 private:
+  /// Returns the value of the device info Param, fetching it into Value on
+  /// the first call.
+  template <typename Param>
+  const typename Param::return_type &
+  getCachedInfo(typename Param::return_type &Value, std::once_flag &Flag) const;
+
   explicit device_impl(ur_native_handle_t InteropDevice,
                        ur_device_handle_t Device, PlatformImplPtr Platform,
                        const AdapterPtr &Adapter);
@@ -307,6 +329,20 @@ private:
   mutable std::once_flag MDeviceNameFlag;
   mutable ext::oneapi::experimental::architecture MDeviceArch{};
   mutable std::once_flag MDeviceArchFlag;
+  /// The device info values queried for each device by the enumeration of
+  /// the devices and sub-devices, which are cached once fetched.
+  mutable std::vector<info::partition_property> MPartitionProperties;
+  mutable std::once_flag MPartitionPropertiesFlag;
+  mutable std::vector<info::partition_affinity_domain>
+      MPartitionAffinityDomains;
+  mutable std::once_flag MPartitionAffinityDomainsFlag;
+  mutable uint32_t MPartitionMaxSubDevices = 0;
+  mutable std::once_flag MPartitionMaxSubDevicesFlag;
+  mutable uint32_t MMaxComputeUnits = 0;
+  mutable std::once_flag MMaxComputeUnitsFlag;
+  mutable std::mutex MReductionLaunchParamsMutex;
+  mutable std::unordered_map<size_t, ReductionLaunchParams>
+      MReductionLaunchParams;
   std::pair<uint64_t, uint64_t> MDeviceHostBaseTime{0, 0};
 }; // class device_impl
 
@@ -0,0 +1,146 @@
+//==--------- device_profile.cpp - Profile counters of device code --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/adapter.hpp>
+#include <detail/config.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/device_binary_image.hpp>
+#include <detail/device_profile.hpp>
+#include <detail/kernel_program_cache.hpp>
+#include <detail/program_manager/program_manager.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+namespace {
+struct ProfileCountersInfo {
+  uint64_t FuncHash;
+  uint32_t NumCounters;
+  std::string FuncName;
+};
+
+// The property of the counters variable \p Prop, see collectProfileCounters
+// in ComputeModuleRuntimeInfo.cpp:
+// * 8 bytes - Size of the property.
+// * 8 bytes - Hash of the function.
+// * 4 bytes - Number of counters.
+// * 4 bytes - Size of the name of the function.
+// * The PGO name of the function.
+ProfileCountersInfo getProfileCountersInfo(sycl_device_binary_property Prop) {
+  ByteArray Info = DeviceBinaryProperty(Prop).asByteArray();
+  Info.dropBytes(8);
+  ProfileCountersInfo Res;
+  Res.FuncHash = Info.consume<uint64_t>();
+  Res.NumCounters = Info.consume<uint32_t>();
+  uint32_t NameSize = Info.consume<uint32_t>();
+  Res.FuncName.assign(reinterpret_cast<const char *>(Info.begin()), NameSize);
+  return Res;
+}
+
+// Counters of the functions of all the contexts released so far, by name and
+// hash. Never destroyed, contexts may be released by the destructors of other
+// static objects.
+using ProfileT = std::map<std::pair<std::string, uint64_t>,
+                          std::vector<uint64_t>>;
+ProfileT &getProfile() {
+  static ProfileT *Profile = new ProfileT();
+  return *Profile;
+}
+std::mutex &getProfileMutex() {
+  static std::mutex *Mutex = new std::mutex();
+  return *Mutex;
+}
+
+const std::string &getPath() {
+  static const std::string Path = SYCLConfig<SYCL_DEVICE_PROFILE_FILE>::get();
+  return Path;
+}
+
+bool readCounters(const AdapterPtr &Adapter, ur_queue_handle_t Queue,
+                  ur_program_handle_t Program, const char *Name,
+                  std::vector<uint64_t> &Counters) {
+  return Adapter->call_nocheck<UrApiKind::urEnqueueDeviceGlobalVariableRead>(
+             Queue, Program, Name, /*blockingRead=*/true,
+             Counters.size() * sizeof(uint64_t), 0, Counters.data(), 0,
+             nullptr, nullptr) == UR_RESULT_SUCCESS;
+}
+
+void writeProfile(const ProfileT &Profile) {
+  std::ofstream Out{getPath(), std::ios::trunc};
+  for (const auto &[Key, Counters] : Profile) {
+    Out << Key.first << "\n# Func Hash:\n"
+        << Key.second << "\n# Num Counters:\n"
+        << Counters.size() << "\n# Counter Values:\n";
+    for (uint64_t Count : Counters)
+      Out << Count << '\n';
+    Out << '\n';
+  }
+}
+} // namespace
+
+bool DeviceProfile::isEnabled() { return !getPath().empty(); }
+
+void DeviceProfile::collect(context_impl &Context) {
+  if (!isEnabled())
+    return;
+
+  const AdapterPtr &Adapter = Context.getAdapter();
+  std::vector<std::pair<ur_program_handle_t, ur_device_handle_t>> Programs;
+  {
+    auto LockedCache = Context.getKernelProgramCache().acquireCachedPrograms();
+    for (const auto &[Key, Result] : LockedCache.get().Cache)
+      if (Result->State.load() == KernelProgramCache::BuildState::BS_Done &&
+          Result->Val)
+        Programs.emplace_back(Result->Val, Key.second);
+  }
+
+  std::lock_guard<std::mutex> Lock(getProfileMutex());
+  ProfileT &Profile = getProfile();
+  bool Changed = false;
+  for (const auto &[Program, Device] : Programs) {
+    ur_queue_handle_t Queue = nullptr;
+    for (const RTDeviceBinaryImage *Img :
+         ProgramManager::getInstance().getNativeProgramImages(Program)) {
+      for (sycl_device_binary_property Prop : Img->getProfileCounters()) {
+        if (!Queue &&
+            Adapter->call_nocheck<UrApiKind::urQueueCreate>(
+                Context.getHandleRef(), Device, nullptr, &Queue) !=
+                UR_RESULT_SUCCESS)
+          break;
+        ProfileCountersInfo Info = getProfileCountersInfo(Prop);
+        std::vector<uint64_t> Counters(Info.NumCounters);
+        // The backend may not find the counters of a function it removed.
+        if (!readCounters(Adapter, Queue, Program, Prop->Name, Counters))
+          continue;
+        std::vector<uint64_t> &Total =
+            Profile[{std::move(Info.FuncName), Info.FuncHash}];
+        Total.resize(Counters.size());
+        for (size_t I = 0; I < Counters.size(); ++I)
+          Total[I] += Counters[I];
+        Changed = true;
+      }
+    }
+    if (Queue)
+      Adapter->call_nocheck<UrApiKind::urQueueRelease>(Queue);
+  }
+  if (Changed)
+    writeProfile(Profile);
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,37 @@
+//==--------- device_profile.hpp - Profile counters of device code --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class context_impl;
+
+/// Collects the counters of the device code built with
+/// -fprofile-instr-generate when SYCL_DEVICE_PROFILE_FILE is set.
+///
+/// sycl-post-link lists the counters of each device image in the
+/// "SYCL/profile counters" property set. The counters of the programs built
+/// for a context are read back when the context is released, added to those
+/// of the contexts released before, and the totals are written to the file
+/// in the text format of llvm-profdata, which merges the files of several
+/// runs and converts them for -fprofile-instr-use.
+class DeviceProfile {
+public:
+  static bool isEnabled();
+
+  /// Reads the counters of the programs in the cache of \p Context and
+  /// rewrites the profile file.
+  static void collect(context_impl &Context);
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -7,15 +7,18 @@
 //===----------------------------------------------------------------------===//
 
 #include <detail/adapter.hpp>
+#include <detail/deferred_flush.hpp>
 #include <detail/event_impl.hpp>
 #include <detail/event_info.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <sycl/context.hpp>
+#include <sycl/detail/tsan_annotations.hpp>
 #include <sycl/device_selector.hpp>
 
 #include "detail/config.hpp"
 
+#include <algorithm>
 #include <chrono>
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
@@ -52,9 +55,80 @@ event_impl::~event_impl() {
   }
 }
 
+// Polls the status of the native events for up to SpinDuration, so that the
+// waits on short commands don't pay the wake up latency of a blocking wait.
+static void spinOnEvents(const AdapterPtr &Adapter,
+                         const ur_event_handle_t *Events, size_t NumEvents,
+                         std::chrono::microseconds SpinDuration) {
+  if (SpinDuration.count() <= 0)
+    return;
+  auto Deadline = std::chrono::steady_clock::now() + SpinDuration;
+  size_t Next = 0;
+  while (Next < NumEvents) {
+    ur_event_status_t Status = UR_EVENT_STATUS_QUEUED;
+    if (Adapter->call_nocheck<UrApiKind::urEventGetInfo>(
+            Events[Next], UR_EVENT_INFO_COMMAND_EXECUTION_STATUS,
+            sizeof(ur_event_status_t), &Status,
+            nullptr) != UR_RESULT_SUCCESS)
+      return;
+    if (Status == UR_EVENT_STATUS_COMPLETE)
+      ++Next;
+    else if (std::chrono::steady_clock::now() >= Deadline)
+      return;
+  }
+}
+
+std::chrono::microseconds event_impl::getWaitSpinDuration() const {
+  if (QueueImplPtr Queue = MQueue.lock())
+    return Queue->getWaitSpinDuration();
+  return std::chrono::microseconds{0};
+}
+
+void event_impl::waitNativeEvents(const std::vector<event> &Events) {
+  if (Events.size() < 2)
+    return;
+  if (DeferredFlush::isEnabled())
+    DeferredFlush::instance().flushAll();
+
+  struct AdapterEvents {
+    const AdapterPtr *Adapter;
+    std::vector<ur_event_handle_t> Handles;
+    std::chrono::microseconds SpinDuration;
+  };
+  std::vector<AdapterEvents> Groups;
+  for (const event &Event : Events) {
+    const EventImplPtr &Impl = getSyclObjImpl(Event);
+    ur_event_handle_t Handle = Impl->getHandle();
+    if (Impl->MIsHostEvent || !Handle || !Impl->MGraph.expired())
+      continue;
+    const AdapterPtr &Adapter = Impl->getAdapter();
+    auto It = std::find_if(
+        Groups.begin(), Groups.end(),
+        [&](const AdapterEvents &Group) { return *Group.Adapter == Adapter; });
+    if (It == Groups.end())
+      It = Groups.insert(Groups.end(),
+                         {&Adapter, {}, std::chrono::microseconds{0}});
+    It->Handles.push_back(Handle);
+    It->SpinDuration = std::max(It->SpinDuration, Impl->getWaitSpinDuration());
+  }
+
+  for (AdapterEvents &Group : Groups) {
+    spinOnEvents(*Group.Adapter, Group.Handles.data(), Group.Handles.size(),
+                 Group.SpinDuration);
+    // The errors are reported by the waits on the individual events, which
+    // find them complete.
+    (*Group.Adapter)
+        ->call_nocheck<UrApiKind::urEventWait>(Group.Handles.size(),
+                                               Group.Handles.data());
+  }
+}
+
 void event_impl::waitInternal(bool *Success) {
   auto Handle = this->getHandle();
+  if (DeferredFlush::isEnabled())
+    DeferredFlush::instance().flushAll();
   if (!MIsHostEvent && Handle) {
+    spinOnEvents(getAdapter(), &Handle, 1, getWaitSpinDuration());
     // Wait for the native event
     ur_result_t Err =
         getAdapter()->call_nocheck<UrApiKind::urEventWait>(1, &Handle);
@@ -67,6 +141,7 @@ void event_impl::waitInternal(bool *Success) {
       *Success = false;
     else {
       getAdapter()->checkUrResult(Err);
+      MNativeComplete.store(true, std::memory_order_release);
       if (Success != nullptr)
         *Success = true;
     }
@@ -80,6 +155,10 @@ void event_impl::waitInternal(bool *Success) {
     std::unique_lock<std::mutex> lock(MMutex);
     cv.wait(lock, [this] { return MState == HES_Complete; });
   }
+  // The host task or the submitting thread, see setComplete and setHandle,
+  // synchronize with the waiting thread.
+  if (Success == nullptr || *Success)
+    tsanAcquire(this);
 
   // Wait for connected events(e.g. streams prints)
   for (const EventImplPtr &Event : MPostCompleteEvents)
@@ -95,6 +174,7 @@ void event_impl::setComplete() {
   if (MIsHostEvent || !this->getHandle()) {
     {
       std::unique_lock<std::mutex> lock(MMutex);
+      tsanRelease(this);
 #ifndef NDEBUG
       int Expected = HES_NotComplete;
       int Desired = HES_Complete;
@@ -122,7 +202,14 @@ static uint64_t inline getTimestamp() {
 ur_event_handle_t event_impl::getHandle() const { return MEvent.load(); }
 
 void event_impl::setHandle(const ur_event_handle_t &UREvent) {
+  // The commands enqueued for the handle are submitted after what the
+  // submitting thread did so far, which happens before the threads seeing
+  // the event complete, as far as ThreadSanitizer is concerned.
+  tsanRelease(this);
   MEvent.store(UREvent);
+  // The cached status was the one of the previous handle.
+  MNativeComplete.store(false, std::memory_order_relaxed);
+  MCompletionCallbackSet.store(false, std::memory_order_relaxed);
 }
 
 const ContextImplPtr &event_impl::getContextImpl() {
@@ -405,17 +492,23 @@ event_impl::get_info<info::event::command_execution_status>() {
   if (!MIsHostEvent) {
     // Command is enqueued and UrEvent is ready
     auto Handle = this->getHandle();
-    if (Handle)
-      return get_event_info<info::event::command_execution_status>(
-          Handle, this->getAdapter());
+    if (Handle) {
+      if (DeferredFlush::isEnabled())
+        DeferredFlush::instance().flushAll();
+      info::event_command_status Status = getNativeExecutionStatus(Handle);
+      if (Status == info::event_command_status::complete)
+        tsanAcquire(this);
+      return Status;
+    }
     // Command is blocked and not enqueued, UrEvent is not assigned yet
     else if (MCommand)
       return sycl::info::event_command_status::submitted;
   }
 
-  return MIsHostEvent && MState.load() != HES_Complete
-             ? sycl::info::event_command_status::submitted
-             : info::event_command_status::complete;
+  if (MIsHostEvent && MState.load() != HES_Complete)
+    return sycl::info::event_command_status::submitted;
+  tsanAcquire(this);
+  return info::event_command_status::complete;
 }
 
 template <>
@@ -542,7 +635,10 @@ void event_impl::flushIfNeeded(const QueueImplPtr &UserQueue) {
       Handle, UR_EVENT_INFO_COMMAND_EXECUTION_STATUS, sizeof(ur_event_status_t),
       &Status, nullptr);
   if (Status == UR_EVENT_STATUS_QUEUED) {
-    getAdapter()->call<UrApiKind::urQueueFlush>(Queue->getHandleRef());
+    if (DeferredFlush::isEnabled())
+      DeferredFlush::instance().request(Queue);
+    else
+      getAdapter()->call<UrApiKind::urQueueFlush>(Queue->getHandleRef());
   }
   MIsFlushed = true;
 }
@@ -602,6 +698,57 @@ void event_impl::setHostEnqueueTime() {
 
 uint64_t event_impl::getSubmissionTime() { return MSubmitTime; }
 
+static void onNativeEventCompletion(ur_event_handle_t, ur_execution_info_t,
+                                    void *UserData) {
+  std::unique_ptr<std::shared_ptr<std::atomic<bool>>> Flag(
+      static_cast<std::shared_ptr<std::atomic<bool>> *>(UserData));
+  (*Flag)->store(true, std::memory_order_release);
+}
+
+void event_impl::setCompletionCallback(ur_event_handle_t Handle) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  if (MCompletionCallbackSet.load(std::memory_order_relaxed) ||
+      MCompletionCallbackFailed)
+    return;
+  auto Flag = std::make_shared<std::atomic<bool>>(false);
+  auto *UserData = new std::shared_ptr<std::atomic<bool>>(Flag);
+  if (getAdapter()->call_nocheck<UrApiKind::urEventSetCallback>(
+          Handle, UR_EXECUTION_INFO_COMPLETE, onNativeEventCompletion,
+          UserData) != UR_RESULT_SUCCESS) {
+    delete UserData;
+    MCompletionCallbackFailed = true;
+    return;
+  }
+  MCompletionCallbackFlag = std::move(Flag);
+  MCompletionCallbackSet.store(true, std::memory_order_release);
+}
+
+info::event_command_status
+event_impl::getNativeExecutionStatus(ur_event_handle_t Handle) {
+  if (MNativeComplete.load(std::memory_order_acquire))
+    return info::event_command_status::complete;
+  if (MCompletionCallbackSet.load(std::memory_order_acquire)) {
+    // Until the callback is called, the command is still in the last status
+    // queried, or has moved from submitted to running since.
+    if (!MCompletionCallbackFlag->load(std::memory_order_acquire))
+      return static_cast<info::event_command_status>(
+          MLastNativeStatus.load(std::memory_order_relaxed));
+    MNativeComplete.store(true, std::memory_order_release);
+    return info::event_command_status::complete;
+  }
+
+  info::event_command_status Status =
+      get_event_info<info::event::command_execution_status>(Handle,
+                                                            getAdapter());
+  if (Status == info::event_command_status::complete) {
+    MNativeComplete.store(true, std::memory_order_release);
+    return Status;
+  }
+  MLastNativeStatus.store(static_cast<int>(Status), std::memory_order_relaxed);
+  setCompletionCallback(Handle);
+  return Status;
+}
+
 bool event_impl::isCompleted() {
   return get_info<info::event::command_execution_status>() ==
          info::event_command_status::complete;
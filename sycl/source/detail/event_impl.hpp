@@ -17,8 +17,10 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <optional>
+#include <vector>
 
 namespace sycl {
 inline namespace _V1 {
@@ -26,6 +28,7 @@ namespace ext::oneapi::experimental::detail {
 class graph_impl;
 }
 class context;
+class event;
 namespace detail {
 class Adapter;
 class context_impl;
@@ -123,6 +126,10 @@ public:
   ///        it's pointing to is then set according to the outcome.
   void waitInternal(bool *Success = nullptr);
 
+  /// Waits for the native events of Events with one backend call per
+  /// adapter, so that the waits on the individual events find them complete.
+  static void waitNativeEvents(const std::vector<event> &Events);
+
   /// Marks this event as completed.
   void setComplete();
 
@@ -337,6 +344,15 @@ public:
   }
 
 protected:
+  // Returns the execution status of the native event Handle, cached once it
+  // is complete.
+  info::event_command_status getNativeExecutionStatus(ur_event_handle_t Handle);
+  // Sets the callback marking the native event Handle complete, if supported.
+  void setCompletionCallback(ur_event_handle_t Handle);
+
+  // Returns the spin duration of the waits on the event, set by its queue.
+  std::chrono::microseconds getWaitSpinDuration() const;
+
   // When instrumentation is enabled emits trace event for event wait begin and
   // returns the telemetry event generated for the wait
   void *instrumentationProlog(std::string &Name, int32_t StreamID,
@@ -388,6 +404,20 @@ protected:
   std::mutex MMutex;
   std::condition_variable cv;
 
+  // Status of the native event cached by the completion polling, so that
+  // polling a completed event, or a pending one whose completion callback is
+  // set, doesn't call into the adapter.
+  std::atomic<bool> MNativeComplete{false};
+  // Last status different from complete queried for the native event.
+  std::atomic<int> MLastNativeStatus{0};
+  // Set by the completion callback of the native event. It is shared with the
+  // callback, which may be called after the event is destroyed.
+  std::shared_ptr<std::atomic<bool>> MCompletionCallbackFlag;
+  // Published once MCompletionCallbackFlag is set, under MMutex.
+  std::atomic<bool> MCompletionCallbackSet{false};
+  // Whether the adapter doesn't support the completion callbacks.
+  bool MCompletionCallbackFailed = false;
+
   /// Store the command graph associated with this event, if any.
   /// This event is also be stored in the graph so a weak_ptr is used.
   std::weak_ptr<ext::oneapi::experimental::detail::graph_impl> MGraph;
@@ -0,0 +1,108 @@
+//==---------------- event_impl_pool.hpp - SYCL event pool -----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// Free list of memory blocks used for event_impl objects of a queue. The
+/// objects themselves are destroyed as usual, only their storage is recycled,
+/// so a stream of short-lived events does not go through malloc/free for each
+/// of them.
+class EventImplPool {
+public:
+  EventImplPool() = default;
+  EventImplPool(const EventImplPool &) = delete;
+  EventImplPool &operator=(const EventImplPool &) = delete;
+
+  ~EventImplPool() {
+    for (void *Block : MFreeBlocks)
+      ::operator delete(Block);
+  }
+
+  void *allocate(size_t Size) {
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      if (Size == MBlockSize && !MFreeBlocks.empty()) {
+        void *Block = MFreeBlocks.back();
+        MFreeBlocks.pop_back();
+        return Block;
+      }
+    }
+    return ::operator new(Size);
+  }
+
+  void deallocate(void *Block, size_t Size) {
+    {
+      std::lock_guard<std::mutex> Lock(MMutex);
+      // All the blocks are expected to be of the same size, so only the first
+      // size seen is pooled.
+      if (!MBlockSize)
+        MBlockSize = Size;
+      if (Size == MBlockSize && MFreeBlocks.size() < MaxFreeBlocks) {
+        MFreeBlocks.push_back(Block);
+        return;
+      }
+    }
+    ::operator delete(Block);
+  }
+
+private:
+  // Limits the memory kept by the pool after a burst of submissions.
+  static constexpr size_t MaxFreeBlocks = 1024;
+
+  std::mutex MMutex;
+  std::vector<void *> MFreeBlocks;
+  size_t MBlockSize = 0;
+};
+
+/// Allocator for std::allocate_shared taking the storage from EventImplPool.
+/// It keeps the pool alive, so events may outlive the queue they belong to.
+template <typename T> class EventImplPoolAllocator {
+public:
+  using value_type = T;
+
+  EventImplPoolAllocator(std::shared_ptr<EventImplPool> Pool)
+      : MPool(std::move(Pool)) {}
+
+  template <typename U>
+  EventImplPoolAllocator(const EventImplPoolAllocator<U> &Other)
+      : MPool(Other.MPool) {}
+
+  T *allocate(size_t N) {
+    return static_cast<T *>(MPool->allocate(N * sizeof(T)));
+  }
+
+  void deallocate(T *Ptr, size_t N) { MPool->deallocate(Ptr, N * sizeof(T)); }
+
+  template <typename U>
+  bool operator==(const EventImplPoolAllocator<U> &Other) const {
+    return MPool == Other.MPool;
+  }
+  template <typename U>
+  bool operator!=(const EventImplPoolAllocator<U> &Other) const {
+    return MPool != Other.MPool;
+  }
+
+private:
+  template <typename U> friend class EventImplPoolAllocator;
+
+  std::shared_ptr<EventImplPool> MPool;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
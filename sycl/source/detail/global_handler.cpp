@@ -17,6 +17,7 @@
 #include <detail/platform_impl.hpp>
 #include <detail/program_manager/program_manager.hpp>
 #include <detail/scheduler/scheduler.hpp>
+#include <detail/stream_printer.hpp>
 #include <detail/thread_pool.hpp>
 #include <detail/ur.hpp>
 #include <detail/xpti_registry.hpp>
@@ -96,7 +97,7 @@ void GlobalHandler::TraceEventXPTI(const char *Message) {
     return;
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   static std::once_flag InitXPTIFlag;
-  if (xptiTraceEnabled()) {
+  if (xpti::framework::trace_enabled()) {
     std::call_once(InitXPTIFlag, [&]() { InitXPTI(); });
 
     // We have to handle the cases where: (1) we may have just the code location
@@ -229,6 +230,12 @@ ThreadPool &GlobalHandler::getHostTaskThreadPool() {
   return TP;
 }
 
+StreamPrinter &GlobalHandler::getStreamPrinter() {
+  bool Lossy = SYCLConfig<SYCL_ASYNC_STREAM_FLUSH>::get() ==
+               StreamFlushMode::AsyncLossy;
+  return getOrCreate(MStreamPrinter, Lossy);
+}
+
 void GlobalHandler::releaseDefaultContexts() {
   // Release shared-pointers to SYCL objects.
   // Note that on Windows the destruction of the default context
@@ -326,6 +333,10 @@ void shutdown_early() {
   if (Handler->MHostTaskThreadPool.Inst)
     Handler->MHostTaskThreadPool.Inst->finishAndWait();
 
+  // Print the output of the streams flushed by the host tasks.
+  if (Handler->MStreamPrinter.Inst)
+    Handler->MStreamPrinter.Inst->finishAndWait();
+
   // This releases OUR reference to the default context, but
   // other may yet have refs
   Handler->releaseDefaultContexts();
@@ -26,6 +26,7 @@ class Adapter;
 class ods_target_list;
 class XPTIRegistry;
 class ThreadPool;
+class StreamPrinter;
 
 using PlatformImplPtr = std::shared_ptr<platform_impl>;
 using ContextImplPtr = std::shared_ptr<context_impl>;
@@ -72,6 +73,7 @@ public:
   ods_target_list &getOneapiDeviceSelectorTargets(const std::string &InitValue);
   XPTIRegistry &getXPTIRegistry();
   ThreadPool &getHostTaskThreadPool();
+  StreamPrinter &getStreamPrinter();
 
   static void registerEarlyShutdownHandler();
 
@@ -129,6 +131,8 @@ private:
   InstWithLock<XPTIRegistry> MXPTIRegistry;
   // Thread pool for host task and event callbacks execution
   InstWithLock<ThreadPool> MHostTaskThreadPool;
+  // Background printer of sycl::stream output
+  InstWithLock<StreamPrinter> MStreamPrinter;
 };
 } // namespace detail
 } // namespace _V1
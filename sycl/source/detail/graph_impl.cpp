@@ -9,6 +9,7 @@
 #include <detail/graph_impl.hpp>
 #include <detail/handler_impl.hpp>
 #include <detail/kernel_arg_mask.hpp>
+#include <detail/persistent_device_code_cache.hpp>
 #include <detail/program_manager/program_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/scheduler/commands.hpp>
@@ -17,9 +18,13 @@
 #ifdef __INTEL_PREVIEW_BREAKING_CHANGES
 #include <sycl/detail/string_view.hpp>
 #endif
+#include <sycl/ext/oneapi/virtual_mem/virtual_mem.hpp>
 #include <sycl/feature_test.hpp>
 #include <sycl/queue.hpp>
 
+#include <unordered_map>
+#include <unordered_set>
+
 namespace sycl {
 inline namespace _V1 {
 
@@ -174,6 +179,89 @@ std::vector<node> createNodesFromImpls(
   return Nodes;
 }
 
+/// Maximum number of queues the partitions of a graph are spread over.
+constexpr size_t MaxPartitionQueues = 4;
+
+/// Assigns the nodes of a partition group to connected components, only
+/// considering edges between nodes of the group.
+/// @param Nodes Nodes of the group.
+/// @param[out] Components Index of the component of each node, in the order
+/// the components are first encountered in Nodes.
+/// @return The number of components.
+size_t
+findConnectedComponents(const std::vector<std::shared_ptr<node_impl>> &Nodes,
+                        std::vector<size_t> &Components) {
+  std::unordered_map<node_impl *, size_t> NodeIndices;
+  for (size_t I = 0; I < Nodes.size(); ++I) {
+    NodeIndices[Nodes[I].get()] = I;
+  }
+
+  const size_t Unassigned = Nodes.size();
+  Components.assign(Nodes.size(), Unassigned);
+  size_t NumComponents = 0;
+  std::vector<size_t> ToVisit;
+  for (size_t I = 0; I < Nodes.size(); ++I) {
+    if (Components[I] != Unassigned) {
+      continue;
+    }
+    Components[I] = NumComponents;
+    ToVisit.push_back(I);
+    while (!ToVisit.empty()) {
+      const auto &Node = Nodes[ToVisit.back()];
+      ToVisit.pop_back();
+      auto Visit = [&](const std::weak_ptr<node_impl> &Other) {
+        auto It = NodeIndices.find(Other.lock().get());
+        if (It != NodeIndices.end() && Components[It->second] == Unassigned) {
+          Components[It->second] = NumComponents;
+          ToVisit.push_back(It->second);
+        }
+      };
+      std::for_each(Node->MSuccessors.begin(), Node->MSuccessors.end(), Visit);
+      std::for_each(Node->MPredecessors.begin(), Node->MPredecessors.end(),
+                    Visit);
+    }
+    ++NumComponents;
+  }
+  return NumComponents;
+}
+
+/// Tests if two requirements describe the same access to the same memory.
+bool isSameRequirement(const sycl::detail::AccessorImplHost *LHS,
+                       const sycl::detail::AccessorImplHost *RHS) {
+  return LHS->MSYCLMemObj == RHS->MSYCLMemObj &&
+         LHS->MAccessMode == RHS->MAccessMode &&
+         LHS->MOffset == RHS->MOffset &&
+         LHS->MAccessRange == RHS->MAccessRange &&
+         LHS->MMemoryRange == RHS->MMemoryRange &&
+         LHS->MDims == RHS->MDims && LHS->MElemSize == RHS->MElemSize &&
+         LHS->MOffsetInBytes == RHS->MOffsetInBytes &&
+         LHS->MIsSubBuffer == RHS->MIsSubBuffer;
+}
+
+/// Removes requirements equivalent to an earlier one from a list, keeping the
+/// order of the remaining ones. Each requirement of the graph is processed by
+/// the scheduler on every submission, while nodes commonly access the same
+/// buffers in the same way.
+/// @param Requirements List of requirements to deduplicate.
+void removeDuplicateRequirements(
+    std::vector<sycl::detail::AccessorImplHost *> &Requirements) {
+  std::unordered_map<sycl::detail::SYCLMemObjI *,
+                     std::vector<sycl::detail::AccessorImplHost *>>
+      Seen;
+  auto NewEnd = std::remove_if(
+      Requirements.begin(), Requirements.end(),
+      [&Seen](sycl::detail::AccessorImplHost *Req) {
+        std::vector<sycl::detail::AccessorImplHost *> &SameMemObj =
+            Seen[Req->MSYCLMemObj];
+        for (sycl::detail::AccessorImplHost *Other : SameMemObj)
+          if (Other == Req || isSameRequirement(Other, Req))
+            return true;
+        SameMemObj.push_back(Req);
+        return false;
+      });
+  Requirements.erase(NewEnd, Requirements.end());
+}
+
 } // anonymous namespace
 
 void partition::schedule() {
@@ -185,6 +273,48 @@ void partition::schedule() {
 }
 
 void exec_graph_impl::makePartitions() {
+  // Partitioning only depends on the topology of the graph, so it is stored
+  // along with the device code to be reused by later runs.
+  std::string CacheKey;
+  if (sycl::detail::PersistentDeviceCodeCache::isEnabled()) {
+    CacheKey = getPartitionsCacheKey();
+  }
+  if (CacheKey.empty() ||
+      !deserializePartitions(
+          sycl::detail::PersistentDeviceCodeCache::getGraphItemFromDisc(
+              MDevice, CacheKey))) {
+    computePartitions();
+    if (!CacheKey.empty()) {
+      sycl::detail::PersistentDeviceCodeCache::putGraphItemToDisc(
+          MDevice, CacheKey, serializePartitions());
+    }
+  }
+
+  // Add an empty partition if there is no partition, i.e. empty graph
+  if (MPartitions.size() == 0) {
+    MPartitions.push_back(std::make_shared<partition>());
+  }
+
+  // Make global schedule list
+  for (const auto &Partition : MPartitions) {
+    MSchedule.insert(MSchedule.end(), Partition->MSchedule.begin(),
+                     Partition->MSchedule.end());
+  }
+
+  // Compute partition dependencies
+  for (const auto &Partition : MPartitions) {
+    for (auto const &Root : Partition->MRoots) {
+      auto RootNode = Root.lock();
+      for (const auto &Dep : RootNode->MPredecessors) {
+        auto NodeDep = Dep.lock();
+        Partition->MPredecessors.push_back(
+            MPartitions[MPartitionNodes[NodeDep]]);
+      }
+    }
+  }
+}
+
+void exec_graph_impl::computePartitions() {
   int CurrentPartition = -1;
   std::list<std::shared_ptr<node_impl>> HostTaskList;
   // find all the host-tasks in the graph
@@ -254,50 +384,173 @@ void exec_graph_impl::makePartitions() {
   // Create partitions
   int PartitionFinalNum = 0;
   for (int i = -1; i <= CurrentPartition; i++) {
-    const std::shared_ptr<partition> &Partition = std::make_shared<partition>();
+    std::vector<std::shared_ptr<node_impl>> GroupNodes;
     for (auto &Node : MNodeStorage) {
       if (Node->MPartitionNum == i) {
+        GroupNodes.push_back(Node);
+      }
+    }
+    if (GroupNodes.empty()) {
+      continue;
+    }
+
+    // Nodes of a group with no edges between them can run concurrently, so
+    // each connected part of the group gets its own partition and queue.
+    std::vector<size_t> Components(GroupNodes.size(), 0);
+    size_t NumComponents = 1;
+    if (MUseMultipleQueues &&
+        GroupNodes.front()->MCGType != sycl::detail::CGType::CodeplayHostTask) {
+      NumComponents = findConnectedComponents(GroupNodes, Components);
+    }
+
+    for (size_t Component = 0; Component < NumComponents; ++Component) {
+      const std::shared_ptr<partition> &Partition =
+          std::make_shared<partition>();
+      for (size_t NodeIdx = 0; NodeIdx < GroupNodes.size(); ++NodeIdx) {
+        if (Components[NodeIdx] != Component) {
+          continue;
+        }
+        const auto &Node = GroupNodes[NodeIdx];
         MPartitionNodes[Node] = PartitionFinalNum;
         if (isPartitionRoot(Node)) {
           Partition->MRoots.insert(Node);
         }
       }
-    }
-    if (Partition->MRoots.size() > 0) {
-      Partition->schedule();
-      Partition->MIsInOrderGraph = Partition->checkIfGraphIsSinglePath();
-      MPartitions.push_back(Partition);
-      PartitionFinalNum++;
+      if (Partition->MRoots.size() > 0) {
+        Partition->schedule();
+        Partition->MIsInOrderGraph = Partition->checkIfGraphIsSinglePath();
+        Partition->MQueueIndex = Component % MaxPartitionQueues;
+        MPartitions.push_back(Partition);
+        PartitionFinalNum++;
+      }
     }
   }
 
-  // Add an empty partition if there is no partition, i.e. empty graph
-  if (MPartitions.size() == 0) {
-    MPartitions.push_back(std::make_shared<partition>());
+  // Reset node groups (if node have to be re-processed - e.g. subgraph)
+  for (auto &Node : MNodeStorage) {
+    Node->MPartitionNum = -1;
   }
+}
 
-  // Make global schedule list
-  for (const auto &Partition : MPartitions) {
-    MSchedule.insert(MSchedule.end(), Partition->MSchedule.begin(),
-                     Partition->MSchedule.end());
+std::string exec_graph_impl::getPartitionsCacheKey() const {
+  std::unordered_map<node_impl *, size_t> NodeIndices;
+  for (size_t I = 0; I < MNodeStorage.size(); ++I) {
+    NodeIndices[MNodeStorage[I].get()] = I;
   }
 
-  // Compute partition dependencies
-  for (const auto &Partition : MPartitions) {
-    for (auto const &Root : Partition->MRoots) {
-      auto RootNode = Root.lock();
-      for (const auto &Dep : RootNode->MPredecessors) {
-        auto NodeDep = Dep.lock();
-        Partition->MPredecessors.push_back(
-            MPartitions[MPartitionNodes[NodeDep]]);
+  std::string Key{"graph-partitions-1"};
+  auto AppendValue = [&Key](size_t Value) {
+    Key.append(reinterpret_cast<const char *>(&Value), sizeof(Value));
+  };
+  AppendValue(MUseMultipleQueues);
+  AppendValue(MNodeStorage.size());
+  for (const auto &Node : MNodeStorage) {
+    AppendValue(static_cast<size_t>(Node->MNodeType));
+    AppendValue(static_cast<size_t>(Node->MCGType));
+    if (Node->MCGType == sycl::detail::CGType::Kernel) {
+      std::string KernelName =
+          static_cast<sycl::detail::CGExecKernel *>(Node->MCommandGroup.get())
+              ->getKernelName();
+      // Kernels without a name can't be told apart across runs.
+      if (KernelName.empty()) {
+        return {};
       }
+      AppendValue(KernelName.size());
+      Key.append(KernelName);
+    }
+    AppendValue(Node->MSuccessors.size());
+    for (const auto &Succ : Node->MSuccessors) {
+      AppendValue(NodeIndices.at(Succ.lock().get()));
     }
   }
+  return Key;
+}
 
-  // Reset node groups (if node have to be re-processed - e.g. subgraph)
-  for (auto &Node : MNodeStorage) {
-    Node->MPartitionNum = -1;
+// Format: number of partitions, then for each partition its queue index,
+// in-order flag, [size, node indices] of its roots and [size, node indices] of
+// its schedule.
+std::vector<char> exec_graph_impl::serializePartitions() const {
+  std::unordered_map<node_impl *, size_t> NodeIndices;
+  for (size_t I = 0; I < MNodeStorage.size(); ++I) {
+    NodeIndices[MNodeStorage[I].get()] = I;
   }
+
+  std::vector<char> Data;
+  auto AppendValue = [&Data](size_t Value) {
+    const char *Bytes = reinterpret_cast<const char *>(&Value);
+    Data.insert(Data.end(), Bytes, Bytes + sizeof(Value));
+  };
+  AppendValue(MPartitions.size());
+  for (const auto &Partition : MPartitions) {
+    AppendValue(Partition->MQueueIndex);
+    AppendValue(Partition->MIsInOrderGraph);
+    AppendValue(Partition->MRoots.size());
+    for (const auto &Root : Partition->MRoots) {
+      AppendValue(NodeIndices.at(Root.lock().get()));
+    }
+    AppendValue(Partition->MSchedule.size());
+    for (const auto &Node : Partition->MSchedule) {
+      AppendValue(NodeIndices.at(Node.get()));
+    }
+  }
+  return Data;
+}
+
+bool exec_graph_impl::deserializePartitions(const std::vector<char> &Data) {
+  size_t Pos = 0;
+  auto ReadValue = [&Data, &Pos](size_t &Value) {
+    if (Data.size() - Pos < sizeof(Value))
+      return false;
+    std::memcpy(&Value, Data.data() + Pos, sizeof(Value));
+    Pos += sizeof(Value);
+    return true;
+  };
+  auto ReadNode = [&](std::shared_ptr<node_impl> &Node) {
+    size_t Index = 0;
+    if (!ReadValue(Index) || Index >= MNodeStorage.size())
+      return false;
+    Node = MNodeStorage[Index];
+    return true;
+  };
+
+  auto Restore = [&]() {
+    size_t NumPartitions = 0;
+    if (Data.empty() || !ReadValue(NumPartitions))
+      return false;
+    for (size_t PartitionNum = 0; PartitionNum < NumPartitions;
+         ++PartitionNum) {
+      auto Partition = std::make_shared<partition>();
+      size_t IsInOrder = 0, NumRoots = 0, ScheduleSize = 0;
+      if (!ReadValue(Partition->MQueueIndex) || !ReadValue(IsInOrder) ||
+          !ReadValue(NumRoots))
+        return false;
+      Partition->MIsInOrderGraph = IsInOrder;
+      for (size_t I = 0; I < NumRoots; ++I) {
+        std::shared_ptr<node_impl> Root;
+        if (!ReadNode(Root))
+          return false;
+        Partition->MRoots.insert(Root);
+      }
+      if (!ReadValue(ScheduleSize))
+        return false;
+      for (size_t I = 0; I < ScheduleSize; ++I) {
+        std::shared_ptr<node_impl> Node;
+        if (!ReadNode(Node) ||
+            !MPartitionNodes.emplace(Node, PartitionNum).second)
+          return false;
+        Partition->MSchedule.push_back(Node);
+      }
+      MPartitions.push_back(Partition);
+    }
+    // Every node must be scheduled exactly once
+    return Pos == Data.size() && MPartitionNodes.size() == MNodeStorage.size();
+  };
+
+  if (Restore())
+    return true;
+  MPartitions.clear();
+  MPartitionNodes.clear();
+  return false;
 }
 
 graph_impl::~graph_impl() {
@@ -306,6 +559,9 @@ graph_impl::~graph_impl() {
     for (auto &MemObj : MMemObjs) {
       MemObj->markNoLongerBeingUsedInGraph();
     }
+    for (const MemAllocation &Alloc : MMemAllocations) {
+      free_virtual_mem(Alloc.Ptr, Alloc.Size, MContext);
+    }
   } catch (std::exception &e) {
     __SYCL_REPORT_EXCEPTION_TO_STREAM("exception in ~graph_impl", e);
   }
@@ -367,6 +623,60 @@ graph_impl::add(const std::vector<std::shared_ptr<node_impl>> &Dep) {
   return NodeImpl;
 }
 
+std::shared_ptr<node_impl>
+graph_impl::addMemAlloc(void *&Ptr, size_t Size,
+                        const std::vector<std::shared_ptr<node_impl>> &Dep) {
+  if (!MDevice.has(aspect::ext_oneapi_virtual_mem)) {
+    throw sycl::exception(sycl::make_error_code(errc::feature_not_supported),
+                          "Memory allocation nodes require a device with "
+                          "aspect::ext_oneapi_virtual_mem");
+  }
+  if (Size == 0) {
+    throw sycl::exception(sycl::make_error_code(errc::invalid),
+                          "Memory allocation nodes cannot be zero-sized");
+  }
+
+  const size_t Granularity = get_mem_granularity(MDevice, MContext);
+  const size_t AlignedSize =
+      ((Size + Granularity - 1) / Granularity) * Granularity;
+  uintptr_t Start = reserve_virtual_mem(AlignedSize, MContext);
+  MMemAllocations.push_back({Start, AlignedSize, false});
+
+  std::shared_ptr<node_impl> NodeImpl = add(Dep);
+  NodeImpl->MNodeType = node_type::ext_oneapi_mem_alloc;
+  NodeImpl->MMemPtr = reinterpret_cast<void *>(Start);
+  NodeImpl->MMemSize = AlignedSize;
+
+  Ptr = NodeImpl->MMemPtr;
+  return NodeImpl;
+}
+
+std::shared_ptr<node_impl>
+graph_impl::addMemFree(void *Ptr,
+                       const std::vector<std::shared_ptr<node_impl>> &Dep) {
+  auto AllocIt = std::find_if(MMemAllocations.begin(), MMemAllocations.end(),
+                              [Ptr](const MemAllocation &Alloc) {
+                                return Alloc.Ptr ==
+                                       reinterpret_cast<uintptr_t>(Ptr);
+                              });
+  if (AllocIt == MMemAllocations.end()) {
+    throw sycl::exception(sycl::make_error_code(errc::invalid),
+                          "Pointer was not allocated by a memory allocation "
+                          "node of this graph");
+  }
+  if (AllocIt->Freed) {
+    throw sycl::exception(sycl::make_error_code(errc::invalid),
+                          "Memory allocation has already been freed");
+  }
+  AllocIt->Freed = true;
+
+  std::shared_ptr<node_impl> NodeImpl = add(Dep);
+  NodeImpl->MNodeType = node_type::ext_oneapi_mem_free;
+  NodeImpl->MMemPtr = Ptr;
+  NodeImpl->MMemSize = AllocIt->Size;
+  return NodeImpl;
+}
+
 std::shared_ptr<node_impl>
 graph_impl::add(std::function<void(handler &)> CGF,
                 const std::vector<sycl::detail::ArgDesc> &Args,
@@ -731,11 +1041,6 @@ ur_exp_command_buffer_sync_point_t exec_graph_impl::enqueueNode(
     ur_exp_command_buffer_handle_t CommandBuffer,
     std::shared_ptr<node_impl> Node) {
 
-  // Queue which will be used for allocation operations for accessors.
-  auto AllocaQueue = std::make_shared<sycl::detail::queue_impl>(
-      DeviceImpl, sycl::detail::getSyclObjImpl(Ctx), sycl::async_handler{},
-      sycl::property_list{});
-
   std::vector<ur_exp_command_buffer_sync_point_t> Deps;
   for (auto &N : Node->MPredecessors) {
     findRealDeps(Deps, N.lock(), MPartitionNodes[Node]);
@@ -743,8 +1048,8 @@ ur_exp_command_buffer_sync_point_t exec_graph_impl::enqueueNode(
 
   sycl::detail::EventImplPtr Event =
       sycl::detail::Scheduler::getInstance().addCG(
-          Node->getCGCopy(), AllocaQueue, /*EventNeeded=*/true, CommandBuffer,
-          Deps);
+          Node->getCGCopy(), getAllocaQueue(Ctx, DeviceImpl),
+          /*EventNeeded=*/true, CommandBuffer, Deps);
 
   if (MIsUpdatable) {
     MCommandMap[Node] = Event->getCommandBufferCommand();
@@ -752,6 +1057,37 @@ ur_exp_command_buffer_sync_point_t exec_graph_impl::enqueueNode(
 
   return Event->getSyncPoint();
 }
+const std::shared_ptr<sycl::detail::queue_impl> &
+exec_graph_impl::getAllocaQueue(sycl::context Ctx,
+                                sycl::detail::DeviceImplPtr DeviceImpl) {
+  // Creating a queue creates a backend queue as well, so it is done once and
+  // not per node.
+  if (!MAllocaQueue || MAllocaQueue->getDeviceImplPtr() != DeviceImpl)
+    MAllocaQueue = std::make_shared<sycl::detail::queue_impl>(
+        DeviceImpl, sycl::detail::getSyclObjImpl(Ctx), sycl::async_handler{},
+        sycl::property_list{});
+  return MAllocaQueue;
+}
+
+const std::shared_ptr<sycl::detail::queue_impl> &
+exec_graph_impl::getPartitionQueue(
+    const std::shared_ptr<sycl::detail::queue_impl> &Queue, size_t Index) {
+  if (Index == 0)
+    return Queue;
+
+  if (MPartitionQueues.size() < Index)
+    MPartitionQueues.resize(Index);
+  std::shared_ptr<sycl::detail::queue_impl> &PartitionQueue =
+      MPartitionQueues[Index - 1];
+  if (!PartitionQueue ||
+      PartitionQueue->getDeviceImplPtr() != Queue->getDeviceImplPtr())
+    PartitionQueue = std::make_shared<sycl::detail::queue_impl>(
+        Queue->getDeviceImplPtr(), Queue->getContextImplPtr(),
+        sycl::async_handler{},
+        sycl::property_list{sycl::property::queue::in_order{}});
+  return PartitionQueue;
+}
+
 void exec_graph_impl::createCommandBuffers(
     sycl::device Device, std::shared_ptr<partition> &Partition) {
   ur_exp_command_buffer_handle_t OutCommandBuffer;
@@ -804,6 +1140,8 @@ void exec_graph_impl::createCommandBuffers(
                       Node->MCommandGroup->getAccStorage().end());
   }
 
+  removeDuplicateRequirements(MRequirements);
+
   Res = Adapter
             ->call_nocheck<sycl::detail::UrApiKind::urCommandBufferFinalizeExp>(
                 OutCommandBuffer);
@@ -821,7 +1159,9 @@ exec_graph_impl::exec_graph_impl(sycl::context Context,
       MExecutionEvents(),
       MIsUpdatable(PropList.has_property<property::graph::updatable>()),
       MEnableProfiling(
-          PropList.has_property<property::graph::enable_profiling>()) {
+          PropList.has_property<property::graph::enable_profiling>()),
+      MUseMultipleQueues(
+          PropList.has_property<property::graph::use_multiple_queues>()) {
 
   // If the graph has been marked as updatable then check if the backend
   // actually supports that. Devices supporting aspect::ext_oneapi_graph must
@@ -835,6 +1175,21 @@ exec_graph_impl::exec_graph_impl(sycl::context Context,
   }
   // Copy nodes from GraphImpl and merge any subgraph nodes into this graph.
   duplicateNodes();
+
+  // Updates match the nodes and edges of this graph against the modifiable
+  // graph, so the topology of updatable graphs is kept as it is.
+  if (PropList.has_property<property::graph::enable_optimizations>() &&
+      !MIsUpdatable) {
+    removeRedundantEdges();
+    coalesceMemoryOperations();
+  }
+
+  if (std::any_of(MNodeStorage.begin(), MNodeStorage.end(),
+                  [](const std::shared_ptr<node_impl> &Node) {
+                    return Node->MNodeType == node_type::ext_oneapi_mem_alloc;
+                  })) {
+    mapMemAllocations();
+  }
 }
 
 exec_graph_impl::~exec_graph_impl() {
@@ -868,6 +1223,14 @@ exec_graph_impl::~exec_graph_impl() {
         assert(Res == UR_RESULT_SUCCESS);
       }
     }
+
+    if (MMemArena) {
+      for (const auto &[Ptr, Size] : MMemMappings) {
+        unmap(Ptr, Size, MContext);
+      }
+      MMemArena.reset();
+      MGraphImpl->MMemAllocationsMapped = false;
+    }
   } catch (std::exception &e) {
     __SYCL_REPORT_EXCEPTION_TO_STREAM("exception in ~exec_graph_impl", e);
   }
@@ -882,12 +1245,14 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
   std::unordered_map<std::shared_ptr<partition>, sycl::detail::EventImplPtr>
       PartitionsExecutionEvents;
 
-  auto CreateNewEvent([&]() {
-    auto NewEvent = std::make_shared<sycl::detail::event_impl>(Queue);
-    NewEvent->setContextImpl(Queue->getContextImplPtr());
-    NewEvent->setStateIncomplete();
-    return NewEvent;
-  });
+  auto CreateNewEvent(
+      [](const std::shared_ptr<sycl::detail::queue_impl> &EventQueue) {
+        auto NewEvent = std::make_shared<sycl::detail::event_impl>(EventQueue);
+        NewEvent->setContextImpl(EventQueue->getContextImplPtr());
+        NewEvent->setStateIncomplete();
+        return NewEvent;
+      });
+  bool UsedPartitionQueues = false;
 
   sycl::detail::EventImplPtr NewEvent;
   std::vector<sycl::detail::EventImplPtr> BackupCGDataMEvents;
@@ -949,7 +1314,11 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
         }
       }
 
-      NewEvent = CreateNewEvent();
+      const std::shared_ptr<sycl::detail::queue_impl> &PartitionQueue =
+          getPartitionQueue(Queue, CurrentPartition->MQueueIndex);
+      UsedPartitionQueues |= PartitionQueue != Queue;
+
+      NewEvent = CreateNewEvent(PartitionQueue);
       ur_event_handle_t UREvent = nullptr;
       // Merge requirements from the nodes into requirements (if any) from the
       // handler.
@@ -966,10 +1335,11 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
           NewEvent->setHostEnqueueTime();
         }
         ur_result_t Res =
-            Queue->getAdapter()
+            PartitionQueue->getAdapter()
                 ->call_nocheck<
                     sycl::detail::UrApiKind::urCommandBufferEnqueueExp>(
-                    CommandBuffer, Queue->getHandleRef(), 0, nullptr, &UREvent);
+                    CommandBuffer, PartitionQueue->getHandleRef(), 0, nullptr,
+                    &UREvent);
         NewEvent->setHandle(UREvent);
         if (Res == UR_RESULT_ERROR_INVALID_QUEUE_PROPERTIES) {
           throw sycl::exception(
@@ -989,7 +1359,7 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
                 CommandBuffer, nullptr, std::move(CGData));
 
         NewEvent = sycl::detail::Scheduler::getInstance().addCG(
-            std::move(CommandGroup), Queue, /*EventNeeded=*/true);
+            std::move(CommandGroup), PartitionQueue, /*EventNeeded=*/true);
       }
       NewEvent->setEventFromSubmittedExecCommandBuffer(true);
     } else if ((CurrentPartition->MSchedule.size() > 0) &&
@@ -1024,7 +1394,7 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
           sycl::detail::CGExecKernel *CG =
               static_cast<sycl::detail::CGExecKernel *>(
                   NodeImpl->MCommandGroup.get());
-          auto OutEvent = CreateNewEvent();
+          auto OutEvent = CreateNewEvent(Queue);
           sycl::detail::enqueueImpKernel(
               Queue, CG->MNDRDesc, CG->MArgs, CG->MKernelBundle,
               CG->MSyclKernel, CG->MKernelName, RawEvents, OutEvent,
@@ -1052,6 +1422,21 @@ exec_graph_impl::enqueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
     PartitionsExecutionEvents[CurrentPartition] = NewEvent;
   }
 
+  // Work on the internal queues is joined back into the queue the graph was
+  // submitted to, so that later commands on it are ordered after the graph.
+  if (UsedPartitionQueues) {
+    std::vector<sycl::detail::EventImplPtr> PartitionEvents;
+    PartitionEvents.reserve(PartitionsExecutionEvents.size());
+    for (auto const &Elem : PartitionsExecutionEvents) {
+      PartitionEvents.push_back(Elem.second);
+    }
+    NewEvent = sycl::detail::Scheduler::getInstance().addCG(
+        std::make_unique<sycl::detail::CGBarrier>(
+            std::move(PartitionEvents), sycl::detail::CG::StorageInitHelper{},
+            sycl::detail::CGType::BarrierWaitlist),
+        Queue, /*EventNeeded=*/true);
+  }
+
   // Keep track of this execution event so we can make sure it's completed in
   // the destructor.
   MExecutionEvents.push_back(NewEvent);
@@ -1220,6 +1605,237 @@ void exec_graph_impl::duplicateNodes() {
   MNodeStorage.insert(MNodeStorage.begin(), NewNodes.begin(), NewNodes.end());
 }
 
+void exec_graph_impl::mapMemAllocations() {
+  // The virtual address ranges are owned by the modifiable graph, so they can
+  // only be backed by the memory of a single executable graph at a time.
+  if (MGraphImpl->MMemAllocationsMapped) {
+    throw sycl::exception(sycl::make_error_code(errc::invalid),
+                          "Graphs with memory allocation nodes can only have "
+                          "one executable graph alive at a time");
+  }
+
+  // Topological order of the nodes
+  std::unordered_map<node_impl *, size_t> PendingPreds;
+  std::vector<node_impl *> Order;
+  for (const auto &Node : MNodeStorage) {
+    PendingPreds[Node.get()] = Node->MPredecessors.size();
+    if (Node->MPredecessors.empty())
+      Order.push_back(Node.get());
+  }
+  for (size_t I = 0; I < Order.size(); I++) {
+    for (const auto &Succ : Order[I]->MSuccessors) {
+      node_impl *SuccNode = Succ.lock().get();
+      if (--PendingPreds[SuccNode] == 0)
+        Order.push_back(SuccNode);
+    }
+  }
+
+  // Nodes ordered after the free node of each allocation
+  std::unordered_map<void *, std::unordered_set<node_impl *>> AfterFree;
+  for (node_impl *Node : Order) {
+    if (Node->MNodeType != node_type::ext_oneapi_mem_free)
+      continue;
+    std::unordered_set<node_impl *> &Reachable = AfterFree[Node->MMemPtr];
+    std::vector<node_impl *> Stack{Node};
+    while (!Stack.empty()) {
+      node_impl *Current = Stack.back();
+      Stack.pop_back();
+      for (const auto &Succ : Current->MSuccessors) {
+        node_impl *SuccNode = Succ.lock().get();
+        if (Reachable.insert(SuccNode).second)
+          Stack.push_back(SuccNode);
+      }
+    }
+  }
+
+  struct Placement {
+    void *Ptr;
+    size_t Offset;
+    size_t Size;
+  };
+  std::vector<Placement> Placements;
+  size_t ArenaSize = 0;
+  for (node_impl *Node : Order) {
+    if (Node->MNodeType != node_type::ext_oneapi_mem_alloc)
+      continue;
+
+    // Earlier allocations still alive when this one is allocated
+    std::vector<std::pair<size_t, size_t>> Busy;
+    for (const Placement &Other : Placements) {
+      auto FreeIt = AfterFree.find(Other.Ptr);
+      if (FreeIt == AfterFree.end() || !FreeIt->second.count(Node))
+        Busy.emplace_back(Other.Offset, Other.Offset + Other.Size);
+    }
+    std::sort(Busy.begin(), Busy.end());
+
+    // First fit, all the sizes are multiples of the granularity so the
+    // offsets are suitably aligned for mapping
+    size_t Offset = 0;
+    for (const auto &[Begin, End] : Busy) {
+      if (Offset + Node->MMemSize <= Begin)
+        break;
+      Offset = std::max(Offset, End);
+    }
+    Placements.push_back({Node->MMemPtr, Offset, Node->MMemSize});
+    ArenaSize = std::max(ArenaSize, Offset + Node->MMemSize);
+  }
+
+  MMemArena = std::make_unique<physical_mem>(MDevice, MContext, ArenaSize);
+  for (const Placement &Place : Placements) {
+    MMemArena->map(reinterpret_cast<uintptr_t>(Place.Ptr), Place.Size,
+                   address_access_mode::read_write, Place.Offset);
+    MMemMappings.emplace_back(Place.Ptr, Place.Size);
+  }
+  MGraphImpl->MMemAllocationsMapped = true;
+}
+
+void exec_graph_impl::removeRedundantEdges() {
+  std::unordered_map<node_impl *, size_t> NodeIndices;
+  for (size_t I = 0; I < MNodeStorage.size(); ++I)
+    NodeIndices[MNodeStorage[I].get()] = I;
+
+  // Stores the index of the last node the search was run for, so the marks
+  // don't need to be reset between searches.
+  std::vector<size_t> ReachedFrom(MNodeStorage.size(), MNodeStorage.size());
+  std::vector<node_impl *> ToVisit;
+  for (size_t I = 0; I < MNodeStorage.size(); ++I) {
+    const std::shared_ptr<node_impl> &Node = MNodeStorage[I];
+    if (Node->MSuccessors.size() < 2)
+      continue;
+
+    // Mark all the nodes reachable through paths of at least two edges.
+    ToVisit.clear();
+    for (auto &Succ : Node->MSuccessors)
+      for (auto &SuccSucc : Succ.lock()->MSuccessors)
+        ToVisit.push_back(SuccSucc.lock().get());
+    while (!ToVisit.empty()) {
+      node_impl *Cur = ToVisit.back();
+      ToVisit.pop_back();
+      size_t &Mark = ReachedFrom[NodeIndices.at(Cur)];
+      if (Mark == I)
+        continue;
+      Mark = I;
+      for (auto &Succ : Cur->MSuccessors)
+        ToVisit.push_back(Succ.lock().get());
+    }
+
+    // Direct edges to the marked nodes are implied by these paths.
+    auto IsRedundant = [&](const std::weak_ptr<node_impl> &Succ) {
+      std::shared_ptr<node_impl> SuccNode = Succ.lock();
+      if (ReachedFrom[NodeIndices.at(SuccNode.get())] != I)
+        return false;
+      auto &Preds = SuccNode->MPredecessors;
+      Preds.erase(std::remove_if(Preds.begin(), Preds.end(),
+                                 [&Node](const std::weak_ptr<node_impl> &Pred) {
+                                   return Pred.lock() == Node;
+                                 }),
+                  Preds.end());
+      return true;
+    };
+    Node->MSuccessors.erase(std::remove_if(Node->MSuccessors.begin(),
+                                           Node->MSuccessors.end(),
+                                           IsRedundant),
+                            Node->MSuccessors.end());
+  }
+}
+
+void exec_graph_impl::coalesceMemoryOperations() {
+  // Creates the command-group of a node covering First and then Second.
+  auto MergeCGs = [](sycl::detail::CG *First, sycl::detail::CG *Second)
+      -> std::unique_ptr<sycl::detail::CG> {
+    sycl::detail::CG::StorageInitHelper Data(
+        First->getArgsStorage(), First->getAccStorage(),
+        First->getSharedPtrStorage(), First->getRequirements(),
+        First->getEvents());
+    Data.MArgsStorage.insert(Data.MArgsStorage.end(),
+                             Second->getArgsStorage().begin(),
+                             Second->getArgsStorage().end());
+    Data.MSharedPtrStorage.insert(Data.MSharedPtrStorage.end(),
+                                  Second->getSharedPtrStorage().begin(),
+                                  Second->getSharedPtrStorage().end());
+    sycl::detail::code_location Loc(First->MFileName.data(),
+                                    First->MFunctionName.data(), First->MLine,
+                                    First->MColumn);
+
+    if (First->getType() == sycl::detail::CGType::CopyUSM) {
+      auto *FirstCopy = static_cast<sycl::detail::CGCopyUSM *>(First);
+      auto *SecondCopy = static_cast<sycl::detail::CGCopyUSM *>(Second);
+      if (static_cast<char *>(FirstCopy->getSrc()) + FirstCopy->getLength() !=
+              SecondCopy->getSrc() ||
+          static_cast<char *>(FirstCopy->getDst()) + FirstCopy->getLength() !=
+              SecondCopy->getDst())
+        return nullptr;
+      return std::make_unique<sycl::detail::CGCopyUSM>(
+          FirstCopy->getSrc(), FirstCopy->getDst(),
+          FirstCopy->getLength() + SecondCopy->getLength(), std::move(Data),
+          Loc);
+    }
+
+    auto *FirstFill = static_cast<sycl::detail::CGFillUSM *>(First);
+    auto *SecondFill = static_cast<sycl::detail::CGFillUSM *>(Second);
+    if (FirstFill->getPattern() != SecondFill->getPattern() ||
+        FirstFill->getLength() % FirstFill->getPattern().size() != 0 ||
+        static_cast<char *>(FirstFill->getDst()) + FirstFill->getLength() !=
+            SecondFill->getDst())
+      return nullptr;
+    return std::make_unique<sycl::detail::CGFillUSM>(
+        FirstFill->getPattern(), FirstFill->getDst(),
+        FirstFill->getLength() + SecondFill->getLength(), std::move(Data), Loc);
+  };
+
+  auto IsMergeable = [](const std::shared_ptr<node_impl> &Node) {
+    return (Node->MCGType == sycl::detail::CGType::CopyUSM ||
+            Node->MCGType == sycl::detail::CGType::FillUSM) &&
+           Node->MCommandGroup->getRequirements().empty() &&
+           Node->MCommandGroup->getEvents().empty();
+  };
+
+  std::unordered_set<node_impl *> MergedNodes;
+  for (const std::shared_ptr<node_impl> &Node : MNodeStorage) {
+    if (MergedNodes.count(Node.get()) || !IsMergeable(Node))
+      continue;
+
+    while (Node->MSuccessors.size() == 1) {
+      std::shared_ptr<node_impl> Succ = Node->MSuccessors.front().lock();
+      if (Succ->MPredecessors.size() != 1 || Succ->MCGType != Node->MCGType ||
+          !IsMergeable(Succ))
+        break;
+
+      std::unique_ptr<sycl::detail::CG> MergedCG =
+          MergeCGs(Node->MCommandGroup.get(), Succ->MCommandGroup.get());
+      if (!MergedCG)
+        break;
+      Node->MCommandGroup = std::move(MergedCG);
+
+      // Node takes over the successors of the merged node.
+      Node->MSuccessors = std::move(Succ->MSuccessors);
+      Succ->MSuccessors.clear();
+      Succ->MPredecessors.clear();
+      for (auto &NextWeak : Node->MSuccessors) {
+        for (auto &Pred : NextWeak.lock()->MPredecessors)
+          if (Pred.lock() == Succ)
+            Pred = Node;
+      }
+      MergedNodes.insert(Succ.get());
+    }
+  }
+
+  if (MergedNodes.empty())
+    return;
+
+  for (auto It = MIDCache.begin(); It != MIDCache.end();) {
+    if (MergedNodes.count(It->second.get()))
+      It = MIDCache.erase(It);
+    else
+      ++It;
+  }
+  MNodeStorage.erase(std::remove_if(MNodeStorage.begin(), MNodeStorage.end(),
+                                    [&MergedNodes](const auto &Node) {
+                                      return MergedNodes.count(Node.get()) != 0;
+                                    }),
+                     MNodeStorage.end());
+}
+
 void exec_graph_impl::update(std::shared_ptr<graph_impl> GraphImpl) {
 
   if (MDevice != GraphImpl->getDevice()) {
@@ -1281,8 +1897,13 @@ void exec_graph_impl::update(std::shared_ptr<graph_impl> GraphImpl) {
   }
 
   for (uint32_t i = 0; i < MNodeStorage.size(); ++i) {
-    MIDCache.insert(
-        std::make_pair(GraphImpl->MNodeStorage[i]->MID, MNodeStorage[i]));
+    // Repeated updates from the same graph must not grow the cache.
+    auto [Begin, End] = MIDCache.equal_range(GraphImpl->MNodeStorage[i]->MID);
+    if (std::none_of(Begin, End, [&](const auto &Entry) {
+          return Entry.second == MNodeStorage[i];
+        }))
+      MIDCache.insert(
+          std::make_pair(GraphImpl->MNodeStorage[i]->MID, MNodeStorage[i]));
   }
 
   update(GraphImpl->MNodeStorage);
@@ -1309,9 +1930,14 @@ void exec_graph_impl::update(
   // At worst we may have as many requirements as there are for the entire graph
   // for updating.
   UpdateRequirements.reserve(MRequirements.size());
+  // Only the nodes modified since this graph was last finalized or updated
+  // from them are passed on, so the cost of an update depends on the number
+  // of changed nodes rather than the size of the graph.
+  std::vector<std::shared_ptr<node_impl>> ChangedNodes;
   for (auto &Node : Nodes) {
     // Check if node(s) derived from this modifiable node exists in this graph
-    if (MIDCache.count(Node->getID()) == 0) {
+    auto ExecNode = MIDCache.find(Node->getID());
+    if (ExecNode == MIDCache.end()) {
       throw sycl::exception(
           sycl::make_error_code(errc::invalid),
           "Node passed to update() is not part of the graph.");
@@ -1324,6 +1950,10 @@ void exec_graph_impl::update(
                             "barrier and empty nodes are supported.");
     }
 
+    if (ExecNode->second->MModificationStamp == Node->MModificationStamp)
+      continue;
+    ChangedNodes.push_back(Node);
+
     if (const auto &CG = Node->MCommandGroup;
         CG && CG->getRequirements().size() != 0) {
       NeedScheduledUpdate = true;
@@ -1334,6 +1964,9 @@ void exec_graph_impl::update(
     }
   }
 
+  if (ChangedNodes.empty())
+    return;
+
   // Clean up any execution events which have finished so we don't pass them to
   // the scheduler.
   for (auto It = MExecutionEvents.begin(); It != MExecutionEvents.end();) {
@@ -1349,15 +1982,15 @@ void exec_graph_impl::update(
   NeedScheduledUpdate |= MExecutionEvents.size() > 0;
 
   if (NeedScheduledUpdate) {
-    auto AllocaQueue = std::make_shared<sycl::detail::queue_impl>(
-        sycl::detail::getSyclObjImpl(MGraphImpl->getDevice()),
-        sycl::detail::getSyclObjImpl(MGraphImpl->getContext()),
-        sycl::async_handler{}, sycl::property_list{});
+    removeDuplicateRequirements(UpdateRequirements);
     // Don't need to care about the return event here because it is synchronous
     sycl::detail::Scheduler::getInstance().addCommandGraphUpdate(
-        this, Nodes, AllocaQueue, UpdateRequirements, MExecutionEvents);
+        this, ChangedNodes,
+        getAllocaQueue(MGraphImpl->getContext(),
+                       sycl::detail::getSyclObjImpl(MGraphImpl->getDevice())),
+        UpdateRequirements, MExecutionEvents);
   } else {
-    for (auto &Node : Nodes) {
+    for (auto &Node : ChangedNodes) {
       updateImpl(Node);
     }
   }
@@ -1371,6 +2004,7 @@ void exec_graph_impl::update(
                          Node->MCommandGroup->getRequirements().begin(),
                          Node->MCommandGroup->getRequirements().end());
   }
+  removeDuplicateRequirements(MRequirements);
 }
 
 void exec_graph_impl::updateImpl(std::shared_ptr<node_impl> Node) {
@@ -1416,7 +2050,8 @@ void exec_graph_impl::updateImpl(std::shared_ptr<node_impl> Node) {
     UrKernel = Kernel->getHandleRef();
     EliminatedArgMask = Kernel->getKernelArgMask();
   } else {
-    std::tie(UrKernel, std::ignore, EliminatedArgMask, UrProgram) =
+    std::tie(UrKernel, std::ignore, EliminatedArgMask, UrProgram,
+             std::ignore) =
         sycl::detail::ProgramManager::getInstance().getOrCreateKernel(
             ContextImpl, DeviceImpl, ExecCG.MKernelName);
   }
@@ -1593,6 +2228,33 @@ node modifiable_command_graph::addImpl(std::function<void(handler &)> CGF,
   return sycl::detail::createSyclObjFromImpl<node>(NodeImpl);
 }
 
+node modifiable_command_graph::addMallocDeviceImpl(
+    void *&Ptr, size_t Size, const std::vector<node> &Deps) {
+  impl->throwIfGraphRecordingQueue("Explicit API \"add_malloc_device()\"");
+  std::vector<std::shared_ptr<detail::node_impl>> DepImpls;
+  for (auto &D : Deps) {
+    DepImpls.push_back(sycl::detail::getSyclObjImpl(D));
+  }
+
+  graph_impl::WriteLock Lock(impl->MMutex);
+  std::shared_ptr<detail::node_impl> NodeImpl =
+      impl->addMemAlloc(Ptr, Size, DepImpls);
+  return sycl::detail::createSyclObjFromImpl<node>(NodeImpl);
+}
+
+node modifiable_command_graph::addFreeImpl(void *Ptr,
+                                           const std::vector<node> &Deps) {
+  impl->throwIfGraphRecordingQueue("Explicit API \"add_free()\"");
+  std::vector<std::shared_ptr<detail::node_impl>> DepImpls;
+  for (auto &D : Deps) {
+    DepImpls.push_back(sycl::detail::getSyclObjImpl(D));
+  }
+
+  graph_impl::WriteLock Lock(impl->MMutex);
+  std::shared_ptr<detail::node_impl> NodeImpl = impl->addMemFree(Ptr, DepImpls);
+  return sycl::detail::createSyclObjFromImpl<node>(NodeImpl);
+}
+
 void modifiable_command_graph::addGraphLeafDependencies(node Node) {
   // Find all exit nodes in the current graph and add them to the dependency
   // vector
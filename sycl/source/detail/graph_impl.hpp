@@ -12,6 +12,7 @@
 #include <sycl/detail/os_util.hpp>
 #include <sycl/ext/oneapi/experimental/graph.hpp>
 #include <sycl/ext/oneapi/experimental/raw_kernel_arg.hpp>
+#include <sycl/ext/oneapi/virtual_mem/physical_mem.hpp>
 #include <sycl/handler.hpp>
 
 #include <detail/accessor_impl.hpp>
@@ -21,6 +22,7 @@
 #include <detail/kernel_impl.hpp>
 #include <detail/sycl_mem_obj_t.hpp>
 
+#include <atomic>
 #include <cstring>
 #include <deque>
 #include <fstream>
@@ -111,6 +113,16 @@ public:
   /// Track whether an ND-Range was used for kernel nodes
   bool MNDRangeUsed = false;
 
+  /// Stamp of the last modification of the node arguments or execution range,
+  /// unique across all nodes. Copies of a node keep its stamp until they are
+  /// modified, so executable graph update can skip unchanged nodes.
+  uint64_t MModificationStamp = getNextModificationStamp();
+
+  /// Device address and size of the memory allocated by a memory allocation
+  /// node, or released by a memory free node.
+  void *MMemPtr = nullptr;
+  size_t MMemSize = 0;
+
   /// Add successor to the node.
   /// @param Node Node to add as a successor.
   void registerSuccessor(const std::shared_ptr<node_impl> &Node) {
@@ -160,7 +172,9 @@ public:
       : enable_shared_from_this(Other), MSuccessors(Other.MSuccessors),
         MPredecessors(Other.MPredecessors), MCGType(Other.MCGType),
         MNodeType(Other.MNodeType), MCommandGroup(Other.getCGCopy()),
-        MSubGraphImpl(Other.MSubGraphImpl) {}
+        MSubGraphImpl(Other.MSubGraphImpl),
+        MModificationStamp(Other.MModificationStamp), MMemPtr(Other.MMemPtr),
+        MMemSize(Other.MMemSize) {}
 
   /// Copy-assignment operator. This will perform a deep-copy of the
   /// command group object associated with this node.
@@ -172,6 +186,9 @@ public:
       MNodeType = Other.MNodeType;
       MCommandGroup = Other.getCGCopy();
       MSubGraphImpl = Other.MSubGraphImpl;
+      MModificationStamp = Other.MModificationStamp;
+      MMemPtr = Other.MMemPtr;
+      MMemSize = Other.MMemSize;
     }
     return *this;
   }
@@ -454,6 +471,7 @@ public:
         }
       }
       Arg.MPtr = NewAccImpl.get();
+      MModificationStamp = getNextModificationStamp();
       break;
     }
   }
@@ -470,6 +488,7 @@ public:
       // MPtr may be a pointer into arg storage so we memcpy the contents of
       // NewValue rather than assign it directly
       std::memcpy(Arg.MPtr, NewValue, Size);
+      MModificationStamp = getNextModificationStamp();
       break;
     }
   }
@@ -499,6 +518,7 @@ public:
     }
 
     NDRDesc = sycl::detail::NDRDescT{ExecutionRange};
+    MModificationStamp = getNextModificationStamp();
   }
 
   template <int Dimensions> void updateRange(range<Dimensions> ExecutionRange) {
@@ -525,6 +545,7 @@ public:
     }
 
     NDRDesc = sycl::detail::NDRDescT{ExecutionRange};
+    MModificationStamp = getNextModificationStamp();
   }
 
   void updateFromOtherNode(const std::shared_ptr<node_impl> &Other) {
@@ -542,6 +563,7 @@ public:
     auto &NewArgStorage = ExecCG->getArgsStorage();
     // Rebuild the arg storage and update the args
     rebuildArgStorage(ExecCG->MArgs, OldArgStorage, NewArgStorage);
+    MModificationStamp = Other->MModificationStamp;
   }
 
   id_type getID() const { return MID; }
@@ -583,6 +605,11 @@ private:
     return nextID++;
   }
 
+  static uint64_t getNextModificationStamp() {
+    static std::atomic<uint64_t> NextStamp = 0;
+    return NextStamp++;
+  }
+
   /// Prints Node information to Stream.
   /// @param Stream Where to print the Node information
   /// @param Verbose If true, print additional information about the nodes
@@ -817,6 +844,9 @@ public:
   /// True if the graph of this partition is a single path graph
   /// and in-order optmization can be applied on it.
   bool MIsInOrderGraph = false;
+  /// Index of the queue this partition is submitted to, 0 is the queue the
+  /// graph is submitted to.
+  size_t MQueueIndex = 0;
 
   /// @return True if the partition contains a host task
   bool isHostTask() const {
@@ -913,6 +943,24 @@ public:
   std::shared_ptr<node_impl>
   add(const std::vector<std::shared_ptr<node_impl>> &Dep = {});
 
+  /// Create a memory allocation node in the graph. Only virtual address space
+  /// is reserved here, it is backed by device memory when the graph is
+  /// finalized.
+  /// @param[out] Ptr Set to the device address of the allocation.
+  /// @param Size Number of bytes to allocate.
+  /// @param Dep List of predecessor nodes.
+  /// @return Created node in the graph.
+  std::shared_ptr<node_impl>
+  addMemAlloc(void *&Ptr, size_t Size,
+              const std::vector<std::shared_ptr<node_impl>> &Dep);
+
+  /// Create a memory free node in the graph.
+  /// @param Ptr Device address returned for a memory allocation node.
+  /// @param Dep List of predecessor nodes.
+  /// @return Created node in the graph.
+  std::shared_ptr<node_impl>
+  addMemFree(void *Ptr, const std::vector<std::shared_ptr<node_impl>> &Dep);
+
   /// Create an empty node in the graph.
   /// @param Events List of events associated to this node.
   /// @return Created node in the graph.
@@ -1005,6 +1053,17 @@ public:
   /// than needing an expensive depth first search.
   std::vector<std::shared_ptr<node_impl>> MNodeStorage;
 
+  /// Virtual address range reserved for a memory allocation node.
+  struct MemAllocation {
+    uintptr_t Ptr;
+    size_t Size;
+    bool Freed;
+  };
+  /// Allocations of the memory allocation nodes of this graph.
+  std::vector<MemAllocation> MMemAllocations;
+  /// Set while an executable graph maps device memory to the allocations.
+  bool MMemAllocationsMapped = false;
+
   /// Find the last node added to this graph from an in-order queue.
   /// @param Queue In-order queue to find the last node added to the graph from.
   /// @return Last node in this graph added from \p Queue recording, or empty
@@ -1393,6 +1452,23 @@ private:
               ur_exp_command_buffer_handle_t CommandBuffer,
               std::shared_ptr<node_impl> Node);
 
+  /// Returns the queue used for allocation operations for accessors of the
+  /// nodes, creating it if needed.
+  /// @param Ctx Context to use.
+  /// @param DeviceImpl Device the allocations are made for.
+  /// @return Queue for the allocation operations.
+  const std::shared_ptr<sycl::detail::queue_impl> &
+  getAllocaQueue(sycl::context Ctx, sycl::detail::DeviceImplPtr DeviceImpl);
+
+  /// Returns the queue a partition is submitted to, creating internal
+  /// queues if needed.
+  /// @param Queue Queue the graph is submitted to.
+  /// @param Index Queue index of the partition.
+  /// @return Queue for the partition.
+  const std::shared_ptr<sycl::detail::queue_impl> &
+  getPartitionQueue(const std::shared_ptr<sycl::detail::queue_impl> &Queue,
+                    size_t Index);
+
   /// Enqueue a node directly to the command-buffer without going through the
   /// scheduler.
   /// @param Ctx Context to use.
@@ -1415,11 +1491,44 @@ private:
                     std::shared_ptr<node_impl> CurrentNode,
                     int ReferencePartitionNum);
 
+  /// Assigns the nodes to partitions and schedules them, creating the
+  /// partitions in MPartitions.
+  void computePartitions();
+
+  /// Creates a key identifying the topology of the graph and the kernels of
+  /// its nodes, used to look up the partitions in the persistent cache.
+  /// @return The key, empty if the graph cannot be cached.
+  std::string getPartitionsCacheKey() const;
+
+  /// Serializes the partitions as node indices into MNodeStorage.
+  /// @return Serialized partitions.
+  std::vector<char> serializePartitions() const;
+
+  /// Recreates the partitions from serialized data, leaving MPartitions
+  /// empty if the data doesn't match the nodes of the graph.
+  /// @param Data Data created by serializePartitions().
+  /// @return True if the partitions were restored.
+  bool deserializePartitions(const std::vector<char> &Data);
+
   /// Duplicate nodes from the modifiable graph associated with this executable
   /// graph and store them locally. Any subgraph nodes in the modifiable graph
   /// will be expanded and merged into this new set of nodes.
   void duplicateNodes();
 
+  /// Backs the memory allocation nodes of the graph with device memory. Two
+  /// allocations share memory when the free node of one is ordered before the
+  /// allocation node of the other.
+  void mapMemAllocations();
+
+  /// Removes edges implied by other paths of the graph, so that fewer sync
+  /// points have to be passed to the command-buffers.
+  void removeRedundantEdges();
+
+  /// Merges chains of USM copies or fills over contiguous memory into single
+  /// nodes. Only node pairs that are each other's only successor and
+  /// predecessor are merged, so the ordering with other nodes is preserved.
+  void coalesceMemoryOperations();
+
   /// Prints the contents of the graph to a text file in DOT format.
   /// @param FilePath Path to the output file.
   /// @param Verbose If true, print additional information about the nodes such
@@ -1473,6 +1582,8 @@ private:
   /// Storage for accessors which are used by this graph, accumulated from
   /// all nodes enqueued to the graph.
   std::vector<sycl::detail::AccessorImplPtr> MAccessors;
+  /// Queue used for allocation operations for accessors of the nodes.
+  std::shared_ptr<sycl::detail::queue_impl> MAllocaQueue;
   /// List of all execution events returned from command buffer enqueue calls.
   std::vector<sycl::detail::EventImplPtr> MExecutionEvents;
   /// List of the partitions that compose the exec graph.
@@ -1487,6 +1598,14 @@ private:
   bool MIsUpdatable;
   /// If true, the graph profiling is enabled.
   bool MEnableProfiling;
+  /// If true, independent partitions may run on internal queues.
+  bool MUseMultipleQueues;
+  /// Device memory shared by the memory allocation nodes of the graph.
+  std::unique_ptr<physical_mem> MMemArena;
+  /// Virtual address ranges mapped to MMemArena.
+  std::vector<std::pair<void *, size_t>> MMemMappings;
+  /// Internal queues for partitions with a non-zero queue index.
+  std::vector<std::shared_ptr<sycl::detail::queue_impl>> MPartitionQueues;
 
   // Stores a cache of node ids from modifiable graph nodes to the companion
   // node(s) in this graph. Used for quick access when updating this graph.
@@ -121,6 +121,7 @@ public:
 
   bool MKernelIsCooperative = false;
   bool MKernelUsesClusterLaunch = false;
+  bool MKernelSpecializesNDRange = false;
 
   // Extra information for bindless image copy
   ur_image_desc_t MSrcImageDesc = {};
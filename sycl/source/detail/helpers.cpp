@@ -37,6 +37,23 @@ markBufferAsInternal(const std::shared_ptr<buffer_impl> &BufImpl) {
   BufImpl->markAsInternal();
 }
 
+// Returns the LLVM IR image embedded for the target TargetSpec (via
+// -fsycl-embed-ir) which contains the kernel, nullptr if there is none.
+static RTDeviceBinaryImage *getEmbeddedIRImage(const char *KernelName,
+                                               const std::string &TargetSpec) {
+  auto KernelID = ProgramManager::getInstance().getSYCLKernelID(KernelName);
+  std::vector<kernel_id> KernelIds{KernelID};
+  auto DeviceImages =
+      ProgramManager::getInstance().getRawDeviceImages(KernelIds);
+  auto DeviceImage = std::find_if(
+      DeviceImages.begin(), DeviceImages.end(),
+      [&TargetSpec](RTDeviceBinaryImage *DI) {
+        return DI->getFormat() == SYCL_DEVICE_BINARY_TYPE_LLVMIR_BITCODE &&
+               DI->getRawData().DeviceTargetSpec == TargetSpec;
+      });
+  return DeviceImage == DeviceImages.end() ? nullptr : *DeviceImage;
+}
+
 std::tuple<const RTDeviceBinaryImage *, ur_program_handle_t>
 retrieveKernelBinary(const QueueImplPtr &Queue, const char *KernelName,
                      CGExecKernel *KernelCG) {
@@ -45,19 +62,9 @@ retrieveKernelBinary(const QueueImplPtr &Queue, const char *KernelName,
   bool isHIP =
       Queue->getDeviceImplPtr()->getBackend() == backend::ext_oneapi_hip;
   if (isNvidia || isHIP) {
-    auto KernelID = ProgramManager::getInstance().getSYCLKernelID(KernelName);
-    std::vector<kernel_id> KernelIds{KernelID};
-    auto DeviceImages =
-        ProgramManager::getInstance().getRawDeviceImages(KernelIds);
-    auto DeviceImage = std::find_if(
-        DeviceImages.begin(), DeviceImages.end(),
-        [isNvidia](RTDeviceBinaryImage *DI) {
-          const std::string &TargetSpec = isNvidia ? std::string("llvm_nvptx64")
-                                                   : std::string("llvm_amdgcn");
-          return DI->getFormat() == SYCL_DEVICE_BINARY_TYPE_LLVMIR_BITCODE &&
-                 DI->getRawData().DeviceTargetSpec == TargetSpec;
-        });
-    if (DeviceImage == DeviceImages.end()) {
+    RTDeviceBinaryImage *DeviceImage = getEmbeddedIRImage(
+        KernelName, isNvidia ? "llvm_nvptx64" : "llvm_amdgcn");
+    if (!DeviceImage) {
       return {nullptr, nullptr};
     }
     auto ContextImpl = Queue->getContextImplPtr();
@@ -65,9 +72,9 @@ retrieveKernelBinary(const QueueImplPtr &Queue, const char *KernelName,
     auto DeviceImpl = Queue->getDeviceImplPtr();
     auto Device = detail::createSyclObjFromImpl<device>(DeviceImpl);
     ur_program_handle_t Program =
-        detail::ProgramManager::getInstance().createURProgram(**DeviceImage,
+        detail::ProgramManager::getInstance().createURProgram(*DeviceImage,
                                                               Context, Device);
-    return {*DeviceImage, Program};
+    return {DeviceImage, Program};
   }
 
   const RTDeviceBinaryImage *DeviceImage = nullptr;
@@ -96,6 +103,19 @@ retrieveKernelBinary(const QueueImplPtr &Queue, const char *KernelName,
     Program = detail::ProgramManager::getInstance().createURProgram(
         *DeviceImage, Context, Device);
   }
+
+  // If the LLVM IR the SPIR-V image was translated from is embedded as well,
+  // hand it out instead so that the JIT compiler doesn't have to translate
+  // the SPIR-V back to LLVM IR. Both come from the same sycl-post-link output,
+  // so the program built from the SPIR-V still describes the kernel, e.g. its
+  // eliminated arguments.
+  if (DeviceImage &&
+      DeviceImage->getFormat() == SYCL_DEVICE_BINARY_TYPE_SPIRV) {
+    if (const RTDeviceBinaryImage *IRImage = getEmbeddedIRImage(
+            KernelName,
+            std::string("llvm_") + DeviceImage->getRawData().DeviceTargetSpec))
+      DeviceImage = IRImage;
+  }
   return {DeviceImage, Program};
 }
 
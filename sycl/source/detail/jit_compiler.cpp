@@ -9,12 +9,15 @@
 #if SYCL_EXT_JIT_ENABLE
 #include <KernelFusion.h>
 #include <detail/device_image_impl.hpp>
+#include <detail/global_handler.hpp>
 #include <detail/helpers.hpp>
 #include <detail/jit_compiler.hpp>
 #include <detail/kernel_bundle_impl.hpp>
 #include <detail/kernel_impl.hpp>
+#include <detail/persistent_device_code_cache.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/sycl_mem_obj_t.hpp>
+#include <detail/thread_pool.hpp>
 #include <sycl/detail/ur.hpp>
 #include <sycl/kernel_bundle.hpp>
 
@@ -401,6 +404,35 @@ detectIdenticalParameter(std::vector<Param> &Params, ArgDesc Arg) {
   return Params.end();
 }
 
+// Check whether the used arguments of the kernels to fuse are known not to
+// overlap unless they are identical, in which case they get merged into a
+// single parameter of the fused kernel. This only holds for accessors to
+// whole buffers, the memory USM pointers and streams point to is unknown.
+static bool argumentsMayOverlap(const ParamList &Params) {
+  std::unordered_map<SYCLMemObjI *, Requirement *> AccessedMemObjs;
+  for (const Param &P : Params) {
+    if (!P.Used) {
+      continue;
+    }
+    if (P.Arg.MType == kernel_param_kind_t::kind_pointer ||
+        P.Arg.MType == kernel_param_kind_t::kind_stream) {
+      return true;
+    }
+    if (P.Arg.MType != kernel_param_kind_t::kind_accessor) {
+      continue;
+    }
+    Requirement *Req = static_cast<Requirement *>(P.Arg.MPtr);
+    if (Req->MIsSubBuffer) {
+      return true;
+    }
+    auto [It, Inserted] = AccessedMemObjs.try_emplace(Req->MSYCLMemObj, Req);
+    if (!Inserted && !accessorEquals(Req, It->second)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 void *storePlainArgRaw(std::vector<std::vector<char>> &ArgStorage, void *ArgPtr,
                        size_t ArgSize) {
   ArgStorage.emplace_back(ArgSize);
@@ -611,10 +643,80 @@ updatePromotedArgs(const ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
   }
 }
 
+// Drops the arguments eliminated from the fused kernel, i.e., the unused ones,
+// the ones identical to another argument and the constant-propagated ones,
+// and numbers the remaining ones consecutively. The launches of the fused
+// kernel then set exactly the arguments of the kernel function, without a
+// mask of eliminated arguments to filter them.
+static void
+pruneEliminatedArgs(const ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
+                    std::vector<ArgDesc> &FusedArgs) {
+  auto &ArgUsageInfo = FusedKernelInfo.Args.UsageMask;
+  assert(ArgUsageInfo.size() == FusedArgs.size());
+  std::vector<ArgDesc> UsedArgs;
+  UsedArgs.reserve(FusedArgs.size());
+  for (size_t ArgIndex = 0; ArgIndex < ArgUsageInfo.size(); ++ArgIndex) {
+    if (!(ArgUsageInfo[ArgIndex] & ::jit_compiler::ArgUsage::Used)) {
+      continue;
+    }
+    const ArgDesc &Arg = FusedArgs[ArgIndex];
+    UsedArgs.emplace_back(Arg.MType, Arg.MPtr, Arg.MSize,
+                          static_cast<int>(UsedArgs.size()));
+  }
+  FusedArgs = std::move(UsedArgs);
+}
+
+// Returns the key of a kernel with materialized specialization constants in
+// the persistent device code cache. The key holds everything but the device
+// the JIT compilation depends on, the device is part of the cache path.
+static std::string
+getMaterializedKernelKey(const std::string &KernelName,
+                         const sycl_device_binary_struct &RawDeviceImage,
+                         const std::vector<unsigned char> &SpecConstBlob,
+                         const std::string &TargetCPU,
+                         const std::string &TargetFeatures) {
+  std::string Key;
+  auto Append = [&Key](const void *Data, size_t Size) {
+    Key.append(reinterpret_cast<const char *>(&Size), sizeof(Size));
+    Key.append(static_cast<const char *>(Data), Size);
+  };
+  Append(KernelName.data(), KernelName.size());
+  Append(TargetCPU.data(), TargetCPU.size());
+  Append(TargetFeatures.data(), TargetFeatures.size());
+  Append(SpecConstBlob.data(), SpecConstBlob.size());
+  Append(RawDeviceImage.BinaryStart,
+         RawDeviceImage.BinaryEnd - RawDeviceImage.BinaryStart);
+  return Key;
+}
+
+// Returns the key telling the materialized kernels apart: the values of the
+// specialization constants, followed by the ND-range for the kernels
+// specialized for it. The blobs of a kernel all have the same size, so the
+// keys cannot be confused.
+static std::vector<unsigned char>
+getMaterializationKey(const std::vector<unsigned char> &SpecConstBlob,
+                      const NDRDescT *SpecializedNDRange) {
+  std::vector<unsigned char> Key{SpecConstBlob};
+  if (!SpecializedNDRange)
+    return Key;
+  auto Append = [&Key](const auto &Value) {
+    const auto *Bytes = reinterpret_cast<const unsigned char *>(&Value);
+    Key.insert(Key.end(), Bytes, Bytes + sizeof(Value));
+  };
+  Append(SpecializedNDRange->Dims);
+  for (int I = 0; I < 3; ++I) {
+    Append(SpecializedNDRange->GlobalSize[I]);
+    Append(SpecializedNDRange->LocalSize[I]);
+    Append(SpecializedNDRange->GlobalOffset[I]);
+  }
+  return Key;
+}
+
 ur_kernel_handle_t jit_compiler::materializeSpecConstants(
     QueueImplPtr Queue, const RTDeviceBinaryImage *BinImage,
     const std::string &KernelName,
-    const std::vector<unsigned char> &SpecConstBlob) {
+    const std::vector<unsigned char> &SpecConstBlob,
+    const NDRDescT *SpecializedNDRange) {
   if (!BinImage) {
     throw sycl::exception(sycl::make_error_code(sycl::errc::invalid),
                           "No suitable IR available for materializing");
@@ -625,10 +727,36 @@ ur_kernel_handle_t jit_compiler::materializeSpecConstants(
         "Cannot jit kernel with invalid kernel function name");
   }
   auto &PM = detail::ProgramManager::getInstance();
+  const std::vector<unsigned char> MaterializationKey =
+      getMaterializationKey(SpecConstBlob, SpecializedNDRange);
   if (auto CachedKernel =
-          PM.getCachedMaterializedKernel(KernelName, SpecConstBlob))
+          PM.getCachedMaterializedKernel(KernelName, MaterializationKey))
     return CachedKernel;
 
+  const auto InFlightKey = std::make_pair(KernelName, MaterializationKey);
+  {
+    std::unique_lock<std::mutex> Lock{InFlightMaterializationsMutex};
+    InFlightMaterializationsCV.wait(Lock, [&]() {
+      return !InFlightMaterializations.count(InFlightKey);
+    });
+    // Another thread may have materialized the kernel while this one waited.
+    if (auto CachedKernel =
+            PM.getCachedMaterializedKernel(KernelName, MaterializationKey))
+      return CachedKernel;
+    InFlightMaterializations.insert(InFlightKey);
+  }
+  struct InFlightGuard {
+    jit_compiler &JIT;
+    const std::pair<std::string, std::vector<unsigned char>> &Key;
+    ~InFlightGuard() {
+      {
+        std::lock_guard<std::mutex> Lock{JIT.InFlightMaterializationsMutex};
+        JIT.InFlightMaterializations.erase(Key);
+      }
+      JIT.InFlightMaterializationsCV.notify_all();
+    }
+  } Guard{*this, InFlightKey};
+
   auto &RawDeviceImage = BinImage->getRawData();
   auto DeviceImageSize = static_cast<size_t>(RawDeviceImage.BinaryEnd -
                                              RawDeviceImage.BinaryStart);
@@ -642,6 +770,20 @@ ur_kernel_handle_t jit_compiler::materializeSpecConstants(
   ::jit_compiler::SYCLKernelBinaryInfo BinInfo{
       BinaryImageFormat, 0, RawDeviceImage.BinaryStart, DeviceImageSize};
 
+  std::optional<::jit_compiler::NDRange> NDR;
+  if (SpecializedNDRange) {
+    constexpr auto SYCLTypeToIndices = [](auto Val) -> ::jit_compiler::Indices {
+      return {Val.get(0), Val.get(1), Val.get(2)};
+    };
+    NDR.emplace(static_cast<int>(SpecializedNDRange->Dims),
+                SYCLTypeToIndices(SpecializedNDRange->GlobalSize),
+                SYCLTypeToIndices(SpecializedNDRange->LocalSize),
+                SYCLTypeToIndices(SpecializedNDRange->GlobalOffset));
+  }
+
+  // The configuration of the JIT library is per thread, another use of the
+  // library on this thread may have left options behind.
+  ResetConfigHandle();
   ::jit_compiler::TargetInfo TargetInfo = getTargetInfo(Queue);
   AddToConfigHandle(
       ::jit_compiler::option::JITTargetInfo::set(std::move(TargetInfo)));
@@ -661,25 +803,47 @@ ur_kernel_handle_t jit_compiler::materializeSpecConstants(
   AddToConfigHandle(
       ::jit_compiler::option::JITTargetFeatures::set(TargetFeaturesOpt));
 
-  auto MaterializerResult =
-      MaterializeSpecConstHandle(KernelName.c_str(), BinInfo, SpecConstBlob);
-  if (MaterializerResult.failed()) {
-    std::string Message{"Compilation for kernel failed with message:\n"};
-    Message.append(MaterializerResult.getErrorMessage());
-    if (DebugEnabled) {
-      std::cerr << Message << "\n";
+  // A previous run of the application may have materialized the kernel
+  // already, avoid the JIT compilation then.
+  const auto &Context = Queue->get_context();
+  const auto &Device = Queue->get_device();
+  const std::string CacheKey = getMaterializedKernelKey(
+      KernelName, RawDeviceImage, MaterializationKey,
+      detail::SYCLConfig<detail::SYCL_JIT_AMDGCN_PTX_TARGET_CPU>::get(),
+      detail::SYCLConfig<detail::SYCL_JIT_AMDGCN_PTX_TARGET_FEATURES>::get());
+  std::vector<char> MaterializedBinary =
+      PersistentDeviceCodeCache::getJITItemFromDisc(Device, CacheKey);
+  if (MaterializedBinary.empty()) {
+    auto MaterializerResult =
+        MaterializeSpecConstHandle(KernelName.c_str(), BinInfo, SpecConstBlob,
+                                   NDR ? &*NDR : nullptr);
+    if (MaterializerResult.failed()) {
+      std::string Message{"Compilation for kernel failed with message:\n"};
+      Message.append(MaterializerResult.getErrorMessage());
+      if (DebugEnabled) {
+        std::cerr << Message << "\n";
+      }
+      throw sycl::exception(sycl::make_error_code(sycl::errc::invalid),
+                            Message);
     }
-    throw sycl::exception(sycl::make_error_code(sycl::errc::invalid), Message);
+
+    auto &MaterializerKernelInfo = MaterializerResult.getKernelInfo();
+    const auto *BinaryStart = reinterpret_cast<const char *>(
+        MaterializerKernelInfo.BinaryInfo.BinaryStart);
+    MaterializedBinary.assign(BinaryStart,
+                              BinaryStart +
+                                  MaterializerKernelInfo.BinaryInfo.BinarySize);
+    PersistentDeviceCodeCache::putJITItemToDisc(Device, CacheKey,
+                                                MaterializedBinary);
   }
 
-  auto &MaterializerKernelInfo = MaterializerResult.getKernelInfo();
   sycl_device_binary_struct MaterializedRawDeviceImage{RawDeviceImage};
   MaterializedRawDeviceImage.BinaryStart =
-      MaterializerKernelInfo.BinaryInfo.BinaryStart;
+      reinterpret_cast<const unsigned char *>(MaterializedBinary.data());
   MaterializedRawDeviceImage.BinaryEnd =
-      MaterializerKernelInfo.BinaryInfo.BinaryStart +
-      MaterializerKernelInfo.BinaryInfo.BinarySize;
+      MaterializedRawDeviceImage.BinaryStart + MaterializedBinary.size();
 
+  std::lock_guard<std::mutex> Lock{JITMutex};
   const bool OrigCacheCfg = SYCLConfig<SYCL_CACHE_IN_MEM>::get();
   if (OrigCacheCfg) {
     if (0 != setenv("SYCL_CACHE_IN_MEM", "0", true)) {
@@ -691,10 +855,9 @@ ur_kernel_handle_t jit_compiler::materializeSpecConstants(
   }
 
   RTDeviceBinaryImage MaterializedRTDevBinImage{&MaterializedRawDeviceImage};
-  const auto &Context = Queue->get_context();
-  const auto &Device = Queue->get_device();
-  auto NewKernel = PM.getOrCreateMaterializedKernel(
-      MaterializedRTDevBinImage, Context, Device, KernelName, SpecConstBlob);
+  auto NewKernel =
+      PM.getOrCreateMaterializedKernel(MaterializedRTDevBinImage, Context,
+                                       Device, KernelName, MaterializationKey);
 
   if (OrigCacheCfg) {
     if (0 != setenv("SYCL_CACHE_IN_MEM", "1", true)) {
@@ -708,6 +871,43 @@ ur_kernel_handle_t jit_compiler::materializeSpecConstants(
   return NewKernel;
 }
 
+ur_kernel_handle_t jit_compiler::requestSpecConstMaterialization(
+    QueueImplPtr Queue, const RTDeviceBinaryImage *BinImage,
+    const std::string &KernelName,
+    const std::vector<unsigned char> &SpecConstBlob,
+    const NDRDescT *SpecializedNDRange) {
+  std::vector<unsigned char> MaterializationKey =
+      getMaterializationKey(SpecConstBlob, SpecializedNDRange);
+  if (auto CachedKernel =
+          detail::ProgramManager::getInstance().getCachedMaterializedKernel(
+              KernelName, MaterializationKey))
+    return CachedKernel;
+
+  {
+    std::lock_guard<std::mutex> Lock{MaterializationRequestsMutex};
+    if (!MaterializationRequests.emplace(KernelName, MaterializationKey)
+             .second)
+      return nullptr;
+  }
+
+  // The ND-range of the launch doesn't outlive it, keep a copy.
+  std::optional<NDRDescT> NDRange;
+  if (SpecializedNDRange)
+    NDRange = *SpecializedNDRange;
+  GlobalHandler::instance().getHostTaskThreadPool().submit(
+      [this, Queue, BinImage, KernelName, SpecConstBlob, NDRange]() {
+        try {
+          materializeSpecConstants(Queue, BinImage, KernelName, SpecConstBlob,
+                                   NDRange ? &*NDRange : nullptr);
+        } catch (std::exception &E) {
+          // The kernel keeps being launched without materialization.
+          printPerformanceWarning(
+              std::string("Background materialization failed: ") + E.what());
+        }
+      });
+  return nullptr;
+}
+
 std::unique_ptr<detail::CG>
 jit_compiler::fuseKernels(QueueImplPtr Queue,
                           std::vector<ExecCGCommand *> &InputKernels,
@@ -914,12 +1114,16 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
                              ParamIdentities);
   }
 
-  // Retrieve barrier flags.
+  // Retrieve barrier flags. The JIT compiler may only remove the barriers
+  // between the kernels if distinct parameters never refer to the same memory.
   ::jit_compiler::BarrierFlags BarrierFlags =
-      ::jit_compiler::getLocalAndGlobalBarrierFlag();
+      argumentsMayOverlap(FusedParams)
+          ? ::jit_compiler::getLocalAndGlobalBarrierFlag()
+          : ::jit_compiler::getElidableLocalAndGlobalBarrierFlag();
 
   static size_t FusedKernelNameIndex = 0;
   auto FusedKernelName = "fused_" + std::to_string(FusedKernelNameIndex++);
+  std::lock_guard<std::mutex> Lock{JITMutex};
   ResetConfigHandle();
   bool DebugEnabled =
       detail::SYCLConfig<detail::SYCL_RT_WARNING_LEVEL>::get() > 0;
@@ -927,6 +1131,8 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
       ::jit_compiler::option::JITEnableVerbose::set(DebugEnabled));
   AddToConfigHandle(::jit_compiler::option::JITEnableCaching::set(
       detail::SYCLConfig<detail::SYCL_ENABLE_FUSION_CACHING>::get()));
+  AddToConfigHandle(::jit_compiler::option::JITEnableFusionCostModel::set(
+      detail::SYCLConfig<detail::SYCL_JIT_FUSION_COST_MODEL>::get()));
 
   ::jit_compiler::TargetInfo TargetInfo = getTargetInfo(Queue);
   ::jit_compiler::BinaryFormat TargetFormat = TargetInfo.getFormat();
@@ -971,6 +1177,7 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
     return NDRDesc;
   }(FusedKernelInfo.NDR);
   updatePromotedArgs(FusedKernelInfo, NDRDesc, FusedArgs, ArgsStorage);
+  pruneEliminatedArgs(FusedKernelInfo, FusedArgs);
 
   if (!FusionResult.cached()) {
     auto PIDeviceBinaries = createPIDeviceBinary(FusedKernelInfo, TargetFormat);
@@ -997,7 +1204,8 @@ jit_compiler::fuseKernels(QueueImplPtr Queue,
       NDRDesc, nullptr, nullptr, std::move(KernelBundleImplPtr),
       std::move(CGData), std::move(FusedArgs), FusedOrCachedKernelName, {}, {},
       CGType::Kernel, KernelCacheConfig, false /* KernelIsCooperative */,
-      false /* KernelUsesClusterLaunch*/));
+      false /* KernelUsesClusterLaunch*/,
+      false /* KernelSpecializesNDRange */));
   return FusedCG;
 }
 
@@ -1039,20 +1247,8 @@ sycl_device_binaries jit_compiler::createPIDeviceBinary(
   OffloadEntryContainer Entry{FusedKernelName, nullptr, 0, 0, 0};
   Binary.addOffloadEntry(std::move(Entry));
 
-  // Create a property entry for the argument usage mask for the fused kernel.
-  auto ArgMask = encodeArgUsageMask(FusedKernelInfo.Args.UsageMask);
-  PropertyContainer ArgMaskProp{
-      FusedKernelName, ArgMask.data(), ArgMask.size(),
-      sycl_property_type::SYCL_PROPERTY_TYPE_BYTE_ARRAY};
-
-  // Create a property set for the argument usage masks of all kernels
-  // (currently only one).
-  PropertySetContainer ArgMaskPropSet{
-      __SYCL_PROPERTY_SET_KERNEL_PARAM_OPT_INFO};
-
-  ArgMaskPropSet.addProperty(std::move(ArgMaskProp));
-
-  Binary.addProperty(std::move(ArgMaskPropSet));
+  // The eliminated arguments are not part of the fused kernel command group,
+  // see pruneEliminatedArgs, so no argument usage mask is attached.
 
   if (Format == ::jit_compiler::BinaryFormat::PTX ||
       Format == ::jit_compiler::BinaryFormat::AMDGCN) {
@@ -1095,36 +1291,6 @@ sycl_device_binaries jit_compiler::createPIDeviceBinary(
   return JITDeviceBinaries.back().getPIDeviceStruct();
 }
 
-std::vector<uint8_t> jit_compiler::encodeArgUsageMask(
-    const ::jit_compiler::ArgUsageMask &Mask) const {
-  // This must match the decoding logic in program_manager.cpp.
-  constexpr uint64_t NBytesForSize = 8;
-  constexpr uint64_t NBitsInElement = 8;
-  uint64_t Size = static_cast<uint64_t>(Mask.size());
-  // Round the size to the next multiple of 8
-  uint64_t RoundedSize =
-      ((Size + (NBitsInElement - 1)) & (~(NBitsInElement - 1)));
-  std::vector<uint8_t> Encoded((RoundedSize / NBitsInElement) + NBytesForSize,
-                               0u);
-  // First encode the size of the actual mask
-  for (size_t i = 0; i < NBytesForSize; ++i) {
-    uint8_t Byte =
-        static_cast<uint8_t>((RoundedSize >> i * NBitsInElement) & 0xFF);
-    Encoded[i] = Byte;
-  }
-  // Encode the actual mask bit-wise
-  for (size_t i = 0; i < Size; ++i) {
-    // DPC++ internally uses 'true' to indicate that an argument has been
-    // eliminated, while the JIT compiler uses 'true' to indicate an argument
-    // is used. Translate this here.
-    if (!(Mask[i] & ::jit_compiler::ArgUsage::Used)) {
-      uint8_t &Byte = Encoded[NBytesForSize + (i / NBitsInElement)];
-      Byte |= static_cast<uint8_t>((1 << (i % NBitsInElement)));
-    }
-  }
-  return Encoded;
-}
-
 std::vector<uint8_t> jit_compiler::encodeReqdWorkGroupSize(
     const ::jit_compiler::SYCLKernelAttribute &Attr) const {
   assert(Attr.Kind ==
@@ -16,6 +16,9 @@
 #include <KernelFusion.h>
 #endif // SYCL_EXT_JIT_ENABLE
 
+#include <condition_variable>
+#include <mutex>
+#include <set>
 #include <unordered_map>
 
 namespace jit_compiler {
@@ -38,11 +41,24 @@ public:
   std::unique_ptr<detail::CG>
   fuseKernels(QueueImplPtr Queue, std::vector<ExecCGCommand *> &InputKernels,
               const property_list &);
+  /// Returns the kernel with materialized specialization constants. If
+  /// SpecializedNDRange is not null, the kernel is also specialized for that
+  /// ND-range.
   ur_kernel_handle_t
   materializeSpecConstants(QueueImplPtr Queue,
                            const RTDeviceBinaryImage *BinImage,
                            const std::string &KernelName,
-                           const std::vector<unsigned char> &SpecConstBlob);
+                           const std::vector<unsigned char> &SpecConstBlob,
+                           const NDRDescT *SpecializedNDRange = nullptr);
+
+  /// Returns the kernel with materialized specialization constants if it is
+  /// ready. Otherwise schedules its materialization on the host task thread
+  /// pool, unless it was scheduled already, and returns nullptr.
+  ur_kernel_handle_t requestSpecConstMaterialization(
+      QueueImplPtr Queue, const RTDeviceBinaryImage *BinImage,
+      const std::string &KernelName,
+      const std::vector<unsigned char> &SpecConstBlob,
+      const NDRDescT *SpecializedNDRange = nullptr);
 
   bool isAvailable() { return Available; }
 
@@ -63,9 +79,6 @@ private:
   createPIDeviceBinary(const ::jit_compiler::SYCLKernelInfo &FusedKernelInfo,
                        ::jit_compiler::BinaryFormat Format);
 
-  std::vector<uint8_t>
-  encodeArgUsageMask(const ::jit_compiler::ArgUsageMask &Mask) const;
-
   std::vector<uint8_t> encodeReqdWorkGroupSize(
       const ::jit_compiler::SYCLKernelAttribute &Attr) const;
 
@@ -75,6 +88,27 @@ private:
   // Manages the lifetime of the UR structs for device binaries.
   std::vector<DeviceBinariesCollection> JITDeviceBinaries;
 
+  // Serializes the fusion of kernels and the creation of the materialized
+  // kernels, which temporarily disables the in-memory cache through the
+  // environment. The JIT library itself compiles in a context and with a
+  // configuration of the calling thread.
+  std::mutex JITMutex;
+
+  // Kernels being materialized, keyed as MaterializationRequests. Different
+  // kernels are materialized in parallel, a thread materializing a kernel
+  // already being materialized waits for it instead.
+  std::mutex InFlightMaterializationsMutex;
+  std::condition_variable InFlightMaterializationsCV;
+  std::set<std::pair<std::string, std::vector<unsigned char>>>
+      InFlightMaterializations;
+
+  // Kernels whose materialization was requested from the background, keyed
+  // by kernel name and materialization key, see getMaterializationKey. Failed
+  // requests are kept so that they are not retried.
+  std::mutex MaterializationRequestsMutex;
+  std::set<std::pair<std::string, std::vector<unsigned char>>>
+      MaterializationRequests;
+
 #if SYCL_EXT_JIT_ENABLE
   // Handles to the entry points of the lazily loaded JIT library.
   using FuseKernelsFuncT = decltype(::jit_compiler::fuseKernels) *;
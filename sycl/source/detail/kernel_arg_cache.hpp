@@ -0,0 +1,71 @@
+//==----------- kernel_arg_cache.hpp - SYCL KernelArgCache -----------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/kernel_desc.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+// Values last set on the arguments of a shared kernel handle, so that the
+// launches of a kernel with the same arguments as the previous one don't set
+// them again. It is accessed under the mutex of the kernel. Only the values
+// set with urKernelSetArgValue and urKernelSetArgPointer are recorded: the
+// adapters may consume the other kinds of arguments at each launch.
+class KernelArgCache {
+public:
+  // Returns true if the argument Index was last set to the Size bytes at
+  // Value with an argument of kind Kind.
+  bool isSet(size_t Index, kernel_param_kind_t Kind, const void *Value,
+             size_t Size) const {
+    if (MDisabled.load(std::memory_order_relaxed) || Index >= MArgs.size())
+      return false;
+    const Arg &A = MArgs[Index];
+    return A.Kind == Kind && A.Bytes.size() == Size &&
+           std::memcmp(A.Bytes.data(), Value, Size) == 0;
+  }
+
+  // Records that the argument Index was set to the Size bytes at Value.
+  void set(size_t Index, kernel_param_kind_t Kind, const void *Value,
+           size_t Size) {
+    if (Index >= MArgs.size())
+      MArgs.resize(Index + 1);
+    Arg &A = MArgs[Index];
+    A.Kind = Kind;
+    const auto *Bytes = static_cast<const unsigned char *>(Value);
+    A.Bytes.assign(Bytes, Bytes + Size);
+  }
+
+  // Forgets the value of the argument Index, set by other means.
+  void reset(size_t Index) {
+    if (Index < MArgs.size())
+      MArgs[Index].Kind = kernel_param_kind_t::kind_invalid;
+  }
+
+  void clear() { MArgs.clear(); }
+
+  // Makes all the arguments be set at each launch, for the kernels whose
+  // native handle was exposed to the user.
+  void disable() { MDisabled.store(true, std::memory_order_relaxed); }
+
+private:
+  struct Arg {
+    kernel_param_kind_t Kind = kernel_param_kind_t::kind_invalid;
+    std::vector<unsigned char> Bytes;
+  };
+  std::vector<Arg> MArgs;
+  std::atomic<bool> MDisabled{false};
+};
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -444,7 +444,7 @@ public:
         const auto &SourceStr = std::get<std::string>(this->Source);
         return syclex::detail::SYCL_to_SPIRV(SourceStr, IncludePairs,
                                              BuildOptions, LogPtr,
-                                             RegisteredKernelNames);
+                                             RegisteredKernelNames, Devices[0]);
       }
       throw sycl::exception(
           make_error_code(errc::invalid),
@@ -632,14 +632,14 @@ public:
                             "The kernel bundle does not contain the kernel "
                             "identified by kernelId.");
 
-    auto [Kernel, CacheMutex, ArgMask] =
+    auto [Kernel, CacheMutex, ArgMask, ArgCache] =
         detail::ProgramManager::getInstance().getOrCreateKernel(
             MContext, KernelID.get_name(), /*PropList=*/{},
             SelectedImage->get_ur_program_ref());
 
     std::shared_ptr<kernel_impl> KernelImpl = std::make_shared<kernel_impl>(
         Kernel, detail::getSyclObjImpl(MContext), SelectedImage, Self, ArgMask,
-        SelectedImage->get_ur_program_ref(), CacheMutex);
+        SelectedImage->get_ur_program_ref(), CacheMutex, ArgCache);
 
     return detail::createSyclObjFromImpl<kernel>(KernelImpl);
   }
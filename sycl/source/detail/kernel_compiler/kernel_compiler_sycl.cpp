@@ -27,12 +27,14 @@ bool SYCL_Compilation_Available() { return false; }
 spirv_vec_t
 SYCL_to_SPIRV(const std::string &SYCLSource, include_pairs_t IncludePairs,
               const std::vector<std::string> &UserArgs, std::string *LogPtr,
-              const std::vector<std::string> &RegisteredKernelNames) {
+              const std::vector<std::string> &RegisteredKernelNames,
+              const sycl::device &CacheDevice) {
   (void)SYCLSource;
   (void)IncludePairs;
   (void)UserArgs;
   (void)LogPtr;
   (void)RegisteredKernelNames;
+  (void)CacheDevice;
   throw sycl::exception(sycl::errc::build,
                         "kernel_compiler does not support GCC<8");
 }
@@ -43,15 +45,18 @@ SYCL_to_SPIRV(const std::string &SYCLSource, include_pairs_t IncludePairs,
 
 #else
 
+#include <detail/persistent_device_code_cache.hpp>
 #include <sycl/detail/os_util.hpp>
 
 #include <ctime>
 #include <filesystem>
 #include <fstream>
+#include <mutex>
 #include <random>
 #include <regex>
 #include <sstream>
 #include <stdio.h>
+#include <unordered_map>
 
 namespace sycl {
 inline namespace _V1 {
@@ -280,16 +285,70 @@ spirv_vec_t loadSpvFromFile(const std::filesystem::path &FileName) {
   return Spv;
 }
 
+// The key identifies the compiler binary and holds all the inputs of the
+// compilation, each prefixed by its size to keep the key unambiguous.
+std::string
+getCompilationKey(const std::string &SYCLSource,
+                  const include_pairs_t &IncludePairs,
+                  const std::vector<std::string> &UserArgs,
+                  const std::vector<std::string> &RegisteredKernelNames) {
+  std::ostringstream Key;
+  auto Append = [&Key](const std::string &Part) {
+    Key << Part.size() << ':' << Part;
+  };
+
+  // A rebuilt compiler comes with rebuilt headers, tell them apart by the
+  // modification time of the compiler.
+  const std::filesystem::path CompilerPath = getCompilerPath();
+  std::error_code Error;
+  const auto CompilerTime =
+      std::filesystem::last_write_time(CompilerPath, Error);
+  Append(CompilerPath.string());
+  Append(std::to_string(CompilerTime.time_since_epoch().count()));
+
+  Key << UserArgs.size();
+  for (const std::string &Arg : UserArgs)
+    Append(Arg);
+  Key << IncludePairs.size();
+  for (const auto &[Name, Contents] : IncludePairs) {
+    Append(Name);
+    Append(Contents);
+  }
+  Key << RegisteredKernelNames.size();
+  for (const std::string &KernelName : RegisteredKernelNames)
+    Append(KernelName);
+  Append(SYCLSource);
+  return Key.str();
+}
+
+struct CachedCompilation {
+  spirv_vec_t Spv;
+  std::string Log;
+};
+
+// Compilations done by this process, keyed by getCompilationKey.
+struct InMemoryCompilationCache {
+  std::mutex Mutex;
+  std::unordered_map<std::string, CachedCompilation> Compilations;
+};
+
+InMemoryCompilationCache &getInMemoryCompilationCache() {
+  static InMemoryCompilationCache Cache;
+  return Cache;
+}
+
 spirv_vec_t
-SYCL_to_SPIRV(const std::string &SYCLSource, include_pairs_t IncludePairs,
-              const std::vector<std::string> &UserArgs, std::string *LogPtr,
-              const std::vector<std::string> &RegisteredKernelNames) {
+compileSYCLToSPIRV(const std::string &SYCLSource, include_pairs_t IncludePairs,
+                   const std::vector<std::string> &UserArgs,
+                   std::string *LogPtr,
+                   const std::vector<std::string> &RegisteredKernelNames,
+                   std::string &CompileLog) {
   // clang-format off
   const std::string id                   = generateSemiUniqueId();
   const std::filesystem::path ParentDir  = prepareWS(id);
   std::filesystem::path FilePath         = outputCpp(ParentDir, id, SYCLSource, UserArgs, RegisteredKernelNames);
                                            outputIncludeFiles(ParentDir, IncludePairs);
-  std::string CompileLog                 = invokeCompiler(FilePath, ParentDir, id, UserArgs, LogPtr);
+                       CompileLog        = invokeCompiler(FilePath, ParentDir, id, UserArgs, LogPtr);
   std::filesystem::path SpvPath          = findSpv(ParentDir, id, CompileLog);
   spirv_vec_t Spv                        = loadSpvFromFile(SpvPath);
                                            deleteWS(ParentDir);
@@ -297,6 +356,44 @@ SYCL_to_SPIRV(const std::string &SYCLSource, include_pairs_t IncludePairs,
   // clang-format on
 }
 
+spirv_vec_t
+SYCL_to_SPIRV(const std::string &SYCLSource, include_pairs_t IncludePairs,
+              const std::vector<std::string> &UserArgs, std::string *LogPtr,
+              const std::vector<std::string> &RegisteredKernelNames,
+              const sycl::device &CacheDevice) {
+  using sycl::detail::PersistentDeviceCodeCache;
+  const std::string Key = getCompilationKey(SYCLSource, IncludePairs, UserArgs,
+                                            RegisteredKernelNames);
+  InMemoryCompilationCache &Cache = getInMemoryCompilationCache();
+  {
+    std::lock_guard<std::mutex> Lock{Cache.Mutex};
+    auto It = Cache.Compilations.find(Key);
+    if (It != Cache.Compilations.end()) {
+      if (LogPtr != nullptr)
+        LogPtr->append(It->second.Log);
+      return It->second.Spv;
+    }
+  }
+
+  CachedCompilation Compilation;
+  std::vector<char> PersistedSpv =
+      PersistentDeviceCodeCache::getRTCItemFromDisc(CacheDevice, Key);
+  if (!PersistedSpv.empty()) {
+    Compilation.Spv.assign(PersistedSpv.begin(), PersistedSpv.end());
+  } else {
+    Compilation.Spv =
+        compileSYCLToSPIRV(SYCLSource, IncludePairs, UserArgs, LogPtr,
+                           RegisteredKernelNames, Compilation.Log);
+    PersistentDeviceCodeCache::putRTCItemToDisc(
+        CacheDevice, Key,
+        std::vector<char>(Compilation.Spv.begin(), Compilation.Spv.end()));
+  }
+
+  std::lock_guard<std::mutex> Lock{Cache.Mutex};
+  return Cache.Compilations.try_emplace(Key, std::move(Compilation))
+      .first->second.Spv;
+}
+
 bool SYCL_Compilation_Available() {
   // Is compiler on $PATH ? We try to invoke it.
   std::string id = generateSemiUniqueId();
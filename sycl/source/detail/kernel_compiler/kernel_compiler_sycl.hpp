@@ -24,10 +24,15 @@ namespace detail {
 using spirv_vec_t = std::vector<uint8_t>;
 using include_pairs_t = std::vector<std::pair<std::string, std::string>>;
 
+// Compilations are cached in memory and, if enabled, in the persistent
+// device code cache of CacheDevice. A cached compilation doesn't invoke the
+// compiler again, the log it appends is the one of the original compilation
+// or empty if it comes from the persistent cache.
 spirv_vec_t
 SYCL_to_SPIRV(const std::string &Source, include_pairs_t IncludePairs,
               const std::vector<std::string> &UserArgs, std::string *LogPtr,
-              const std::vector<std::string> &RegisteredKernelNames);
+              const std::vector<std::string> &RegisteredKernelNames,
+              const sycl::device &CacheDevice);
 
 bool SYCL_Compilation_Available();
 
@@ -48,11 +48,13 @@ kernel_impl::kernel_impl(ur_kernel_handle_t Kernel, ContextImplPtr ContextImpl,
                          DeviceImageImplPtr DeviceImageImpl,
                          KernelBundleImplPtr KernelBundleImpl,
                          const KernelArgMask *ArgMask,
-                         ur_program_handle_t Program, std::mutex *CacheMutex)
+                         ur_program_handle_t Program, std::mutex *CacheMutex,
+                         KernelArgCache *ArgCache)
     : MKernel(Kernel), MContext(std::move(ContextImpl)), MProgram(Program),
       MCreatedFromSource(false), MDeviceImageImpl(std::move(DeviceImageImpl)),
       MKernelBundleImpl(std::move(KernelBundleImpl)),
-      MKernelArgMaskPtr{ArgMask}, MCacheMutex{CacheMutex} {
+      MKernelArgMaskPtr{ArgMask}, MCacheMutex{CacheMutex},
+      MArgCache{ArgCache} {
   MIsInterop = MKernelBundleImpl->isInterop();
 }
 
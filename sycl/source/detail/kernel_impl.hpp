@@ -10,6 +10,7 @@
 
 #include <detail/context_impl.hpp>
 #include <detail/device_impl.hpp>
+#include <detail/kernel_arg_cache.hpp>
 #include <detail/kernel_arg_mask.hpp>
 #include <detail/kernel_info.hpp>
 #include <sycl/detail/common.hpp>
@@ -53,7 +54,7 @@ public:
               DeviceImageImplPtr DeviceImageImpl,
               KernelBundleImplPtr KernelBundleImpl,
               const KernelArgMask *ArgMask, ur_program_handle_t Program,
-              std::mutex *CacheMutex);
+              std::mutex *CacheMutex, KernelArgCache *ArgCache);
 
   // This section means the object is non-movable and non-copyable
   // There is no need of move and copy constructors in kernel_impl.
@@ -152,6 +153,10 @@ public:
   ur_native_handle_t getNative() const {
     const AdapterPtr &Adapter = MContext->getAdapter();
 
+    // The arguments may be set through the native handle.
+    if (MArgCache)
+      MArgCache->disable();
+
     if (MContext->getBackend() == backend::opencl)
       Adapter->call<UrApiKind::urKernelRetain>(MKernel);
 
@@ -174,6 +179,7 @@ public:
 
   const KernelArgMask *getKernelArgMask() const { return MKernelArgMaskPtr; }
   std::mutex *getCacheMutex() const { return MCacheMutex; }
+  KernelArgCache *getArgCache() const { return MArgCache; }
 
 private:
   ur_kernel_handle_t MKernel = nullptr;
@@ -186,6 +192,7 @@ private:
   std::mutex MNoncacheableEnqueueMutex;
   const KernelArgMask *MKernelArgMaskPtr;
   std::mutex *MCacheMutex = nullptr;
+  KernelArgCache *MArgCache = nullptr;
 
   bool isBuiltInKernel(const device &Device) const;
   void checkIfValidForNumArgsInfoQuery() const;
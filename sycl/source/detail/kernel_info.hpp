@@ -16,7 +16,9 @@
 #include <sycl/device.hpp>
 #include <sycl/info/info_desc.hpp>
 
+#include <algorithm>
 #include <type_traits>
+#include <vector>
 
 namespace sycl {
 inline namespace _V1 {
@@ -146,6 +148,54 @@ uint32_t get_kernel_device_specific_info_with_input(ur_kernel_handle_t Kernel,
 
   return Result;
 }
+
+/// Registers and spill memory of a kernel for a device, as reported by the
+/// backend compiler. The values are 0 if the backend doesn't report them.
+struct KernelResourceUsage {
+  uint32_t NumRegs = 0;
+  uint32_t SpillMemSize = 0;
+};
+
+inline KernelResourceUsage getKernelResourceUsage(ur_kernel_handle_t Kernel,
+                                                  ur_device_handle_t Device,
+                                                  const AdapterPtr &Adapter) {
+  KernelResourceUsage Usage;
+  Adapter->call_nocheck<UrApiKind::urKernelGetInfo>(
+      Kernel, UR_KERNEL_INFO_NUM_REGS, sizeof(uint32_t), &Usage.NumRegs,
+      nullptr);
+
+  // The spill sizes are reported for each device of the program of the
+  // kernel, in the order of UR_PROGRAM_INFO_DEVICES.
+  size_t SpillSizesSize = 0;
+  if (Adapter->call_nocheck<UrApiKind::urKernelGetInfo>(
+          Kernel, UR_KERNEL_INFO_SPILL_MEM_SIZE, 0, nullptr,
+          &SpillSizesSize) != UR_RESULT_SUCCESS ||
+      SpillSizesSize == 0)
+    return Usage;
+  std::vector<uint32_t> SpillSizes(SpillSizesSize / sizeof(uint32_t));
+  Adapter->call<UrApiKind::urKernelGetInfo>(Kernel,
+                                            UR_KERNEL_INFO_SPILL_MEM_SIZE,
+                                            SpillSizesSize, SpillSizes.data(),
+                                            nullptr);
+
+  ur_program_handle_t Program = nullptr;
+  Adapter->call<UrApiKind::urKernelGetInfo>(Kernel, UR_KERNEL_INFO_PROGRAM,
+                                            sizeof(ur_program_handle_t),
+                                            &Program, nullptr);
+  size_t DevicesSize = 0;
+  Adapter->call<UrApiKind::urProgramGetInfo>(Program, UR_PROGRAM_INFO_DEVICES,
+                                             0, nullptr, &DevicesSize);
+  std::vector<ur_device_handle_t> Devices(DevicesSize /
+                                          sizeof(ur_device_handle_t));
+  Adapter->call<UrApiKind::urProgramGetInfo>(Program, UR_PROGRAM_INFO_DEVICES,
+                                             DevicesSize, Devices.data(),
+                                             nullptr);
+  size_t Index = std::find(Devices.begin(), Devices.end(), Device) -
+                 Devices.begin();
+  if (Index < SpillSizes.size())
+    Usage.SpillMemSize = SpillSizes[Index];
+  return Usage;
+}
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
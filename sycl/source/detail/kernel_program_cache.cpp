@@ -7,15 +7,113 @@
 //===----------------------------------------------------------------------===//
 
 #include <detail/adapter.hpp>
+#include <detail/config.hpp>
 #include <detail/context_impl.hpp>
 #include <detail/kernel_program_cache.hpp>
 
+#include <iostream>
+
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
 const AdapterPtr &KernelProgramCache::getAdapter() {
   return MParentContext->getAdapter();
 }
+
+void KernelProgramCache::registerProgramUsage(ur_program_handle_t Program) {
+  const size_t Threshold =
+      SYCLConfig<SYCL_IN_MEM_CACHE_EVICTION_THRESHOLD>::get();
+  if (Threshold == 0 || !Program)
+    return;
+
+  auto LockedCache = acquireCachedPrograms();
+  ProgramCache &ProgCache = LockedCache.get();
+
+  auto [It, DidInsert] = ProgCache.Usage.try_emplace(Program, nullptr);
+  if (DidInsert) {
+    const AdapterPtr &Adapter = getAdapter();
+    uint32_t DeviceNum = 0;
+    Adapter->call<UrApiKind::urProgramGetInfo>(
+        Program, UR_PROGRAM_INFO_NUM_DEVICES, sizeof(DeviceNum), &DeviceNum,
+        nullptr);
+    std::vector<size_t> BinarySizes(DeviceNum);
+    Adapter->call<UrApiKind::urProgramGetInfo>(
+        Program, UR_PROGRAM_INFO_BINARY_SIZES,
+        sizeof(size_t) * BinarySizes.size(), BinarySizes.data(), nullptr);
+
+    It->second = std::make_shared<ProgramUsage>();
+    for (size_t Size : BinarySizes)
+      It->second->Size += Size;
+    ProgCache.TotalSize += It->second->Size;
+  }
+  It->second->touch();
+
+  while (ProgCache.TotalSize > Threshold && ProgCache.Usage.size() > 1) {
+    auto Victim = ProgCache.Usage.end();
+    for (auto UsageIt = ProgCache.Usage.begin();
+         UsageIt != ProgCache.Usage.end(); ++UsageIt) {
+      if (UsageIt->first == Program)
+        continue;
+      if (Victim == ProgCache.Usage.end() ||
+          UsageIt->second->LastUse.load(std::memory_order_relaxed) <
+              Victim->second->LastUse.load(std::memory_order_relaxed))
+        Victim = UsageIt;
+    }
+    evictProgram(ProgCache, Victim->first);
+  }
+}
+
+KernelProgramCache::ProgramUsagePtr
+KernelProgramCache::getProgramUsage(ur_program_handle_t Program) {
+  if (SYCLConfig<SYCL_IN_MEM_CACHE_EVICTION_THRESHOLD>::get() == 0)
+    return nullptr;
+  auto LockedCache = acquireCachedPrograms();
+  auto &Usage = LockedCache.get().Usage;
+  auto It = Usage.find(Program);
+  return It != Usage.end() ? It->second : nullptr;
+}
+
+// Removes every cache entry referring to Program. The UR handles are released
+// by the build result destructors once the last user drops them.
+void KernelProgramCache::evictProgram(ProgramCache &ProgCache,
+                                      ur_program_handle_t Program) {
+  if (SYCLConfig<SYCL_CACHE_TRACE>::get())
+    std::cerr << "[In-Memory Cache][Evict program] " << Program << "\n";
+
+  for (auto It = ProgCache.Cache.begin(); It != ProgCache.Cache.end();) {
+    if (It->second->Val != Program) {
+      ++It;
+      continue;
+    }
+    CommonProgramKeyT CommonKey =
+        std::make_pair(It->first.first.second, It->first.second);
+    auto [KeyBegin, KeyEnd] = ProgCache.KeyMap.equal_range(CommonKey);
+    for (auto KeyIt = KeyBegin; KeyIt != KeyEnd; ++KeyIt) {
+      if (KeyIt->second == It->first) {
+        ProgCache.KeyMap.erase(KeyIt);
+        break;
+      }
+    }
+    It = ProgCache.Cache.erase(It);
+  }
+
+  auto UsageIt = ProgCache.Usage.find(Program);
+  ProgCache.TotalSize -= UsageIt->second->Size;
+  ProgCache.Usage.erase(UsageIt);
+  ++ProgCache.Stats.Evictions;
+
+  {
+    std::lock_guard<std::mutex> Lock(MKernelsPerProgramCacheMutex);
+    MKernelsPerProgramCache.erase(Program);
+  }
+
+  for (KernelFastCacheShard &Shard : MKernelFastCacheShards) {
+    std::unique_lock<std::shared_mutex> Lock(Shard.Mutex);
+    ::boost::unordered::erase_if(Shard.Cache, [Program](const auto &Entry) {
+      return std::get<3>(Entry.second.Val) == Program;
+    });
+  }
+}
 } // namespace detail
 } // namespace _V1
 } // namespace sycl
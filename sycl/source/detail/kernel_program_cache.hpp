@@ -9,6 +9,7 @@
 #pragma once
 
 #include "sycl/exception.hpp"
+#include <detail/kernel_arg_cache.hpp>
 #include <detail/kernel_arg_mask.hpp>
 #include <detail/platform_impl.hpp>
 #include <sycl/detail/common.hpp>
@@ -17,9 +18,13 @@
 #include <sycl/detail/ur.hpp>
 #include <sycl/detail/util.hpp>
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
+#include <shared_mutex>
+#include <string_view>
 #include <type_traits>
 
 #include <boost/unordered/unordered_flat_map.hpp>
@@ -114,17 +119,77 @@ public:
   };
   using ProgramBuildResultPtr = std::shared_ptr<ProgramBuildResult>;
 
+  /// Specialization constant blob of a program cache key. Its hash is
+  /// computed once when the key is made, so that the lookups don't hash the
+  /// whole blob, and the blobs are only compared byte-wise when their hashes
+  /// match.
+  class SpecConstBlobKey {
+  public:
+    SpecConstBlobKey(SerializedObj Blob)
+        : MBlob(std::move(Blob)),
+          MHash(std::hash<std::string_view>{}(std::string_view(
+              reinterpret_cast<const char *>(MBlob.data()), MBlob.size()))) {}
+
+    const SerializedObj &getBlob() const { return MBlob; }
+
+    bool operator==(const SpecConstBlobKey &Other) const {
+      return MHash == Other.MHash && MBlob == Other.MBlob;
+    }
+    bool operator!=(const SpecConstBlobKey &Other) const {
+      return !(*this == Other);
+    }
+
+    friend size_t hash_value(const SpecConstBlobKey &Key) { return Key.MHash; }
+
+  private:
+    SerializedObj MBlob;
+    size_t MHash;
+  };
+
   /* Drop LinkOptions and CompileOptions from CacheKey since they are only used
    * when debugging environment variables are set and we can just ignore them
    * since all kernels will have their build options overridden with the same
    * string*/
   using ProgramCacheKeyT =
-      std::pair<std::pair<SerializedObj, std::uintptr_t>, ur_device_handle_t>;
+      std::pair<std::pair<SpecConstBlobKey, std::uintptr_t>,
+                ur_device_handle_t>;
   using CommonProgramKeyT = std::pair<std::uintptr_t, ur_device_handle_t>;
 
+  /// Usage information of a built program, used to pick the least recently
+  /// used programs for eviction when SYCL_IN_MEM_CACHE_EVICTION_THRESHOLD is
+  /// set.
+  struct ProgramUsage {
+    /// Total size of the program binaries in bytes.
+    size_t Size = 0;
+    /// Time of the last use of the program in milliseconds. The value is only
+    /// updated when it changes so that hot programs do not bounce the cache
+    /// line between submitting threads.
+    std::atomic<int64_t> LastUse{0};
+
+    void touch() {
+      int64_t Now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch())
+                        .count();
+      if (LastUse.load(std::memory_order_relaxed) != Now)
+        LastUse.store(Now, std::memory_order_relaxed);
+    }
+  };
+  using ProgramUsagePtr = std::shared_ptr<ProgramUsage>;
+
+  /// Counters of the in-memory program cache.
+  struct ProgramCacheStats {
+    size_t Hits = 0;
+    size_t Misses = 0;
+    size_t Evictions = 0;
+  };
+
   struct ProgramCache {
     ::boost::unordered_map<ProgramCacheKeyT, ProgramBuildResultPtr> Cache;
     ::boost::unordered_multimap<CommonProgramKeyT, ProgramCacheKeyT> KeyMap;
+    // Only populated when eviction is enabled.
+    ::boost::unordered_map<ur_program_handle_t, ProgramUsagePtr> Usage;
+    size_t TotalSize = 0;
+    ProgramCacheStats Stats;
 
     size_t size() const noexcept { return Cache.size(); }
   };
@@ -135,6 +200,8 @@ public:
       std::pair<ur_kernel_handle_t, const KernelArgMask *>;
   struct KernelBuildResult : public BuildResult<KernelArgMaskPairT> {
     AdapterPtr Adapter;
+    // Arguments set on the kernel, guarded by MBuildResultMutex.
+    KernelArgCache MArgCache;
     KernelBuildResult(const AdapterPtr &Adapter) : Adapter(Adapter) {
       Val.first = nullptr;
     }
@@ -161,14 +228,33 @@ public:
       std::tuple<SerializedObj, ur_device_handle_t, std::string, std::string>;
   using KernelFastCacheValT =
       std::tuple<ur_kernel_handle_t, std::mutex *, const KernelArgMask *,
-                 ur_program_handle_t>;
+                 ur_program_handle_t, KernelArgCache *>;
   // This container is used as a fast path for retrieving cached kernels.
   // unordered_flat_map is used here to reduce lookup overhead.
   // The slow path is used only once for each newly created kernel, so the
   // higher overhead of insertion that comes with unordered_flat_map is more
   // of an issue there. For that reason, those use regular unordered maps.
+  struct KernelFastCacheEntry {
+    KernelFastCacheValT Val;
+    // Usage of the program the kernel belongs to, null if eviction is
+    // disabled.
+    ProgramUsagePtr Usage;
+  };
   using KernelFastCacheT =
-      ::boost::unordered_flat_map<KernelFastCacheKeyT, KernelFastCacheValT>;
+      ::boost::unordered_flat_map<KernelFastCacheKeyT, KernelFastCacheEntry>;
+
+  // The fast cache is split into independently locked shards, so that lookups
+  // of already built kernels from different host threads do not serialize on
+  // a single mutex. Lookups only take a shared lock on their shard; exclusive
+  // access is needed only when a newly built kernel is saved.
+  static constexpr size_t KernelFastCacheShardCount = 16;
+  static_assert((KernelFastCacheShardCount & (KernelFastCacheShardCount - 1)) ==
+                    0,
+                "Shard count must be a power of two");
+  struct KernelFastCacheShard {
+    std::shared_mutex Mutex;
+    KernelFastCacheT Cache;
+  };
 
   ~KernelProgramCache() = default;
 
@@ -188,11 +274,14 @@ public:
     auto &ProgCache = LockedCache.get();
     auto [It, DidInsert] = ProgCache.Cache.try_emplace(CacheKey, nullptr);
     if (DidInsert) {
+      ++ProgCache.Stats.Misses;
       It->second = std::make_shared<ProgramBuildResult>(getAdapter());
       // Save reference between the common key and the full key.
       CommonProgramKeyT CommonKey =
           std::make_pair(CacheKey.first.second, CacheKey.second);
       ProgCache.KeyMap.emplace(CommonKey, CacheKey);
+    } else {
+      ++ProgCache.Stats.Hits;
     }
     return std::make_pair(It->second, DidInsert);
   }
@@ -232,20 +321,39 @@ public:
 
   template <typename KeyT>
   KernelFastCacheValT tryToGetKernelFast(KeyT &&CacheKey) {
-    std::unique_lock<std::mutex> Lock(MKernelFastCacheMutex);
-    auto It = MKernelFastCache.find(CacheKey);
-    if (It != MKernelFastCache.end()) {
-      return It->second;
+    KernelFastCacheShard &Shard = getKernelFastCacheShard(CacheKey);
+    std::shared_lock<std::shared_mutex> Lock(Shard.Mutex);
+    auto It = Shard.Cache.find(CacheKey);
+    if (It != Shard.Cache.end()) {
+      if (It->second.Usage)
+        It->second.Usage->touch();
+      return It->second.Val;
     }
-    return std::make_tuple(nullptr, nullptr, nullptr, nullptr);
+    return std::make_tuple(nullptr, nullptr, nullptr, nullptr, nullptr);
   }
 
   template <typename KeyT, typename ValT>
   void saveKernel(KeyT &&CacheKey, ValT &&CacheVal) {
-    std::unique_lock<std::mutex> Lock(MKernelFastCacheMutex);
+    // Must be looked up before the shard is locked, eviction locks the
+    // program cache first and the shards after it.
+    ProgramUsagePtr Usage = getProgramUsage(std::get<3>(CacheVal));
+    KernelFastCacheShard &Shard = getKernelFastCacheShard(CacheKey);
+    std::unique_lock<std::shared_mutex> Lock(Shard.Mutex);
     // if no insertion took place, thus some other thread has already inserted
     // smth in the cache
-    MKernelFastCache.emplace(CacheKey, CacheVal);
+    Shard.Cache.emplace(CacheKey,
+                        KernelFastCacheEntry{CacheVal, std::move(Usage)});
+  }
+
+  /// Accounts a built program towards the eviction threshold and marks it as
+  /// used, then evicts least recently used programs until the cache fits in
+  /// the threshold again. The program itself is never evicted by this call.
+  ///
+  /// Does nothing unless SYCL_IN_MEM_CACHE_EVICTION_THRESHOLD is set.
+  void registerProgramUsage(ur_program_handle_t Program);
+
+  ProgramCacheStats getProgramCacheStats() {
+    return acquireCachedPrograms().get().Stats;
   }
 
   /// Clears cache state.
@@ -254,10 +362,12 @@ public:
   void reset() {
     std::lock_guard<std::mutex> L1(MProgramCacheMutex);
     std::lock_guard<std::mutex> L2(MKernelsPerProgramCacheMutex);
-    std::lock_guard<std::mutex> L3(MKernelFastCacheMutex);
     MCachedPrograms = ProgramCache{};
     MKernelsPerProgramCache = KernelCacheT{};
-    MKernelFastCache = KernelFastCacheT{};
+    for (KernelFastCacheShard &Shard : MKernelFastCacheShards) {
+      std::unique_lock<std::shared_mutex> Lock(Shard.Mutex);
+      Shard.Cache = KernelFastCacheT{};
+    }
   }
 
   /// Try to fetch entity (kernel or program) from cache. If there is no such
@@ -353,10 +463,23 @@ private:
   KernelCacheT MKernelsPerProgramCache;
   ContextPtr MParentContext;
 
-  std::mutex MKernelFastCacheMutex;
-  KernelFastCacheT MKernelFastCache;
+  std::array<KernelFastCacheShard, KernelFastCacheShardCount>
+      MKernelFastCacheShards;
   friend class ::MockKernelProgramCache;
 
+  ProgramUsagePtr getProgramUsage(ur_program_handle_t Program);
+  void evictProgram(ProgramCache &ProgCache, ur_program_handle_t Program);
+
+  KernelFastCacheShard &
+  getKernelFastCacheShard(const KernelFastCacheKeyT &CacheKey) {
+    // Only the device and the kernel name are used to pick a shard: they are
+    // cheap to hash and already spread kernels well across shards.
+    size_t Hash = std::hash<std::string>{}(std::get<3>(CacheKey));
+    Hash ^= std::hash<ur_device_handle_t>{}(std::get<1>(CacheKey)) +
+            0x9e3779b9 + (Hash << 6) + (Hash >> 2);
+    return MKernelFastCacheShards[Hash & (KernelFastCacheShardCount - 1)];
+  }
+
   const AdapterPtr &getAdapter();
 };
 } // namespace detail
@@ -7,11 +7,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "ur_api.h"
+#include <detail/config.hpp>
 #include <detail/context_impl.hpp>
 #include <detail/device_image_impl.hpp>
 #include <detail/event_impl.hpp>
 #include <detail/mem_alloc_helper.hpp>
 #include <detail/memory_manager.hpp>
+#include <detail/memory_telemetry.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/ur_utils.hpp>
 #include <detail/xpti_registry.hpp>
@@ -177,7 +179,7 @@ void memReleaseHelper(const AdapterPtr &Adapter, ur_mem_handle_t Mem) {
   uintptr_t MemObjID = (uintptr_t)(Mem);
   uintptr_t Ptr = 0;
   // Do not make unnecessary UR calls without instrumentation enabled
-  if (xptiTraceEnabled()) {
+  if (xpti::framework::trace_enabled()) {
     ur_native_handle_t PtrHandle = 0;
     // When doing buffer interop we don't know what device the memory should be
     // resident on, so pass nullptr for Device param. Buffer interop may not be
@@ -410,6 +412,8 @@ void *MemoryManager::allocateMemBuffer(ContextImplPtr TargetContext,
     MemPtr = allocateBufferObject(TargetContext, UserPtr, HostPtrReadOnly, Size,
                                   PropsList);
   XPTIRegistry::bufferAssociateNotification(MemObj, MemPtr);
+  if (TargetContext && MemoryTelemetry::isEnabled())
+    MemoryTelemetry::instance().recordBufferAlloc(MemObj, Size);
   return MemPtr;
 }
 
@@ -494,6 +498,71 @@ void prepTermPositions(TermPositions &pos, int Dimensions,
   }
 }
 
+// Writes Size bytes of pageable host memory to a buffer through pinned
+// staging buffers of the context. Two chunks are in flight at a time, so that
+// copying a chunk to a staging buffer overlaps with the transfer of the
+// previous one. The host data is read before returning, so this is only done
+// when the write has no dependencies.
+// Returns false if the write should be done directly instead.
+static bool copyH2DStaged(const QueueImplPtr &TgtQueue, const char *SrcMem,
+                          ur_mem_handle_t DstMem, size_t DstOffset,
+                          size_t Size, ur_event_handle_t &OutEvent,
+                          const detail::EventImplPtr &OutEventImpl) {
+  const size_t ChunkSize = SYCLConfig<SYCL_STAGING_CHUNK_SIZE>::get();
+  if (ChunkSize == 0 || Size < 2 * ChunkSize)
+    return false;
+
+  const ContextImplPtr &Context = TgtQueue->getContextImplPtr();
+  const AdapterPtr &Adapter = TgtQueue->getAdapter();
+  // Devices sharing memory with the host don't gain anything from an extra
+  // copy, and USM host memory is already pinned.
+  if (TgtQueue->getDeviceImplPtr()
+          ->get_info<info::device::host_unified_memory>())
+    return false;
+  ur_usm_type_t SrcType = UR_USM_TYPE_UNKNOWN;
+  if (Adapter->call_nocheck<UrApiKind::urUSMGetMemAllocInfo>(
+          Context->getHandleRef(), SrcMem, UR_USM_ALLOC_INFO_TYPE,
+          sizeof(SrcType), &SrcType, nullptr) == UR_RESULT_SUCCESS &&
+      SrcType != UR_USM_TYPE_UNKNOWN)
+    return false;
+
+  StagingBufferPool &Pool = Context->getStagingBufferPool();
+  void *Staging[2] = {Pool.acquire(ChunkSize), Pool.acquire(ChunkSize)};
+  if (!Staging[0] || !Staging[1]) {
+    for (void *Ptr : Staging)
+      if (Ptr)
+        Pool.recycle(Ptr, ChunkSize, nullptr);
+    return false;
+  }
+
+  const ur_queue_handle_t Queue = TgtQueue->getHandleRef();
+  if (OutEventImpl != nullptr)
+    OutEventImpl->setHostEnqueueTime();
+
+  ur_event_handle_t LastEvents[2] = {nullptr, nullptr};
+  std::vector<ur_event_handle_t> ChunkEvents;
+  for (size_t Offset = 0, I = 0; Offset < Size; Offset += ChunkSize, ++I) {
+    const size_t Buf = I % 2;
+    const size_t Len = std::min(ChunkSize, Size - Offset);
+    if (LastEvents[Buf])
+      Adapter->call<UrApiKind::urEventWait>(1, &LastEvents[Buf]);
+    std::memcpy(Staging[Buf], SrcMem + Offset, Len);
+    Adapter->call<UrApiKind::urEnqueueMemBufferWrite>(
+        Queue, DstMem,
+        /*blocking_write=*/false, DstOffset + Offset, Len, Staging[Buf], 0,
+        nullptr, &LastEvents[Buf]);
+    ChunkEvents.push_back(LastEvents[Buf]);
+  }
+  Adapter->call<UrApiKind::urEnqueueEventsWait>(
+      Queue, ChunkEvents.size(), ChunkEvents.data(), &OutEvent);
+
+  for (size_t Buf = 0; Buf < 2; ++Buf)
+    Pool.recycle(Staging[Buf], ChunkSize, LastEvents[Buf]);
+  for (ur_event_handle_t Event : ChunkEvents)
+    Adapter->call<UrApiKind::urEventRelease>(Event);
+  return true;
+}
+
 void copyH2D(SYCLMemObjI *SYCLMemObj, char *SrcMem, QueueImplPtr,
              unsigned int DimSrc, sycl::range<3> SrcSize,
              sycl::range<3> SrcAccessRange, sycl::id<3> SrcOffset,
@@ -523,6 +592,10 @@ void copyH2D(SYCLMemObjI *SYCLMemObj, char *SrcMem, QueueImplPtr,
 
   if (MemType == detail::SYCLMemObjI::MemObjType::Buffer) {
     if (1 == DimDst && 1 == DimSrc) {
+      if (DepEvents.empty() &&
+          copyH2DStaged(TgtQueue, SrcMem + SrcXOffBytes, DstMem, DstXOffBytes,
+                        DstAccessRangeWidthBytes, OutEvent, OutEventImpl))
+        return;
       if (OutEventImpl != nullptr)
         OutEventImpl->setHostEnqueueTime();
       Adapter->call<UrApiKind::urEnqueueMemBufferWrite>(
@@ -767,6 +840,12 @@ void MemoryManager::copy(
     sycl::range<3> DstAccessRange, sycl::id<3> DstOffset,
     unsigned int DstElemSize, std::vector<ur_event_handle_t> DepEvents,
     ur_event_handle_t &OutEvent, const detail::EventImplPtr &OutEventImpl) {
+  MemoryTelemetry::TimePoint TelemetryStart = MemoryTelemetry::now();
+  MemoryTelemetry::Direction TelemetryDir =
+      SrcQueue ? (TgtQueue ? MemoryTelemetry::Direction::DeviceToDevice
+                           : MemoryTelemetry::Direction::DeviceToHost)
+               : (TgtQueue ? MemoryTelemetry::Direction::HostToDevice
+                           : MemoryTelemetry::Direction::HostToHost);
 
   if (!SrcQueue) {
     if (!TgtQueue)
@@ -794,6 +873,12 @@ void MemoryManager::copy(
               std::move(TgtQueue), DimDst, DstSize, DstAccessRange, DstOffset,
               DstElemSize, std::move(DepEvents), OutEvent, OutEventImpl);
   }
+
+  if (MemoryTelemetry::isEnabled())
+    MemoryTelemetry::instance().recordBufferCopy(
+        SYCLMemObj, TelemetryDir,
+        SrcAccessRange[0] * SrcAccessRange[1] * SrcAccessRange[2] * SrcElemSize,
+        TelemetryStart);
 }
 
 void MemoryManager::fill(SYCLMemObjI *SYCLMemObj, void *Mem, QueueImplPtr Queue,
@@ -928,6 +1013,7 @@ void MemoryManager::copy_usm(const void *SrcMem, QueueImplPtr SrcQueue,
     throw exception(make_error_code(errc::invalid),
                     "NULL pointer argument in memory copy operation.");
 
+  MemoryTelemetry::TimePoint TelemetryStart = MemoryTelemetry::now();
   const AdapterPtr &Adapter = SrcQueue->getAdapter();
   if (OutEventImpl != nullptr)
     OutEventImpl->setHostEnqueueTime();
@@ -935,6 +1021,9 @@ void MemoryManager::copy_usm(const void *SrcMem, QueueImplPtr SrcQueue,
                                                /* blocking */ false, DstMem,
                                                SrcMem, Len, DepEvents.size(),
                                                DepEvents.data(), OutEvent);
+  if (MemoryTelemetry::isEnabled())
+    MemoryTelemetry::instance().recordUSMCopy(SrcMem, DstMem, Len,
+                                              TelemetryStart);
 }
 
 void MemoryManager::fill_usm(void *Mem, QueueImplPtr Queue, size_t Length,
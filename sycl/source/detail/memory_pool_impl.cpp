@@ -0,0 +1,192 @@
+//==------- memory_pool_impl.cpp - SYCL asynchronous USM memory pool -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/context_impl.hpp>
+#include <detail/device_impl.hpp>
+#include <detail/event_impl.hpp>
+#include <detail/memory_pool_impl.hpp>
+#include <detail/queue_impl.hpp>
+#include <sycl/exception.hpp>
+
+#include <algorithm>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+memory_pool_impl::memory_pool_impl(
+    context_impl &ContextImpl, const std::shared_ptr<device_impl> &DeviceImpl,
+    std::shared_ptr<context_impl> ContextOwner)
+    : MContextImpl(ContextImpl), MDeviceImpl(DeviceImpl),
+      MContextOwner(std::move(ContextOwner)) {
+  if (!MDeviceImpl->has(aspect::usm_device_allocations)) {
+    throw sycl::exception(sycl::errc::feature_not_supported,
+                          "Device does not support USM device allocations!");
+  }
+
+  // Adapters without pool support allocate from the default pool of the
+  // context, blocks are still cached by this pool.
+  ur_usm_pool_desc_t PoolDesc{};
+  PoolDesc.stype = UR_STRUCTURE_TYPE_USM_POOL_DESC;
+  ur_result_t Error =
+      MContextImpl.getAdapter()->call_nocheck<UrApiKind::urUSMPoolCreate>(
+          MContextImpl.getHandleRef(), &PoolDesc, &MPool);
+  if (Error != UR_RESULT_SUCCESS)
+    MPool = nullptr;
+
+  MContextImpl.registerMemoryPool(this);
+}
+
+memory_pool_impl::~memory_pool_impl() {
+  try {
+    MContextImpl.unregisterMemoryPool(this);
+    for (FreeBlock &Block : MFreeBlocks) {
+      if (Block.Event)
+        Block.Event->wait(Block.Event);
+      freeToDevice(Block.Ptr);
+    }
+    for (const auto &[Ptr, Size] : MUsedBlocks)
+      freeToDevice(Ptr);
+    if (MPool)
+      MContextImpl.getAdapter()->call<UrApiKind::urUSMPoolRelease>(MPool);
+  } catch (std::exception &e) {
+    __SYCL_REPORT_EXCEPTION_TO_STREAM("exception in ~memory_pool_impl", e);
+  }
+}
+
+void *memory_pool_impl::allocate(const std::shared_ptr<queue_impl> &Queue,
+                                 size_t Size) {
+  if (Size == 0)
+    return nullptr;
+  const size_t BlockSize =
+      (Size + MinBlockSize - 1) / MinBlockSize * MinBlockSize;
+
+  std::unique_lock<std::mutex> Lock(MMutex);
+  // Best fit, not wasting more than half of the block.
+  auto Best = MFreeBlocks.end();
+  for (auto It = MFreeBlocks.begin(); It != MFreeBlocks.end(); ++It) {
+    if (It->Size >= BlockSize && It->Size / 2 <= BlockSize &&
+        (Best == MFreeBlocks.end() || It->Size < Best->Size))
+      Best = It;
+  }
+
+  if (Best != MFreeBlocks.end()) {
+    FreeBlock Block = std::move(*Best);
+    MFreeBlocks.erase(Best);
+    MUsedBlocks.emplace(Block.Ptr, Block.Size);
+    MUsedSize += Block.Size;
+    Lock.unlock();
+
+    // Work submitted to an in-order queue is ordered after the work which
+    // used the block on that queue.
+    bool IsOrdered = Queue->isInOrder() && Block.Queue.lock() == Queue;
+    if (!IsOrdered && Block.Event && !Block.Event->isCompleted()) {
+      createSyclObjFromImpl<queue>(Queue).ext_oneapi_submit_barrier(
+          {createSyclObjFromImpl<event>(Block.Event)});
+    }
+    return Block.Ptr;
+  }
+
+  void *Ptr = allocateFromDevice(BlockSize);
+  if (!Ptr) {
+    // Give the memory of the blocks which are no longer in use back to the
+    // device and retry.
+    trimToLocked(0);
+    Ptr = allocateFromDevice(BlockSize);
+  }
+  if (!Ptr) {
+    throw sycl::exception(sycl::make_error_code(errc::memory_allocation),
+                          "Failed to allocate device memory for the pool");
+  }
+  MUsedBlocks.emplace(Ptr, BlockSize);
+  MReservedSize += BlockSize;
+  MUsedSize += BlockSize;
+  return Ptr;
+}
+
+bool memory_pool_impl::deallocate(const std::shared_ptr<queue_impl> &Queue,
+                                  void *Ptr) {
+  size_t Size = 0;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    auto It = MUsedBlocks.find(Ptr);
+    if (It == MUsedBlocks.end())
+      return false;
+    Size = It->second;
+    MUsedBlocks.erase(It);
+    MUsedSize -= Size;
+  }
+
+  // Work submitted to the queue so far may still use the memory.
+  event LastEvent = Queue->isInOrder()
+                        ? Queue->getLastEvent(Queue)
+                        : createSyclObjFromImpl<queue>(Queue)
+                              .ext_oneapi_submit_barrier();
+  std::shared_ptr<event_impl> Event = getSyclObjImpl(LastEvent);
+  if (Event->isDiscarded()) {
+    // There is nothing to wait on later.
+    Queue->wait();
+    Event = nullptr;
+  }
+
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MFreeBlocks.push_back({Ptr, Size, Queue, std::move(Event)});
+  return true;
+}
+
+bool memory_pool_impl::owns(void *Ptr) const {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  return MUsedBlocks.count(Ptr) != 0;
+}
+
+void memory_pool_impl::trimTo(size_t MinBytesToKeep) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  trimToLocked(MinBytesToKeep);
+}
+
+void memory_pool_impl::trimToLocked(size_t MinBytesToKeep) {
+  auto NewEnd = std::remove_if(
+      MFreeBlocks.begin(), MFreeBlocks.end(), [&](FreeBlock &Block) {
+        if (MReservedSize <= MinBytesToKeep ||
+            (Block.Event && !Block.Event->isCompleted()))
+          return false;
+        freeToDevice(Block.Ptr);
+        MReservedSize -= Block.Size;
+        return true;
+      });
+  MFreeBlocks.erase(NewEnd, MFreeBlocks.end());
+}
+
+size_t memory_pool_impl::getReservedSize() const {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  return MReservedSize;
+}
+
+size_t memory_pool_impl::getUsedSize() const {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  return MUsedSize;
+}
+
+void *memory_pool_impl::allocateFromDevice(size_t Size) {
+  ur_usm_desc_t UsmDesc{};
+  void *Ptr = nullptr;
+  ur_result_t Error =
+      MContextImpl.getAdapter()->call_nocheck<UrApiKind::urUSMDeviceAlloc>(
+          MContextImpl.getHandleRef(), MDeviceImpl->getHandleRef(), &UsmDesc,
+          MPool, Size, &Ptr);
+  return Error == UR_RESULT_SUCCESS ? Ptr : nullptr;
+}
+
+void memory_pool_impl::freeToDevice(void *Ptr) {
+  MContextImpl.getAdapter()->call<UrApiKind::urUSMFree>(
+      MContextImpl.getHandleRef(), Ptr);
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
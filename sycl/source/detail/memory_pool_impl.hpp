@@ -0,0 +1,113 @@
+//==------- memory_pool_impl.hpp - SYCL asynchronous USM memory pool -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/ur.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class context_impl;
+class device_impl;
+class event_impl;
+class queue_impl;
+
+/// Device USM allocations of one device of a context, allocated from a UR
+/// memory pool. Freed blocks are cached together with an event marking the
+/// end of the work that may still use them, so that they can be reused
+/// without synchronizing with the host.
+class memory_pool_impl {
+public:
+  /// @param ContextImpl Context of the allocations.
+  /// @param DeviceImpl Device the memory is allocated on.
+  /// @param ContextOwner Keeps the context alive for pools created by the
+  /// user. The default pools of a context are owned by it and don't set it.
+  memory_pool_impl(context_impl &ContextImpl,
+                   const std::shared_ptr<device_impl> &DeviceImpl,
+                   std::shared_ptr<context_impl> ContextOwner = nullptr);
+
+  /// Waits for the pending releases and frees all the memory of the pool.
+  ~memory_pool_impl();
+
+  memory_pool_impl(const memory_pool_impl &) = delete;
+  memory_pool_impl &operator=(const memory_pool_impl &) = delete;
+
+  /// Allocates Size bytes usable by the work submitted to Queue from now on.
+  /// A cached block still in use by another queue is reused by making Queue
+  /// wait for that work with a barrier.
+  /// @return Pointer to the allocation, nullptr if Size is zero.
+  void *allocate(const std::shared_ptr<queue_impl> &Queue, size_t Size);
+
+  /// Returns the allocation Ptr to the pool once the work submitted to Queue
+  /// so far is done.
+  /// @return False if Ptr was not allocated from this pool.
+  bool deallocate(const std::shared_ptr<queue_impl> &Queue, void *Ptr);
+
+  /// @return True if Ptr is an allocation of this pool which hasn't been
+  /// freed.
+  bool owns(void *Ptr) const;
+
+  /// Frees cached blocks whose pending work is done until at most
+  /// MinBytesToKeep bytes are reserved.
+  void trimTo(size_t MinBytesToKeep);
+
+  size_t getReservedSize() const;
+  size_t getUsedSize() const;
+
+  context_impl &getContextImpl() const { return MContextImpl; }
+  /// @return Owning pointer to the context, null for the default pools.
+  const std::shared_ptr<context_impl> &getContextImplPtr() const {
+    return MContextOwner;
+  }
+  const std::shared_ptr<device_impl> &getDeviceImpl() const {
+    return MDeviceImpl;
+  }
+
+private:
+  // Allocation sizes are rounded up to this, so that blocks freed by
+  // allocations of slightly different sizes can be reused.
+  static constexpr size_t MinBlockSize = 256;
+
+  struct FreeBlock {
+    void *Ptr;
+    size_t Size;
+    // Queue the block was freed on and event of the last work submitted to it
+    // before the release. The event is null if that work is done.
+    std::weak_ptr<queue_impl> Queue;
+    std::shared_ptr<event_impl> Event;
+  };
+
+  void *allocateFromDevice(size_t Size);
+  void freeToDevice(void *Ptr);
+  // MMutex must be held.
+  void trimToLocked(size_t MinBytesToKeep);
+
+  context_impl &MContextImpl;
+  const std::shared_ptr<device_impl> MDeviceImpl;
+  const std::shared_ptr<context_impl> MContextOwner;
+  ur_usm_pool_handle_t MPool = nullptr;
+
+  mutable std::mutex MMutex;
+  // Sizes of the allocations handed out and not freed.
+  std::unordered_map<void *, size_t> MUsedBlocks;
+  std::vector<FreeBlock> MFreeBlocks;
+  size_t MReservedSize = 0;
+  size_t MUsedSize = 0;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,203 @@
+//==---- memory_telemetry.cpp - Memory transfer and allocation statistics --==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/memory_telemetry.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+const bool MemoryTelemetry::MEnabled =
+    SYCLConfig<SYCL_MEMORY_TELEMETRY>::get();
+
+MemoryTelemetry &MemoryTelemetry::instance() {
+  // Never destroyed, memory objects released by the destructors of other
+  // static objects may still be recorded.
+  static MemoryTelemetry *Telemetry = new MemoryTelemetry();
+  return *Telemetry;
+}
+
+static std::string getSiteName(const code_location &CodeLoc) {
+  if (!CodeLoc.fileName() && !CodeLoc.functionName())
+    return "<unknown>";
+  std::string Name = CodeLoc.fileName() ? CodeLoc.fileName() : "<unknown>";
+  Name += ":" + std::to_string(CodeLoc.lineNumber());
+  if (CodeLoc.functionName())
+    Name += std::string(" (") + CodeLoc.functionName() + ")";
+  return Name;
+}
+
+MemoryTelemetry::SiteStats &
+MemoryTelemetry::getSite(const code_location &CodeLoc) {
+  return MSites[getSiteName(CodeLoc)];
+}
+
+MemoryTelemetry::SiteStats &MemoryTelemetry::getSubmissionSite() {
+  return getSite(tls_code_loc_t{}.query());
+}
+
+const MemoryTelemetry::USMAllocation *
+MemoryTelemetry::findUSMAllocation(const void *Ptr) const {
+  auto Address = reinterpret_cast<uintptr_t>(Ptr);
+  auto It = MUSMAllocations.upper_bound(Address);
+  if (It == MUSMAllocations.begin())
+    return nullptr;
+  --It;
+  if (Address >= It->first + It->second.Bytes)
+    return nullptr;
+  return &It->second;
+}
+
+void MemoryTelemetry::addTransfer(SiteStats &Site, Direction Dir,
+                                  size_t Bytes, TimePoint Start) {
+  TransferStats &Transfer = Site.Transfers[static_cast<int>(Dir)];
+  ++Transfer.Count;
+  Transfer.Bytes += Bytes;
+  Transfer.TimeNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - Start)
+                         .count();
+}
+
+void MemoryTelemetry::registerBuffer(const SYCLMemObjI *Buffer,
+                                     const code_location &CodeLoc) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MBuffers[Buffer] = &getSite(CodeLoc);
+}
+
+void MemoryTelemetry::unregisterBuffer(const SYCLMemObjI *Buffer) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MBuffers.erase(Buffer);
+}
+
+void MemoryTelemetry::recordBufferAlloc(const SYCLMemObjI *Buffer,
+                                        size_t Bytes) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MBuffers.find(Buffer);
+  SiteStats &Site = It != MBuffers.end() ? *It->second : getSubmissionSite();
+  ++Site.Allocations;
+  Site.AllocatedBytes += Bytes;
+}
+
+void MemoryTelemetry::recordBufferCopy(const SYCLMemObjI *Buffer,
+                                       Direction Dir, size_t Bytes,
+                                       TimePoint Start) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MBuffers.find(Buffer);
+  addTransfer(It != MBuffers.end() ? *It->second : getSubmissionSite(), Dir,
+              Bytes, Start);
+}
+
+void MemoryTelemetry::recordUSMAlloc(const void *Ptr, size_t Bytes,
+                                     sycl::usm::alloc Kind,
+                                     const code_location &CodeLoc) {
+  if (!Ptr)
+    return;
+  std::lock_guard<std::mutex> Lock(MMutex);
+  SiteStats &Site = getSite(CodeLoc);
+  ++Site.Allocations;
+  Site.AllocatedBytes += Bytes;
+  Site.LiveUSMBytes += Bytes;
+  Site.PeakLiveUSMBytes = std::max(Site.PeakLiveUSMBytes, Site.LiveUSMBytes);
+  MLiveUSMBytes += Bytes;
+  MPeakLiveUSMBytes = std::max(MPeakLiveUSMBytes, MLiveUSMBytes);
+  MUSMAllocations[reinterpret_cast<uintptr_t>(Ptr)] = {Bytes, Kind, &Site};
+}
+
+void MemoryTelemetry::recordUSMFree(const void *Ptr) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MUSMAllocations.find(reinterpret_cast<uintptr_t>(Ptr));
+  if (It == MUSMAllocations.end())
+    return;
+  It->second.Site->LiveUSMBytes -= It->second.Bytes;
+  MLiveUSMBytes -= It->second.Bytes;
+  MUSMAllocations.erase(It);
+}
+
+void MemoryTelemetry::recordUSMCopy(const void *Src, const void *Dst,
+                                    size_t Bytes, TimePoint Start) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto getDeviceAllocation = [&](const void *Ptr) -> const USMAllocation * {
+    const USMAllocation *Alloc = findUSMAllocation(Ptr);
+    return Alloc && Alloc->Kind == sycl::usm::alloc::device ? Alloc : nullptr;
+  };
+  const USMAllocation *SrcAlloc = getDeviceAllocation(Src);
+  const USMAllocation *DstAlloc = getDeviceAllocation(Dst);
+
+  Direction Dir = SrcAlloc ? (DstAlloc ? Direction::DeviceToDevice
+                                       : Direction::DeviceToHost)
+                           : (DstAlloc ? Direction::HostToDevice
+                                       : Direction::HostToHost);
+  // The device side of the copy identifies the allocation site.
+  const USMAllocation *Alloc = DstAlloc ? DstAlloc : SrcAlloc;
+  if (!Alloc)
+    Alloc = findUSMAllocation(Dst);
+  if (!Alloc)
+    Alloc = findUSMAllocation(Src);
+  addTransfer(Alloc ? *Alloc->Site : getSubmissionSite(), Dir, Bytes, Start);
+}
+
+void MemoryTelemetry::print() const {
+  static constexpr const char *DirectionNames[NumDirections] = {
+      "host_to_device", "device_to_host", "device_to_device", "host_to_host"};
+
+  std::lock_guard<std::mutex> Lock(MMutex);
+  // The sites moving the most bytes come first.
+  auto getTransferredBytes = [](const SiteStats &Site) {
+    uint64_t Bytes = 0;
+    for (const TransferStats &Transfer : Site.Transfers)
+      Bytes += Transfer.Bytes;
+    return Bytes;
+  };
+  std::vector<std::pair<const std::string *, const SiteStats *>> Sites;
+  for (const auto &[Name, Site] : MSites)
+    Sites.emplace_back(&Name, &Site);
+  std::sort(Sites.begin(), Sites.end(), [&](const auto &A, const auto &B) {
+    return getTransferredBytes(*A.second) > getTransferredBytes(*B.second);
+  });
+
+  std::fprintf(stderr, "SYCL memory telemetry:\n");
+  std::fprintf(stderr, "  peak live USM bytes %" PRIu64 "\n",
+               MPeakLiveUSMBytes);
+  for (const auto &[Name, Site] : Sites) {
+    std::fprintf(stderr, "  %s\n", Name->c_str());
+    for (int I = 0; I < NumDirections; ++I) {
+      const TransferStats &Transfer = Site->Transfers[I];
+      if (Transfer.Count)
+        std::fprintf(stderr,
+                     "    %-16s count %" PRIu64 " bytes %" PRIu64
+                     " host time %" PRIu64 " ns\n",
+                     DirectionNames[I], Transfer.Count, Transfer.Bytes,
+                     Transfer.TimeNs);
+    }
+    if (Site->Allocations)
+      std::fprintf(stderr,
+                   "    %-16s count %" PRIu64 " bytes %" PRIu64
+                   " peak live USM bytes %" PRIu64 "\n",
+                   "allocations", Site->Allocations, Site->AllocatedBytes,
+                   Site->PeakLiveUSMBytes);
+  }
+}
+
+namespace {
+struct MemoryTelemetryPrinter {
+  ~MemoryTelemetryPrinter() {
+    if (MemoryTelemetry::isEnabled())
+      MemoryTelemetry::instance().print();
+  }
+} GMemoryTelemetryPrinter;
+} // namespace
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
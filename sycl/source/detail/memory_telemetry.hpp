@@ -0,0 +1,115 @@
+//==---- memory_telemetry.hpp - Memory transfer and allocation statistics --==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/common.hpp>
+#include <sycl/usm/usm_enums.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class SYCLMemObjI;
+
+/// Aggregates the bytes moved by the memory transfers and the allocations of
+/// the application per allocation site, i.e. the code location where the
+/// buffer or the USM allocation involved was created. Transfers of memory the
+/// runtime didn't see being allocated are attributed to the code location of
+/// their submission. Enabled by SYCL_MEMORY_TELEMETRY=1, the statistics are
+/// printed to stderr at exit.
+class MemoryTelemetry {
+public:
+  enum class Direction : int {
+    HostToDevice = 0,
+    DeviceToHost = 1,
+    DeviceToDevice = 2,
+    HostToHost = 3
+  };
+  static constexpr int NumDirections = 4;
+
+  using TimePoint = std::chrono::steady_clock::time_point;
+
+  static bool isEnabled() { return MEnabled; }
+  static MemoryTelemetry &instance();
+
+  static TimePoint now() {
+    return isEnabled() ? std::chrono::steady_clock::now() : TimePoint{};
+  }
+
+  void registerBuffer(const SYCLMemObjI *Buffer, const code_location &CodeLoc);
+  void unregisterBuffer(const SYCLMemObjI *Buffer);
+
+  void recordBufferAlloc(const SYCLMemObjI *Buffer, size_t Bytes);
+  void recordBufferCopy(const SYCLMemObjI *Buffer, Direction Dir, size_t Bytes,
+                        TimePoint Start);
+
+  void recordUSMAlloc(const void *Ptr, size_t Bytes, sycl::usm::alloc Kind,
+                      const code_location &CodeLoc);
+  void recordUSMFree(const void *Ptr);
+  /// The direction of the copy is deduced from the allocations Src and Dst
+  /// belong to, memory other than device USM counting as host memory.
+  void recordUSMCopy(const void *Src, const void *Dst, size_t Bytes,
+                     TimePoint Start);
+
+  void print() const;
+
+private:
+  struct TransferStats {
+    uint64_t Count = 0;
+    uint64_t Bytes = 0;
+    // Host time spent issuing the transfers, which includes the transfer
+    // itself only for blocking ones.
+    uint64_t TimeNs = 0;
+  };
+
+  struct SiteStats {
+    TransferStats Transfers[NumDirections];
+    uint64_t Allocations = 0;
+    uint64_t AllocatedBytes = 0;
+    uint64_t LiveUSMBytes = 0;
+    uint64_t PeakLiveUSMBytes = 0;
+  };
+
+  struct USMAllocation {
+    size_t Bytes;
+    sycl::usm::alloc Kind;
+    SiteStats *Site;
+  };
+
+  // Must be called with MMutex locked.
+  SiteStats &getSite(const code_location &CodeLoc);
+  SiteStats &getSubmissionSite();
+  const USMAllocation *findUSMAllocation(const void *Ptr) const;
+  static void addTransfer(SiteStats &Site, Direction Dir, size_t Bytes,
+                          TimePoint Start);
+
+  static const bool MEnabled;
+
+  mutable std::mutex MMutex;
+  // Keyed by the printed code location, the addresses of the entries are
+  // stable.
+  std::unordered_map<std::string, SiteStats> MSites;
+  std::unordered_map<const SYCLMemObjI *, SiteStats *> MBuffers;
+  // Keyed by the start address of the allocations.
+  std::map<uintptr_t, USMAllocation> MUSMAllocations;
+  uint64_t MLiveUSMBytes = 0;
+  uint64_t MPeakLiveUSMBytes = 0;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
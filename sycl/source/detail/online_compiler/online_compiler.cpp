@@ -6,10 +6,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/persistent_device_code_cache.hpp>
 #include <sycl/detail/os_util.hpp>
 #include <sycl/detail/ur.hpp>
 #include <sycl/ext/intel/experimental/online_compiler.hpp>
 
+#include <atomic>
 #include <cstring>
 
 #include "ocloc_api.h"
@@ -67,6 +69,20 @@ prepareOclocArgs(sycl::info::device_type DeviceType, device_arch DeviceArch,
   return Args;
 }
 
+// Version of the loaded ocloc library, part of the keys of the compilations
+// in the persistent cache.
+static std::atomic<int> OclocVersion{0};
+
+// Key of the compilation of Source with the ocloc arguments Args.
+static std::string getCompilationKey(const std::vector<const char *> &Args,
+                                     const std::string &Source) {
+  std::string Key = std::to_string(OclocVersion.load());
+  for (const char *Arg : Args)
+    Key.append(1, '\0').append(Arg);
+  Key.append(2, '\0').append(Source);
+  return Key;
+}
+
 /// Compiles the given source \p Source to SPIR-V IL and returns IL as a vector
 /// of bytes.
 /// @param Source - Either OpenCL or CM source code.
@@ -109,6 +125,7 @@ compileToSPIRV(const std::string &Source, sycl::info::device_type DeviceType,
           reinterpret_cast<decltype(::oclocVersion) *>(OclocVersionHandle);
       LoadedVersion = OclocVersionFunc();
     }
+    OclocVersion = LoadedVersion;
     // The loaded library with version (A.B) is compatible with expected API/ABI
     // version (X.Y) used here if A == B and B >= Y.
     int LoadedVersionMajor = LoadedVersion >> 16;
@@ -147,6 +164,13 @@ compileToSPIRV(const std::string &Source, sycl::info::device_type DeviceType,
   std::vector<const char *> Args = detail::prepareOclocArgs(
       DeviceType, DeviceArch, Is64Bit, DeviceStepping, CombinedUserArgs);
 
+  using sycl::detail::PersistentDeviceCodeCache;
+  const std::string Key = getCompilationKey(Args, Source);
+  std::vector<char> CachedSpirV =
+      PersistentDeviceCodeCache::getOnlineCompilerItemFromDisc(Key);
+  if (!CachedSpirV.empty())
+    return std::vector<byte>(CachedSpirV.begin(), CachedSpirV.end());
+
   uint32_t NumOutputs = 0;
   byte **Outputs = nullptr;
   uint64_t *OutputLengths = nullptr;
@@ -194,6 +218,8 @@ compileToSPIRV(const std::string &Source, sycl::info::device_type DeviceType,
   if (MemFreeError)
     throw online_compile_error("ocloc cannot safely free resources");
 
+  PersistentDeviceCodeCache::putOnlineCompilerItemToDisc(
+      Key, std::vector<char>(SpirV.begin(), SpirV.end()));
   return SpirV;
 }
 } // namespace detail
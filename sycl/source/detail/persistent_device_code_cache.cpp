@@ -8,15 +8,23 @@
 
 #include <detail/adapter.hpp>
 #include <detail/device_impl.hpp>
+#include <detail/global_handler.hpp>
 #include <detail/persistent_device_code_cache.hpp>
 #include <detail/program_manager/program_manager.hpp>
+#include <detail/thread_pool.hpp>
 
+#include <atomic>
 #include <cerrno>
+#include <chrono>
 #include <cstdio>
+#include <cstring>
 #include <fstream>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
 
 #if defined(__SYCL_RT_OS_POSIX_SUPPORT)
+#include <sys/mman.h>
 #include <unistd.h>
 #else
 #include <direct.h>
@@ -52,6 +60,134 @@ LockCacheItem::~LockCacheItem() {
                                      FileName);
 }
 
+namespace {
+/* Read-only view of the whole file content. The file is memory mapped where
+ * supported and read into memory otherwise. An empty view is returned if the
+ * file cannot be read.
+ */
+class MappedFile {
+public:
+  MappedFile(const std::string &FileName) {
+#if defined(__SYCL_RT_OS_POSIX_SUPPORT)
+    int FD = open(FileName.c_str(), O_RDONLY);
+    if (FD == -1)
+      return;
+    struct stat Stat;
+    if (fstat(FD, &Stat) == 0 && Stat.st_size > 0) {
+      void *Addr = mmap(nullptr, Stat.st_size, PROT_READ, MAP_PRIVATE, FD, 0);
+      if (Addr != MAP_FAILED) {
+        Data = static_cast<const char *>(Addr);
+        Size = Stat.st_size;
+      }
+    }
+    close(FD);
+#else
+    std::ifstream FileStream{FileName, std::ios::binary | std::ios::ate};
+    if (!FileStream)
+      return;
+    Buffer.resize(FileStream.tellg());
+    FileStream.seekg(0);
+    FileStream.read(Buffer.data(), Buffer.size());
+    if (FileStream.fail())
+      Buffer.clear();
+    Data = Buffer.data();
+    Size = Buffer.size();
+#endif
+  }
+
+  ~MappedFile() {
+#if defined(__SYCL_RT_OS_POSIX_SUPPORT)
+    if (Data)
+      munmap(const_cast<char *>(Data), Size);
+#endif
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  const char *data() const { return Data; }
+  size_t size() const { return Size; }
+
+private:
+  const char *Data = nullptr;
+  size_t Size = 0;
+#if !defined(__SYCL_RT_OS_POSIX_SUPPORT)
+  std::vector<char> Buffer;
+#endif
+};
+
+/* Sequential reader of [size, value] formatted data. All reads are checked
+ * against the end of the data, a failed read makes all subsequent ones fail.
+ */
+class DataReader {
+public:
+  DataReader(const char *Data, size_t Size) : Cur(Data), End(Data + Size) {}
+
+  template <typename T> bool read(T &Value) {
+    if (!Cur || static_cast<size_t>(End - Cur) < sizeof(Value))
+      return fail();
+    std::memcpy(&Value, Cur, sizeof(Value));
+    Cur += sizeof(Value);
+    return true;
+  }
+
+  // Returns pointer to the next Size bytes and skips them.
+  const char *take(size_t Size) {
+    if (!Cur || static_cast<size_t>(End - Cur) < Size) {
+      fail();
+      return nullptr;
+    }
+    const char *Res = Cur;
+    Cur += Size;
+    return Res;
+  }
+
+  bool atEnd() const { return Cur == End; }
+
+private:
+  bool fail() {
+    Cur = nullptr;
+    return false;
+  }
+
+  const char *Cur;
+  const char *End;
+};
+
+/* Usage records queued by this process and not yet written to the ledger */
+struct PendingUsage {
+  std::mutex Mutex;
+  std::string Records;
+  bool MaintenanceScheduled = false;
+};
+
+PendingUsage &getPendingUsage() {
+  static PendingUsage Pending;
+  return Pending;
+}
+
+// Appends Data to FileName with a single write, so that concurrent writers do
+// not interleave.
+bool appendToFile(const std::string &FileName, const std::string &Data) {
+  int fd =
+      open(FileName.c_str(), O_WRONLY | O_APPEND | O_CREAT, S_IREAD | S_IWRITE);
+  if (fd == -1)
+    return false;
+  auto Written = write(fd, Data.data(), Data.size());
+  close(fd);
+  return Written >= 0 && static_cast<size_t>(Written) == Data.size();
+}
+
+void appendUsageRecord(std::string &Records, int64_t Time, size_t Size,
+                       const std::string &Path) {
+  const size_t PathSize = Path.size();
+  Records.append(reinterpret_cast<const char *>(&Time), sizeof(Time));
+  Records.append(reinterpret_cast<const char *>(&Size), sizeof(Size));
+  Records.append(reinterpret_cast<const char *>(&PathSize), sizeof(PathSize));
+  Records.append(Path);
+}
+} // namespace
+
 // Returns true if the specified format is either SPIRV or a native binary.
 static bool
 IsSupportedImageFormat(ur::DeviceBinaryType Format) {
@@ -166,6 +302,12 @@ void PersistentDeviceCodeCache::putItemToDisc(
       trace("device binary has been cached: " + FullFileName);
       writeSourceItem(FileName + ".src", Device, SortedImgs, SpecConsts,
                       BuildOptionsString);
+      std::string DeviceDir = getDeviceDir(Device);
+      addItemToIndex(DeviceDir, FileName.substr(DeviceDir.size() + 1));
+      size_t ItemSize = 0;
+      for (const std::vector<char> &Binary : Result)
+        ItemSize += Binary.size();
+      recordItemUsage(FileName, ItemSize);
     } else {
       PersistentDeviceCodeCache::trace("cache lock not owned " + FileName);
     }
@@ -195,7 +337,30 @@ std::vector<std::vector<char>> PersistentDeviceCodeCache::getItemFromDisc(
   std::string Path =
       getCacheItemPath(Device, SortedImgs, SpecConsts, BuildOptionsString);
 
-  if (Path.empty() || !OSUtil::isPathPresent(Path))
+  if (Path.empty())
+    return {};
+
+  std::string DeviceDir = getDeviceDir(Device);
+  std::string RelDir = Path.substr(DeviceDir.size() + 1);
+
+  // Indexed items are complete by construction, so there is no need to check
+  // for the lock file.
+  for (const std::string &RelItem : getIndexedItems(DeviceDir, RelDir)) {
+    std::string FileName = DeviceDir + "/" + RelItem;
+    if (!isCacheItemSrcEqual(FileName + ".src", Device, SortedImgs, SpecConsts,
+                             BuildOptionsString))
+      continue;
+    std::string FullFileName = FileName + ".bin";
+    std::vector<std::vector<char>> res = readBinaryDataFromFile(FullFileName);
+    if (!res.empty()) {
+      trace("using cached device binary: " + FullFileName);
+      recordItemUsage(FileName, 0);
+      return res; // subject for NRVO
+    }
+  }
+
+  // Fall back to the directory walk for items created without the index.
+  if (!OSUtil::isPathPresent(Path))
     return {};
 
   int i = 0;
@@ -211,8 +376,12 @@ std::vector<std::vector<char>> PersistentDeviceCodeCache::getItemFromDisc(
         std::string FullFileName = FileName + ".bin";
         std::vector<std::vector<char>> res =
             readBinaryDataFromFile(FullFileName);
-        trace("using cached device binary: " + FullFileName);
-        return res; // subject for NRVO
+        if (!res.empty()) {
+          trace("using cached device binary: " + FullFileName);
+          addItemToIndex(DeviceDir, RelDir + "/" + std::to_string(i));
+          recordItemUsage(FileName, 0);
+          return res; // subject for NRVO
+        }
       } catch (...) {
         // If read was unsuccessfull try the next item
       }
@@ -222,6 +391,366 @@ std::vector<std::vector<char>> PersistentDeviceCodeCache::getItemFromDisc(
   return {};
 }
 
+namespace {
+/* Returns directory name to store the data of Category for the key Key.
+ */
+std::string getKeyedItemPath(const std::string &DeviceDir,
+                             const std::string &Category,
+                             const std::string &Key) {
+  std::hash<std::string> StringHasher{};
+  return DeviceDir + "/" + Category + "/" + std::to_string(StringHasher(Key));
+}
+
+/* Check that the key stored in the .src file is equal to Key.
+ * Format: [size, key]
+ */
+bool isItemKeyEqual(const std::string &FileName, const std::string &Key) {
+  MappedFile File{FileName};
+  DataReader Reader{File.data(), File.size()};
+  size_t Size = 0;
+  if (!Reader.read(Size) || Size != Key.size())
+    return false;
+  const char *Value = Reader.take(Size);
+  return Value && std::memcmp(Value, Key.data(), Size) == 0;
+}
+} // namespace
+
+void PersistentDeviceCodeCache::putKeyedItemToDisc(
+    const std::string &Dir, const std::string &Category,
+    const std::string &Key, const std::vector<char> &Data) {
+  if (!isEnabled() || Dir.empty())
+    return;
+
+  std::string DirName = getKeyedItemPath(Dir, Category, Key);
+
+  size_t i = 0;
+  std::string FileName;
+  do {
+    FileName = DirName + "/" + std::to_string(i++);
+  } while (OSUtil::isPathPresent(FileName + ".bin") ||
+           OSUtil::isPathPresent(FileName + ".lock"));
+
+  try {
+    OSUtil::makeDir(DirName.c_str());
+    LockCacheItem Lock{FileName};
+    if (Lock.isOwned()) {
+      std::string FullFileName = FileName + ".bin";
+      writeBinaryDataToFile(FullFileName, {Data});
+      trace(Category + " item has been cached: " + FullFileName);
+
+      std::ofstream FileStream{FileName + ".src", std::ios::binary};
+      size_t Size = Key.size();
+      FileStream.write((char *)&Size, sizeof(Size));
+      FileStream.write(Key.data(), Size);
+      FileStream.close();
+      if (FileStream.fail())
+        trace("Failed to write source file to " + FileName + ".src");
+
+      recordItemUsage(FileName, Data.size());
+    } else {
+      PersistentDeviceCodeCache::trace("cache lock not owned " + FileName);
+    }
+  } catch (std::exception &e) {
+    PersistentDeviceCodeCache::trace(
+        std::string("exception encountered making persistent cache: ") +
+        e.what());
+  } catch (...) {
+    PersistentDeviceCodeCache::trace(
+        std::string("error outputting persistent cache: ") +
+        std::strerror(errno));
+  }
+}
+
+std::vector<char>
+PersistentDeviceCodeCache::getKeyedItemFromDisc(const std::string &Dir,
+                                                const std::string &Category,
+                                                const std::string &Key) {
+  if (!isEnabled() || Dir.empty())
+    return {};
+
+  std::string Path = getKeyedItemPath(Dir, Category, Key);
+  if (!OSUtil::isPathPresent(Path))
+    return {};
+
+  int i = 0;
+  std::string FileName{Path + "/" + std::to_string(i)};
+  while (OSUtil::isPathPresent(FileName + ".bin") ||
+         OSUtil::isPathPresent(FileName + ".src")) {
+    if (!LockCacheItem::isLocked(FileName) &&
+        isItemKeyEqual(FileName + ".src", Key)) {
+      std::string FullFileName = FileName + ".bin";
+      std::vector<std::vector<char>> Res = readBinaryDataFromFile(FullFileName);
+      if (Res.size() == 1) {
+        trace("using cached " + Category + " item: " + FullFileName);
+        recordItemUsage(FileName, 0);
+        return std::move(Res[0]);
+      }
+    }
+    FileName = Path + "/" + std::to_string(++i);
+  }
+  return {};
+}
+
+void PersistentDeviceCodeCache::putKeyedItemToDisc(
+    const device &Device, const std::string &Category, const std::string &Key,
+    const std::vector<char> &Data) {
+  if (!isEnabled())
+    return;
+  putKeyedItemToDisc(getDeviceDir(Device), Category, Key, Data);
+}
+
+std::vector<char>
+PersistentDeviceCodeCache::getKeyedItemFromDisc(const device &Device,
+                                                const std::string &Category,
+                                                const std::string &Key) {
+  if (!isEnabled())
+    return {};
+  return getKeyedItemFromDisc(getDeviceDir(Device), Category, Key);
+}
+
+void PersistentDeviceCodeCache::putGraphItemToDisc(
+    const device &Device, const std::string &GraphKey,
+    const std::vector<char> &Data) {
+  putKeyedItemToDisc(Device, "graph", GraphKey, Data);
+}
+
+std::vector<char>
+PersistentDeviceCodeCache::getGraphItemFromDisc(const device &Device,
+                                                const std::string &GraphKey) {
+  return getKeyedItemFromDisc(Device, "graph", GraphKey);
+}
+
+void PersistentDeviceCodeCache::putJITItemToDisc(
+    const device &Device, const std::string &JITKey,
+    const std::vector<char> &Data) {
+  putKeyedItemToDisc(Device, "jit", JITKey, Data);
+}
+
+std::vector<char>
+PersistentDeviceCodeCache::getJITItemFromDisc(const device &Device,
+                                              const std::string &JITKey) {
+  return getKeyedItemFromDisc(Device, "jit", JITKey);
+}
+
+void PersistentDeviceCodeCache::putRTCItemToDisc(
+    const device &Device, const std::string &RTCKey,
+    const std::vector<char> &Data) {
+  putKeyedItemToDisc(Device, "rtc", RTCKey, Data);
+}
+
+std::vector<char>
+PersistentDeviceCodeCache::getRTCItemFromDisc(const device &Device,
+                                              const std::string &RTCKey) {
+  return getKeyedItemFromDisc(Device, "rtc", RTCKey);
+}
+
+void PersistentDeviceCodeCache::putOnlineCompilerItemToDisc(
+    const std::string &Key, const std::vector<char> &Data) {
+  putKeyedItemToDisc(getRootDir(), "online_compiler", Key, Data);
+}
+
+std::vector<char>
+PersistentDeviceCodeCache::getOnlineCompilerItemFromDisc(
+    const std::string &Key) {
+  return getKeyedItemFromDisc(getRootDir(), "online_compiler", Key);
+}
+
+/* Index record format: [key hash, relative item path size, relative item
+ * path]. The key hash is the hash of the item directory the record belongs to.
+ */
+std::vector<std::string>
+PersistentDeviceCodeCache::getIndexedItems(const std::string &DeviceDir,
+                                           const std::string &RelDir) {
+  MappedFile Index{DeviceDir + "/index"};
+  DataReader Reader{Index.data(), Index.size()};
+  const size_t KeyHash = std::hash<std::string>{}(RelDir);
+
+  std::vector<std::string> Res;
+  size_t RecordHash = 0, Size = 0;
+  while (!Reader.atEnd() && Reader.read(RecordHash) && Reader.read(Size)) {
+    const char *RelItem = Reader.take(Size);
+    if (!RelItem) {
+      trace("Malformed cache index in " + DeviceDir);
+      break;
+    }
+    // Full directory comparison resolves key hash collisions.
+    if (RecordHash == KeyHash && Size > RelDir.size() &&
+        RelItem[RelDir.size()] == '/' &&
+        RelDir.compare(0, RelDir.size(), RelItem, RelDir.size()) == 0)
+      Res.emplace_back(RelItem, Size);
+  }
+  return Res;
+}
+
+void PersistentDeviceCodeCache::addItemToIndex(const std::string &DeviceDir,
+                                               const std::string &RelItem) {
+  const std::string RelDir = RelItem.substr(0, RelItem.rfind('/'));
+  const size_t KeyHash = std::hash<std::string>{}(RelDir);
+  const size_t Size = RelItem.size();
+
+  std::string Record(sizeof(KeyHash) + sizeof(Size) + Size, '\0');
+  std::memcpy(&Record[0], &KeyHash, sizeof(KeyHash));
+  std::memcpy(&Record[sizeof(KeyHash)], &Size, sizeof(Size));
+  std::memcpy(&Record[sizeof(KeyHash) + sizeof(Size)], RelItem.data(), Size);
+
+  std::string IndexName = DeviceDir + "/index";
+  if (!appendToFile(IndexName, Record))
+    trace("Failed to update cache index: " + IndexName + " " +
+          std::strerror(errno));
+}
+
+void PersistentDeviceCodeCache::recordItemUsage(const std::string &FileName,
+                                                size_t Size) {
+  const std::string RootDir = getRootDir();
+  const int64_t Now = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+
+  PendingUsage &Pending = getPendingUsage();
+  {
+    std::lock_guard<std::mutex> Lock(Pending.Mutex);
+    appendUsageRecord(Pending.Records, Now, Size,
+                      FileName.substr(RootDir.size() + 1));
+    if (Pending.MaintenanceScheduled)
+      return;
+    Pending.MaintenanceScheduled = true;
+  }
+
+  try {
+    GlobalHandler::instance().getHostTaskThreadPool().submit(
+        [] { runMaintenance(); });
+  } catch (...) {
+    std::lock_guard<std::mutex> Lock(getPendingUsage().Mutex);
+    getPendingUsage().MaintenanceScheduled = false;
+  }
+}
+
+void PersistentDeviceCodeCache::runMaintenance() {
+  PendingUsage &Pending = getPendingUsage();
+  std::string Records;
+  {
+    std::lock_guard<std::mutex> Lock(Pending.Mutex);
+    Records.swap(Pending.Records);
+    Pending.MaintenanceScheduled = false;
+  }
+
+  try {
+    const std::string RootDir = getRootDir();
+    if (RootDir.empty())
+      return;
+    if (!Records.empty() && !appendToFile(RootDir + "/usage", Records))
+      trace("Failed to update cache usage ledger: " + RootDir + "/usage " +
+            std::strerror(errno));
+    if (!SYCLConfig<SYCL_CACHE_EVICTION_DISABLE>::get())
+      evictItems(RootDir);
+  } catch (std::exception &e) {
+    trace(std::string("exception encountered during cache maintenance: ") +
+          e.what());
+  } catch (...) {
+    trace("error during cache maintenance");
+  }
+}
+
+void PersistentDeviceCodeCache::evictItems(const std::string &RootDir) {
+  static const auto MaxSize =
+      getNumParam<SYCL_CACHE_MAX_SIZE>(DEFAULT_MAX_CACHE_SIZE);
+  static const auto ThresholdDays =
+      getNumParam<SYCL_CACHE_THRESHOLD>(DEFAULT_CACHE_THRESHOLD);
+  if (!MaxSize && !ThresholdDays)
+    return;
+
+  const std::string LedgerName = RootDir + "/usage";
+  LockCacheItem Lock{LedgerName};
+  if (!Lock.isOwned())
+    return;
+
+  struct ItemUsage {
+    size_t Size = 0;
+    int64_t LastUse = 0;
+  };
+  std::unordered_map<std::string, ItemUsage> Items;
+  size_t LedgerSize = 0;
+  {
+    MappedFile Ledger{LedgerName};
+    LedgerSize = Ledger.size();
+    DataReader Reader{Ledger.data(), Ledger.size()};
+    int64_t Time = 0;
+    size_t Size = 0, PathSize = 0;
+    while (!Reader.atEnd() && Reader.read(Time) && Reader.read(Size) &&
+           Reader.read(PathSize)) {
+      const char *Path = Reader.take(PathSize);
+      if (!Path) {
+        trace("Malformed cache usage ledger " + LedgerName);
+        break;
+      }
+      ItemUsage &Usage = Items[std::string(Path, PathSize)];
+      if (Size)
+        Usage.Size = Size;
+      Usage.LastUse = std::max(Usage.LastUse, Time);
+    }
+  }
+
+  std::vector<std::pair<std::string, ItemUsage>> SortedItems(Items.begin(),
+                                                             Items.end());
+  std::sort(SortedItems.begin(), SortedItems.end(),
+            [](const auto &A, const auto &B) {
+              return A.second.LastUse < B.second.LastUse;
+            });
+  size_t TotalSize = 0;
+  for (const auto &Item : SortedItems)
+    TotalSize += Item.second.Size;
+
+  // Trim to three quarters of the limit, so that the next few items written
+  // do not trigger another eviction right away.
+  const size_t TargetSize = MaxSize - MaxSize / 4;
+  const int64_t Now = std::chrono::duration_cast<std::chrono::seconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+  const int64_t ExpireTime =
+      ThresholdDays ? Now - static_cast<int64_t>(ThresholdDays) * 24 * 60 * 60
+                    : 0;
+  const bool NeedTrim = MaxSize && TotalSize > MaxSize;
+
+  size_t Evicted = 0;
+  std::string Compacted;
+  for (const auto &[Path, Usage] : SortedItems) {
+    const std::string FileName = RootDir + "/" + Path;
+    const bool Expired = Usage.LastUse < ExpireTime;
+    const bool OverSize = NeedTrim && TotalSize > TargetSize;
+    if ((Expired || OverSize) && !LockCacheItem::isLocked(FileName)) {
+      std::remove((FileName + ".bin").c_str());
+      std::remove((FileName + ".src").c_str());
+      trace("evicted cache item: " + FileName);
+      TotalSize -= Usage.Size;
+      ++Evicted;
+      continue;
+    }
+    appendUsageRecord(Compacted, Usage.LastUse, Usage.Size, Path);
+  }
+  if (!Evicted)
+    return;
+
+  // Keep records appended by other processes while the ledger was processed.
+  {
+    MappedFile Ledger{LedgerName};
+    if (Ledger.size() > LedgerSize)
+      Compacted.append(Ledger.data() + LedgerSize, Ledger.size() - LedgerSize);
+  }
+  const std::string TmpName = LedgerName + ".tmp";
+  std::remove(TmpName.c_str());
+  if (!appendToFile(TmpName, Compacted)) {
+    trace("Failed to write cache usage ledger " + TmpName);
+    std::remove(TmpName.c_str());
+    return;
+  }
+#if !defined(__SYCL_RT_OS_POSIX_SUPPORT)
+  // rename does not replace existing files on Windows.
+  std::remove(LedgerName.c_str());
+#endif
+  if (std::rename(TmpName.c_str(), LedgerName.c_str()))
+    trace("Failed to replace cache usage ledger " + LedgerName);
+}
+
 /* Returns string value which can be used to identify different device
  */
 std::string PersistentDeviceCodeCache::getDeviceIDString(const device &Device) {
@@ -257,24 +786,24 @@ void PersistentDeviceCodeCache::writeBinaryDataToFile(
  */
 std::vector<std::vector<char>>
 PersistentDeviceCodeCache::readBinaryDataFromFile(const std::string &FileName) {
-  std::ifstream FileStream{FileName, std::ios::binary};
+  MappedFile File{FileName};
+  DataReader Reader{File.data(), File.size()};
   size_t ImgNum = 0, ImgSize = 0;
-  FileStream.read((char *)&ImgNum, sizeof(ImgNum));
+  // Each image takes at least its size field, reject corrupted counts before
+  // allocating for them.
+  if (!Reader.read(ImgNum) || ImgNum > File.size() / sizeof(ImgSize)) {
+    trace("Failed to read binary file from " + FileName);
+    return {};
+  }
 
   std::vector<std::vector<char>> Res(ImgNum);
   for (size_t i = 0; i < ImgNum; ++i) {
-    FileStream.read((char *)&ImgSize, sizeof(ImgSize));
-
-    std::vector<char> ImgData(ImgSize);
-    FileStream.read(ImgData.data(), ImgSize);
-
-    Res[i] = std::move(ImgData);
-  }
-  FileStream.close();
-
-  if (FileStream.fail()) {
-    trace("Failed to read binary file from " + FileName);
-    return {};
+    const char *ImgData = nullptr;
+    if (!Reader.read(ImgSize) || !(ImgData = Reader.take(ImgSize))) {
+      trace("Failed to read binary file from " + FileName);
+      return {};
+    }
+    Res[i].assign(ImgData, ImgData + ImgSize);
   }
 
   return Res;
@@ -324,44 +853,35 @@ bool PersistentDeviceCodeCache::isCacheItemSrcEqual(
     const std::string &FileName, const device &Device,
     const std::vector<const RTDeviceBinaryImage *> &SortedImgs,
     const SerializedObj &SpecConsts, const std::string &BuildOptionsString) {
-  std::ifstream FileStream{FileName, std::ios::binary};
-
-  std::string ImgsString;
-  for (const RTDeviceBinaryImage *Img : SortedImgs)
-    ImgsString.append((const char *)Img->getRawData().BinaryStart,
-                      Img->getSize());
-  std::string SpecConstsString{(const char *)SpecConsts.data(),
-                               SpecConsts.size()};
+  MappedFile File{FileName};
+  DataReader Reader{File.data(), File.size()};
 
-  size_t Size = 0;
-  FileStream.read((char *)&Size, sizeof(Size));
-  std::string res(Size, '\0');
-  FileStream.read(&res[0], Size);
-  if (getDeviceIDString(Device).compare(res))
-    return false;
-
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (BuildOptionsString.compare(res))
-    return false;
+  auto ReadEqual = [&Reader](const char *Data, size_t DataSize) {
+    size_t Size = 0;
+    if (!Reader.read(Size) || Size != DataSize)
+      return false;
+    const char *Value = Reader.take(Size);
+    return Value && std::memcmp(Value, Data, Size) == 0;
+  };
 
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (SpecConstsString.compare(res))
+  std::string DeviceString{getDeviceIDString(Device)};
+  if (!ReadEqual(DeviceString.data(), DeviceString.size()) ||
+      !ReadEqual(BuildOptionsString.data(), BuildOptionsString.size()) ||
+      !ReadEqual((const char *)SpecConsts.data(), SpecConsts.size()))
     return false;
 
-  FileStream.read((char *)&Size, sizeof(Size));
-  res.resize(Size);
-  FileStream.read(&res[0], Size);
-  if (ImgsString.compare(res))
+  // Images are stored as a single value, compare them one after another.
+  size_t ImgsSize = 0;
+  for (const RTDeviceBinaryImage *Img : SortedImgs)
+    ImgsSize += Img->getSize();
+  size_t Size = 0;
+  if (!Reader.read(Size) || Size != ImgsSize)
     return false;
-
-  FileStream.close();
-
-  if (FileStream.fail()) {
-    trace("Failed to read source file from " + FileName);
+  for (const RTDeviceBinaryImage *Img : SortedImgs) {
+    const char *Value = Reader.take(Img->getSize());
+    if (!Value || std::memcmp(Value, Img->getRawData().BinaryStart,
+                              Img->getSize()) != 0)
+      return false;
   }
 
   return true;
@@ -373,11 +893,9 @@ bool PersistentDeviceCodeCache::isCacheItemSrcEqual(
 std::string PersistentDeviceCodeCache::getCacheItemPath(
     const device &Device, const std::vector<const RTDeviceBinaryImage *> &Imgs,
     const SerializedObj &SpecConsts, const std::string &BuildOptionsString) {
-  std::string cache_root{getRootDir()};
-  if (cache_root.empty()) {
-    trace("Disable persistent cache due to unconfigured cache root.");
+  std::string DeviceDir{getDeviceDir(Device)};
+  if (DeviceDir.empty())
     return {};
-  }
 
   std::string ImgsString;
   for (const RTDeviceBinaryImage *Img : Imgs)
@@ -385,17 +903,28 @@ std::string PersistentDeviceCodeCache::getCacheItemPath(
       ImgsString.append((const char *)Img->getRawData().BinaryStart,
                         Img->getSize());
 
-  std::string DeviceString{getDeviceIDString(Device)};
   std::string SpecConstsString{(const char *)SpecConsts.data(),
                                SpecConsts.size()};
   std::hash<std::string> StringHasher{};
 
-  return cache_root + "/" + std::to_string(StringHasher(DeviceString)) + "/" +
-         std::to_string(StringHasher(ImgsString)) + "/" +
+  return DeviceDir + "/" + std::to_string(StringHasher(ImgsString)) + "/" +
          std::to_string(StringHasher(SpecConstsString)) + "/" +
          std::to_string(StringHasher(BuildOptionsString));
 }
 
+/* Returns directory name to store kernel images for specified device.
+ */
+std::string PersistentDeviceCodeCache::getDeviceDir(const device &Device) {
+  std::string cache_root{getRootDir()};
+  if (cache_root.empty()) {
+    trace("Disable persistent cache due to unconfigured cache root.");
+    return {};
+  }
+  std::hash<std::string> StringHasher{};
+  return cache_root + "/" +
+         std::to_string(StringHasher(getDeviceIDString(Device)));
+}
+
 /* Returns true if persistent cache is enabled.
  */
 bool PersistentDeviceCodeCache::isEnabled() {
@@ -87,6 +87,35 @@ class PersistentDeviceCodeCache {
    *   <n>.lock - cache item lock file. It is created when data is saved to
    *              filesystem. On read operation the absence of file is checked
    *              but it is not created to avoid lock.
+   * Finalized command graph layouts are stored next to the device code:
+   *   <cache_root>/<device_hash>/graph/<graph_key_hash>/<n>.{src,bin,lock}
+   * where the .src file holds the full graph key and the .bin file holds the
+   * layout produced by the graph runtime. Device code produced by the JIT
+   * compiler of the runtime is stored the same way under
+   *   <cache_root>/<device_hash>/jit/<jit_key_hash>/<n>.{src,bin,lock}
+   * and SPIR-V compiled from SYCL source by the kernel_compiler under
+   *   <cache_root>/<device_hash>/rtc/<rtc_key_hash>/<n>.{src,bin,lock}
+   * In addition every <device_hash> directory holds an index file which maps
+   * the hashed key of a cache item (the path below <device_hash>) to the
+   * cache items stored for it:
+   *   <cache_root>/<device_hash>/index
+   * Format: sequence of [key hash, path size, path] records, path being
+   * relative to <device_hash> and not including the file extension. Records
+   * are appended once the item files are complete, so a lookup reads a single
+   * file instead of probing the directory tree. Caches created without the
+   * index are still looked up by walking the directories, and items found
+   * this way are added to the index.
+   * Usage of cache items is tracked in a ledger shared by all processes using
+   * the cache:
+   *   <cache_root>/usage
+   * Format: sequence of [time, size, path size, path] records, path being
+   * relative to <cache_root> and not including the file extension. A record
+   * with non-zero size is added when the item is created, records with zero
+   * size mark cache hits. Records are appended from the host task thread pool,
+   * which also evicts least recently used items when the cache exceeds
+   * SYCL_CACHE_MAX_SIZE bytes and items unused for SYCL_CACHE_THRESHOLD days.
+   * Eviction is done by a single process at a time (guarded by usage.lock)
+   * and compacts the ledger afterwards.
    * All filesystem operation failures are not treated as SYCL errors and
    * ignored. If such errors happen warning messages are written to std::cerr
    * and:
@@ -106,6 +135,33 @@ private:
   static std::vector<std::vector<char>>
   readBinaryDataFromFile(const std::string &FileName);
 
+  /* Returns relative paths of the cache items recorded for the item
+   * directory RelDir in the index of DeviceDir.
+   */
+  static std::vector<std::string> getIndexedItems(const std::string &DeviceDir,
+                                                  const std::string &RelDir);
+
+  /* Appends record for cache item RelItem to the index of DeviceDir
+   */
+  static void addItemToIndex(const std::string &DeviceDir,
+                             const std::string &RelItem);
+
+  /* Queues usage record of the cache item FileName (path without extension)
+   * and schedules background maintenance of the cache. Size is the size of
+   * a new item and zero for a cache hit.
+   */
+  static void recordItemUsage(const std::string &FileName, size_t Size);
+
+  /* Writes queued usage records to the ledger and evicts cache items if
+   * needed. Runs on the host task thread pool.
+   */
+  static void runMaintenance();
+
+  /* Removes least recently used items according to the ledger and compacts
+   * the ledger. Does nothing if another process is evicting.
+   */
+  static void evictItems(const std::string &RootDir);
+
   /* Writing cache item key sources to be used for reliable identification
    * Format: Four pairs of [size, value] for device, build options,
    * specialization constant values, device code SPIR-V images.
@@ -123,13 +179,37 @@ private:
       const std::vector<const RTDeviceBinaryImage *> &SortedImgs,
       const SerializedObj &SpecConsts, const std::string &BuildOptionsString);
 
-  /* Check if on-disk cache enabled.
+  /* Data of Category (graph or jit) stored for the key Key is read from
+   * persistent cache. Empty vector is returned on cache miss.
    */
-  static bool isEnabled();
+  static std::vector<char> getKeyedItemFromDisc(const device &Device,
+                                                const std::string &Category,
+                                                const std::string &Key);
+
+  /* Stores data of Category (graph or jit) for the key Key in persistent cache
+   */
+  static void putKeyedItemToDisc(const device &Device,
+                                 const std::string &Category,
+                                 const std::string &Key,
+                                 const std::vector<char> &Data);
+
+  /* Same as above, for the items stored in the directory Dir rather than in
+   * the directory of a device.
+   */
+  static std::vector<char> getKeyedItemFromDisc(const std::string &Dir,
+                                                const std::string &Category,
+                                                const std::string &Key);
+  static void putKeyedItemToDisc(const std::string &Dir,
+                                 const std::string &Category,
+                                 const std::string &Key,
+                                 const std::vector<char> &Data);
 
   /* Returns the path to directory storing persistent device code cache.*/
   static std::string getRootDir();
 
+  /* Returns the path to directory storing cache items for the device.*/
+  static std::string getDeviceDir(const device &Device);
+
   /* Form string representing device version */
   static std::string getDeviceIDString(const device &Device);
 
@@ -160,7 +240,18 @@ private:
   static constexpr unsigned long DEFAULT_MAX_DEVICE_IMAGE_SIZE =
       1024 * 1024 * 1024;
 
+  /* Default value for maximum cache size in bytes, zero means no limit */
+  static constexpr unsigned long DEFAULT_MAX_CACHE_SIZE = 0;
+
+  /* Default number of days after which unused items are evicted, zero means
+   * no limit */
+  static constexpr unsigned long DEFAULT_CACHE_THRESHOLD = 0;
+
 public:
+  /* Check if on-disk cache enabled.
+   */
+  static bool isEnabled();
+
   /* Get directory name for storing current cache item
    */
   static std::string
@@ -188,6 +279,55 @@ public:
                 const std::string &BuildOptionsString,
                 const ur_program_handle_t &NativePrg);
 
+  /* Command graph data stored for the graph key GraphKey is read from
+   * persistent cache. Empty vector is returned on cache miss.
+   */
+  static std::vector<char> getGraphItemFromDisc(const device &Device,
+                                                const std::string &GraphKey);
+
+  /* Stores command graph data for the graph key GraphKey in persistent cache
+   */
+  static void putGraphItemToDisc(const device &Device,
+                                 const std::string &GraphKey,
+                                 const std::vector<char> &Data);
+
+  /* Device code produced by the JIT compiler for the key JITKey is read from
+   * persistent cache. Empty vector is returned on cache miss.
+   */
+  static std::vector<char> getJITItemFromDisc(const device &Device,
+                                              const std::string &JITKey);
+
+  /* Stores device code produced by the JIT compiler for the key JITKey in
+   * persistent cache
+   */
+  static void putJITItemToDisc(const device &Device, const std::string &JITKey,
+                               const std::vector<char> &Data);
+
+  /* SPIR-V compiled from SYCL source for the key RTCKey is read from
+   * persistent cache. Empty vector is returned on cache miss.
+   */
+  static std::vector<char> getRTCItemFromDisc(const device &Device,
+                                              const std::string &RTCKey);
+
+  /* Stores SPIR-V compiled from SYCL source for the key RTCKey in persistent
+   * cache
+   */
+  static void putRTCItemToDisc(const device &Device, const std::string &RTCKey,
+                               const std::vector<char> &Data);
+
+  /* SPIR-V compiled by the online compiler for the key Key is read from
+   * persistent cache. Empty vector is returned on cache miss. The items are
+   * not specific to a device, the target is part of the key.
+   */
+  static std::vector<char>
+  getOnlineCompilerItemFromDisc(const std::string &Key);
+
+  /* Stores SPIR-V compiled by the online compiler for the key Key in
+   * persistent cache
+   */
+  static void putOnlineCompilerItemToDisc(const std::string &Key,
+                                          const std::vector<char> &Data);
+
   /* Sends message to std:cerr stream when SYCL_CACHE_TRACE environemnt is set*/
   static void trace(const std::string &msg) {
     static const char *TraceEnabled = SYCLConfig<SYCL_CACHE_TRACE>::get();
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <future>
 #include <mutex>
 #include <string>
 #include <unordered_set>
@@ -147,12 +148,34 @@ std::vector<platform> platform_impl::get_platforms() {
   std::vector<AdapterPtr> &Adapters = sycl::detail::ur::initializeUr();
   std::vector<std::pair<platform, AdapterPtr>> PlatformsWithAdapter;
 
-  // Then check backend-specific adapters
-  for (auto &Adapter : Adapters) {
-    const auto &AdapterPlatforms = getAdapterPlatforms(Adapter);
-    for (const auto &P : AdapterPlatforms) {
-      PlatformsWithAdapter.push_back({P, Adapter});
-    }
+  // ONEAPI_DEVICE_SELECTOR discards all the devices of the backends it doesn't
+  // select, so their platforms would have no devices and wouldn't be reported.
+  // They are not enumerated at all, which spares the initialization of their
+  // drivers and the enumeration of their devices.
+  ods_target_list *OdsTargetList = SYCLConfig<ONEAPI_DEVICE_SELECTOR>::get();
+
+  // Then check backend-specific adapters. Initializing the drivers and
+  // enumerating the devices is the bulk of the first call, the adapters are
+  // independent so they are enumerated concurrently. The platforms are still
+  // reported in the order of the adapters.
+  std::vector<AdapterPtr *> SelectedAdapters;
+  for (auto &Adapter : Adapters)
+    if (!OdsTargetList ||
+        OdsTargetList->backendCompatible(Adapter->getBackend()))
+      SelectedAdapters.push_back(&Adapter);
+  std::vector<std::future<std::vector<platform>>> AdapterPlatforms;
+  for (size_t I = 1; I < SelectedAdapters.size(); ++I)
+    AdapterPlatforms.push_back(
+        std::async(std::launch::async, [Adapter = SelectedAdapters[I]]() {
+          return getAdapterPlatforms(*Adapter);
+        }));
+  for (size_t I = 0; I < SelectedAdapters.size(); ++I) {
+    // The first adapter is enumerated by this thread meanwhile.
+    std::vector<platform> Platforms =
+        I == 0 ? getAdapterPlatforms(*SelectedAdapters[0])
+               : AdapterPlatforms[I - 1].get();
+    for (const auto &P : Platforms)
+      PlatformsWithAdapter.push_back({P, *SelectedAdapters[I]});
   }
 
   // For the selected platforms register them with their adapters
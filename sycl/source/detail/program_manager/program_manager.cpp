@@ -13,13 +13,17 @@
 #include <detail/device_impl.hpp>
 #include <detail/event_impl.hpp>
 #include <detail/global_handler.hpp>
+#include <detail/kernel_info.hpp>
 #include <detail/persistent_device_code_cache.hpp>
 #include <detail/platform_impl.hpp>
 #include <detail/program_manager/program_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/spec_constant_impl.hpp>
 #include <detail/split_string.hpp>
+#include <detail/submission_stats.hpp>
+#include <detail/thread_pool.hpp>
 #include <detail/ur_info_code.hpp>
+#include <detail/work_group_counters.hpp>
 #include <sycl/aspects.hpp>
 #include <sycl/backend_types.hpp>
 #include <sycl/context.hpp>
@@ -34,15 +38,20 @@
 #include <sycl/ext/oneapi/matrix/query-types.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <condition_variable>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <exception>
 #include <fstream>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <variant>
 
 namespace sycl {
@@ -57,10 +66,16 @@ static constexpr char UseSpvEnv[]("SYCL_USE_KERNEL_SPV");
 
 /// This function enables ITT annotations in SPIR-V module by setting
 /// a specialization constant if INTEL_LIBITTNOTIFY64 env variable is set.
+/// The work-group counters are enabled the same way if
+/// SYCL_WORK_GROUP_COUNTERS is set.
 static void enableITTAnnotationsIfNeeded(const ur_program_handle_t &Prog,
                                          const AdapterPtr &Adapter) {
-  if (SYCLConfig<INTEL_ENABLE_OFFLOAD_ANNOTATIONS>::get() != nullptr) {
-    constexpr char SpecValue = 1;
+  char SpecValue = 0;
+  if (SYCLConfig<INTEL_ENABLE_OFFLOAD_ANNOTATIONS>::get() != nullptr)
+    SpecValue |= ITTAnnotationsEnabled;
+  if (WorkGroupCounters::isEnabled())
+    SpecValue |= ITTWorkGroupCountersEnabled;
+  if (SpecValue) {
     ur_specialization_constant_info_t SpecConstInfo = {
         ITTSpecConstId, sizeof(char), &SpecValue};
     Adapter->call<UrApiKind::urProgramSetSpecializationConstants>(
@@ -178,6 +193,16 @@ static bool isDeviceBinaryTypeSupported(const context &C,
   return "unknown";
 }
 
+// Compressed images are decompressed on first use, i.e. once they are selected
+// for a device, so that images of unused targets are never decompressed.
+static void CheckAndDecompressImage([[maybe_unused]] RTDeviceBinaryImage *Img) {
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+  if (auto CompImg = dynamic_cast<CompressedRTDeviceBinaryImage *>(Img))
+    if (CompImg->isCompressed())
+      CompImg->decompress();
+#endif
+}
+
 ur_program_handle_t
 ProgramManager::createURProgram(const RTDeviceBinaryImage &Img,
                                 const context &Context, const device &Device) {
@@ -185,6 +210,7 @@ ProgramManager::createURProgram(const RTDeviceBinaryImage &Img,
     std::cerr << ">>> ProgramManager::createPIProgram(" << &Img << ", "
               << getSyclObjImpl(Context).get() << ", "
               << getSyclObjImpl(Device).get() << ")\n";
+  CheckAndDecompressImage(const_cast<RTDeviceBinaryImage *>(&Img));
   const sycl_device_binary_struct &RawImg = Img.getRawData();
 
   // perform minimal sanity checks on the device image and the descriptor
@@ -495,6 +521,10 @@ std::pair<ur_program_handle_t, bool> ProgramManager::getOrCreateURProgram(
     const std::string &CompileAndLinkOptions, SerializedObj SpecConsts) {
   ur_program_handle_t NativePrg; // TODO: Or native?
 
+  // The persistent cache compares the decompressed image contents.
+  for (const RTDeviceBinaryImage *Img : AllImages)
+    CheckAndDecompressImage(const_cast<RTDeviceBinaryImage *>(Img));
+
   auto BinProg = PersistentDeviceCodeCache::getItemFromDisc(
       Device, AllImages, SpecConsts, CompileAndLinkOptions);
   if (BinProg.size()) {
@@ -526,6 +556,31 @@ static void emitBuiltProgramInfo(const ur_program_handle_t &Prog,
   }
 }
 
+/// Reports the registers and the spill memory the backend compiler allocated
+/// for a kernel created for a device: all the kernels are reported when
+/// SYCL_REPORT_KERNEL_RESOURCES is set, the kernels which spill are when
+/// SYCL_RT_WARNING_LEVEL is greater than or equal to 1.
+static void reportKernelResourceUsage(ur_kernel_handle_t Kernel,
+                                      const std::string &KernelName,
+                                      const DeviceImplPtr &DeviceImpl) {
+  bool ReportAll = SYCLConfig<SYCL_REPORT_KERNEL_RESOURCES>::get();
+  if (!ReportAll && SYCLConfig<SYCL_RT_WARNING_LEVEL>::get() < 1)
+    return;
+  KernelResourceUsage Usage = getKernelResourceUsage(
+      Kernel, DeviceImpl->getHandleRef(), DeviceImpl->getAdapter());
+  // The values the backend doesn't report are 0.
+  if (ReportAll)
+    std::clog << "Kernel " << KernelName << " on "
+              << DeviceImpl->getDeviceName() << ": " << Usage.NumRegs
+              << " registers, " << Usage.SpillMemSize
+              << " bytes of spill memory.\n";
+  else if (Usage.SpillMemSize > 0)
+    std::clog << "WARNING: kernel " << KernelName << " spills "
+              << Usage.SpillMemSize << " bytes of registers to memory on "
+              << DeviceImpl->getDeviceName()
+              << ", which may degrade its performance.\n";
+}
+
 static const char *getUrDeviceTarget(const char *URDeviceTarget) {
   if (strcmp(URDeviceTarget, __SYCL_DEVICE_BINARY_TARGET_UNKNOWN) == 0)
     return UR_DEVICE_BINARY_TARGET_UNKNOWN;
@@ -616,9 +671,7 @@ ProgramManager::collectDeviceImageDepsForImportedSymbols(
     bool Found = false;
     for (auto It = Range.first; It != Range.second; ++It) {
       RTDeviceBinaryImage *Img = It->second;
-      if (Img->getFormat() != Format ||
-          !doesDevSupportDeviceRequirements(Dev, *Img) ||
-          !compatibleWithDevice(Img, Dev))
+      if (Img->getFormat() != Format || !isImageCompatible(Img, Dev))
         continue;
       DeviceImagesToLink.insert(Img);
       Found = true;
@@ -878,8 +931,8 @@ ur_program_handle_t ProgramManager::getBuiltURProgram(
 
   uint32_t ImgId = Img.getImageID();
   const ur_device_handle_t UrDevice = Dev->getHandleRef();
-  auto CacheKey =
-      std::make_pair(std::make_pair(std::move(SpecConsts), ImgId), UrDevice);
+  KernelProgramCache::ProgramCacheKeyT CacheKey{{std::move(SpecConsts), ImgId},
+                                                UrDevice};
 
   auto GetCachedBuildF = [&Cache, &CacheKey]() {
     return Cache.getOrInsertProgram(CacheKey);
@@ -913,17 +966,117 @@ ur_program_handle_t ProgramManager::getBuiltURProgram(
   // caller. In that case, we need to increase the ref count of the
   // program.
   ContextImpl->getAdapter()->call<UrApiKind::urProgramRetain>(ResProgram);
+
+  // The returned handle is retained above, so the program stays valid for the
+  // caller even if it gets evicted from the cache right away.
+  Cache.registerProgramUsage(ResProgram);
   return ResProgram;
 }
 
+namespace {
+// Records the names of the kernels launched by the application for
+// SYCL_KERNEL_PROFILE and adds them to the profile file at exit, so the file
+// accumulates the kernels of several runs.
+struct KernelProfileRecorder {
+  static const std::string &getPath() {
+    static const std::string Path = SYCLConfig<SYCL_KERNEL_PROFILE>::get();
+    return Path;
+  }
+
+  static void record(const std::string &KernelName) {
+    if (getPath().empty())
+      return;
+    std::lock_guard<std::mutex> Lock(getMutex());
+    getKernelNames().insert(KernelName);
+  }
+
+  ~KernelProfileRecorder() {
+    if (getPath().empty())
+      return;
+    std::lock_guard<std::mutex> Lock(getMutex());
+    std::set<std::string> &KernelNames = getKernelNames();
+    if (KernelNames.empty())
+      return;
+    {
+      std::ifstream In{getPath()};
+      for (std::string Line; std::getline(In, Line);)
+        if (!Line.empty())
+          KernelNames.insert(Line);
+    }
+    std::ofstream Out{getPath(), std::ios::trunc};
+    for (const std::string &Name : KernelNames)
+      Out << Name << '\n';
+  }
+
+private:
+  // Never destroyed, kernels may be launched by the destructors of other
+  // static objects.
+  static std::mutex &getMutex() {
+    static std::mutex *Mutex = new std::mutex();
+    return *Mutex;
+  }
+  static std::set<std::string> &getKernelNames() {
+    static std::set<std::string> *Names = new std::set<std::string>();
+    return *Names;
+  }
+} GKernelProfileRecorder;
+} // namespace
+
+void ProgramManager::buildProgramsAsync(const ContextImplPtr &ContextImpl,
+                                        const std::vector<device> &Devs,
+                                        bool OnlyHotImages) {
+  // Without the in-memory cache there is nowhere to keep the results.
+  if (!SYCLConfig<SYCL_CACHE_IN_MEM>::get() || m_UseSpvFile)
+    return;
+
+  // One kernel per device image is enough: the other kernels of the image
+  // are served by the same program.
+  std::vector<std::string> KernelNames;
+  {
+    std::lock_guard<std::mutex> KernelIDsGuard(m_KernelIDsMutex);
+    KernelNames.reserve(m_BinImg2KernelIDs.size());
+    std::unordered_set<std::string> Seen;
+    for (const auto &[Img, KernelIDs] : m_BinImg2KernelIDs) {
+      if (!KernelIDs || KernelIDs->empty())
+        continue;
+      if (OnlyHotImages && !getUint32PropAsBool(*Img, "hotKernels"))
+        continue;
+      std::string Name = KernelIDs->front().get_name();
+      if (Seen.insert(Name).second)
+        KernelNames.push_back(std::move(Name));
+    }
+  }
+
+  ThreadPool &Pool = GlobalHandler::instance().getHostTaskThreadPool();
+  for (const device &Dev : Devs) {
+    DeviceImplPtr DeviceImpl = getSyclObjImpl(Dev);
+    for (const std::string &KernelName : KernelNames) {
+      Pool.submit([this, ContextImpl, DeviceImpl, KernelName]() {
+        try {
+          ur_program_handle_t Program =
+              getBuiltURProgram(ContextImpl, DeviceImpl, KernelName);
+          // The cache keeps its own reference to the program.
+          ContextImpl->getAdapter()->call<UrApiKind::urProgramRelease>(
+              Program);
+        } catch (...) {
+          // The kernel may be unsupported by the device, or its build may
+          // fail. Failed builds are recorded in the cache and are reported
+          // to the user by the first submission of the kernel.
+        }
+      });
+    }
+  }
+}
+
 // When caching is enabled, the returned UrProgram and UrKernel will
 // already have their ref count incremented.
 std::tuple<ur_kernel_handle_t, std::mutex *, const KernelArgMask *,
-           ur_program_handle_t>
+           ur_program_handle_t, KernelArgCache *>
 ProgramManager::getOrCreateKernel(const ContextImplPtr &ContextImpl,
                                   const DeviceImplPtr &DeviceImpl,
                                   const std::string &KernelName,
                                   const NDRDescT &NDRDesc) {
+  SubmissionPhaseTimer Timer(submission_phase::kernel_lookup);
   if constexpr (DbgProgMgr > 0) {
     std::cerr << ">>> ProgramManager::getOrCreateKernel(" << ContextImpl.get()
               << ", " << DeviceImpl.get() << ", " << KernelName << ")\n";
@@ -958,15 +1111,17 @@ ProgramManager::getOrCreateKernel(const ContextImplPtr &ContextImpl,
     }
   }
 
+  KernelProfileRecorder::record(KernelName);
   ur_program_handle_t Program =
       getBuiltURProgram(ContextImpl, DeviceImpl, KernelName, NDRDesc);
 
-  auto BuildF = [this, &Program, &KernelName, &ContextImpl] {
+  auto BuildF = [this, &Program, &KernelName, &ContextImpl, &DeviceImpl] {
     ur_kernel_handle_t Kernel = nullptr;
 
     const AdapterPtr &Adapter = ContextImpl->getAdapter();
     Adapter->call<errc::kernel_not_supported, UrApiKind::urKernelCreate>(
         Program, KernelName.c_str(), &Kernel);
+    reportKernelResourceUsage(Kernel, KernelName, DeviceImpl);
 
     // Only set UR_USM_INDIRECT_ACCESS if the platform can handle it.
     if (ContextImpl->getPlatformImpl()->supports_usm()) {
@@ -993,16 +1148,16 @@ ProgramManager::getOrCreateKernel(const ContextImplPtr &ContextImpl,
     // threads when caching is disabled, so we can return
     // nullptr for the mutex.
     auto [Kernel, ArgMask] = BuildF();
-    return make_tuple(Kernel, nullptr, ArgMask, Program);
+    return make_tuple(Kernel, nullptr, ArgMask, Program, nullptr);
   }
 
   auto BuildResult = Cache.getOrBuild<errc::invalid>(GetCachedBuildF, BuildF);
   // getOrBuild is not supposed to return nullptr
   assert(BuildResult != nullptr && "Invalid build result");
   const KernelArgMaskPairT &KernelArgMaskPair = BuildResult->Val;
-  auto ret_val = std::make_tuple(KernelArgMaskPair.first,
-                                 &(BuildResult->MBuildResultMutex),
-                                 KernelArgMaskPair.second, Program);
+  auto ret_val = std::make_tuple(
+      KernelArgMaskPair.first, &(BuildResult->MBuildResultMutex),
+      KernelArgMaskPair.second, Program, &(BuildResult->MArgCache));
   // If caching is enabled, one copy of the kernel handle will be
   // stored in the cache, and one handle is returned to the
   // caller. In that case, we need to increase the ref count of the
@@ -1177,8 +1332,11 @@ static ur_program_handle_t loadDeviceLibFallback(const ContextImplPtr Context,
 
   auto LibFileName = getDeviceLibFilename(Extension, UseNativeLib);
 
+  // A library program is loaded and compiled once per context and device, the
+  // programs which need it link the compiled library, so that only the
+  // functions they use end up in the linked program.
   auto LockedCache = Context->acquireCachedLibPrograms();
-  auto CachedLibPrograms = LockedCache.get();
+  auto &CachedLibPrograms = LockedCache.get();
   auto CacheResult = CachedLibPrograms.emplace(
       std::make_pair(std::make_pair(Extension, Device), nullptr));
   bool Cached = !CacheResult.second;
@@ -1341,6 +1499,17 @@ RTDeviceBinaryImage *getBinImageFromMultiMap(
   if (DeviceFilteredImgs.empty())
     return nullptr;
 
+  // The images are looked up by kernel name for the programs which are built
+  // without a kernel bundle, none of their specialization constants is set.
+  // The images with the default values of the specialization constants are
+  // put first, the native runtime picks them over the other images for the
+  // same target and they are built without being specialized.
+  std::stable_partition(DeviceFilteredImgs.begin(), DeviceFilteredImgs.end(),
+                        [](RTDeviceBinaryImage *Img) {
+                          return getUint32PropAsBool(
+                              *Img, "specConstsReplacedWithDefault");
+                        });
+
   std::vector<ur_device_binary_t> UrBinaries(DeviceFilteredImgs.size());
   for (uint32_t BinaryCount = 0; BinaryCount < DeviceFilteredImgs.size();
        BinaryCount++) {
@@ -1392,6 +1561,7 @@ ProgramManager::getDeviceImage(const std::string &KernelName,
   }
   if (Img) {
     CheckJITCompilationForImage(Img, JITCompilationIsRequired);
+    CheckAndDecompressImage(Img);
 
     if constexpr (DbgProgMgr > 0) {
       std::cerr << "selected device image: " << &Img->getRawData() << "\n";
@@ -1444,6 +1614,7 @@ RTDeviceBinaryImage &ProgramManager::getDeviceImage(
   std::advance(ImageIterator, ImgInd);
 
   CheckJITCompilationForImage(*ImageIterator, JITCompilationIsRequired);
+  CheckAndDecompressImage(*ImageIterator);
 
   if constexpr (DbgProgMgr > 0) {
     std::cerr << "selected device image: " << &(*ImageIterator)->getRawData()
@@ -1650,8 +1821,75 @@ bool ProgramManager::kernelUsesAssert(const std::string &KernelName) const {
   return m_KernelUsesAssert.find(KernelName) != m_KernelUsesAssert.end();
 }
 
+static bool isNullOrEqual(const char *LHS, const char *RHS) {
+  if (!LHS || !RHS)
+    return LHS == RHS;
+  return std::strcmp(LHS, RHS) == 0;
+}
+
+/// Returns the hash of the binary and the target of the image, to find the
+/// copies of the image that other libraries register.
+static size_t getImageHash(const RTDeviceBinaryImage &Img) {
+  const sycl_device_binary_struct &RawImg = Img.getRawData();
+  size_t Hash = std::hash<std::string_view>{}(std::string_view(
+      reinterpret_cast<const char *>(RawImg.BinaryStart), Img.getSize()));
+  if (RawImg.DeviceTargetSpec)
+    Hash ^= std::hash<std::string_view>{}(RawImg.DeviceTargetSpec) +
+            0x9e3779b9 + (Hash << 6) + (Hash >> 2);
+  return Hash;
+}
+
+static bool arePropertiesEqual(const sycl_device_binary_property_struct &LHS,
+                               const sycl_device_binary_property_struct &RHS) {
+  if (LHS.Type != RHS.Type || LHS.ValSize != RHS.ValSize ||
+      !isNullOrEqual(LHS.Name, RHS.Name))
+    return false;
+  // Integer properties are stored in the size, without a value.
+  if (!LHS.ValAddr || !RHS.ValAddr)
+    return LHS.ValAddr == RHS.ValAddr;
+  return std::memcmp(LHS.ValAddr, RHS.ValAddr, LHS.ValSize) == 0;
+}
+
+/// Returns whether the images are byte-identical copies: same binary, target,
+/// options, kernels and properties.
+static bool areImagesIdentical(const RTDeviceBinaryImage &LHS,
+                               const RTDeviceBinaryImage &RHS) {
+  const sycl_device_binary_struct &L = LHS.getRawData();
+  const sycl_device_binary_struct &R = RHS.getRawData();
+  if (L.Format != R.Format || LHS.getSize() != RHS.getSize() ||
+      !isNullOrEqual(L.DeviceTargetSpec, R.DeviceTargetSpec) ||
+      !isNullOrEqual(L.CompileOptions, R.CompileOptions) ||
+      !isNullOrEqual(L.LinkOptions, R.LinkOptions) ||
+      std::memcmp(L.BinaryStart, R.BinaryStart, LHS.getSize()) != 0)
+    return false;
+
+  if (L.EntriesEnd - L.EntriesBegin != R.EntriesEnd - R.EntriesBegin ||
+      !std::equal(L.EntriesBegin, L.EntriesEnd, R.EntriesBegin,
+                  [](const auto &LEntry, const auto &REntry) {
+                    return isNullOrEqual(LEntry.name, REntry.name);
+                  }))
+    return false;
+
+  if (L.PropertySetsEnd - L.PropertySetsBegin !=
+      R.PropertySetsEnd - R.PropertySetsBegin)
+    return false;
+  for (auto LSet = L.PropertySetsBegin, RSet = R.PropertySetsBegin;
+       LSet != L.PropertySetsEnd; ++LSet, ++RSet) {
+    if (!isNullOrEqual(LSet->Name, RSet->Name) ||
+        LSet->PropertiesEnd - LSet->PropertiesBegin !=
+            RSet->PropertiesEnd - RSet->PropertiesBegin ||
+        !std::equal(LSet->PropertiesBegin, LSet->PropertiesEnd,
+                    RSet->PropertiesBegin, arePropertiesEqual))
+      return false;
+  }
+  return true;
+}
+
 void ProgramManager::addImages(sycl_device_binaries DeviceBinary) {
   const bool DumpImages = std::getenv("SYCL_DUMP_IMAGES") && !m_UseSpvFile;
+  // Hold the lock for the whole registration, so that the copies of an image
+  // registered concurrently aren't used before the first one is registered.
+  std::lock_guard<std::mutex> ImageHashesGuard(m_ImageHashesMutex);
   for (int I = 0; I < DeviceBinary->NumDeviceBinaries; I++) {
     sycl_device_binary RawImg = &(DeviceBinary->DeviceBinaries[I]);
     const sycl_offload_entry EntriesB = RawImg->EntriesBegin;
@@ -1660,18 +1898,38 @@ void ProgramManager::addImages(sycl_device_binaries DeviceBinary) {
     if (EntriesB == EntriesE)
       continue;
 
-    auto Img = std::make_unique<RTDeviceBinaryImage>(RawImg);
+    std::unique_ptr<RTDeviceBinaryImage> Img;
+    if (RawImg->Format == SYCL_DEVICE_BINARY_TYPE_COMPRESSED_NONE) {
+#ifdef SYCL_RT_ZSTD_AVAILABLE
+      Img = std::make_unique<CompressedRTDeviceBinaryImage>(RawImg);
+#else
+      throw sycl::exception(make_error_code(errc::feature_not_supported),
+                            "Compressed device images are not supported: the "
+                            "SYCL runtime was built without zstd support");
+#endif
+    } else {
+      Img = std::make_unique<RTDeviceBinaryImage>(RawImg);
+    }
+
+    // Libraries built from the same sources carry identical copies of the
+    // images of their common kernels. Use the image registered first for all
+    // of them, so that the copies share its kernel IDs and programs built
+    // from it instead of being built again.
+    size_t ImgHash = getImageHash(*Img);
+    auto [HashBegin, HashEnd] = m_ImageHashes.equal_range(ImgHash);
+    if (std::any_of(HashBegin, HashEnd, [&](const auto &HashAndImg) {
+          return areImagesIdentical(*HashAndImg.second, *Img);
+        }))
+      continue;
+    m_ImageHashes.emplace(ImgHash, Img.get());
+
     static uint32_t SequenceID = 0;
 
-    // Fill the kernel argument mask map
-    const RTDeviceBinaryImage::PropertyRange &KPOIRange =
-        Img->getKernelParamOptInfo();
-    if (KPOIRange.isAvailable()) {
-      KernelNameToArgMaskMap &ArgMaskMap =
-          m_EliminatedKernelArgMasks[Img.get()];
-      for (const auto &Info : KPOIRange)
-        ArgMaskMap[Info->Name] =
-            createKernelArgMask(DeviceBinaryProperty(Info).asByteArray());
+    // Register the image in the kernel argument mask map, the masks are only
+    // parsed when they are looked up.
+    if (Img->getKernelParamOptInfo().isAvailable()) {
+      std::lock_guard<std::mutex> Lock(m_EliminatedKernelArgMasksMutex);
+      m_EliminatedKernelArgMasks[Img.get()];
     }
 
     // Fill maps for kernel bundles
@@ -1700,7 +1958,10 @@ void ProgramManager::addImages(sycl_device_binaries DeviceBinary) {
       dumpImage(*Img, NeedsSequenceID ? ++SequenceID : 0);
     }
 
-    m_BinImg2KernelIDs[Img.get()].reset(new std::vector<kernel_id>);
+    std::shared_ptr<std::vector<kernel_id>> &ImgKernelIDs =
+        m_BinImg2KernelIDs[Img.get()];
+    ImgKernelIDs.reset(new std::vector<kernel_id>);
+    ImgKernelIDs->reserve(EntriesE - EntriesB);
 
     for (sycl_offload_entry EntriesIt = EntriesB; EntriesIt != EntriesE;
          ++EntriesIt) {
@@ -1732,7 +1993,7 @@ void ProgramManager::addImages(sycl_device_binaries DeviceBinary) {
         It = m_KernelName2KernelIDs.emplace_hint(It, EntriesIt->name, KernelID);
       }
       m_KernelIDs2BinImage.insert(std::make_pair(It->second, Img.get()));
-      m_BinImg2KernelIDs[Img.get()]->push_back(It->second);
+      ImgKernelIDs->push_back(It->second);
     }
 
     cacheKernelUsesAssertInfo(*Img);
@@ -1745,8 +2006,8 @@ void ProgramManager::addImages(sycl_device_binaries DeviceBinary) {
     }
 
     // Sort kernel ids for faster search
-    std::sort(m_BinImg2KernelIDs[Img.get()]->begin(),
-              m_BinImg2KernelIDs[Img.get()]->end(), LessByHash<kernel_id>{});
+    std::sort(ImgKernelIDs->begin(), ImgKernelIDs->end(),
+              LessByHash<kernel_id>{});
 
     // ... and initialize associated device_global information
     {
@@ -1865,9 +2126,32 @@ uint32_t ProgramManager::getDeviceLibReqMask(const RTDeviceBinaryImage &Img) {
     return 0x0;
 }
 
+const ProgramManager::KernelNameToArgMaskMap &
+ProgramManager::getImageArgMasks(const RTDeviceBinaryImage *Img,
+                                 ImageArgMasks &Entry) {
+  if (!Entry.Parsed) {
+    for (const auto &Info : Img->getKernelParamOptInfo())
+      Entry.Masks[Info->Name] =
+          createKernelArgMask(DeviceBinaryProperty(Info).asByteArray());
+    Entry.Parsed = true;
+  }
+  return Entry.Masks;
+}
+
+std::vector<const RTDeviceBinaryImage *>
+ProgramManager::getNativeProgramImages(ur_program_handle_t NativePrg) {
+  std::lock_guard<std::mutex> Lock(MNativeProgramsMutex);
+  std::vector<const RTDeviceBinaryImage *> Images;
+  auto Range = NativePrograms.equal_range(NativePrg);
+  for (auto ImgIt = Range.first; ImgIt != Range.second; ++ImgIt)
+    Images.push_back(ImgIt->second);
+  return Images;
+}
+
 const KernelArgMask *
 ProgramManager::getEliminatedKernelArgMask(ur_program_handle_t NativePrg,
                                            const std::string &KernelName) {
+  std::lock_guard<std::mutex> MasksLock(m_EliminatedKernelArgMasksMutex);
   // Bail out if there are no eliminated kernel arg masks in our images
   if (m_EliminatedKernelArgMasks.empty())
     return nullptr;
@@ -1879,9 +2163,11 @@ ProgramManager::getEliminatedKernelArgMask(ur_program_handle_t NativePrg,
       auto MapIt = m_EliminatedKernelArgMasks.find(ImgIt->second);
       if (MapIt == m_EliminatedKernelArgMasks.end())
         continue;
-      auto ArgMaskMapIt = MapIt->second.find(KernelName);
-      if (ArgMaskMapIt != MapIt->second.end())
-        return &MapIt->second[KernelName];
+      const KernelNameToArgMaskMap &Masks =
+          getImageArgMasks(MapIt->first, MapIt->second);
+      auto ArgMaskMapIt = Masks.find(KernelName);
+      if (ArgMaskMapIt != Masks.end())
+        return &ArgMaskMapIt->second;
     }
     if (Range.first != Range.second)
       return nullptr;
@@ -1890,8 +2176,10 @@ ProgramManager::getEliminatedKernelArgMask(ur_program_handle_t NativePrg,
   // If the program was not cached iterate over all available images looking for
   // the requested kernel
   for (auto &Elem : m_EliminatedKernelArgMasks) {
-    auto ArgMask = Elem.second.find(KernelName);
-    if (ArgMask != Elem.second.end())
+    const KernelNameToArgMaskMap &Masks =
+        getImageArgMasks(Elem.first, Elem.second);
+    auto ArgMask = Masks.find(KernelName);
+    if (ArgMask != Masks.end())
       return &ArgMask->second;
   }
 
@@ -1932,7 +2220,41 @@ bool ProgramManager::hasCompatibleImage(const device &Dev) {
       m_BinImg2KernelIDs.cbegin(), m_BinImg2KernelIDs.cend(),
       [&](std::pair<RTDeviceBinaryImage *,
                     std::shared_ptr<std::vector<kernel_id>>>
-              Elem) { return compatibleWithDevice(Elem.first, Dev); });
+              Elem) {
+        return isImageCompatible(Elem.first, Dev,
+                                 /*CheckRequirements=*/false);
+      });
+}
+
+bool ProgramManager::isImageCompatible(RTDeviceBinaryImage *Img,
+                                       const device &Dev,
+                                       bool CheckRequirements) {
+  ur_device_handle_t Device = getSyclObjImpl(Dev)->getHandleRef();
+  ImageCompatibility Known;
+  {
+    std::lock_guard<std::mutex> Guard(m_ImageCompatibilityMutex);
+    Known = m_ImageCompatibility[Img][Device];
+  }
+
+  // The checks are done without the lock: the threads checking the same pair
+  // concurrently find the same results.
+  bool Updated = false;
+  if (!Known.Target) {
+    Known.Target = compatibleWithDevice(Img, Dev);
+    Updated = true;
+  }
+  if (CheckRequirements && *Known.Target && !Known.Requirements) {
+    Known.Requirements = doesDevSupportDeviceRequirements(Dev, *Img);
+    Updated = true;
+  }
+  if (Updated) {
+    std::lock_guard<std::mutex> Guard(m_ImageCompatibilityMutex);
+    ImageCompatibility &Entry = m_ImageCompatibility[Img][Device];
+    Entry.Target = Known.Target;
+    if (Known.Requirements)
+      Entry.Requirements = Known.Requirements;
+  }
+  return *Known.Target && (!CheckRequirements || *Known.Requirements);
 }
 
 std::vector<kernel_id> ProgramManager::getAllSYCLKernelIDs() {
@@ -2137,8 +2459,7 @@ ProgramManager::getSYCLDeviceImagesWithCompatibleState(
         KernelImageMap.insert({KernelID, {}});
 
     for (RTDeviceBinaryImage *BinImage : BinImages) {
-      if (!compatibleWithDevice(BinImage, Dev) ||
-          !doesDevSupportDeviceRequirements(Dev, *BinImage))
+      if (!isImageCompatible(BinImage, Dev))
         continue;
 
       auto InsertRes = ImageInfoMap.insert({BinImage, {}});
@@ -2201,6 +2522,10 @@ ProgramManager::getSYCLDeviceImagesWithCompatibleState(
     if (ImgInfoPair.second.RequirementCounter == 0)
       continue;
 
+    // Device images query the format of the binary image, so it has to be
+    // known at this point.
+    CheckAndDecompressImage(ImgInfoPair.first);
+
     DeviceImageImplPtr Impl = std::make_shared<detail::device_image_impl>(
         ImgInfoPair.first, Ctx, Devs, ImgInfoPair.second.State,
         ImgInfoPair.second.KernelIDs, /*PIProgram=*/nullptr);
@@ -2214,7 +2539,7 @@ ProgramManager::getSYCLDeviceImagesWithCompatibleState(
 void ProgramManager::bringSYCLDeviceImagesToState(
     std::vector<device_image_plain> &DeviceImages, bundle_state TargetState) {
 
-  for (device_image_plain &DevImage : DeviceImages) {
+  auto BringToState = [this, TargetState](device_image_plain &DevImage) {
     const bundle_state DevImageState = getSyclObjImpl(DevImage)->get_state();
 
     // At this time, there is no circumstance where a device image should ever
@@ -2268,7 +2593,53 @@ void ProgramManager::bringSYCLDeviceImagesToState(
       break;
     }
     }
+  };
+
+  const size_t Count = DeviceImages.size();
+  if (Count < 2) {
+    for (device_image_plain &DevImage : DeviceImages)
+      BringToState(DevImage);
+    return;
   }
+
+  // The images are built concurrently by the threads of the pool and the
+  // calling thread, which takes the images left by the pool. It makes
+  // progress even if all the workers are busy, e.g. when it is one of them.
+  // The jobs starting after the last image was taken don't touch the images.
+  struct BuildState {
+    std::atomic<size_t> Next{0};
+    std::mutex Mutex;
+    std::condition_variable Finished;
+    size_t Done = 0;
+    std::exception_ptr Error;
+  };
+  auto State = std::make_shared<BuildState>();
+  device_image_plain *Images = DeviceImages.data();
+  auto BuildImages = [State, Images, Count, BringToState]() {
+    for (size_t I = State->Next++; I < Count; I = State->Next++) {
+      std::exception_ptr Error;
+      try {
+        BringToState(Images[I]);
+      } catch (...) {
+        Error = std::current_exception();
+      }
+      std::lock_guard<std::mutex> Lock(State->Mutex);
+      if (Error && !State->Error)
+        State->Error = Error;
+      if (++State->Done == Count)
+        State->Finished.notify_all();
+    }
+  };
+
+  ThreadPool &Pool = GlobalHandler::instance().getHostTaskThreadPool();
+  for (size_t I = 1; I < Count; ++I)
+    Pool.submit(BuildImages);
+  BuildImages();
+
+  std::unique_lock<std::mutex> Lock(State->Mutex);
+  State->Finished.wait(Lock, [&]() { return State->Done == Count; });
+  if (State->Error)
+    std::rethrow_exception(State->Error);
 }
 
 std::vector<device_image_plain>
@@ -2618,8 +2989,8 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
 
   uint32_t ImgId = Img.getImageID();
   ur_device_handle_t UrDevice = getSyclObjImpl(Devs[0]).get()->getHandleRef();
-  auto CacheKey =
-      std::make_pair(std::make_pair(std::move(SpecConsts), ImgId), UrDevice);
+  KernelProgramCache::ProgramCacheKeyT CacheKey{{std::move(SpecConsts), ImgId},
+                                                UrDevice};
 
   // CacheKey is captured by reference so when we overwrite it later we can
   // reuse this function.
@@ -2659,6 +3030,7 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
   // cache. The ref counter will be descremented in the destructor of
   // device_image_impl
   Adapter->call<UrApiKind::urProgramRetain>(ResProgram);
+  Cache.registerProgramUsage(ResProgram);
 
   DeviceImageImplPtr ExecImpl = std::make_shared<detail::device_image_impl>(
       InputImpl->get_bin_image_ref(), Context, Devs, bundle_state::executable,
@@ -2671,7 +3043,8 @@ device_image_plain ProgramManager::build(const device_image_plain &DeviceImage,
 
 // When caching is enabled, the returned UrKernel will already have
 // its ref count incremented.
-std::tuple<ur_kernel_handle_t, std::mutex *, const KernelArgMask *>
+std::tuple<ur_kernel_handle_t, std::mutex *, const KernelArgMask *,
+           KernelArgCache *>
 ProgramManager::getOrCreateKernel(const context &Context,
                                   const std::string &KernelName,
                                   const property_list &PropList,
@@ -2715,7 +3088,7 @@ ProgramManager::getOrCreateKernel(const context &Context,
     // threads when caching is disabled, so we can return
     // nullptr for the mutex.
     auto [Kernel, ArgMask] = BuildF();
-    return make_tuple(Kernel, nullptr, ArgMask);
+    return make_tuple(Kernel, nullptr, ArgMask, nullptr);
   }
 
   auto BuildResult = Cache.getOrBuild<errc::invalid>(GetCachedBuildF, BuildF);
@@ -2726,9 +3099,9 @@ ProgramManager::getOrCreateKernel(const context &Context,
   // caller. In that case, we need to increase the ref count of the
   // kernel.
   Ctx->getAdapter()->call<UrApiKind::urKernelRetain>(BuildResult->Val.first);
-  return std::make_tuple(BuildResult->Val.first,
-                         &(BuildResult->MBuildResultMutex),
-                         BuildResult->Val.second);
+  return std::make_tuple(
+      BuildResult->Val.first, &(BuildResult->MBuildResultMutex),
+      BuildResult->Val.second, &(BuildResult->MArgCache));
 }
 
 ur_kernel_handle_t ProgramManager::getCachedMaterializedKernel(
@@ -2797,6 +3170,7 @@ ur_kernel_handle_t ProgramManager::getOrCreateMaterializedKernel(
   ur_kernel_handle_t UrKernel{nullptr};
   Adapter->call<errc::kernel_not_supported, UrApiKind::urKernelCreate>(
       BuildProgram.get(), KernelName.c_str(), &UrKernel);
+  reportKernelResourceUsage(UrKernel, KernelName, DeviceImpl);
   {
     std::lock_guard<std::mutex> KernelIDsGuard(m_KernelIDsMutex);
     m_MaterializedKernels[KernelName][SpecializationConsts] = UrKernel;
@@ -11,6 +11,7 @@
 #include <detail/device_binary_image.hpp>
 #include <detail/device_global_map_entry.hpp>
 #include <detail/host_pipe_map_entry.hpp>
+#include <detail/kernel_arg_cache.hpp>
 #include <detail/kernel_arg_mask.hpp>
 #include <detail/spec_constant_impl.hpp>
 #include <sycl/detail/cg_types.hpp>
@@ -27,6 +28,8 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <type_traits>
 #include <unordered_map>
@@ -61,6 +64,9 @@ checkDevSupportDeviceRequirements(const device &Dev,
 // This value must be the same as in libdevice/device_itt.h.
 // See sycl/doc/design/ITTAnnotations.md for more info.
 static constexpr uint32_t inline ITTSpecConstId = 0xFF747469;
+// Bits of the value of the ITT specialization constant.
+static constexpr char inline ITTAnnotationsEnabled = 0x1;
+static constexpr char inline ITTWorkGroupCountersEnabled = 0x2;
 
 class context_impl;
 using ContextImplPtr = std::shared_ptr<context_impl>;
@@ -150,8 +156,22 @@ public:
                                         const property_list &PropList,
                                         bool JITCompilationIsRequired = false);
 
+  /// Schedules builds of the programs for all kernels registered with the
+  /// runtime on the host task thread pool. Results are stored in the in-memory
+  /// cache of the context, so a later getBuiltURProgram call for a kernel
+  /// only waits if the build of its program is still in progress.
+  /// Build errors are not reported here, they are reported by the first
+  /// regular build request of the affected kernel.
+  /// \param ContextImpl the context to build the programs in
+  /// \param Devs the devices to build the programs for
+  /// \param OnlyHotImages only build the images sycl-post-link grouped the
+  /// kernels of its -kernel-profile into
+  void buildProgramsAsync(const ContextImplPtr &ContextImpl,
+                          const std::vector<device> &Devs,
+                          bool OnlyHotImages = false);
+
   std::tuple<ur_kernel_handle_t, std::mutex *, const KernelArgMask *,
-             ur_program_handle_t>
+             ur_program_handle_t, KernelArgCache *>
   getOrCreateKernel(const ContextImplPtr &ContextImpl,
                     const DeviceImplPtr &DeviceImpl,
                     const std::string &KernelName,
@@ -184,6 +204,11 @@ public:
   getEliminatedKernelArgMask(ur_program_handle_t NativePrg,
                              const std::string &KernelName);
 
+  /// Returns the device images the native program was built from.
+  /// \param NativePrg a live UR program built by the program manager.
+  std::vector<const RTDeviceBinaryImage *>
+  getNativeProgramImages(ur_program_handle_t NativePrg);
+
   // The function returns the unique SYCL kernel identifier associated with a
   // kernel name.
   kernel_id getSYCLKernelID(const std::string &KernelName);
@@ -280,7 +305,8 @@ public:
                            const std::vector<device> &Devs,
                            const property_list &PropList);
 
-  std::tuple<ur_kernel_handle_t, std::mutex *, const KernelArgMask *>
+  std::tuple<ur_kernel_handle_t, std::mutex *, const KernelArgMask *,
+             KernelArgCache *>
   getOrCreateKernel(const context &Context, const std::string &KernelName,
                     const property_list &PropList, ur_program_handle_t Program);
 
@@ -313,6 +339,12 @@ private:
   /// Add info on kernels using assert into cache
   void cacheKernelUsesAssertInfo(RTDeviceBinaryImage &Img);
 
+  /// Returns true if the image Img is compatible with the target of the
+  /// device Dev and, if CheckRequirements is true, if Dev supports its device
+  /// requirements. The results are memoized per image and device.
+  bool isImageCompatible(RTDeviceBinaryImage *Img, const device &Dev,
+                         bool CheckRequirements = true);
+
   std::set<RTDeviceBinaryImage *>
   collectDeviceImageDepsForImportedSymbols(const RTDeviceBinaryImage &Img,
                                            device Dev);
@@ -372,6 +404,14 @@ private:
   /// for proper cleanup.
   std::unordered_set<RTDeviceBinaryImageUPtr> m_DeviceImages;
 
+  /// Maps the hashes of the binaries of the registered images to the images,
+  /// to find the identical copies of an image that several libraries carry.
+  /// Access must be guarded by the m_ImageHashesMutex mutex.
+  std::unordered_multimap<size_t, RTDeviceBinaryImage *> m_ImageHashes;
+
+  /// Protects the image hashes, held during the registration of images.
+  std::mutex m_ImageHashesMutex;
+
   /// Maps names of built-in kernels to their unique kernel IDs.
   /// Access must be guarded by the m_BuiltInKernelIDsMutex mutex.
   std::unordered_map<std::string, kernel_id> m_BuiltInKernelIDs;
@@ -384,6 +424,21 @@ private:
   /// Protects built-in kernel ID cache.
   std::mutex m_BuiltInKernelIDsMutex;
 
+  /// Results of the compatibility checks of an image with a device, unset
+  /// until the check is done.
+  struct ImageCompatibility {
+    std::optional<bool> Target;
+    std::optional<bool> Requirements;
+  };
+  /// Memoized compatibility of the images with the devices, by image and
+  /// device handle. The images and devices live as long as the program
+  /// manager, so the entries are never invalidated.
+  /// Access must be guarded by the m_ImageCompatibilityMutex mutex.
+  std::unordered_map<const RTDeviceBinaryImage *,
+                     std::unordered_map<ur_device_handle_t, ImageCompatibility>>
+      m_ImageCompatibility;
+  std::mutex m_ImageCompatibilityMutex;
+
   // Keeps track of ur_program to image correspondence. Needed for:
   // - knowing which specialization constants are used in the program and
   //   injecting their current values before compiling the SPIR-V; the binary
@@ -404,10 +459,23 @@ private:
   std::mutex MNativeProgramsMutex;
 
   using KernelNameToArgMaskMap = std::unordered_map<std::string, KernelArgMask>;
+  /// Kernel argument masks of an image, parsed from its properties on first
+  /// lookup rather than when the image is registered.
+  struct ImageArgMasks {
+    bool Parsed = false;
+    KernelNameToArgMaskMap Masks;
+  };
+  /// Returns the kernel argument masks of Img, parsing them if needed.
+  /// m_EliminatedKernelArgMasksMutex must be held.
+  const KernelNameToArgMaskMap &getImageArgMasks(const RTDeviceBinaryImage *Img,
+                                                 ImageArgMasks &Entry);
   /// Maps binary image and kernel name pairs to kernel argument masks which
   /// specify which arguments were eliminated during device code optimization.
-  std::unordered_map<const RTDeviceBinaryImage *, KernelNameToArgMaskMap>
+  /// Only the images with kernel argument masks have an entry.
+  /// Access must be guarded by the m_EliminatedKernelArgMasksMutex mutex.
+  std::unordered_map<const RTDeviceBinaryImage *, ImageArgMasks>
       m_EliminatedKernelArgMasks;
+  std::mutex m_EliminatedKernelArgMasksMutex;
 
   /// True iff a SPIR-V file has been specified with an environment variable
   bool m_UseSpvFile = false;
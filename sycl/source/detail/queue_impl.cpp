@@ -6,15 +6,19 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/deferred_flush.hpp>
 #include <detail/event_impl.hpp>
 #include <detail/memory_manager.hpp>
+#include <detail/program_manager/program_manager.hpp>
 #include <detail/queue_impl.hpp>
+#include <detail/scheduler/commands.hpp>
 #include <sycl/context.hpp>
 #include <sycl/detail/common.hpp>
 #include <sycl/detail/ur.hpp>
 #include <sycl/device.hpp>
 
 #include <cstring>
+#include <thread>
 #include <utility>
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
@@ -26,6 +30,9 @@
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+uint8_t GDeviceTimingStreamID;
+#endif
 // Treat 0 as reserved for host task traces
 std::atomic<unsigned long long> queue_impl::MNextAvailableQueueID = 1;
 
@@ -45,13 +52,19 @@ public:
 };
 
 static std::vector<ur_event_handle_t>
-getUrEvents(const std::vector<sycl::event> &DepEvents) {
+getUrEvents(const std::vector<sycl::event> &DepEvents,
+            const queue_impl &Queue) {
   std::vector<ur_event_handle_t> RetUrEvents;
   for (const sycl::event &Event : DepEvents) {
     const EventImplPtr &EventImpl = detail::getSyclObjImpl(Event);
     auto Handle = EventImpl->getHandle();
-    if (Handle != nullptr)
-      RetUrEvents.push_back(Handle);
+    if (Handle == nullptr)
+      continue;
+    // Do not add redundant event dependencies for in-order queues, the backend
+    // queue orders them already.
+    if (Queue.isInOrder() && EventImpl->getWorkerQueue().get() == &Queue)
+      continue;
+    RetUrEvents.push_back(Handle);
   }
   return RetUrEvents;
 }
@@ -111,26 +124,27 @@ queue_impl::get_backend_info<info::device::backend_version>() const {
 
 static event prepareSYCLEventAssociatedWithQueue(
     const std::shared_ptr<detail::queue_impl> &QueueImpl) {
-  auto EventImpl = std::make_shared<detail::event_impl>(QueueImpl);
+  auto EventImpl = queue_impl::createEventImpl(QueueImpl);
   EventImpl->setContextImpl(detail::getSyclObjImpl(QueueImpl->get_context()));
   EventImpl->setStateIncomplete();
   return detail::createSyclObjFromImpl<event>(EventImpl);
 }
 
-static event createDiscardedEvent() {
-  EventImplPtr EventImpl =
-      std::make_shared<event_impl>(event_impl::HES_Discarded);
-  return createSyclObjFromImpl<event>(EventImpl);
+static event createDiscardedEvent(const queue_impl &Queue) {
+  return createSyclObjFromImpl<event>(Queue.getDiscardedEvent());
 }
 
 const std::vector<event> &
-queue_impl::getExtendDependencyList(const std::vector<event> &DepEvents,
+queue_impl::getExtendDependencyList(const std::shared_ptr<queue_impl> &Self,
+                                    const std::vector<event> &DepEvents,
                                     std::vector<event> &MutableVec,
                                     std::unique_lock<std::mutex> &QueueLock) {
   if (!isInOrder())
     return DepEvents;
 
   QueueLock.lock();
+  if (MGraph.expired())
+    leaveNoLastEventMode(Self);
   EventImplPtr ExtraEvent = MGraph.expired() ? MDefaultGraphDeps.LastEventPtr
                                              : MExtGraphDeps.LastEventPtr;
   std::optional<event> ExternalEvent = popExternalEvent();
@@ -277,7 +291,18 @@ event queue_impl::memcpyFromDeviceGlobal(
       DeviceGlobalPtr, IsDeviceImageScope, Self, NumBytes, Offset, Dest);
 }
 
-event queue_impl::getLastEvent() {
+void queue_impl::leaveNoLastEventMode(const std::shared_ptr<queue_impl> &Self) {
+  // The mode is only changed under MMutex.
+  if (!MNoLastEventMode.load(std::memory_order_relaxed))
+    return;
+  MNoLastEventMode.store(false);
+  while (MNoLastEventSubmissions.load() != 0)
+    std::this_thread::yield();
+  if (MNoLastEventCommands.exchange(false))
+    MDefaultGraphDeps.LastEventPtr = insertMarkerEvent(Self);
+}
+
+event queue_impl::getLastEvent(const std::shared_ptr<queue_impl> &Self) {
   {
     // The external event is required to finish last if set, so it is considered
     // the last event if present.
@@ -288,9 +313,14 @@ event queue_impl::getLastEvent() {
 
   std::lock_guard<std::mutex> Lock{MMutex};
   if (MDiscardEvents)
-    return createDiscardedEvent();
+    return createDiscardedEvent(*this);
   if (!MGraph.expired() && MExtGraphDeps.LastEventPtr)
     return detail::createSyclObjFromImpl<event>(MExtGraphDeps.LastEventPtr);
+  // The commands submitted in the no last event mode are only ordered by the
+  // backend queue, a marker stands for the last of them.
+  if (MGraph.expired() && MNoLastEventMode.load() &&
+      MNoLastEventCommands.load(std::memory_order_relaxed))
+    return detail::createSyclObjFromImpl<event>(insertMarkerEvent(Self));
   if (!MDefaultGraphDeps.LastEventPtr)
     MDefaultGraphDeps.LastEventPtr = std::make_shared<event_impl>(std::nullopt);
   return detail::createSyclObjFromImpl<event>(MDefaultGraphDeps.LastEventPtr);
@@ -392,6 +422,10 @@ event queue_impl::submit_impl(const std::function<void(handler &)> &CGF,
   addEvent(Event);
 
   auto EventImpl = detail::getSyclObjImpl(Event);
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  if (Type == CGType::Kernel)
+    addDeviceTimingEvent(EventImpl);
+#endif
   for (auto &Stream : Streams) {
     // We don't want stream flushing to be blocking operation that is why submit
     // a host task to print stream buffer. It will fire up as soon as the kernel
@@ -407,6 +441,70 @@ event queue_impl::submit_impl(const std::function<void(handler &)> &CGF,
   return Event;
 }
 
+event queue_impl::submitBatch(
+    const std::vector<std::function<void(handler &)>> &CGFs,
+    const std::shared_ptr<queue_impl> &Self, bool CallerNeedsEvent,
+    const detail::code_location &Loc) {
+  if (CGFs.empty())
+    return {};
+
+  // Command group functions are user code, so they are all called before the
+  // queue lock is taken.
+  std::vector<std::unique_ptr<handler>> Handlers;
+  Handlers.reserve(CGFs.size());
+  for (size_t I = 0; I < CGFs.size(); ++I) {
+    // Only the event of the last command group can reach the user.
+    bool NeedsEvent = CallerNeedsEvent && I + 1 == CGFs.size();
+    Handlers.emplace_back(new handler(Self, Self, nullptr, NeedsEvent));
+    Handlers.back()->saveCodeLoc(Loc, /*IsTopCodeLoc=*/true);
+    NestedCallsTracker tracker;
+    CGFs[I](*Handlers.back());
+  }
+
+  std::vector<std::vector<StreamImplPtr>> Streams(Handlers.size());
+  for (size_t I = 0; I < Handlers.size(); ++I)
+    if (detail::getSyclObjImpl(*Handlers[I])->MCGType == CGType::Kernel)
+      Streams[I] = std::move(Handlers[I]->MStreamStorage);
+
+  std::vector<event> Events(Handlers.size());
+  size_t NumFinalized = 0;
+  std::exception_ptr Error;
+  {
+    std::lock_guard<std::mutex> Lock{MMutex};
+    try {
+      for (; NumFinalized < Handlers.size(); ++NumFinalized)
+        finalizeHandlerLocked(*Handlers[NumFinalized], Events[NumFinalized]);
+    } catch (...) {
+      Error = std::current_exception();
+    }
+  }
+
+  // Track the submitted commands even if the batch failed part way.
+  for (size_t I = 0; I < NumFinalized; ++I) {
+    addEvent(Events[I]);
+    auto EventImpl = detail::getSyclObjImpl(Events[I]);
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+    if (detail::getSyclObjImpl(*Handlers[I])->MCGType == CGType::Kernel)
+      addDeviceTimingEvent(EventImpl);
+#endif
+    for (auto &Stream : Streams[I]) {
+      event FlushEvent = submit_impl(
+          [&](handler &ServiceCGH) {
+            Stream->generateFlushCommand(ServiceCGH);
+          },
+          Self, Self, nullptr, /*CallerNeedsEvent*/ true, Loc,
+          /*IsTopCodeLoc=*/true, {});
+      EventImpl->attachEventToCompleteWeak(detail::getSyclObjImpl(FlushEvent));
+      registerStreamServiceEvent(detail::getSyclObjImpl(FlushEvent));
+    }
+  }
+
+  if (Error)
+    std::rethrow_exception(Error);
+
+  return discard_or_return(Events.back());
+}
+
 template <typename HandlerFuncT>
 event queue_impl::submitWithHandler(const std::shared_ptr<queue_impl> &Self,
                                     const std::vector<event> &DepEvents,
@@ -426,52 +524,103 @@ event queue_impl::submitMemOpHelper(const std::shared_ptr<queue_impl> &Self,
                                     HandlerFuncT HandlerFunc,
                                     MemOpFuncT MemOpFunc,
                                     MemOpArgTs... MemOpArgs) {
+  // Enqueues the operation to the backend queue, bypassing the scheduler.
+  auto EnqueueDirectly = [&](const std::vector<event> &Deps) {
+    if ((MDiscardEvents || !CallerNeedsEvent) && supportsDiscardingPiEvents()) {
+      NestedCallsTracker tracker;
+      MemOpFunc(MemOpArgs..., getUrEvents(Deps, *this),
+                /*PiEvent*/ nullptr, /*EventImplPtr*/ nullptr);
+      return createDiscardedEvent(*this);
+    }
+
+    event ResEvent = prepareSYCLEventAssociatedWithQueue(Self);
+    auto EventImpl = detail::getSyclObjImpl(ResEvent);
+    {
+      NestedCallsTracker tracker;
+      ur_event_handle_t UREvent = nullptr;
+      MemOpFunc(MemOpArgs..., getUrEvents(Deps, *this), &UREvent, EventImpl);
+      EventImpl->setHandle(UREvent);
+      EventImpl->setEnqueued();
+    }
+    // Track only if we won't be able to handle it with urQueueFinish.
+    if (MEmulateOOO)
+      addSharedEvent(ResEvent);
+    return discard_or_return(ResEvent);
+  };
+
+  // In the no last event mode, the operations are ordered by the backend
+  // queue and don't need the lock.
+  if (MIsInorder && MGraph.expired() &&
+      Scheduler::areEventsSafeForSchedulerBypass(DepEvents, MContext))
+    if (NoLastEventSubmission Submission{*this})
+      return EnqueueDirectly(DepEvents);
+
   // We need to submit command and update the last event under same lock if we
   // have in-order queue.
   {
     std::unique_lock<std::mutex> Lock(MMutex, std::defer_lock);
 
-    std::vector<event> MutableDepEvents;
+    // The extended list is only used by in-order queues, which hold the lock
+    // until the end of this scope. Drop the events before the lock is released
+    // but keep the capacity for the next submission.
+    struct ClearOnExit {
+      std::unique_lock<std::mutex> &Lock;
+      std::vector<event> &Vec;
+      ~ClearOnExit() {
+        if (Lock.owns_lock())
+          Vec.clear();
+      }
+    } ClearExtendedDeps{Lock, MExtendedDepEvents};
     const std::vector<event> &ExpandedDepEvents =
-        getExtendDependencyList(DepEvents, MutableDepEvents, Lock);
+        getExtendDependencyList(Self, DepEvents, MExtendedDepEvents, Lock);
 
     // If we have a command graph set we need to capture the op through the
     // handler rather than by-passing the scheduler.
     if (MGraph.expired() && Scheduler::areEventsSafeForSchedulerBypass(
                                 ExpandedDepEvents, MContext)) {
-      if ((MDiscardEvents || !CallerNeedsEvent) &&
-          supportsDiscardingPiEvents()) {
-        NestedCallsTracker tracker;
-        MemOpFunc(MemOpArgs..., getUrEvents(ExpandedDepEvents),
-                  /*PiEvent*/ nullptr, /*EventImplPtr*/ nullptr);
-        return createDiscardedEvent();
-      }
-
-      event ResEvent = prepareSYCLEventAssociatedWithQueue(Self);
-      auto EventImpl = detail::getSyclObjImpl(ResEvent);
-      {
-        NestedCallsTracker tracker;
-        ur_event_handle_t UREvent = nullptr;
-        MemOpFunc(MemOpArgs..., getUrEvents(ExpandedDepEvents), &UREvent,
-                  EventImpl);
-        EventImpl->setHandle(UREvent);
-        EventImpl->setEnqueued();
-      }
-
-      if (isInOrder()) {
-        auto &EventToStoreIn = MGraph.expired() ? MDefaultGraphDeps.LastEventPtr
-                                                : MExtGraphDeps.LastEventPtr;
-        EventToStoreIn = EventImpl;
-      }
-      // Track only if we won't be able to handle it with urQueueFinish.
-      if (MEmulateOOO)
-        addSharedEvent(ResEvent);
-      return discard_or_return(ResEvent);
+      event ResEvent = EnqueueDirectly(ExpandedDepEvents);
+      // The operation follows all the previous commands, none of them is left
+      // in the scheduler.
+      if (isInOrder())
+        enterNoLastEventMode();
+      return ResEvent;
     }
   }
   return submitWithHandler(Self, DepEvents, HandlerFunc);
 }
 
+event queue_impl::submitKernelLaunch(
+    const std::shared_ptr<queue_impl> &Self,
+    const std::shared_ptr<kernel_impl> &Kernel, const std::string &KernelName,
+    NDRDescT &NDRDesc, std::vector<ArgDesc> &Args, bool CallerNeedsEvent,
+    const std::function<void(handler &)> &HandlerFunc) {
+  // The handler reports the kernels of other contexts.
+  if (Kernel->get_info<info::kernel::context>() != get_context())
+    return submitWithHandler(Self, {}, HandlerFunc);
+
+  // The event of a kernel using assert is needed to check the assert flag.
+  if (!Kernel->isInterop() &&
+      ProgramManager::getInstance().kernelUsesAssert(KernelName))
+    CallerNeedsEvent = true;
+
+  // The kernel is launched like a memory operation: directly when no command
+  // of the scheduler precedes it, or through the handler otherwise.
+  auto LaunchKernel = [&](std::vector<ur_event_handle_t> RawEvents,
+                          ur_event_handle_t *OutEvent,
+                          const EventImplPtr &EventImpl) {
+    enqueueImpKernel(Self, NDRDesc, Args, /*KernelBundleImplPtr*/ nullptr,
+                     Kernel, KernelName, RawEvents, EventImpl,
+                     /*getMemAllocationFunc*/ nullptr,
+                     UR_KERNEL_CACHE_CONFIG_DEFAULT,
+                     /*KernelIsCooperative*/ false,
+                     /*KernelUsesClusterLaunch*/ false);
+    if (OutEvent)
+      *OutEvent = EventImpl->getHandle();
+  };
+  return submitMemOpHelper(Self, {}, CallerNeedsEvent, HandlerFunc,
+                           LaunchKernel);
+}
+
 void *queue_impl::instrumentationProlog(const detail::code_location &CodeLoc,
                                         std::string &Name, int32_t StreamID,
                                         uint64_t &IId) {
@@ -564,6 +713,10 @@ void queue_impl::wait(const detail::code_location &CodeLoc) {
                           "recording to a command graph.");
   }
 
+  // The commands of the queue may depend on those of queues not flushed yet.
+  if (DeferredFlush::isEnabled())
+    DeferredFlush::instance().flushAll();
+
   // If there is an external event set, we know we are using an in-order queue
   // and the event is required to finish after the last event in the queue. As
   // such, we can just wait for it and finish.
@@ -634,13 +787,103 @@ void queue_impl::wait(const detail::code_location &CodeLoc) {
     Event->wait(Event);
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
+  reportDeviceTimings(/*QueueFinished=*/true);
   instrumentationEpilog(TelemetryEvent, Name, StreamID, IId);
 #endif
 }
 
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+void queue_impl::addDeviceTimingEvent(const EventImplPtr &Event) {
+  if (!xptiCheckTraceEnabled(GDeviceTimingStreamID) || Event->isDiscarded())
+    return;
+  // The command may be cleaned up before the kernel completes, so its trace
+  // event is looked up now. Kernels bypassing the scheduler have no command
+  // and are reported with the trace event of the queue.
+  DeviceTimingEntry Entry{Event, MTraceEvent, MInstanceID};
+  if (auto *Cmd = static_cast<Command *>(Event->getCommand())) {
+    Entry.TraceEvent = Cmd->MTraceEvent;
+    Entry.InstanceID = Cmd->MInstanceID;
+  }
+  // The completed kernels are reported in batches, which doesn't add any
+  // synchronization with the device.
+  constexpr size_t BatchSize = 64;
+  bool Report = false;
+  {
+    std::lock_guard<std::mutex> Lock(MDeviceTimingMutex);
+    MDeviceTimingEvents.push_back(std::move(Entry));
+    Report = MDeviceTimingEvents.size() >= BatchSize;
+  }
+  if (Report)
+    reportDeviceTimings(/*QueueFinished=*/false);
+}
+
+void queue_impl::reportDeviceTimings(bool QueueFinished) {
+  std::vector<DeviceTimingEntry> Entries;
+  {
+    std::lock_guard<std::mutex> Lock(MDeviceTimingMutex);
+    Entries.swap(MDeviceTimingEvents);
+  }
+  if (Entries.empty())
+    return;
+
+  const AdapterPtr &Adapter = getAdapter();
+  size_t NumReported = 0;
+  for (; NumReported < Entries.size(); ++NumReported) {
+    const DeviceTimingEntry &Entry = Entries[NumReported];
+    ur_event_handle_t Handle = Entry.Event->getHandle();
+    // Kernels still waiting in the scheduler have no UR event yet, the ones
+    // without UR event once the queue finished never got one.
+    if (!Handle) {
+      if (QueueFinished)
+        continue;
+      break;
+    }
+    // Kernels submitted while the queue was waited for may still be running.
+    ur_event_status_t Status = UR_EVENT_STATUS_QUEUED;
+    Adapter->call<UrApiKind::urEventGetInfo>(
+        Handle, UR_EVENT_INFO_COMMAND_EXECUTION_STATUS, sizeof(Status),
+        &Status, nullptr);
+    if (Status != UR_EVENT_STATUS_COMPLETE)
+      break;
+    // The queue may have been created before the stream was subscribed to,
+    // without profiling.
+    uint64_t Timestamps[2] = {0, 0};
+    if (Adapter->call_nocheck<UrApiKind::urEventGetProfilingInfo>(
+            Handle, UR_PROFILING_INFO_COMMAND_START, sizeof(uint64_t),
+            &Timestamps[0], nullptr) != UR_RESULT_SUCCESS ||
+        Adapter->call_nocheck<UrApiKind::urEventGetProfilingInfo>(
+            Handle, UR_PROFILING_INFO_COMMAND_END, sizeof(uint64_t),
+            &Timestamps[1], nullptr) != UR_RESULT_SUCCESS)
+      continue;
+    auto *TraceEvent = static_cast<xpti_td *>(Entry.TraceEvent);
+    xptiNotifySubscribers(GDeviceTimingStreamID,
+                          (uint16_t)xpti::trace_point_type_t::signal, nullptr,
+                          TraceEvent ? TraceEvent : GSYCLGraphEvent,
+                          Entry.InstanceID,
+                          static_cast<const void *>(Timestamps));
+  }
+
+  // The kernels which didn't complete yet are checked with the next batch.
+  if (NumReported < Entries.size()) {
+    std::lock_guard<std::mutex> Lock(MDeviceTimingMutex);
+    MDeviceTimingEvents.insert(MDeviceTimingEvents.begin(),
+                               Entries.begin() + NumReported, Entries.end());
+  }
+}
+#endif
+
+void queue_impl::buildHotProgramsIfNeeded() {
+  if (!SYCLConfig<SYCL_EAGER_BUILD_HOT_KERNELS>::get())
+    return;
+  std::call_once(MContext->getHotProgramsBuildFlag(), [this]() {
+    ProgramManager::getInstance().buildProgramsAsync(
+        MContext, MContext->getDevices(), /*OnlyHotImages=*/true);
+  });
+}
+
 void queue_impl::constructorNotification() {
 #if XPTI_ENABLE_INSTRUMENTATION
-  if (xptiTraceEnabled()) {
+  if (xpti::framework::trace_enabled()) {
     MStreamID = xptiRegisterStream(SYCL_STREAM_NAME);
     constexpr uint16_t NotificationTraceType =
         static_cast<uint16_t>(xpti::trace_point_type_t::queue_create);
@@ -697,6 +940,7 @@ void queue_impl::destructorNotification() {
 }
 
 ur_native_handle_t queue_impl::getNative(int32_t &NativeHandleDesc) const {
+  MNativeHandleTaken = true;
   const AdapterPtr &Adapter = getAdapter();
   if (getContextImplPtr()->getBackend() == backend::opencl)
     Adapter->call<UrApiKind::urQueueRetain>(MQueues[0]);
@@ -712,8 +956,8 @@ ur_native_handle_t queue_impl::getNative(int32_t &NativeHandleDesc) const {
 
 bool queue_impl::ext_oneapi_empty() const {
   // If we have in-order queue where events are not discarded then just check
-  // the status of the last event.
-  if (isInOrder() && !MDiscardEvents) {
+  // the status of the last event, unless it isn't tracked.
+  if (isInOrder() && !MDiscardEvents && !MNoLastEventMode.load()) {
     std::lock_guard<std::mutex> Lock(MMutex);
     // If there is no last event we know that no work has been submitted, so it
     // must be trivially empty.
@@ -761,7 +1005,7 @@ bool queue_impl::ext_oneapi_empty() const {
 event queue_impl::discard_or_return(const event &Event) {
   if (!(MDiscardEvents))
     return Event;
-  return createDiscardedEvent();
+  return createDiscardedEvent(*this);
 }
 
 void queue_impl::revisitUnenqueuedCommandsState(
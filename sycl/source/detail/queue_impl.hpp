@@ -14,6 +14,7 @@
 #include <detail/device_impl.hpp>
 #include <detail/device_info.hpp>
 #include <detail/event_impl.hpp>
+#include <detail/event_impl_pool.hpp>
 #include <detail/global_handler.hpp>
 #include <detail/handler_impl.hpp>
 #include <detail/kernel_impl.hpp>
@@ -34,6 +35,7 @@
 
 #include "detail/graph_impl.hpp"
 
+#include <chrono>
 #include <utility>
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
@@ -158,7 +160,8 @@ public:
     }
     const QueueOrder QOrder =
         MIsInorder ? QueueOrder::Ordered : QueueOrder::OOO;
-    MQueues.push_back(createQueue(QOrder));
+    MQueues.push_back(createQueue(QOrder, /*FromPool=*/true));
+    buildHotProgramsIfNeeded();
     // This section is the second part of the instrumentation that uses the
     // tracepoint information and notifies
 
@@ -172,7 +175,7 @@ public:
 #endif
   }
 
-  event getLastEvent();
+  event getLastEvent(const std::shared_ptr<queue_impl> &Self);
 
 private:
   void queue_impl_interop(ur_queue_handle_t UrQueue) {
@@ -256,7 +259,11 @@ public:
       destructorNotification();
 #endif
       throw_asynchronous();
-      getAdapter()->call<UrApiKind::urQueueRelease>(MQueues[0]);
+      if (MPooled && !MNativeHandleTaken)
+        MContext->getQueuePool().recycle(MQueues[0], MDevice->getHandleRef(),
+                                         MPoolFlags, MPoolComputeIndex);
+      else
+        getAdapter()->call<UrApiKind::urQueueRelease>(MQueues[0]);
     } catch (std::exception &e) {
       __SYCL_REPORT_EXCEPTION_TO_STREAM("exception in ~queue_impl", e);
     }
@@ -265,6 +272,7 @@ public:
   /// \return an OpenCL interoperability queue handle.
 
   cl_command_queue get() {
+    MNativeHandleTaken = true;
     getAdapter()->call<UrApiKind::urQueueRetain>(MQueues[0]);
     ur_native_handle_t nativeHandle = 0;
     getAdapter()->call<UrApiKind::urQueueGetNativeHandle>(MQueues[0], nullptr,
@@ -378,6 +386,39 @@ public:
                 IsTopCodeLoc, PostProcess);
   }
 
+  /// Submits a batch of command group function objects to the queue, in the
+  /// order they are given. All the command groups are finalized under a single
+  /// acquisition of the queue lock.
+  ///
+  /// \param CGFs are function objects containing command groups.
+  /// \param Self is a shared_ptr to this queue.
+  /// \param CallerNeedsEvent is a boolean indicating whether the event of the
+  ///        last command group is required by the user after the call.
+  /// \param Loc is the code location of the submit call.
+  /// \return a SYCL event for the last command group of the batch.
+  event submitBatch(const std::vector<std::function<void(handler &)>> &CGFs,
+                    const std::shared_ptr<queue_impl> &Self,
+                    bool CallerNeedsEvent, const detail::code_location &Loc);
+
+  /// Launches a precompiled kernel with the given arguments, bypassing the
+  /// handler and the scheduler when no command of the scheduler precedes it.
+  ///
+  /// \param Self is a shared_ptr to this queue.
+  /// \param Kernel is the kernel to launch.
+  /// \param KernelName is the name of the kernel.
+  /// \param NDRDesc is the range of the launch.
+  /// \param Args are the arguments of the kernel.
+  /// \param CallerNeedsEvent is a boolean indicating whether the event is
+  ///        required by the user after the call.
+  /// \param HandlerFunc submits the kernel through a handler, used when the
+  ///        scheduler can't be bypassed.
+  /// \return a SYCL event for the kernel.
+  event submitKernelLaunch(const std::shared_ptr<queue_impl> &Self,
+                           const std::shared_ptr<kernel_impl> &Kernel,
+                           const std::string &KernelName, NDRDescT &NDRDesc,
+                           std::vector<ArgDesc> &Args, bool CallerNeedsEvent,
+                           const std::function<void(handler &)> &HandlerFunc);
+
   /// Performs a blocking wait for the completion of all enqueued tasks in the
   /// queue.
   ///
@@ -489,7 +530,9 @@ public:
   ///
   /// \param Order specifies whether the queue being constructed as in-order
   /// or out-of-order.
-  ur_queue_handle_t createQueue(QueueOrder Order) {
+  /// \param FromPool specifies whether the queue may be taken from the queue
+  /// pool of the context, and given back to it by the destructor.
+  ur_queue_handle_t createQueue(QueueOrder Order, bool FromPool = false) {
     ur_queue_handle_t Queue{};
     ur_context_handle_t Context = MContext->getHandleRef();
     ur_device_handle_t Device = MDevice->getHandleRef();
@@ -501,6 +544,14 @@ public:
     ur_queue_properties_t Properties = {UR_STRUCTURE_TYPE_QUEUE_PROPERTIES,
                                         nullptr, 0};
     Properties.flags = createUrQueueFlags(MPropList, Order);
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+    // The device timing stream reports the device timestamps of the kernels
+    // even if the user didn't ask for profiling. Events are not created with
+    // discard_events, so there would be nothing to report.
+    if (xptiCheckTraceEnabled(GDeviceTimingStreamID) &&
+        !has_property<ext::oneapi::property::queue::discard_events>())
+      Properties.flags |= UR_QUEUE_FLAG_PROFILING_ENABLE;
+#endif
     ur_queue_index_properties_t IndexProperties = {
         UR_STRUCTURE_TYPE_QUEUE_INDEX_PROPERTIES, nullptr, 0};
     if (has_property<ext::intel::property::queue::compute_index>()) {
@@ -509,6 +560,18 @@ public:
               .get_index();
       Properties.pNext = &IndexProperties;
     }
+    const int32_t ComputeIndex =
+        Properties.pNext ? IndexProperties.computeIndex : -1;
+    if (FromPool) {
+      Queue = MContext->getQueuePool().acquire(Device, Properties.flags,
+                                               ComputeIndex);
+      if (Queue) {
+        MPooled = true;
+        MPoolFlags = Properties.flags;
+        MPoolComputeIndex = ComputeIndex;
+        return Queue;
+      }
+    }
     ur_result_t Error = Adapter->call_nocheck<UrApiKind::urQueueCreate>(
         Context, Device, &Properties, &Queue);
 
@@ -521,6 +584,11 @@ public:
       Queue = createQueue(QueueOrder::Ordered);
     } else {
       Adapter->checkUrResult(Error);
+      if (FromPool) {
+        MPooled = true;
+        MPoolFlags = Properties.flags;
+        MPoolComputeIndex = ComputeIndex;
+      }
     }
 
     return Queue;
@@ -676,8 +744,12 @@ public:
 
   void *getTraceEvent() { return MTraceEvent; }
 
-  void setExternalEvent(const event &Event) {
-    std::lock_guard<std::mutex> Lock(MInOrderExternalEventMtx);
+  void setExternalEvent(const std::shared_ptr<queue_impl> &Self,
+                        const event &Event) {
+    // The submissions in the no last event mode ignore the external event.
+    std::lock_guard<std::mutex> Lock(MMutex);
+    leaveNoLastEventMode(Self);
+    std::lock_guard<std::mutex> EventLock(MInOrderExternalEventMtx);
     MInOrderExternalEvent = Event;
   }
 
@@ -689,10 +761,83 @@ public:
   }
 
   const std::vector<event> &
-  getExtendDependencyList(const std::vector<event> &DepEvents,
+  getExtendDependencyList(const std::shared_ptr<queue_impl> &Self,
+                          const std::vector<event> &DepEvents,
                           std::vector<event> &MutableVec,
                           std::unique_lock<std::mutex> &QueueLock);
 
+  // Must be called under MMutex protection. Waits for the submissions in the
+  // no last event mode in progress and leaves the mode, with a marker for the
+  // commands submitted in it as the last event.
+  void leaveNoLastEventMode(const std::shared_ptr<queue_impl> &Self);
+
+  // Must be called under MMutex protection, after a command was enqueued to
+  // the backend queue with all the previous ones.
+  void enterNoLastEventMode() {
+    MDefaultGraphDeps.LastEventPtr = nullptr;
+    MNoLastEventCommands.store(true, std::memory_order_relaxed);
+    MNoLastEventMode.store(true);
+  }
+
+  // A submission in the no last event mode, if the mode is set when it starts.
+  class NoLastEventSubmission {
+  public:
+    NoLastEventSubmission(queue_impl &Queue) : MQueue(Queue) {
+      // Paired with leaveNoLastEventMode, which clears the mode before it
+      // waits for the submissions in progress.
+      MQueue.MNoLastEventSubmissions.fetch_add(1);
+      MActive = MQueue.MNoLastEventMode.load();
+      if (!MActive)
+        MQueue.MNoLastEventSubmissions.fetch_sub(1);
+    }
+    NoLastEventSubmission(const NoLastEventSubmission &) = delete;
+    NoLastEventSubmission &operator=(const NoLastEventSubmission &) = delete;
+    ~NoLastEventSubmission() {
+      if (!MActive)
+        return;
+      MQueue.MNoLastEventCommands.store(true, std::memory_order_relaxed);
+      MQueue.MNoLastEventSubmissions.fetch_sub(1);
+    }
+
+    explicit operator bool() const { return MActive; }
+
+  private:
+    queue_impl &MQueue;
+    bool MActive;
+  };
+
+  // Whether handler::finalize enqueues the command of the handler directly
+  // to the backend queue, see its fast path.
+  template <typename HandlerType>
+  bool isDirectKernelSubmission(HandlerType &Handler) const {
+    const auto &HandlerImpl = getSyclObjImpl(Handler);
+    return HandlerImpl->MCGType == CGType::Kernel && MGraph.expired() &&
+           !HandlerImpl->MGraph && !HandlerImpl->MSubgraphNode &&
+           HandlerImpl->CGData.MRequirements.empty() &&
+           Handler.MStreamStorage.empty() &&
+           Scheduler::areEventsSafeForSchedulerBypass(
+               HandlerImpl->CGData.MEvents, MContext);
+  }
+
+public:
+  /// Returns the event handed out for submissions which discard their events.
+  /// Discarded events carry no state, so one object is shared by all of them
+  /// instead of allocating a new event per submission.
+  const EventImplPtr &getDiscardedEvent() const { return MDiscardedEvent; }
+
+  /// Creates an event for a command submitted to Queue. Events of queues with
+  /// the discard_events property are never handed out to the user, their
+  /// storage is recycled through the event pool of the queue.
+  static EventImplPtr
+  createEventImpl(const std::shared_ptr<queue_impl> &Queue) {
+    if (Queue && Queue->MDiscardEvents)
+      return std::allocate_shared<event_impl>(
+          EventImplPoolAllocator<event_impl>(Queue->MEventImplPool), Queue);
+    return std::make_shared<event_impl>(Queue);
+  }
+
+protected:
+
   // Called on host task completion that could block some kernels from enqueue.
   // Approach that tracks almost all tasks to provide barrier sync for both ur
   // tasks and host tasks is applicable for out of order queues only. Not needed
@@ -710,11 +855,19 @@ public:
 
   const property_list &getPropList() const { return MPropList; }
 
+  std::chrono::microseconds getWaitSpinDuration() const {
+    return MWaitSpinDuration;
+  }
+
+  /// Returns 1 for the queues with priority_high, -1 for the queues with
+  /// priority_low and 0 otherwise.
+  int getSchedulingPriority() const { return MSchedulingPriority; }
+
   /// Inserts a marker event at the end of the queue. Waiting for this marker
   /// will wait for the completion of all work in the queue at the time of the
   /// insertion, but will not act as a barrier unless the queue is in-order.
   EventImplPtr insertMarkerEvent(const std::shared_ptr<queue_impl> &Self) {
-    auto ResEvent = std::make_shared<detail::event_impl>(Self);
+    auto ResEvent = createEventImpl(Self);
     ur_event_handle_t UREvent = nullptr;
     getAdapter()->call<UrApiKind::urEnqueueEventsWait>(getHandleRef(), 0,
                                                        nullptr, &UREvent);
@@ -727,7 +880,7 @@ protected:
 
   template <typename HandlerType = handler>
   EventImplPtr insertHelperBarrier(const HandlerType &Handler) {
-    auto ResEvent = std::make_shared<detail::event_impl>(Handler.MQueue);
+    auto ResEvent = createEventImpl(Handler.MQueue);
     ur_event_handle_t UREvent = nullptr;
     getAdapter()->call<UrApiKind::urEnqueueEventsWaitWithBarrier>(
         Handler.MQueue->getHandleRef(), 0, nullptr, &UREvent);
@@ -738,11 +891,28 @@ protected:
   // template is needed for proper unit testing
   template <typename HandlerType = handler>
   void finalizeHandler(HandlerType &Handler, event &EventRet) {
-    if (MIsInorder) {
-      // Accessing and changing of an event isn't atomic operation.
-      // Hence, here is the lock for thread-safety.
-      std::lock_guard<std::mutex> Lock{MMutex};
+    // In the no last event mode, the kernels enqueued directly to the backend
+    // queue are ordered by it and don't need the lock.
+    if (MIsInorder && isDirectKernelSubmission(Handler))
+      if (NoLastEventSubmission Submission{*this}) {
+        EventRet = Handler.finalize();
+        assert(!getSyclObjImpl(EventRet)->getCommand() &&
+               "The kernel was expected to bypass the scheduler");
+        return;
+      }
 
+    // Accessing and changing of an event isn't atomic operation.
+    // Hence, here is the lock for thread-safety.
+    std::lock_guard<std::mutex> Lock{MMutex};
+    finalizeHandlerLocked(Handler, EventRet);
+  }
+
+  // Same as finalizeHandler, MMutex is expected to be locked by the caller.
+  template <typename HandlerType = handler>
+  void finalizeHandlerLocked(HandlerType &Handler, event &EventRet) {
+    if (MIsInorder) {
+      if (MGraph.expired())
+        leaveNoLastEventMode(Handler.MQueue);
       auto &EventToBuildDeps = MGraph.expired() ? MDefaultGraphDeps.LastEventPtr
                                                 : MExtGraphDeps.LastEventPtr;
 
@@ -776,9 +946,13 @@ protected:
 
       EventRet = Handler.finalize();
       EventToBuildDeps = getSyclObjImpl(EventRet);
+      // A kernel enqueued directly to the backend queue follows all the
+      // previous commands, as no other is left in the scheduler.
+      if (MGraph.expired() && !EventToBuildDeps->getCommand() &&
+          (EventToBuildDeps->isDiscarded() || EventToBuildDeps->getHandle()))
+        enterNoLastEventMode();
     } else {
       const CGType Type = getSyclObjImpl(Handler)->MCGType;
-      std::lock_guard<std::mutex> Lock{MMutex};
       // The following code supports barrier synchronization if host task is
       // involved in the scenario. Native barriers cannot handle host task
       // dependency so in the case where some commands were not enqueued
@@ -874,6 +1048,18 @@ protected:
   // We need to emit a queue_create notification when a queue object is created
   void constructorNotification();
 
+  // Starts building the programs of the hot kernels of the context on the
+  // first queue created with it, for SYCL_EAGER_BUILD_HOT_KERNELS.
+  void buildHotProgramsIfNeeded();
+
+  // Tracks a kernel submitted to the queue, so that its device timestamps are
+  // reported on the device timing stream once it completes
+  void addDeviceTimingEvent(const EventImplPtr &Event);
+
+  // Reports the device timestamps of the tracked kernels which completed. If
+  // QueueFinished is set, the kernels which were never enqueued are dropped.
+  void reportDeviceTimings(bool QueueFinished);
+
   // We need to emit a queue_destroy notification when a queue object is
   // destroyed
   void destructorNotification();
@@ -916,6 +1102,16 @@ protected:
   /// need to emulate it with multiple native in-order queues.
   bool MEmulateOOO = false;
 
+  /// Indicates that MQueues[0] goes back to the queue pool of the context when
+  /// the queue is destroyed, with the flags and the compute index it was
+  /// created with.
+  bool MPooled = false;
+  ur_queue_flags_t MPoolFlags = 0;
+  int32_t MPoolComputeIndex = -1;
+  /// Set once the native handle is given to the application, which may still
+  /// use it after the queue is destroyed.
+  mutable std::atomic<bool> MNativeHandleTaken{false};
+
   // Access should be guarded with MMutex
   struct DependencyTrackingItems {
     // This event is employed for enhanced dependency tracking with in-order
@@ -935,6 +1131,16 @@ protected:
 
   const bool MIsInorder;
 
+  // In-order queues whose commands are all enqueued directly to the backend
+  // queue rely on its ordering and don't track their last event, so that
+  // their submissions don't take MMutex. The mode is left under MMutex before
+  // a command that needs the last event.
+  std::atomic<bool> MNoLastEventMode{MIsInorder};
+  // Number of submissions in progress in the no last event mode.
+  std::atomic<size_t> MNoLastEventSubmissions{0};
+  // Whether a command was submitted since the mode was entered.
+  std::atomic<bool> MNoLastEventCommands{false};
+
   std::vector<EventImplPtr> MStreamsServiceEvents;
   std::mutex MStreamsServiceEventsMutex;
 
@@ -947,6 +1153,16 @@ protected:
   uint8_t MStreamID = 0;
   /// The instance ID of the trace event for queue object
   uint64_t MInstanceID = 0;
+  /// A kernel whose device timestamps are reported on the device timing stream
+  /// once it completes, with the trace event and instance of its command
+  struct DeviceTimingEntry {
+    EventImplPtr Event;
+    void *TraceEvent;
+    uint64_t InstanceID;
+  };
+  /// The kernels not reported yet, in submission order
+  std::vector<DeviceTimingEntry> MDeviceTimingEvents;
+  std::mutex MDeviceTimingMutex;
 
   // the fallback implementation of profiling info
   bool MFallbackProfiling = false;
@@ -958,10 +1174,36 @@ protected:
   std::optional<event> MInOrderExternalEvent;
   mutable std::mutex MInOrderExternalEventMtx;
 
+  // Storage for the dependency list extended by getExtendDependencyList() for
+  // in-order queues. It is reused between submissions to avoid allocating a
+  // new list every time. Access should be guarded with MMutex.
+  std::vector<event> MExtendedDepEvents;
+
+  const EventImplPtr MDiscardedEvent =
+      std::make_shared<event_impl>(event_impl::HES_Discarded);
+
+  const std::shared_ptr<EventImplPool> MEventImplPool =
+      std::make_shared<EventImplPool>();
+
 public:
   // Queue constructed with the discard_events property
   const bool MDiscardEvents;
   const bool MIsProfilingEnabled;
+  // Duration for which the waits on the events of the queue poll them before
+  // blocking.
+  const std::chrono::microseconds MWaitSpinDuration =
+      has_property<ext::oneapi::property::queue::wait_spin_duration>()
+          ? get_property<ext::oneapi::property::queue::wait_spin_duration>()
+                .get_duration()
+          : std::chrono::microseconds{0};
+
+  // Priority of the queue in the scheduler: among the commands unblocked at
+  // the same time, the commands of the queues of higher priority are enqueued
+  // first.
+  const int MSchedulingPriority =
+      has_property<ext::oneapi::property::queue::priority_high>()  ? 1
+      : has_property<ext::oneapi::property::queue::priority_low>() ? -1
+                                                                    : 0;
 
 protected:
   // Command graph which is associated with this queue for the purposes of
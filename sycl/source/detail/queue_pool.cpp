@@ -0,0 +1,63 @@
+//==------------ queue_pool.cpp - Native queues reused by a context --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/adapter.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/queue_pool.hpp>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+void QueuePool::release() {
+  const AdapterPtr &Adapter = MContextImpl.getAdapter();
+  std::lock_guard<std::mutex> Lock(MMutex);
+  for (auto &[Key, Queues] : MQueues)
+    for (ur_queue_handle_t Queue : Queues)
+      Adapter->call_nocheck<UrApiKind::urQueueRelease>(Queue);
+  MQueues.clear();
+}
+
+ur_queue_handle_t QueuePool::acquire(ur_device_handle_t Device,
+                                     ur_queue_flags_t Flags,
+                                     int32_t ComputeIndex) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MQueues.find({Device, Flags, ComputeIndex});
+  if (It == MQueues.end() || It->second.empty())
+    return nullptr;
+  ur_queue_handle_t Queue = It->second.back();
+  It->second.pop_back();
+  return Queue;
+}
+
+void QueuePool::recycle(ur_queue_handle_t Queue, ur_device_handle_t Device,
+                        ur_queue_flags_t Flags, int32_t ComputeIndex) {
+  // Work left in the queue would delay the work of its next owner.
+  if (isIdle(Queue)) {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    std::vector<ur_queue_handle_t> &Queues =
+        MQueues[{Device, Flags, ComputeIndex}];
+    if (Queues.size() < MaxQueues) {
+      Queues.push_back(Queue);
+      return;
+    }
+  }
+  MContextImpl.getAdapter()->call<UrApiKind::urQueueRelease>(Queue);
+}
+
+bool QueuePool::isIdle(ur_queue_handle_t Queue) const {
+  ur_bool_t IsEmpty = false;
+  ur_result_t Error =
+      MContextImpl.getAdapter()->call_nocheck<UrApiKind::urQueueGetInfo>(
+          Queue, UR_QUEUE_INFO_EMPTY, sizeof(IsEmpty), &IsEmpty, nullptr);
+  return Error == UR_RESULT_SUCCESS && IsEmpty;
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
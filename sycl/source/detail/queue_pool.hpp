@@ -0,0 +1,65 @@
+//==------------ queue_pool.hpp - Native queues reused by a context --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/ur.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class context_impl;
+
+/// Native queues of a context given back by the SYCL queues destroyed, so
+/// that a SYCL queue created later for the same device with the same flags
+/// reuses one instead of creating a native queue. Only the queues without
+/// pending work are kept.
+class QueuePool {
+public:
+  QueuePool(context_impl &ContextImpl) : MContextImpl(ContextImpl) {}
+  QueuePool(const QueuePool &) = delete;
+  QueuePool &operator=(const QueuePool &) = delete;
+
+  /// Releases the queues of the pool. Must be called while the context handle
+  /// is still valid.
+  void release();
+
+  /// Takes a queue of Device created with Flags and ComputeIndex, -1 if none,
+  /// out of the pool.
+  /// @return The queue, nullptr if the pool has none.
+  ur_queue_handle_t acquire(ur_device_handle_t Device, ur_queue_flags_t Flags,
+                            int32_t ComputeIndex);
+
+  /// Gives Queue back to the pool, or releases it if it has pending work or
+  /// the pool already holds MaxQueues queues of its kind.
+  void recycle(ur_queue_handle_t Queue, ur_device_handle_t Device,
+               ur_queue_flags_t Flags, int32_t ComputeIndex);
+
+private:
+  static constexpr size_t MaxQueues = 4;
+
+  using Key = std::tuple<ur_device_handle_t, ur_queue_flags_t, int32_t>;
+
+  bool isIdle(ur_queue_handle_t Queue) const;
+
+  context_impl &MContextImpl;
+  std::mutex MMutex;
+  std::map<Key, std::vector<ur_queue_handle_t>> MQueues;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
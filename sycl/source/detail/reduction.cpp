@@ -7,10 +7,14 @@
 //===----------------------------------------------------------------------===//
 
 #include <detail/config.hpp>
+#include <detail/device_impl.hpp>
 #include <detail/memory_manager.hpp>
 #include <detail/queue_impl.hpp>
 #include <sycl/reduction.hpp>
 
+#include <algorithm>
+#include <vector>
+
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
@@ -166,6 +170,61 @@ __SYCL_EXPORT size_t reduGetPreferredWGSize(std::shared_ptr<queue_impl> &Queue,
   return reduGetMaxWGSize(Queue, LocalMemBytesPerWorkItem);
 }
 
+// Number of work-items a compute unit of a discrete GPU keeps resident, the
+// value for most NVIDIA and AMD GPUs.
+static constexpr size_t GPUResidentWorkItemsPerCU = 2048;
+
+// Estimates how many work-groups of WGSize work-items the device runs
+// concurrently. Each of them produces one partial result of the reduction.
+static size_t reduEstimateNumConcurrentWorkGroups(const device &Dev,
+                                                  size_t WGSize) {
+  size_t NumCUs = Dev.get_info<sycl::info::device::max_compute_units>();
+  if (!Dev.is_gpu())
+    return NumCUs;
+
+  if (Dev.has(aspect::ext_intel_gpu_eu_count) &&
+      Dev.has(aspect::ext_intel_gpu_hw_threads_per_eu)) {
+    // Every hardware thread runs a sub-group.
+    size_t NumThreads =
+        Dev.get_info<ext::intel::info::device::gpu_eu_count>() *
+        Dev.get_info<ext::intel::info::device::gpu_hw_threads_per_eu>();
+    std::vector<size_t> SGSizes =
+        Dev.get_info<sycl::info::device::sub_group_sizes>();
+    size_t SGSize =
+        SGSizes.empty() ? 1 : *std::min_element(SGSizes.begin(), SGSizes.end());
+    size_t SGsPerWG = (WGSize + SGSize - 1) / SGSize;
+    return std::max<size_t>(1, NumThreads / SGsPerWG);
+  }
+
+  if (Dev.get_info<sycl::info::device::host_unified_memory>())
+    return NumCUs * 8;
+  return NumCUs * std::max<size_t>(1, GPUResidentWorkItemsPerCU / WGSize);
+}
+
+__SYCL_EXPORT void
+reduGetRangeLaunchParams(std::shared_ptr<queue_impl> &Queue,
+                         size_t LocalMemBytesPerWorkItem, size_t &WGSize,
+                         size_t &NumWorkGroups) {
+  // See reduGetPreferredWGSize and reduGetMaxNumConcurrentWorkGroups for the
+  // values used without a queue.
+  if (Queue == nullptr) {
+    WGSize = reduGetPreferredWGSize(Queue, LocalMemBytesPerWorkItem);
+    NumWorkGroups = reduGetMaxNumConcurrentWorkGroups(Queue);
+    return;
+  }
+
+  const device_impl &DevImpl = *Queue->getDeviceImplPtr();
+  device_impl::ReductionLaunchParams Params = DevImpl.getReductionLaunchParams(
+      LocalMemBytesPerWorkItem, [&]() -> device_impl::ReductionLaunchParams {
+        size_t PrefWGSize =
+            reduGetPreferredWGSize(Queue, LocalMemBytesPerWorkItem);
+        return {PrefWGSize, reduEstimateNumConcurrentWorkGroups(
+                                Queue->get_device(), PrefWGSize)};
+      });
+  WGSize = Params.WGSize;
+  NumWorkGroups = Params.NumWorkGroups;
+}
+
 __SYCL_EXPORT void
 addCounterInit(handler &CGH, std::shared_ptr<sycl::detail::queue_impl> &Queue,
                std::shared_ptr<int> &Counter) {
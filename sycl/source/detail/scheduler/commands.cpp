@@ -22,6 +22,8 @@
 #include <detail/scheduler/commands.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/stream_impl.hpp>
+#include <detail/submission_stats.hpp>
+#include <detail/work_group_counters.hpp>
 #include <detail/xpti_registry.hpp>
 #include <sycl/access/access.hpp>
 #include <sycl/backend_types.hpp>
@@ -71,6 +73,10 @@ void emitInstrumentationGeneral(uint32_t StreamID, uint64_t InstanceID,
                                 const void *Addr) {
   if (!(xptiCheckTraceEnabled(StreamID, Type) && TraceEvent))
     return;
+  // Sampling keeps or drops all the notifications of an instance together.
+  if (!xpti::framework::sampler_t::instance().sample(
+          static_cast<uint8_t>(StreamID), Type, InstanceID))
+    return;
   // Trace event notifier that emits a Type event
   xptiNotifySubscribers(StreamID, Type, detail::GSYCLGraphEvent,
                         static_cast<xpti_td *>(TraceEvent), InstanceID, Addr);
@@ -349,11 +355,9 @@ class DispatchHostTask {
       RequiredEventsPerAdapter[Adapter].push_back(Event);
     }
 
-    // wait for dependency device events
-    // FIXME Current implementation of waiting for events will make the thread
-    // 'sleep' until all of dependency events are complete. We need a bit more
-    // sophisticated waiting mechanism to allow to utilize this thread for any
-    // other available job and resume once all required events are ready.
+    // Wait for dependency device events. They are already complete unless the
+    // backend doesn't support the completion callbacks dispatch() relies on,
+    // in which case the thread 'sleeps' until they are.
     for (auto &AdapterWithEvents : RequiredEventsPerAdapter) {
       std::vector<ur_event_handle_t> RawEvents =
           MThisCmd->getUrEvents(AdapterWithEvents.second);
@@ -382,6 +386,27 @@ class DispatchHostTask {
     return true;
   }
 
+  // A host task suspended until the completion callbacks of its native
+  // dependencies are called, counting the thread pool job it is resumed as.
+  struct SuspendedHostTask {
+    DispatchHostTask Task;
+    std::atomic<size_t> PendingCallbacks;
+  };
+
+  static void resumeOnCompletion(ur_event_handle_t, ur_execution_info_t,
+                                 void *UserData) {
+    resume(static_cast<SuspendedHostTask *>(UserData), 1);
+  }
+
+  static void resume(SuspendedHostTask *Suspended, size_t Callbacks) {
+    if (Suspended->PendingCallbacks.fetch_sub(Callbacks) != Callbacks)
+      return;
+    std::unique_ptr<SuspendedHostTask> Owner(Suspended);
+    // The dependencies are complete, the resumed task only checks their
+    // status.
+    queue_impl::getThreadPool().submitReserved(std::move(Owner->Task));
+  }
+
 public:
   DispatchHostTask(ExecCGCommand *ThisCmd,
                    std::vector<interop_handle::ReqToMem> ReqToMem,
@@ -389,6 +414,38 @@ public:
       : MThisCmd{ThisCmd}, MReqToMem(std::move(ReqToMem)),
         MReqUrMem(std::move(ReqUrMem)) {}
 
+  // Runs the host task on the thread pool once its native dependencies are
+  // complete. Rather than blocking a pool thread on them, the task is
+  // suspended until their completion callbacks are called. The backends which
+  // don't support the callbacks get the task waiting for them on the pool.
+  static void dispatch(DispatchHostTask &&Task) {
+    std::vector<std::pair<AdapterPtr, ur_event_handle_t>> RawEvents;
+    for (const EventImplPtr &Event : Task.MThisCmd->MPreparedDepsEvents)
+      for (ur_event_handle_t RawEvent : Task.MThisCmd->getUrEvents({Event}))
+        RawEvents.emplace_back(Event->getAdapter(), RawEvent);
+
+    ThreadPool &Pool = queue_impl::getThreadPool();
+    if (RawEvents.empty()) {
+      Pool.submit<DispatchHostTask>(std::move(Task));
+      return;
+    }
+
+    Pool.reserve();
+    // The dispatcher holds one more count, so that the task isn't resumed
+    // before all the callbacks are set.
+    auto *Suspended =
+        new SuspendedHostTask{std::move(Task), RawEvents.size() + 1};
+    size_t Unset = RawEvents.size();
+    for (auto &[Adapter, RawEvent] : RawEvents) {
+      if (Adapter->call_nocheck<UrApiKind::urEventSetCallback>(
+              RawEvent, UR_EXECUTION_INFO_COMPLETE, resumeOnCompletion,
+              Suspended) != UR_RESULT_SUCCESS)
+        break;
+      --Unset;
+    }
+    resume(Suspended, Unset + 1);
+  }
+
   void operator()() const {
     assert(MThisCmd->getCG().getType() == CGType::CodeplayHostTask);
 
@@ -400,7 +457,7 @@ public:
     // as Command field and put it here to TLS so that thrown exception could
     // query and report it.
     std::unique_ptr<detail::tls_code_loc_t> AsyncCodeLocationPtr;
-    if (xptiTraceEnabled() && !CurrentCodeLocationValid()) {
+    if (xpti::framework::trace_enabled() && !CurrentCodeLocationValid()) {
       AsyncCodeLocationPtr.reset(
           new detail::tls_code_loc_t(MThisCmd->MSubmissionCodeLocation));
     }
@@ -460,7 +517,7 @@ public:
       // sycl::exception emit tracing of message with code location if
       // available. For other types of exception we need to explicitly trigger
       // tracing by calling TraceEventXPTI.
-      if (xptiTraceEnabled()) {
+      if (xpti::framework::trace_enabled()) {
         try {
           rethrow_exception(CurrentException);
         } catch (const sycl::exception &) {
@@ -564,7 +621,7 @@ Command::Command(
     ur_exp_command_buffer_handle_t CommandBuffer,
     const std::vector<ur_exp_command_buffer_sync_point_t> &SyncPoints)
     : MQueue(std::move(Queue)),
-      MEvent(std::make_shared<detail::event_impl>(MQueue)),
+      MEvent(queue_impl::createEventImpl(MQueue)),
       MPreparedDepsEvents(MEvent->getPreparedDepsEvents()),
       MPreparedHostDepsEvents(MEvent->getPreparedHostDepsEvents()), MType(Type),
       MCommandBuffer(CommandBuffer), MSyncPointDeps(SyncPoints) {
@@ -578,7 +635,7 @@ Command::Command(
   MEnqueueStatus = EnqueueResultT::SyclEnqueueReady;
 
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (!xptiTraceEnabled())
+  if (!xpti::framework::trace_enabled())
     return;
   // Obtain the stream ID so all commands can emit traces to that stream
   MStreamID = xptiRegisterStream(SYCL_STREAM_NAME);
@@ -871,7 +928,7 @@ bool Command::enqueue(EnqueueResultT &EnqueueResult, BlockingT Blocking,
   // submission code location set. So we set it manually to properly trace
   // failures if ur level report any.
   std::unique_ptr<detail::tls_code_loc_t> AsyncCodeLocationPtr;
-  if (xptiTraceEnabled() && !CurrentCodeLocationValid()) {
+  if (xpti::framework::trace_enabled() && !CurrentCodeLocationValid()) {
     AsyncCodeLocationPtr.reset(
         new detail::tls_code_loc_t(MSubmissionCodeLocation));
   }
@@ -1011,7 +1068,7 @@ const char *Command::getBlockReason() const {
 
 void Command::copySubmissionCodeLocation() {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
-  if (!xptiTraceEnabled())
+  if (!xpti::framework::trace_enabled())
     return;
 
   detail::tls_code_loc_t Tls;
@@ -1492,7 +1549,12 @@ MemCpyCommand::MemCpyCommand(Requirement SrcReq,
     MEvent->setContextImpl(MSrcQueue->getContextImplPtr());
   }
 
-  MWorkerQueue = !MQueue ? MSrcQueue : MQueue;
+  // Device to device copies are enqueued to the source queue, which is in
+  // another context for peer to peer copies.
+  MWorkerQueue = !MQueue || (MSrcQueue && MSrcQueue->getContextImplPtr() !=
+                                              MQueue->getContextImplPtr())
+                     ? MSrcQueue
+                     : MQueue;
   MEvent->setWorkerQueue(MWorkerQueue);
 
   emitInstrumentationDataProxy();
@@ -1992,15 +2054,17 @@ void instrumentationAddExtraKernelMetadata(
 
     EliminatedArgMask = KernelImpl->getKernelArgMask();
     Program = KernelImpl->getDeviceImage()->get_ur_program_ref();
+    Kernel = KernelImpl->getHandleRef();
   } else if (nullptr != SyclKernel) {
     Program = SyclKernel->getProgramRef();
+    Kernel = SyclKernel->getHandleRef();
     if (!SyclKernel->isCreatedFromSource())
       EliminatedArgMask = SyclKernel->getKernelArgMask();
   } else if (Queue) {
     // NOTE: Queue can be null when kernel is directly enqueued to a command
     // buffer
     //       by graph API, when a modifiable graph is finalized.
-    std::tie(Kernel, KernelMutex, EliminatedArgMask, Program) =
+    std::tie(Kernel, KernelMutex, EliminatedArgMask, Program, std::ignore) =
         detail::ProgramManager::getInstance().getOrCreateKernel(
             Queue->getContextImplPtr(), Queue->getDeviceImplPtr(), KernelName);
   }
@@ -2020,6 +2084,16 @@ void instrumentationAddExtraKernelMetadata(
                                         Args[i].MSize, Args[i].MIndex};
     xpti::addMetadata(CmdTraceEvent, Prefix + std::to_string(i), arg);
   }
+
+  // The registers and the spill memory the backend compiler allocated for the
+  // kernel, spills being a common cause of performance cliffs.
+  if (Kernel && Queue) {
+    KernelResourceUsage Usage = getKernelResourceUsage(
+        Kernel, Queue->getDeviceImplPtr()->getHandleRef(),
+        Queue->getAdapter());
+    xpti::addMetadata(CmdTraceEvent, "num_regs", Usage.NumRegs);
+    xpti::addMetadata(CmdTraceEvent, "spill_mem_size", Usage.SpillMemSize);
+  }
 }
 
 void instrumentationFillCommonData(const std::string &KernelName,
@@ -2295,7 +2369,13 @@ void SetArgBasedOnType(
     const AdapterPtr &Adapter, ur_kernel_handle_t Kernel,
     const std::shared_ptr<device_image_impl> &DeviceImageImpl,
     const std::function<void *(Requirement *Req)> &getMemAllocationFunc,
-    const sycl::context &Context, detail::ArgDesc &Arg, size_t NextTrueIndex) {
+    const sycl::context &Context, detail::ArgDesc &Arg, size_t NextTrueIndex,
+    KernelArgCache *ArgCache) {
+  // Only the values and the USM pointers are recorded, see KernelArgCache.
+  if (ArgCache && Arg.MType != kernel_param_kind_t::kind_pointer &&
+      !(Arg.MType == kernel_param_kind_t::kind_std_layout && Arg.MPtr))
+    ArgCache->reset(NextTrueIndex);
+
   switch (Arg.MType) {
   case kernel_param_kind_t::kind_stream:
     break;
@@ -2319,8 +2399,13 @@ void SetArgBasedOnType(
   }
   case kernel_param_kind_t::kind_std_layout: {
     if (Arg.MPtr) {
+      if (ArgCache &&
+          ArgCache->isSet(NextTrueIndex, Arg.MType, Arg.MPtr, Arg.MSize))
+        break;
       Adapter->call<UrApiKind::urKernelSetArgValue>(
           Kernel, NextTrueIndex, Arg.MSize, nullptr, Arg.MPtr);
+      if (ArgCache)
+        ArgCache->set(NextTrueIndex, Arg.MType, Arg.MPtr, Arg.MSize);
     } else {
       Adapter->call<UrApiKind::urKernelSetArgLocal>(Kernel, NextTrueIndex,
                                                     Arg.MSize, nullptr);
@@ -2341,8 +2426,13 @@ void SetArgBasedOnType(
     // We need to de-rerence this to get the actual USM allocation - that's the
     // pointer UR is expecting.
     const void *Ptr = *static_cast<const void *const *>(Arg.MPtr);
+    if (ArgCache &&
+        ArgCache->isSet(NextTrueIndex, Arg.MType, &Ptr, sizeof(Ptr)))
+      break;
     Adapter->call<UrApiKind::urKernelSetArgPointer>(Kernel, NextTrueIndex,
                                                     nullptr, Ptr);
+    if (ArgCache)
+      ArgCache->set(NextTrueIndex, Arg.MType, &Ptr, sizeof(Ptr));
     break;
   }
   case kernel_param_kind_t::kind_specialization_constants_buffer: {
@@ -2375,25 +2465,46 @@ static ur_result_t SetKernelParamsAndLaunch(
     const KernelArgMask *EliminatedArgMask,
     const std::function<void *(Requirement *Req)> &getMemAllocationFunc,
     bool IsCooperative, bool KernelUsesClusterLaunch,
-    const RTDeviceBinaryImage *BinImage, const std::string &KernelName) {
+    const RTDeviceBinaryImage *BinImage, const std::string &KernelName,
+    bool KernelSpecializesNDRange, KernelArgCache *ArgCache) {
   assert(Queue && "Kernel submissions should have an associated queue");
   const AdapterPtr &Adapter = Queue->getAdapter();
 
   if (SYCLConfig<SYCL_JIT_AMDGCN_PTX_KERNELS>::get()) {
     std::vector<unsigned char> Empty;
-    Kernel = Scheduler::getInstance().completeSpecConstMaterialization(
-        Queue, BinImage, KernelName,
+    std::vector<unsigned char> &SpecConstBlob =
         DeviceImageImpl.get() ? DeviceImageImpl->get_spec_const_blob_ref()
-                              : Empty);
+                              : Empty;
+    // The ND-range can only be materialized if the local size is known.
+    const NDRDescT *SpecializedNDRange =
+        KernelSpecializesNDRange && NDRDesc.LocalSize[0] != 0 ? &NDRDesc
+                                                              : nullptr;
+    if (SYCLConfig<SYCL_JIT_BACKGROUND_COMPILATION>::get()) {
+      // Launch the kernel as it is until the materialized one is ready.
+      if (ur_kernel_handle_t MaterializedKernel =
+              Scheduler::getInstance().requestSpecConstMaterialization(
+                  Queue, BinImage, KernelName, SpecConstBlob,
+                  SpecializedNDRange))
+        Kernel = MaterializedKernel;
+    } else {
+      Kernel = Scheduler::getInstance().completeSpecConstMaterialization(
+          Queue, BinImage, KernelName, SpecConstBlob, SpecializedNDRange);
+    }
+    // The arguments of the materialized kernels aren't recorded.
+    ArgCache = nullptr;
   }
 
   auto setFunc = [&Adapter, Kernel, &DeviceImageImpl, &getMemAllocationFunc,
-                  &Queue](detail::ArgDesc &Arg, size_t NextTrueIndex) {
+                  &Queue, ArgCache](detail::ArgDesc &Arg,
+                                    size_t NextTrueIndex) {
     SetArgBasedOnType(Adapter, Kernel, DeviceImageImpl, getMemAllocationFunc,
-                      Queue->get_context(), Arg, NextTrueIndex);
+                      Queue->get_context(), Arg, NextTrueIndex, ArgCache);
   };
 
-  applyFuncOnFilteredArgs(EliminatedArgMask, Args, setFunc);
+  {
+    SubmissionPhaseTimer Timer(submission_phase::set_arguments);
+    applyFuncOnFilteredArgs(EliminatedArgMask, Args, setFunc);
+  }
 
   adjustNDRangePerKernel(NDRDesc, Kernel, *(Queue->getDeviceImplPtr()));
 
@@ -2489,6 +2600,8 @@ ur_result_t enqueueImpCommandBufferKernel(
   ur_program_handle_t UrProgram = nullptr;
   std::shared_ptr<kernel_impl> SyclKernelImpl = nullptr;
   std::shared_ptr<device_image_impl> DeviceImageImpl = nullptr;
+  std::mutex *KernelMutex = nullptr;
+  KernelArgCache *ArgCache = nullptr;
 
   auto Kernel = CommandGroup.MSyclKernel;
   auto KernelBundleImplPtr = CommandGroup.MKernelBundle;
@@ -2510,22 +2623,31 @@ ur_result_t enqueueImpCommandBufferKernel(
     DeviceImageImpl = SyclKernelImpl->getDeviceImage();
     UrProgram = DeviceImageImpl->get_ur_program_ref();
     EliminatedArgMask = SyclKernelImpl->getKernelArgMask();
+    KernelMutex = SyclKernelImpl->getCacheMutex();
+    ArgCache = SyclKernelImpl->getArgCache();
   } else if (Kernel != nullptr) {
     UrKernel = Kernel->getHandleRef();
     UrProgram = Kernel->getProgramRef();
     EliminatedArgMask = Kernel->getKernelArgMask();
+    KernelMutex = Kernel->getCacheMutex();
+    ArgCache = Kernel->getArgCache();
   } else {
-    std::tie(UrKernel, std::ignore, EliminatedArgMask, UrProgram) =
+    std::tie(UrKernel, KernelMutex, EliminatedArgMask, UrProgram, ArgCache) =
         sycl::detail::ProgramManager::getInstance().getOrCreateKernel(
             ContextImpl, DeviceImpl, CommandGroup.MKernelName);
   }
 
+  // The arguments recorded by the launches of a shared kernel must match the
+  // ones set on it until the command is appended.
+  using LockT = std::unique_lock<std::mutex>;
+  auto Lock = KernelMutex && ArgCache ? LockT(*KernelMutex) : LockT();
+
   auto SetFunc = [&Adapter, &UrKernel, &DeviceImageImpl, &Ctx,
-                  &getMemAllocationFunc](sycl::detail::ArgDesc &Arg,
-                                         size_t NextTrueIndex) {
+                  &getMemAllocationFunc, ArgCache](sycl::detail::ArgDesc &Arg,
+                                                   size_t NextTrueIndex) {
     sycl::detail::SetArgBasedOnType(Adapter, UrKernel, DeviceImageImpl,
                                     getMemAllocationFunc, Ctx, Arg,
-                                    NextTrueIndex);
+                                    NextTrueIndex, ArgCache);
   };
   // Copy args for modification
   auto Args = CommandGroup.MArgs;
@@ -2574,6 +2696,8 @@ ur_result_t enqueueImpCommandBufferKernel(
           SyncPoints.size() ? SyncPoints.data() : nullptr, 0, nullptr,
           OutSyncPoint, nullptr,
           CommandBufferDesc.isUpdatable ? OutCommand : nullptr);
+  if (Lock.owns_lock())
+    Lock.unlock();
 
   if (!SyclKernelImpl && !Kernel) {
     Adapter->call<UrApiKind::urKernelRelease>(UrKernel);
@@ -2597,13 +2721,15 @@ void enqueueImpKernel(
     const detail::EventImplPtr &OutEventImpl,
     const std::function<void *(Requirement *Req)> &getMemAllocationFunc,
     ur_kernel_cache_config_t KernelCacheConfig, const bool KernelIsCooperative,
-    const bool KernelUsesClusterLaunch, const RTDeviceBinaryImage *BinImage) {
+    const bool KernelUsesClusterLaunch, const RTDeviceBinaryImage *BinImage,
+    const bool KernelSpecializesNDRange) {
   assert(Queue && "Kernel submissions should have an associated queue");
   // Run OpenCL kernel
   auto ContextImpl = Queue->getContextImplPtr();
   auto DeviceImpl = Queue->getDeviceImplPtr();
   ur_kernel_handle_t Kernel = nullptr;
   std::mutex *KernelMutex = nullptr;
+  KernelArgCache *ArgCache = nullptr;
   ur_program_handle_t Program = nullptr;
   const KernelArgMask *EliminatedArgMask;
 
@@ -2630,22 +2756,29 @@ void enqueueImpKernel(
 
     EliminatedArgMask = SyclKernelImpl->getKernelArgMask();
     KernelMutex = SyclKernelImpl->getCacheMutex();
+    ArgCache = SyclKernelImpl->getArgCache();
   } else if (nullptr != MSyclKernel) {
     assert(MSyclKernel->get_info<info::kernel::context>() ==
            Queue->get_context());
     Kernel = MSyclKernel->getHandleRef();
     Program = MSyclKernel->getProgramRef();
 
+    // The kernels of the cache, launched directly without their kernel
+    // bundle, share their handle and the mutex guarding it with the other
+    // launches.
     // Non-cacheable kernels use mutexes from kernel_impls.
     // TODO this can still result in a race condition if multiple SYCL
     // kernels are created with the same native handle. To address this,
     // we need to either store and use a ur_native_handle_t -> mutex map or
     // reuse and return existing SYCL kernels from make_native to avoid
     // their duplication in such cases.
-    KernelMutex = &MSyclKernel->getNoncacheableEnqueueMutex();
+    KernelMutex = MSyclKernel->getCacheMutex();
+    if (!KernelMutex)
+      KernelMutex = &MSyclKernel->getNoncacheableEnqueueMutex();
+    ArgCache = MSyclKernel->getArgCache();
     EliminatedArgMask = MSyclKernel->getKernelArgMask();
   } else {
-    std::tie(Kernel, KernelMutex, EliminatedArgMask, Program) =
+    std::tie(Kernel, KernelMutex, EliminatedArgMask, Program, ArgCache) =
         detail::ProgramManager::getInstance().getOrCreateKernel(
             ContextImpl, DeviceImpl, KernelName, NDRDesc);
   }
@@ -2668,6 +2801,25 @@ void enqueueImpKernel(
     EventsWaitList = EventsWithDeviceGlobalInits;
   }
 
+  // Prefetch the shared allocations the arguments of the kernel point into.
+  std::vector<ur_event_handle_t> PrefetchEvents;
+  if (usm::USMPrefetcher::isEnabled()) {
+    std::vector<const void *> Ptrs;
+    auto collectPtr = [&Ptrs](detail::ArgDesc &Arg, size_t) {
+      if (Arg.MType == kernel_param_kind_t::kind_pointer)
+        Ptrs.push_back(*static_cast<const void *const *>(Arg.MPtr));
+    };
+    applyFuncOnFilteredArgs(EliminatedArgMask, Args, collectPtr);
+    PrefetchEvents = ContextImpl->getUSMPrefetcher().prefetch(
+        *Queue, Ptrs, EventsWaitList);
+    EventsWaitList.insert(EventsWaitList.end(), PrefetchEvents.begin(),
+                          PrefetchEvents.end());
+  }
+
+  std::unique_ptr<WorkGroupCounters> Counters;
+  if (WorkGroupCounters::isEnabled())
+    Counters = WorkGroupCounters::begin(Queue, Program, NDRDesc);
+
   ur_result_t Error = UR_RESULT_SUCCESS;
   {
     // When KernelMutex is null, this means that in-memory caching is
@@ -2689,9 +2841,14 @@ void enqueueImpKernel(
     Error = SetKernelParamsAndLaunch(
         Queue, Args, DeviceImageImpl, Kernel, NDRDesc, EventsWaitList,
         OutEventImpl, EliminatedArgMask, getMemAllocationFunc,
-        KernelIsCooperative, KernelUsesClusterLaunch, BinImage, KernelName);
+        KernelIsCooperative, KernelUsesClusterLaunch, BinImage, KernelName,
+        KernelSpecializesNDRange, ArgCache);
+    if (Counters && Error == UR_RESULT_SUCCESS)
+      Counters->end(OutEventImpl);
 
     const AdapterPtr &Adapter = Queue->getAdapter();
+    for (ur_event_handle_t Event : PrefetchEvents)
+      Adapter->call<UrApiKind::urEventRelease>(Event);
     if (!SyclKernelImpl && !MSyclKernel) {
       Adapter->call<UrApiKind::urKernelRelease>(Kernel);
       Adapter->call<UrApiKind::urProgramRelease>(Program);
@@ -3029,7 +3186,8 @@ ur_result_t ExecCGCommand::enqueueImpQueue() {
                      SyclKernel, KernelName, RawEvents, EventImpl,
                      getMemAllocationFunc, ExecKernel->MKernelCacheConfig,
                      ExecKernel->MKernelIsCooperative,
-                     ExecKernel->MKernelUsesClusterLaunch, BinImage);
+                     ExecKernel->MKernelUsesClusterLaunch, BinImage,
+                     ExecKernel->MKernelSpecializesNDRange);
 
     return UR_RESULT_SUCCESS;
   }
@@ -3158,7 +3316,7 @@ ur_result_t ExecCGCommand::enqueueImpQueue() {
     // submitted to report exception origin properly.
     copySubmissionCodeLocation();
 
-    queue_impl::getThreadPool().submit<DispatchHostTask>(
+    DispatchHostTask::dispatch(
         DispatchHostTask(this, std::move(ReqToMem), std::move(ReqUrMem)));
 
     MShouldCompleteEventIfPossible = false;
@@ -27,23 +27,45 @@
 #include <memory>
 #include <queue>
 #include <set>
+#include <utility>
 #include <vector>
 
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
 
+/// Returns the first and past the last bytes of the memory object which the
+/// ranged accessor or the sub-buffer of the requirement may access.
+static std::pair<size_t, size_t> getAccessedBytes(const Requirement *Req) {
+  const range<3> &MemRange = Req->MMemoryRange;
+  const range<3> &AccessRange = Req->MAccessRange;
+  const id<3> &Offset = Req->MOffset;
+  if (AccessRange.size() == 0)
+    return {Req->MOffsetInBytes, Req->MOffsetInBytes};
+
+  auto Linearize = [&MemRange](size_t I0, size_t I1, size_t I2) {
+    return (I0 * MemRange[1] + I1) * MemRange[2] + I2;
+  };
+  size_t First = Linearize(Offset[0], Offset[1], Offset[2]);
+  size_t Last =
+      Linearize(Offset[0] + AccessRange[0] - 1, Offset[1] + AccessRange[1] - 1,
+                Offset[2] + AccessRange[2] - 1);
+  return {Req->MOffsetInBytes + First * Req->MElemSize,
+          Req->MOffsetInBytes + (Last + 1) * Req->MElemSize};
+}
+
 /// Checks whether two requirements overlap or not.
 ///
 /// This information can be used to prove that executing two kernels that
-/// work on different parts of the memory object in parallel is legal.
+/// work on different parts of the memory object in parallel is legal. The
+/// requirements of multi-dimensional ranged accessors are approximated with
+/// the contiguous bytes between their first and last elements.
 // TODO merge with LeavesCollection's version of doOverlap (see
 // leaves_collection.cpp).
 static bool doOverlap(const Requirement *LHS, const Requirement *RHS) {
-  return (LHS->MOffsetInBytes + LHS->MAccessRange.size() * LHS->MElemSize >=
-          RHS->MOffsetInBytes) ||
-         (RHS->MOffsetInBytes + RHS->MAccessRange.size() * RHS->MElemSize >=
-          LHS->MOffsetInBytes);
+  auto [LHSStart, LHSEnd] = getAccessedBytes(LHS);
+  auto [RHSStart, RHSEnd] = getAccessedBytes(RHS);
+  return LHSStart < RHSEnd && RHSStart < LHSEnd;
 }
 
 /// Checks if current requirement is requirement for sub buffer.
@@ -58,6 +80,39 @@ static bool isOnSameContext(const ContextImplPtr Context,
   return Context == queue_impl::getContext(Queue);
 }
 
+/// Checks if the buffer memory of Record in its current device context can be
+/// copied directly to the context of Queue, without going through the host.
+/// This needs both contexts to have a single device, the source device being
+/// able to access the memory of the target one.
+static bool canCopyPeerToPeer(const MemObjRecord *Record,
+                              const Requirement *Req,
+                              const QueueImplPtr &Queue) {
+  const ContextImplPtr &SrcContext = Record->MCurContext;
+  if (!SrcContext || !Queue ||
+      Req->MSYCLMemObj->getType() != SYCLMemObjI::MemObjType::Buffer)
+    return false;
+  const ContextImplPtr &DstContext = Queue->getContextImplPtr();
+  if (SrcContext->getDevices().size() != 1 ||
+      DstContext->getDevices().size() != 1)
+    return false;
+
+  const DeviceImplPtr &SrcDevice =
+      getSyclObjImpl(SrcContext->getDevices().front());
+  const DeviceImplPtr &DstDevice = Queue->getDeviceImplPtr();
+  if (SrcDevice->getPlatformImpl() != DstDevice->getPlatformImpl())
+    return false;
+
+  // Adapters without peer to peer support report it as an error.
+  int Supported = 0;
+  ur_result_t Error =
+      SrcDevice->getAdapter()
+          ->call_nocheck<UrApiKind::urUsmP2PPeerAccessGetInfoExp>(
+              SrcDevice->getHandleRef(), DstDevice->getHandleRef(),
+              UR_EXP_PEER_INFO_UR_PEER_ACCESS_SUPPORTED, sizeof(Supported),
+              &Supported, nullptr);
+  return Error == UR_RESULT_SUCCESS && Supported == 1;
+}
+
 /// Checks if the required access mode is allowed under the current one.
 static bool isAccessModeAllowed(access::mode Required, access::mode Current) {
   switch (Current) {
@@ -187,7 +242,7 @@ Scheduler::GraphBuilder::getOrInsertMemObjRecord(const QueueImplPtr &Queue,
   if (nullptr != Record)
     return Record;
 
-  const size_t LeafLimit = 8;
+  const size_t LeafLimit = SYCLConfig<SYCL_MAX_LEAVES>::get();
   LeavesCollection::AllocateDependencyF AllocateDependency =
       [this](Command *Dependant, Command *Dependency, MemObjRecord *Record,
              LeavesCollection::EnqueueListT &ToEnqueue) {
@@ -206,6 +261,11 @@ Scheduler::GraphBuilder::getOrInsertMemObjRecord(const QueueImplPtr &Queue,
         for (Command *Cmd : ToCleanUp)
           cleanupCommand(Cmd);
       };
+  LeavesCollection::ReleaseLeafF ReleaseLeaf = [this](Command *Leaf) {
+    --(Leaf->MLeafCounter);
+    if (Leaf->readyForCleanup())
+      cleanupCommand(Leaf);
+  };
 
   const ContextImplPtr &InteropCtxPtr = Req->MSYCLMemObj->getInteropContext();
   if (InteropCtxPtr) {
@@ -225,7 +285,8 @@ Scheduler::GraphBuilder::getOrInsertMemObjRecord(const QueueImplPtr &Queue,
         Dev, InteropCtxPtr, /*AsyncHandler=*/{}, /*PropertyList=*/{}}};
 
     MemObject->MRecord.reset(
-        new MemObjRecord{InteropCtxPtr, LeafLimit, AllocateDependency});
+        new MemObjRecord{InteropCtxPtr, LeafLimit, AllocateDependency,
+                         ReleaseLeaf});
     std::vector<Command *> ToEnqueue;
     getOrCreateAllocaForReq(MemObject->MRecord.get(), Req, InteropQueuePtr,
                             ToEnqueue);
@@ -234,7 +295,8 @@ Scheduler::GraphBuilder::getOrInsertMemObjRecord(const QueueImplPtr &Queue,
                                 "alloca or exceeding the leaf limit).");
   } else
     MemObject->MRecord.reset(new MemObjRecord{queue_impl::getContext(Queue),
-                                              LeafLimit, AllocateDependency});
+                                              LeafLimit, AllocateDependency,
+                                              ReleaseLeaf});
 
   MMemObjs.push_back(MemObject);
   return MemObject->MRecord.get();
@@ -460,7 +522,8 @@ Command *Scheduler::GraphBuilder::remapMemoryObject(
 // pointed by Req.
 Command *
 Scheduler::GraphBuilder::addCopyBack(Requirement *Req,
-                                     std::vector<Command *> &ToEnqueue) {
+                                     std::vector<Command *> &ToEnqueue,
+                                     bool OnlyModified) {
   SYCLMemObjI *MemObj = Req->MSYCLMemObj;
   MemObjRecord *Record = getMemObjRecord(MemObj);
   if (Record && MPrintOptionsArray[BeforeAddCopyBack])
@@ -474,9 +537,27 @@ Scheduler::GraphBuilder::addCopyBack(Requirement *Req,
   AllocaCommandBase *SrcAllocaCmd =
       findAllocaForReq(Record, Req, Record->MCurContext);
 
+  Requirement SrcReq = *SrcAllocaCmd->getRequirement();
+  // The destination is expected to be a byte range over the whole buffer, of
+  // which only the modified part is copied when the rest is up to date.
+  if (OnlyModified && MemObj->getType() == SYCLMemObjI::MemObjType::Buffer &&
+      Req->MDims == 1 && Req->MElemSize == 1 &&
+      Record->MModifiedBegin < Record->MModifiedEnd) {
+    const size_t Begin = Record->MModifiedBegin;
+    const size_t End = std::min(Record->MModifiedEnd, MemObj->getSizeInBytes());
+    const range<3> MemoryRange{MemObj->getSizeInBytes(), 1, 1};
+    for (Requirement *CopyReq : {&SrcReq, Req}) {
+      CopyReq->MDims = 1;
+      CopyReq->MElemSize = 1;
+      CopyReq->MOffset = id<3>{Begin, 0, 0};
+      CopyReq->MAccessRange = range<3>{End - Begin, 1, 1};
+      CopyReq->MMemoryRange = MemoryRange;
+    }
+  }
+
   auto MemCpyCmdUniquePtr = std::make_unique<MemCpyCommandHost>(
-      *SrcAllocaCmd->getRequirement(), SrcAllocaCmd, *Req, &Req->MData,
-      SrcAllocaCmd->getQueue(), nullptr);
+      SrcReq, SrcAllocaCmd, *Req, &Req->MData, SrcAllocaCmd->getQueue(),
+      nullptr);
 
   if (!MemCpyCmdUniquePtr)
     throw exception(make_error_code(errc::memory_allocation),
@@ -583,11 +664,13 @@ Scheduler::GraphBuilder::findDepsForReq(MemObjRecord *Record,
     ToAnalyze.insert(ToAnalyze.begin(), V.begin(), V.end());
   }
 
+  // Reused across iterations to avoid an allocation per analyzed command.
+  std::vector<Command *> NewAnalyze;
   while (!ToAnalyze.empty()) {
     Command *DepCmd = ToAnalyze.back();
     ToAnalyze.pop_back();
 
-    std::vector<Command *> NewAnalyze;
+    NewAnalyze.clear();
 
     for (const DepDesc &Dep : DepCmd->MDeps) {
       if (Dep.MDepRequirement->MSYCLMemObj != Req->MSYCLMemObj)
@@ -642,6 +725,17 @@ DepDesc Scheduler::GraphBuilder::findDepForRecord(Command *Cmd,
 AllocaCommandBase *Scheduler::GraphBuilder::findAllocaForReq(
     MemObjRecord *Record, const Requirement *Req, const ContextImplPtr &Context,
     bool AllowConst) {
+  // Steady-state loops keep asking for the same allocation, check the result
+  // of the previous lookup first.
+  const bool IsSubReq = IsSuitableSubReq(Req);
+  MemObjRecord::AllocaLookupT &LastLookup = Record->MLastAllocaLookup;
+  if (LastLookup.AllocaCmd && LastLookup.Context == Context.get() &&
+      LastLookup.IsSubReq == IsSubReq &&
+      (!IsSubReq || (LastLookup.OffsetInBytes == Req->MOffsetInBytes &&
+                     LastLookup.AccessRange == Req->MAccessRange &&
+                     LastLookup.AllowConst == AllowConst)))
+    return LastLookup.AllocaCmd;
+
   auto IsSuitableAlloca = [&Context, Req,
                            AllowConst](AllocaCommandBase *AllocaCmd) {
     bool Res = isOnSameContext(Context, AllocaCmd->getQueue());
@@ -656,7 +750,18 @@ AllocaCommandBase *Scheduler::GraphBuilder::findAllocaForReq(
   };
   const auto It = std::find_if(Record->MAllocaCommands.begin(),
                                Record->MAllocaCommands.end(), IsSuitableAlloca);
-  return (Record->MAllocaCommands.end() != It) ? *It : nullptr;
+  if (Record->MAllocaCommands.end() == It)
+    return nullptr;
+
+  // The context of the found alloca is kept alive by it, so the raw pointer
+  // can't be reused by another context while the entry is in use.
+  LastLookup = {Context.get(),
+                IsSubReq,
+                Req->MOffsetInBytes,
+                Req->MAccessRange,
+                AllowConst,
+                *It};
+  return *It;
 }
 
 static bool checkHostUnifiedMemory(const ContextImplPtr &Ctx) {
@@ -779,6 +884,16 @@ AllocaCommandBase *Scheduler::GraphBuilder::getOrCreateAllocaForReq(
           }
       }
 
+      // Without the user data or a link to the host allocation the content of
+      // the memory object is copied to the new allocation.
+      auto *SYCLMemObj = static_cast<detail::SYCLMemObjT *>(MemObj);
+      if (Context && SYCLMemObj->requestsZeroCopy() && !InitFromUserData &&
+          !LinkedAllocaCmd)
+        SYCLMemObj->reportZeroCopyDeclined(
+            HostUnifiedMemory
+                ? "the memory object is already allocated in another context"
+                : "the device doesn't have host unified memory");
+
       AllocaCmd =
           new AllocaCommand(Queue, FullReq, InitFromUserData, LinkedAllocaCmd);
 
@@ -832,6 +947,30 @@ AllocaCommandBase *Scheduler::GraphBuilder::getOrCreateAllocaForReq(
   return AllocaCmd;
 }
 
+// Extends the modified bounds of the record with the bytes accessed by the
+// requirement. Images are always treated as fully modified.
+static void addModifiedRange(MemObjRecord *Record, const Requirement *Req) {
+  size_t Begin = 0;
+  size_t End = Req->MSYCLMemObj->getSizeInBytes();
+  if (Req->MSYCLMemObj->getType() == SYCLMemObjI::MemObjType::Buffer) {
+    if (Req->MAccessRange.size() == 0)
+      return;
+    // Row-major linear index of an element within the memory range, unused
+    // dimensions have zero offset and unit range.
+    auto Linearize = [Req](const id<3> &Idx) {
+      return (Idx[0] * Req->MMemoryRange[1] + Idx[1]) * Req->MMemoryRange[2] +
+             Idx[2];
+    };
+    const id<3> Last{Req->MOffset[0] + Req->MAccessRange[0] - 1,
+                     Req->MOffset[1] + Req->MAccessRange[1] - 1,
+                     Req->MOffset[2] + Req->MAccessRange[2] - 1};
+    Begin = Req->MOffsetInBytes + Linearize(Req->MOffset) * Req->MElemSize;
+    End = Req->MOffsetInBytes + (Linearize(Last) + 1) * Req->MElemSize;
+  }
+  Record->MModifiedBegin = std::min(Record->MModifiedBegin, Begin);
+  Record->MModifiedEnd = std::max(Record->MModifiedEnd, End);
+}
+
 // The function sets MemModified flag in record if requirement has write access.
 void Scheduler::GraphBuilder::markModifiedIfWrite(MemObjRecord *Record,
                                                   Requirement *Req) {
@@ -842,6 +981,7 @@ void Scheduler::GraphBuilder::markModifiedIfWrite(MemObjRecord *Record,
   case access::mode::discard_read_write:
   case access::mode::atomic:
     Record->MMemModified = true;
+    addModifiedRange(Record, Req);
     break;
   case access::mode::read:
     break;
@@ -922,9 +1062,6 @@ Command *Scheduler::GraphBuilder::addCG(
     std::vector<Command *> &ToEnqueue, bool EventNeeded,
     ur_exp_command_buffer_handle_t CommandBuffer,
     const std::vector<ur_exp_command_buffer_sync_point_t> &Dependencies) {
-  std::vector<Requirement *> &Reqs = CommandGroup->getRequirements();
-  std::vector<detail::EventImplPtr> &Events = CommandGroup->getEvents();
-
   auto NewCmd = std::make_unique<ExecCGCommand>(std::move(CommandGroup), Queue,
                                                 EventNeeded, CommandBuffer,
                                                 std::move(Dependencies));
@@ -933,6 +1070,41 @@ Command *Scheduler::GraphBuilder::addCG(
     throw exception(make_error_code(errc::memory_allocation),
                     "Out of host memory");
 
+  return addCG(std::move(NewCmd), Queue, ToEnqueue);
+}
+
+Command *Scheduler::GraphBuilder::tryAddIndependentCG(
+    std::unique_ptr<ExecCGCommand> &NewCmd, std::vector<Command *> &ToEnqueue) {
+  detail::CG &CG = NewCmd->getCG();
+  if (!CG.getRequirements().empty() || MPrintOptionsArray[BeforeAddCG] ||
+      MPrintOptionsArray[AfterAddCG])
+    return nullptr;
+
+  // Events without a command are not part of the graph. Events from another
+  // context would need a connection command, leave those to addCG.
+  ContextImplPtr WorkerContext = NewCmd->getWorkerContext();
+  for (const detail::EventImplPtr &Event : CG.getEvents())
+    if (Event->getCommand() ||
+        (WorkerContext && Event->getContextImpl() != WorkerContext))
+      return nullptr;
+
+  std::vector<Command *> ToCleanUp;
+  for (const detail::EventImplPtr &Event : CG.getEvents()) {
+    if (Command *ConnCmd = NewCmd->addDep(Event, ToCleanUp))
+      ToEnqueue.push_back(ConnCmd);
+  }
+  assert(ToCleanUp.empty() && "Independent command should not need cleanup");
+
+  return NewCmd.release();
+}
+
+Command *
+Scheduler::GraphBuilder::addCG(std::unique_ptr<ExecCGCommand> NewCmd,
+                               const QueueImplPtr &Queue,
+                               std::vector<Command *> &ToEnqueue) {
+  std::vector<Requirement *> &Reqs = NewCmd->getCG().getRequirements();
+  std::vector<detail::EventImplPtr> &Events = NewCmd->getCG().getEvents();
+
   bool isInteropTask = isInteropHostTask(NewCmd.get());
 
   if (MPrintOptionsArray[BeforeAddCG])
@@ -979,8 +1151,8 @@ Command *Scheduler::GraphBuilder::addCG(
                           ToEnqueue);
       }
     } else {
-      // Cannot directly copy memory from OpenCL device to OpenCL device -
-      // create two copies: device->host and host->device.
+      // Memory can only be copied directly between devices with peer to peer
+      // access, otherwise create two copies: device->host and host->device.
       bool NeedMemMoveToHost = false;
       auto MemMoveTargetQueue = Queue;
 
@@ -993,7 +1165,7 @@ Command *Scheduler::GraphBuilder::addCG(
           MemMoveTargetQueue = HT.MQueue;
         }
       } else if (Queue && Record->MCurContext)
-        NeedMemMoveToHost = true;
+        NeedMemMoveToHost = !canCopyPeerToPeer(Record, Req, Queue);
 
       if (NeedMemMoveToHost)
         insertMemoryMove(Record, Req, nullptr, ToEnqueue);
@@ -1300,13 +1472,13 @@ Command *Scheduler::GraphBuilder::addCommandGraphUpdate(
     }
 
     if (!isSameCtx) {
-      // Cannot directly copy memory from OpenCL device to OpenCL device -
-      // create two copies: device->host and host->device.
+      // Memory can only be copied directly between devices with peer to peer
+      // access, otherwise create two copies: device->host and host->device.
       bool NeedMemMoveToHost = false;
       auto MemMoveTargetQueue = Queue;
 
       if (Queue && Record->MCurContext)
-        NeedMemMoveToHost = true;
+        NeedMemMoveToHost = !canCopyPeerToPeer(Record, Req, Queue);
 
       if (NeedMemMoveToHost)
         insertMemoryMove(Record, Req, nullptr, ToEnqueue);
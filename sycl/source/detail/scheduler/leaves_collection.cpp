@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <detail/event_impl.hpp>
 #include <detail/scheduler/leaves_collection.hpp>
 #include <detail/scheduler/scheduler.hpp>
 
@@ -120,7 +121,21 @@ bool LeavesCollection::addGenericCommand(Command *Cmd,
     if (OldLeaf == Cmd)
       return false;
 
-    MAllocateDependency(Cmd, OldLeaf, MRecord, ToEnqueue);
+    ++MStats.Overflows;
+    // Completed leaves don't impose any ordering, so they can be dropped
+    // without adding a dependency. Otherwise give the buffer more room before
+    // falling back to pushing out the oldest leaf.
+    if (compactGenericCommands() == 0) {
+      const size_t Capacity = MGenericCommands.capacity();
+      if (Capacity < MMaxGenericCommandsCapacity) {
+        MGenericCommands.grow(
+            std::min(Capacity * 2, MMaxGenericCommandsCapacity));
+        ++MStats.Grows;
+      } else {
+        MAllocateDependency(Cmd, OldLeaf, MRecord, ToEnqueue);
+        ++MStats.PushedOutLeaves;
+      }
+    }
   }
 
   MGenericCommands.push_back(Cmd);
@@ -128,6 +143,28 @@ bool LeavesCollection::addGenericCommand(Command *Cmd,
   return true;
 }
 
+size_t LeavesCollection::compactGenericCommands() {
+  if (!MReleaseLeaf)
+    return 0;
+
+  std::vector<Command *> Completed;
+  auto NewEnd = std::remove_if(
+      MGenericCommands.begin(), MGenericCommands.end(), [&](Command *Leaf) {
+        if (!Leaf->isSuccessfullyEnqueued() || !Leaf->getEvent()->isCompleted())
+          return false;
+        Completed.push_back(Leaf);
+        return true;
+      });
+  MGenericCommands.erase(NewEnd, MGenericCommands.end());
+
+  // Releasing may clean up the commands, so do it once the buffer is updated.
+  for (Command *Leaf : Completed)
+    MReleaseLeaf(Leaf);
+
+  MStats.CompactedLeaves += Completed.size();
+  return Completed.size();
+}
+
 void LeavesCollection::insertHostAccessorCommand(EmptyCommand *Cmd) {
   MHostAccessorCommandsXRef[Cmd] =
       MHostAccessorCommands.insert(MHostAccessorCommands.end(), Cmd);
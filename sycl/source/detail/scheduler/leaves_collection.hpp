@@ -45,6 +45,25 @@ public:
   using AllocateDependencyF =
       std::function<void(Command *, Command *, MemObjRecord *, EnqueueListT &)>;
 
+  // Called for a completed leaf dropped from the collection
+  using ReleaseLeafF = std::function<void(Command *)>;
+
+  /// Counters of how the generic commands buffer handled overflows.
+  struct Stats {
+    // Times the buffer was full.
+    size_t Overflows = 0;
+    // Completed leaves dropped to make room.
+    size_t CompactedLeaves = 0;
+    // Times the capacity was increased.
+    size_t Grows = 0;
+    // Leaves pushed out with a dependency added to the new command.
+    size_t PushedOutLeaves = 0;
+  };
+
+  // The capacity of the generic commands buffer may grow up to this many
+  // times its initial value.
+  static constexpr std::size_t MaxCapacityFactor = 4;
+
   template <bool IsConst> class IteratorT;
 
   using value_type = Command *;
@@ -57,9 +76,13 @@ public:
   using const_iterator = IteratorT<true>;
 
   LeavesCollection(MemObjRecord *Record, std::size_t GenericCommandsCapacity,
-                   AllocateDependencyF AllocateDependency)
+                   AllocateDependencyF AllocateDependency,
+                   ReleaseLeafF ReleaseLeaf = nullptr)
       : MRecord{Record}, MGenericCommands{GenericCommandsCapacity},
-        MAllocateDependency{std::move(AllocateDependency)} {}
+        MMaxGenericCommandsCapacity{GenericCommandsCapacity *
+                                    MaxCapacityFactor},
+        MAllocateDependency{std::move(AllocateDependency)},
+        MReleaseLeaf{std::move(ReleaseLeaf)} {}
 
   iterator begin() {
     if (MGenericCommands.empty())
@@ -103,6 +126,8 @@ public:
     return MHostAccessorCommands;
   }
 
+  const Stats &getStats() const { return MStats; }
+
 private:
   template <bool IsConst, typename T> struct Iterator;
 
@@ -124,9 +149,16 @@ private:
   HostAccessorCommandsT MHostAccessorCommands;
   HostAccessorCommandsXRefT MHostAccessorCommandsXRef;
 
+  std::size_t MMaxGenericCommandsCapacity;
+
   AllocateDependencyF MAllocateDependency;
+  ReleaseLeafF MReleaseLeaf;
+
+  Stats MStats;
 
   bool addGenericCommand(value_type Cmd, EnqueueListT &ToEnqueue);
+  // Drops completed generic commands, returns number of dropped ones.
+  size_t compactGenericCommands();
   bool addHostAccessorCommand(EmptyCommand *Cmd, EnqueueListT &ToEnqueue);
 
   // inserts a command to the end of list for its mem object
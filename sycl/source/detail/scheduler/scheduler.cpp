@@ -8,20 +8,24 @@
 
 #include <detail/scheduler/scheduler.hpp>
 
+#include <detail/config.hpp>
 #include <detail/global_handler.hpp>
 #include <detail/graph_impl.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/stream_impl.hpp>
+#include <detail/submission_stats.hpp>
 #include <detail/sycl_mem_obj_i.hpp>
 #include <sycl/device_selector.hpp>
 #include <sycl/feature_test.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstdio>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <thread>
+#include <utility>
 #include <vector>
 
 namespace sycl {
@@ -98,6 +102,7 @@ EventImplPtr Scheduler::addCG(
     std::unique_ptr<detail::CG> CommandGroup, const QueueImplPtr &Queue,
     bool EventNeeded, ur_exp_command_buffer_handle_t CommandBuffer,
     const std::vector<ur_exp_command_buffer_sync_point_t> &Dependencies) {
+  SubmissionPhaseTimer Timer(submission_phase::scheduler_add_cg);
   EventImplPtr NewEvent = nullptr;
   const CGType Type = CommandGroup->getType();
   std::vector<Command *> AuxiliaryCmds;
@@ -105,28 +110,45 @@ EventImplPtr Scheduler::addCG(
   AuxiliaryResources = CommandGroup->getAuxiliaryResources();
   CommandGroup->clearAuxiliaryResources();
 
-  {
-    WriteLockT Lock = acquireWriteLock();
+  // Host tasks are not bound to the queue in the graph.
+  const QueueImplPtr &CmdQueue =
+      Type == CGType::CodeplayHostTask ? nullptr : Queue;
+
+  // Creating the command does not touch the graph, so it is done before the
+  // graph lock is taken.
+  std::unique_ptr<ExecCGCommand> NewExecCmd;
+  if (Type != CGType::UpdateHost) {
+    NewExecCmd = std::make_unique<ExecCGCommand>(
+        std::move(CommandGroup), CmdQueue, EventNeeded,
+        Type == CGType::CodeplayHostTask ? nullptr : CommandBuffer,
+        Type == CGType::CodeplayHostTask
+            ? std::vector<ur_exp_command_buffer_sync_point_t>{}
+            : Dependencies);
+  }
 
-    Command *NewCmd = nullptr;
-    switch (Type) {
-    case CGType::UpdateHost:
-      NewCmd =
-          MGraphBuilder.addCGUpdateHost(std::move(CommandGroup), AuxiliaryCmds);
-      break;
-    case CGType::CodeplayHostTask: {
-      NewCmd = MGraphBuilder.addCG(std::move(CommandGroup), nullptr,
-                                   AuxiliaryCmds, EventNeeded);
-      break;
+  Command *NewCmd = nullptr;
+  {
+    SubmissionPhaseTimer GraphBuildTimer(submission_phase::graph_build);
+    if (NewExecCmd) {
+      // Commands not connected to the graph do not need exclusive access, so
+      // such submissions from different threads do not serialize.
+      ReadLockT Lock = acquireReadLock();
+      NewCmd = MGraphBuilder.tryAddIndependentCG(NewExecCmd, AuxiliaryCmds);
     }
-    default:
-      NewCmd = MGraphBuilder.addCG(std::move(CommandGroup), std::move(Queue),
-                                   AuxiliaryCmds, EventNeeded, CommandBuffer,
-                                   std::move(Dependencies));
+
+    if (!NewCmd) {
+      WriteLockT Lock = acquireWriteLock();
+
+      if (Type == CGType::UpdateHost)
+        NewCmd = MGraphBuilder.addCGUpdateHost(std::move(CommandGroup),
+                                               AuxiliaryCmds);
+      else
+        NewCmd =
+            MGraphBuilder.addCG(std::move(NewExecCmd), CmdQueue, AuxiliaryCmds);
     }
-    NewEvent = NewCmd->getEvent();
-    NewEvent->setSubmissionTime();
   }
+  NewEvent = NewCmd->getEvent();
+  NewEvent->setSubmissionTime();
 
   enqueueCommandForCG(NewEvent, AuxiliaryCmds);
 
@@ -139,6 +161,7 @@ EventImplPtr Scheduler::addCG(
 void Scheduler::enqueueCommandForCG(EventImplPtr NewEvent,
                                     std::vector<Command *> &AuxiliaryCmds,
                                     BlockingT Blocking) {
+  SubmissionPhaseTimer Timer(submission_phase::enqueue_command);
   std::vector<Command *> ToCleanUp;
   {
     ReadLockT Lock = acquireReadLock();
@@ -193,12 +216,12 @@ void Scheduler::enqueueCommandForCG(EventImplPtr NewEvent,
   cleanupCommands(ToCleanUp);
 }
 
-EventImplPtr Scheduler::addCopyBack(Requirement *Req) {
+EventImplPtr Scheduler::addCopyBack(Requirement *Req, bool OnlyModified) {
   std::vector<Command *> AuxiliaryCmds;
   Command *NewCmd = nullptr;
   {
     WriteLockT Lock = acquireWriteLock();
-    NewCmd = MGraphBuilder.addCopyBack(Req, AuxiliaryCmds);
+    NewCmd = MGraphBuilder.addCopyBack(Req, AuxiliaryCmds, OnlyModified);
     // Command was not created because there were no operations with
     // buffer.
     if (!NewCmd)
@@ -369,10 +392,30 @@ void Scheduler::enqueueLeavesOfReqUnlocked(const Requirement *const Req,
 void Scheduler::enqueueUnblockedCommands(
     const std::vector<EventImplPtr> &ToEnqueue, ReadLockT &GraphReadLock,
     std::vector<Command *> &ToCleanUp) {
+  // The commands of the queues of higher priority are enqueued first, so that
+  // the latency-critical work unblocked along with other work reaches the
+  // device first. The order of submission is kept among equal priorities.
+  std::vector<std::pair<int, Command *>> Cmds;
+  Cmds.reserve(ToEnqueue.size());
+  bool HasPriorities = false;
   for (auto &Event : ToEnqueue) {
     Command *Cmd = static_cast<Command *>(Event->getCommand());
     if (!Cmd)
       continue;
+    QueueImplPtr Queue = Event->getSubmittedQueue();
+    int Priority = Queue ? Queue->getSchedulingPriority() : 0;
+    HasPriorities |= Priority != 0;
+    Cmds.emplace_back(Priority, Cmd);
+  }
+  if (HasPriorities)
+    std::stable_sort(Cmds.begin(), Cmds.end(),
+                     [](const std::pair<int, Command *> &A,
+                        const std::pair<int, Command *> &B) {
+                       return A.first > B.first;
+                     });
+
+  for (const std::pair<int, Command *> &Entry : Cmds) {
+    Command *Cmd = Entry.second;
     EnqueueResultT Res;
     bool Enqueued =
         GraphProcessor::enqueueCommand(Cmd, GraphReadLock, Res, ToCleanUp, Cmd);
@@ -386,7 +429,7 @@ void Scheduler::releaseResources(BlockingT Blocking) {
   //  There might be some commands scheduled for post enqueue cleanup that
   //  haven't been freed because of the graph mutex being locked at the time,
   //  clean them up now.
-  cleanupCommands({});
+  cleanupCommands({}, /*Flush*/ true);
 
   cleanupAuxiliaryResources(Blocking);
   // We need loop since sometimes we may need new objects to be added to
@@ -405,13 +448,22 @@ MemObjRecord *Scheduler::getMemObjRecord(const Requirement *const Req) {
   return Req->MSYCLMemObj->MRecord.get();
 }
 
-void Scheduler::cleanupCommands(const std::vector<Command *> &Cmds) {
+void Scheduler::cleanupCommands(const std::vector<Command *> &Cmds,
+                                bool Flush) {
   cleanupAuxiliaryResources(BlockingT::NON_BLOCKING);
   cleanupDeferredMemObjects(BlockingT::NON_BLOCKING);
 
-  if (Cmds.empty()) {
+  {
     std::lock_guard<std::mutex> Lock{MDeferredCleanupMutex};
-    if (MDeferredCleanupCommands.empty())
+    // The commands are cleaned up in batches, so that the graph write lock is
+    // taken once for several of them under high submission rates.
+    if (!Flush && MDeferredCleanupCommands.size() + Cmds.size() <
+                      SYCLConfig<SYCL_POST_ENQUEUE_CLEANUP_BATCH_SIZE>::get()) {
+      MDeferredCleanupCommands.insert(MDeferredCleanupCommands.end(),
+                                      Cmds.begin(), Cmds.end());
+      return;
+    }
+    if (Cmds.empty() && MDeferredCleanupCommands.empty())
       return;
   }
 
@@ -582,10 +634,11 @@ ur_kernel_handle_t Scheduler::completeSpecConstMaterialization(
     [[maybe_unused]] QueueImplPtr Queue,
     [[maybe_unused]] const RTDeviceBinaryImage *BinImage,
     [[maybe_unused]] const std::string &KernelName,
-    [[maybe_unused]] std::vector<unsigned char> &SpecConstBlob) {
+    [[maybe_unused]] std::vector<unsigned char> &SpecConstBlob,
+    [[maybe_unused]] const NDRDescT *SpecializedNDRange) {
 #if SYCL_EXT_JIT_ENABLE
   return detail::jit_compiler::get_instance().materializeSpecConstants(
-      Queue, BinImage, KernelName, SpecConstBlob);
+      Queue, BinImage, KernelName, SpecConstBlob, SpecializedNDRange);
 #else  // SYCL_EXT_JIT_ENABLE
   if (detail::SYCLConfig<detail::SYCL_RT_WARNING_LEVEL>::get() > 0) {
     std::cerr << "WARNING: Materialization of spec constants not supported by "
@@ -595,6 +648,20 @@ ur_kernel_handle_t Scheduler::completeSpecConstMaterialization(
 #endif // SYCL_EXT_JIT_ENABLE
 }
 
+ur_kernel_handle_t Scheduler::requestSpecConstMaterialization(
+    [[maybe_unused]] QueueImplPtr Queue,
+    [[maybe_unused]] const RTDeviceBinaryImage *BinImage,
+    [[maybe_unused]] const std::string &KernelName,
+    [[maybe_unused]] std::vector<unsigned char> &SpecConstBlob,
+    [[maybe_unused]] const NDRDescT *SpecializedNDRange) {
+#if SYCL_EXT_JIT_ENABLE
+  return detail::jit_compiler::get_instance().requestSpecConstMaterialization(
+      Queue, BinImage, KernelName, SpecConstBlob, SpecializedNDRange);
+#else  // SYCL_EXT_JIT_ENABLE
+  return nullptr;
+#endif // SYCL_EXT_JIT_ENABLE
+}
+
 EventImplPtr Scheduler::addCommandGraphUpdate(
     ext::oneapi::experimental::detail::exec_graph_impl *Graph,
     std::vector<std::shared_ptr<ext::oneapi::experimental::detail::node_impl>>
@@ -14,6 +14,7 @@
 #include <detail/sycl_mem_obj_i.hpp>
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <queue>
 #include <set>
@@ -199,12 +200,27 @@ using CommandPtr = std::unique_ptr<Command>;
 /// \ingroup sycl_graph
 struct MemObjRecord {
   MemObjRecord(ContextImplPtr Ctx, std::size_t LeafLimit,
-               LeavesCollection::AllocateDependencyF AllocateDependency)
-      : MReadLeaves{this, LeafLimit, AllocateDependency},
-        MWriteLeaves{this, LeafLimit, AllocateDependency}, MCurContext{Ctx} {}
+               LeavesCollection::AllocateDependencyF AllocateDependency,
+               LeavesCollection::ReleaseLeafF ReleaseLeaf = nullptr)
+      : MReadLeaves{this, LeafLimit, AllocateDependency, ReleaseLeaf},
+        MWriteLeaves{this, LeafLimit, AllocateDependency, ReleaseLeaf},
+        MCurContext{Ctx} {}
   // Contains all allocation commands for the memory object.
   std::vector<AllocaCommandBase *> MAllocaCommands;
 
+  // The result of the last successful alloca lookup, see
+  // GraphBuilder::findAllocaForReq. Allocas are only ever appended to
+  // MAllocaCommands, so the first suitable one never changes and the entry
+  // stays valid for as long as the record exists.
+  struct AllocaLookupT {
+    const context_impl *Context = nullptr;
+    bool IsSubReq = false;
+    size_t OffsetInBytes = 0;
+    range<3> AccessRange{0, 0, 0};
+    bool AllowConst = false;
+    AllocaCommandBase *AllocaCmd = nullptr;
+  } MLastAllocaLookup;
+
   // Contains latest read only commands working with memory object.
   LeavesCollection MReadLeaves;
 
@@ -221,6 +237,11 @@ struct MemObjRecord {
   // The flag indicates that the content of the memory object was/will be
   // modified. Used while deciding if copy back needed.
   bool MMemModified = false;
+
+  // Bounds in bytes of the parts of the memory object modified so far,
+  // MModifiedBegin >= MModifiedEnd if nothing was modified.
+  size_t MModifiedBegin = SIZE_MAX;
+  size_t MModifiedEnd = 0;
 };
 
 /// DPC++ graph scheduler class.
@@ -385,8 +406,11 @@ public:
   ///
   /// \param Req is a requirement that points to the memory where data is
   /// needed.
+  /// \param OnlyModified is true if the memory pointed by the requirement
+  /// still holds the initial content of the memory object, so that only the
+  /// modified part has to be copied.
   /// \return an event object to wait on for copy finish.
-  EventImplPtr addCopyBack(Requirement *Req);
+  EventImplPtr addCopyBack(Requirement *Req, bool OnlyModified = false);
 
   /// Waits for the event.
   ///
@@ -452,9 +476,20 @@ public:
 
   void deferMemObjRelease(const std::shared_ptr<detail::SYCLMemObjI> &MemObj);
 
+  /// Returns the kernel with materialized specialization constants and, if
+  /// SpecializedNDRange is not null, the ND-range it is launched with.
   ur_kernel_handle_t completeSpecConstMaterialization(
       QueueImplPtr Queue, const RTDeviceBinaryImage *BinImage,
-      const std::string &KernelName, std::vector<unsigned char> &SpecConstBlob);
+      const std::string &KernelName, std::vector<unsigned char> &SpecConstBlob,
+      const NDRDescT *SpecializedNDRange = nullptr);
+
+  /// Returns the kernel with materialized specialization constants if it is
+  /// ready, otherwise requests its materialization in the background and
+  /// returns nullptr.
+  ur_kernel_handle_t requestSpecConstMaterialization(
+      QueueImplPtr Queue, const RTDeviceBinaryImage *BinImage,
+      const std::string &KernelName, std::vector<unsigned char> &SpecConstBlob,
+      const NDRDescT *SpecializedNDRange = nullptr);
 
   void releaseResources(BlockingT Blocking = BlockingT::BLOCKING);
   bool isDeferredMemObjectsEmpty();
@@ -511,7 +546,9 @@ protected:
   /// avoidance
   ReadLockT acquireReadLock() { return ReadLockT{MGraphLock}; }
 
-  void cleanupCommands(const std::vector<Command *> &Cmds);
+  /// Cleans up the commands, or defers it until enough commands are pending
+  /// cleanup, unless \p Flush is set.
+  void cleanupCommands(const std::vector<Command *> &Cmds, bool Flush = false);
 
   void NotifyHostTaskCompletion(Command *Cmd);
 
@@ -561,6 +598,23 @@ protected:
                    const std::vector<ur_exp_command_buffer_sync_point_t>
                        &Dependencies = {});
 
+    /// Adds a command created from a \ref CG "command group" beforehand to
+    /// the dependency graph.
+    ///
+    /// \sa addCG
+    Command *addCG(std::unique_ptr<ExecCGCommand> NewCmd,
+                   const QueueImplPtr &Queue,
+                   std::vector<Command *> &ToEnqueue);
+
+    /// Adds a command which neither accesses memory objects nor depends on
+    /// commands of the graph. Such a command is not connected to the graph,
+    /// so this only requires the graph to be locked for reading.
+    ///
+    /// \return the added command, or nullptr if the command does not meet the
+    /// conditions above. NewCmd is left untouched in the latter case.
+    Command *tryAddIndependentCG(std::unique_ptr<ExecCGCommand> &NewCmd,
+                                 std::vector<Command *> &ToEnqueue);
+
     /// Registers a \ref CG "command group" that updates host memory to the
     /// latest state.
     ///
@@ -571,7 +625,10 @@ protected:
     /// Enqueues a command to update memory to the latest state.
     ///
     /// \param Req is a requirement, that describes memory object.
-    Command *addCopyBack(Requirement *Req, std::vector<Command *> &ToEnqueue);
+    /// \param OnlyModified restricts the copy to the modified bytes of a
+    /// buffer.
+    Command *addCopyBack(Requirement *Req, std::vector<Command *> &ToEnqueue,
+                         bool OnlyModified = false);
 
     /// Enqueues a command to create a host accessor.
     ///
@@ -0,0 +1,88 @@
+//==---- staging_buffer_pool.cpp - Pinned host buffers for transfers -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/adapter.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/staging_buffer_pool.hpp>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+void StagingBufferPool::release() {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  for (StagingBuffer &Buffer : MBuffers)
+    freeBuffer(Buffer);
+  MBuffers.clear();
+}
+
+void *StagingBufferPool::acquire(size_t Size) {
+  const AdapterPtr &Adapter = MContextImpl.getAdapter();
+  std::unique_lock<std::mutex> Lock(MMutex);
+  auto Match = MBuffers.end();
+  for (auto It = MBuffers.begin(); It != MBuffers.end(); ++It) {
+    if (It->Size == Size && isIdle(*It)) {
+      Match = It;
+      break;
+    }
+  }
+
+  if (Match == MBuffers.end() && MBuffers.size() >= MaxBuffers) {
+    // Make room by dropping the oldest buffer of the pool.
+    StagingBuffer Oldest = MBuffers.front();
+    MBuffers.erase(MBuffers.begin());
+    Lock.unlock();
+    freeBuffer(Oldest);
+  } else if (Match != MBuffers.end()) {
+    void *Ptr = Match->Ptr;
+    if (Match->Event)
+      Adapter->call<UrApiKind::urEventRelease>(Match->Event);
+    MBuffers.erase(Match);
+    return Ptr;
+  } else {
+    Lock.unlock();
+  }
+
+  ur_usm_desc_t UsmDesc{};
+  void *Ptr = nullptr;
+  ur_result_t Error = Adapter->call_nocheck<UrApiKind::urUSMHostAlloc>(
+      MContextImpl.getHandleRef(), &UsmDesc, /*pool=*/nullptr, Size, &Ptr);
+  return Error == UR_RESULT_SUCCESS ? Ptr : nullptr;
+}
+
+void StagingBufferPool::recycle(void *Ptr, size_t Size,
+                                ur_event_handle_t Event) {
+  if (Event)
+    MContextImpl.getAdapter()->call<UrApiKind::urEventRetain>(Event);
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MBuffers.push_back({Ptr, Size, Event});
+}
+
+bool StagingBufferPool::isIdle(const StagingBuffer &Buffer) const {
+  if (!Buffer.Event)
+    return true;
+  ur_event_status_t Status = UR_EVENT_STATUS_QUEUED;
+  ur_result_t Error =
+      MContextImpl.getAdapter()->call_nocheck<UrApiKind::urEventGetInfo>(
+          Buffer.Event, UR_EVENT_INFO_COMMAND_EXECUTION_STATUS, sizeof(Status),
+          &Status, nullptr);
+  return Error == UR_RESULT_SUCCESS && Status == UR_EVENT_STATUS_COMPLETE;
+}
+
+void StagingBufferPool::freeBuffer(StagingBuffer &Buffer) {
+  const AdapterPtr &Adapter = MContextImpl.getAdapter();
+  if (Buffer.Event) {
+    Adapter->call<UrApiKind::urEventWait>(1, &Buffer.Event);
+    Adapter->call<UrApiKind::urEventRelease>(Buffer.Event);
+  }
+  Adapter->call<UrApiKind::urUSMFree>(MContextImpl.getHandleRef(), Buffer.Ptr);
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,66 @@
+//==---- staging_buffer_pool.hpp - Pinned host buffers for transfers -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/ur.hpp>
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class context_impl;
+
+/// Pinned host USM buffers of a context used to stage copies between pageable
+/// host memory and device memory. A buffer given back to the pool stays busy
+/// until the event of the last transfer using it completes.
+class StagingBufferPool {
+public:
+  StagingBufferPool(context_impl &ContextImpl) : MContextImpl(ContextImpl) {}
+  StagingBufferPool(const StagingBufferPool &) = delete;
+  StagingBufferPool &operator=(const StagingBufferPool &) = delete;
+
+  /// Waits for the pending transfers and frees the buffers. Must be called
+  /// while the context handle is still valid.
+  void release();
+
+  /// Takes a buffer of Size bytes out of the pool, allocating it if none is
+  /// idle. Once the pool holds MaxBuffers buffers the oldest one is freed,
+  /// waiting for its transfer if needed.
+  /// @return The buffer, nullptr if it cannot be allocated.
+  void *acquire(size_t Size);
+
+  /// Gives a buffer back to the pool.
+  /// @param Event Event of the last transfer using the buffer, retained by
+  /// the pool. May be nullptr.
+  void recycle(void *Ptr, size_t Size, ur_event_handle_t Event);
+
+private:
+  static constexpr size_t MaxBuffers = 8;
+
+  struct StagingBuffer {
+    void *Ptr;
+    size_t Size;
+    ur_event_handle_t Event;
+  };
+
+  bool isIdle(const StagingBuffer &Buffer) const;
+  void freeBuffer(StagingBuffer &Buffer);
+
+  context_impl &MContextImpl;
+  std::mutex MMutex;
+  std::vector<StagingBuffer> MBuffers;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
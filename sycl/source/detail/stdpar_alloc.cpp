@@ -0,0 +1,217 @@
+//==------ stdpar_alloc.cpp - Allocation functions of the SYCL stdpar ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/stdpar_alloc.hpp>
+#include <sycl/exception.hpp>
+#include <sycl/properties/queue_properties.hpp>
+#include <sycl/queue.hpp>
+#include <sycl/usm.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+namespace {
+
+// The queue owning the allocations, with the default device and context as
+// the queue of the offloaded algorithms. It is never destroyed: the program
+// can free memory from the destructors of its static objects, after the
+// runtime would have destroyed it.
+queue *getStdParQueue() {
+  static queue *Queue = []() -> queue * {
+    try {
+      return new queue{property::queue::in_order()};
+    } catch (const exception &) {
+      return nullptr;
+    }
+  }();
+  return Queue;
+}
+
+// The USM allocations start with a header, right before the memory returned
+// to the program, which records the start of the allocation and the size of
+// the memory for the reallocations.
+struct AllocHeader {
+  void *Base;
+  size_t Size;
+};
+
+constexpr size_t MinAlignment =
+    std::max(alignof(std::max_align_t), sizeof(AllocHeader));
+
+AllocHeader *getHeader(void *Ptr) {
+  return reinterpret_cast<AllocHeader *>(Ptr) - 1;
+}
+
+// Without a device, the memory is allocated by the C library, and released
+// with std::free.
+void *allocateSystem(size_t Size, size_t Alignment) noexcept {
+  if (Alignment <= alignof(std::max_align_t))
+    return std::malloc(Size);
+#ifdef _WIN32
+  // The memory of _aligned_malloc can't be released with std::free.
+  return nullptr;
+#else
+  return std::aligned_alloc(Alignment, (std::max<size_t>(Size, 1) +
+                                        Alignment - 1) /
+                                           Alignment * Alignment);
+#endif
+}
+
+void *allocate(size_t Size, size_t Alignment) noexcept {
+  queue *Queue = getStdParQueue();
+  if (!Queue)
+    return allocateSystem(Size, Alignment);
+  Alignment = std::max(Alignment, MinAlignment);
+  if (Size > std::numeric_limits<size_t>::max() - Alignment)
+    return nullptr;
+  void *Base = nullptr;
+  try {
+    Base = sycl::aligned_alloc_shared(Alignment, Size + Alignment, *Queue);
+  } catch (const exception &) {
+    return nullptr;
+  }
+  if (!Base)
+    return nullptr;
+  void *Ptr = static_cast<char *>(Base) + Alignment;
+  *getHeader(Ptr) = {Base, Size};
+  return Ptr;
+}
+
+bool isUSMAllocation(void *Ptr) {
+  queue *Queue = getStdParQueue();
+  return Queue && sycl::get_pointer_type(Ptr, Queue->get_context()) ==
+                      sycl::usm::alloc::shared;
+}
+
+void deallocate(void *Ptr) noexcept {
+  if (!Ptr)
+    return;
+  if (!isUSMAllocation(Ptr)) {
+    std::free(Ptr);
+    return;
+  }
+  try {
+    sycl::free(getHeader(Ptr)->Base, *getStdParQueue());
+  } catch (const exception &) {
+    // The memory is leaked rather than terminating the program.
+  }
+}
+
+void *reallocate(void *Ptr, size_t Size) noexcept {
+  if (!Ptr)
+    return allocate(Size, MinAlignment);
+  if (!isUSMAllocation(Ptr))
+    return std::realloc(Ptr, Size);
+  size_t OldSize = getHeader(Ptr)->Size;
+  if (Size <= OldSize) {
+    getHeader(Ptr)->Size = Size;
+    return Ptr;
+  }
+  void *NewPtr = allocate(Size, MinAlignment);
+  if (!NewPtr)
+    return nullptr;
+  std::memcpy(NewPtr, Ptr, OldSize);
+  deallocate(Ptr);
+  return NewPtr;
+}
+
+void *allocateOrThrow(size_t Size, size_t Alignment) {
+  if (void *Ptr = allocate(Size, Alignment))
+    return Ptr;
+  throw std::bad_alloc();
+}
+
+} // namespace
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
+
+using namespace sycl::detail;
+
+extern "C" {
+void *__syclstdpar_malloc(size_t Size) {
+  return allocate(Size, MinAlignment);
+}
+
+void *__syclstdpar_calloc(size_t Count, size_t Size) {
+  if (Size && Count > std::numeric_limits<size_t>::max() / Size)
+    return nullptr;
+  void *Ptr = allocate(Count * Size, MinAlignment);
+  if (Ptr)
+    std::memset(Ptr, 0, Count * Size);
+  return Ptr;
+}
+
+void *__syclstdpar_aligned_alloc(size_t Alignment, size_t Size) {
+  return allocate(Size, Alignment);
+}
+
+int __syclstdpar_posix_aligned_alloc(void **Ptr, size_t Alignment,
+                                     size_t Size) {
+  if (Alignment % sizeof(void *) || (Alignment & (Alignment - 1)))
+    return EINVAL;
+  void *Result = allocate(Size, Alignment);
+  if (!Result)
+    return ENOMEM;
+  *Ptr = Result;
+  return 0;
+}
+
+void *__syclstdpar_realloc(void *Ptr, size_t Size) {
+  return reallocate(Ptr, Size);
+}
+
+void *__syclstdpar_realloc_array(void *Ptr, size_t Count, size_t Size) {
+  if (Size && Count > std::numeric_limits<size_t>::max() / Size) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+  return reallocate(Ptr, Count * Size);
+}
+
+void __syclstdpar_free(void *Ptr) { deallocate(Ptr); }
+
+void *__syclstdpar_operator_new(size_t Size) {
+  return allocateOrThrow(Size, MinAlignment);
+}
+
+void *__syclstdpar_operator_new_nothrow(size_t Size, const std::nothrow_t &) {
+  return allocate(Size, MinAlignment);
+}
+
+void *__syclstdpar_operator_new_aligned(size_t Size, std::align_val_t Align) {
+  return allocateOrThrow(Size, static_cast<size_t>(Align));
+}
+
+void *__syclstdpar_operator_new_aligned_nothrow(size_t Size,
+                                                std::align_val_t Align,
+                                                const std::nothrow_t &) {
+  return allocate(Size, static_cast<size_t>(Align));
+}
+
+void __syclstdpar_operator_delete(void *Ptr) { deallocate(Ptr); }
+
+void __syclstdpar_operator_delete_sized(void *Ptr, size_t) {
+  deallocate(Ptr);
+}
+
+void __syclstdpar_operator_delete_aligned(void *Ptr, std::align_val_t) {
+  deallocate(Ptr);
+}
+
+void __syclstdpar_operator_delete_aligned_sized(void *Ptr, size_t,
+                                                std::align_val_t) {
+  deallocate(Ptr);
+}
+}
@@ -0,0 +1,50 @@
+//==------ stdpar_alloc.hpp - Allocation functions of the SYCL stdpar ------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/export.hpp>
+
+#include <cstddef>
+#include <new>
+
+// The allocation and deallocation functions replacing the ones of the C and
+// C++ libraries in the host code compiled with the allocation interposition of
+// the SYCL stdpar (the sycl-stdpar-interpose-alloc pass). They allocate USM
+// shared memory with the context and the device of the default queue, which
+// the parallel algorithms offloaded to the device can access. The memory that
+// isn't allocated with USM, e.g. by libraries compiled without the
+// interposition, is released with the functions of the C library.
+extern "C" {
+__SYCL_EXPORT void *__syclstdpar_malloc(size_t Size);
+__SYCL_EXPORT void *__syclstdpar_calloc(size_t Count, size_t Size);
+__SYCL_EXPORT void *__syclstdpar_aligned_alloc(size_t Alignment, size_t Size);
+__SYCL_EXPORT int __syclstdpar_posix_aligned_alloc(void **Ptr,
+                                                   size_t Alignment,
+                                                   size_t Size);
+__SYCL_EXPORT void *__syclstdpar_realloc(void *Ptr, size_t Size);
+__SYCL_EXPORT void *__syclstdpar_realloc_array(void *Ptr, size_t Count,
+                                               size_t Size);
+__SYCL_EXPORT void __syclstdpar_free(void *Ptr);
+
+__SYCL_EXPORT void *__syclstdpar_operator_new(size_t Size);
+__SYCL_EXPORT void *__syclstdpar_operator_new_nothrow(size_t Size,
+                                                      const std::nothrow_t &);
+__SYCL_EXPORT void *__syclstdpar_operator_new_aligned(size_t Size,
+                                                      std::align_val_t Align);
+__SYCL_EXPORT void *
+__syclstdpar_operator_new_aligned_nothrow(size_t Size, std::align_val_t Align,
+                                          const std::nothrow_t &);
+__SYCL_EXPORT void __syclstdpar_operator_delete(void *Ptr);
+__SYCL_EXPORT void __syclstdpar_operator_delete_sized(void *Ptr, size_t Size);
+__SYCL_EXPORT void __syclstdpar_operator_delete_aligned(void *Ptr,
+                                                        std::align_val_t Align);
+__SYCL_EXPORT void
+__syclstdpar_operator_delete_aligned_sized(void *Ptr, size_t Size,
+                                           std::align_val_t Align);
+}
@@ -7,12 +7,16 @@
 //===----------------------------------------------------------------------===//
 
 #include <detail/buffer_impl.hpp>
+#include <detail/config.hpp>
+#include <detail/global_handler.hpp>
 #include <detail/queue_impl.hpp>
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/stream_impl.hpp>
+#include <detail/stream_printer.hpp>
 #include <sycl/queue.hpp>
 
 #include <cstdio>
+#include <cstring>
 
 namespace sycl {
 inline namespace _V1 {
@@ -77,6 +81,18 @@ void stream_impl::generateFlushCommand(handler &cgh) {
   host_accessor<char, 1, access::mode::read_write> BufHostAcc(
       Buf_, cgh, range<1>(BufferSize_), id<1>(OffsetSize));
 
+  if (SYCLConfig<SYCL_ASYNC_STREAM_FLUSH>::get() != StreamFlushMode::Sync) {
+    cgh.host_task([=] {
+      // The stream buffer is zero-initialized and the output is not NUL
+      // terminated only if it fills the whole buffer.
+      const char *Data = BufHostAcc.empty() ? nullptr : &(BufHostAcc[0]);
+      size_t Size = Data ? strnlen(Data, BufHostAcc.size()) : 0;
+      if (Size)
+        GlobalHandler::instance().getStreamPrinter().print(Data, Size);
+    });
+    return;
+  }
+
   cgh.host_task([=] {
     if (!BufHostAcc.empty()) {
       // SYCL 2020, 4.16:
@@ -0,0 +1,95 @@
+//==---- stream_printer.cpp - Background printing of sycl::stream output ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/stream_printer.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+StreamPrinter::StreamPrinter(bool Lossy)
+    : MLossy(Lossy), MRing(Capacity), MThread([this] { worker(); }) {}
+
+StreamPrinter::~StreamPrinter() { finishAndWait(); }
+
+void StreamPrinter::print(const char *Data, size_t Size) {
+  std::unique_lock<std::mutex> Lock(MMutex);
+  if (MStop) {
+    // The background thread is gone, print directly.
+    Lock.unlock();
+    fwrite(Data, 1, Size, stdout);
+    fflush(stdout);
+    return;
+  }
+
+  while (Size > 0) {
+    if (MSize == Capacity) {
+      if (MLossy) {
+        MDropped += Size;
+        break;
+      }
+      MSpaceReady.wait(Lock, [this] { return MSize < Capacity; });
+    }
+    // Copy as much as fits contiguously after the pending output.
+    size_t Tail = (MHead + MSize) % Capacity;
+    size_t Count = std::min({Size, Capacity - MSize, Capacity - Tail});
+    std::memcpy(MRing.data() + Tail, Data, Count);
+    MSize += Count;
+    Data += Count;
+    Size -= Count;
+    MDataReady.notify_one();
+  }
+  if (MDropped)
+    MDataReady.notify_one();
+}
+
+void StreamPrinter::finishAndWait() {
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    MStop = true;
+  }
+  MDataReady.notify_one();
+  if (MThread.joinable())
+    MThread.join();
+}
+
+void StreamPrinter::worker() {
+  std::unique_lock<std::mutex> Lock(MMutex);
+  while (true) {
+    MDataReady.wait(Lock, [this] { return MSize || MDropped || MStop; });
+    if (!MSize && !MDropped)
+      break;
+
+    // The region being printed is not touched by the writers until it is
+    // released below, so it is printed without holding the lock.
+    size_t Begin = MHead;
+    size_t Count = std::min(MSize, Capacity - MHead);
+    size_t Dropped = MDropped;
+    MDropped = 0;
+    Lock.unlock();
+
+    fwrite(MRing.data() + Begin, 1, Count, stdout);
+    fflush(stdout);
+    if (Dropped)
+      fprintf(stderr, "WARNING: %zu bytes of sycl::stream output dropped\n",
+              Dropped);
+
+    Lock.lock();
+    MHead = (MHead + Count) % Capacity;
+    MSize -= Count;
+    MSpaceReady.notify_all();
+  }
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
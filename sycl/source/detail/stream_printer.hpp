@@ -0,0 +1,62 @@
+//==---- stream_printer.hpp - Background printing of sycl::stream output ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+/// Prints the output of sycl::stream objects to stdout from a background
+/// thread, so that the host tasks flushing the streams don't wait for the
+/// I/O. The output waiting to be printed is kept in a ring buffer.
+class StreamPrinter {
+public:
+  /// @param Lossy If true, output which doesn't fit into the ring buffer is
+  /// dropped instead of waiting for the background thread to print it.
+  StreamPrinter(bool Lossy);
+  ~StreamPrinter();
+
+  StreamPrinter(const StreamPrinter &) = delete;
+  StreamPrinter &operator=(const StreamPrinter &) = delete;
+
+  /// Queues Size bytes of Data for printing.
+  void print(const char *Data, size_t Size);
+
+  /// Prints the pending output and stops the background thread.
+  void finishAndWait();
+
+private:
+  static constexpr size_t Capacity = 16 * 1024 * 1024;
+
+  void worker();
+
+  const bool MLossy;
+  std::vector<char> MRing;
+  // Position of the first pending byte and number of pending bytes.
+  size_t MHead = 0;
+  size_t MSize = 0;
+  // Number of bytes dropped since the last notice about it.
+  size_t MDropped = 0;
+  bool MStop = false;
+
+  std::mutex MMutex;
+  std::condition_variable MDataReady;
+  std::condition_variable MSpaceReady;
+  std::thread MThread;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
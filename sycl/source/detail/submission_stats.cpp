@@ -0,0 +1,120 @@
+//==---- submission_stats.cpp - Latency breakdown of the submissions -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/submission_stats.hpp>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+std::atomic<bool> SubmissionStats::MEnabled{
+    SYCLConfig<SYCL_SUBMISSION_STATS>::get()};
+
+SubmissionStats &SubmissionStats::instance() {
+  // Never destroyed, the submissions made by the destructors of other static
+  // objects may still record their phases.
+  static SubmissionStats *Stats = new SubmissionStats();
+  return *Stats;
+}
+
+static size_t getHistogramBucket(uint64_t Nanoseconds) {
+  size_t Bucket = 0;
+  while (Nanoseconds >>= 1)
+    ++Bucket;
+  return std::min(Bucket, submission_phase_stats::histogram_size - 1);
+}
+
+void SubmissionStats::record(submission_phase Phase, uint64_t Nanoseconds) {
+  PhaseCounters &Counters = MPhases[static_cast<int>(Phase)];
+  Counters.Count.fetch_add(1, std::memory_order_relaxed);
+  Counters.TotalNs.fetch_add(Nanoseconds, std::memory_order_relaxed);
+  Counters.Histogram[getHistogramBucket(Nanoseconds)].fetch_add(
+      1, std::memory_order_relaxed);
+  uint64_t Max = Counters.MaxNs.load(std::memory_order_relaxed);
+  while (Max < Nanoseconds &&
+         !Counters.MaxNs.compare_exchange_weak(Max, Nanoseconds,
+                                               std::memory_order_relaxed))
+    ;
+}
+
+submission_phase_stats SubmissionStats::get(submission_phase Phase) const {
+  const PhaseCounters &Counters = MPhases[static_cast<int>(Phase)];
+  submission_phase_stats Stats;
+  Stats.count = Counters.Count.load(std::memory_order_relaxed);
+  Stats.total_ns = Counters.TotalNs.load(std::memory_order_relaxed);
+  Stats.max_ns = Counters.MaxNs.load(std::memory_order_relaxed);
+  for (size_t I = 0; I < submission_phase_stats::histogram_size; ++I)
+    Stats.histogram[I] = Counters.Histogram[I].load(std::memory_order_relaxed);
+  return Stats;
+}
+
+void SubmissionStats::reset() {
+  for (PhaseCounters &Counters : MPhases) {
+    Counters.Count.store(0, std::memory_order_relaxed);
+    Counters.TotalNs.store(0, std::memory_order_relaxed);
+    Counters.MaxNs.store(0, std::memory_order_relaxed);
+    for (std::atomic<uint64_t> &Bucket : Counters.Histogram)
+      Bucket.store(0, std::memory_order_relaxed);
+  }
+}
+
+static const char *getPhaseName(submission_phase Phase) {
+  switch (Phase) {
+  case submission_phase::handler_finalize:
+    return "handler_finalize";
+  case submission_phase::scheduler_add_cg:
+    return "scheduler_add_cg";
+  case submission_phase::graph_build:
+    return "graph_build";
+  case submission_phase::enqueue_command:
+    return "enqueue_command";
+  case submission_phase::kernel_lookup:
+    return "kernel_lookup";
+  case submission_phase::set_arguments:
+    return "set_arguments";
+  }
+  return "unknown";
+}
+
+void SubmissionStats::print() const {
+  std::fprintf(stderr, "SYCL submission statistics (ns):\n");
+  for (int I = 0; I < NumPhases; ++I) {
+    auto Phase = static_cast<submission_phase>(I);
+    submission_phase_stats Stats = get(Phase);
+    if (!Stats.count)
+      continue;
+    std::fprintf(stderr,
+                 "  %-16s count %" PRIu64 " total %" PRIu64 " mean %" PRIu64
+                 " max %" PRIu64 "\n",
+                 getPhaseName(Phase), Stats.count, Stats.total_ns,
+                 Stats.total_ns / Stats.count, Stats.max_ns);
+    for (size_t B = 0; B < submission_phase_stats::histogram_size; ++B)
+      if (Stats.histogram[B])
+        std::fprintf(stderr, "    [2^%zu, 2^%zu) %" PRIu64 "\n", B, B + 1,
+                     Stats.histogram[B]);
+  }
+}
+
+namespace {
+// Prints the statistics at exit if they were requested by the environment.
+struct SubmissionStatsPrinter {
+  ~SubmissionStatsPrinter() {
+    if (SYCLConfig<SYCL_SUBMISSION_STATS>::get())
+      SubmissionStats::instance().print();
+  }
+} GSubmissionStatsPrinter;
+} // namespace
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
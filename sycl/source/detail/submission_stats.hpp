@@ -0,0 +1,90 @@
+//==---- submission_stats.hpp - Latency breakdown of the submissions -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/ext/oneapi/experimental/submission_stats.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+using ext::oneapi::experimental::submission_phase;
+using ext::oneapi::experimental::submission_phase_stats;
+
+/// Counters of the time spent in each phase of the submissions, updated
+/// concurrently by the submitting threads.
+class SubmissionStats {
+public:
+  static constexpr int NumPhases =
+      static_cast<int>(submission_phase::set_arguments) + 1;
+
+  static SubmissionStats &instance();
+
+  static bool isEnabled() {
+    return MEnabled.load(std::memory_order_relaxed);
+  }
+  static void setEnabled(bool Enabled) {
+    MEnabled.store(Enabled, std::memory_order_relaxed);
+  }
+
+  void record(submission_phase Phase, uint64_t Nanoseconds);
+  submission_phase_stats get(submission_phase Phase) const;
+  void reset();
+
+  /// Prints the statistics of the phases which ran at least once to stderr.
+  void print() const;
+
+private:
+  // The counters of each phase are on their own cache line so that threads
+  // in different phases don't contend.
+  struct alignas(64) PhaseCounters {
+    std::atomic<uint64_t> Count{0};
+    std::atomic<uint64_t> TotalNs{0};
+    std::atomic<uint64_t> MaxNs{0};
+    std::atomic<uint64_t> Histogram[submission_phase_stats::histogram_size]{};
+  };
+
+  static std::atomic<bool> MEnabled;
+  PhaseCounters MPhases[NumPhases];
+};
+
+/// Records the time between its construction and its destruction as a run of
+/// Phase if the statistics are enabled.
+class SubmissionPhaseTimer {
+public:
+  SubmissionPhaseTimer(submission_phase Phase)
+      : MPhase(Phase), MEnabled(SubmissionStats::isEnabled()) {
+    if (MEnabled)
+      MStart = std::chrono::steady_clock::now();
+  }
+  ~SubmissionPhaseTimer() {
+    if (!MEnabled)
+      return;
+    auto Duration = std::chrono::steady_clock::now() - MStart;
+    SubmissionStats::instance().record(
+        MPhase,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Duration).count());
+  }
+
+  SubmissionPhaseTimer(const SubmissionPhaseTimer &) = delete;
+  SubmissionPhaseTimer &operator=(const SubmissionPhaseTimer &) = delete;
+
+private:
+  submission_phase MPhase;
+  bool MEnabled;
+  std::chrono::steady_clock::time_point MStart;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -13,6 +13,9 @@
 #include <detail/scheduler/scheduler.hpp>
 #include <detail/sycl_mem_obj_t.hpp>
 
+#include <cstdint>
+#include <iostream>
+
 namespace sycl {
 inline namespace _V1 {
 namespace detail {
@@ -134,7 +137,8 @@ void SYCLMemObjT::updateHostMemory(void *const Ptr) {
                   Dims, ElemSize, size_t(0));
   Req.MData = Ptr;
 
-  EventImplPtr Event = Scheduler::getInstance().addCopyBack(&Req);
+  EventImplPtr Event = Scheduler::getInstance().addCopyBack(
+      &Req, /*OnlyModified=*/Ptr && Ptr == MInitialHostPtr);
   if (Event)
     Event->wait(Event);
 }
@@ -202,6 +206,28 @@ void SYCLMemObjT::determineHostPtr(const ContextImplPtr &Context,
     HostPtrReadOnly = false;
 }
 
+// Alignment the backends need to use host memory in place, the page size on
+// all the supported platforms.
+static constexpr size_t ZeroCopyAlignment = 4096;
+
+void SYCLMemObjT::checkZeroCopyHostPtr(const void *HostPtr) const {
+  if (!requestsZeroCopy())
+    return;
+  if (reinterpret_cast<std::uintptr_t>(HostPtr) % ZeroCopyAlignment != 0)
+    reportZeroCopyDeclined("the host pointer is not aligned to 4096 bytes");
+  if (MHostPtrReadOnly)
+    reportZeroCopyDeclined("the host pointer is read-only, it is copied when "
+                           "the memory object is written");
+}
+
+void SYCLMemObjT::reportZeroCopyDeclined(const char *Reason) const {
+  // The user asked for zero-copy explicitly, so this is reported regardless
+  // of SYCL_RT_WARNING_LEVEL.
+  std::cerr << "WARNING: host memory of a buffer with the zero_copy property "
+               "is copied: "
+            << Reason << "\n";
+}
+
 void SYCLMemObjT::detachMemoryObject(
     const std::shared_ptr<SYCLMemObjT> &Self) const {
   // Check MRecord without read lock because at this point we expect that no
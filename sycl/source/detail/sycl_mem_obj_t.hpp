@@ -172,9 +172,19 @@ protected:
 public:
   bool useHostPtr() {
     return has_property<property::buffer::use_host_ptr>() ||
-           has_property<property::image::use_host_ptr>();
+           has_property<property::image::use_host_ptr>() || requestsZeroCopy();
   }
 
+  /// Returns true if the memory object must use the host memory it was
+  /// created with in place on devices with host unified memory.
+  bool requestsZeroCopy() const {
+    return has_property<sycl::ext::oneapi::property::buffer::zero_copy>();
+  }
+
+  /// Reports that the host memory of a memory object requesting zero-copy is
+  /// copied anyway, Reason explains why.
+  void reportZeroCopyDeclined(const char *Reason) const;
+
   bool canReadHostPtr(void *HostPtr, const size_t RequiredAlign) {
     bool Aligned =
         (reinterpret_cast<std::uintptr_t>(HostPtr) % RequiredAlign) == 0;
@@ -191,9 +201,11 @@ public:
       set_final_data([HostPtr](const std::function<void(void *const Ptr)> &F) {
         F(HostPtr);
       });
+      MInitialHostPtr = HostPtr;
     }
 
     if (HostPtr) {
+      checkZeroCopyHostPtr(HostPtr);
       if (canReuseHostPtr(HostPtr, RequiredAlign)) {
         MUserPtr = HostPtr;
       } else if (canReadHostPtr(HostPtr, RequiredAlign)) {
@@ -225,8 +237,11 @@ public:
     MSharedPtrStorage = HostPtr;
     MHostPtrReadOnly = IsConstPtr;
     if (HostPtr) {
-      if (!MHostPtrReadOnly)
+      if (!MHostPtrReadOnly) {
         set_final_data_from_storage();
+        MInitialHostPtr = HostPtr.get();
+      }
+      checkZeroCopyHostPtr(HostPtr.get());
 
       if (canReuseHostPtr(HostPtr.get(), RequiredAlign)) {
         MUserPtr = HostPtr.get();
@@ -252,6 +267,10 @@ public:
                       const size_t RequiredAlign, bool IsConstPtr) {
     MHostPtrReadOnly = IsConstPtr;
     setAlign(RequiredAlign);
+    if (requestsZeroCopy())
+      throw exception(make_error_code(errc::invalid),
+                      "Buffer constructor from a pair of iterator values does "
+                      "not support zero_copy property.");
     if (useHostPtr())
       throw exception(make_error_code(errc::invalid),
                       "Buffer constructor from a pair of iterator values does "
@@ -264,6 +283,10 @@ public:
     CopyFromInput(MUserPtr);
   }
 
+  // Reports the properties of the host pointer which prevent using it in place
+  // if the memory object requests zero-copy.
+  void checkZeroCopyHostPtr(const void *HostPtr) const;
+
   void setAlign(size_t RequiredAlign) {
     MAllocator->setAlignment(RequiredAlign);
   }
@@ -359,6 +382,10 @@ protected:
   void *MUserPtr;
   // Copy of memory passed by user to constructor.
   void *MShadowCopy;
+  // Writable host memory the object was initialized from. It keeps the
+  // initial content until the write back, which then only needs to copy the
+  // modified bytes.
+  void *MInitialHostPtr = nullptr;
   // Function which update host with final data on memory object destruction.
   std::function<void(void)> MUploadDataFunctor;
   // Field which holds user's shared_ptr in case of memory object is created
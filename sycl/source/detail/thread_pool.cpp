@@ -0,0 +1,97 @@
+//===-- thread_pool.cpp - Simple thread pool --------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/thread_pool.hpp>
+#include <sycl/detail/os_util.hpp>
+
+#if defined(__SYCL_RT_OS_LINUX)
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <string>
+#endif
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+#if defined(__SYCL_RT_OS_LINUX)
+// Parses a list of the sysfs format, e.g. "0-3,8,10-11".
+static std::vector<unsigned> parseSysfsList(const std::string &List) {
+  std::vector<unsigned> Values;
+  size_t Pos = 0;
+  while (Pos < List.size()) {
+    size_t End = List.find(',', Pos);
+    if (End == std::string::npos)
+      End = List.size();
+    std::string Range = List.substr(Pos, End - Pos);
+    Pos = End + 1;
+    try {
+      size_t Dash = Range.find('-');
+      unsigned First = std::stoul(Range.substr(0, Dash));
+      unsigned Last =
+          Dash == std::string::npos ? First : std::stoul(Range.substr(Dash + 1));
+      for (unsigned Value = First; Value <= Last; ++Value)
+        Values.push_back(Value);
+    } catch (...) {
+      return {};
+    }
+  }
+  return Values;
+}
+
+static std::string readSysfsLine(const std::string &Path) {
+  std::ifstream File(Path);
+  std::string Line;
+  std::getline(File, Line);
+  return Line;
+}
+#endif
+
+std::vector<std::vector<unsigned>> getNUMANodeCPUs() {
+  std::vector<std::vector<unsigned>> Nodes;
+#if defined(__SYCL_RT_OS_LINUX)
+  cpu_set_t Allowed;
+  CPU_ZERO(&Allowed);
+  if (sched_getaffinity(0, sizeof(Allowed), &Allowed) != 0)
+    return {};
+
+  for (unsigned Node : parseSysfsList(
+           readSysfsLine("/sys/devices/system/node/online"))) {
+    std::vector<unsigned> CPUs;
+    for (unsigned CPU : parseSysfsList(readSysfsLine(
+             "/sys/devices/system/node/node" + std::to_string(Node) +
+             "/cpulist")))
+      if (CPU < CPU_SETSIZE && CPU_ISSET(CPU, &Allowed))
+        CPUs.push_back(CPU);
+    if (!CPUs.empty())
+      Nodes.push_back(std::move(CPUs));
+  }
+#endif
+  return Nodes;
+}
+
+void bindCurrentThreadToCPUs(const std::vector<unsigned> &CPUs) {
+#if defined(__SYCL_RT_OS_LINUX)
+  cpu_set_t Set;
+  CPU_ZERO(&Set);
+  for (unsigned CPU : CPUs)
+    CPU_SET(CPU, &Set);
+  // Failing to bind only loses the locality of the worker.
+  (void)pthread_setaffinity_np(pthread_self(), sizeof(Set), &Set);
+#else
+  (void)CPUs;
+#endif
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -11,9 +11,14 @@
 #include <algorithm>
 #include <atomic>
 #include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <queue>
 #include <thread>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include <sycl/detail/defines.hpp>
@@ -22,54 +27,259 @@ namespace sycl {
 inline namespace _V1 {
 namespace detail {
 
+/// Move-only type-erased job. Callables fitting into the inline storage (e.g.
+/// host task dispatchers) are stored without a heap allocation.
+class ThreadPoolJob {
+  static constexpr size_t InlineSize = 64;
+
+  struct Ops {
+    void (*Invoke)(void *Storage);
+    // Moves the callable from one storage to another and destroys the source.
+    void (*Relocate)(void *From, void *To);
+    void (*Destroy)(void *Storage);
+  };
+
+  template <typename FuncT>
+  static constexpr bool IsInline =
+      sizeof(FuncT) <= InlineSize &&
+      alignof(FuncT) <= alignof(std::max_align_t) &&
+      std::is_nothrow_move_constructible_v<FuncT>;
+
+  template <typename FuncT> static const Ops *getOps() {
+    if constexpr (IsInline<FuncT>) {
+      static constexpr Ops InlineOps{
+          [](void *Storage) { (*static_cast<FuncT *>(Storage))(); },
+          [](void *From, void *To) {
+            FuncT *Src = static_cast<FuncT *>(From);
+            new (To) FuncT(std::move(*Src));
+            Src->~FuncT();
+          },
+          [](void *Storage) { static_cast<FuncT *>(Storage)->~FuncT(); }};
+      return &InlineOps;
+    } else {
+      static constexpr Ops HeapOps{
+          [](void *Storage) { (**static_cast<FuncT **>(Storage))(); },
+          [](void *From, void *To) {
+            *static_cast<FuncT **>(To) = *static_cast<FuncT **>(From);
+          },
+          [](void *Storage) { delete *static_cast<FuncT **>(Storage); }};
+      return &HeapOps;
+    }
+  }
+
+  alignas(std::max_align_t) unsigned char MStorage[InlineSize];
+  const Ops *MOps = nullptr;
+
+public:
+  ThreadPoolJob() = default;
+
+  template <typename T, typename FuncT = std::decay_t<T>,
+            typename = std::enable_if_t<
+                !std::is_same_v<FuncT, ThreadPoolJob>>>
+  ThreadPoolJob(T &&Func) : MOps(getOps<FuncT>()) {
+    if constexpr (IsInline<FuncT>)
+      new (MStorage) FuncT(std::forward<T>(Func));
+    else
+      *reinterpret_cast<FuncT **>(MStorage) = new FuncT(std::forward<T>(Func));
+  }
+
+  ThreadPoolJob(ThreadPoolJob &&Other) noexcept : MOps(Other.MOps) {
+    if (MOps)
+      MOps->Relocate(Other.MStorage, MStorage);
+    Other.MOps = nullptr;
+  }
+
+  ThreadPoolJob &operator=(ThreadPoolJob &&Other) noexcept {
+    if (this != &Other) {
+      if (MOps)
+        MOps->Destroy(MStorage);
+      MOps = Other.MOps;
+      if (MOps)
+        MOps->Relocate(Other.MStorage, MStorage);
+      Other.MOps = nullptr;
+    }
+    return *this;
+  }
+
+  ThreadPoolJob(const ThreadPoolJob &) = delete;
+  ThreadPoolJob &operator=(const ThreadPoolJob &) = delete;
+
+  ~ThreadPoolJob() {
+    if (MOps)
+      MOps->Destroy(MStorage);
+  }
+
+  void operator()() { MOps->Invoke(MStorage); }
+};
+
+/// @return The CPUs the process may run on of each NUMA node, without the
+/// nodes having none. Empty when the topology is unknown.
+std::vector<std::vector<unsigned>> getNUMANodeCPUs();
+
+/// Restricts the current thread to run on CPUs.
+void bindCurrentThreadToCPUs(const std::vector<unsigned> &CPUs);
+
+/// Thread pool with a job queue per worker. Jobs submitted from a worker go
+/// to its own queue, other submissions are distributed round-robin. Workers
+/// take jobs from the front of their own queue and steal from the back of the
+/// other queues when it is empty.
+///
+/// On machines with several NUMA nodes, the workers are spread over the nodes
+/// and bound to their CPUs, and steal from the workers of their own node
+/// before the others, so that a job tends to run near the memory it uses.
 class ThreadPool {
+  struct WorkerQueue {
+    std::mutex Mutex;
+    std::deque<ThreadPoolJob> Jobs;
+  };
+
   std::vector<std::thread> MLaunchedThreads;
 
   size_t MThreadCount;
-  std::queue<std::function<void()>> MJobQueue;
-  std::mutex MJobQueueMutex;
+  std::unique_ptr<WorkerQueue[]> MQueues;
+  // The order in which each worker visits the queues: its own, then those of
+  // the workers on its NUMA node, then the others.
+  std::vector<std::vector<size_t>> MVisitOrder;
+  // The CPUs each worker is bound to, none when not bound.
+  std::vector<std::vector<unsigned>> MWorkerCPUs;
+  std::atomic_size_t MNextQueue{0};
+
+  // Number of jobs queued and not yet taken by a worker.
+  std::atomic_size_t MQueuedJobs{0};
+  // Number of workers which are about to sleep or sleeping.
+  std::atomic_size_t MSleepingWorkers{0};
+  std::mutex MSleepMutex;
   std::condition_variable MDoSmthOrStop;
-  bool MStop = false;
-  std::atomic_uint MJobsInPool;
+  std::atomic_bool MStop{false};
+
+  // Number of jobs submitted and not yet finished.
+  std::atomic_uint MJobsInPool{0};
+  std::mutex MDrainMutex;
+  std::condition_variable MDrained;
+
+  // Pool and queue index of the worker running on the current thread.
+  struct CurrentWorker {
+    const ThreadPool *Pool = nullptr;
+    size_t Idx = 0;
+  };
+  static CurrentWorker &getCurrentWorker() {
+    static thread_local CurrentWorker Worker;
+    return Worker;
+  }
+
+  bool tryPop(size_t Idx, ThreadPoolJob &Job) {
+    for (size_t Victim : MVisitOrder[Idx]) {
+      WorkerQueue &Queue = MQueues[Victim];
+      std::lock_guard<std::mutex> Lock(Queue.Mutex);
+      if (Queue.Jobs.empty())
+        continue;
+      if (Victim == Idx) {
+        Job = std::move(Queue.Jobs.front());
+        Queue.Jobs.pop_front();
+      } else {
+        Job = std::move(Queue.Jobs.back());
+        Queue.Jobs.pop_back();
+      }
+      MQueuedJobs--;
+      return true;
+    }
+    return false;
+  }
 
-  void worker() {
+  void worker(size_t Idx) {
     GlobalHandler::instance().registerSchedulerUsage(/*ModifyCounter*/ false);
-    std::unique_lock<std::mutex> Lock(MJobQueueMutex);
+    getCurrentWorker() = {this, Idx};
+    if (!MWorkerCPUs[Idx].empty())
+      bindCurrentThreadToCPUs(MWorkerCPUs[Idx]);
+    ThreadPoolJob Job;
     while (true) {
-      MDoSmthOrStop.wait(Lock,
-                         [this]() { return !MJobQueue.empty() || MStop; });
-
       if (MStop)
         break;
 
-      std::function<void()> Job = std::move(MJobQueue.front());
-      MJobQueue.pop();
-      Lock.unlock();
+      if (!tryPop(Idx, Job)) {
+        std::unique_lock<std::mutex> Lock(MSleepMutex);
+        MSleepingWorkers++;
+        MDoSmthOrStop.wait(Lock,
+                           [this]() { return MQueuedJobs != 0 || MStop; });
+        MSleepingWorkers--;
+        continue;
+      }
 
       Job();
+      // Release the resources captured by the job before reporting it done.
+      Job = ThreadPoolJob{};
 
-      Lock.lock();
-
-      MJobsInPool--;
+      if (--MJobsInPool == 0) {
+        std::lock_guard<std::mutex> Lock(MDrainMutex);
+        MDrained.notify_all();
+      }
     }
+    getCurrentWorker() = {};
   }
 
   void start() {
+    MQueues = std::make_unique<WorkerQueue[]>(MThreadCount);
     MLaunchedThreads.reserve(MThreadCount);
 
+    // The workers are assigned to the nodes round-robin. With a single node
+    // they are left unbound, as before.
+    std::vector<std::vector<unsigned>> Nodes;
+    if (MThreadCount > 1)
+      Nodes = getNUMANodeCPUs();
+    const size_t NumNodes = Nodes.size() > 1 ? Nodes.size() : 1;
+    MWorkerCPUs.assign(MThreadCount, {});
+    MVisitOrder.assign(MThreadCount, {});
+    for (size_t Idx = 0; Idx < MThreadCount; ++Idx) {
+      if (NumNodes > 1)
+        MWorkerCPUs[Idx] = Nodes[Idx % NumNodes];
+      std::vector<size_t> &Order = MVisitOrder[Idx];
+      Order.reserve(MThreadCount);
+      for (size_t I = 0; I < MThreadCount; ++I)
+        if ((Idx + I) % MThreadCount % NumNodes == Idx % NumNodes)
+          Order.push_back((Idx + I) % MThreadCount);
+      for (size_t I = 0; I < MThreadCount; ++I)
+        if ((Idx + I) % MThreadCount % NumNodes != Idx % NumNodes)
+          Order.push_back((Idx + I) % MThreadCount);
+    }
+
     MJobsInPool.store(0);
 
     for (size_t Idx = 0; Idx < MThreadCount; ++Idx)
-      MLaunchedThreads.emplace_back([this] { worker(); });
+      MLaunchedThreads.emplace_back([this, Idx] { worker(Idx); });
+  }
+
+  void push(ThreadPoolJob &&Job, bool Reserved = false) {
+    const CurrentWorker &Worker = getCurrentWorker();
+    WorkerQueue *Queue = Worker.Pool == this
+                             ? &MQueues[Worker.Idx]
+                             : &MQueues[MNextQueue++ % MThreadCount];
+
+    // Count the job before it becomes visible so that the counters never
+    // underflow when a worker takes it right away.
+    if (!Reserved)
+      MJobsInPool++;
+    MQueuedJobs++;
+    {
+      std::lock_guard<std::mutex> Lock(Queue->Mutex);
+      Queue->Jobs.push_back(std::move(Job));
+    }
+    // Sleeping workers check MQueuedJobs under MSleepMutex after announcing
+    // themselves, so either they see the new job or it sees them.
+    if (MSleepingWorkers != 0) {
+      std::lock_guard<std::mutex> Lock(MSleepMutex);
+      MDoSmthOrStop.notify_one();
+    }
   }
 
 public:
+  /// Blocks until all submitted jobs are finished.
   void drain() {
-    while (MJobsInPool != 0)
-      std::this_thread::yield();
+    std::unique_lock<std::mutex> Lock(MDrainMutex);
+    MDrained.wait(Lock, [this]() { return MJobsInPool == 0; });
   }
 
-  ThreadPool(unsigned int ThreadCount = 1) : MThreadCount(ThreadCount) {
+  ThreadPool(unsigned int ThreadCount = 1)
+      : MThreadCount(std::max(ThreadCount, 1u)) {
     start();
   }
 
@@ -83,7 +293,7 @@ public:
 
   void finishAndWait() {
     {
-      std::lock_guard<std::mutex> Lock(MJobQueueMutex);
+      std::lock_guard<std::mutex> Lock(MSleepMutex);
       MStop = true;
     }
 
@@ -95,21 +305,20 @@ public:
   }
 
   template <typename T> void submit(T &&Func) {
-    {
-      std::lock_guard<std::mutex> Lock(MJobQueueMutex);
-      MJobQueue.emplace([F = std::move(Func)]() { F(); });
-    }
-    MJobsInPool++;
-    MDoSmthOrStop.notify_one();
+    push(ThreadPoolJob{std::forward<T>(Func)});
   }
 
   void submit(std::function<void()> &&Func) {
-    {
-      std::lock_guard<std::mutex> Lock(MJobQueueMutex);
-      MJobQueue.emplace(Func);
-    }
-    MJobsInPool++;
-    MDoSmthOrStop.notify_one();
+    push(ThreadPoolJob{std::move(Func)});
+  }
+
+  /// Counts a job which will be submitted later with submitReserved, e.g.
+  /// from a completion callback, so that drain() waits for it meanwhile.
+  void reserve() { MJobsInPool++; }
+
+  /// Submits a job counted by a previous call to reserve().
+  template <typename T> void submitReserved(T &&Func) {
+    push(ThreadPoolJob{std::forward<T>(Func)}, /*Reserved*/ true);
   }
 };
 
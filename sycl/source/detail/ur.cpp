@@ -230,7 +230,9 @@ static void initializeAdapters(std::vector<AdapterPtr> &Adapters,
 #ifdef XPTI_ENABLE_INSTRUMENTATION
   GlobalHandler::instance().getXPTIRegistry().initializeFrameworkOnce();
 
-  if (!(xptiTraceEnabled() && !XPTIInitDone))
+  // The stream is initialized even if tracing is disabled, so that the
+  // subscribers attached later by xptiAttachSubscriber() are told about it.
+  if (XPTIInitDone)
     return;
   // Not sure this is the best place to initialize the framework; SYCL runtime
   // team needs to advise on the right place, until then we piggy-back on the
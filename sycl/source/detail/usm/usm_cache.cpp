@@ -0,0 +1,120 @@
+//==------------ usm_cache.cpp - Caching of small USM allocations ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/adapter.hpp>
+#include <detail/config.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/memory_telemetry.hpp>
+#include <detail/usm/usm_cache.hpp>
+
+#include <iostream>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+namespace usm {
+
+size_t USMCache::getThreshold() {
+  return SYCLConfig<SYCL_USM_CACHE_THRESHOLD>::get();
+}
+
+int USMCache::findBucket(size_t Size) {
+  int Bucket = 0;
+  while (Bucket + 1 < NumBuckets && BucketSize[Bucket + 1] <= Size)
+    ++Bucket;
+  return Bucket;
+}
+
+void *USMCache::take(const device_impl *Dev, sycl::usm::alloc Kind,
+                     size_t Size) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto ListIt = MFreeLists.find({Dev, Kind, findBucket(Size)});
+  if (ListIt != MFreeLists.end()) {
+    // The smallest free allocation large enough, which is less than twice as
+    // large as requested except in the last class.
+    auto It = ListIt->second.lower_bound(Size);
+    if (It != ListIt->second.end()) {
+      void *Ptr = It->second;
+      ListIt->second.erase(It);
+      ++MHits;
+      MBytesReused += Size;
+      return Ptr;
+    }
+  }
+  ++MMisses;
+  return nullptr;
+}
+
+void USMCache::track(const device_impl *Dev, sycl::usm::alloc Kind,
+                     size_t Size, void *Ptr) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MNodes.emplace(Ptr, Node{Dev, Kind, Size});
+}
+
+bool USMCache::recycle(void *Ptr) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  auto It = MNodes.find(Ptr);
+  if (It == MNodes.end())
+    return false;
+  const Node &N = It->second;
+  MFreeLists[{N.Dev, N.Kind, findBucket(N.Size)}].emplace(N.Size, Ptr);
+  return true;
+}
+
+bool USMCache::releaseFree() {
+  std::unordered_map<void *, Node> Freed;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    for (auto &[Key, List] : MFreeLists) {
+      for (auto &[Size, Ptr] : List) {
+        auto It = MNodes.find(Ptr);
+        Freed.insert(*It);
+        MNodes.erase(It);
+      }
+    }
+    MFreeLists.clear();
+    if (Freed.empty())
+      return false;
+    ++MOutOfMemoryReleases;
+  }
+  freeAll(Freed);
+  return true;
+}
+
+void USMCache::release() {
+  std::unordered_map<void *, Node> Nodes;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    Nodes.swap(MNodes);
+    MFreeLists.clear();
+  }
+  // The allocations still in use are freed as well, the context owning them
+  // being released.
+  freeAll(Nodes);
+  if (MemoryTelemetry::isEnabled() && (MHits || MMisses))
+    printStats();
+}
+
+void USMCache::freeAll(const std::unordered_map<void *, Node> &Nodes) {
+  const AdapterPtr &Adapter = MContextImpl.getAdapter();
+  for (const auto &Entry : Nodes)
+    Adapter->call_nocheck<UrApiKind::urUSMFree>(MContextImpl.getHandleRef(),
+                                                Entry.first);
+}
+
+void USMCache::printStats() const {
+  std::cerr << "USM cache of context " << &MContextImpl << ": " << MHits
+            << " hits, " << MMisses << " misses, " << MBytesReused
+            << " bytes reused, " << MOutOfMemoryReleases
+            << " releases on out of memory\n";
+}
+
+} // namespace usm
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
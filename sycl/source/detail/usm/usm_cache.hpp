@@ -0,0 +1,107 @@
+//==------------ usm_cache.hpp - Caching of small USM allocations ----------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/usm/usm_enums.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class context_impl;
+class device_impl;
+
+namespace usm {
+
+/// Cache of the small device and shared USM allocations of a context, with
+/// the size classes of the memory manager of the offload plugins: an
+/// allocation freed by the application is kept in the free list of its
+/// device, kind and power of two size class, and a later allocation of the
+/// same class is served from it instead of the backend. When the backend is
+/// out of memory, the free lists are emptied and the allocation retried.
+///
+/// Opt-in with SYCL_USM_CACHE_THRESHOLD, the size in bytes of the largest
+/// allocation cached. With SYCL_MEMORY_TELEMETRY=1, the hits and misses of
+/// the cache are printed to stderr when the context is released.
+class USMCache {
+public:
+  USMCache(context_impl &ContextImpl) : MContextImpl(ContextImpl) {}
+  USMCache(const USMCache &) = delete;
+  USMCache &operator=(const USMCache &) = delete;
+
+  /// @return The size of the largest allocation cached, 0 when the cache is
+  /// disabled.
+  static size_t getThreshold();
+
+  /// Takes an allocation of at least Size bytes out of the free lists.
+  /// @return The allocation, nullptr if none is free.
+  void *take(const device_impl *Dev, sycl::usm::alloc Kind, size_t Size);
+
+  /// Starts managing Ptr, a new allocation of Size bytes, so that freeing it
+  /// gives it back to the cache.
+  void track(const device_impl *Dev, sycl::usm::alloc Kind, size_t Size,
+             void *Ptr);
+
+  /// Gives Ptr back to the cache.
+  /// @return false if the cache doesn't manage Ptr, which must then be freed.
+  bool recycle(void *Ptr);
+
+  /// Frees the allocations of the free lists.
+  /// @return true if any allocation was freed.
+  bool releaseFree();
+
+  /// Frees all the allocations managed by the cache. Must be called while the
+  /// context handle is still valid.
+  void release();
+
+private:
+  static constexpr size_t BucketSize[] = {
+      0,       1U << 2, 1U << 3,  1U << 4,  1U << 5,  1U << 6, 1U << 7,
+      1U << 8, 1U << 9, 1U << 10, 1U << 11, 1U << 12, 1U << 13};
+  static constexpr int NumBuckets = sizeof(BucketSize) / sizeof(BucketSize[0]);
+
+  /// @return The size class of Size bytes, the last one holding all the
+  /// sizes above its own.
+  static int findBucket(size_t Size);
+
+  struct Node {
+    const device_impl *Dev;
+    sycl::usm::alloc Kind;
+    size_t Size;
+  };
+
+  using FreeListKey = std::tuple<const device_impl *, sycl::usm::alloc, int>;
+  /// The free allocations of a size class ordered by size.
+  using FreeList = std::multimap<size_t, void *>;
+
+  void freeAll(const std::unordered_map<void *, Node> &Nodes);
+  void printStats() const;
+
+  context_impl &MContextImpl;
+  std::mutex MMutex;
+  std::unordered_map<void *, Node> MNodes;
+  std::map<FreeListKey, FreeList> MFreeLists;
+
+  uint64_t MHits = 0;
+  uint64_t MMisses = 0;
+  uint64_t MBytesReused = 0;
+  uint64_t MOutOfMemoryReleases = 0;
+};
+
+} // namespace usm
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -6,8 +6,12 @@
 //
 // ===--------------------------------------------------------------------=== //
 
+#include <detail/memory_telemetry.hpp>
 #include <detail/queue_impl.hpp>
+#include <detail/usm/usm_cache.hpp>
 #include <detail/usm/usm_impl.hpp>
+#include <detail/usm/usm_numa.hpp>
+#include <detail/usm/usm_prefetch.hpp>
 #include <sycl/context.hpp>
 #include <sycl/detail/aligned_allocator.hpp>
 #include <sycl/detail/os_util.hpp>
@@ -86,9 +90,21 @@ void *alignedAllocHost(size_t Alignment, size_t Size, const sycl::context &Ctxt,
       UsmDesc.pNext = &UsmLocationDesc;
     }
 
-    Error = Adapter->call_nocheck<sycl::detail::UrApiKind::urUSMHostAlloc>(
-        C, &UsmDesc,
-        /* pool= */ nullptr, Size, &RetVal);
+    // The pages of the allocation are pinned, they are placed on the NUMA
+    // node of the device as they are allocated.
+    int NumaNode = -1;
+    if (PropList.has_property<sycl::ext::oneapi::property::usm::numa_local>())
+      NumaNode = sycl::detail::usm::getDeviceNumaNode(
+          PropList.get_property<sycl::ext::oneapi::property::usm::numa_local>()
+              .get_device());
+    else
+      NumaNode = sycl::detail::usm::getDefaultNumaNode(Ctxt);
+    {
+      sycl::detail::usm::NumaPreferredScope NumaScope{NumaNode};
+      Error = Adapter->call_nocheck<sycl::detail::UrApiKind::urUSMHostAlloc>(
+          C, &UsmDesc,
+          /* pool= */ nullptr, Size, &RetVal);
+    }
 
     // Error is for debugging purposes.
     // The spec wants a nullptr returned, not an exception.
@@ -98,6 +114,9 @@ void *alignedAllocHost(size_t Alignment, size_t Size, const sycl::context &Ctxt,
   xpti::addMetadata(PrepareNotify.traceEvent(), "memory_ptr",
                     reinterpret_cast<size_t>(RetVal));
 #endif
+  if (sycl::detail::MemoryTelemetry::isEnabled())
+    sycl::detail::MemoryTelemetry::instance().recordUSMAlloc(
+        RetVal, Size, sycl::usm::alloc::host, CodeLoc);
   return RetVal;
 }
 } // namespace
@@ -113,24 +132,11 @@ extern xpti::trace_event_data_t *GSYCLGraphEvent;
 #endif
 namespace usm {
 
-void *alignedAllocInternal(size_t Alignment, size_t Size,
-                           const context_impl *CtxImpl,
-                           const device_impl *DevImpl, alloc Kind,
-                           const property_list &PropList) {
-  if (Kind == alloc::device &&
-      !DevImpl->has(sycl::aspect::usm_device_allocations)) {
-    throw sycl::exception(sycl::errc::feature_not_supported,
-                          "Device does not support USM device allocations!");
-  }
-  if (Kind == alloc::shared &&
-      !DevImpl->has(sycl::aspect::usm_shared_allocations)) {
-    throw sycl::exception(sycl::errc::feature_not_supported,
-                          "Device does not support shared USM allocations!");
-  }
-  void *RetVal = nullptr;
-  if (Size == 0)
-    return nullptr;
-
+static ur_result_t allocateOnDevice(size_t Alignment, size_t Size,
+                                    const context_impl *CtxImpl,
+                                    const device_impl *DevImpl, alloc Kind,
+                                    const property_list &PropList,
+                                    void *&RetVal) {
   ur_context_handle_t C = CtxImpl->getHandleRef();
   const AdapterPtr &Adapter = CtxImpl->getAdapter();
   ur_result_t Error = UR_RESULT_ERROR_INVALID_VALUE;
@@ -208,11 +214,55 @@ void *alignedAllocInternal(size_t Alignment, size_t Size,
     break;
   }
   }
+  return Error;
+}
+
+void *alignedAllocInternal(size_t Alignment, size_t Size,
+                           const context_impl *CtxImpl,
+                           const device_impl *DevImpl, alloc Kind,
+                           const property_list &PropList) {
+  if (Kind == alloc::device &&
+      !DevImpl->has(sycl::aspect::usm_device_allocations)) {
+    throw sycl::exception(sycl::errc::feature_not_supported,
+                          "Device does not support USM device allocations!");
+  }
+  if (Kind == alloc::shared &&
+      !DevImpl->has(sycl::aspect::usm_shared_allocations)) {
+    throw sycl::exception(sycl::errc::feature_not_supported,
+                          "Device does not support shared USM allocations!");
+  }
+  void *RetVal = nullptr;
+  if (Size == 0)
+    return nullptr;
+
+  // Only the allocations with the default alignment and without properties
+  // are cached, so that any of them can be reused for another.
+  USMCache &Cache = CtxImpl->getUSMCache();
+  const bool Cacheable =
+      Alignment == 0 && (Kind == alloc::device || Kind == alloc::shared) &&
+      Size <= USMCache::getThreshold() &&
+      !PropList.has_property<
+          sycl::ext::oneapi::property::usm::device_read_only>() &&
+      !PropList.has_property<
+          sycl::ext::intel::experimental::property::usm::buffer_location>();
+  if (Cacheable)
+    if (void *Ptr = Cache.take(DevImpl, Kind, Size))
+      return Ptr;
+
+  ur_result_t Error = allocateOnDevice(Alignment, Size, CtxImpl, DevImpl, Kind,
+                                       PropList, RetVal);
+  // The device may be out of the memory held by the free allocations of the
+  // cache.
+  if (Error != UR_RESULT_SUCCESS && Cache.releaseFree())
+    Error = allocateOnDevice(Alignment, Size, CtxImpl, DevImpl, Kind, PropList,
+                             RetVal);
 
   // Error is for debugging purposes.
   // The spec wants a nullptr returned, not an exception.
   if (Error != UR_RESULT_SUCCESS)
     return nullptr;
+  if (Cacheable)
+    Cache.track(DevImpl, Kind, Size, RetVal);
   return RetVal;
 }
 
@@ -245,12 +295,25 @@ void *alignedAlloc(size_t Alignment, size_t Size, const context &Ctxt,
   xpti::addMetadata(PrepareNotify.traceEvent(), "memory_ptr",
                     reinterpret_cast<size_t>(RetVal));
 #endif
+  if (MemoryTelemetry::isEnabled())
+    MemoryTelemetry::instance().recordUSMAlloc(RetVal, Size, Kind, CodeLoc);
+  if (RetVal && Kind == alloc::shared && USMPrefetcher::isEnabled())
+    getSyclObjImpl(Ctxt)->getUSMPrefetcher().track(
+        RetVal, Size,
+        PropList.has_property<
+            sycl::ext::oneapi::property::usm::device_read_only>());
   return RetVal;
 }
 
 void freeInternal(void *Ptr, const context_impl *CtxImpl) {
   if (Ptr == nullptr)
     return;
+  if (MemoryTelemetry::isEnabled())
+    MemoryTelemetry::instance().recordUSMFree(Ptr);
+  if (USMPrefetcher::isEnabled())
+    CtxImpl->getUSMPrefetcher().untrack(Ptr);
+  if (USMCache::getThreshold() != 0 && CtxImpl->getUSMCache().recycle(Ptr))
+    return;
   ur_context_handle_t C = CtxImpl->getHandleRef();
   const AdapterPtr &Adapter = CtxImpl->getAdapter();
   Adapter->call<detail::UrApiKind::urUSMFree>(C, Ptr);
@@ -0,0 +1,103 @@
+//==----------- usm_numa.cpp - NUMA placement of the host USM --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/config.hpp>
+#include <detail/usm/usm_numa.hpp>
+#include <sycl/detail/os_util.hpp>
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#if defined(__SYCL_RT_OS_LINUX)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+namespace usm {
+
+namespace {
+#if defined(__SYCL_RT_OS_LINUX)
+// From linux/mempolicy.h, which may not be installed.
+constexpr int MPOL_PREFERRED_MODE = 1;
+#endif
+
+int readDeviceNumaNode(const device &Dev) {
+  if (!Dev.has(aspect::ext_intel_pci_address))
+    return -1;
+  std::string Address = Dev.get_info<ext::intel::info::device::pci_address>();
+  std::ifstream File{"/sys/bus/pci/devices/" + Address + "/numa_node"};
+  int Node = -1;
+  if (!(File >> Node))
+    return -1;
+  return Node;
+}
+} // namespace
+
+int getDeviceNumaNode(const device &Dev) {
+  // The topology doesn't change, the nodes are looked up once per device.
+  static std::mutex Mutex;
+  static std::unordered_map<device, int> Nodes;
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = Nodes.find(Dev);
+    if (It != Nodes.end())
+      return It->second;
+  }
+  int Node = readDeviceNumaNode(Dev);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Nodes.emplace(Dev, Node);
+  return Node;
+}
+
+int getDefaultNumaNode(const context &Ctxt) {
+  static const bool Enabled = SYCLConfig<SYCL_USM_HOST_NUMA_LOCAL>::get();
+  if (!Enabled)
+    return -1;
+  int Node = -1;
+  for (const device &Dev : Ctxt.get_devices()) {
+    int DevNode = getDeviceNumaNode(Dev);
+    if (DevNode < 0 || (Node >= 0 && DevNode != Node))
+      return -1;
+    Node = DevNode;
+  }
+  return Node;
+}
+
+NumaPreferredScope::NumaPreferredScope(int Node) {
+#if defined(__SYCL_RT_OS_LINUX)
+  constexpr unsigned long Bits = MaskWords * sizeof(unsigned long) * 8;
+  if (Node < 0 || static_cast<unsigned long>(Node) >= Bits)
+    return;
+  if (syscall(SYS_get_mempolicy, &MOldMode, MOldMask, Bits + 1, nullptr, 0))
+    return;
+  unsigned long Mask[MaskWords] = {};
+  Mask[Node / (sizeof(unsigned long) * 8)] =
+      1UL << (Node % (sizeof(unsigned long) * 8));
+  MSet = syscall(SYS_set_mempolicy, MPOL_PREFERRED_MODE, Mask, Bits + 1) == 0;
+#else
+  (void)Node;
+#endif
+}
+
+NumaPreferredScope::~NumaPreferredScope() {
+#if defined(__SYCL_RT_OS_LINUX)
+  constexpr unsigned long Bits = MaskWords * sizeof(unsigned long) * 8;
+  if (MSet)
+    syscall(SYS_set_mempolicy, MOldMode, MOldMask, Bits + 1);
+#endif
+}
+
+} // namespace usm
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,48 @@
+//==----------- usm_numa.hpp - NUMA placement of the host USM --------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/context.hpp>
+#include <sycl/device.hpp>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+namespace usm {
+
+/// NUMA node of the PCI device of \p Dev, -1 if it is unknown.
+int getDeviceNumaNode(const device &Dev);
+
+/// NUMA node of the devices of \p Ctxt if they are all on the same one, -1
+/// otherwise. Only looked up when SYCL_USM_HOST_NUMA_LOCAL=1.
+int getDefaultNumaNode(const context &Ctxt);
+
+/// Makes the memory allocated by the calling thread prefer the NUMA node
+/// \p Node while in scope, so that the pages pinned by the host allocations
+/// are placed on it. Does nothing if \p Node is -1 or on the systems without
+/// NUMA memory policies.
+class NumaPreferredScope {
+public:
+  explicit NumaPreferredScope(int Node);
+  ~NumaPreferredScope();
+  NumaPreferredScope(const NumaPreferredScope &) = delete;
+  NumaPreferredScope &operator=(const NumaPreferredScope &) = delete;
+
+private:
+  static constexpr size_t MaskWords = 16;
+
+  bool MSet = false;
+  int MOldMode = 0;
+  unsigned long MOldMask[MaskWords] = {};
+};
+
+} // namespace usm
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
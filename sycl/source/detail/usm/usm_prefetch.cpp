@@ -0,0 +1,92 @@
+//==------- usm_prefetch.cpp - Prefetch of the shared USM of the kernels ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/adapter.hpp>
+#include <detail/config.hpp>
+#include <detail/queue_impl.hpp>
+#include <detail/usm/usm_prefetch.hpp>
+
+#include <set>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+namespace usm {
+
+bool USMPrefetcher::isEnabled() {
+  static const bool Enabled = SYCLConfig<SYCL_USM_AUTO_PREFETCH>::get();
+  return Enabled;
+}
+
+void USMPrefetcher::track(void *Ptr, size_t Size, bool DeviceReadOnly) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MAllocations[reinterpret_cast<uintptr_t>(Ptr)] =
+      Allocation{Size, DeviceReadOnly, /*Advised=*/false};
+}
+
+void USMPrefetcher::untrack(void *Ptr) {
+  std::lock_guard<std::mutex> Lock(MMutex);
+  MAllocations.erase(reinterpret_cast<uintptr_t>(Ptr));
+}
+
+std::vector<ur_event_handle_t>
+USMPrefetcher::prefetch(queue_impl &Queue,
+                        const std::vector<const void *> &Ptrs,
+                        const std::vector<ur_event_handle_t> &DepEvents) {
+  struct Range {
+    const void *Ptr;
+    size_t Size;
+    bool Advise;
+  };
+  std::vector<Range> Ranges;
+  {
+    std::lock_guard<std::mutex> Lock(MMutex);
+    if (MAllocations.empty())
+      return {};
+    // Several arguments may point into the same allocation.
+    std::set<uintptr_t> Seen;
+    for (const void *Ptr : Ptrs) {
+      uintptr_t Addr = reinterpret_cast<uintptr_t>(Ptr);
+      auto It = MAllocations.upper_bound(Addr);
+      if (It == MAllocations.begin())
+        continue;
+      --It;
+      if (Addr >= It->first + It->second.Size ||
+          !Seen.insert(It->first).second)
+        continue;
+      bool Advise = It->second.DeviceReadOnly && !It->second.Advised;
+      It->second.Advised |= Advise;
+      Ranges.push_back(
+          {reinterpret_cast<const void *>(It->first), It->second.Size, Advise});
+    }
+  }
+
+  const AdapterPtr &Adapter = Queue.getAdapter();
+  std::vector<ur_event_handle_t> Events;
+  Events.reserve(Ranges.size());
+  for (const Range &R : Ranges) {
+    // The prefetch and the advice are hints, the launch doesn't depend on
+    // them succeeding.
+    if (R.Advise)
+      Adapter->call_nocheck<UrApiKind::urEnqueueUSMAdvise>(
+          Queue.getHandleRef(), R.Ptr, R.Size,
+          UR_USM_ADVICE_FLAG_SET_READ_MOSTLY, nullptr);
+    ur_event_handle_t Event = nullptr;
+    if (Adapter->call_nocheck<UrApiKind::urEnqueueUSMPrefetch>(
+            Queue.getHandleRef(), R.Ptr, R.Size, 0, DepEvents.size(),
+            DepEvents.empty() ? nullptr : DepEvents.data(),
+            &Event) == UR_RESULT_SUCCESS)
+      Events.push_back(Event);
+  }
+  return Events;
+}
+
+} // namespace usm
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,74 @@
+//==------- usm_prefetch.hpp - Prefetch of the shared USM of the kernels ---==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/ur.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class queue_impl;
+
+namespace usm {
+
+/// Tracks the shared USM allocations of a context, so that the allocations
+/// the pointer arguments of a kernel point into are prefetched to the device
+/// before the kernel is launched, instead of migrating page by page on the
+/// faults of the kernel. The allocations made with the device_read_only
+/// property are also advised read-mostly on their first launch, letting the
+/// device keep a copy of them rather than moving them.
+///
+/// Opt-in with SYCL_USM_AUTO_PREFETCH=1. Only the arguments the kernel
+/// doesn't eliminate are prefetched, the pointers stored in other memory
+/// aren't seen.
+class USMPrefetcher {
+public:
+  USMPrefetcher() = default;
+  USMPrefetcher(const USMPrefetcher &) = delete;
+  USMPrefetcher &operator=(const USMPrefetcher &) = delete;
+
+  static bool isEnabled();
+
+  /// Starts tracking Ptr, a new shared allocation of Size bytes.
+  void track(void *Ptr, size_t Size, bool DeviceReadOnly);
+
+  /// Stops tracking Ptr, which is being freed.
+  void untrack(void *Ptr);
+
+  /// Enqueues the prefetch to the device of Queue of the tracked allocations
+  /// Ptrs point into, each waiting for DepEvents.
+  /// @return The events of the prefetches, to be waited for by the launch and
+  /// released by the caller.
+  std::vector<ur_event_handle_t>
+  prefetch(queue_impl &Queue, const std::vector<const void *> &Ptrs,
+           const std::vector<ur_event_handle_t> &DepEvents);
+
+private:
+  struct Allocation {
+    size_t Size;
+    bool DeviceReadOnly;
+    bool Advised;
+  };
+
+  std::mutex MMutex;
+  /// The allocations by start address.
+  std::map<uintptr_t, Allocation> MAllocations;
+};
+
+} // namespace usm
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,172 @@
+//==------ work_group_counters.cpp - Device-side work-group counters -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/cg.hpp>
+#include <detail/config.hpp>
+#include <detail/context_impl.hpp>
+#include <detail/device_impl.hpp>
+#include <detail/event_impl.hpp>
+#include <detail/queue_impl.hpp>
+#include <detail/scheduler/commands.hpp>
+#include <detail/work_group_counters.hpp>
+#include <detail/xpti_registry.hpp>
+
+#include <algorithm>
+#include <tuple>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+uint8_t GWorkGroupCountersStreamID;
+
+const bool WorkGroupCounters::MEnabled =
+    SYCLConfig<SYCL_WORK_GROUP_COUNTERS>::get();
+#else
+// The counters are only reported through XPTI.
+const bool WorkGroupCounters::MEnabled = false;
+#endif
+
+// Name of the device global in libdevice/itt_compiler_wrappers.cpp.
+static constexpr const char *DeviceGlobalName = "__itt_wg_counters";
+
+// Bounds the size of the buffer when the number of work-groups is not known
+// before the launch, the work-groups beyond it are only counted.
+static constexpr size_t MaxNumRecords = size_t{1} << 20;
+
+// Serializes the launches whose counters are collected.
+static std::mutex &getLaunchMutex() {
+  static std::mutex *Mutex = new std::mutex();
+  return *Mutex;
+}
+
+static size_t getNumWorkGroups(const NDRDescT &NDRDesc) {
+  size_t NumGroups = 1;
+  for (int I = 0; I < 3; ++I) {
+    if (NDRDesc.NumWorkGroups[0])
+      NumGroups *= std::max<size_t>(NDRDesc.NumWorkGroups[I], 1);
+    else if (NDRDesc.LocalSize[0])
+      NumGroups *= (NDRDesc.GlobalSize[I] + NDRDesc.LocalSize[I] - 1) /
+                   NDRDesc.LocalSize[I];
+    else
+      // The work-group size is chosen by the backend, so there are at most
+      // as many work-groups as work-items.
+      NumGroups *= NDRDesc.GlobalSize[I];
+  }
+  return std::min(NumGroups, MaxNumRecords);
+}
+
+WorkGroupCounters::WorkGroupCounters(const QueueImplPtr &Queue,
+                                     ur_program_handle_t Program,
+                                     size_t NumRecords)
+    : MLock(getLaunchMutex()), MQueue(Queue), MProgram(Program),
+      MNumRecords(NumRecords) {}
+
+std::unique_ptr<WorkGroupCounters>
+WorkGroupCounters::begin(const QueueImplPtr &Queue, ur_program_handle_t Program,
+                         const NDRDescT &NDRDesc) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  if (!isEnabled() || !xptiCheckTraceEnabled(GWorkGroupCountersStreamID))
+    return nullptr;
+
+  size_t NumRecords = getNumWorkGroups(NDRDesc);
+  std::unique_ptr<WorkGroupCounters> Counters(
+      new WorkGroupCounters(Queue, Program, NumRecords));
+
+  const AdapterPtr &Adapter = Queue->getAdapter();
+  size_t Size =
+      sizeof(WorkGroupCountersData) + NumRecords * sizeof(WorkGroupRecord);
+  if (Adapter->call_nocheck<UrApiKind::urUSMDeviceAlloc>(
+          Queue->getContextImplPtr()->getHandleRef(),
+          Queue->getDeviceImplPtr()->getHandleRef(), nullptr, nullptr, Size,
+          &Counters->MDeviceMem) != UR_RESULT_SUCCESS) {
+    Counters->MDeviceMem = nullptr;
+    return nullptr;
+  }
+
+  std::vector<uint64_t> Initial(Size / sizeof(uint64_t), 0);
+  reinterpret_cast<WorkGroupCountersData *>(Initial.data())->NumRecords =
+      NumRecords;
+  Adapter->call<UrApiKind::urEnqueueUSMMemcpy>(
+      Queue->getHandleRef(), /*blocking=*/true, Counters->MDeviceMem,
+      Initial.data(), Size, 0, nullptr, nullptr);
+
+  // Programs built without -fsycl-instrument-device-code don't have the
+  // device global.
+  if (!Counters->setDeviceGlobal(Counters->MDeviceMem))
+    return nullptr;
+  Counters->MAttached = true;
+  return Counters;
+#else
+  std::ignore = Queue;
+  std::ignore = Program;
+  std::ignore = NDRDesc;
+  return nullptr;
+#endif
+}
+
+bool WorkGroupCounters::setDeviceGlobal(void *Ptr) {
+  return MQueue->getAdapter()
+             ->call_nocheck<UrApiKind::urEnqueueDeviceGlobalVariableWrite>(
+                 MQueue->getHandleRef(), MProgram, DeviceGlobalName,
+                 /*blockingWrite=*/true, sizeof(Ptr), 0, &Ptr, 0, nullptr,
+                 nullptr) == UR_RESULT_SUCCESS;
+}
+
+void WorkGroupCounters::end(const EventImplPtr &KernelEvent) {
+#ifdef XPTI_ENABLE_INSTRUMENTATION
+  const AdapterPtr &Adapter = MQueue->getAdapter();
+  ur_event_handle_t Handle = KernelEvent ? KernelEvent->getHandle() : nullptr;
+  if (Handle)
+    Adapter->call<UrApiKind::urEventWait>(1, &Handle);
+  else
+    Adapter->call<UrApiKind::urQueueFinish>(MQueue->getHandleRef());
+
+  size_t Size =
+      sizeof(WorkGroupCountersData) + MNumRecords * sizeof(WorkGroupRecord);
+  std::vector<uint64_t> Data(Size / sizeof(uint64_t));
+  Adapter->call<UrApiKind::urEnqueueUSMMemcpy>(
+      MQueue->getHandleRef(), /*blocking=*/true, Data.data(), MDeviceMem, Size,
+      0, nullptr, nullptr);
+  auto *Records = reinterpret_cast<WorkGroupRecord *>(
+      Data.data() + sizeof(WorkGroupCountersData) / sizeof(uint64_t));
+  for (size_t I = 0; I < MNumRecords; ++I)
+    Records[I].Start = ~Records[I].Start;
+
+  // Kernels bypassing the scheduler have no command and are reported with
+  // the graph event.
+  xpti_td *TraceEvent = GSYCLGraphEvent;
+  uint64_t InstanceID = 0;
+  auto *Cmd =
+      KernelEvent ? static_cast<Command *>(KernelEvent->getCommand()) : nullptr;
+  if (Cmd && Cmd->MTraceEvent) {
+    TraceEvent = static_cast<xpti_td *>(Cmd->MTraceEvent);
+    InstanceID = Cmd->MInstanceID;
+  }
+  xptiNotifySubscribers(GWorkGroupCountersStreamID,
+                        (uint16_t)xpti::trace_point_type_t::signal, nullptr,
+                        TraceEvent, InstanceID,
+                        static_cast<const void *>(Data.data()));
+#else
+  std::ignore = KernelEvent;
+#endif
+}
+
+WorkGroupCounters::~WorkGroupCounters() {
+  // The kernels of the program launched later must not write to the buffer.
+  if (MAttached)
+    setDeviceGlobal(nullptr);
+  if (MDeviceMem)
+    MQueue->getAdapter()->call_nocheck<UrApiKind::urUSMFree>(
+        MQueue->getContextImplPtr()->getHandleRef(), MDeviceMem);
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
@@ -0,0 +1,95 @@
+//==------ work_group_counters.hpp - Device-side work-group counters -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <sycl/detail/ur.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+class NDRDescT;
+class event_impl;
+class queue_impl;
+using EventImplPtr = std::shared_ptr<event_impl>;
+using QueueImplPtr = std::shared_ptr<queue_impl>;
+
+/// Counters of a work-group, in device clock ticks. The layout must be the
+/// same as __itt_wg_record_t in libdevice/device_itt.h.
+struct WorkGroupRecord {
+  /// Earliest start of a work-item. The device writes its bitwise negation,
+  /// which is undone before the counters are reported.
+  uint64_t Start;
+  /// Latest finish of a work-item.
+  uint64_t End;
+  /// Sum over the work-items of the time spent waiting at barriers.
+  uint64_t BarrierWait;
+};
+
+/// Counters of a kernel launch, followed by NumRecords WorkGroupRecord indexed
+/// by the linear work-group id. The layout must be the same as
+/// __itt_wg_counters_t in libdevice/device_itt.h.
+struct WorkGroupCountersData {
+  uint64_t NumRecords;
+  /// Number of work-groups whose linear id didn't fit into the records.
+  uint64_t Dropped;
+};
+
+/// Collects the work-group counters of a kernel launch for the
+/// sycl.experimental.work_group_counters XPTI stream. Enabled by
+/// SYCL_WORK_GROUP_COUNTERS=1, the counters are recorded by the ITT compiler
+/// wrappers of libdevice in the kernels built with
+/// -fsycl-instrument-device-code, into a buffer set up through the
+/// __itt_wg_counters device global of their program.
+///
+/// The device global is shared by all the launches of the program, so the
+/// launches which are collected are serialized, each of them being waited for
+/// before the next one starts.
+class WorkGroupCounters {
+public:
+  static bool isEnabled() { return MEnabled; }
+
+  /// Sets up the counters for a launch of a kernel of Program with NDRDesc.
+  /// Returns null if they are not collected, i.e. if the stream has no
+  /// subscriber or the program is not instrumented.
+  static std::unique_ptr<WorkGroupCounters>
+  begin(const QueueImplPtr &Queue, ur_program_handle_t Program,
+        const NDRDescT &NDRDesc);
+
+  /// Waits for the kernel launched after begin() and reports its counters.
+  void end(const EventImplPtr &KernelEvent);
+
+  /// Detaches the buffer from the program and releases it.
+  ~WorkGroupCounters();
+
+private:
+  WorkGroupCounters(const QueueImplPtr &Queue, ur_program_handle_t Program,
+                    size_t NumRecords);
+
+  bool setDeviceGlobal(void *Ptr);
+
+  static const bool MEnabled;
+
+  std::unique_lock<std::mutex> MLock;
+  QueueImplPtr MQueue;
+  ur_program_handle_t MProgram;
+  size_t MNumRecords;
+  void *MDeviceMem = nullptr;
+  bool MAttached = false;
+};
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
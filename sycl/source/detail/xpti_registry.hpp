@@ -34,6 +34,8 @@ inline constexpr auto SYCL_MEM_ALLOC_STREAM_NAME =
 extern uint8_t GBufferStreamID;
 extern uint8_t GImageStreamID;
 extern uint8_t GMemAllocStreamID;
+extern uint8_t GDeviceTimingStreamID;
+extern uint8_t GWorkGroupCountersStreamID;
 extern xpti::trace_event_data_t *GMemAllocEvent;
 extern xpti::trace_event_data_t *GSYCLGraphEvent;
 
@@ -58,6 +60,21 @@ inline constexpr const char *SYCL_BUFFER_STREAM_NAME =
 // Stream name being used to notify about image objects.
 inline constexpr const char *SYCL_IMAGE_STREAM_NAME = "sycl.experimental.image";
 
+// Stream name being used to report the device execution times of kernels. A
+// signal is emitted for each completed kernel with the trace event of its
+// command and, as user data, a pointer to two uint64_t holding the device
+// timestamps in nanoseconds of the start and the end of the kernel.
+inline constexpr const char *SYCL_DEVICE_TIMING_STREAM_NAME =
+    "sycl.experimental.device_timing";
+
+// Stream name being used to report the work-group counters of kernels built
+// with -fsycl-instrument-device-code when SYCL_WORK_GROUP_COUNTERS=1 is set. A
+// signal is emitted for each completed kernel with the trace event of its
+// command and, as user data, a pointer to the WorkGroupCountersData of the
+// launch, see detail/work_group_counters.hpp.
+inline constexpr const char *SYCL_WORK_GROUP_COUNTERS_STREAM_NAME =
+    "sycl.experimental.work_group_counters";
+
 class XPTIRegistry {
 public:
   void initializeFrameworkOnce() {
@@ -74,11 +91,25 @@ public:
       // Memory allocation events
       GMemAllocStreamID = xptiRegisterStream(SYCL_MEM_ALLOC_STREAM_NAME);
       this->initializeStream(SYCL_MEM_ALLOC_STREAM_NAME, 0, 1, "0.1");
+
+      // Device execution times of kernels
+      GDeviceTimingStreamID =
+          xptiRegisterStream(SYCL_DEVICE_TIMING_STREAM_NAME);
+      this->initializeStream(SYCL_DEVICE_TIMING_STREAM_NAME, 0, 1, "0.1");
+
+      // Work-group counters of kernels
+      GWorkGroupCountersStreamID =
+          xptiRegisterStream(SYCL_WORK_GROUP_COUNTERS_STREAM_NAME);
+      this->initializeStream(SYCL_WORK_GROUP_COUNTERS_STREAM_NAME, 0, 1, "0.1");
       xpti::payload_t MAPayload("SYCL Memory Allocations Layer");
       uint64_t MAInstanceNo = 0;
       GMemAllocEvent = xptiMakeEvent("SYCL Memory Allocations", &MAPayload,
                                      xpti::trace_algorithm_event,
                                      xpti_at::active, &MAInstanceNo);
+#if !defined(_WIN32) && !defined(_WIN64)
+      // Subscribers may be attached on a signal once the streams exist.
+      xpti::framework::attach_control_t::instance().start();
+#endif
     });
 #endif
   }
@@ -99,6 +130,7 @@ public:
 
   ~XPTIRegistry() {
 #ifdef XPTI_ENABLE_INSTRUMENTATION
+    xpti::framework::buffered_notifier_t::instance().shutdown();
     for (const auto &StreamName : MActiveStreams) {
       xptiFinalize(StreamName.c_str());
     }
@@ -192,7 +224,7 @@ public:
         TraceType == (uint16_t)xpti::trace_point_type_t::queue_create)
       MTP->parent_event(GSYCLGraphEvent);
     // Now if tracing is enabled, create trace events and notify
-    if (xptiTraceEnabled() && MTP) {
+    if (xpti::framework::trace_enabled() && MTP) {
       MTP->stream(StreamName).trace_type((xpti::trace_point_type_t)TraceType);
       MTraceEvent = const_cast<xpti::trace_event_data_t *>(MTP->trace_event());
       MStreamID = MTP->stream_id();
@@ -229,7 +261,7 @@ public:
         TraceType == (uint16_t)xpti::trace_point_type_t::queue_create)
       MTP->parent_event(GSYCLGraphEvent);
     // Now if tracing is enabled, create trace events and notify
-    if (xptiTraceEnabled() && MTP) {
+    if (xpti::framework::trace_enabled() && MTP) {
       MTP->stream(StreamName).trace_type((xpti::trace_point_type_t)TraceType);
       MTraceEvent = const_cast<xpti::trace_event_data_t *>(MTP->trace_event());
       MStreamID = MTP->stream_id();
@@ -249,7 +281,7 @@ public:
 
   XPTIScope &
   addMetadata(const std::function<void(xpti::trace_event_data_t *)> &Callback) {
-    if (xptiTraceEnabled() && MTP) {
+    if (xpti::framework::trace_enabled() && MTP) {
       auto TEvent = const_cast<xpti::trace_event_data_t *>(MTP->trace_event());
       Callback(TEvent);
     }
@@ -269,8 +301,11 @@ public:
     MTraceType = TraceType & 0xfffe;
     MScopedNotify = true;
     if (xptiCheckTraceEnabled(MStreamID, TraceType) && MTP) {
-      xptiNotifySubscribers(MStreamID, MTraceType, nullptr, MTraceEvent,
-                            MInstanceID, static_cast<const void *>(MUserData));
+      // The user data is a string literal, so the notification can be
+      // buffered.
+      xpti::framework::buffered_notifier_t::instance().notify(
+          MStreamID, MTraceType, nullptr, MTraceEvent, MInstanceID,
+          static_cast<const void *>(MUserData));
     }
     return *this;
   }
@@ -287,8 +322,9 @@ public:
         return;
 
       // Only notify for a trace type that has a begin/end
-      xptiNotifySubscribers(MStreamID, MTraceType, nullptr, MTraceEvent,
-                            MInstanceID, static_cast<const void *>(MUserData));
+      xpti::framework::buffered_notifier_t::instance().notify(
+          MStreamID, MTraceType, nullptr, MTraceEvent, MInstanceID,
+          static_cast<const void *>(MUserData));
     }
     // Delete the tracepoint object which will clear TLS if it is the top of
     // the scope
@@ -0,0 +1,34 @@
+//==---------- xray.cpp --- XRay instrumentation of the SYCL runtime -------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Only built with SYCL_ENABLE_XRAY, which links the XRay runtime into the SYCL
+// runtime library.
+
+#include <xray/xray_interface.h>
+
+#include <cstdlib>
+#include <cstring>
+
+namespace sycl {
+inline namespace _V1 {
+namespace detail {
+
+// The XRay runtime linked into a shared library is built without the
+// .preinit_array initialization, which patches the sleds before main when
+// XRAY_OPTIONS has patch_premain=true. The sleds of the library are patched
+// when it is loaded instead, after the XRay runtime is initialized by its
+// own constructor.
+__attribute__((constructor)) static void patchXRaySleds() {
+  const char *Options = std::getenv("XRAY_OPTIONS");
+  if (Options && std::strstr(Options, "patch_premain=true"))
+    __xray_patch();
+}
+
+} // namespace detail
+} // namespace _V1
+} // namespace sycl
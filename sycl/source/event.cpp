@@ -41,6 +41,7 @@ bool event::operator!=(const event &rhs) const { return !(*this == rhs); }
 void event::wait() { impl->wait(impl); }
 
 void event::wait(const std::vector<event> &EventList) {
+  detail::event_impl::waitNativeEvents(EventList);
   for (auto E : EventList) {
     E.wait();
   }
@@ -49,6 +50,7 @@ void event::wait(const std::vector<event> &EventList) {
 void event::wait_and_throw() { impl->wait_and_throw(impl); }
 
 void event::wait_and_throw(const std::vector<event> &EventList) {
+  detail::event_impl::waitNativeEvents(EventList);
   for (auto E : EventList) {
     E.wait_and_throw();
   }
@@ -473,6 +473,13 @@ exe_kb build_from_source(
 }
 
 } // namespace detail
+
+void build_kernels_async(const context &Ctx, const std::vector<device> &Devs) {
+  sycl::detail::ProgramManager::getInstance().buildProgramsAsync(
+      sycl::detail::getSyclObjImpl(Ctx),
+      sycl::detail::removeDuplicateDevices(Devs));
+}
+
 } // namespace ext::oneapi::experimental
 
 } // namespace _V1
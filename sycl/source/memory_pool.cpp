@@ -0,0 +1,93 @@
+//==------- memory_pool.cpp - SYCL asynchronous USM allocations ------------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/context_impl.hpp>
+#include <detail/memory_pool_impl.hpp>
+#include <detail/queue_impl.hpp>
+#include <sycl/ext/oneapi/experimental/async_alloc.hpp>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+memory_pool::memory_pool(const context &SyclContext, const device &SyclDevice,
+                         const property_list &PropList) {
+  (void)PropList;
+  const std::shared_ptr<sycl::detail::context_impl> &CtxImpl =
+      sycl::detail::getSyclObjImpl(SyclContext);
+  impl = std::make_shared<sycl::detail::memory_pool_impl>(
+      *CtxImpl, sycl::detail::getSyclObjImpl(SyclDevice), CtxImpl);
+}
+
+context memory_pool::get_context() const {
+  return sycl::detail::createSyclObjFromImpl<context>(
+      impl->getContextImplPtr());
+}
+
+device memory_pool::get_device() const {
+  return sycl::detail::createSyclObjFromImpl<device>(impl->getDeviceImpl());
+}
+
+size_t memory_pool::get_reserved_size_current() const {
+  return impl->getReservedSize();
+}
+
+size_t memory_pool::get_used_size_current() const {
+  return impl->getUsedSize();
+}
+
+void memory_pool::trim_to(size_t MinBytesToKeep) {
+  impl->trimTo(MinBytesToKeep);
+}
+
+void *async_malloc(const queue &SyclQueue, sycl::usm::alloc Kind,
+                   size_t Size) {
+  if (Kind != sycl::usm::alloc::device) {
+    throw sycl::exception(
+        sycl::make_error_code(sycl::errc::feature_not_supported),
+        "Only device allocations are supported by async_malloc");
+  }
+  const std::shared_ptr<sycl::detail::queue_impl> &QueueImpl =
+      sycl::detail::getSyclObjImpl(SyclQueue);
+  sycl::detail::memory_pool_impl &Pool =
+      QueueImpl->getContextImplPtr()->getDefaultMemoryPool(
+          QueueImpl->getDeviceImplPtr());
+  return Pool.allocate(QueueImpl, Size);
+}
+
+void *async_malloc_from_pool(const queue &SyclQueue, size_t Size,
+                             const memory_pool &Pool) {
+  const std::shared_ptr<sycl::detail::queue_impl> &QueueImpl =
+      sycl::detail::getSyclObjImpl(SyclQueue);
+  const std::shared_ptr<sycl::detail::memory_pool_impl> &PoolImpl =
+      sycl::detail::getSyclObjImpl(Pool);
+  if (&PoolImpl->getContextImpl() != QueueImpl->getContextImplPtr().get()) {
+    throw sycl::exception(
+        sycl::make_error_code(sycl::errc::invalid),
+        "The memory pool and the queue must have the same context");
+  }
+  return PoolImpl->allocate(QueueImpl, Size);
+}
+
+void async_free(const queue &SyclQueue, void *Ptr) {
+  if (Ptr == nullptr)
+    return;
+  const std::shared_ptr<sycl::detail::queue_impl> &QueueImpl =
+      sycl::detail::getSyclObjImpl(SyclQueue);
+  sycl::detail::memory_pool_impl *Pool =
+      QueueImpl->getContextImplPtr()->findMemoryPool(Ptr);
+  if (!Pool || !Pool->deallocate(QueueImpl, Ptr)) {
+    throw sycl::exception(
+        sycl::make_error_code(sycl::errc::invalid),
+        "Pointer was not allocated by async_malloc in the queue's context");
+  }
+}
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
@@ -12,6 +12,7 @@
 #include <sycl/detail/common.hpp>
 #include <sycl/event.hpp>
 #include <sycl/exception_list.hpp>
+#include <sycl/ext/oneapi/experimental/enqueue_functions.hpp>
 #include <sycl/handler.hpp>
 #include <sycl/queue.hpp>
 
@@ -238,7 +239,7 @@ getBarrierEventForInorderQueueHelper(const detail::QueueImplPtr QueueImpl) {
   assert(!QueueImpl->getCommandGraph() &&
          "Should not be called in on graph recording.");
 
-  return QueueImpl->getLastEvent();
+  return QueueImpl->getLastEvent(QueueImpl);
 }
 
 /// Prevents any commands submitted afterward to this queue from executing
@@ -362,7 +363,7 @@ event queue::ext_oneapi_get_last_event() const {
         make_error_code(errc::invalid),
         "ext_oneapi_get_last_event() can only be called on in-order queues.");
 
-  event LastEvent = impl->getLastEvent();
+  event LastEvent = impl->getLastEvent(impl);
   // If the last event was discarded or a NOP, we insert a marker to represent
   // an event at end.
   auto LastEventImpl = detail::getSyclObjImpl(LastEvent);
@@ -377,11 +378,89 @@ void queue::ext_oneapi_set_external_event(const event &external_event) {
     throw sycl::exception(make_error_code(errc::invalid),
                           "ext_oneapi_set_external_event() can only be called "
                           "on in-order queues.");
-  return impl->setExternalEvent(external_event);
+  return impl->setExternalEvent(impl, external_event);
 }
 
 const property_list &queue::getPropList() const { return impl->getPropList(); }
 
+namespace ext::oneapi::experimental::detail {
+event submit_batch_impl(queue &Q,
+                        const std::vector<std::function<void(handler &)>> &CGFs,
+                        bool CallerNeedsEvent,
+                        const sycl::detail::code_location &CodeLoc) {
+  std::shared_ptr<sycl::detail::queue_impl> QueueImpl =
+      sycl::detail::getSyclObjImpl(Q);
+  return QueueImpl->submitBatch(CGFs, QueueImpl, CallerNeedsEvent, CodeLoc);
+}
+
+template <int Dims> static range<Dims> makeRange(const size_t *Sizes) {
+  if constexpr (Dims == 1)
+    return range<1>{Sizes[0]};
+  else if constexpr (Dims == 2)
+    return range<2>{Sizes[0], Sizes[1]};
+  else
+    return range<3>{Sizes[0], Sizes[1], Sizes[2]};
+}
+
+template <int Dims>
+static void launchWithHandler(handler &CGH, const kernel &Kernel,
+                              const size_t *GlobalSize,
+                              const size_t *LocalSize) {
+  if (LocalSize)
+    CGH.parallel_for(
+        nd_range<Dims>{makeRange<Dims>(GlobalSize), makeRange<Dims>(LocalSize)},
+        Kernel);
+  else
+    CGH.parallel_for(makeRange<Dims>(GlobalSize), Kernel);
+}
+
+event launch_descriptor_impl(queue &Q, const kernel &Kernel,
+                             const char *KernelName, int Dims,
+                             const size_t *GlobalSize, const size_t *LocalSize,
+                             const unsigned char *ArgData,
+                             const launch_arg *Args, size_t NumArgs,
+                             bool CallerNeedsEvent,
+                             const sycl::detail::code_location &CodeLoc) {
+  std::shared_ptr<sycl::detail::queue_impl> QueueImpl =
+      sycl::detail::getSyclObjImpl(Q);
+  sycl::detail::tls_code_loc_t TlsCodeLocCapture(CodeLoc);
+
+  range<3> Global{0, 0, 0};
+  range<3> Local{0, 0, 0};
+  for (int I = 0; I < Dims; ++I) {
+    Global[I] = GlobalSize[I];
+    if (LocalSize)
+      Local[I] = LocalSize[I];
+  }
+  sycl::detail::NDRDescT NDRDesc =
+      LocalSize ? sycl::detail::NDRDescT(Global, Local, id<3>{0, 0, 0}, Dims)
+                : sycl::detail::NDRDescT(Global, /*SetNumWorkGroups=*/false,
+                                         Dims);
+
+  std::vector<sycl::detail::ArgDesc> ArgDescs;
+  ArgDescs.reserve(NumArgs);
+  for (size_t I = 0; I < NumArgs; ++I)
+    ArgDescs.emplace_back(sycl::detail::kernel_param_kind_t::kind_std_layout,
+                          const_cast<unsigned char *>(ArgData) + Args[I].Offset,
+                          static_cast<int>(Args[I].Size), Args[I].Index);
+
+  auto HandlerFunc = [&](handler &CGH) {
+    for (size_t I = 0; I < NumArgs; ++I)
+      CGH.set_arg(Args[I].Index,
+                  raw_kernel_arg(ArgData + Args[I].Offset, Args[I].Size));
+    if (Dims == 1)
+      launchWithHandler<1>(CGH, Kernel, GlobalSize, LocalSize);
+    else if (Dims == 2)
+      launchWithHandler<2>(CGH, Kernel, GlobalSize, LocalSize);
+    else
+      launchWithHandler<3>(CGH, Kernel, GlobalSize, LocalSize);
+  };
+  return QueueImpl->submitKernelLaunch(
+      QueueImpl, sycl::detail::getSyclObjImpl(Kernel), KernelName, NDRDesc,
+      ArgDescs, CallerNeedsEvent, HandlerFunc);
+}
+} // namespace ext::oneapi::experimental::detail
+
 } // namespace _V1
 } // namespace sycl
 
@@ -0,0 +1,30 @@
+//==------ submission_stats.cpp - SYCL submission latency breakdown --------==//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <detail/submission_stats.hpp>
+#include <sycl/ext/oneapi/experimental/submission_stats.hpp>
+
+namespace sycl {
+inline namespace _V1 {
+namespace ext::oneapi::experimental {
+
+submission_phase_stats get_submission_stats(submission_phase Phase) {
+  return sycl::detail::SubmissionStats::instance().get(Phase);
+}
+
+void reset_submission_stats() {
+  sycl::detail::SubmissionStats::instance().reset();
+}
+
+void set_submission_stats_enabled(bool Enabled) {
+  sycl::detail::SubmissionStats::setEnabled(Enabled);
+}
+
+} // namespace ext::oneapi::experimental
+} // namespace _V1
+} // namespace sycl
@@ -857,6 +857,37 @@ XPTI_EXPORT_API bool xptiTraceEnabled();
 /// @return bool that indicates whether it is enabled or not
 XPTI_EXPORT_API bool xptiCheckTraceEnabled(uint16_t stream, uint16_t ttype = 0);
 
+/// @brief Returns the flag telling whether tracing is enabled or not
+/// @details The flag holds the value xptiTraceEnabled() would return and is
+/// updated as subscribers are attached and detached, so instrumentation can
+/// check it with a single load instead of a call. The flag stays valid for the
+/// lifetime of the process.
+/// @return Pointer to the flag, never NULL
+XPTI_EXPORT_API const std::atomic<bool> *xptiTraceEnabledFlag();
+
+/// @brief Loads a subscriber into a running process
+/// @details Loads the subscriber library as if it had been listed in
+/// XPTI_SUBSCRIBERS at startup, loading the dispatcher first if tracing was
+/// not enabled. The xptiTraceInit() function of the subscriber is called for
+/// every stream already initialized by xptiInitialize(), including the
+/// streams initialized while no dispatcher was loaded, and tracing is enabled
+/// from then on.
+/// @param path Path of the subscriber library
+/// @return XPTI_RESULT_SUCCESS if the subscriber is loaded,
+/// XPTI_RESULT_DUPLICATE if it is already loaded, XPTI_RESULT_FAIL if the
+/// library or the dispatcher cannot be loaded
+XPTI_EXPORT_API xpti::result_t xptiAttachSubscriber(const char *path);
+
+/// @brief Unloads a subscriber loaded by xptiAttachSubscriber()
+/// @details Calls the xptiTraceFinish() function of the subscriber for every
+/// initialized stream and unregisters its callbacks before unloading it. The
+/// notifications being delivered to the subscriber complete first. Tracing is
+/// disabled once no subscriber is left.
+/// @param path Path the subscriber was attached with
+/// @return XPTI_RESULT_SUCCESS if the subscriber is unloaded,
+/// XPTI_RESULT_NOTFOUND if it is not attached
+XPTI_EXPORT_API xpti::result_t xptiDetachSubscriber(const char *path);
+
 /// @brief Resets internal state
 /// @details This method is currently ONLY used by the tests and is NOT
 /// recommended for use in the instrumentation of applications or runtimes.
@@ -1034,6 +1065,9 @@ typedef xpti::result_t (*xpti_add_metadata_t)(xpti::trace_event_data_t *,
 typedef xpti::metadata_t *(*xpti_query_metadata_t)(xpti::trace_event_data_t *);
 typedef bool (*xpti_trace_enabled_t)();
 typedef bool (*xpti_check_trace_enabled_t)(uint16_t stream, uint16_t ttype);
+typedef const std::atomic<bool> *(*xpti_trace_enabled_flag_t)();
+typedef xpti::result_t (*xpti_attach_subscriber_t)(const char *);
+typedef xpti::result_t (*xpti_detach_subscriber_t)(const char *);
 typedef void (*xpti_force_set_trace_enabled_t)(bool);
 typedef void (*xpti_release_event_t)(xpti::trace_event_data_t *);
 typedef void (*xpti_enable_tracepoint_scope_notification_t)(bool);
@@ -11,14 +11,18 @@
 #include "xpti/xpti_trace_framework.h"
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
 #include <thread>
+#include <vector>
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <string>
@@ -39,10 +43,15 @@ typedef FARPROC xpti_plugin_function_t;
 // Windows
 constexpr auto WIN_PATH_MAX = 32767;
 #else // Linux and MacOSX
+#include <cerrno>
+#include <csignal>
 #include <cstdlib>
 #include <dlfcn.h>
+#include <fcntl.h>
 #include <limits.h>
 #include <string>
+#include <sys/stat.h>
+#include <unistd.h>
 
 typedef void *xpti_plugin_handle_t;
 typedef void *xpti_plugin_function_t;
@@ -1459,6 +1468,394 @@ private:
   bool MTraceEnabled = false;
 };
 
+/// @class sampler_t
+/// @brief Decides which instances of the trace events are reported.
+///
+/// The environment variable XPTI_TRACE_SAMPLING holds a comma separated list
+/// of entries of the form `<stream>=<N>` or `<stream>:<trace type>=<N>`, the
+/// trace type being the numeric value of an xpti::trace_point_type_t, e.g.,
+/// `sycl=100,sycl:20=10`. One instance in N of the trace events of the stream
+/// is then reported, the entries for a trace type taking precedence over the
+/// ones for the whole stream.
+///
+/// The decision only depends on the instance number, so the begin and end
+/// notifications of an instance, which share the sampling rate of the begin
+/// trace type, are either both reported or both dropped. Trace types without
+/// a rate are always reported.
+///
+class sampler_t {
+public:
+  /// @brief Returns the sampler of the process.
+  ///
+  static sampler_t &instance() {
+    static sampler_t *Sampler = new sampler_t();
+    return *Sampler;
+  }
+
+  sampler_t(const sampler_t &) = delete;
+  sampler_t &operator=(const sampler_t &) = delete;
+
+  /// @brief Checks whether a notification is reported.
+  ///
+  /// @param StreamID The stream of the notification.
+  /// @param TraceType The trace type of the notification.
+  /// @param Instance The instance number of the trace event.
+  /// @return true if the notification must be sent to the subscribers.
+  ///
+  bool sample(uint8_t StreamID, uint16_t TraceType, uint64_t Instance) const {
+    if (!MEnabled)
+      return true;
+    uint64_t Rate = getRate(StreamID, TraceType);
+    return Rate <= 1 || Instance % Rate == 1;
+  }
+
+private:
+  struct stream_rates_t {
+    /// Rate of the trace types without their own rate, 0 if none
+    uint64_t Default = 0;
+    /// Rates of the begin trace types, the end types sharing them
+    std::vector<std::pair<uint16_t, uint64_t>> TraceTypes;
+  };
+
+  sampler_t() {
+    utils::PlatformHelper Helper;
+    std::string Env = Helper.getEnvironmentVariable("XPTI_TRACE_SAMPLING");
+    std::stringstream Entries(Env);
+    std::string Entry;
+    while (std::getline(Entries, Entry, ',')) {
+      size_t Eq = Entry.find('=');
+      if (Eq == std::string::npos)
+        continue;
+      std::string Stream = Entry.substr(0, Eq);
+      uint64_t Rate = std::strtoull(Entry.c_str() + Eq + 1, nullptr, 10);
+      size_t Colon = Stream.find(':');
+      std::optional<uint16_t> TraceType;
+      if (Colon != std::string::npos) {
+        TraceType = static_cast<uint16_t>(
+            std::strtoul(Stream.c_str() + Colon + 1, nullptr, 10) & 0xfffe);
+        Stream.resize(Colon);
+      }
+      if (Stream.empty() || Rate <= 1)
+        continue;
+      stream_rates_t &Rates = MRates[xptiRegisterStream(Stream.c_str())];
+      if (TraceType)
+        Rates.TraceTypes.emplace_back(*TraceType, Rate);
+      else
+        Rates.Default = Rate;
+      MEnabled = true;
+    }
+  }
+
+  uint64_t getRate(uint8_t StreamID, uint16_t TraceType) const {
+    const stream_rates_t &Rates = MRates[StreamID];
+    for (const auto &[Type, Rate] : Rates.TraceTypes) {
+      if (Type == (TraceType & 0xfffe))
+        return Rate;
+    }
+    return Rates.Default;
+  }
+
+  /// Set if any rate is configured
+  bool MEnabled = false;
+  /// The rates of each stream
+  stream_rates_t MRates[256];
+};
+
+/// @class buffered_notifier_t
+/// @brief Delivers notifications to subscribers from a collector thread.
+///
+/// When the environment variable XPTI_TRACE_BUFFERED is set to "1" or "true",
+/// the notifications sent through notify() are written to a lock-free ring
+/// buffer owned by the calling thread and a collector thread delivers them to
+/// the subscribers in batches. This takes the cost of the callbacks off the
+/// instrumented thread. Otherwise, the subscribers are notified synchronously.
+///
+/// The notifications a thread sends through this class are delivered in the
+/// order they were sent, but the notifications of different threads may be
+/// interleaved.
+///
+/// @note The trace events and the user data of a buffered notification must
+///       outlive its delivery, so only persistent trace events and static user
+///       data, such as string literals, may be sent through this class. The
+///       subscribers are called on the collector thread, see the metadata of
+///       the trace events at the time of delivery and don't see the
+///       thread-local state of the instrumented thread, such as the stashed
+///       tuples and the universal ID.
+///
+class buffered_notifier_t {
+public:
+  /// @brief Returns the notifier of the process.
+  ///
+  /// The notifier is never destroyed, as notifications may be sent while
+  /// static objects are destroyed; shutdown() must be called before the
+  /// framework is finalized.
+  ///
+  static buffered_notifier_t &instance() {
+    static buffered_notifier_t *Notifier = new buffered_notifier_t();
+    return *Notifier;
+  }
+
+  buffered_notifier_t(const buffered_notifier_t &) = delete;
+  buffered_notifier_t &operator=(const buffered_notifier_t &) = delete;
+
+  /// @brief Sends a notification to the subscribers.
+  ///
+  /// Takes the same parameters as xptiNotifySubscribers(). Notifications the
+  /// sampler_t drops are not delivered. In buffered mode, the notification is
+  /// queued and the call only waits for the collector if the ring buffer of
+  /// the thread is full.
+  ///
+  /// @return The result of xptiNotifySubscribers() if the notification is
+  /// delivered synchronously, XPTI_RESULT_SUCCESS otherwise.
+  ///
+  xpti::result_t notify(uint8_t StreamID, uint16_t TraceType,
+                        xpti::trace_event_data_t *Parent,
+                        xpti::trace_event_data_t *Object, uint64_t Instance,
+                        const void *UserData) {
+    if (!sampler_t::instance().sample(StreamID, TraceType, Instance))
+      return xpti::result_t::XPTI_RESULT_SUCCESS;
+    if (!MBuffered.load(std::memory_order_relaxed))
+      return xptiNotifySubscribers(StreamID, TraceType, Parent, Object,
+                                   Instance, UserData);
+
+    ring_buffer_t &Buffer = threadBuffer();
+    size_t Tail = Buffer.MTail.load(std::memory_order_relaxed);
+    while (Tail - Buffer.MHead.load(std::memory_order_acquire) ==
+           ring_buffer_t::Capacity)
+      std::this_thread::yield();
+    Buffer.MSlots[Tail % ring_buffer_t::Capacity] = {
+        StreamID, TraceType, Parent, Object, Instance, UserData};
+    Buffer.MTail.store(Tail + 1, std::memory_order_release);
+    return xpti::result_t::XPTI_RESULT_SUCCESS;
+  }
+
+  /// @brief Delivers the notifications buffered so far before returning.
+  ///
+  void flush() {
+    std::lock_guard<std::mutex> Lock(MDrainMutex);
+    drain();
+  }
+
+  /// @brief Delivers the buffered notifications and stops the collector
+  /// thread. The notifications sent afterwards are delivered synchronously.
+  ///
+  void shutdown() {
+    if (!MBuffered.exchange(false))
+      return;
+    MStop.store(true);
+    if (MCollector.joinable())
+      MCollector.join();
+    flush();
+  }
+
+private:
+  /// A notification waiting to be delivered.
+  struct notification_t {
+    uint8_t StreamID;
+    uint16_t TraceType;
+    xpti::trace_event_data_t *Parent;
+    xpti::trace_event_data_t *Object;
+    uint64_t Instance;
+    const void *UserData;
+  };
+
+  /// Single-producer single-consumer ring buffer of a thread. Only the owning
+  /// thread moves the tail and only the drain() holding MDrainMutex moves the
+  /// head.
+  struct ring_buffer_t {
+    static constexpr size_t Capacity = 4096;
+    notification_t MSlots[Capacity];
+    std::atomic<size_t> MHead{0};
+    std::atomic<size_t> MTail{0};
+  };
+
+  buffered_notifier_t() {
+    utils::PlatformHelper Helper;
+    std::string Env = Helper.getEnvironmentVariable("XPTI_TRACE_BUFFERED");
+    if (Env != "1" && Env != "true")
+      return;
+    MBuffered = true;
+    MCollector = std::thread([this] { collect(); });
+  }
+
+  ring_buffer_t &threadBuffer() {
+    // The buffer is shared with the notifier, so that the notifications of
+    // a thread are still delivered after it exits.
+    thread_local std::shared_ptr<ring_buffer_t> Buffer = [this] {
+      auto NewBuffer = std::make_shared<ring_buffer_t>();
+      std::lock_guard<std::mutex> Lock(MDrainMutex);
+      MBuffers.push_back(NewBuffer);
+      return NewBuffer;
+    }();
+    return *Buffer;
+  }
+
+  /// Delivers the notifications of all the ring buffers, releasing the
+  /// buffers of the threads which exited. MDrainMutex must be held.
+  void drain() {
+    for (size_t I = 0; I < MBuffers.size();) {
+      ring_buffer_t &Buffer = *MBuffers[I];
+      size_t Head = Buffer.MHead.load(std::memory_order_relaxed);
+      size_t Tail = Buffer.MTail.load(std::memory_order_acquire);
+      for (; Head != Tail; ++Head) {
+        const notification_t &N = Buffer.MSlots[Head % ring_buffer_t::Capacity];
+        xptiNotifySubscribers(N.StreamID, N.TraceType, N.Parent, N.Object,
+                              N.Instance, N.UserData);
+      }
+      Buffer.MHead.store(Head, std::memory_order_release);
+      if (MBuffers[I].use_count() == 1 &&
+          Head == Buffer.MTail.load(std::memory_order_acquire)) {
+        MBuffers[I] = std::move(MBuffers.back());
+        MBuffers.pop_back();
+        continue;
+      }
+      ++I;
+    }
+  }
+
+  void collect() {
+    // Notifications are polled for, so that sending them takes no lock.
+    while (!MStop.load()) {
+      flush();
+      std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+  }
+
+  /// Set if the notifications are buffered
+  std::atomic<bool> MBuffered{false};
+  /// Set to stop the collector thread
+  std::atomic<bool> MStop{false};
+  /// Serializes the draining of the ring buffers and guards MBuffers
+  std::mutex MDrainMutex;
+  /// The ring buffers of the threads which sent notifications
+  std::vector<std::shared_ptr<ring_buffer_t>> MBuffers;
+  std::thread MCollector;
+};
+
+/// @brief Checks whether tracing is enabled
+/// @details Reads the flag published by xptiTraceEnabledFlag(), which costs a
+/// load and a branch while xptiTraceEnabled() is a call into the framework.
+/// The result follows the subscribers attached and detached at runtime.
+inline bool trace_enabled() {
+  static const std::atomic<bool> *Flag = xptiTraceEnabledFlag();
+  return Flag->load(std::memory_order_relaxed);
+}
+
+#if !defined(_WIN32) && !defined(_WIN64)
+/// @class attach_control_t
+/// @brief Attaches and detaches subscribers when the process gets a signal.
+///
+/// When the environment variable XPTI_ATTACH_SIGNAL holds a signal number,
+/// start() installs a handler for that signal. On each signal, the control
+/// file named by XPTI_ATTACH_CONTROL, by default /tmp/xpti_attach.<pid>, is
+/// read and removed. Each of its lines is either "attach <subscriber>" or
+/// "detach <subscriber>" and is passed to xptiAttachSubscriber() or
+/// xptiDetachSubscriber(). This allows tracing a process which was started
+/// without subscribers:
+///
+///   echo "attach /path/to/libcollector.so" > /tmp/xpti_attach.1234
+///   kill -s <signal> 1234
+///
+/// The control file is ignored unless it is a regular file owned by the user
+/// running the process and writable by that user only, so that other users
+/// cannot make the process load a library.
+///
+/// @note The signal handler only wakes up a thread, which reads the control
+///       file and loads or unloads the subscribers.
+class attach_control_t {
+public:
+  static attach_control_t &instance() {
+    // Leaked, the listening thread runs until the process exits.
+    static attach_control_t *Control = new attach_control_t();
+    return *Control;
+  }
+
+  /// Installs the signal handler if XPTI_ATTACH_SIGNAL is set. Calling it
+  /// more than once has no effect.
+  void start() {
+    std::call_once(MStarted, [this] {
+      const char *Signal = std::getenv("XPTI_ATTACH_SIGNAL");
+      if (!Signal)
+        return;
+      int SignalNo = std::atoi(Signal);
+      int Pipe[2];
+      if (SignalNo <= 0 || ::pipe(Pipe) != 0)
+        return;
+      ::fcntl(Pipe[1], F_SETFL, O_NONBLOCK);
+      MReadFD = Pipe[0];
+      MWakeFD = Pipe[1];
+      if (const char *Path = std::getenv("XPTI_ATTACH_CONTROL"))
+        MControlPath = Path;
+      else
+        MControlPath = "/tmp/xpti_attach." + std::to_string(::getpid());
+
+      std::thread([this] { listen(); }).detach();
+      struct sigaction Action {};
+      Action.sa_handler = onSignal;
+      Action.sa_flags = SA_RESTART;
+      sigemptyset(&Action.sa_mask);
+      ::sigaction(SignalNo, &Action, nullptr);
+    });
+  }
+
+private:
+  attach_control_t() = default;
+
+  static void onSignal(int) {
+    // Only async-signal-safe calls are allowed here. If the pipe is full, a
+    // wake up is already pending.
+    char Byte = 0;
+    [[maybe_unused]] ssize_t Written = ::write(MWakeFD, &Byte, 1);
+  }
+
+  void listen() {
+    char Byte;
+    while (true) {
+      ssize_t Read = ::read(MReadFD, &Byte, 1);
+      if (Read == 1)
+        processControlFile();
+      else if (Read != -1 || errno != EINTR)
+        break;
+    }
+  }
+
+  void processControlFile() {
+    int FD = ::open(MControlPath.c_str(), O_RDONLY | O_NOFOLLOW);
+    if (FD < 0)
+      return;
+    struct stat Stat;
+    bool Trusted = ::fstat(FD, &Stat) == 0 && S_ISREG(Stat.st_mode) &&
+                   Stat.st_uid == ::geteuid() &&
+                   !(Stat.st_mode & (S_IWGRP | S_IWOTH));
+    std::string Contents;
+    char Chunk[4096];
+    ssize_t Read;
+    while (Trusted && (Read = ::read(FD, Chunk, sizeof(Chunk))) > 0)
+      Contents.append(Chunk, Read);
+    ::close(FD);
+    ::unlink(MControlPath.c_str());
+    if (!Trusted)
+      return;
+
+    std::istringstream Lines(Contents);
+    std::string Command, Subscriber;
+    while (Lines >> Command >> Subscriber) {
+      if (Command == "attach")
+        xptiAttachSubscriber(Subscriber.c_str());
+      else if (Command == "detach")
+        xptiDetachSubscriber(Subscriber.c_str());
+    }
+  }
+
+  std::once_flag MStarted;
+  /// The ends of the pipe the signal handler writes to in order to wake up
+  /// the listening thread
+  int MReadFD = -1;
+  static inline int MWakeFD = -1;
+  std::string MControlPath;
+};
+#endif
+
 // --------------- Commented section of the code -------------
 //
 // github.com/bombela/backward-cpp/blob/master/backward.hpp